@@ -12,11 +12,15 @@ SOURCES += src/global.cpp \
     src/matrix.cpp \
     src/input.cpp \
     src/ele.cpp \
+    src/eleBlock.cpp \
     src/polynomials.cpp \
     src/operators.cpp \
     src/geo.cpp \
     src/output.cpp \
     src/face.cpp \
+    src/faceBlock.cpp \
+    src/faceComm.cpp \
+    src/taskGraph.cpp \
     src/flux.cpp \
     src/flurry.cpp \
     src/solver.cpp \
@@ -37,17 +41,24 @@ SOURCES += src/global.cpp \
     src/points.cpp \
     src/superMesh.cpp \
     src/overComm.cpp \
-    src/multigrid.cpp
+    src/multigrid.cpp \
+    src/newtonKrylov.cpp \
+    src/blockJacobian.cpp \
+    src/statistics.cpp
 		   
 HEADERS += include/global.hpp \
     include/matrix.hpp \
     include/input.hpp \
     include/ele.hpp \
+    include/eleBlock.hpp \
     include/polynomials.hpp \
     include/operators.hpp \
     include/geo.hpp \
     include/output.hpp \
     include/face.hpp \
+    include/faceBlock.hpp \
+    include/faceComm.hpp \
+    include/taskGraph.hpp \
     include/flux.hpp \
     include/flurry.hpp \
     include/solver.hpp \
@@ -68,7 +79,10 @@ HEADERS += include/global.hpp \
     include/points.hpp \
     include/superMesh.hpp \
     include/overComm.hpp \
-    include/multigrid.hpp
+    include/multigrid.hpp \
+    include/newtonKrylov.hpp \
+    include/blockJacobian.hpp \
+    include/statistics.hpp
 
 DISTFILES += \
     README.md \
@@ -0,0 +1,117 @@
+/*!
+ * \file blockJacobian.hpp
+ * \brief Header file for the blockJacobian class
+ *
+ * Block-sparse linearization of the FR residual
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#pragma once
+
+#include <vector>
+
+#include "global.hpp"
+
+#include "input.hpp"
+#include "matrix.hpp"
+
+class face;
+class solver;
+
+/*! Block-sparse Jacobian dR/dU of the FR residual R = divF/|J|
+ *
+ * Each local element owns one block row, made up of its diagonal block plus
+ * one block for each of its faces which is shared with another local element
+ * [keyed by the element's local face index].  Blocks are [nSpts*nFields]^2,
+ * row-major, with the DOFs of an element ordered as U_spts(spt,field).
+ *
+ * The blocks are assembled analytically from the point flux Jacobians [see
+ * flux.hpp] and the common-flux Jacobians of the faces [face::calcFluxJacobian],
+ * chained through the FR extrapolation, divergence and correction operators.
+ * Couplings across MPI boundaries are left out, as are [for viscous cases] the
+ * dependencies on the neighbors of an element's neighbors through their
+ * corrected gradients, which keeps the stencil compact.
+ */
+class blockJacobian
+{
+public:
+  //! Set up the block-sparse structure from the solver's elements & faces
+  void setup(input *inParams, solver *inSolver);
+
+  /*! Linearize the residual about the current solution
+   *  NOTE: The residual must have just been evaluated [solver::calcResidual] */
+  void assemble(void);
+
+  //! y = J*x over the local elements
+  void multiply(const vector<double> &x, vector<double> &y);
+
+  //! Add the memory held by the blocks & their structure to the tally [with the Newton-Krylov preconditioner]
+  void addMemUsage(memTally &mem);
+
+  //! Block in the given slot [see rowStart]
+  double* getBlock(int slot) { return &blocks[(size_t)slot*bs*bs]; }
+
+  //! Diagonal block of the given element
+  double* getDiagBlock(int ele) { return getBlock(rowStart[ele]); }
+
+  int nEles;
+  int bs;                         //! Block size [nSpts*nFields]
+  vector<int> rowStart;           //! First slot of each element's row [the diagonal block]; size nEles+1
+  vector<int> colInd;             //! Column (element) of each slot
+  vector<vector<int>> faceSlot;   //! Slot for each local face of each element [-1 if no local neighbor]
+
+private:
+  input *params = NULL;
+  solver *Solver = NULL;
+
+  int nDims, nFields, nSpts, nFpts;
+
+  //! Connection of an element to one of its faces
+  struct faceLink {
+    face *F = NULL;
+    bool isLeft = true;  //! Whether the element is on the left side of the face
+    int nbr = -1;        //! Local element on the other side [-1 if none]
+    int nbrFace = -1;    //! Local face ID of the face within nbr
+  };
+  vector<vector<faceLink>> links;  //! [nEles][nFaces]
+
+  vector<double> blocks;
+
+  /* --- Dense FR operators [shared by all elements] --- */
+  matrix<double> opE;            //! Extrapolation spts -> fpts
+  matrix<double> opC;            //! Divergence of the correction function
+  vector<matrix<double>> opD;    //! Gradient at spts
+  vector<matrix<double>> opCU;   //! Gradient correction
+
+  //! Index within element e of the given flux point of its face j
+  int eleFpt(int e, int j, int fpt);
+
+  /*! Linearization of the corrected physical gradient of element e w.r.t. its
+   *  own DOFs [j = -1], or those of its neighbor across face j
+   *  GJ[dim]: [bs x bs] */
+  void calcGradJacobian(int e, int j, vector<vector<double>> &GJ);
+
+  //! Assemble all blocks in the row of element e
+  void assembleRow(int e);
+};
@@ -62,11 +62,17 @@ public:
   /*! No right element at a boundary - do nothing. */
   void setRightStateSolution(void);
 
+  /*! Linearize the boundary condition and common flux together w.r.t. the
+   *  interior state [finite differences; see face::calcFluxJacobian] */
+  void calcFluxJacobian(void);
+
   /*! For wall boundary conditions, compute the force on the wall */
-  vector<double> computeWallForce(void);
+  void computeWallForce(double* force);
 
   /*! For inlet/outlet boundary conditions, compute the force on the wall */
-  vector<double> computeMassFlux(void);
+  void computeMassFlux(double* flux);
+
+  void addMemUsage(memTally &mem);
 
 private:
   int bcType;  //! Boundary condition to apply to this face
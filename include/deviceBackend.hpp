@@ -0,0 +1,149 @@
+/*!
+ * \file deviceBackend.hpp
+ * \brief Header file for the deviceBackend class
+ *
+ * GPU (CUDA / HIP) residual evaluation & explicit RK time advancement
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#pragma once
+
+#include <vector>
+
+#ifndef _NO_MPI
+#include "mpi.h"
+#endif
+
+#include "global.hpp"
+
+#include "deviceKernels.hpp"
+#include "eleBlock.hpp"
+#include "input.hpp"
+
+class solver;
+
+/*! Runs the full residual evaluation & RK update on a GPU
+ *
+ * The solution, flux & gradient arrays are mirrored on the device in the
+ * eleBlock layout [see batchStorage], so the FR operators are applied to all
+ * elements at once as dense matrix products [cuBLAS / hipBLAS], and all
+ * pointwise work [fluxes, boundary conditions, common interface fluxes, time
+ * advancement] is done by the kernels in deviceKernels.cu.  The host copy of
+ * the solution is only updated when needed for output [see syncHost].
+ *
+ * Supported: a single element type & order [one eleBlock]; Navier-Stokes /
+ * Euler with the Rusanov flux; static grids; the classical explicit RK
+ * schemes, with constant, global or local time stepping; MPI [the face data
+ * is staged on the host unless params->gpuAwareMPI].
+ *
+ * In mixed-precision builds, everything but U_spts, U0 & the geometry is
+ * stored in single precision [see 'real' in deviceKernels.hpp]; U_spts is
+ * rounded into Ur_spts before each residual evaluation for the operators.
+ */
+class deviceBackend
+{
+public:
+  ~deviceBackend();
+
+  //! Select the GPU, copy the operators, geometry & initial solution to it
+  void setup(input *inParams, solver *inSolver);
+
+  //! Advance the solution by one time step [params->iter already incremented]
+  void update(void);
+
+  //! Copy the solution, residual & gradient back to the host elements & faces
+  void syncHost(void);
+
+private:
+  input *params = NULL;
+  solver *Solver = NULL;
+  eleBlock *block = NULL;
+  deviceParams devParams;
+
+  int nDims, nFields, nEles, nSpts, nFpts, nCols, nRKSteps;
+  int syncIter = -1;  //! Iteration at which the host was last updated
+
+  /* --- Solution / flux arrays [eleBlock layout; dim arrays stacked] --- */
+  double *U_spts, *U0;
+  real *Ur_spts;            //! U_spts in the storage precision [same array unless mixed precision]
+  real *U_fpts;
+  real *F_spts, *F_fpts;    //! [nDims*nSpts, nCols], [nDims*nFpts, nCols]
+  real *Fn_fpts, *dFn_fpts;
+  real *Uc_fpts, *dUc_fpts;
+  real *dU_spts, *dU_fpts;  //! [nDims*nSpts, nCols], [nDims*nFpts, nCols]
+  vector<real*> divF_spts;  //! [nRKSteps][nSpts, nCols]
+
+  /* --- FR operators [dense, row-major] --- */
+  real *opSptsFpts;    //! [nFpts, nSpts]
+  real *opGrad;        //! Stacked gradient [nDims*nSpts, nSpts]
+  real *opDiv;         //! Concatenated divergence [nSpts, nDims*nSpts]
+  real *opCorrectU;    //! Stacked gradient correction [nDims*nSpts, nFpts]
+  real *opCorrection;  //! [nSpts, nFpts]
+
+  /* --- Geometry [per point, ordered as pt*nEles + ele] --- */
+  double *JGinv, *detJac, *tNorm, *dA;
+  double *waveSp, *dtEle;
+
+  //! Flux-point index & geometry data for one class of faces
+  struct faceSet
+  {
+    int nPts = 0;
+    int *idxL = NULL, *idxR = NULL, *bcType = NULL;
+    double *norm = NULL, *dAL = NULL, *dAR = NULL;
+    real *Fn = NULL;    //! Inviscid common flux at each point [for the viscous flux]
+  };
+
+  faceSet intFaces, bndFaces, mpiFaces;
+
+  /* --- MPI communication [see faceComm] --- */
+  int nRanks = 0;
+  int nSendPts = 0, nRecvPts = 0;
+  int *sendIdx = NULL;  //! Flux-point index of each point to send, in send order
+  real *sendBuf = NULL, *recvBuf = NULL, *sendBufGrad = NULL, *recvBufGrad = NULL;
+  vector<real> hSendBuf, hRecvBuf, hSendBufGrad, hRecvBufGrad;  //! Host staging buffers
+#ifndef _NO_MPI
+  vector<MPI_Request> sendReqs, recvReqs, sendReqsGrad, recvReqsGrad;
+#endif
+
+  vector<void*> allocations;  //! All device memory, freed on destruction
+
+  template<typename T> T* allocate(size_t n);
+  template<typename T> T* upload(const vector<T> &data);
+
+  //! Copy n values from the device to a double-precision host array
+  void download(double *host, const real *dev, size_t n);
+
+  void setupOperators(void);
+  void setupGeometry(void);
+  void setupFaces(void);
+  void setupMpi(void);
+
+  //! Compute the residual of the current solution into divF_spts[step]
+  void calcResidual(int step);
+
+  void calcDt(void);
+
+  void startExchange(bool grad);
+  void finishExchange(bool grad);
+};
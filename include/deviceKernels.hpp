@@ -0,0 +1,164 @@
+/*!
+ * \file deviceKernels.hpp
+ * \brief Host-callable interface to the GPU (CUDA / HIP) kernels
+ *
+ * Only plain C++ types appear here, so that the rest of Flurry can be
+ * compiled without the CUDA / HIP headers; the kernels themselves live in
+ * deviceKernels.cu.  All arrays are device pointers, laid out as the
+ * eleBlock arrays: [nPts, nEles*nFields], i.e. [pt][ele][field].
+ *
+ * The solution & flux arrays and the FR operators are stored as 'real',
+ * which is single precision in mixed-precision builds [make precision=mixed].
+ * The solution at the solution points, the RK stages, the geometry, and all
+ * pointwise arithmetic stay in double precision.
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA..
+ *
+ */
+#pragma once
+
+#include <cstddef>
+
+#ifdef _MIXED_PRECISION
+typedef float real;
+#else
+typedef double real;
+#endif
+
+/*! The members of input needed by the device kernels, gathered into a plain
+ *  struct so that it can be passed to the kernels by value */
+struct deviceParams
+{
+  int nDims, nFields;
+  double gamma;
+
+  /* --- Viscous flux --- */
+  double prandtl;
+  double mu_inf, rt_inf, c_sth;  //! For Sutherland's Law
+  int fixVis;
+  double tau, penFact;           //! LDG bias & penalty parameters
+
+  /* --- Boundary conditions --- */
+  double rhoBound, uBound, vBound, wBound, pBound;
+  double TWall, RGas;
+};
+
+/* ---------------- Device management & memory ---------------- */
+
+//! # of GPUs visible to this process
+int devGetDeviceCount(void);
+
+//! Select the GPU to run on & create the BLAS handle
+void devSetDevice(int dev);
+
+//! Release the BLAS handle
+void devFinalize(void);
+
+void* devMalloc(size_t bytes);
+void devFree(void* ptr);
+void devCopyToDevice(void* dst, const void* src, size_t bytes);
+void devCopyToHost(void* dst, const void* src, size_t bytes);
+void devCopy(void* dst, const void* src, size_t bytes);
+void devSynchronize(void);
+
+/* ---------------- Dense linear algebra ---------------- */
+
+//! C = A*B [+ C if add], with A: [m,k], B: [k,n], C: [m,n], all row-major
+void devGemm(int m, int n, int k, const double* A, const double* B, double* C, bool add = false);
+void devGemm(int m, int n, int k, const float* A, const float* B, float* C, bool add = false);
+
+//! Minimum of x[0:n] [x >= 0], copied back to the host
+double devMin(int n, const double* x);
+
+/* ---------------- Solution-point kernels ----------------
+ * nPts = nSpts*nEles; F, dU: [nDims][nSpts][nEles*nFields]
+ * JGinv: [nPts][nDims][nDims]; detJac: [nPts] */
+
+//! Transformed inviscid flux at all solution points
+void devInviscidFluxSpts(int nPts, const double* U, real* F, const double* JGinv, deviceParams p);
+
+//! Add the transformed viscous flux at all solution points
+void devViscousFluxSpts(int nPts, const double* U, const real* dU, real* F, const double* JGinv, deviceParams p);
+
+//! Transform the [corrected] reference-space gradient to physical space
+void devTransformGradU(int nPts, real* dU, const double* JGinv, const double* detJac, int nDims, int nFields);
+
+/* ---------------- Flux-point kernels ----------------
+ * nPts = nFpts*nEles; tNorm: [nPts][nDims] */
+
+//! c = a - b [e.g. dUc = Uc - U]
+void devDifference(int n, const real* a, const real* b, real* c);
+
+//! b = a, rounded to the storage precision [mixed-precision builds]
+void devConvert(int n, const double* a, real* b);
+
+//! dFn = Fn - sum_dim(F_fpts[dim]*tNorm[dim])
+void devDeltaFn(int nPts, const real* Fn, const real* F_fpts, const double* tNorm, real* dFn, int nDims, int nFields);
+
+/* ---------------- Face kernels ----------------
+ * Each face flux point gives the index of its data within the element arrays
+ * [fpt*nEles*nFields + ele*nFields]; the wave speed (one value per flux
+ * point) is at idx/nFields.  Fn_face holds the inviscid common flux at each
+ * face point, so that the viscous flux can be added before scaling by dA.
+ * For MPI faces, UR & idxR refer to the receive buffer, and dAR is NULL. */
+
+//! Rusanov flux on interior & MPI faces [+ LDG common solution if Uc != NULL]
+void devInteriorFlux(int nPts, const int* idxL, const int* idxR, const double* norm, const double* dAL,
+                     const double* dAR, const real* U_fpts, const real* UR, real* Fn_fpts,
+                     real* Fn_face, double* waveSp, real* Uc_fpts, deviceParams p);
+
+//! Boundary conditions & central flux on boundary faces [+ common solution if Uc != NULL]
+void devBoundaryFlux(int nPts, const int* idxL, const int* bcType, const double* norm, const double* dAL,
+                     const real* U_fpts, real* Fn_fpts, real* Fn_face, double* waveSp,
+                     real* Uc_fpts, deviceParams p);
+
+/*! LDG viscous flux on interior & MPI faces; the right gradient is at
+ *  dUR[idxR*gScaleR + dim*gStrideR + k] [element arrays or receive buffer] */
+void devInteriorViscousFlux(int nPts, const int* idxL, const int* idxR, const double* norm, const double* dAL,
+                            const double* dAR, const real* U_fpts, const real* UR, const real* dU_fpts,
+                            int gStride, const real* dUR, int gScaleR, int gStrideR, real* Fn_fpts,
+                            const real* Fn_face, deviceParams p);
+
+//! LDG viscous flux on boundary faces
+void devBoundaryViscousFlux(int nPts, const int* idxL, const int* bcType, const double* norm, const double* dAL,
+                            const real* U_fpts, const real* dU_fpts, int gStride, real* Fn_fpts,
+                            const real* Fn_face, deviceParams p);
+
+/*! Gather nDims [1 for the solution] x nFields values at each point into a
+ *  contiguous MPI buffer: buf[(pt*nDims+dim)*nFields+k] = src[idx[pt]+dim*stride+k] */
+void devPack(int nPts, const int* idx, const real* src, int stride, int nDims, int nFields, real* buf);
+
+/* ---------------- Time advancement ----------------
+ * nPts = nSpts*nEles; dtEle [local time stepping] may be NULL */
+
+//! U = U0 - rkVal*dt*divF/detJac
+void devTimeStepA(int nPts, int nEles, int nFields, double* U, const double* U0, const real* divF,
+                  const double* detJac, const double* dtEle, double dt, double rkVal);
+
+//! U -= rkVal*dt*divF/detJac
+void devTimeStepB(int nPts, int nEles, int nFields, double* U, const real* divF,
+                  const double* detJac, const double* dtEle, double dt, double rkVal);
+
+//! CFL-based time step of each element from the max. wave speed over its flux points
+void devCalcDt(int nEles, int nFpts, const double* waveSp, const double* dA, double fac, double* dtEle);
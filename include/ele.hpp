@@ -32,12 +32,35 @@
 
 #include "global.hpp"
 
+#include "eleBlock.hpp"
+#include "flux.hpp"
 #include "funcs.hpp"
 #include "geo.hpp"
 #include "input.hpp"
 #include "matrix.hpp"
 #include "points.hpp"
 
+/*! Shape-basis values & derivatives at the solution & flux points, which are
+ *  identical for all elements of the same type, order & number of nodes */
+struct shapeTables
+{
+  matrix<double> spts;          //! Shape basis at solution points [nSpts x nNodes]
+  matrix<double> fpts;          //! Shape basis at flux points [nFpts x nNodes]
+  vector<matrix<double>> dSpts; //! Derivative of shape basis at solution points
+  vector<matrix<double>> dFpts; //! Derivative of shape basis at flux points
+  vector<double> wts_spts;      //! Quadrature weights at the solution points
+};
+
+//! Convergence statistics from batched point location [ele::getRefLocNewton]
+struct refLocStats
+{
+  int nPts = 0;      //! # of points tested
+  int nNewton = 0;   //! # of points inside the bounding box [Newton solves]
+  int nFound = 0;    //! # of Newton solves which converged
+  int nIters = 0;    //! Total # of Newton iterations
+  int maxIters = 0;  //! Max. # of Newton iterations for one point
+};
+
 class ele
 {
 friend class face;
@@ -76,6 +99,12 @@ public:
 
   void calcGridVelocity(void);
 
+  //! Rigid-body motion: rotate/translate the initial transforms & positions in place of recomputing them
+  void moveRigid(bool doTransforms);
+
+  //! Store the initial transforms & positions for use with moveRigid
+  void setupRigidTransforms(void);
+
   void calcTransforms(bool moving = false);
 
   void calcTransforms_point(matrix<double>& jacobian, matrix<double>& JGinv, double& detJac, const point& loc);
@@ -92,13 +121,16 @@ public:
 
   void setPpts(void);
 
-  void setShape_spts(void);
+  //! Get the shape tables shared with all other elements of the same type, order & number of nodes
+  void setShapeTables(void);
 
-  void setShape_fpts(void);
+  void setShape_spts(shapeTables &tab);
 
-  void setDShape_spts(void);
+  void setShape_fpts(shapeTables &tab);
 
-  void setDShape_fpts(void);
+  void setDShape_spts(shapeTables &tab);
+
+  void setDShape_fpts(shapeTables &tab);
 
   void setTransformedNormals_fpts(void);
 
@@ -110,6 +142,9 @@ public:
 
   void transformGradF_spts(int step);
 
+  /*! Get the discontinuous normal flux from the flux extrapolated to the flux points */
+  void calcDisFn_fpts(void);
+
   void calcDeltaFn(void);
 
   void calcDeltaUc(void);
@@ -132,20 +167,27 @@ public:
   /*! Perform final advancement of Runge-Kutta time integration [With PMG source term] */
   void timeStepB_source(int step, double rkVal);
 
+  /*! Advance one stage of a 2N-storage RK scheme; U0 holds the stage increment dU */
+  void timeStepLS(double rkA, double rkB, bool source = false);
+
+  /*! Advance one stage of an SSP (Shu-Osher form) RK scheme
+   *  If calcErr, return the sum of the squared, scaled embedded-error estimate */
+  double timeStepSSP(double rkA, bool source = false, bool calcErr = false);
+
   /*! Copy U0_spts into U_spts for final time advancement */
   void copyU0_Uspts(void);
   void copyUspts_U0(void);
 
   /* --- Display, Output & Diagnostic Functions --- */
 
-  /*! Get vector of primitive variables at a solution point */
-  vector<double> getPrimitives(uint spt);
+  /*! Get the primitive variables at a solution point [V: nFields] */
+  void getPrimitives(uint spt, double* V);
 
-  /*! Get vector of primitive variables at a flux point */
-  vector<double> getPrimitivesFpt(uint fpt);
+  /*! Get the primitive variables at a flux point [V: nFields] */
+  void getPrimitivesFpt(uint fpt, double* V);
 
-  /*! Get vector of primitive variables at a mesh point */
-  vector<double> getPrimitivesMpt(uint mpt);
+  /*! Get the primitive variables at a mesh point [V: nFields] */
+  void getPrimitivesMpt(uint mpt, double* V);
 
   /*! Get the full matrix of solution values at spts + fpts combined */
   void getPrimitivesPlot(matrix<double> &V);
@@ -156,8 +198,8 @@ public:
   /*! Get the locations of the plotting points */
   vector<point> getPpts(void);
 
-  /*! Compute the norm of the solution residual over the element */
-  vector<double> getNormResidual(int normType);
+  /*! Compute the norm of the solution residual over the element [res: nFields] */
+  void getNormResidual(int normType, double* res);
 
   /*! Get position of solution point in physical space */
   point getPosSpt(uint spt);
@@ -172,8 +214,15 @@ public:
   vector<double> getBoundingBox(void);
 
   /*! Find the reference location of a point inside an element given its
-   *  physical location, using the Newton root-finding method */
-  bool getRefLocNewton(point pos, point& loc);
+   *  physical location, using the Newton root-finding method
+   *  [starting from 'guess', e.g. the point's location on the previous step] */
+  bool getRefLocNewton(point pos, point& loc, point guess = point());
+
+  /*! Batched version of getRefLocNewton for nPts points: the bounding box is
+   *  computed once, and each Newton solve starts from the nearest node of a
+   *  reference-space lattice mapped to physical space [built on demand].
+   *  isIn[i] = 1 if pos[i] was found in the element; returns the # found */
+  int getRefLocNewton(const point* pos, int nPts, point* loc, char* isIn, refLocStats* stats = NULL);
 
   /*! Find the reference location of a point inside an element given its
    *  physical location, using the Nelder-Meade algorithm */
@@ -194,12 +243,22 @@ public:
   double getSensor(void);
 
   void calcEntropyErr_spts(void);
-  vector<double> getEntropyVars(int spt);
+  void getEntropyVars(int spt, double* v);
   void getEntropyErrPlot(matrix<double> &S);
   void setupArrays();
   void setupAllGeometry();
+
+  /*! Setup the solution arrays as views into the element's eleBlock */
+  void setupBlockViews(void);
   void restart(ifstream &file, input *_params, geo *_Geo);
 
+  /*! Set the solution from a binary restart record, given at the solution
+   *  points of order 'rOrder' [interpolated to the element's order] */
+  void restart(const double *U_r, int rOrder);
+
+  //! Lagrange interpolation from the solution points of one order to those of another
+  matrix<double> getOrderInterp(int fromOrder, int toOrder);
+
   void getUSpts(double* Uvec);
   void setUSpts(double* Uvec);
 
@@ -210,6 +269,9 @@ public:
   //! Calculate the error of the solution w.r.t. several test cases
   matrix<double> calcError();
 
+  //! Add the memory held by the element's arrays to the tally [views of an eleBlock hold none]
+  void addMemUsage(memTally &mem);
+
   /* --- Simulation/Mesh Parameters --- */
   geo* Geo;      //! Geometry (mesh) to which element belongs
   input* params; //! Input parameters for simulation
@@ -248,21 +310,22 @@ public:
   // Transform Variables
   vector<double> detJac_spts;  //! Determinant of transformation Jacobian at each solution point
   vector<double> detJac_fpts;  //! Determinant of transformation Jacobian at each solution point
-  vector<matrix<double> > Jac_spts;  //! Transformation Jacobian [matrix] at each solution point
-  vector<matrix<double> > Jac_fpts;  //! Transformation Jacobian [matrix] at each flux point
+  vector<matrix<double> > Jac_spts;  //! Transformation Jacobian [matrix] at each solution point [moving or overset grids only]
   vector<matrix<double> > JGinv_spts;  //! Inverse of transformation Jacobian [matrix] at each solution point
-  vector<matrix<double> > JGinv_fpts;  //! Inverse of transformation Jacobian [matrix] at each flux point
 
-  matrix<double> shape_spts;
-  matrix<double> shape_fpts;
-  vector<matrix<double>> dShape_spts;  //! Derivative of shape basis at solution points
-  vector<matrix<double>> dShape_fpts;  //! Derivative of shape basis at flux points
+  shared_ptr<const shapeTables> shapes;  //! Shape basis [& derivatives] at the solution & flux points
   matrix<double> gridVel_spts;         //! Mesh velocity at solution points
   matrix<double> gridVel_fpts;         //! Mesh velocity at flux points
   matrix<double> gridVel_nodes;        //! Mesh velocity at mesh (corner) points
   matrix<double> gridVel_mpts;         //! Mesh velocity at ALL mesh points (corners + edges in 3D)
   vector<point> nodesRK;               //! Location of mesh nodes in physical space
 
+  // Initial-Position Transforms [rigid-body motion]
+  vector<matrix<double>> Jac0_spts;    //! Transformation Jacobian at the initial position
+  vector<matrix<double>> JGinv0_spts;  //! Inverse of transformation Jacobian at the initial position
+  matrix<double> norm0_fpts;                        //! Unit normal at the initial position
+  vector<point> pos0_spts, pos0_fpts;               //! Position of solution & flux points at the initial position
+
   // Geometry Variables
   vector<point> pos_spts;     //! Position of solution points in physical space
   vector<point> pos_fpts;     //! Position of flux points in physical space
@@ -270,6 +333,7 @@ public:
   matrix<double> norm_fpts;   //! Unit normal in physical space
   matrix<double> tNorm_fpts;  //! Unit normal in reference space
   vector<double> dA_fpts;     //! Local equivalent face-area at flux point
+  vector<double> lift_fpts;   //! BR2 lifting coefficient at flux points [reference element; see oper::setupLifting]
 
   // Shock Capturing variables
   double sensor;
@@ -282,6 +346,10 @@ public:
   matrix<double> S_fpts;      //! Entropy-adjoint variable at flux points
   matrix<double> S_mpts;      //! Entropy-adjoint variable at mesh points
 
+  /* --- Flux kernels for the current equation set & dimension --- */
+  inviscidFluxKernel invFluxKernel;
+  viscousFluxKernel visFluxKernel;
+
   /* --- Temporary Variables --- */
   matrix<double> tempF;
   vector<double> tempU;
@@ -289,9 +357,13 @@ public:
   /* --- Overset Stuff --- */
   int sptOffset;  //! Offset within overset data-transfer array to grab solution data
 
-  vector<matrix<double>> transformFlux_physToRef(void);
+  /* --- Batched Storage --- */
+  eleBlock* block = NULL;  //! Contiguous storage for this element's (eType,order) [if params->batchStorage]
+  int blockInd = -1;       //! Index of element within block
+
+  void transformFlux_physToRef(vector<matrix<double>> &outF);
   vector<matrix<double>> transformFlux_refToPhys(void);
-  vector<matrix<double>> transformGradU_physToRef(void);
+  void transformGradU_physToRef(vector<matrix<double>> &outDU);
 
 private:
 
@@ -302,5 +374,7 @@ private:
 
   double getDxNelderMead(point refLoc, point physPos);
 
-  vector<double> tmpShape;  //! To avoid unnecessary mem allocs in calcPos
+  /*! Newton iterations for the reference location of physical point pos,
+   *  starting from loc; returns the # of iterations [-1 if not converged] */
+  int newtonRefLoc(const point &pos, point &loc, double tol);
 };
@@ -0,0 +1,93 @@
+/*!
+ * \file eleBlock.hpp
+ * \brief Header file for eleBlock class
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA..
+ *
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "global.hpp"
+
+#include "input.hpp"
+#include "matrix.hpp"
+
+/*! Contiguous solution storage shared by all elements of one (eType, order)
+ *
+ * Each array is stored as [nPts, nEles*nFields], i.e. [pt][ele][field], so
+ * that the data for element 'ic' is the strided [nPts, nFields] sub-matrix
+ * starting at column ic*nFields.  Each ele sets up its solution matrices as
+ * views into these blocks (see ele::setupArrays), so all per-element code runs
+ * unchanged while the FR operators can later be applied to all elements at
+ * once.
+ */
+class eleBlock
+{
+public:
+  //! Allocate all storage for nEles elements of the given type & order
+  void setup(input *inParams, int _eType, int _order, int _nEles);
+
+  //! Point the matrix 'view' at the data for element 'ic' within 'block'
+  void getView(matrix<double> &block, int ic, matrix<double> &view);
+
+  //! Add the memory held by the block arrays to the tally [as for ele::addMemUsage]
+  void addMemUsage(memTally &mem);
+
+  input *params;
+
+  int eType;
+  int order;
+  int nEles;   //! # of elements in block
+  int nSpts;   //! # of solution points per element
+  int nFpts;   //! # of flux points per element
+  int nDims, nFields;
+  int nCols;   //! # of columns in each block array [nEles*nFields]
+
+  /* --- Block storage [nPts, nEles*nFields] --- */
+  matrix<double> U_spts;           //! Solution at solution points
+  matrix<double> U_fpts;           //! Solution at flux points
+  matrix<double> U0;               //! Solution at solution points, beginning of each time step
+  vector<matrix<double>> F_spts;   //! Flux at solution points
+  vector<matrix<double>> F_fpts;   //! Flux at flux points
+  matrix<double> disFn_fpts;       //! Discontinuous normal flux at flux points
+  matrix<double> Fn_fpts;          //! Interface flux at flux points
+  matrix<double> dFn_fpts;         //! Interface minus discontinuous flux at flux points
+  matrix<double> Uc_fpts;          //! Common solution at flux points
+  matrix<double> dUc_fpts;         //! Common minus discontinuous solution at flux points
+  vector<matrix<double>> dU_spts;  //! Gradient of solution at solution points
+  vector<matrix<double>> dU_fpts;  //! Gradient of solution at flux points
+  vector<matrix<double>> divF_spts; //! Divergence of flux at solution points [per RK stage]
+  matrix<double> sol_spts;         //! PMG: Solution at the start of the coarse-level cycle
+  matrix<double> corr_spts;        //! PMG: Coarse-level correction
+  matrix<double> src_spts;         //! PMG: Coarse-level source term
+
+private:
+  vector<unique_ptr<double[]>> storage;  //! Memory underlying all of the block arrays
+
+  //! Allocate a [nRows, nCols] block array with NUMA-aware (first-touch) zero-initialization
+  void allocate(matrix<double> &mat, int nRows);
+};
@@ -0,0 +1,111 @@
+/*!
+ * \file extract.hpp
+ * \brief Header file for the extractor class
+ *
+ * In-situ data reduction: point probes, cutting planes & wall surfaces
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#pragma once
+
+#include <fstream>
+#include <vector>
+
+#include "global.hpp"
+#include "input.hpp"
+#include "solver.hpp"
+
+/*! Header of a binary time-series file [slices & surfaces]
+ *
+ * Each sample is appended as a record of {iter [int], time [double],
+ * nPts [int]}, followed by the point coordinates as nPts x 3 doubles if
+ * 'movingPts', and then the primitive variables as nPts x nVars doubles.
+ * For fixed points, the coordinates follow the header once instead. */
+struct seriesHeader
+{
+  char magic[8];  //! "FLURRYTS"
+  int version;
+  int nDims;
+  int nVars;      //! # of primitive variables per point
+  int nPts;       //! # of points [fixed points only]
+  int movingPts;  //! Are the coordinates written with every record?
+};
+
+/*! In-situ extraction of probes, cutting planes & wall-surface data
+ *
+ * Sample locations are found once [or on every sample, for moving grids]
+ * and the solution is interpolated there from the solution points, so only
+ * small time-series files are written at high frequency instead of full
+ * volume files.  In MPI runs each point is sampled by one rank only, and
+ * all data is gathered to rank 0 for writing. */
+class extractor
+{
+public:
+  //! Read the probe & slice definitions and locate all sample points
+  void setup(input *params, solver *Solver);
+
+  //! Sample & write whichever data is due on the current iteration
+  void sample(void);
+
+  //! Re-locate the sample points after the elements have changed [e.g. load rebalancing]
+  void relocate(void);
+
+private:
+  input *params = NULL;
+  solver *Solver = NULL;
+
+  //! A set of fixed points in space at which to sample the solution
+  struct samplePts
+  {
+    vector<point> pts;      //! Physical locations
+    vector<int> eleID;      //! Local ele containing each point [-1 if not on this rank]
+    vector<point> refLoc;   //! Reference location of each point within its ele
+    string fileName;
+  };
+
+  samplePts probes;
+  vector<samplePts> slices;
+  string surfFileName;
+
+  int nVars;  //! # of primitive variables written per point
+
+  //! Find the element [and the reference location within it] containing each point
+  void locatePoints(samplePts &S);
+
+  //! Interpolate the primitive variables to the points [nPts x nVars, on rank 0]
+  void interpPoints(samplePts &S, vector<double> &V);
+
+  //! Gather the position & primitive variables at all wall flux points to rank 0
+  void getSurfaceData(vector<double> &xyz, vector<double> &V);
+
+  //! Convert a state vector from conservative to primitive variables [in place]
+  void getPrimitives(double *U);
+
+  void writeProbes(void);
+  void writeSlices(void);
+  void writeSurface(void);
+
+  //! Open [or on restart, append to] a time-series file; returns true if it is new
+  bool openSeries(ofstream &file, const string &fileName, bool binary);
+};
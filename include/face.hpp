@@ -67,6 +67,8 @@ struct faceInfo {
 
 class face
 {
+friend class faceBlock;
+
 public:
 
   /*! Assign basic parameters to boundary */
@@ -104,18 +106,33 @@ public:
    *  Either put directly into ele's memory, or send across MPI boundary */
   virtual void setRightStateSolution(void) =0;
 
-  /*! Compute the force on any wall boundary conditions */
-  virtual vector<double> computeWallForce(void) =0;
+  /*! Add the force [and moment] on any wall boundary conditions to force */
+  virtual void computeWallForce(double* force) =0;
 
-  /*! For inlet/outlet boundary conditions, compute the force on the wall */
-  virtual vector<double> computeMassFlux(void) =0;
+  /*! For inlet/outlet boundary conditions, add the mass flux to flux */
+  virtual void computeMassFlux(double* flux) =0;
 
   /*! Calculate the common inviscid flux on the face */
   void calcInviscidFlux(void);
 
+  /*! Put the common inviscid flux [and common solution] into the left & right eles */
+  void finishInviscidFlux(void);
+
   /*! Calculate the common viscous flux on the face */
   void calcViscousFlux(void);
 
+  /*! Linearize the common normal flux [and for viscous cases, the common
+   *  solution] about the current left & right states, as last set by
+   *  calcInviscidFlux & calcViscousFlux [see blockJacobian] */
+  virtual void calcFluxJacobian(void);
+
+  /*! Index within the right element of the given flux point on the face
+   *  [-1 if there is no local right element] */
+  virtual int getFptR(int) { return -1; }
+
+  //! Add the memory held by the face's arrays to the tally [see memTally]
+  virtual void addMemUsage(memTally &mem);
+
   /*! Calculate the common flux using the Rusanov method
    *  NOTE: Overridden for overFaces due to flux-interp modifications */
   virtual void rusanovFlux(void);
@@ -129,9 +146,13 @@ public:
   /*! For boundary faces, use a central flux (no added dissipation) */
   void centralFluxBound(void);
 
-  /*! Calculate a biased-average solution for LDG viscous flux */
+  /*! Calculate a biased-average solution for LDG viscous flux [central average for BR2] */
   void ldgSolution(void);
 
+  //! Elements to the left & right of the face [right is null for boundary & MPI faces]
+  ele* getLeftEle(void) { return eL.get(); }
+  ele* getRightEle(void) { return eR.get(); }
+
   int ID; //! Global ID of face
 
   input *params; //! Input parameters for simulation
@@ -162,6 +183,8 @@ protected:
   matrix<double> normL;   //! Unit outward normal at flux points
   vector<double> dAL;     //! Local face-area equivalent (aka edge Jacobian) at flux points
   vector<double> detJacL; //! Determinant of transformation Jacobian at flux points
+  vector<double> liftL;   //! BR2 lifting factor at left flux points [eta * lift_fpts * dA / detJac]
+  vector<double> liftR;   //! BR2 lifting factor at right flux points [as ordered on the left face]
   vector<double*> waveSp; //! Maximum numerical wave speed at flux point (in left ele's memory)
 
   //! Temporary vectors for calculating common flux
@@ -170,4 +193,35 @@ protected:
 
   int isMPI;  //! Flag for MPI faces to separate communication from flux calculation
   int isBnd;  //! Flag for boundary faces for use in LDG routines
+
+  /* --- 'Mortar' between left & right elements of different order [p-adaptation];
+   * the right flux points are ordered as seen from the left face --- */
+  matrix<double> interpR;  //! Interpolation from the right to the left flux points [nFptsL, nFptsR]
+  matrix<double> projR;    //! L2 projection from the left to the right flux points [nFptsR, nFptsL]
+
+  //! Setup interpR & projR for a right element of order orderR
+  void setupMortar(int orderR);
+
+public:
+  /* --- Linearization of the common flux [see calcFluxJacobian]; Fn excludes the dA scaling --- */
+  matrix<double> dFndUL, dFndUR;  //! dFn/dU on each side at each flux point [nFpts, nFields*nFields]
+  matrix<double> dFndQL, dFndQR;  //! Viscous: dFn/d(gradU) on each side [nFpts, nFields*nDims*nFields]
+  matrix<double> dUcdUL, dUcdUR;  //! Viscous: dUc/dU on each side [nFpts, nFields*nFields]
+
+protected:
+  //! Calculate the common inviscid flux Fn from the current left & right states
+  void calcCommonInviscidFlux(void);
+
+  //! Add the common viscous flux to Fn, from the current left & right states & gradients
+  void calcCommonViscousFlux(void);
+
+  //! LDG penalty factor at a flux point, with its sign set by a fixed switch direction
+  double ldgPenalty(int fpt);
+
+  /*! BR2: add the lifting of the jump UC - U to one side's gradient; sign is
+   *  +1 for the left side, and -1 for the right [outward normal -normL] */
+  void liftGradient(vector<matrix<double>> &gradU, matrix<double> &U, vector<double> &lift, double sign);
+
+  //! Allocate the flux-Jacobian arrays
+  void setupFluxJacobian(void);
 };
@@ -0,0 +1,81 @@
+/*!
+ * \file faceBlock.hpp
+ * \brief Header file for faceBlock class
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA..
+ *
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "global.hpp"
+
+#include "face.hpp"
+#include "input.hpp"
+#include "matrix.hpp"
+
+/*! Contiguous flux-point storage shared by all faces of one concrete type
+ *
+ * The left/right states, normals, grid velocity and common flux of every face
+ * are stored back-to-back as [nFpts, nFields] (or [nFpts, nDims]), and each
+ * face's own matrices are set up as views into these arrays.  Gathering the
+ * states and scattering the fluxes is still done face-by-face, but the
+ * Riemann solver itself then runs as one tight loop over all flux points of
+ * the block, with no per-face dispatch or temporaries.
+ */
+class faceBlock
+{
+public:
+  //! Allocate storage for the given faces [all of type faceType] and point their data at it
+  void setup(input *inParams, int _faceType, vector<face*> &_faces);
+
+  //! Calculate the common inviscid flux on all faces in the block
+  void calcInviscidFlux(void);
+
+  //! Whether the block's Riemann solver can be applied in batched form
+  static bool canBatch(input *params);
+
+  //! Add the memory held by the block arrays to the tally [as "faces"]
+  void addMemUsage(memTally &mem);
+
+  input *params;
+
+  int faceType;  //! Concrete type of all faces in block [INTERNAL, BOUNDARY, MPI_FACE]
+  int nFaces;
+  int nFpts;     //! Total # of flux points over all faces in block
+  int nDims, nFields;
+
+  vector<face*> faces;
+  vector<int> fptStart;   //! Index of each face's first flux point within the block
+
+  /* --- Block storage [nFpts, nFields] or [nFpts, nDims] --- */
+  matrix<double> UL;      //! Discontinuous solution on left side of faces
+  matrix<double> UR;      //! Discontinuous solution on right side of faces
+  matrix<double> normL;   //! Unit outward normal at flux points
+  matrix<double> Vg;      //! Grid velocity at flux points
+  matrix<double> Fn;      //! Common normal flux at flux points
+  vector<double> waveSp;  //! Maximum wave speed at flux points
+};
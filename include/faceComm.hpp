@@ -0,0 +1,109 @@
+/*!
+ * \file faceComm.hpp
+ * \brief Header file for faceComm class
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA..
+ *
+ */
+#pragma once
+
+#include <map>
+#include <vector>
+
+#ifndef _NO_MPI
+#include "mpi.h"
+#endif
+
+#include "global.hpp"
+
+#include "input.hpp"
+#include "mpiFace.hpp"
+
+/*! Aggregated MPI communication for all mpiFaces of a solver
+ *
+ * Rather than one message per face, the data of all faces shared with a given
+ * neighbor rank is packed into one contiguous buffer and exchanged with a
+ * single persistent send/receive pair.  Send buffers are packed in the order
+ * of the receiving rank's local face IDs [IDR], and receive buffers are
+ * unpacked in the order of this rank's face IDs, so no face IDs need to be
+ * exchanged.
+ *
+ * With params->haloFloat, the messages are sent in single precision [half the
+ * bytes] whenever the rounding error of a message, relative to its largest
+ * value, is within params->haloTol; otherwise that message is sent in double
+ * precision.  The receiver tells the two apart by the size of the message.
+ */
+class faceComm
+{
+public:
+  ~faceComm();
+
+  //! Group the faces by neighbor rank and set up the persistent requests
+  void setup(input *inParams, vector<shared_ptr<mpiFace>> &mpiFaces);
+
+  //! Pack & send the left state [or gradient] of all faces, and post the receives
+  void startExchange(bool grad = false);
+
+  /*! Wait for the data from any one neighbor rank & unpack it into its faces
+   *  Returns the index of that rank in recvFaces, or -1 once all have arrived */
+  int finishAny(bool grad = false);
+
+  //! Finish the entire exchange
+  void finishAll(bool grad = false);
+
+  //! Add the memory held by the message buffers to the tally [as "mpiFace"]
+  void addMemUsage(memTally &mem);
+
+  int nRanks = 0;                     //! # of neighboring ranks
+  vector<int> ranks;                  //! Neighboring ranks
+  vector<vector<mpiFace*>> sendFaces; //! Faces shared with each rank, in the order of the right-side face IDs
+  vector<vector<mpiFace*>> recvFaces; //! Faces shared with each rank, in the order of the local face IDs
+
+private:
+  input *params = NULL;
+  int nDims, nFields;
+
+  vector<vector<double>> sendBuf, recvBuf;          //! Solution buffers per rank
+  vector<vector<double>> sendBufGrad, recvBufGrad;  //! Gradient buffers per rank
+
+  bool floatMsg[2] = {false, false};  //! Whether the solution / gradient messages may be sent as floats
+  vector<char> sentFloat;             //! Whether each rank's message was sent as floats [startExchange]
+  vector<vector<float>> sendBufF, recvBufF;          //! Single-precision solution buffers per rank
+  vector<vector<float>> sendBufGradF, recvBufGradF;  //! Single-precision gradient buffers per rank
+
+#ifndef _NO_MPI
+  vector<MPI_Request> sendReqs, recvReqs;
+  vector<MPI_Request> sendReqsGrad, recvReqsGrad;
+  vector<MPI_Request> sendReqsF, sendReqsGradF;  //! Single-precision sends [floatMsg]
+#endif
+
+  //! Round buf to floats in fBuf if the rounding error is within params->haloTol; returns whether it was
+  bool packFloat(const vector<double> &buf, vector<float> &fBuf);
+
+  //! Expand a message of floats received into the start of buf [via fBuf]
+  void unpackFloat(vector<double> &buf, vector<float> &fBuf);
+
+  //! Release any persistent requests from a previous setup
+  void freeRequests(void);
+};
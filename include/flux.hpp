@@ -36,21 +36,64 @@
 /*! Calculate the inviscid portion of the Euler or Navier-Stokes flux vector at a point */
 void inviscidFlux(const double *U, matrix<double> &F, input *params);
 
+/*! Jacobian of the inviscid flux w.r.t. the conserved variables at a point
+ *  dFdU: [nDims, nFields, nFields], row-major */
+void inviscidFluxJacobian(const double *U, double *dFdU, input *params);
+
 /*! Calculate the viscous portion of the Navier-Stokes flux vector at a point */
 void viscousFlux(double *U, matrix<double> &gradU, matrix<double> &Fvis, input *params);
 
+/*! Jacobians of the viscous flux w.r.t. the conserved variables and their gradient
+ *  [Navier-Stokes or Advection-Diffusion], all row-major:
+ *  dFdU: [nDims, nFields, nFields]; dFdQ: [nDims, nFields, nDims, nFields] */
+void viscousFluxJacobian(double* U, matrix<double> &gradU, double* dFdU, double* dFdQ, input *params);
+
 /*! Calculate the viscous shear-stress tensor at a point */
 matrix<double> viscousStressTensor(double* U, matrix<double> &gradU, input *params);
 
 /*! Calculate the viscous flux for Advection-Diffusion */
 void viscousFluxAD(matrix<double> &gradU, matrix<double> &Fvis, input *params);
 
+/*! Flux at all solution points of an element, with the equation set and
+ *  dimension fixed at compile time [select once with get*FluxKernel()]
+ *  U: [nSpts, nFields]; dU, F: nDims x [nSpts, nFields]
+ *  The inviscid kernel overwrites F and the viscous kernel adds to it; both
+ *  transform to the reference domain with JGinv, unless it is NULL */
+typedef void (*inviscidFluxKernel)(matrix<double> &U, vector<matrix<double>> &F, vector<matrix<double>> *JGinv, input *params);
+typedef void (*viscousFluxKernel)(matrix<double> &U, vector<matrix<double>> &dU, vector<matrix<double>> &F,
+                                  vector<matrix<double>> *JGinv, input *params);
+
+inviscidFluxKernel getInviscidFluxKernel(input *params);
+viscousFluxKernel getViscousFluxKernel(input *params);
+
 /*! Calculate the common inviscid flux at a point using Roe's method */
 void roeFlux(double* uL, double* uR, double *norm, double *Fn, input *params);
 
+/*! Calculate the Roe common flux at nPts points at once [2D Navier-Stokes]
+ *  UL, UR, Fn: [nPts, nFields]; norm: [nPts, nDims] */
+void roeFlux(int nPts, const double* UL, const double* UR, const double* norm, double* Fn, input *params);
+
+/*! Jacobians of the Roe common flux w.r.t. the left & right states [nFields, nFields each] */
+void roeFluxJacobian(const double* UL, const double* UR, const double* norm, double* dFdUL, double* dFdUR, input *params);
+
 /*! Calculate the common inviscid flux at a point using the Rusanov scalar-diffusion method */
 void rusanovFlux(double* UL, double* UR, matrix<double> &FL, matrix<double> &FR, double *norm, double *Fn, double *waveSp, input *params);
 
+/*! Calculate the Rusanov common flux at nPts points at once [Navier-Stokes]
+ *  UL, UR, Fn: [nPts, nFields]; norm, Vg: [nPts, nDims] (Vg = NULL if not moving)
+ *  waveSp: [nPts] maximum wave speed at each point */
+void rusanovFlux(int nPts, const double* UL, const double* UR, const double* norm, const double* Vg,
+                 double* Fn, double* waveSp, input *params);
+
+/*! Jacobians of the Rusanov common flux w.r.t. the left & right states [nFields, nFields each]
+ *  [static grids; the wave speed is differentiated as well] */
+void rusanovFluxJacobian(const double* UL, const double* UR, const double* norm, double* dFdUL, double* dFdUR, input *params);
+
+/*! Calculate the central (non-dissipative) common flux on boundary faces at
+ *  nPts points at once [Navier-Stokes; same layout as above] */
+void centralFluxBound(int nPts, const double* UL, const double* UR, const double* norm, const double* Vg,
+                      double* Fn, double* waveSp, input *params);
+
 /*! Simple central-difference flux (For advection problems) */
 void centralFlux(double* uL, double* uR, double *norm, double *Fn, input *params);
 
@@ -79,6 +79,10 @@ void getSimplex(int nDims, vector<double> x0, double L, matrix<double> X);
 
 vector<int> getOrder(vector<double> &data);
 
+/*! Index of a point along a Hilbert curve filling the box [minPt,maxPt]
+ *  [2D: 31 bits, 3D: 21 bits per dimension] */
+uint64_t hilbertIndex(const point &pt, const point &minPt, const point &maxPt, int nDims);
+
 //! Given points for a cell's face and a point inside the cell, get the outward unit normal
 Vec3 getFaceNormalTri(vector<point> &facePts, point &xc);
 
@@ -58,6 +58,35 @@ class tioga;
 #define FRINGE -1
 #define FIELD_HOLE -2
 
+/*! A Gmsh PhysicalName [boundary or fluid region], as stored in a partitioned mesh file */
+struct gmshPhysicalName
+{
+  int dim;
+  int id;
+  char name[64];
+};
+
+/*! Header of a pre-partitioned binary mesh file [see geo::writePartMesh]
+ *
+ * The header is followed by nNames gmshPhysicalName records, then by a
+ * partition table of nParts x {offset, nBytes} [int64_t], then by the record
+ * of each partition:
+ *   {nEles, nVerts, nNodesPerCell, nCols, maxNBndPts} [int],
+ *   ctype, c2nv, c2nf, ic2icg [nEles ints each], c2v [nEles x nCols],
+ *   iv2ivg [nVerts], xv [nVerts x nDims doubles], nBndPts [nBounds],
+ *   bndPts [nBounds x maxNBndPts; partition-local node IDs] */
+struct meshPartHeader
+{
+  char magic[8];  //! "FLURRYPM"
+  int version;
+  int nDims;
+  int nParts;     //! # of partitions [ranks] in the table
+  int nNames;     //! # of Gmsh PhysicalNames
+  int nBounds;    //! # of (non-fluid) boundaries
+  int nEles_g;
+  int nVerts_g;
+};
+
 class geo
 {
 public:
@@ -73,6 +102,26 @@ public:
   //! Multigrid-specific setup function [from mesh-refinement method]
   void setup_hmg(input *params, int _gridID, int _gridRank, int _nProcGrid, const vector<int> &_gridIdList = {0}, const vector<int>& _epart = {-1});
 
+  /*!
+   * \brief H-multigrid [agglomeration method]: build this grid by merging the cells of fineGrid
+   *
+   * Each 2x2 [2x2x2] block of quads [hexes] around an interior vertex becomes
+   * one linear quad [hex]; cells which cannot be merged into a conforming
+   * coarse mesh are kept [as linear cells].  Both grids are global [not
+   * partitioned]; fineGrid must have been set up with setup(params,true) or
+   * agglomerate.  parent is set to the coarse cell containing each fine cell.
+   */
+  void agglomerate(geo &fineGrid, vector<int> &parent);
+
+  /*!
+   * \brief Dynamic load balancing: re-partition the grid of oldGeo
+   *
+   * The grid is re-partitioned from oldGeo's global mesh, weighting each
+   * element by its current cost [blanked cells: 1], and then the connectivity
+   * is re-processed as in setup().  Collective over all ranks.
+   */
+  void setupRebalanced(geo &oldGeo, const vector<shared_ptr<ele>> &eles);
+
   //! Take the basic connectivity data and generate the rest
   void processConnectivity();
 
@@ -84,12 +133,31 @@ public:
 
   /* === Helper Routines === */
 
-  //! Read essential connectivity from a Gmsh mesh file
+  //! Read essential connectivity from a Gmsh mesh file [ASCII or binary, format 2.x]
   void readGmsh(string fileName);
 
+  //! Read this rank's partition from a pre-partitioned binary mesh file
+  void readPartMesh(string fileName);
+
+  /*!
+   * \brief Pre-processing mode: read & partition the mesh, then write the binary partitioned mesh
+   *
+   * The mesh is partitioned across the ranks of the current run; each rank
+   * writes its own partition [MPI-IO], and later runs on the same number of
+   * ranks read only their own part with readPartMesh.
+   */
+  void writePartMesh(input *params);
+
   //! Create a simple Cartesian mesh from input parameters
   void createMesh();
 
+  /*! Create only this rank's block of the Cartesian mesh [see input::distributedMesh]
+   *
+   * The cells are split into a px x py [x pz] grid of blocks, one per rank;
+   * the global vertex & cell IDs are those of createMesh, but no rank ever
+   * holds the global mesh, so no partitioning is needed. */
+  void createMeshBlock();
+
   //! Update connectivity / node-blanking for overset grids
   void setupOverset3D();
 
@@ -101,6 +169,12 @@ public:
    */
   void updateADT();
 
+  //! Compute the bounding box of every element [eleBBox]
+  void updateEleBBoxes(void);
+
+  //! Add the memory held by the mesh & its connectivity to the tally [as "geo: mesh & connectivity"]
+  void addMemUsage(memTally &mem);
+
   /* ---- My Overset Functions ---- */
 
   void matchOversetDonors(vector<shared_ptr<ele>> &eles, vector<superMesh> &donors);
@@ -143,6 +217,14 @@ public:
   vector<point> xv0;      //! Initial position of vertices [moving grids]
   matrix<double> gridVel; //! Grid velocity of vertices
 
+  // Rigid-Body Motion [motion 4,5]: x = rotMat*(x0 - rotCenter) + rotCenter + rigidOffset
+  bool rigidMotion = false;  //! Grid moves as a rigid body: element transforms are rotated, not recomputed
+  matrix<double> rotMat;     //! Rotation matrix [3x3] at the current RK-stage time
+  point rotCenter;           //! Initial center of rotation
+  point rigidOffset;         //! Translation of the center of rotation
+  point rigidVel;            //! Velocity of the center of rotation
+  double rotOmega = 0;       //! Angular velocity about the z-axis
+
   point minPt;   //! Centroid of all vertices on grid partition
   point maxPt;     //! Overall x,y,z extents (max-min) of grid partition
 
@@ -150,7 +232,7 @@ public:
   matrix<int> c2e, c2b, e2c, e2v, v2e, v2v, v2c;
   matrix<int> c2f, f2v, f2c, c2c, c2ac;
   vector<int> v2nv, v2nc, c2nv, c2nf, f2nv, ctype;
-  vector<int> intFaces, bndFaces, mpiFaces, mpiCells;
+  vector<int> intFaces, bndFaces, mpiFaces;
   unordered_set<int> overFaces, overCells; //! List of all faces / cells which have an overset-boundary-condition face
   vector<int> bcList;            //! List of boundary conditions for each boundary
   vector<int> bcType;            //! Boundary condition for each boundary face
@@ -160,9 +242,9 @@ public:
   vector<int> nFacesPerBnd;      //! List of # of faces on each boundary
   vector<int> procR;             //! What processor lies to the 'right' of this face
   vector<int> faceID_R;            //! The local mpiFace ID of each mpiFace on the opposite processor
-  vector<int> gIC_R;             //! The global cell ID of the right cell on the opposite processor
   vector<int> mpiLocF;           //! Element-local face ID of MPI Face in left cell
-  vector<int> mpiLocF_R;         //! Element-local face ID of MPI Face in right cell
+  matrix<int> mpiFaceNodes_R;    //! 3D: Global node IDs of each MPI face, as oriented in the right cell
+  matrix<double> mpiFaceXv_R;    //! 3D periodic: Positions of the nodes in mpiFaceNodes_R [4 x 3 per face]
   vector<int> mpiPeriodic;       //! Flag for whether an MPI face is also a periodic face
   vector<int> faceType;          //! Type for each face: hole, internal, boundary, MPI, overset [-1,0,1,2,3]
 
@@ -204,6 +286,7 @@ public:
   unordered_set<int> unblankCells;  //! List of non-existing cells which, due to motion, must be un-blanked
   unordered_set<int> blankCells;    //! List of existing cells which, due to motion, must be blanked
   unordered_set<int> fringeCells;   //! For field-fill (non-boundary) overset method, fringe/receptor cell list
+  bool blankingChanged = true;      //! Did any cell on this grid get blanked or unblanked this iteration?
 
 #ifndef _NO_MPI
   shared_ptr<overComm> OComm;
@@ -239,12 +322,27 @@ private:
   matrix<int> bndPts_g;  //! Global lists of points on boundaries
   vector<int> nBndPts_g; //! Global number of points on each boundary
   map<int,int> bcIdMap;  //! Map from Gmsh boundary ID to Flurry BC ID
+  vector<gmshPhysicalName> physicalNames; //! Gmsh PhysicalNames of the mesh [for writePartMesh]
   int nEles_g, nVerts_g;
 
+  //! Map a Gmsh PhysicalName to its Flurry boundary condition [or the fluid region]
+  void addPhysicalName(int bcdim, int bcid, string bcStr);
+
   void processConn2D(void);
   void processConn3D(void);
   void processConnExtra(void);
 
+  /*! Reorder the local cells along a Hilbert curve through their centroids, so
+   *  that neighboring cells [and so their faces] are stored close together */
+  void reorderCells(void);
+
+  /*! Sort the unique faces into intFaces & bndFaces, given the unique-face ID
+   *  of each cell's face [iF; faces numbered in order of first appearance] */
+  void sortFaces(const vector<int> &iF, const string &faceName);
+
+  //! Find the boundary condition of each boundary face [bcType, bcFaces]
+  void matchBoundaryFaces(void);
+
   void setupOverset2D(void);
 
   //! Using Tioga's nodal iblanks, set iblank values for all cells and faces
@@ -260,13 +358,16 @@ private:
   //! Check if two given periodic edges match up
   bool checkPeriodicFaces(int *edge1, int *edge2);
   bool checkPeriodicFaces3D(vector<int> &face1, vector<int> &face2);
-  bool comparePeriodicMPI(vector<int> &face1, vector<int> &face2);
+  bool comparePeriodicMPI(vector<point> &face1, vector<point> &face2);
 
   //! Compare the orientation (rotation in ref. space) betwen the local faces of 2 elements
   int compareOrientation(int ic1, int ic2, int f1, int f2);
 
   //! Compare the orientation (rotation in ref. space) betwen the local faces of 2 elements across MPI boundary
-  int compareOrientationMPI(int ic1, int ic2, int f1, int f2, int isPeriodic);
+  int compareOrientationMPI(int ic1, int f1, int F, int isPeriodic);
+
+  //! Local node IDs of face f of cell ic, ordered CCW from the face's reference-space origin
+  vector<int> getOrientedFaceNodes(int ic, int f);
 
   //! For overset cases, balance MPI processes across grids by # of elements
   void splitGridProcs(void);
@@ -274,10 +375,25 @@ private:
   //! For MPI runs, partition the mesh across all processors
   void partitionMesh(void);
 
+  //! Compute epart with METIS [or ParMETIS, if built with parmetis=y]; empty weights: uniform
+  void computePartitions(vector<int> &weights);
+
+  //! Estimated cost of each element for partitioning: 2*nSpts + nFpts [+ nFpts of boundary faces]; empty if !partWeights
+  void getEleWeights(vector<int> &weights);
+
   //! For MPI runs, match internal faces across MPI boundaries
   void matchMPIFaces();
 
-  //! Compare two faces [lists of nodes] to see if they match [used for MPI]
-  bool compareFaces(vector<int> &face1, vector<int> &face2);
+  //! Move the unmatched boundary faces [bcType NONE or PERIODIC] into mpiFaces
+  void extractMPIFaces(void);
+
+  /*! Match the MPI faces of a distributed Cartesian mesh [createMeshBlock]:
+   *  the neighbor rank & structured index of each face are known, so faces
+   *  are only exchanged with the neighboring ranks */
+  void matchMPIFacesBlocks(void);
+
+  bool meshBlocks = false;     //! Whether this is a distributed Cartesian mesh [createMeshBlock]
+  int procDims[3] = {1,1,1};   //! # of mesh blocks [ranks] in each direction
+  int blockLo[3], blockHi[3];  //! Range of cell indices of this rank's block
 
 };
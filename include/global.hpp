@@ -313,6 +313,36 @@ bool checkNaN(vector<double> &vec);
 
 bool checkNaN(double* vec, int size);
 
+//! Max. number of OpenMP threads [1 when compiled without OpenMP]
+inline int getMaxThreads(void)
+{
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+//! ID of the calling OpenMP thread [0 when compiled without OpenMP]
+inline int getThreadNum(void)
+{
+#ifdef _OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+//! Whether the caller is inside an active OpenMP parallel region [false without OpenMP]
+inline bool inParallel(void)
+{
+#ifdef _OPENMP
+  return omp_in_parallel();
+#else
+  return false;
+#endif
+}
+
 /*! Get polynomial-order-based CFL limit.  Borrowed from Josh's zefr code. */
 double getCFLLimit(int order);
 
@@ -477,3 +507,81 @@ public:
   void showTime(int precision=3);
   double getElapsedTime(void);
 };
+
+/*! Hierarchical wall-clock timers for the phases of a run [see input::profile]
+ *
+ * Each PROFILE("name") scope adds its time & call count to a node of a tree,
+ * beneath the node of the innermost enclosing PROFILE scope.  Only the
+ * master thread may start & stop timers [i.e., outside of OpenMP regions]. */
+class phaseTimers {
+public:
+  bool enabled = false;
+
+  phaseTimers(void);
+
+  void start(const char* name);
+  void stop(void);
+
+  /*! Combine the timers of all ranks [min / max / avg] and print them on
+   *  rank 0; also write them as JSON to 'jsonFile', if given, along with the
+   *  [already reduced] run-wide values in 'summary' */
+  void report(double totalTime, const string &jsonFile = "", const map<string,double> &summary = map<string,double>());
+
+  //! Total time [s] of all phases with the given name, wherever they are nested [outermost only]
+  double getTime(const string &name);
+
+private:
+  struct node {
+    string name;
+    int parent;
+    vector<int> children;
+    double time;
+    long calls;
+    std::chrono::steady_clock::time_point t0;
+  };
+
+  vector<node> nodes;
+  int current;
+
+  //! Full '/'-separated name of a node, e.g. "update/calcResidual/extrapolateU"
+  string getPath(int n);
+};
+
+extern phaseTimers profiler;
+
+/*! Times the enclosing scope with the global profiler [if enabled; ignored
+ *  within parallel regions, e.g. inside the tasks of taskGraph] */
+struct scopedPhase {
+  bool on;
+  scopedPhase(const char* name) : on(profiler.enabled && !inParallel()) { if (on) profiler.start(name); }
+  ~scopedPhase() { if (on) profiler.stop(); }
+};
+
+#define PROFILE(name) scopedPhase _phase_(name)
+
+/*! Tally of the heap memory held by each subsystem [see input::memReport]
+ *
+ * Each class adds the bytes held by its arrays [see memBytes] to named
+ * categories, e.g. "ele: solution" or "oper: Hex P4"; the report gives the
+ * min / max / sum of each category over all ranks. */
+class memTally {
+public:
+  map<string,size_t> bytes;  //! Bytes held in each category
+
+  void add(const string &category, size_t nBytes) { bytes[category] += nBytes; }
+
+  //! Total over all categories
+  size_t total(void) const;
+
+  /*! Combine the tallies of all ranks [min / max / sum] and print them on
+   *  rank 0, along with the peak resident set size of the ranks */
+  void report(const string &title);
+};
+
+//! Peak resident set size of this process so far [bytes]
+size_t getPeakMemory(void);
+
+#ifdef _DEBUG
+//! # of heap allocations [operator new] made so far by this process [debug builds only]
+long getAllocCount(void);
+#endif
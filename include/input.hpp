@@ -28,6 +28,8 @@
 #pragma once
 
 #include <fstream>
+#include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -52,12 +54,18 @@ public:
   /*! Set the file to be read from */
   void setFile(string fileName);
 
-  /*! Open the file to prepare for reading simulation parameters */
-  void openFile(void);
+  /*! Read the file [on rank 0, broadcast to all ranks] and index its lines by option name
+   *  [collective if MPI is initialized; lookups call it if the file is not yet read] */
+  void readFile(void);
 
-  /*! Close the file & clean up */
+  /*! Drop this reader's reference to the option index; its next lookup re-reads
+   *  the file, so must then be made on all ranks */
   void closeFile(void);
 
+  /*! Read another file's options in place of those of the same name [ensemble
+   *  members]; none of the 'locked' options may appear in it */
+  void addOverrides(string overFile, const set<string> &locked);
+
   /* === Functions to read paramters from input file === */
 
   /*! Read a single value from the input file; if not found, apply a default value */
@@ -81,9 +89,16 @@ public:
   void getMap(string optName, map<T, U> &opt);
 
 private:
-  ifstream optFile;
   string fileName;
 
+  bool isRead = false;
+
+  //! Rest of each line of the file [in order], indexed by the line's first word;
+  //! shared by copies of the reader [e.g. the multigrid levels' inputs]
+  shared_ptr<map<string,vector<string>>> optLines;
+
+  //! Rest of the first line for option optName; NULL if not in the file
+  const string* findOption(const string &optName);
 };
 
 class input
@@ -92,7 +107,8 @@ public:
   /*! Default constructor */
   input();
 
-  void readInputFile(char *filename);
+  /*! Read the input file; for an ensemble member, the member's override file is applied on top */
+  void readInputFile(char *filename, int member = -1);
 
   void nonDimensionalize(void);
 
@@ -111,6 +127,8 @@ public:
   /* --- Viscous Solver Parameters --- */
   double penFact;    //! Penalty factor for the LDG viscous flux
   double tau;        //! Bias parameter for the LDG viscous flux
+  int viscScheme;    //! Viscous interface flux: {0 | LDG} {1 | BR2 [compact: one MPI exchange per stage]}
+  double br2Eta;     //! Lifting penalty factor for the BR2 viscous flux
   double Re;         //! Reynolds number
   double Lref;       //! Reference length for Reynlds number
 
@@ -128,7 +146,7 @@ public:
   int nDims;
   double dt;
   double CFL;
-  int dtType;
+  int dtType;       //! 0 - Constant dt, 1 - Global CFL-based dt, 2 - Local (per-element) CFL-based dt [steady only]
   int timeType;
   double rkTime;
   double time;
@@ -138,21 +156,47 @@ public:
   int restartIter;
   int restart;
   int restart_freq;
+  int restartType;  //! Restart files: 0 - read the .vtu plot files, 1 - binary checkpoint in one shared file [MPI-IO], 2 - binary checkpoint per rank [mmap on read]; binary checkpoints can be read by any # of ranks
   int nRKSteps;
-  vector<double> RKa, RKb;
+  int nRKRegs;      //! # of RK-stage residuals stored per element [nRKSteps, or 1 for low-storage schemes]
+  int lowStorageRK; //! Scheme type: 0 - classical [U0 + all stage residuals], 1 - 2N-storage (Williamson form), 2 - SSP (Shu-Osher form)
+  vector<double> RKa, RKb, RKc;  //! RK coefficients & stage times [meaning of RKa & RKb depends upon lowStorageRK]
+
+  /* --- Steady-State Acceleration --- */
+  double resSmoothing; //! Implicit residual smoothing coefficient (element-mean residual) [default: off/0]
+  int resSmoothIters;  //! # of Jacobi iterations for implicit residual smoothing
+
+  /* --- Implicit Time Stepping [Newton-Krylov] --- */
+  int implicitTime;    //! Implicit time integration [timeType 11: BDF1, 12: BDF2, 13: ESDIRK3]
+  int newtonMaxIter;   //! Max. # of Newton iterations per implicit stage
+  double newtonTol;    //! Relative tolerance for the Newton iterations
+  int gmresKrylov;     //! Krylov subspace size (# of iterations between GMRES restarts)
+  int gmresRestarts;   //! Max. # of GMRES restarts
+  double gmresTol;     //! Relative tolerance for each linear solve [inexact Newton]
+  int precondType;     //! GMRES preconditioner: 0 - none, 1 - element block-Jacobi, 2 - element block-Jacobi with analytic blocks
+  int jacobianFreq;    //! # of time steps between updates of the block-Jacobi preconditioner
+
+  /* --- Adaptive Time Stepping [Embedded Error Estimate] --- */
+  int adaptDt;      //! Adapt dt to keep the embedded RK error estimate below tolerance [default: off/0]
+  double adaptRTol; //! Relative error tolerance for adaptive time stepping
+  double adaptATol; //! Absolute error tolerance for adaptive time stepping
 
   /* --- Multigrid Options --- */
   int PMG;         //! P-Multigrid flag [default: off/0]
   int lowOrder;    //! Minimum order to use with PMG [default: 0]
   int smoothSteps; //! Number of 'smoothing' iterations to use on coarse levels
-  int HMG;         //! H-Multigrid flag [default: off/0]
+  int HMG;         //! H-Multigrid: 0 - off, 1 - refine the input [coarsest] mesh [2D], 2 - agglomerate the input [finest] mesh
   int n_h_levels;  //! Number of h-levels to cycle [default: 1]
+  int mgCycle;     //! PMG cycle type: 0 - V, 1 - W, 2 - FMG start-up followed by V-cycles
+  int fmgCycles;   //! FMG: # of cycles run on each coarse level before moving up to the next
   int shapeOrder; //! Shape-function order to use on generated fine grids
 
   int iter;
 
   /* --- Moving-Grid Parameters --- */
   double moveAx, moveAy, moveFx, moveFy;
+  double rotOmega, pitchAmp, pitchFreq;  //! Rigid rotation [motion 5]: spin rate, pitching amplitude (rad) & frequency (Hz)
+  double rotCx, rotCy;                   //! Rigid rotation [motion 5]: initial center of rotation
 
   /* --- Output Parameters --- */
 
@@ -164,6 +208,23 @@ public:
   int quadOrder;
   int plotFreq;
   int plotType;
+  int vtuFormat;    //! ParaView DataArray format: 0 - ASCII, 1 - appended raw binary, 2 - appended base64 binary
+  int vtuCompress;  //! zlib-compress each binary DataArray [requires a build with zlib=y]
+  int asyncOutput;  //! Write ParaView files from a background thread while the solver continues
+  int profile;      //! Per-phase timers [see phaseTimers]: 0 - off, 1 - print at end, 2 - also write JSON
+  int memReport;      //! Memory held by each subsystem [see memTally]: 0 - off, 1 - report after setup
+  int memReportFreq;  //! Iterations between further memory reports [0: after setup only]
+
+  /* --- In-situ extraction [see extractor] --- */
+  int probeFreq;           //! Iterations between probe samples [0: off]
+  vector<double> probePts; //! Probe locations [x y z per probe]
+  int sliceFreq;           //! Iterations between slice samples [0: off]
+  vector<double> slices;   //! Slice definitions [x0 y0 z0  ax ay az  bx by bz  n1 n2 per slice]
+  int surfaceFreq;         //! Iterations between wall-surface samples [0: off]
+
+  /* --- In-situ flow statistics [see statistics] --- */
+  int statsFreq;           //! Iterations between samples of the running means & second moments [0: off]
+  int statsStart;          //! Iteration at which the averaging begins [default: 0]
 
   bool calcEntropySensor;
 
@@ -209,14 +270,22 @@ public:
   double lambda;   //! Lax-Friedrichs upwind coefficient (0: Central, 1: Upwind)
 
   /* --- Mesh Parameters --- */
-  string meshFileName;          //! Gmsh file name for standard run
+  string meshFileName;          //! Gmsh [or pre-partitioned binary] mesh file name for standard run
+  int partWeights;              //! Weight elements by their estimated cost when partitioning [default: off/0]
+  int rebalanceFreq;            //! Check the load balance [& repartition if needed] every rebalanceFreq iterations [default: off/0]
+  double rebalanceTol;          //! Repartition when the (max/avg) load imbalance exceeds this [default: 1.1]
+  string partMeshFile;          //! Pre-processing only: write the mesh, partitioned across this run's ranks, to this file & exit
   vector<string> oversetGrids;  //! Gmsh file names of all overset grids being used
   int meshType;     //! Type of mesh being used: Single Gmsh, create a mesh, or read multiple overset grids
   int nx, ny, nz;   //! For creating a structured mesh: Number of cells in each direction
+  int distributedMesh = 0;  //! For creating a structured mesh in MPI runs: each rank creates only its own block [default: off/0]
   int nGrids;       //! # of grids in overset calculation
   int writeIBLANK;  //! Write IBLANK in ParaView output?
   int oversetMethod;   //! Interp. dis. sol'n (0) or corr. flux (1) at overset bounds, or use Galerkin proj. (2) on fringe cells
   int projection;   //! Use Local Galerkin Projection (1) or simple collocation (0)
+  int donorCache;   //! Moving grids: retry each point's previous donor cell before a full search
+  int multirate;    //! Each overset grid sub-cycles with its own stable dt within the coarsest grid's step; fringe data is extrapolated linearly in time between exchanges [dtType 1; default: off/0]
+  int multirateMax; //! Max. # of sub-steps per multirate macro step [default: 32]
   double xmin, xmax, ymin, ymax, zmin, zmax;
   double periodicTol, periodicDX, periodicDY, periodicDZ;
   string create_bcTop, create_bcBottom, create_bcLeft;
@@ -228,14 +297,40 @@ public:
   string sptsTypeQuad;
   int vcjhSchemeTri;
   int vcjhSchemeQuad;
+  string operCache;    //! Binary file in which the FR operators are kept between runs [see solver::setupOperators]
 
   /* --- Shock Capturing, Filtering & Stabilization Parameters --- */
   int scFlag;       //! Shock Capturing Flag
   double threshold; //! Threshold for considering as shock -Set to 1.0 by default
+  int scSensorFreq; //! Sense all elements every scSensorFreq iterations; only the troubled elements & their halo in between [default: 1]
 
   double exps0;     //! Minimum entropy bound for polynomial squeezing
   int squeeze;      //! Flag to turn on polynomial squeezing or not
 
+  /* --- p-Adaptation Parameters --- */
+  int pAdaptFreq;        //! Adapt the element orders every pAdaptFreq iterations [default: off/0]
+  int pAdaptMin;         //! Minimum element order [default: 1]
+  int pAdaptMax;         //! Maximum element order [default: order+2]
+  double pAdaptRefine;   //! Raise an element's order if its error indicator is above pAdaptRefine x the mean [default: 2]
+  double pAdaptCoarsen;  //! Lower an element's order if its error indicator is below pAdaptCoarsen x the mean [default: 0.25]
+
+  /* --- Data Layout / Performance Parameters --- */
+  int batchStorage; //! Store solution arrays contiguously per (eType,order) [default: off/0]
+  int faceBatching; //! Calculate the common flux over contiguous blocks of faces of each type [default: off/0]
+  int sumFactorization; //! Apply quad/hex operators in sum-factorized (tensor-product) form [default: on/1]
+  int fuseKernels;  //! Fuse the element-local stages of each RK stage into as few element sweeps as possible [default: off/0]
+  int taskResidual; //! Run the fused residual as a graph of element- & face-chunk tasks, without global barriers [implies fuseKernels; default: off/0]
+  int reorderMesh;  //! Reorder the local elements [& faces] along a Hilbert curve through the element centroids [default: off/0]
+  int gpu;          //! Run the residual evaluation & RK update on the GPU [experimental; requires a GPU build; default: off/0]
+  int gpuAwareMPI;  //! Pass device buffers directly to MPI, rather than staging them on the host [default: off/0]
+  int haloFloat;    //! Send MPI face data in single precision: 0 - never, 1 - gradient messages [LDG], 2 - all messages [default: 0]
+  double haloTol;   //! haloFloat: max rounding error of a message relative to its largest value, else it is sent in double precision [default: 1e-6]
+
+  /* --- Ensemble Parameters --- */
+  int ensemble;                   //! Advance several parameter variants side by side on one mesh [default: off/0]
+  vector<string> ensembleFiles;   //! Per member: a file of options overriding the input file [e.g. MachBound, gamma]
+  int ensembleMember = -1;        //! This run's member ID [-1: not an ensemble member]
+
   /* --- PID Boundary Conditions --- */
   double Kp;
   double Kd;
@@ -244,6 +339,7 @@ public:
   /* --- Other --- */
   int rank;
   int nproc;
+  bool mpiSerialized = true;  //! Whether MPI may be called from any thread [one at a time; MPI_THREAD_SERIALIZED]
 
 private:
   fileReader opts;
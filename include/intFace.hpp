@@ -55,11 +55,16 @@ public:
   //! Put the common solution into the right element's memory (viscous cases)
   void setRightStateSolution(void);
 
+  //! Index of the given face flux point within the right element
+  int getFptR(int fpt) { return fptR[fpt]; }
+
+  void addMemUsage(memTally &mem);
+
   //! Do nothing [not a wall boundary]
-  vector<double> computeWallForce(void);
+  void computeWallForce(double* force);
 
   //! Do nothing [not an inlet/outlet boundary]
-  vector<double> computeMassFlux(void);
+  void computeMassFlux(double* flux);
 
 private:
   int faceID_R;              //! Right element's face ID
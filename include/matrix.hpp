@@ -37,6 +37,9 @@
 #include <array>
 #include <iomanip>   // for setw, setprecision
 #include <iostream>
+#include <set>
+#include <type_traits>
+#include <unordered_set>
 #include <vector>
 
 #include "error.hpp"
@@ -66,7 +69,7 @@ public:
   void initializeToValue(const T &_val);
 
   //! Assignment
-  Array<T,N> operator=(const Array<T,N>& inArray);
+  Array<T,N>& operator=(const Array<T,N>& inArray);
 
   /*! Get dim0 [number of rows] */
   uint getDim0(void) {return this->dims[0];}
@@ -77,12 +80,16 @@ public:
   uint getDim1(void) const {return this->dims[1];}
 
   /*! Get the size of the underlying data array (total number of Array elements) */
-  uint getSize(void) {return data.size();}
+  uint getSize(void) {return (isView) ? dims[0]*dims[1] : data.size();}
 
   /* --- Member Functions --- */
 
   void setup(uint inDim0, uint inDim1=1, uint inDim2=1, uint inDim3=1);
 
+  /*! Turn the Array into a non-owning [inDim0 x inDim1] view of external
+   *  storage, with consecutive rows separated by 'inStride' entries */
+  void setupView(T* inData, uint inDim0, uint inDim1, uint inStride);
+
   /* --- Data-Access Operators --- */
 
   /*! Returns a pointer to the first element of row inDim0 */
@@ -102,6 +109,14 @@ public:
   uint dims[4];  //! Dimensions of the Array
 
   vector<T> data;
+
+  T* dataPtr = NULL;      //! Pointer to the first Array entry (data.data() unless a view)
+  uint stride = 0;       //! Distance in memory between consecutive entries along dim0
+  bool isView = false;   //! Flag for Arrays referencing outside storage [see setupView()]
+
+protected:
+  //! Reset dataPtr & stride to point to the owned data vector
+  void resetDataPtr(void);
 };
 
 template<typename T>
@@ -227,3 +242,44 @@ public:
   /*! Find all unique 'rows' in a Array */
   void unique(matrix<T> &out, vector<int> &iRow);
 };
+
+/* --- Heap memory held by [nested] containers, for memory accounting [see memTally] --- */
+
+//! Anything without heap storage of its own [scalars, points, ...]
+template<typename T>
+size_t memBytes(const T &) { return 0; }
+
+inline size_t memBytes(const vector<bool> &vec) { return vec.capacity()/8; }
+
+template<typename T>
+size_t memBytes(const vector<T> &vec);
+
+template<typename T>
+size_t memBytes(const set<T> &s) { return s.size()*(sizeof(T)+4*sizeof(void*)); }
+
+template<typename T>
+size_t memBytes(const unordered_set<T> &s) { return s.size()*(sizeof(T)+2*sizeof(void*)) + s.bucket_count()*sizeof(void*); }
+
+//! Views hold no storage of their own
+template<typename T, uint N>
+size_t memBytes(const Array<T,N> &mat) { return (mat.isView) ? 0 : memBytes(mat.data); }
+
+template<typename T>
+size_t memBytes(const Array2D<T> &mat) { return memBytes((const Array<T,2>&)mat); }
+
+template<typename T>
+size_t memBytes(const matrix<T> &mat) { return memBytes((const Array<T,2>&)mat); }
+
+template<typename T>
+size_t memBytes(const vector<T> &vec)
+{
+  size_t bytes = vec.capacity()*sizeof(T);
+  if (!std::is_trivially_copyable<T>::value)
+    for (auto &v:vec) bytes += memBytes(v);
+
+  return bytes;
+}
+
+//! Total over several containers
+template<typename T1, typename T2, typename... Ts>
+size_t memBytes(const T1 &a, const T2 &b, const Ts&... rest) { return memBytes(a) + memBytes(b,rest...); }
@@ -44,6 +44,8 @@ class face;
 
 class mpiFace : public face
 {
+friend class deviceBackend;
+
 public:
 
   //! Get/send information from/to the opposite processor
@@ -55,10 +57,10 @@ public:
   /*! Get pointer access to right ele's data */
   void getPointersRight(void);
 
-  //! Receive the right-state data from the opposite processor
+  //! Get the right-state data received from the opposite processor
   void getRightState(void);
 
-  //! For viscous cases, receive the solution gradient from the opposite processor
+  //! For viscous cases, get the solution gradient received from the opposite processor
   void getRightGradient(void);
 
   //! Do nothing [handled sparately via comminicate()]
@@ -68,16 +70,27 @@ public:
   void setRightStateSolution(void);
 
   //! Do nothing [not a wall boundary]
-  vector<double> computeWallForce(void);
+  void computeWallForce(double* force);
 
   //! Do nothing [not an inlet/outlet boundary]
-  vector<double> computeMassFlux(void);
+  void computeMassFlux(double* flux);
+
+  //! The right-state arrays & receive buffers are tallied as "mpiFace"
+  void addMemUsage(memTally &mem);
+
+  /*! Get the left state & pack it into the outgoing buffer for the opposite processor
+   *  [see faceComm]; returns the position in the buffer following this face's data
+   *  For BR2, the left gradient & lifting factor are packed along with it */
+  double* communicate(double* sendBuf);
+
+  //! Get the left gradient & pack it into the outgoing buffer for the opposite processor
+  double* communicateGrad(double* sendBuf);
 
-  //! Send the right-state data across the processor boundary using MPI
-  void communicate(void);
+  //! Unpack the right state from the incoming buffer from the opposite processor
+  const double* receive(const double* recvBuf);
 
-  //! Send the right-state gradient data across the processor boundary using MPI
-  void communicateGrad();
+  //! Unpack the right gradient from the incoming buffer from the opposite processor
+  const double* receiveGrad(const double* recvBuf);
 
   int procL;               //! Processor ID on left  [this face]
   int procR;               //! Processor ID on right [opposite face]
@@ -97,15 +110,11 @@ private:
 
   matrix<double> bufUR;      //! Incoming buffer for receving UR
   Array<double,3> bufGradUR;  //! Incoming buffer for receving gradUR
-  Array<double,3> bufGradUL;      //! !! TEMP HACK !! Outgoing buffer for sending UL
+  vector<double> bufLiftR;    //! Incoming buffer for receiving liftR [BR2]
 
 #ifndef _NO_MPI
   MPI_Comm myComm;
 
-  MPI_Request UL_out;
-  MPI_Request UR_in;
-  MPI_Request gradUL_out;
-  MPI_Request gradUR_in;
   MPI_Request nFpts_out;
   MPI_Request nFpts_in;
 
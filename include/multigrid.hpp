@@ -37,6 +37,18 @@
 #include "solver.hpp"
 
 
+/*! P- [and optionally H-] multigrid acceleration using the FAS scheme
+ *
+ * The coarse p-levels are full solvers on the same mesh as the fine level.
+ * For static, non-overset meshes they share the fine level's geo object
+ * rather than reading & partitioning the mesh again.  With batched element
+ * storage, restriction & prolongation are applied to whole eleBlocks at once.
+ *
+ * With HMG, the cycle continues below the coarsest [P = 0] p-level through
+ * n_h_levels coarser meshes: either the input mesh refined [HMG = 1; 2D], or
+ * the input mesh's cells agglomerated 2^nDims at a time [HMG = 2; see
+ * geo::agglomerate].
+ */
 class multiGrid
 {
   private:
@@ -44,22 +56,64 @@ class multiGrid
     vector<input> pInputs, hInputs;
     int order;
     vector<shared_ptr<solver>> pGrids, hGrids;
-    vector<shared_ptr<geo>> pGeos, hGeos;
+    vector<shared_ptr<geo>> hGeos;
     shared_ptr<geo> fine_grid;
 
-    //! For nested HMG method
+    //! HMG: cell of h-level H [global ID] containing each cell of the next-finer level [global ID]
     vector<vector<int>> parent_cells;
+
+    //! HMG: cells of the next-finer level [local] making up each cell of h-level H [padded with -1]
     vector<matrix<int>> child_cells;
 
-    void restrict_pmg(solver &grid_fine, solver &grid_coarse);
+    //! Restrict the solution & residual of grid_fine to grid_coarse
+    void restrict_pmg(solver &grid_fine, solver &grid_coarse, bool residual = true);
+
+    //! Add the prolonged coarse-level correction to the fine-level solution
     void prolong_err(solver &grid_c, solver &grid_f);
+
+    //! FMG: Replace the fine-level solution with the prolonged coarse-level solution
+    void prolong_sol(solver &grid_c, solver &grid_f);
+
     void compute_source_term(solver &grid);
 
+    //! Store the starting solution of a coarse level [sol_spts]
+    void store_solution(solver &grid);
+
+    //! Form the coarse-level correction [corr_spts = U_spts - sol_spts]
+    void compute_correction(solver &grid);
+
+    //! Add the coarse-level source term to the residual
+    void add_source_term(solver &grid);
+
+    /*! Restrict grid_f [whose residual must be current] to p-level P, cycle
+     *  there, and add the resulting correction back to grid_f */
+    void coarse_correction(solver &grid_f, int P);
+
+    //! One cycle on coarse p-level P [V or W, recursing to the coarser levels]
+    void cycle_level(int P);
+
+    //! Downward & upward sweep through the h-levels below the coarsest p-level
+    void cycle_hmg(void);
+
+    //! Full-multigrid start-up: converge each coarse level in turn, then interpolate up
+    void full_multigrid(solver &Solver);
+
+    //! Restrict the solution & residual of grid_f to h-level H [grid_c]
     void restrict_hmg(solver &grid_f, solver&grid_c, uint H);
+
+    //! Add the correction of h-level H [grid_c] to the next-finer level
     void prolong_hmg(solver &grid_c, solver&grid_f, uint H);
+
     void setup_h_level(geo& mesh_c, geo& mesh_f, int refine_level);
 
+    //! Find the local children of each local cell of grid_c, given the parent of each global cell of grid_f
+    void setup_children(solver &grid_f, solver &grid_c, const vector<int> &parent, matrix<int> &children);
+
   public:
     void setup(int order, input *params, solver& Solver);
     void cycle(solver &Solver);
+
+    /*! Add the memory held by each coarse level to the tally, as "multigrid: P<p>"
+     *  or "multigrid: H<h>" [a level's mesh is counted unless it is Solver's] */
+    void addMemUsage(memTally &mem, solver &Solver);
 };
@@ -0,0 +1,136 @@
+/*!
+ * \file newtonKrylov.hpp
+ * \brief Header file for the newtonKrylov class
+ *
+ * Jacobian-free Newton-Krylov implicit time integration
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#pragma once
+
+#include <vector>
+
+#include "global.hpp"
+
+#include "blockJacobian.hpp"
+#include "input.hpp"
+#include "matrix.hpp"
+
+class solver;
+
+/*! Implicit time integration using a Jacobian-free Newton-Krylov method
+ *
+ * Each implicit stage requires the solution of
+ *   G(U) = (U - U*) / (gamma*dt) + R(U) = 0,
+ * where R = divF/|J| is the (physical-space) FR residual computed by
+ * solver::calcResidual, and U* collects the known terms of the scheme
+ * [BDF1, BDF2 or ESDIRK3].  Newton's method is used, with each linear system
+ * solved by restarted GMRES using finite-difference Jacobian-vector products
+ * and right preconditioning.
+ *
+ * The block-Jacobi preconditioner uses the element-diagonal blocks of dR/dU,
+ * computed by finite differences over a coloring of the element graph in which
+ * no two elements sharing a color are within each other's residual stencil,
+ * or else assembled analytically [see blockJacobian].
+ */
+class newtonKrylov
+{
+public:
+  //! Set up the scheme, work vectors & preconditioner data
+  void setup(input *inParams, solver *inSolver);
+
+  //! Advance the solution by one time step of size params->dt
+  void timeStep(void);
+
+  //! Add the memory held by the work vectors & preconditioner to the tally
+  void addMemUsage(memTally &mem);
+
+private:
+  input *params = NULL;
+  solver *Solver = NULL;
+
+  int nEles;
+  int N;               //! Number of local degrees of freedom
+  vector<int> offset;  //! Offset of each element's DOFs in the global vectors
+  vector<int> nDOF;    //! Number of DOFs of each element
+
+  /* --- Time-Integration Scheme --- */
+  int nStages;
+  double gamma;                //! Implicit (diagonal) coefficient of the scheme
+  vector<vector<double>> A;    //! DIRK coefficients [ESDIRK only]
+  vector<double> c;            //! Stage times
+  int nSteps = 0;              //! Number of time steps taken so far [for BDF2 start-up]
+
+  /* --- Work Vectors --- */
+  vector<double> U, Un, Unm1, Ustar, G, R, dU, Up, Rp;
+  vector<vector<double>> Rstage;  //! Stage residuals [ESDIRK]
+
+  /* --- GMRES --- */
+  vector<vector<double>> V;    //! Krylov basis
+  vector<double> z;            //! Preconditioned basis vector
+  matrix<double> H;            //! Hessenberg matrix
+  vector<double> cs, sn, s;    //! Givens rotations & residual vector
+
+  /* --- Block-Jacobi Preconditioner --- */
+  vector<int> color;
+  int nColors = 0;
+  vector<vector<double>> dRdU;  //! Element diagonal blocks of dR/dU [nDOF x nDOF, row-major]
+  vector<vector<double>> LU;    //! LU factors of I/(gamma*dt) + dR/dU
+  vector<vector<int>> piv;      //! Pivots for LU
+  double factorGDt = 0;         //! gamma*dt for which LU is current
+  int stepsSinceJac = -1;       //! Time steps since dR/dU was last computed
+  blockJacobian Jac;            //! Analytic dR/dU [precondType 2]
+
+  //! Copy the solution from / to the elements
+  void getState(vector<double> &vec);
+  void setState(const vector<double> &vec);
+
+  //! Evaluate the residual R(u) [leaves the solution u in the elements]
+  void calcR(const vector<double> &u, vector<double> &res);
+
+  //! Solve G(U) = 0 for one implicit stage; returns the final ||G||
+  double solveStage(double gdt, double tStage);
+
+  //! Jacobian-vector product, given the unperturbed R(U)
+  void applyJ(const vector<double> &v, vector<double> &Jv, double gdt);
+
+  //! Apply the preconditioner: out = M^-1 * in
+  void applyPrecond(const vector<double> &in, vector<double> &out);
+
+  //! Restarted, right-preconditioned GMRES for J x = b; returns # of iterations
+  int gmres(const vector<double> &b, vector<double> &x, double gdt);
+
+  //! Greedy coloring of the element graph [distance-1, or distance-2 for viscous]
+  void setupColoring(void);
+
+  //! Element-diagonal blocks of dR/dU [finite-difference, or analytic]
+  void calcBlockJacobian(void);
+
+  //! LU-factor I/(gamma*dt) + dR/dU for each element
+  void factorBlocks(double gdt);
+
+  //! Global dot product & norm
+  double dot(const vector<double> &a, const vector<double> &b);
+  double norm(const vector<double> &a);
+};
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <map>
+#include <string>
 #include <vector>
 
 #include "global.hpp"
@@ -38,12 +39,61 @@
 #include "input.hpp"
 #include "matrix.hpp"
 #include "points.hpp"
+#include "polynomials.hpp"
+
+/*! Sum-factorized (sparse) form of a tensor-product FR operator
+ *
+ *  On quads & hexes, each row of the extrapolation, gradient, and correction
+ *  operators is non-zero only along the single 1D line of solution points
+ *  through that row's point, so applying only those P+1 entries per row is
+ *  equivalent to applying the 1D operator along each line: O(P^4) rather
+ *  than O(P^6) work per hex. */
+class sumFactOper
+{
+public:
+  //! Extract the non-zero entries of a dense operator
+  void setup(matrix<double> &op);
+
+  //! B = Op*A [A & B may span an entire eleBlock]
+  void timesMatrix(matrix<double> &A, matrix<double> &B);
+
+  //! B += Op*A
+  void timesMatrixPlus(matrix<double> &A, matrix<double> &B);
+
+  //! Whether the operator is sparse enough to be worth using in place of the dense form
+  bool isActive(void) { return active; }
+
+  //! Bytes held by the sparse form
+  size_t getMemUsage(void) const { return memBytes(rowStart, cols, vals); }
+
+private:
+  uint nRows = 0, nCols = 0;
+  bool active = false;
+
+  vector<uint> rowStart;  //! Start of each row in cols & vals [size nRows+1]
+  vector<uint> cols;
+  vector<double> vals;
+
+  void mult(matrix<double> &A, matrix<double> &B, bool zero);
+};
 
 class oper
 {
 public:
-  //! Overall setup function for one element type & polynomial order
-  void setupOperators(uint eType, uint order, geo* inGeo, input* inParams);
+  /*! Overall setup function for one element type & polynomial order
+   *  If 'packed' is given, the dense operators are read from it [see
+   *  packOperators] rather than computed */
+  void setupOperators(uint eType, uint order, geo* inGeo, input* inParams, const char* packed = NULL);
+
+  //! Append the dense operators to buf [for the operator cache / broadcast]
+  void packOperators(vector<char> &buf);
+
+  //! Add the memory held by the operators to the tally, as "oper: <type> P<order>"
+  void addMemUsage(memTally &mem);
+
+  /*! Everything the dense operators depend on, for a given element type & order
+   *  [the key of the operator cache] */
+  static string cacheKey(uint eType, uint order, input* params);
 
   //! Setup operator for extrapolation from solution points to flux points
   void setupExtrapolateSptsFpts(vector<point> &loc_fpts);
@@ -79,6 +129,10 @@ public:
 
   void setupCorrectGradU(void);
 
+  /*! Setup the BR2 lifting coefficients: the corrected gradient's response, at
+   *  each flux point, to a unit jump in the solution at that point */
+  void setupLifting(void);
+
   void applyGradSpts(matrix<double> &U_spts, vector<matrix<double> > &dU_spts);
 
   void applyGradFSpts(vector<matrix<double>> &F_spts, Array<matrix<double>,2>& dF_spts);
@@ -103,19 +157,42 @@ public:
 
   void applyCorrectGradU(matrix<double>& dUc_fpts, vector<matrix<double> >& dU_spts, vector<matrix<double> > &JGinv_spts, vector<double> &detJac_spts);
 
-  /*! Shock Capturing in the element */
-  double shockCaptureInEle(matrix<double> &U_spts, double threshold);
+  /*! Apply the gradient correction in the reference domain only [e.g. for all elements in an eleBlock at once] */
+  void applyCorrectGradU(matrix<double>& dUc_fpts, vector<matrix<double> >& dU_spts);
+
+  /*! Transform the corrected solution gradient from reference to physical space */
+  void applyTransformGradU(vector<matrix<double> >& dU_spts, vector<matrix<double> > &JGinv_spts, vector<double> &detJac_spts);
+
+  /*! Extrapolate the uncorrected [reference] gradient to the flux points in
+   *  physical space, leaving dU_spts untouched [BR2 viscous flux] */
+  void applyExtrapolateGradU(vector<matrix<double> >& dU_spts, vector<matrix<double> > &JGinv_spts, vector<double> &detJac_spts, vector<matrix<double> >& dU_fpts);
+
+  /*! Concentration-method shock sensor for the element [quads] */
+  double shockSensor(matrix<double> &U_spts);
+
+  /*! Apply the exponential modal filter to several elements' solutions at
+   *  once, gathered into a single [nSpts x nEles*nFields] matrix product */
+  void applyFilter(vector<matrix<double>*> &U_spts);
 
   const matrix<double>& get_oper_div_spts();
   const matrix<double>& get_oper_spts_fpts();
 
+  /* Dense forms of the FR operators [e.g. for linearization of the residual] */
+  const matrix<double>& get_oper_grad_spts_dim(int dim);
+  const matrix<double>& get_oper_correction();
+  const matrix<double>& get_oper_correctU(int dim);
+
+  //! BR2 lifting coefficient at each flux point [see setupLifting]
+  const vector<double>& get_lift_fpts();
+
   map<int,matrix<double>*> get_oper_grad_spts;
   map<int,matrix<double>*> get_oper_correct;
 
   //! Calculate average density over an element (needed for negative-density correction)
   void calcAvgU(matrix<double>& U_spts, vector<double>& detJ_spts, vector<double>& Uavg);
 
-  matrix<double> interpolateCorrectedFlux(vector<matrix<double> >& F_spts, matrix<double>& dFn_fpts, point refLoc);
+  //! Corrected flux Fi [nDims,nFields] at refLoc, in reference space
+  void interpolateCorrectedFlux(vector<matrix<double> >& F_spts, matrix<double>& dFn_fpts, point refLoc, matrix<double>& Fi);
 
   matrix<double> opp_prolong;   //! PMG Prolongation operator
   matrix<double> opp_restrict;  //! PMG Restriction operator
@@ -133,8 +210,24 @@ private:
   matrix<double> opp_correction;
   vector<matrix<double>> opp_correctU;
   vector<matrix<double>> opp_correctF;
+  vector<double> lift_fpts;       //! BR2 lifting coefficient at the flux points [reference element]
+
+  vector<matrix<double>> tempFn;  //! Per-thread scratch space for applyExtrapolateFn
+  vector<double> wts_spts;        //! Quadrature weights at the solution points [for calcAvgU]
 
-  matrix<double> tempFn;
+  lagrangeBasis1D basis1D;        //! 1D Lagrange basis on the solution points [quads & hexes]
+
+  //! Values of all nSpts tensor-product Lagrange modes at the reference location loc [quads & hexes]
+  void evalTensorBasis(const double* loc, double* basis);
+
+  /* Sum-factorized forms of the above [see sumFactOper] */
+  sumFactOper sf_spts_to_fpts;
+  vector<sumFactOper> sf_grad_spts;
+  sumFactOper sf_correction;
+  vector<sumFactOper> sf_correctU;
+
+  //! Set up the sum-factorized operators [when available & requested]
+  void setupSumFactorization(void);
 
   void setupCorrectF(vector<point> &loc_spts);
 
@@ -159,4 +252,19 @@ private:
 
   /* P-Multigrid */
   void setupPMG(int my_order);
+
+  //! All dense operators, in their packed order
+  vector<matrix<double>*> denseOperators(void);
 };
+
+/*! Persistent cache of packed FR operators, keyed by oper::cacheKey
+ *
+ *  The file holds "FLURRYOP", a version number & the # of records, then per
+ *  record: the key length & key, the packed size & the packed operators. */
+typedef map<string,vector<char>> operCacheMap;
+
+//! Read an operator cache file; returns false if it does not exist or is not valid
+bool readOperCache(const string &fileName, operCacheMap &cache);
+
+//! Write an operator cache file [replacing any existing one]
+void writeOperCache(const string &fileName, const operCacheMap &cache);
@@ -33,18 +33,87 @@
 #include "ele.hpp"
 #include "geo.hpp"
 
-/*! Write solution to file (of type params->plotType) */
+/*! Header of a binary restart [checkpoint] file
+ *
+ * The header is followed by a partition table of nParts x {nEles, offset,
+ * nBytes} [int64_t], then by the element records of each partition.  Each
+ * element record is {IDg, eType, order, nSpts} [int] followed by U_spts as
+ * nSpts x nFields doubles.  A shared file [restartType 1] holds all ranks'
+ * partitions; a per-rank file [restartType 2] holds only its own [part >= 0].
+ * The element records are keyed by global element ID, so the files can be read
+ * by any number of ranks [see solver::readRestartBinary]. */
+struct restartHeader
+{
+  char magic[8];  //! "FLURRYRS"
+  int version;
+  int nDims;
+  int nFields;
+  int nParts;     //! # of partitions [ranks] in the table
+  int part;       //! Rank which wrote a per-rank file [-1 for a shared file]
+  int iter;
+  double time;
+  double dt;
+  int nRanks;     //! # of ranks which wrote the file(s) [version >= 2]
+};
+
+/*! Name of the binary restart file for the given iteration [& rank, if per-rank] */
+string getRestartFileName(input *params, int iter, int rank);
+
+/*! Write a binary restart file [type params->restartType] */
+void writeRestartFile(solver *Solver, input *params);
+
+/*! Plot-point data of one element, staged for writing to a .vtu file */
+struct plotEle
+{
+  int order;
+  vector<point> ppts;
+  matrix<double> V;        //! Primitive variables at the plot points
+  matrix<double> gridVel;  //! Grid velocity at the plot points [moving grids]
+  matrix<double> err;      //! Entropy-error estimate at the plot points
+  double sensor;
+  int iblank;
+};
+
+/*! Snapshot of everything needed to write one rank's .vtu file, so that the
+ *  formatting & writing can proceed [in the background] while the solver
+ *  continues to advance the solution */
+struct plotData
+{
+  string fileName;
+  int iter;
+  double time;
+  vector<int> iblankCell;
+  vector<plotEle> eles;
+};
+
+/*! Write solution to file (of type params->plotType)
+ *  With asyncOutput, ParaView files are written by a background thread */
 void writeData(solver *Solver, input *params);
 
+/*! Wait for any pending background output to finish */
+void finishOutput(void);
+
 /*! Write solution data to a CSV file. */
 void writeCSV(solver *Solver, input *params);
 
 /*! Write solution data to a Paraview .vtu file. */
 void writeParaview(solver *Solver, input *params);
 
-/*! Compute the residual and print to both the terminal and history file. */
+/*! Interpolate the solution to the plot points and copy it into 'data'
+ *  Also writes the .pvtu file [MPI]; returns false if this rank has nothing to write */
+bool stageParaview(solver *Solver, input *params, plotData &data);
+
+/*! Format and write a staged .vtu file [touches no solver data, and makes no MPI calls] */
+void writeParaviewFile(const plotData &data, input *params);
+
+/*! Compute the residual and print to both the terminal and history file.
+ *  In parallel, the reduction across ranks is non-blocking, and the line is
+ *  written once it completes [see finishMonitors] */
 void writeResidual(solver *Solver, input *params);
 
+/*! Complete any in-flight residual / error reductions & write their output */
+void finishMonitors(void);
+
 /*! Compute and display all error norms */
 void writeAllError(solver *Solver, input *params);
 
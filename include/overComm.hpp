@@ -34,6 +34,7 @@
 
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -82,9 +83,10 @@ public:
   shared_ptr<ADT> adt;   //! Alternating Digital Tree for searching
 #endif
 
+  matrix<int> *c2c = NULL;  //! Cell-to-cell connectivity of grid partition [for searching around cached donors]
+
   /* --- Variables for Exchanging Data at Overset Faces --- */
 
-  vector<int> nPts_rank;           //! Number of fringe points for each rank of current grid
   vector<vector<int>> foundPts;    //! IDs of receptor points from each grid which were found to lie within current grid
   vector<vector<int>> foundRank;   //! gridRank of this process for each found point (for benefit of other processes; probably not needed)
   vector<vector<int>> foundEles;   //! Ele ID which each matched point was found to lie within
@@ -104,6 +106,24 @@ public:
   matrix<double> gradU_in;          //! Gradient data received from other grid(s)
   vector<matrix<double>> gradU_out; //! Interpolated gradient data being sent to other grid(s)
 
+  /* --- Multirate time stepping: data of the last two exchanges [solution, gradient] --- */
+  matrix<double> U_in0, U_in1, gradU_in0, gradU_in1;
+  double tIn0[2], tIn1[2];     //! Times of the data in U_in0 / U_in1 [& gradU_in0 / gradU_in1]
+  int nStored[2] = {0, 0};     //! # of exchanges stored so far
+
+  /*! Interpolation from the donor cells to the points being sent to one rank,
+   *  stored in CSR form: row i holds the basis weights at point i of each
+   *  solution point in the row's donor cell */
+  struct interpMatrix
+  {
+    vector<int> rowPtr;            //! Offset of each row within 'weights' [size nRows+1]
+    vector<double> weights;        //! Basis weights of the donor's solution points
+    vector<double> gradTransform;  //! Static grids: invJaco^T/detJac at each point [nDims x nDims per row]
+  };
+
+  vector<interpMatrix> interpMat;  //! Interpolation to the points found for each rank
+  bool newDonors = true;           //! Have the donors changed since the last exchange?
+
   /* --- Variables for Exchanging Data on Unblanked Cells --- */
 
   vector<int> nCells_rank;              //! Number of unblanked cells for each rank of current grid
@@ -128,6 +148,9 @@ public:
 
   void setup(input *_params, int _nGrids, int _gridID, int _gridRank, int _nprocPerGrid, vector<int> &_gridIdList);
 
+  //! Add the memory held by the overset data structures to the tally [not counting TIOGA's]
+  void addMemUsage(memTally &mem);
+
   void setIblanks2D(matrix<double> &xv, matrix<int>& overFaces, matrix<int> &wallFaces, vector<int> &iblank);
 
   //! Find all elements from eles which overlap with target bounding-box
@@ -136,10 +159,13 @@ public:
   /*!
    * \brief Match up each overset-face flux point to its donor grid and element
    *
-   * @param[in] c2ac    : List (for each cell in grid partition) of all cells which share at least one vertex
+   * The partition bounding boxes are exchanged first, so that each point is
+   * only sent to [and searched for on] the ranks of other grids which could
+   * contain it.
+   *
    * @param[in] eleMap  : 'Map' from the grid-global cell ID to its index within 'eles' vector (or -1 if blanked cell)
-   * @param[in] centroid: Centriod of current grid partition
-   * @param[in] extents : x,y,z extents (max-min) of current grid partition
+   * @param[in] minPt   : Minimum x,y,z of current grid partition
+   * @param[in] maxPt   : Maximum x,y,z of current grid partition
    */
   void matchOversetPoints(vector<shared_ptr<ele>> &eles, const vector<int> &eleMap, const point &minPt = point({0,0,0}), const point &maxPt = point({0,0,0}));
 
@@ -167,6 +193,13 @@ public:
   //! Perform the interpolation and communicate gradient across all grids
   void exchangeOversetGradient(vector<shared_ptr<ele>> &eles, map<int, map<int,oper> > &opers, vector<int> &eleMap);
 
+  //! Multirate: keep the data just exchanged into U_in [or gradU_in], at time t
+  void storeFringeData(double t, bool grad);
+
+  /*! Multirate: set U_in [or gradU_in] to its value at time t, extrapolated
+   *  linearly in time from the last two exchanges [held constant after the first] */
+  void extrapolateFringeData(double t, bool grad);
+
   /*!
    * \brief Gather a distributed dataset so that every rank has the full, organized dataset
    *
@@ -222,4 +255,14 @@ private:
 
   //! For use with ADT in 2D
   vector<int> eleList;
+
+  //! Build the interpolation matrices for the current donors
+  void setupInterpolation(vector<shared_ptr<ele>> &eles, map<int,map<int,oper>> &opers, vector<int> &eleMap);
+
+  /*! Send the interpolated values to the ranks which requested them; the
+   *  counts & destination indices are only exchanged when the donors change */
+  void sendInterpolatedData(vector<matrix<double>> &sendVals, matrix<double> &recvVals, int nVars);
+
+  //! Find the point within cell ic0 [warm-starting from loc0] or its face neighbors; returns the cell ID or -1
+  int checkNearDonor(vector<shared_ptr<ele>> &eles, const vector<int> &eleMap, const point &pt, int ic0, const point &loc0, point &refLoc);
 };
@@ -62,10 +62,10 @@ public:
   void setRightStateSolution(void);
 
   //! Do nothing [not a wall boundary]
-  vector<double> computeWallForce(void);
+  void computeWallForce(double* force);
 
   //! Do nothing [not an inlet/outlet boundary]
-  vector<double> computeMassFlux(void);
+  void computeMassFlux(double* flux);
 
   //! Return the physical position of the face's flux points
   vector<point> getPosFpts(void);
@@ -76,6 +76,8 @@ public:
   //! Override normal version when using flux-interp method
   void rusanovFlux(void);
 
+  void addMemUsage(memTally &mem);
+
   int fptOffset;         //! Offset within Solver's mesh block-global interp point list
   vector<point> posFpts; //! Physical locations of left ele's flux points
 
@@ -26,9 +26,31 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA..
  *
  */
+#pragma once
 
 #include "global.hpp"
 
+/*! 1D Lagrange basis on a fixed set of points, in barycentric form
+ *
+ *  l_j(y) = [w_j/(y-x_j)] / sum_k [w_k/(y-x_k)], with the barycentric weights
+ *  w_j = 1/prod_{k!=j}(x_j-x_k) computed once in setup, so that all modes at a
+ *  point cost O(P) together rather than O(P) each [see Lagrange] */
+class lagrangeBasis1D
+{
+public:
+  void setup(const vector<double> &x_lag);
+
+  //! # of modes [points]
+  uint size(void) const { return x.size(); }
+
+  //! Evaluate all modes at point y [l: size()]
+  void eval(double y, double* l) const;
+
+private:
+  vector<double> x;  //! Interpolation points
+  vector<double> w;  //! Barycentric weights
+};
+
 /*! Evaluate the 1D Lagrange polynomial mode based on points x_lag at point y */
 double Lagrange(vector<double> &x_lag, double y, uint mode);
 
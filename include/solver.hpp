@@ -31,6 +31,7 @@
 #include <memory>
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 class oper;
@@ -42,6 +43,8 @@ class overFace;
 #include "geo.hpp"
 #include "input.hpp"
 #include "face.hpp"
+#include "faceBlock.hpp"
+#include "faceComm.hpp"
 #include "intFace.hpp"
 #include "boundFace.hpp"
 #include "mpiFace.hpp"
@@ -49,6 +52,10 @@ class overFace;
 #include "overFace.hpp"
 #include "operators.hpp"
 #include "superMesh.hpp"
+#include "taskGraph.hpp"
+
+class newtonKrylov;
+class deviceBackend;
 
 #ifndef _NO_MPI
 class tioga;
@@ -71,6 +78,9 @@ public:
   //! Vector of all eles handled by this solver
   vector<shared_ptr<ele>> eles;
 
+  //! Map from eType to order to contiguous solution storage [if params->batchStorage]
+  map<int, map<int,eleBlock> > eleBlocks;
+
   //! Vector of all non-MPI faces handled by this solver
   vector<shared_ptr<face>> faces;
 
@@ -80,6 +90,24 @@ public:
   //! Vector of all MPI faces handled by this solver
   vector<shared_ptr<overFace>> overFaces;
 
+  //! Aggregated (per-neighbor-rank) communication for the MPI faces
+  faceComm mpiFaceComm;
+
+  //! Map from face type to contiguous flux-point storage [if params->faceBatching]
+  map<int,faceBlock> faceBlocks;
+
+  //! Implicit (Newton-Krylov) time integrator [if params->implicitTime]
+  shared_ptr<newtonKrylov> NK;
+
+  //! GPU residual evaluation & time advancement [if params->gpu]
+  shared_ptr<deviceBackend> device;
+
+  //! Face-neighbor elements of each element [for residual smoothing & implicit preconditioning]
+  vector<vector<int>> eleNbrs;
+
+  //! Element-mean residual, before & after smoothing [+ scratch space for Jacobi iterations]
+  matrix<double> resMean, resSmooth, resTmp;
+
   //! Local supermesh of donor elements for each cell needing to be unblanked
   vector<superMesh> donors;
 
@@ -105,15 +133,53 @@ public:
   //! Setup the solver with the given simulation parameters & geometry
   void setup(input *params, int order, geo* _Geo = NULL);
 
+  //! Setup the elements, faces, operators & communication for the current Geo
+  void setupFromGeo(void);
+
+  /*! Ensemble runs: take the FR operators of another member on the same mesh
+   *  & discretization, so that setup computes none of its own [call before setup] */
+  void shareOperators(solver &lead);
+
+  /*! Add the memory held by the solver's elements, operators, faces & other
+   *  data to the tally [not counting the mesh; see geo::addMemUsage] */
+  void addMemUsage(memTally &mem);
+
+  /*!
+   * \brief Dynamic load rebalancing
+   *
+   * Estimate each rank's load from the cost of its elements; if the imbalance
+   * (max/avg) exceeds params->rebalanceTol, repartition the grid with the
+   * current element costs as weights, migrate the solution of each element to
+   * its new rank, and rebuild the elements & faces.
+   *
+   * @return Whether the grid was repartitioned
+   */
+  bool rebalance(void);
+
   //! Setup the FR operators for all ele types and polynomial orders which will be used in computation
   void setupOperators();
 
   //! Run the basic setup functions for all elements and faces
   void setupElesFaces();
 
+  //! Allocate the batched (eType,order) storage and assign each ele its place in it
+  void setupEleBlocks();
+
+  //! Group the faces by concrete type into faceBlocks for batched flux calculation
+  void setupFaceBlocks();
+
+  //! Find the face neighbors of each element [eleNbrs]
+  void setupEleNbrs();
+
+  //! Set up the data for implicit residual smoothing
+  void setupResidualSmoothing();
+
   //! If restarting from data file, read data and setup eles & faces accordingly
   void readRestartFile();
 
+  //! Read a binary restart file [see restartHeader & params->restartType]
+  void readRestartBinary();
+
   //! Finish setting up the MPI faces
   void finishMpiSetup(void);
 
@@ -122,14 +188,43 @@ public:
   //! Apply the initial condition to all elements
   void initializeSolution(bool PMG = false);
 
+  //! Once the solution is set: initial overset projection [static grids] & wave speeds
+  void finishSolutionSetup(void);
+
+  //! Copy the latest solution back from the GPU [if params->gpu] before any output
+  void syncHost(void);
+
   void update(bool PMG_Source = false);
 
+  /*! Advance one time step with a low-storage RK scheme [see input::lowStorageRK],
+   *  adapting dt if requested */
+  void updateLowStorage(bool PMG_Source = false);
+
+  //! Advance one step of size params->dt with a classical RK scheme
+  void stepRK(bool PMG_Source = false);
+
+  /*! Multirate time stepping between overset grids [params->multirate]: each
+   *  grid takes as many steps of its own stable dt as needed to cover one step
+   *  of the coarsest grid; the fringe data is exchanged at the start of each
+   *  such macro step, and extrapolated in time for the sub-steps */
+  void updateMultirate(bool PMG_Source = false);
+
   //! Perform one full step of computation
   void calcResidual(int step);
 
+  /*! Perform one full step of computation, with all element-local stages fused
+   *  into as few sweeps over the elements as possible [see fuseKernels]
+   *  If 'advance', the RK update for this stage is included in the final sweep */
+  void calcResidualFused(int step, bool advance = false, bool PMG_Source = false);
+
   //! Calculate the stable time step limit based upon given CFL
   void calcDt(void);
 
+  /*! Implicit residual smoothing [steady-state acceleration; see input::resSmoothing]
+   *  Jacobi iterations for (1 - eps*Laplacian) Rbar = R, where R = dt*divF and
+   *  the Laplacian couples each element to the mean of its face neighbors */
+  void smoothResidual(int step, bool PMG_Source = false);
+
   //! Advance solution in time - Generate intermediate RK stage
   void timeStepA(int step, bool PMG_Source = false);
 
@@ -185,6 +280,10 @@ public:
    *  from the solution points to the flux points */
   void extrapolateGradU(void);
 
+  /*! BR2 viscous flux: extrapolate the uncorrected [physical] gradient of the
+   *  solution to the flux points, ahead of the MPI exchange */
+  void extrapolateGradU_uncorrected(void);
+
   //! Calculate the viscous flux at the solution points
   void calcViscousFlux_spts(void);
 
@@ -227,9 +326,20 @@ public:
   //! For implemented test cases, calculate the L1 error over the domain
   vector<double> integrateError(void);
 
+  //! This rank's contribution to integrateError [before the sum over ranks & the L2 sqrt]
+  vector<double> integrateErrorLocal(void);
+
   /* === Functions for Shock Capturing & Filtering=== */
 
-  //! Use concentration sensor + exponential modal filter to capture discontinuities
+  /*!
+   * \brief Use concentration sensor + exponential modal filter to capture discontinuities
+   *
+   * Every scSensorFreq iterations, all elements are sensed, and the troubled
+   * elements plus their face neighbours are kept in troubledEles; in between,
+   * only the listed elements are sensed [and the neighbours of any newly
+   * troubled element are added].  The filter is applied to all of the
+   * troubled elements of each type & order as one batched operation.
+   */
   void shockCapture(void);
 
   /* === Functions Related to Adaptation === */
@@ -237,20 +347,37 @@ public:
   //! Calculate an entropy-adjoint-based error indicator
   void calcEntropyErr_spts();
 
+  /*!
+   * \brief Flag the elements whose order should change [p_adapt_cells & eleOrders]
+   *
+   * The indicator of each element is the max. magnitude of its entropy error
+   * [S_spts]; elements above pAdaptRefine x the mean indicator are raised one
+   * order, and those below pAdaptCoarsen x the mean are lowered one order
+   * [within pAdaptMin-pAdaptMax].  Elements flagged by the shock sensor are
+   * never raised.
+   */
+  void get_p_adapt_cells();
+
+  /*!
+   * \brief Change the order of the flagged elements
+   *
+   * All elements & faces are re-built, with mortars between elements of
+   * different order; the solution is transferred by interpolation.
+   *
+   * @return Whether any element [on any rank] changed order
+   */
+  bool setup_p_adaptation();
+
   // **All of the following functions are just food for thought at the moment**
 
   void get_r_adapt_cells();
 
-  void get_p_adapt_cells();
-
   void get_h_adapt_cells();
 
   void setup_r_adaption();
 
   void setup_h_adaptation();
 
-  void setup_p_adaptation();
-
   void add_ele(int eType, int order);
 
   /* === Functions Related to Overset Grids === */
@@ -307,6 +434,11 @@ public:
   //! Interpolate 'right state' gradient to overset boundaries for viscous flux
   void oversetInterp_gradient();
 
+  //! Multirate: whether the next overset interpolation of the solution [0] / gradient [1]
+  //! exchanges data between the grids [start of a macro step], rather than extrapolating it
+  bool fringeSync[2] = {true, true};
+  int nSubSteps = 0;  //! Multirate: # of sub-steps of this grid in the last macro step
+
   /* ---- Stabilization Functions ---- */
 
   void calcAvgSolution();
@@ -329,9 +461,59 @@ private:
   //! Lists of cells to apply various adaptation methods to
   vector<int> r_adapt_cells, h_adapt_cells, p_adapt_cells;
 
+  //! Shock capturing: elements sensed every step [troubled elements & their halo]
+  vector<int> troubledEles;
+  vector<char> isListed;  //! Whether each element is in troubledEles
+  int scSweepIter = -1;   //! Iteration of the last sweep over all elements
+  vector<int> troubled;   //! Elements filtered in the current step
+  vector<matrix<double>*> filterU;  //! Solutions of the elements of one type & order to filter
+
+  //! p-adaptation: order of each element [by global ID] which differs from the baseline order
+  unordered_map<int,int> eleOrders;
+
+  //! Append an element's restart-style record {IDg, eType, order, nSpts, U_spts} to buf
+  void packEleRecord(ele *e, vector<char> &buf);
+
+  //! Re-build the elements & faces from the current Geo & eleOrders, then restore the solution from the records in recs
+  void rebuildElesFaces(const vector<char> &recs);
+
+  //! Restore the solution of our elements from the records in [ptr,end); returns the # of elements found
+  int applyEleRecords(const char *ptr, const char *end);
+
+#ifndef _NO_MPI
+  //! Send the element records in each [start,end) range to the ranks now owning the elements; recs gets ours
+  void redistributeEleRecords(const vector<pair<const char*,const char*>> &segs, vector<char> &recs);
+#endif
+
+  /* ---- Fused residual evaluation [see calcResidualFused] ---- */
+
+  //! Sweep 1 over eles[i0:i1]: solution [& BR2 gradient] at the flux points [+ squeezing]
+  void fusedSweep1(int i0, int i1, bool copyU0);
+
+  //! Sweep 2 over eles[i0:i1]: corrected gradient at the solution [& flux] points
+  void fusedSweep2(int i0, int i1);
+
+  //! Sweep 3 over eles[i0:i1]: corrected divergence of the flux [+ RK update]
+  void fusedSweep3(int i0, int i1, int step, bool advance, bool PMG_Source);
+
+  /*! Task graph of one residual evaluation [see taskResidual]: element chunks
+   *  & face chunks, with the MPI exchanges completed by their own tasks */
+  taskGraph resTasks;
+
+  //! Arguments of the residual evaluation being run by resTasks
+  int taskStep;
+  bool taskAdvance, taskPMGSource;
+
+  //! Build resTasks for the current elements & faces
+  void setupResidualTasks(void);
+
+  //! Run the fused residual evaluation as a task graph, without global barriers
+  void calcResidualTasks(int step, bool advance, bool PMG_Source);
+
   /* ---- Overset Grid Variables / Functions ---- */
 
   vector<double> U_spts; //! Global solution vector for solver (over all elements)
+  vector<int> sptStart;  //! Index of each element's first solution point in U_spts [per field]
 
   //shared_ptr<overComm> OComm;
 
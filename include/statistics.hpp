@@ -0,0 +1,98 @@
+/*!
+ * \file statistics.hpp
+ * \brief Header file for the statistics class
+ *
+ * In-situ running time averages & second moments of the flow
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+#pragma once
+
+#include <vector>
+
+#include "global.hpp"
+#include "input.hpp"
+#include "solver.hpp"
+
+/*! Header of a [per-rank] statistics file
+ *
+ * The header is followed by the # of element records [int64], then per
+ * element: {IDg, eType, order, nSpts} [ints] & nSpts x nStats doubles, as in
+ * the binary restart files.  The statistics of each solution point are the
+ * means of the nFields primitive variables, the means of their squares, and
+ * [Navier-Stokes] the means of the velocity products uv, uw, vw. */
+struct statsHeader
+{
+  char magic[8];       //! "FLURRYST"
+  int version;
+  int nDims;
+  int nStats;          //! # of statistics per solution point
+  int part;            //! Rank which wrote the file
+  int iter;
+  int nSamples;        //! # of samples in the averages
+  double time;
+  double tAvg;         //! Length of the averaging window
+  double wallMean[6];  //! Mean wall force [inviscid xyz, viscous xyz; all ranks]
+  double wallSq[6];    //! Mean square of the wall force
+};
+
+/*! In-situ flow statistics
+ *
+ * Running [time-weighted] means of the primitive variables & of their second
+ * moments are accumulated at the solution points every statsFreq iterations,
+ * along with those of the total wall force, so that time averages & Reynolds
+ * stresses need no high-frequency volume output.  Variances follow as
+ * <q^2> - <q>^2, & Reynolds stresses as <uv> - <u><v>.  The statistics are
+ * written with every restart checkpoint [restart_freq] & at the end of the
+ * run, and are read back on restart to continue the averages. */
+class statistics
+{
+public:
+  //! Allocate the statistics [or read them back, on restart]
+  void setup(input *params, solver *Solver);
+
+  //! Add the current solution to the averages, if a sample is due
+  void accumulate(void);
+
+  //! Write the statistics file for the current iteration, & the wall-force averages
+  void write(void);
+
+private:
+  input *params = NULL;
+  solver *Solver = NULL;
+
+  int nStats;
+  int nSamples = 0;
+  double tAvg = 0;     //! Length of the averaging window so far
+  double tLast = -1;   //! Time of the last sample [-1: none yet]
+
+  vector<matrix<double>> eleStats;  //! nSpts x nStats per local element
+  double wallMean[6], wallSq[6];
+
+  //! Name of this rank's statistics file for the given iteration
+  string getFileName(int iter, int rank);
+
+  //! Read the statistics written at the restart iteration; false if there are none
+  bool read(void);
+};
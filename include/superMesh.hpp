@@ -43,15 +43,12 @@
 struct tetra
 {
   array<point,4> nodes;    //! Positions of nodes in tet
-  vector<point> qpts;      //! Physical positions of quadrature points in tet
-  //vector<double> weights;  //! Weights associated with each quadrature point
   int donorID;             //! Donor-grid cell ID to which tetra belongs
 };
 
 struct triangle
 {
   array<point,3> nodes;    //! Positions of nodes in tri
-  vector<point> qpts;      //! Physical positions of quadrature points in tri
   int donorID;             //! Donor-grid cell ID to which tetra belongs
 };
 
@@ -90,11 +87,15 @@ superMesh(vector<point> &_target, Array2D<point> &_donors, int _order, int _nDim
   vector<triangle> tris; //! triangles comprising the supermesh [for 2D]
   vector<int> parents;   //! Parent donor-cell ID for each tet [range 0:(nDonors-1)]
   vector<double> vol;    //! Volume of each simplex
+  vector<point> qptsPhys; //! Physical positions of the quadrature points of all simplices [nSimps x nQpts_simp]
 
   /* ---- Member Functions ---- */
 
   void setup(vector<point> &_target, Array2D<point> &_donors, int _order, int nDims);
 
+  //! Bytes held by the supermesh & its quadrature data
+  size_t getMemUsage(void) const;
+
   //! Using given grids and target cell, build the local supermesh
   void buildSuperMesh(void);
 
@@ -124,6 +125,9 @@ superMesh(vector<point> &_target, Array2D<point> &_donors, int _order, int _nDim
   //! Get the quadrature point locations and weights, and find physical positions of all qpts
   void setupQuadrature(void);
 
+  //! Was this supermesh built from exactly the given target & donor nodes?
+  bool hasInputs(const vector<point> &_target, Array2D<point> &_donors);
+
   //! Print the simplices of the superMesh to a CSV file
   void printSuperMesh(int rank, int ID);
 
@@ -140,17 +144,20 @@ private:
 
 /* --- Extra Helper Functions --- */
 
-//! Subdivide the given hexahedron into 5 tetrahedrons
-vector<tetra> splitHexIntoTets(const vector<point> &hexNodes);
+//! Subdivide the given hexahedron into 5 tetrahedrons [appended to outTets]
+void splitHexIntoTets(const point *hexNodes, vector<tetra> &outTets);
+
+//! Subdivide the given quadrilateral into 2 triangles [appended to outTris]
+void splitQuadIntoTris(const point *quadNodes, vector<triangle> &outTris);
 
-//! Subdivide the given quadrilateral into 2 triangles
-vector<triangle> splitQuadIntoTris(const vector<point> &quadNodes);
+//! Clip the given tet by the plane through xc with outward normal norm; the remaining tets are appended to outTets
+void clipTet(const tetra &tet, const point &xc, const Vec3 &norm, vector<tetra> &outTets);
 
-//! Use the given face and outward normal to clip the given tet and return the new set of tets
-vector<tetra> clipTet(tetra &tet, const vector<point> &clipFace, Vec3 &norm);
+//! Clip the given triangle by the line through xc with outward normal norm; the remaining tris are appended to outTris
+void clipTri(const triangle &tri, const point &xc, const Vec3 &norm, vector<triangle> &outTris);
 
-//! Use the given face and outward normal to clip the given triangle and return the new set of tris
-vector<triangle> clipTri(triangle &tri, const vector<point> &clipFace, Vec3 &norm);
+//! Hash of the node positions a supermesh would be built from [for reusing unchanged supermeshes]
+size_t hashSuperMeshInputs(const vector<point> &target, Array2D<point> &donors);
 
 double getAreaTri(std::array<point,3> &nodes);
 
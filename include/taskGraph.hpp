@@ -0,0 +1,84 @@
+/*!
+ * \file taskGraph.hpp
+ * \brief Header file for taskGraph class
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA..
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include "global.hpp"
+
+/*! A static graph of tasks with explicit dependencies, executed with OpenMP tasks
+ *
+ * Each node runs once per call to run(), as soon as all of its predecessors
+ * have finished, on whichever thread is free [the OpenMP runtime's
+ * work-stealing task scheduler]; there are no barriers other than the one at
+ * the end of run().  A node may also wait on an external event [see
+ * addDependency / release], e.g. the arrival of an MPI message.
+ *
+ * Without OpenMP, the nodes are run in a valid (depth-first) order.
+ */
+class taskGraph
+{
+public:
+  //! Add a node running 'work'; returns its ID
+  int addNode(std::function<void(void)> work);
+
+  //! Node 'to' may not start until node 'from' has finished
+  void addEdge(int from, int to);
+
+  //! Node 'to' may not start until release(to) has been called [once per run()]
+  void addDependency(int to);
+
+  //! Satisfy one external dependency of the given node [from within a running node]
+  void release(int node);
+
+  //! Run all nodes & wait for them to finish
+  void run(void);
+
+  int size(void) { return nodes.size(); }
+
+private:
+  struct node {
+    std::function<void(void)> work;
+    vector<int> next;       //! Nodes depending on this one
+    int nDeps = 0;          //! Total # of dependencies [edges + external]
+  };
+
+  vector<node> nodes;
+
+  //! # of dependencies of each node not yet satisfied in the current run
+  vector<std::atomic<int>> pending;
+
+  //! Run a node, then spawn each successor whose last dependency it was
+  void execute(int n);
+
+  //! Run a node as a new task [or immediately, without OpenMP]
+  void spawn(int n);
+};
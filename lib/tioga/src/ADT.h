@@ -47,6 +47,12 @@ public :
 
   void buildADT(int d,int nelements,double *elementBbox);
 
+  //! Update the node extents for moved element boxes, keeping the tree's structure
+  void refitADT(void);
+
+  //! Number of elements in the tree
+  int getNElem(void) { return nelem; }
+
   //! Search the ADT for the element containint the point xsearch
   void searchADT_point(MeshBlock *mb,int *cellIndex,double *xsearch);
 
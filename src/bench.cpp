@@ -0,0 +1,443 @@
+/*!
+ * \file bench.cpp
+ * \brief Microbenchmarks for the FR kernels [make bench]
+ *
+ * Usage: FlurryBench [maxOrder] [DOFs per case] [options file]
+ *
+ * For quads & hexes of each order, a periodic box mesh of about the given
+ * number of solution points is set up, and each stage of the residual is
+ * timed on its own.  Options in the [optional] options file take precedence
+ * over the benchmark's defaults, e.g. to compare batchStorage or fuseKernels.
+ *
+ * Each kernel is placed on a roofline: its FLOP count [for the operator
+ * applications] and the bytes it moves give its arithmetic intensity, to be
+ * compared with the machine balance [peak GFLOP/s over the STREAM-triad
+ * bandwidth measured at startup].  On Linux, the hardware counters of all
+ * threads are read through perf_event: instructions per cycle, and the
+ * memory traffic as the # of last-level cache misses x 64 B; without them
+ * [e.g. perf_event_paranoid > 2], the compulsory traffic of the kernel's
+ * input & output arrays is used instead.
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "global.hpp"
+#include "input.hpp"
+#include "solver.hpp"
+#include "superMesh.hpp"
+
+/*! Hardware counters of all OpenMP threads [Linux perf_event; user space only] */
+class hwCounters
+{
+public:
+  bool available = false;
+
+  enum {CYCLES, INSTRUCTIONS, LLC_MISSES, N_EVENTS};
+
+  //! Open the counters on each thread of the OpenMP thread pool
+  void setup(void)
+  {
+#ifdef __linux__
+    int nThreads = getMaxThreads();
+    fds.assign(nThreads*N_EVENTS, -1);
+
+    unsigned long long config[N_EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                           PERF_COUNT_HW_CACHE_MISSES};
+
+#pragma omp parallel
+    {
+      int thr = getThreadNum();
+      for (int ev=0; ev<N_EVENTS; ev++) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config[ev];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fds[thr*N_EVENTS+ev] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+      }
+    }
+
+    available = true;
+    for (int fd : fds)
+      if (fd < 0) available = false;
+#endif
+  }
+
+  //! Current totals over all threads
+  vector<double> read(void)
+  {
+    vector<double> counts(N_EVENTS, 0.);
+#ifdef __linux__
+    if (!available) return counts;
+
+    for (uint i=0; i<fds.size(); i++) {
+      long long val = 0;
+      if (::read(fds[i], &val, sizeof(val)) == sizeof(val))
+        counts[i%N_EVENTS] += val;
+    }
+#endif
+    return counts;
+  }
+
+private:
+  vector<int> fds;  //! [thread][event]
+};
+
+static hwCounters counters;
+
+//! Time & hardware counts per call of a kernel
+struct kernelStats {
+  double t;
+  vector<double> counts;
+};
+
+/*! Average time & counts per call of f [s], repeating it for at least minTime seconds */
+template<typename Func>
+static kernelStats timeKernel(Func f, double minTime = 0.2)
+{
+  f();  // Warm-up
+
+  long nCalls = 0;
+  long batch = 1;
+  double elapsed = 0;
+  auto c0 = counters.read();
+  auto t0 = std::chrono::steady_clock::now();
+  while (elapsed < minTime) {
+    for (long i=0; i<batch; i++)
+      f();
+    nCalls += batch;
+    batch *= 2;
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  }
+  auto c1 = counters.read();
+
+  kernelStats stats;
+  stats.t = elapsed/nCalls;
+  for (uint i=0; i<c0.size(); i++)
+    stats.counts.push_back((c1[i] - c0[i])/nCalls);
+
+  return stats;
+}
+
+static double streamBW = 0;  //! STREAM-triad bandwidth [GB/s]
+
+/*! Print one result: time per call, points per second, [dense-matrix-
+ *  equivalent] GFLOP/s for the operator applications, memory traffic [GB/s
+ *  & % of the STREAM bandwidth], arithmetic intensity & IPC.  'bytes' is the
+ *  compulsory traffic of the kernel, used when there are no hardware counters */
+
+static void report(const string &eType, int order, int nEles, const string &kernel, const kernelStats &stats,
+                   double nPts, double flops, double bytes)
+{
+  double t = stats.t;
+  if (counters.available)
+    bytes = 64*stats.counts[hwCounters::LLC_MISSES];
+
+  cout << setw(6) << left << eType << setw(7) << right << order << setw(10) << nEles << "  ";
+  cout << setw(22) << left << kernel << right;
+  cout.setf(ios::fixed, ios::floatfield);
+  cout << setprecision(2) << setw(14) << t*1e6 << setw(12) << nPts/t*1e-6;
+
+  if (flops > 0)
+    cout << setw(10) << flops/t*1e-9;
+  else
+    cout << setw(10) << "-";
+
+  if (bytes > 0) {
+    cout << setw(10) << bytes/t*1e-9 << setw(8) << setprecision(0) << 100*bytes/t*1e-9/streamBW;
+    cout << setprecision(2);
+  }
+  else
+    cout << setw(10) << "-" << setw(8) << "-";
+
+  if (flops > 0 && bytes > 0)
+    cout << setw(10) << flops/bytes;
+  else
+    cout << setw(10) << "-";
+
+  if (counters.available && stats.counts[hwCounters::CYCLES] > 0)
+    cout << setw(8) << stats.counts[hwCounters::INSTRUCTIONS]/stats.counts[hwCounters::CYCLES];
+  else
+    cout << setw(8) << "-";
+
+  cout << endl;
+  cout.unsetf(ios::floatfield);
+}
+
+/*! STREAM triad, a = b + s*c, over arrays much larger than the caches [GB/s] */
+static double benchStream(void)
+{
+  int n = 1<<24;
+  vector<double> a(n), b(n, 1.), c(n, 2.);
+
+  auto stats = timeKernel([&](){
+#pragma omp parallel for
+    for (int i=0; i<n; i++)
+      a[i] = b[i] + 3.*c[i];
+  });
+
+  return 3.*8.*n/stats.t*1e-9;
+}
+
+/*! Benchmark each stage of the residual on a periodic box of quads [2D] or hexes [3D] */
+static void benchEleType(int nDims, int order, double nDofs, const string &optsFile)
+{
+  int nSpts1D = order+1;
+  int nx = max(2,(int)round(pow(nDofs/pow(nSpts1D,nDims),1./nDims)));
+
+  /* --- Generate the input file: user options first, so they take precedence --- */
+  string fileName = "bench_input.tmp";
+  ofstream inFile(fileName.c_str());
+  if (!optsFile.empty()) {
+    ifstream opts(optsFile.c_str());
+    if (!opts.is_open())
+      FatalError("Unable to open benchmark options file.");
+    inFile << opts.rdbuf() << endl;
+  }
+  inFile << "equation 1" << endl;
+  inFile << "nDims " << nDims << endl;
+  inFile << "order " << order << endl;
+  inFile << "viscous 1" << endl;
+  inFile << "Re 100" << endl;
+  inFile << "MachBound 0.2" << endl;
+  inFile << "icType 0" << endl;
+  inFile << "dtType 0" << endl;
+  inFile << "dt 1e-6" << endl;
+  inFile << "iterMax 1" << endl;
+  inFile << "meshType 1" << endl;
+  inFile << "nx " << nx << endl << "ny " << nx << endl << "nz " << nx << endl;
+  inFile << "xmin 0" << endl << "xmax 1" << endl;
+  inFile << "ymin 0" << endl << "ymax 1" << endl;
+  inFile << "zmin 0" << endl << "zmax 1" << endl;
+  inFile.close();
+
+  input params;
+  params.rank = 0;
+  params.nproc = 1;
+
+  // Silence the setup output
+  stringstream sink;
+  auto coutBuf = cout.rdbuf(sink.rdbuf());
+
+  params.readInputFile(&fileName[0]);
+  remove(fileName.c_str());
+
+  solver Solver;
+  Solver.setup(&params,order);
+  Solver.initializeSolution();
+
+  cout.rdbuf(coutBuf);
+
+  // Fill in all intermediate data once
+  Solver.calcResidual(0);
+
+  string eType = (nDims == 2) ? "quad" : "hex";
+  auto &op = Solver.opers[(nDims == 2) ? QUAD : HEX][order];
+  double nSpts = op.get_oper_spts_fpts().getDim1();
+  double nFpts = op.get_oper_spts_fpts().getDim0();
+  int nEles = Solver.eles.size();
+  int nFields = params.nFields;
+
+  double nFacePts = 0;
+  for (auto &f:Solver.faces)
+    nFacePts += f->nFptsL;
+
+  double dofs = nSpts*nEles;
+  double fe = nFields*nEles;  // # of columns each operator is applied to
+
+  /* Compulsory traffic: each input & output array once, 8 B per value
+   * [w: one value per field per element; g: one value per element] */
+  double w = 8*fe, g = 8.*nEles;
+  double facePt = 8*nFields*nFacePts;
+
+  kernelStats t;
+  t = timeKernel([&](){ Solver.extrapolateU(); });
+  report(eType,order,nEles,"spts->fpts",t,dofs,2*nFpts*nSpts*fe,(nSpts+nFpts)*w);
+
+  t = timeKernel([&](){ Solver.calcGradU_spts(); });
+  report(eType,order,nEles,"gradU spts",t,dofs,2*nDims*nSpts*nSpts*fe,(1+nDims)*nSpts*w);
+
+  t = timeKernel([&](){ Solver.correctGradU(); });
+  report(eType,order,nEles,"correct gradU",t,dofs,2*nDims*nSpts*nFpts*fe,
+         (2*nFpts + 2*nDims*nSpts)*w + nSpts*(nDims*nDims+1)*g);
+
+  t = timeKernel([&](){ Solver.calcInviscidFlux_spts(); });
+  report(eType,order,nEles,"inviscidFlux spts",t,dofs,0,(1+nDims)*nSpts*w + nSpts*nDims*nDims*g);
+
+  t = timeKernel([&](){ Solver.calcViscousFlux_spts(); });
+  report(eType,order,nEles,"viscousFlux spts",t,dofs,0,(1+3*nDims)*nSpts*w + nSpts*nDims*nDims*g);
+
+  t = timeKernel([&](){ Solver.calcFluxDivergence(0); });
+  report(eType,order,nEles,"div F spts",t,dofs,2*nDims*nSpts*nSpts*fe,(1+nDims)*nSpts*w);
+
+  t = timeKernel([&](){ Solver.extrapolateNormalFlux(); });
+  report(eType,order,nEles,"normal flux fpts",t,dofs,2*nDims*nFpts*nSpts*fe,
+         nDims*nSpts*w + nFpts*w + nFpts*nDims*g);
+
+  t = timeKernel([&](){ Solver.correctDivFlux(0); });
+  report(eType,order,nEles,"correction",t,dofs,2*nSpts*nFpts*fe,(3*nFpts + 2*nSpts)*w);
+
+  int riemannType = params.riemannType;
+  params.riemannType = 0;
+  t = timeKernel([&](){ Solver.calcInviscidFlux_faces(); });
+  report(eType,order,nEles,"Rusanov faces",t,nFacePts,0,4*facePt);
+
+  if (nDims == 2 && Solver.faceBlocks.empty()) {
+    // Roe is 2D-only, and batched face blocks only implement the Rusanov flux
+    params.riemannType = 1;
+    t = timeKernel([&](){ Solver.calcInviscidFlux_faces(); });
+    report(eType,order,nEles,"Roe faces",t,nFacePts,0,4*facePt);
+  }
+  params.riemannType = riemannType;
+
+  t = timeKernel([&](){ Solver.calcViscousFlux_faces(); });
+  report(eType,order,nEles,"LDG viscous faces",t,nFacePts,0,(6+2*nDims)*facePt);
+
+  t = timeKernel([&](){ Solver.calcResidual(0); });
+  report(eType,order,nEles,"calcResidual",t,dofs,0,0);
+}
+
+/*! Benchmark the construction of a local supermesh: a unit target cell
+ *  overlapped by a shifted 2x2[x2] block of donor cells */
+static void benchSuperMesh(int nDims)
+{
+  vector<point> target;
+  Array2D<point> donors;
+
+  int nNodes = (nDims == 2) ? 4 : 8;
+  double xn[8] = {0,1,1,0,0,1,1,0};
+  double yn[8] = {0,0,1,1,0,0,1,1};
+  double zn[8] = {0,0,0,0,1,1,1,1};
+
+  for (int n=0; n<nNodes; n++) {
+    point pt;
+    pt.x = xn[n];
+    pt.y = yn[n];
+    pt.z = (nDims == 3) ? zn[n] : 0.;
+    target.push_back(pt);
+  }
+
+  int nk = (nDims == 2) ? 1 : 2;
+  for (int k=0; k<nk; k++) {
+    for (int j=0; j<2; j++) {
+      for (int i=0; i<2; i++) {
+        vector<point> cell;
+        for (int n=0; n<nNodes; n++) {
+          point pt = target[n];
+          pt.x = .7*(pt.x+i) - .3;
+          pt.y = .7*(pt.y+j) - .2;
+          if (nDims == 3) pt.z = .7*(pt.z+k) - .1;
+          cell.push_back(pt);
+        }
+        donors.insertRow(cell);
+      }
+    }
+  }
+
+  superMesh mesh(target,donors,4,nDims);
+
+  auto t = timeKernel([&](){ mesh.buildSuperMesh(); });
+  double nSimps = (nDims == 2) ? mesh.tris.size() : mesh.tets.size();
+  report((nDims == 2) ? "quad" : "hex", 0, donors.getDim0(), "buildSuperMesh", t, nSimps, 0, 0);
+}
+
+static void usage(const char *prog)
+{
+  cout << "Usage: " << prog << " [maxOrder >= 1; default: 5] [DOFs per case > 0; default: 2e5] [options file]" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+  int maxOrder = 5;
+  double nDofs = 2e5;
+  string optsFile;
+
+  if (argc > 4) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  for (int i=1; i<argc; i++) {
+    if (!strcmp(argv[i],"-h") || !strcmp(argv[i],"--help")) {
+      usage(argv[0]);
+      return 0;
+    }
+  }
+
+  char *end;
+  if (argc > 1) {
+    long val = strtol(argv[1],&end,10);
+    if (*end != '\0' || val < 1) {
+      cout << "Invalid maxOrder '" << argv[1] << "'" << endl;
+      usage(argv[0]);
+      return 1;
+    }
+    maxOrder = val;
+  }
+  if (argc > 2) {
+    nDofs = strtod(argv[2],&end);
+    if (*end != '\0' || !(nDofs > 0)) {
+      cout << "Invalid # of DOFs per case '" << argv[2] << "'" << endl;
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (argc > 3) optsFile = argv[3];
+
+  counters.setup();
+  streamBW = benchStream();
+
+  cout << "Flurry++ kernel benchmarks [" << getMaxThreads() << " thread(s), ~" << nDofs << " DOFs per case]" << endl;
+  cout << "  Mpts/s: solution points [face flux points for face kernels; simplices for buildSuperMesh]" << endl;
+  cout << "  GFLOP/s: dense-operator equivalent [2 x rows x cols x nFields x nEles]" << endl;
+  cout << "  GB/s: " << (counters.available ? "last-level cache misses x 64 B [hardware counters]"
+                                             : "compulsory traffic [hardware counters unavailable]") << endl;
+  cout << "  %BW: of the STREAM-triad bandwidth, " << setprecision(3) << streamBW << " GB/s" << endl;
+  cout << "  FLOP/B: arithmetic intensity; compare with the machine balance [peak GFLOP/s / STREAM GB/s]" << endl << endl;
+
+  cout << setw(6) << left << "eType" << setw(7) << right << "order" << setw(10) << "nEles" << "  ";
+  cout << setw(22) << left << "kernel" << right << setw(14) << "us/call" << setw(12) << "Mpts/s" << setw(10) << "GFLOP/s";
+  cout << setw(10) << "GB/s" << setw(8) << "%BW" << setw(10) << "FLOP/B" << setw(8) << "IPC" << endl;
+
+  for (int nDims=2; nDims<=3; nDims++)
+    for (int order=1; order<=maxOrder; order++)
+      benchEleType(nDims,order,nDofs,optsFile);
+
+  benchSuperMesh(2);
+  benchSuperMesh(3);
+}
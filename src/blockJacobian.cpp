@@ -0,0 +1,491 @@
+/*!
+ * \file blockJacobian.cpp
+ * \brief blockJacobian class definition
+ *
+ * Block-sparse linearization of the FR residual
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "blockJacobian.hpp"
+
+#include <unordered_map>
+
+#include "flux.hpp"
+#include "solver.hpp"
+
+void blockJacobian::setup(input *inParams, solver *inSolver)
+{
+  params = inParams;
+  Solver = inSolver;
+
+  if (params->meshType == OVERSET_MESH)
+    FatalError("blockJacobian: overset grids not supported.");
+
+  if (params->motion)
+    FatalError("blockJacobian: moving grids not supported.");
+
+  if (params->slipPenalty)
+    FatalError("blockJacobian: slipPenalty boundary condition not supported.");
+
+  auto &eles = Solver->eles;
+  nEles = eles.size();
+  nDims = params->nDims;
+  nFields = params->nFields;
+
+  if (nEles == 0) return;
+
+  /* --- All elements share one set of operators --- */
+  int eType = eles[0]->eType;
+  int order = eles[0]->order;
+  for (auto &e:eles)
+    if (e->eType != eType || e->order != order)
+      FatalError("blockJacobian: all elements must be of the same type & order.");
+
+  nSpts = eles[0]->nSpts;
+  nFpts = eles[0]->nFpts;
+  bs = nSpts*nFields;
+
+  oper &op = Solver->opers[eType][order];
+  opE = op.get_oper_spts_fpts();
+  opC = op.get_oper_correction();
+  opD.resize(nDims);
+  for (int dim=0; dim<nDims; dim++)
+    opD[dim] = op.get_oper_grad_spts_dim(dim);
+
+  if (params->viscous) {
+    opCU.resize(nDims);
+    for (int dim=0; dim<nDims; dim++)
+      opCU[dim] = op.get_oper_correctU(dim);
+  }
+
+  /* --- Element-face connectivity --- */
+  unordered_map<ele*,int> eleInd;
+  for (int i=0; i<nEles; i++)
+    eleInd[eles[i].get()] = i;
+
+  links.resize(nEles);
+  for (int i=0; i<nEles; i++)
+    links[i].assign(eles[i]->faceID.size(),faceLink());
+
+  vector<face*> allFaces;
+  for (auto &F:Solver->faces) allFaces.push_back(F.get());
+  for (auto &F:Solver->mpiFaces) allFaces.push_back(F.get());
+
+  for (auto F:allFaces) {
+    int iL = eleInd[F->getLeftEle()];
+    int iR = -1;
+    int locF_R = -1;
+    if (F->getRightEle() != NULL && !F->myInfo.isBnd) {
+      iR = eleInd[F->getRightEle()];
+      locF_R = F->myInfo.IDR;
+    }
+
+    faceLink &LL = links[iL][F->locF_L];
+    LL.F = F;
+    LL.isLeft = true;
+    LL.nbr = iR;
+    LL.nbrFace = locF_R;
+
+    if (iR >= 0) {
+      faceLink &LR = links[iR][locF_R];
+      LR.F = F;
+      LR.isLeft = false;
+      LR.nbr = iL;
+      LR.nbrFace = F->locF_L;
+    }
+  }
+
+  /* --- Block-sparse structure: the diagonal, then one block per local neighbor --- */
+  rowStart.resize(nEles+1);
+  faceSlot.resize(nEles);
+  colInd.resize(0);
+  for (int i=0; i<nEles; i++) {
+    rowStart[i] = colInd.size();
+    colInd.push_back(i);
+
+    faceSlot[i].assign(links[i].size(),-1);
+    for (uint j=0; j<links[i].size(); j++) {
+      if (links[i][j].nbr < 0) continue;
+      faceSlot[i][j] = colInd.size();
+      colInd.push_back(links[i][j].nbr);
+    }
+  }
+  rowStart[nEles] = colInd.size();
+
+  blocks.assign((size_t)colInd.size()*bs*bs,0.);
+}
+
+int blockJacobian::eleFpt(int e, int j, int fpt)
+{
+  const faceLink &L = links[e][j];
+  if (L.isLeft)
+    return L.F->fptStartL + fpt;
+  else
+    return L.F->getFptR(fpt);
+}
+
+void blockJacobian::assemble(void)
+{
+  /* --- Linearize the common fluxes on all faces --- */
+#pragma omp parallel for
+  for (uint i=0; i<Solver->faces.size(); i++)
+    Solver->faces[i]->calcFluxJacobian();
+
+#pragma omp parallel for
+  for (uint i=0; i<Solver->mpiFaces.size(); i++)
+    Solver->mpiFaces[i]->calcFluxJacobian();
+
+  /* --- Assemble each element's row --- */
+#pragma omp parallel for
+  for (int e=0; e<nEles; e++)
+    assembleRow(e);
+}
+
+void blockJacobian::multiply(const vector<double> &x, vector<double> &y)
+{
+#pragma omp parallel for
+  for (int e=0; e<nEles; e++) {
+    double *ye = &y[(size_t)e*bs];
+    for (int i=0; i<bs; i++)
+      ye[i] = 0;
+
+    for (int slot=rowStart[e]; slot<rowStart[e+1]; slot++) {
+      const double *B = getBlock(slot);
+      const double *xc = &x[(size_t)colInd[slot]*bs];
+      for (int i=0; i<bs; i++) {
+        double sum = 0;
+        for (int j=0; j<bs; j++)
+          sum += B[i*bs+j]*xc[j];
+        ye[i] += sum;
+      }
+    }
+  }
+}
+
+void blockJacobian::calcGradJacobian(int e, int j, vector<vector<double>> &GJ)
+{
+  auto &el = Solver->eles[e];
+  int nF = nFields;
+
+  /* Q_ref[dim](spt) = D[dim]*U + CU[dim]*(Uc - E*U);  Uc = A_L*U_L + A_R*U_R */
+  vector<vector<double>> ref(nDims, vector<double>((size_t)bs*bs,0.));
+
+  auto addFaceTerm = [&](int fe, int g, const double *A) {
+    for (int dim=0; dim<nDims; dim++) {
+      for (int spt=0; spt<nSpts; spt++) {
+        double cu = opCU[dim](spt,fe);
+        if (cu == 0) continue;
+        for (int s=0; s<nSpts; s++) {
+          double c = cu*opE(g,s);
+          if (c == 0) continue;
+          for (int k=0; k<nF; k++)
+            for (int m=0; m<nF; m++)
+              ref[dim][(spt*nF+k)*bs + s*nF+m] += c*A[k*nF+m];
+        }
+      }
+    }
+  };
+
+  if (j < 0) {
+    for (int dim=0; dim<nDims; dim++) {
+      for (int spt=0; spt<nSpts; spt++) {
+        for (int s=0; s<nSpts; s++) {
+          double val = opD[dim](spt,s);
+          for (int fpt=0; fpt<nFpts; fpt++)
+            val -= opCU[dim](spt,fpt)*opE(fpt,s);
+          for (int k=0; k<nF; k++)
+            ref[dim][(spt*nF+k)*bs + s*nF+k] += val;
+        }
+      }
+    }
+
+    for (uint j2=0; j2<links[e].size(); j2++) {
+      const faceLink &L = links[e][j2];
+      if (L.F == NULL) continue;
+      for (int fpt=0; fpt<L.F->nFptsL; fpt++) {
+        int fe = eleFpt(e,j2,fpt);
+        const double *A = (L.isLeft) ? L.F->dUcdUL[fpt] : L.F->dUcdUR[fpt];
+        addFaceTerm(fe,fe,A);
+      }
+    }
+  }
+  else {
+    const faceLink &L = links[e][j];
+    for (int fpt=0; fpt<L.F->nFptsL; fpt++) {
+      int fe = eleFpt(e,j,fpt);
+      int g = eleFpt(L.nbr,L.nbrFace,fpt);
+      const double *A = (L.isLeft) ? L.F->dUcdUR[fpt] : L.F->dUcdUL[fpt];
+      addFaceTerm(fe,g,A);
+    }
+  }
+
+  /* --- Transform to physical space --- */
+  GJ.resize(nDims);
+  for (int dim=0; dim<nDims; dim++) {
+    GJ[dim].assign((size_t)bs*bs,0.);
+    for (int spt=0; spt<nSpts; spt++) {
+      for (int dim2=0; dim2<nDims; dim2++) {
+        double fac = el->JGinv_spts[spt](dim2,dim) / el->detJac_spts[spt];
+        if (fac == 0) continue;
+        for (int i=spt*nF*bs; i<(spt+1)*nF*bs; i++)
+          GJ[dim][i] += fac*ref[dim2][i];
+      }
+    }
+  }
+}
+
+void blockJacobian::assembleRow(int e)
+{
+  auto &el = Solver->eles[e];
+  int nF = nFields;
+  int nDF = nDims*nFields;
+  int nF2 = nFields*nFields;
+  bool viscous = params->viscous;
+  int nFaces = links[e].size();
+
+  /* --- Point flux Jacobians at the solution points, transformed to the reference domain
+   * Aref: d(Fref[dim])/dU [nSpts,nDims,nFields,nFields]
+   * Bref: d(Fref[dim])/d(gradU) [nSpts,nDims,nFields,nDims*nFields] --- */
+  vector<double> Aref(nSpts*nDims*nF2,0.), Bref;
+  vector<double> dFdU(nDims*nF2), dFvdU(nDims*nF2), dFvdQ(nDF*nDF);
+  matrix<double> gradU(nDims,nFields);
+  if (viscous) Bref.assign(nSpts*nDims*nF*nDF,0.);
+
+  for (int spt=0; spt<nSpts; spt++) {
+    inviscidFluxJacobian(el->U_spts[spt], dFdU.data(), params);
+
+    if (viscous) {
+      for (int dim=0; dim<nDims; dim++)
+        for (int k=0; k<nF; k++)
+          gradU(dim,k) = el->dU_spts[dim](spt,k);
+
+      viscousFluxJacobian(el->U_spts[spt], gradU, dFvdU.data(), dFvdQ.data(), params);
+
+      for (int i=0; i<nDims*nF2; i++)
+        dFdU[i] += dFvdU[i];
+    }
+
+    for (int dim1=0; dim1<nDims; dim1++) {
+      for (int dim2=0; dim2<nDims; dim2++) {
+        double fac = el->JGinv_spts[spt](dim1,dim2);
+        for (int i=0; i<nF2; i++)
+          Aref[(spt*nDims+dim1)*nF2+i] += fac*dFdU[dim2*nF2+i];
+        if (viscous)
+          for (int i=0; i<nF*nDF; i++)
+            Bref[(spt*nDims+dim1)*nF*nDF+i] += fac*dFvdQ[dim2*nF*nDF+i];
+      }
+    }
+  }
+
+  /* --- Divergence minus the correction of the discontinuous normal flux:
+   * M[dim] = D[dim] - C*diag(tNorm[dim])*E  [nSpts x nSpts] --- */
+  vector<double> M(nDims*nSpts*nSpts);
+  for (int dim=0; dim<nDims; dim++) {
+    for (int spt=0; spt<nSpts; spt++) {
+      for (int s=0; s<nSpts; s++) {
+        double val = opD[dim](spt,s);
+        for (int fpt=0; fpt<nFpts; fpt++)
+          val -= opC(spt,fpt)*el->tNorm_fpts(fpt,dim)*opE(fpt,s);
+        M[(dim*nSpts+spt)*nSpts+s] = val;
+      }
+    }
+  }
+
+  vector<vector<double>> GJ, GJn, GJtmp;
+  vector<vector<double>> dFref(nDims, vector<double>((size_t)bs*bs));
+  vector<double> T((size_t)nF*bs);
+
+  /* --- Loop over the columns of the row: self [j = -1], then each local neighbor --- */
+  for (int j=-1; j<nFaces; j++) {
+    if (j >= 0 && faceSlot[e][j] < 0) continue;
+
+    double *B = (j < 0) ? getDiagBlock(e) : getBlock(faceSlot[e][j]);
+    for (int i=0; i<bs*bs; i++)
+      B[i] = 0;
+
+    if (viscous)
+      calcGradJacobian(e,j,GJ);
+
+    /* --- d(Fref)/dU_j at the solution points --- */
+    for (int dim=0; dim<nDims; dim++) {
+      auto &dF = dFref[dim];
+      dF.assign((size_t)bs*bs,0.);
+
+      for (int spt=0; spt<nSpts; spt++) {
+        if (j < 0) {
+          for (int k=0; k<nF; k++)
+            for (int m=0; m<nF; m++)
+              dF[(spt*nF+k)*bs + spt*nF+m] = Aref[(spt*nDims+dim)*nF2 + k*nF+m];
+        }
+
+        if (viscous) {
+          for (int k=0; k<nF; k++) {
+            double *row = &dF[(spt*nF+k)*bs];
+            for (int q=0; q<nDF; q++) {
+              double b = Bref[((spt*nDims+dim)*nF+k)*nDF+q];
+              if (b == 0) continue;
+              const double *gj = &GJ[q/nF][(spt*nF+q%nF)*bs];
+              for (int c=0; c<bs; c++)
+                row[c] += b*gj[c];
+            }
+          }
+        }
+      }
+    }
+
+    /* --- Volume & discontinuous-normal-flux terms --- */
+    for (int spt=0; spt<nSpts; spt++) {
+      double invJ = 1./el->detJac_spts[spt];
+      for (int dim=0; dim<nDims; dim++) {
+        for (int s=0; s<nSpts; s++) {
+          double val = invJ*M[(dim*nSpts+spt)*nSpts+s];
+          if (val == 0) continue;
+          for (int k=0; k<nF; k++) {
+            double *row = &B[(spt*nF+k)*bs];
+            const double *dF = &dFref[dim][(s*nF+k)*bs];
+            for (int c=0; c<bs; c++)
+              row[c] += val*dF[c];
+          }
+        }
+      }
+    }
+
+    /* --- Common-flux terms --- */
+    for (int j2=0; j2<nFaces; j2++) {
+      const faceLink &L = links[e][j2];
+      if (L.F == NULL) continue;
+      face *F = L.F;
+      bool local = (L.nbr >= 0);
+
+      // Gradient of the neighbor, w.r.t. U_j
+      bool nbrGrad = false;
+      if (viscous && local) {
+        if (j < 0) {
+          // Through the neighbor's face(s) shared with this element
+          for (uint j3=0; j3<links[L.nbr].size(); j3++) {
+            if (links[L.nbr][j3].nbr != e) continue;
+            calcGradJacobian(L.nbr,j3,GJtmp);
+            if (!nbrGrad) {
+              GJn = GJtmp;
+              nbrGrad = true;
+            }
+            else {
+              for (int dim=0; dim<nDims; dim++)
+                for (int i=0; i<bs*bs; i++)
+                  GJn[dim][i] += GJtmp[dim][i];
+            }
+          }
+        }
+        else if (j == j2) {
+          calcGradJacobian(L.nbr,-1,GJn);
+          nbrGrad = true;
+        }
+      }
+
+      for (int fpt=0; fpt<F->nFptsL; fpt++) {
+        int fe = eleFpt(e,j2,fpt);
+        int g = (local) ? eleFpt(L.nbr,L.nbrFace,fpt) : -1;
+        double fac = (L.isLeft) ? el->dA_fpts[fe] : -el->dA_fpts[fe];
+
+        const double *dU_me = (L.isLeft) ? F->dFndUL[fpt] : F->dFndUR[fpt];
+        const double *dU_ot = (L.isLeft) ? F->dFndUR[fpt] : F->dFndUL[fpt];
+
+        for (auto &t:T) t = 0;
+
+        // Direct dependence on the discontinuous solution at the flux point
+        if (j < 0) {
+          for (int s=0; s<nSpts; s++) {
+            double ee = opE(fe,s);
+            if (ee == 0) continue;
+            for (int k=0; k<nF; k++)
+              for (int m=0; m<nF; m++)
+                T[k*bs + s*nF+m] += dU_me[k*nF+m]*ee;
+          }
+        }
+        else if (j == j2) {
+          for (int s=0; s<nSpts; s++) {
+            double ee = opE(g,s);
+            if (ee == 0) continue;
+            for (int k=0; k<nF; k++)
+              for (int m=0; m<nF; m++)
+                T[k*bs + s*nF+m] += dU_ot[k*nF+m]*ee;
+          }
+        }
+
+        // Dependence through the corrected gradient on either side
+        if (viscous) {
+          const double *dQ_me = (L.isLeft) ? F->dFndQL[fpt] : F->dFndQR[fpt];
+          const double *dQ_ot = (L.isLeft) ? F->dFndQR[fpt] : F->dFndQL[fpt];
+
+          for (int s=0; s<nSpts; s++) {
+            double ee = opE(fe,s);
+            if (ee == 0) continue;
+            for (int k=0; k<nF; k++) {
+              for (int q=0; q<nDF; q++) {
+                double d = ee*dQ_me[k*nDF+q];
+                if (d == 0) continue;
+                const double *gj = &GJ[q/nF][(s*nF+q%nF)*bs];
+                for (int c=0; c<bs; c++)
+                  T[k*bs+c] += d*gj[c];
+              }
+            }
+          }
+
+          if (nbrGrad) {
+            for (int s=0; s<nSpts; s++) {
+              double ee = opE(g,s);
+              if (ee == 0) continue;
+              for (int k=0; k<nF; k++) {
+                for (int q=0; q<nDF; q++) {
+                  double d = ee*dQ_ot[k*nDF+q];
+                  if (d == 0) continue;
+                  const double *gj = &GJn[q/nF][(s*nF+q%nF)*bs];
+                  for (int c=0; c<bs; c++)
+                    T[k*bs+c] += d*gj[c];
+                }
+              }
+            }
+          }
+        }
+
+        // Apply the correction function
+        for (int spt=0; spt<nSpts; spt++) {
+          double val = fac*opC(spt,fe)/el->detJac_spts[spt];
+          if (val == 0) continue;
+          for (int k=0; k<nF; k++) {
+            double *row = &B[(spt*nF+k)*bs];
+            for (int c=0; c<bs; c++)
+              row[c] += val*T[k*bs+c];
+          }
+        }
+      }
+    }
+  }
+}
+
+void blockJacobian::addMemUsage(memTally &mem)
+{
+  mem.add("newtonKrylov: preconditioner", memBytes(rowStart, colInd, faceSlot, links, blocks, opE, opC, opD, opCU));
+}
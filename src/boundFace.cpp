@@ -29,6 +29,7 @@
 #include "boundFace.hpp"
 
 #include <array>
+#include <cfloat>
 
 #include "flux.hpp"
 #include "points.hpp"
@@ -349,10 +350,10 @@ void boundFace::applyViscousBCs(void)
       double e = pR/((params->gamma-1.)*UR(fpt,0));
 
       // Get velocity gradients
-      matrix<double> gradVel(nDims,nDims);
+      double gradVel[3][3];
       for (int dim1=0; dim1<nDims; dim1++)
         for (int dim2=0; dim2<nDims; dim2++)
-          gradVel(dim1,dim2) = (gradUR[fpt](dim1,dim2+1) - gradUR[fpt](dim1,0)*UR(fpt,dim2+1)/UR(fpt,0))/UR(fpt,0);
+          gradVel[dim1][dim2] = (gradUR[fpt](dim1,dim2+1) - gradUR[fpt](dim1,0)*UR(fpt,dim2+1)/UR(fpt,0))/UR(fpt,0);
 
       // Set energy gradient (set gradT = 0) (TODO: only remove dT_d[wall normal])
       double vSq = 0.;
@@ -362,7 +363,7 @@ void boundFace::applyViscousBCs(void)
       for (int dim1=0; dim1<nDims; dim1++) {
         gradUR[fpt](dim1,nDims+1) = (e+0.5*vSq)*gradUR[fpt](dim1,0);
         for (int dim2=0; dim2<nDims; dim2++) {
-          gradUR[fpt](dim1,nDims+1) += UR(fpt,dim2+1)*gradVel(dim2,dim1);
+          gradUR[fpt](dim1,nDims+1) += UR(fpt,dim2+1)*gradVel[dim2][dim1];
         }
       }
     }
@@ -379,10 +380,87 @@ void boundFace::setRightStateSolution(void)
   // No right state; do nothing
 }
 
-vector<double> boundFace::computeWallForce(void)
+void boundFace::calcFluxJacobian(void)
 {
-  vector<double> force = {0,0,0,0,0,0};
+  /* The boundary state is a function of the interior state alone, so the BC and
+   * the common flux are linearized together using finite differences.  Since the
+   * flux points are independent, each variable is perturbed at all of them at once */
+
+  setupFluxJacobian();
+
+  int nDF = nDims*nFields;
+
+  // Save the current state [the flux routines also overwrite the wave speed]
+  matrix<double> UL0 = UL, UR0 = UR, Fn0 = Fn;
+  vector<matrix<double>> gradUL0 = gradUL, gradUR0 = gradUR;
+  vector<double> waveSp0(nFptsL);
+  for (int fpt=0; fpt<nFptsL; fpt++)
+    waveSp0[fpt] = *waveSp[fpt];
+
+  auto calcFn = [&]() {
+    applyBCs();
+    calcCommonInviscidFlux();
+    if (params->viscous) {
+      applyViscousBCs();
+      calcCommonViscousFlux();
+    }
+  };
+
+  calcFn();
+  matrix<double> FnB = Fn, URB = UR;
+
+  vector<double> h(nFptsL);
+  for (int m=0; m<nFields; m++) {
+    for (int fpt=0; fpt<nFptsL; fpt++) {
+      h[fpt] = sqrt(DBL_EPSILON) * max(1.,std::abs(UL0(fpt,m)));
+      UL(fpt,m) += h[fpt];
+    }
+
+    calcFn();
+
+    for (int fpt=0; fpt<nFptsL; fpt++) {
+      for (int k=0; k<nFields; k++)
+        dFndUL(fpt,k*nFields+m) = (Fn(fpt,k) - FnB(fpt,k)) / h[fpt];
+
+      if (params->viscous) {
+        // Common solution on boundaries: Uc = 0.5*(UL + UR(UL))
+        for (int k=0; k<nFields; k++)
+          dUcdUL(fpt,k*nFields+m) = 0.5*((UR(fpt,k) - URB(fpt,k)) / h[fpt] + ((k==m) ? 1. : 0.));
+      }
 
+      UL(fpt,m) = UL0(fpt,m);
+    }
+  }
+
+  if (params->viscous) {
+    for (int dim=0; dim<nDims; dim++) {
+      for (int m=0; m<nFields; m++) {
+        for (int fpt=0; fpt<nFptsL; fpt++) {
+          h[fpt] = sqrt(DBL_EPSILON) * max(1.,std::abs(gradUL0[fpt](dim,m)));
+          gradUL[fpt](dim,m) += h[fpt];
+        }
+
+        calcFn();
+
+        for (int fpt=0; fpt<nFptsL; fpt++) {
+          for (int k=0; k<nFields; k++)
+            dFndQL(fpt,k*nDF+dim*nFields+m) = (Fn(fpt,k) - FnB(fpt,k)) / h[fpt];
+
+          gradUL[fpt](dim,m) = gradUL0[fpt](dim,m);
+        }
+      }
+    }
+  }
+
+  // Restore the state
+  UL = UL0;  UR = UR0;  Fn = Fn0;
+  gradUL = gradUL0;  gradUR = gradUR0;
+  for (int fpt=0; fpt<nFptsL; fpt++)
+    *waveSp[fpt] = waveSp0[fpt];
+}
+
+void boundFace::computeWallForce(double* force)
+{
   if (bcType == SLIP_WALL || bcType == ADIABATIC_NOSLIP || bcType == ISOTHERMAL_NOSLIP) {
     int order;
     if (params->nDims == 2)
@@ -423,14 +501,10 @@ vector<double> boundFace::computeWallForce(void)
       }
     }
   }
-
-  return force;
 }
 
-vector<double> boundFace::computeMassFlux(void)
+void boundFace::computeMassFlux(double* flux)
 {
-  vector<double> flux(nFields);
-
   if (bcType == CHAR || bcType == SUP_IN || bcType == SUP_OUT || bcType == SUB_IN || bcType == SUB_OUT) {
     int order;
     if (params->nDims == 2)
@@ -454,6 +528,10 @@ vector<double> boundFace::computeMassFlux(void)
         flux[k] += Fn(fpt,k)*weight;
     }
   }
+}
 
-  return flux;
+void boundFace::addMemUsage(memTally &mem)
+{
+  face::addMemUsage(mem);
+  mem.add("faces", memBytes(deltaU, deltaUdot, deltaUint));
 }
@@ -0,0 +1,633 @@
+/*!
+ * \file deviceBackend.cpp
+ * \brief Class to run the residual evaluation & RK time advancement on a GPU
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifdef _GPU
+
+#include "deviceBackend.hpp"
+
+#include "solver.hpp"
+
+#ifdef _MIXED_PRECISION
+#define MPI_DEV_REAL MPI_FLOAT
+#else
+#define MPI_DEV_REAL MPI_DOUBLE
+#endif
+
+deviceBackend::~deviceBackend()
+{
+#ifndef _NO_MPI
+  int finalized;
+  MPI_Finalized(&finalized);
+
+  for (auto *reqs : {&sendReqs, &recvReqs, &sendReqsGrad, &recvReqsGrad}) {
+    if (!finalized)
+      for (auto &req : *reqs)
+        MPI_Request_free(&req);
+    reqs->clear();
+  }
+#endif
+
+  for (auto ptr : allocations)
+    devFree(ptr);
+
+  if (params != NULL)
+    devFinalize();
+}
+
+template<typename T>
+T* deviceBackend::allocate(size_t n)
+{
+  T* ptr = (T*)devMalloc(n*sizeof(T));
+  allocations.push_back(ptr);
+  return ptr;
+}
+
+template<typename T>
+T* deviceBackend::upload(const vector<T> &data)
+{
+  T* ptr = allocate<T>(data.size());
+  devCopyToDevice(ptr, data.data(), data.size()*sizeof(T));
+  return ptr;
+}
+
+void deviceBackend::download(double *host, const real *dev, size_t n)
+{
+#ifdef _MIXED_PRECISION
+  vector<real> tmp(n);
+  devCopyToHost(tmp.data(), dev, n*sizeof(real));
+  for (size_t i=0; i<n; i++)
+    host[i] = tmp[i];
+#else
+  devCopyToHost(host, dev, n*sizeof(double));
+#endif
+}
+
+void deviceBackend::setup(input *inParams, solver *inSolver)
+{
+  params = inParams;
+  Solver = inSolver;
+
+  if (Solver->eleBlocks.size() != 1 || Solver->eleBlocks.begin()->second.size() != 1)
+    FatalError("The GPU backend requires a single element type & order on each rank.");
+
+  block = &(Solver->eleBlocks.begin()->second.begin()->second);
+
+  nDims = params->nDims;
+  nFields = params->nFields;
+  nEles = block->nEles;
+  nSpts = block->nSpts;
+  nFpts = block->nFpts;
+  nCols = block->nCols;
+  nRKSteps = params->nRKSteps;
+
+  /* --- Select the GPU: one per rank, round-robin over the ranks on each node --- */
+  int nDevices = devGetDeviceCount();
+  if (nDevices < 1)
+    FatalError("gpu: No GPU devices found.");
+
+  int localRank = 0;
+#ifndef _NO_MPI
+  MPI_Comm nodeComm;
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, params->rank, MPI_INFO_NULL, &nodeComm);
+  MPI_Comm_rank(nodeComm, &localRank);
+  MPI_Comm_free(&nodeComm);
+#endif
+
+  devSetDevice(localRank % nDevices);
+
+  /* --- Parameters for the pointwise kernels --- */
+  devParams.nDims = nDims;
+  devParams.nFields = nFields;
+  devParams.gamma = params->gamma;
+  devParams.prandtl = params->prandtl;
+  devParams.mu_inf = params->mu_inf;
+  devParams.rt_inf = params->rt_inf;
+  devParams.c_sth = params->c_sth;
+  devParams.fixVis = params->fixVis;
+  devParams.tau = params->tau;
+  devParams.penFact = params->penFact;
+  devParams.rhoBound = params->rhoBound;
+  devParams.uBound = params->uBound;
+  devParams.vBound = params->vBound;
+  devParams.wBound = params->wBound;
+  devParams.pBound = params->pBound;
+  devParams.TWall = params->TWall;
+  devParams.RGas = params->RGas;
+
+  /* --- Solution arrays --- */
+  size_t sSize = nSpts*nCols;
+  size_t fSize = nFpts*nCols;
+
+  U_spts = allocate<double>(sSize);
+  U0 = (nRKSteps > 1) ? allocate<double>(sSize) : NULL;
+#ifdef _MIXED_PRECISION
+  Ur_spts = allocate<real>(sSize);
+#else
+  Ur_spts = U_spts;
+#endif
+  U_fpts = allocate<real>(fSize);
+  F_spts = allocate<real>(nDims*sSize);
+  F_fpts = allocate<real>(nDims*fSize);
+  Fn_fpts = allocate<real>(fSize);
+  dFn_fpts = allocate<real>(fSize);
+
+  divF_spts.resize(nRKSteps);
+  for (auto &divF : divF_spts)
+    divF = allocate<real>(sSize);
+
+  Uc_fpts = dUc_fpts = dU_spts = dU_fpts = NULL;
+  if (params->viscous) {
+    Uc_fpts = allocate<real>(fSize);
+    dUc_fpts = allocate<real>(fSize);
+    dU_spts = allocate<real>(nDims*sSize);
+    dU_fpts = allocate<real>(nDims*fSize);
+  }
+
+  // U_fpts is extrapolated from U_spts at the start of each residual evaluation
+  devCopyToDevice(U_spts, block->U_spts.getData(), sSize*sizeof(double));
+
+  setupOperators();
+
+  setupGeometry();
+
+  setupFaces();
+
+  setupMpi();
+
+  // The host & device solutions now match
+  syncIter = params->iter;
+}
+
+void deviceBackend::setupOperators(void)
+{
+  auto &opers = Solver->opers[block->eType][block->order];
+
+  auto &spts_fpts = opers.get_oper_spts_fpts();
+  auto &correction = opers.get_oper_correction();
+
+  vector<real> spts2fpts(nFpts*nSpts), corr(nSpts*nFpts);
+  for (int fpt=0; fpt<nFpts; fpt++) {
+    for (int spt=0; spt<nSpts; spt++) {
+      spts2fpts[fpt*nSpts+spt] = spts_fpts(fpt,spt);
+      corr[spt*nFpts+fpt] = correction(spt,fpt);
+    }
+  }
+
+  /* Stack the gradient operators [so that all components come from one
+   * product], and lay the divergence operator alongside itself, so that
+   * divF = [grad_x grad_y grad_z] * [F_x; F_y; F_z] */
+  vector<real> grad(nDims*nSpts*nSpts), div(nSpts*nDims*nSpts);
+  vector<real> correctU(nDims*nSpts*nFpts);
+  for (int dim=0; dim<nDims; dim++) {
+    auto &gradDim = opers.get_oper_grad_spts_dim(dim);
+    for (int i=0; i<nSpts; i++) {
+      for (int j=0; j<nSpts; j++) {
+        grad[(dim*nSpts+i)*nSpts+j] = gradDim(i,j);
+        div[i*nDims*nSpts+dim*nSpts+j] = gradDim(i,j);
+      }
+    }
+
+    if (params->viscous) {
+      auto &corrU = opers.get_oper_correctU(dim);
+      for (int i=0; i<nSpts; i++)
+        for (int j=0; j<nFpts; j++)
+          correctU[(dim*nSpts+i)*nFpts+j] = corrU(i,j);
+    }
+  }
+
+  opSptsFpts = upload(spts2fpts);
+  opCorrection = upload(corr);
+  opGrad = upload(grad);
+  opDiv = upload(div);
+  opCorrectU = (params->viscous) ? upload(correctU) : NULL;
+}
+
+void deviceBackend::setupGeometry(void)
+{
+  vector<double> hJGinv(nSpts*nEles*nDims*nDims), hDetJac(nSpts*nEles);
+  vector<double> hTNorm(nFpts*nEles*nDims), hDA(nFpts*nEles), hWaveSp(nFpts*nEles);
+
+  for (auto &e : Solver->eles) {
+    int ic = e->blockInd;
+    for (int spt=0; spt<nSpts; spt++) {
+      int pt = spt*nEles + ic;
+      hDetJac[pt] = e->detJac_spts[spt];
+      for (int i=0; i<nDims; i++)
+        for (int j=0; j<nDims; j++)
+          hJGinv[(pt*nDims+i)*nDims+j] = e->JGinv_spts[spt](i,j);
+    }
+
+    for (int fpt=0; fpt<nFpts; fpt++) {
+      int pt = fpt*nEles + ic;
+      hDA[pt] = e->dA_fpts[fpt];
+      hWaveSp[pt] = e->waveSp_fpts[fpt];
+      for (int dim=0; dim<nDims; dim++)
+        hTNorm[pt*nDims+dim] = e->tNorm_fpts(fpt,dim);
+    }
+  }
+
+  JGinv = upload(hJGinv);
+  detJac = upload(hDetJac);
+  tNorm = upload(hTNorm);
+  dA = upload(hDA);
+  waveSp = upload(hWaveSp);
+  dtEle = allocate<double>(nEles);
+}
+
+void deviceBackend::setupFaces(void)
+{
+  vector<int> iIdxL, iIdxR, bIdxL, bcType;
+  vector<double> iNorm, iDAL, iDAR, bNorm, bDAL;
+
+  for (auto &f : Solver->faces) {
+    ele *eL = f->getLeftEle();
+    int bcL = f->myInfo.bcType;
+
+    if (f->myInfo.isBnd) {
+      switch (bcL) {
+        case SUB_IN: case SUB_OUT: case SUP_IN: case SUP_OUT: case SLIP_WALL:
+        case SYMMETRY: case ISOTHERMAL_NOSLIP: case ADIABATIC_NOSLIP: case CHAR:
+          break;
+        default:
+          FatalError("Boundary condition not supported by the GPU backend.");
+      }
+
+      for (int fpt=0; fpt<f->nFptsL; fpt++) {
+        int i = f->fptStartL + fpt;
+        bIdxL.push_back(i*nCols + eL->blockInd*nFields);
+        bcType.push_back(bcL);
+        for (int dim=0; dim<nDims; dim++)
+          bNorm.push_back(eL->norm_fpts(i,dim));
+        bDAL.push_back(eL->dA_fpts[i]);
+      }
+    }
+    else {
+      intFace *iface = dynamic_cast<intFace*>(f.get());
+      if (iface == NULL)
+        FatalError("Face type not supported by the GPU backend.");
+
+      ele *eR = iface->getRightEle();
+      for (int fpt=0; fpt<f->nFptsL; fpt++) {
+        int i = f->fptStartL + fpt;
+        int iR = iface->getFptR(fpt);
+        iIdxL.push_back(i*nCols + eL->blockInd*nFields);
+        iIdxR.push_back(iR*nCols + eR->blockInd*nFields);
+        for (int dim=0; dim<nDims; dim++)
+          iNorm.push_back(eL->norm_fpts(i,dim));
+        iDAL.push_back(eL->dA_fpts[i]);
+        iDAR.push_back(eR->dA_fpts[iR]);
+      }
+    }
+  }
+
+  intFaces.nPts = iIdxL.size();
+  intFaces.idxL = upload(iIdxL);
+  intFaces.idxR = upload(iIdxR);
+  intFaces.norm = upload(iNorm);
+  intFaces.dAL = upload(iDAL);
+  intFaces.dAR = upload(iDAR);
+  intFaces.Fn = allocate<real>(intFaces.nPts*nFields);
+
+  bndFaces.nPts = bIdxL.size();
+  bndFaces.idxL = upload(bIdxL);
+  bndFaces.bcType = upload(bcType);
+  bndFaces.norm = upload(bNorm);
+  bndFaces.dAL = upload(bDAL);
+  bndFaces.Fn = allocate<real>(bndFaces.nPts*nFields);
+}
+
+void deviceBackend::setupMpi(void)
+{
+  auto &comm = Solver->mpiFaceComm;
+  nRanks = comm.nRanks;
+  if (nRanks == 0) return;
+
+  /* --- Send side: the left state of each face, in the order of the receiving rank's face IDs --- */
+  vector<int> hSendIdx, sendOffset(nRanks+1,0);
+  for (int r=0; r<nRanks; r++) {
+    for (auto &f : comm.sendFaces[r]) {
+      ele *eL = f->getLeftEle();
+      for (int fpt=0; fpt<f->nFptsL; fpt++)
+        hSendIdx.push_back((f->fptStartL+fpt)*nCols + eL->blockInd*nFields);
+    }
+    sendOffset[r+1] = hSendIdx.size();
+  }
+
+  /* --- Receive side: each face's right state is read from its chunk of the buffer --- */
+  vector<int> idxL, idxR, recvOffset(nRanks+1,0);
+  vector<double> norm, dAL;
+  int offset = 0;
+  for (int r=0; r<nRanks; r++) {
+    for (auto &f : comm.recvFaces[r]) {
+      if (f->nFptsR != f->nFptsL)
+        FatalError("The GPU backend requires matching flux points across MPI faces.");
+
+      ele *eL = f->getLeftEle();
+      for (int fpt=0; fpt<f->nFptsL; fpt++) {
+        int i = f->fptStartL + fpt;
+        idxL.push_back(i*nCols + eL->blockInd*nFields);
+        idxR.push_back((offset + f->fptR[fpt])*nFields);
+        for (int dim=0; dim<nDims; dim++)
+          norm.push_back(eL->norm_fpts(i,dim));
+        dAL.push_back(eL->dA_fpts[i]);
+      }
+      offset += f->nFptsR;
+    }
+    recvOffset[r+1] = offset;
+  }
+
+  nSendPts = hSendIdx.size();
+  nRecvPts = offset;
+
+  sendIdx = upload(hSendIdx);
+
+  mpiFaces.nPts = idxL.size();
+  mpiFaces.idxL = upload(idxL);
+  mpiFaces.idxR = upload(idxR);
+  mpiFaces.norm = upload(norm);
+  mpiFaces.dAL = upload(dAL);
+  mpiFaces.Fn = allocate<real>(mpiFaces.nPts*nFields);
+
+  sendBuf = allocate<real>(nSendPts*nFields);
+  recvBuf = allocate<real>(nRecvPts*nFields);
+  if (params->viscous) {
+    sendBufGrad = allocate<real>(nSendPts*nDims*nFields);
+    recvBufGrad = allocate<real>(nRecvPts*nDims*nFields);
+  }
+
+#ifndef _NO_MPI
+  /* --- Persistent requests on the device buffers [GPU-aware MPI], or on host copies --- */
+  real *sBuf = sendBuf, *rBuf = recvBuf, *sBufGrad = sendBufGrad, *rBufGrad = recvBufGrad;
+  if (!params->gpuAwareMPI) {
+    hSendBuf.resize(nSendPts*nFields);
+    hRecvBuf.resize(nRecvPts*nFields);
+    sBuf = hSendBuf.data();
+    rBuf = hRecvBuf.data();
+    if (params->viscous) {
+      hSendBufGrad.resize(nSendPts*nDims*nFields);
+      hRecvBufGrad.resize(nRecvPts*nDims*nFields);
+      sBufGrad = hSendBufGrad.data();
+      rBufGrad = hRecvBufGrad.data();
+    }
+  }
+
+  MPI_Comm myComm = comm.sendFaces[0][0]->myInfo.gridComm;
+
+  // Tags distinguish the solution [0] from the gradient [1] messages
+  sendReqs.resize(nRanks);
+  recvReqs.resize(nRanks);
+  for (int r=0; r<nRanks; r++) {
+    int nSend = (sendOffset[r+1]-sendOffset[r])*nFields;
+    int nRecv = (recvOffset[r+1]-recvOffset[r])*nFields;
+    MPI_Send_init(sBuf+sendOffset[r]*nFields,nSend,MPI_DEV_REAL,comm.ranks[r],0,myComm,&sendReqs[r]);
+    MPI_Recv_init(rBuf+recvOffset[r]*nFields,nRecv,MPI_DEV_REAL,comm.ranks[r],0,myComm,&recvReqs[r]);
+  }
+
+  if (params->viscous) {
+    int nGrad = nDims*nFields;
+    sendReqsGrad.resize(nRanks);
+    recvReqsGrad.resize(nRanks);
+    for (int r=0; r<nRanks; r++) {
+      int nSend = (sendOffset[r+1]-sendOffset[r])*nGrad;
+      int nRecv = (recvOffset[r+1]-recvOffset[r])*nGrad;
+      MPI_Send_init(sBufGrad+sendOffset[r]*nGrad,nSend,MPI_DEV_REAL,comm.ranks[r],1,myComm,&sendReqsGrad[r]);
+      MPI_Recv_init(rBufGrad+recvOffset[r]*nGrad,nRecv,MPI_DEV_REAL,comm.ranks[r],1,myComm,&recvReqsGrad[r]);
+    }
+  }
+#endif
+}
+
+void deviceBackend::startExchange(bool grad)
+{
+#ifndef _NO_MPI
+  if (nRanks == 0) return;
+
+  auto &sReqs = (grad) ? sendReqsGrad : sendReqs;
+  auto &rReqs = (grad) ? recvReqsGrad : recvReqs;
+
+  MPI_Startall(nRanks,rReqs.data());
+
+  if (grad) {
+    devPack(nSendPts,sendIdx,dU_fpts,nFpts*nCols,nDims,nFields,sendBufGrad);
+    if (!params->gpuAwareMPI)
+      devCopyToHost(hSendBufGrad.data(),sendBufGrad,hSendBufGrad.size()*sizeof(real));
+  }
+  else {
+    devPack(nSendPts,sendIdx,U_fpts,0,1,nFields,sendBuf);
+    if (!params->gpuAwareMPI)
+      devCopyToHost(hSendBuf.data(),sendBuf,hSendBuf.size()*sizeof(real));
+  }
+
+  // MPI may read the device buffer as soon as the send is started
+  if (params->gpuAwareMPI)
+    devSynchronize();
+
+  MPI_Startall(nRanks,sReqs.data());
+#endif
+}
+
+void deviceBackend::finishExchange(bool grad)
+{
+  PROFILE("mpiWait");
+
+#ifndef _NO_MPI
+  if (nRanks == 0) return;
+
+  auto &sReqs = (grad) ? sendReqsGrad : sendReqs;
+  auto &rReqs = (grad) ? recvReqsGrad : recvReqs;
+
+  MPI_Waitall(nRanks,rReqs.data(),MPI_STATUSES_IGNORE);
+  MPI_Waitall(nRanks,sReqs.data(),MPI_STATUSES_IGNORE);
+
+  if (!params->gpuAwareMPI) {
+    if (grad)
+      devCopyToDevice(recvBufGrad,hRecvBufGrad.data(),hRecvBufGrad.size()*sizeof(real));
+    else
+      devCopyToDevice(recvBuf,hRecvBuf.data(),hRecvBuf.size()*sizeof(real));
+  }
+#endif
+}
+
+void deviceBackend::calcResidual(int step)
+{
+  PROFILE("calcResidual");
+
+  int nSptsTot = nSpts*nEles;
+  int nFptsTot = nFpts*nEles;
+  int gStride = nFpts*nCols;
+  real *divF = divF_spts[step];
+  real *Uc = (params->viscous) ? Uc_fpts : NULL;
+
+#ifdef _MIXED_PRECISION
+  devConvert(nSptsTot*nFields,U_spts,Ur_spts);
+#endif
+
+  /* --- Extrapolate the solution & post the MPI exchange --- */
+  devGemm(nFpts,nCols,nSpts,opSptsFpts,Ur_spts,U_fpts);
+
+  startExchange(false);
+
+  if (params->viscous)
+    devGemm(nDims*nSpts,nCols,nSpts,opGrad,Ur_spts,dU_spts);
+
+  /* --- Inviscid flux --- */
+  devInviscidFluxSpts(nSptsTot,U_spts,F_spts,JGinv,devParams);
+
+  devInteriorFlux(intFaces.nPts,intFaces.idxL,intFaces.idxR,intFaces.norm,intFaces.dAL,intFaces.dAR,
+                  U_fpts,U_fpts,Fn_fpts,intFaces.Fn,waveSp,Uc,devParams);
+
+  devBoundaryFlux(bndFaces.nPts,bndFaces.idxL,bndFaces.bcType,bndFaces.norm,bndFaces.dAL,
+                  U_fpts,Fn_fpts,bndFaces.Fn,waveSp,Uc,devParams);
+
+  finishExchange(false);
+
+  devInteriorFlux(mpiFaces.nPts,mpiFaces.idxL,mpiFaces.idxR,mpiFaces.norm,mpiFaces.dAL,NULL,
+                  U_fpts,recvBuf,Fn_fpts,mpiFaces.Fn,waveSp,Uc,devParams);
+
+  /* --- Viscous flux --- */
+  if (params->viscous) {
+    // Correct the gradient with the common solution & transform to physical space
+    devDifference(nFptsTot*nFields,Uc_fpts,U_fpts,dUc_fpts);
+    devGemm(nDims*nSpts,nCols,nFpts,opCorrectU,dUc_fpts,dU_spts,true);
+    devTransformGradU(nSptsTot,dU_spts,JGinv,detJac,nDims,nFields);
+
+    for (int dim=0; dim<nDims; dim++)
+      devGemm(nFpts,nCols,nSpts,opSptsFpts,dU_spts+dim*nSpts*nCols,dU_fpts+dim*gStride);
+
+    startExchange(true);
+
+    devViscousFluxSpts(nSptsTot,U_spts,dU_spts,F_spts,JGinv,devParams);
+
+    devInteriorViscousFlux(intFaces.nPts,intFaces.idxL,intFaces.idxR,intFaces.norm,intFaces.dAL,intFaces.dAR,
+                           U_fpts,U_fpts,dU_fpts,gStride,dU_fpts,1,gStride,Fn_fpts,intFaces.Fn,devParams);
+
+    devBoundaryViscousFlux(bndFaces.nPts,bndFaces.idxL,bndFaces.bcType,bndFaces.norm,bndFaces.dAL,
+                           U_fpts,dU_fpts,gStride,Fn_fpts,bndFaces.Fn,devParams);
+
+    finishExchange(true);
+
+    devInteriorViscousFlux(mpiFaces.nPts,mpiFaces.idxL,mpiFaces.idxR,mpiFaces.norm,mpiFaces.dAL,NULL,
+                           U_fpts,recvBuf,dU_fpts,gStride,recvBufGrad,nDims,nFields,Fn_fpts,mpiFaces.Fn,devParams);
+  }
+
+  /* --- Flux divergence & correction --- */
+  for (int dim=0; dim<nDims; dim++)
+    devGemm(nFpts,nCols,nSpts,opSptsFpts,F_spts+dim*nSpts*nCols,F_fpts+dim*gStride);
+
+  devGemm(nSpts,nCols,nDims*nSpts,opDiv,F_spts,divF);
+
+  devDeltaFn(nFptsTot,Fn_fpts,F_fpts,tNorm,dFn_fpts,nDims,nFields);
+
+  devGemm(nSpts,nCols,nFpts,opCorrection,dFn_fpts,divF,true);
+}
+
+void deviceBackend::calcDt(void)
+{
+  PROFILE("calcDt");
+
+  double fac = params->CFL * getCFLLimit(block->order);
+  devCalcDt(nEles,nFpts,waveSp,dA,fac,dtEle);
+
+  double dt = devMin(nEles,dtEle);
+
+#ifndef _NO_MPI
+  double dtTmp = dt;
+  MPI_Allreduce(&dtTmp, &dt, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+#endif
+
+  params->dt = dt;
+}
+
+void deviceBackend::update(void)
+{
+  if (params->dtType != 0) calcDt();
+
+  int nPts = nSpts*nEles;
+  double *dtE = (params->dtType == 2) ? dtEle : NULL;
+
+  for (int step=0; step<nRKSteps-1; step++) {
+    params->rkTime = params->time + params->RKc[step]*params->dt;
+
+    if (step == 0) devCopy(U0,U_spts,nSpts*nCols*sizeof(double));
+
+    calcResidual(step);
+
+    devTimeStepA(nPts,nEles,nFields,U_spts,U0,divF_spts[step],detJac,dtE,params->dt,params->RKa[step+1]);
+  }
+
+  /* Final Runge-Kutta time advancement step */
+
+  params->rkTime = params->time + params->RKc[nRKSteps-1]*params->dt;
+
+  calcResidual(nRKSteps-1);
+
+  // Reset solution to initial-stage values
+  if (nRKSteps>1)
+    devCopy(U_spts,U0,nSpts*nCols*sizeof(double));
+
+  for (int step=0; step<nRKSteps; step++)
+    devTimeStepB(nPts,nEles,nFields,U_spts,divF_spts[step],detJac,dtE,params->dt,params->RKb[step]);
+
+  params->time += params->dt;
+}
+
+void deviceBackend::syncHost(void)
+{
+  if (syncIter == params->iter) return;
+
+  PROFILE("syncHost");
+
+  size_t sSize = nSpts*nCols;
+  size_t fSize = nFpts*nCols;
+
+  devCopyToHost(block->U_spts.getData(), U_spts, sSize*sizeof(double));
+  download(block->U_fpts.getData(), U_fpts, fSize);
+
+  for (int step=0; step<nRKSteps; step++)
+    download(block->divF_spts[step].getData(), divF_spts[step], sSize);
+
+  if (params->viscous) {
+    for (int dim=0; dim<nDims; dim++) {
+      download(block->dU_spts[dim].getData(), dU_spts+dim*sSize, sSize);
+      download(block->dU_fpts[dim].getData(), dU_fpts+dim*fSize, fSize);
+    }
+  }
+
+  // Wall forces & mass fluxes are computed from the boundary faces' own copies
+  for (auto &f : Solver->faces) {
+    if (f->myInfo.isBnd) {
+      f->getLeftState();
+      if (params->viscous)
+        f->getLeftGradient();
+    }
+  }
+
+  syncIter = params->iter;
+}
+
+#endif // _GPU
@@ -0,0 +1,1084 @@
+/*!
+ * \file deviceKernels.cu
+ * \brief GPU kernels for the residual evaluation & RK time advancement
+ *
+ * Written in CUDA; compiled with hipcc [-D_HIP] for AMD GPUs, with the CUDA
+ * runtime & cuBLAS calls mapped to their HIP equivalents.  The pointwise
+ * physics mirrors the host routines in flux.cpp, face.cpp & boundFace.cpp.
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA..
+ *
+ */
+
+#include "deviceKernels.hpp"
+
+#ifdef _HIP
+#include <hip/hip_runtime.h>
+#include <hipblas.h>
+#define cudaError_t               hipError_t
+#define cudaSuccess               hipSuccess
+#define cudaGetErrorString        hipGetErrorString
+#define cudaGetLastError          hipGetLastError
+#define cudaGetDeviceCount        hipGetDeviceCount
+#define cudaSetDevice             hipSetDevice
+#define cudaMalloc                hipMalloc
+#define cudaFree                  hipFree
+#define cudaMemcpy                hipMemcpy
+#define cudaMemcpyHostToDevice    hipMemcpyHostToDevice
+#define cudaMemcpyDeviceToHost    hipMemcpyDeviceToHost
+#define cudaMemcpyDeviceToDevice  hipMemcpyDeviceToDevice
+#define cudaDeviceSynchronize     hipDeviceSynchronize
+#define cublasHandle_t            hipblasHandle_t
+#define cublasStatus_t            hipblasStatus_t
+#define CUBLAS_STATUS_SUCCESS     HIPBLAS_STATUS_SUCCESS
+#define CUBLAS_OP_N               HIPBLAS_OP_N
+#define cublasCreate              hipblasCreate
+#define cublasDestroy             hipblasDestroy
+#define cublasDgemm               hipblasDgemm
+#define cublasSgemm               hipblasSgemm
+#define cublasIdamin              hipblasIdamin
+#else
+#include <cuda_runtime.h>
+#include <cublas_v2.h>
+#endif
+
+#include <algorithm>
+
+#include "global.hpp"
+
+#define DEV_CHECK(call) {                                        \
+  cudaError_t err = (call);                                      \
+  if (err != cudaSuccess) FatalError(cudaGetErrorString(err)); }
+
+#define BLAS_CHECK(call) {                                       \
+  if ((call) != CUBLAS_STATUS_SUCCESS) FatalError("GPU BLAS call failed."); }
+
+//! Grid-stride loop over n points [so that any launch configuration covers all points]
+#define FOR_EACH_PT(i,n) for (int i = blockIdx.x*blockDim.x + threadIdx.x; i < (n); i += blockDim.x*gridDim.x)
+
+static const int nThreads = 256;
+
+static int nBlocks(int n)
+{
+  return std::min((n + nThreads - 1) / nThreads, 65535);
+}
+
+static void checkLaunch(void)
+{
+  DEV_CHECK(cudaGetLastError());
+}
+
+static cublasHandle_t blasHandle;
+
+/* ---------------- Device management & memory ---------------- */
+
+int devGetDeviceCount(void)
+{
+  int nDevices = 0;
+  DEV_CHECK(cudaGetDeviceCount(&nDevices));
+  return nDevices;
+}
+
+void devSetDevice(int dev)
+{
+  DEV_CHECK(cudaSetDevice(dev));
+  BLAS_CHECK(cublasCreate(&blasHandle));
+}
+
+void devFinalize(void)
+{
+  cublasDestroy(blasHandle);
+}
+
+void* devMalloc(size_t bytes)
+{
+  void* ptr = NULL;
+  if (bytes > 0)
+    DEV_CHECK(cudaMalloc(&ptr, bytes));
+  return ptr;
+}
+
+void devFree(void* ptr)
+{
+  if (ptr != NULL)
+    DEV_CHECK(cudaFree(ptr));
+}
+
+void devCopyToDevice(void* dst, const void* src, size_t bytes)
+{
+  if (bytes > 0)
+    DEV_CHECK(cudaMemcpy(dst, src, bytes, cudaMemcpyHostToDevice));
+}
+
+void devCopyToHost(void* dst, const void* src, size_t bytes)
+{
+  if (bytes > 0)
+    DEV_CHECK(cudaMemcpy(dst, src, bytes, cudaMemcpyDeviceToHost));
+}
+
+void devCopy(void* dst, const void* src, size_t bytes)
+{
+  if (bytes > 0)
+    DEV_CHECK(cudaMemcpy(dst, src, bytes, cudaMemcpyDeviceToDevice));
+}
+
+void devSynchronize(void)
+{
+  DEV_CHECK(cudaDeviceSynchronize());
+}
+
+/* ---------------- Dense linear algebra ---------------- */
+
+void devGemm(int m, int n, int k, const double* A, const double* B, double* C, bool add)
+{
+  /* cuBLAS is column-major: compute C^T = B^T * A^T, which in row-major
+   * storage is exactly C = A*B */
+  double alpha = 1.;
+  double beta = (add) ? 1. : 0.;
+  BLAS_CHECK(cublasDgemm(blasHandle, CUBLAS_OP_N, CUBLAS_OP_N, n, m, k, &alpha, B, n, A, k, &beta, C, n));
+}
+
+void devGemm(int m, int n, int k, const float* A, const float* B, float* C, bool add)
+{
+  float alpha = 1.f;
+  float beta = (add) ? 1.f : 0.f;
+  BLAS_CHECK(cublasSgemm(blasHandle, CUBLAS_OP_N, CUBLAS_OP_N, n, m, k, &alpha, B, n, A, k, &beta, C, n));
+}
+
+double devMin(int n, const double* x)
+{
+  // For x >= 0, the min. magnitude is the min. value [1-based index]
+  int ind;
+  BLAS_CHECK(cublasIdamin(blasHandle, n, x, 1, &ind));
+
+  double val;
+  devCopyToHost(&val, x+ind-1, sizeof(double));
+  return val;
+}
+
+/* ---------------- Pointwise physics [see flux.cpp] ---------------- */
+
+//! Inviscid Euler flux at a point; F: [nDims, nFields]
+template<int nDims>
+__device__ inline void eulerFlux(const double* U, double gamma, double* F)
+{
+  const int nFields = nDims+2;
+
+  double rho = U[0];
+  double vel[nDims];
+  double vSq = 0.;
+  for (int dim=0; dim<nDims; dim++) {
+    vel[dim] = U[dim+1]/rho;
+    vSq += vel[dim]*vel[dim];
+  }
+
+  double p = (gamma-1.0)*(U[nDims+1]-(0.5*rho*vSq));
+
+  for (int dim=0; dim<nDims; dim++) {
+    double* Fd = F + dim*nFields;
+    Fd[0] = U[dim+1];
+    for (int k=1; k<nDims+1; k++)
+      Fd[k] = U[k]*vel[dim];
+    Fd[dim+1] += p;
+    Fd[nDims+1] = (U[nDims+1]+p)*vel[dim];
+  }
+}
+
+//! Navier-Stokes viscous flux at a point; dU, Fv: [nDims, nFields]
+template<int nDims>
+__device__ inline void viscousFlux(const double* U, const double* dU, const deviceParams &p, double* Fv)
+{
+  const int nFields = nDims+2;
+
+  /* --- Calculate Primitives --- */
+  double rho = U[0];
+  double u   = U[1]/rho;
+  double v   = U[2]/rho;
+  double e   = U[nDims+1]/rho - 0.5*(u*u+v*v);
+
+  double w = 0.;
+  if (nDims == 3) {
+    w = U[3]/rho;
+    e -= 0.5*(w*w);
+  }
+
+  /* --- Get Gradients --- */
+  double dRho_dx  = dU[0];
+  double dRhoU_dx = dU[1];
+  double dRhoV_dx = dU[2];
+  double dE_dx    = dU[nDims+1];
+
+  double dRho_dy  = dU[nFields+0];
+  double dRhoU_dy = dU[nFields+1];
+  double dRhoV_dy = dU[nFields+2];
+  double dE_dy    = dU[nFields+nDims+1];
+
+  double dRho_dz = 0, dRhoU_dz = 0, dRhoV_dz = 0;
+  double dRhoW_dx = 0, dRhoW_dy = 0, dRhoW_dz = 0;
+  double dE_dz = 0;
+  if (nDims == 3) {
+    dRho_dz  = dU[2*nFields+0];
+    dRhoU_dz = dU[2*nFields+1];
+    dRhoV_dz = dU[2*nFields+2];
+    dRhoW_dx = dU[3];
+    dRhoW_dy = dU[nFields+3];
+    dRhoW_dz = dU[2*nFields+3];
+    dE_dz    = dU[2*nFields+4];
+  }
+
+  /* --- Calculate Viscosity --- */
+  double mu = p.mu_inf;
+  if (!p.fixVis) {
+    // Use Sutherland's Law
+    double rt_ratio = (p.gamma-1.0)*e/(p.rt_inf);
+    mu *= pow(rt_ratio,1.5)*(1.+(p.c_sth))/(rt_ratio+(p.c_sth));
+  }
+
+  /* --- Calculate Gradients --- */
+  double du_dx = (dRhoU_dx-dRho_dx*u)/rho;
+  double du_dy = (dRhoU_dy-dRho_dy*u)/rho;
+
+  double dv_dx = (dRhoV_dx-dRho_dx*v)/rho;
+  double dv_dy = (dRhoV_dy-dRho_dy*v)/rho;
+
+  double du_dz = 0, dv_dz = 0;
+  double dw_dx = 0, dw_dy = 0, dw_dz = 0;
+  if (nDims == 3) {
+    du_dz = (dRhoU_dz-dRho_dz*u)/rho;
+    dv_dz = (dRhoV_dz-dRho_dz*v)/rho;
+
+    dw_dx = (dRhoW_dx-dRho_dx*w)/rho;
+    dw_dy = (dRhoW_dy-dRho_dy*w)/rho;
+    dw_dz = (dRhoW_dz-dRho_dz*w)/rho;
+  }
+
+  double dK_dx, dK_dy, dK_dz;
+  if (nDims == 2) {
+    dK_dx = 0.5*(u*u+v*v)*dRho_dx+rho*(u*du_dx+v*dv_dx);
+    dK_dy = 0.5*(u*u+v*v)*dRho_dy+rho*(u*du_dy+v*dv_dy);
+    dK_dz = 0;
+  }
+  else {
+    dK_dx = 0.5*(u*u+v*v+w*w)*dRho_dx+rho*(u*du_dx+v*dv_dx+w*dw_dx);
+    dK_dy = 0.5*(u*u+v*v+w*w)*dRho_dy+rho*(u*du_dy+v*dv_dy+w*dw_dy);
+    dK_dz = 0.5*(u*u+v*v+w*w)*dRho_dz+rho*(u*du_dz+v*dv_dz+w*dw_dz);
+  }
+
+  double de_dx = (dE_dx-dK_dx-dRho_dx*e)/rho;
+  double de_dy = (dE_dy-dK_dy-dRho_dy*e)/rho;
+  double de_dz = 0;
+  if (nDims == 3)
+    de_dz = (dE_dz-dK_dz-dRho_dz*e)/rho;
+
+  double diag = (du_dx + dv_dy + dw_dz)/3.0;
+
+  double tauxx = 2.0*mu*(du_dx-diag);
+  double tauyy = 2.0*mu*(dv_dy-diag);
+
+  double tauxy = mu*(du_dy + dv_dx);
+
+  double tauxz = 0, tauyz = 0, tauzz = 0;
+  if (nDims == 3) {
+    tauxz = mu*(du_dz + dv_dx);
+    tauyz = mu*(du_dz + dv_dy);
+    tauzz = 2.0*mu*(dw_dz-diag);
+  }
+
+  /* --- Calculate Viscous Flux --- */
+  Fv[0] =  0.0;
+  Fv[1] = -tauxx;
+  Fv[2] = -tauxy;
+  Fv[nDims+1] = -(u*tauxx+v*tauxy+w*tauxz+(mu/p.prandtl)*(p.gamma)*de_dx);
+
+  Fv[nFields+0] =  0.0;
+  Fv[nFields+1] = -tauxy;
+  Fv[nFields+2] = -tauyy;
+  Fv[nFields+nDims+1] = -(u*tauxy+v*tauyy+w*tauyz+(mu/p.prandtl)*(p.gamma)*de_dy);
+
+  if (nDims == 3) {
+    Fv[3] = -tauzz;
+    Fv[nFields+3] = -tauyz;
+
+    Fv[2*nFields+0] =  0.0;
+    Fv[2*nFields+1] = -tauxz;
+    Fv[2*nFields+2] = -tauyz;
+    Fv[2*nFields+3] = -tauzz;
+    Fv[2*nFields+4] = -(u*tauxz+v*tauyz+w*tauzz+(mu/p.prandtl)*(p.gamma)*de_dz);
+  }
+}
+
+//! Inviscid Euler normal flux (F dot n) at a point; returns the pressure
+template<int nDims>
+__device__ inline double eulerNormalFlux(const double* U, const double* norm, double gamma, double* Fn)
+{
+  const int nFields = nDims+2;
+
+  double rho = U[0];
+  double vel[nDims];
+  for (int dim=0; dim<nDims; dim++)
+    vel[dim] = U[dim+1]/rho;
+
+  double vSq = vel[0]*vel[0];
+  for (int dim=1; dim<nDims; dim++)
+    vSq += vel[dim]*vel[dim];
+
+  double p = (gamma-1.0)*(U[nDims+1]-(0.5*rho*vSq));
+
+  for (int k=0; k<nFields; k++)
+    Fn[k] = 0;
+
+  for (int dim=0; dim<nDims; dim++) {
+    Fn[0] += norm[dim]*U[dim+1];
+    for (int k=1; k<nDims+1; k++) {
+      double F = U[k]*vel[dim];
+      if (k == dim+1) F += p;
+      Fn[k] += norm[dim]*F;
+    }
+    Fn[nDims+1] += norm[dim]*((U[nDims+1]+p)*vel[dim]);
+  }
+
+  return p;
+}
+
+//! Rusanov [or central, for boundaries] common flux at a point; returns the max. wave speed
+template<int nDims, bool central>
+__device__ inline double commonFlux(const double* uL, const double* uR, const double* n, double gamma, double* fn)
+{
+  const int nFields = nDims+2;
+
+  double FnL[nFields], FnR[nFields];
+  double pL = eulerNormalFlux<nDims>(uL,n,gamma,FnL);
+  double pR = eulerNormalFlux<nDims>(uR,n,gamma,FnR);
+
+  double rhoL = uL[0];
+  double rhoR = uR[0];
+
+  if (central) {
+    double vSqL = 0., vSqR = 0.;
+    for (int dim=0; dim<nDims; dim++) {
+      vSqL += (uL[dim+1]/rhoL)*(uL[dim+1]/rhoL);
+      vSqR += (uR[dim+1]/rhoR)*(uR[dim+1]/rhoR);
+    }
+    pL = (gamma-1.0)*(uL[nDims+1]-rhoL*vSqL);
+    pR = (gamma-1.0)*(uR[nDims+1]-rhoR*vSqR);
+  }
+
+  double vnL = 0., vnR = 0.;
+  for (int dim=0; dim<nDims; dim++) {
+    vnL += n[dim]*uL[dim+1]/rhoL;
+    vnR += n[dim]*uR[dim+1]/rhoR;
+  }
+
+  double csqL = fmax(gamma*pL/rhoL,0.0);
+  double csqR = fmax(gamma*pR/rhoR,0.0);
+  double eigL = fabs(vnL) + sqrt(csqL);
+  double eigR = fabs(vnR) + sqrt(csqR);
+  double eig  = fmax(eigL,eigR);
+
+  if (central) {
+    for (int k=0; k<nFields; k++)
+      fn[k] = 0.5*(FnL[k]+FnR[k]);
+  }
+  else {
+    for (int k=0; k<nFields; k++)
+      fn[k] = 0.5*(FnL[k]+FnR[k] - eig*(uR[k]-uL[k]));
+  }
+
+  return eig;
+}
+
+//! LDG penalty factor, with its sign set by a fixed switch direction [see face::ldgPenalty]
+template<int nDims>
+__device__ inline double ldgPenalty(const double* n, double penFact)
+{
+  if (nDims == 2) {
+    if (n[0]+n[1] < 0)
+      return -penFact;
+  }
+  else {
+    if (n[0]+n[1]+sqrt(2.)*n[2] < 0)
+      return -penFact;
+  }
+
+  return penFact;
+}
+
+//! Right [ghost] state of a boundary flux point [see boundFace::applyBCs]
+template<int nDims>
+__device__ inline void boundaryState(int bcType, const double* uL, const double* n, const deviceParams &p, double* uR)
+{
+  double gamma = p.gamma;
+  double vBound[3] = {p.uBound, p.vBound, p.wBound};
+
+  double rhoL = uL[0];
+  double eL = uL[nDims+1];
+  double vL[3] = {0,0,0};
+  double vR[3] = {0,0,0};
+  for (int i=0; i<nDims; i++)
+    vL[i] = uL[i+1]/uL[0];
+
+  double vSq = 0;
+  for (int i=0; i<nDims; i++)
+    vSq += (vL[i]*vL[i]);
+
+  double pL = (gamma-1.0)*(eL - 0.5*rhoL*vSq);
+
+  double rhoR = rhoL, pR = pL, ER = eL;
+
+  switch (bcType) {
+    case SUB_IN:
+      rhoR = p.rhoBound;
+      for (int i=0; i<nDims; i++)
+        vR[i] = vBound[i];
+      pR = pL;
+      vSq = 0;
+      for (int i=0; i<nDims; i++)
+        vSq += (vR[i]*vR[i]);
+      ER = (pR/(gamma-1.0)) + 0.5*rhoR*vSq;
+      break;
+
+    case SUB_OUT:
+      rhoR = rhoL;
+      for (int i=0; i<nDims; i++)
+        vR[i] = vL[i];
+      pR = p.pBound;
+      vSq = 0.;
+      for (int i=0; i<nDims; i++)
+        vSq += (vR[i]*vR[i]);
+      ER = (pR/(gamma-1.0)) + 0.5*rhoR*vSq;
+      break;
+
+    case SUP_IN:
+      rhoR = p.rhoBound;
+      for (int i=0; i<3; i++)
+        vR[i] = vBound[i];
+      pR = p.pBound;
+      vSq = 0.;
+      for (int i=0; i<nDims; i++)
+        vSq += (vR[i]*vR[i]);
+      ER = (pR/(gamma-1.0)) + 0.5*rhoR*vSq;
+      break;
+
+    case SUP_OUT:
+      rhoR = rhoL;
+      for (int i=0; i<nDims; i++)
+        vR[i] = vL[i];
+      ER = eL;
+      break;
+
+    case SLIP_WALL:
+    case SYMMETRY: {
+      rhoR = rhoL;
+      double vnL = 0.;
+      for (int i=0; i<nDims; i++)
+        vnL += vL[i]*n[i];
+      for (int i=0; i<nDims; i++)
+        vR[i] = vL[i] - (2.0)*vnL*n[i];
+      ER = eL;
+      break;
+    }
+
+    case ISOTHERMAL_NOSLIP:
+      pR = pL;
+      rhoR = pR/(p.RGas*p.TWall);
+      vSq = 0.;
+      ER = (pR/(gamma-1.0)) + 0.5*rhoR*vSq;
+      break;
+
+    case ADIABATIC_NOSLIP:
+      rhoR = rhoL;
+      pR = pL;
+      vSq = 0.;
+      ER = (pR/(gamma-1.0)) + 0.5*rhoR*vSq;
+      break;
+
+    case CHAR: {
+      double vnL = 0.;
+      for (int i=0; i<nDims; i++)
+        vnL += vL[i]*n[i];
+
+      double vnBound = 0;
+      for (int i=0; i<nDims; i++)
+        vnBound += vBound[i]*n[i];
+
+      double r_plus  = vnL + 2./(gamma-1.)*sqrt(gamma*pL/rhoL);
+      double r_minus = vnBound - 2./(gamma-1.)*sqrt(gamma*p.pBound/p.rhoBound);
+
+      double cStar = 0.25*(gamma-1.)*(r_plus-r_minus);
+      double vn_star = 0.5*(r_plus+r_minus);
+
+      if (vnL<0) {
+        // Inflow
+        double one_over_s = pow(p.rhoBound,gamma)/p.pBound;
+
+        vSq = 0.;
+        for (int i=0; i<nDims; i++)
+          vSq += vBound[i]*vBound[i];
+        double h_free_stream = gamma/(gamma-1.)*p.pBound/p.rhoBound + 0.5*vSq;
+
+        rhoR = pow(1./gamma*(one_over_s*cStar*cStar),1./(gamma-1.));
+
+        for (int i=0; i<nDims; i++)
+          vR[i] = vn_star*n[i] + (vBound[i] - vnBound*n[i]);
+
+        pR = rhoR/gamma*cStar*cStar;
+        ER = rhoR*h_free_stream - pR;
+      }
+      else {
+        // Outflow
+        double one_over_s = pow(rhoL,gamma)/pL;
+
+        rhoR = pow(1./gamma*(one_over_s*cStar*cStar), 1./(gamma-1.));
+
+        for (int i=0; i<nDims; i++)
+          vR[i] = vn_star*n[i] + (vL[i] - vnL*n[i]);
+
+        pR = rhoR/gamma*cStar*cStar;
+        vSq = 0.;
+        for (int i=0; i<nDims; i++)
+          vSq += (vR[i]*vR[i]);
+        ER = (pR/(gamma-1.0)) + 0.5*rhoR*vSq;
+      }
+      break;
+    }
+  }
+
+  uR[0] = rhoR;
+  for (int i=0; i<nDims; i++)
+    uR[i+1] = rhoR*vR[i];
+  uR[nDims+1] = ER;
+}
+
+//! Adiabatic-wall gradient BC [see boundFace::applyViscousBCs]; dU: [nDims, nFields]
+template<int nDims>
+__device__ inline void adiabaticGradient(const double* uL, const double* uR, const deviceParams &p, double* dU)
+{
+  const int nFields = nDims+2;
+
+  double rhovSq = 0.;
+  for (int dim=0; dim<nDims; dim++)
+    rhovSq += uL[dim+1]*uL[dim+1];
+  double pL = (p.gamma-1.)*(uL[nDims+1] - 0.5*rhovSq/uL[0]);
+
+  double pR = pL;
+  double e = pR/((p.gamma-1.)*uR[0]);
+
+  double gradVel[nDims][nDims];
+  for (int dim1=0; dim1<nDims; dim1++)
+    for (int dim2=0; dim2<nDims; dim2++)
+      gradVel[dim1][dim2] = (dU[dim1*nFields+dim2+1] - dU[dim1*nFields]*uR[dim2+1]/uR[0])/uR[0];
+
+  double vSq = 0.;
+  for (int dim=0; dim<nDims; dim++)
+    vSq += uR[dim+1]*uR[dim+1]/(uR[0]*uR[0]);
+
+  for (int dim1=0; dim1<nDims; dim1++) {
+    dU[dim1*nFields+nDims+1] = (e+0.5*vSq)*dU[dim1*nFields];
+    for (int dim2=0; dim2<nDims; dim2++)
+      dU[dim1*nFields+nDims+1] += uR[dim2+1]*gradVel[dim2][dim1];
+  }
+}
+
+/* ---------------- Solution-point kernels ---------------- */
+
+//! Write [or add] the flux at one point, transformed to the reference domain
+template<int nDims, bool add>
+__device__ inline void storeSptFlux(const double* Fp, const double* J, real* F, int dimStride)
+{
+  const int nFields = nDims+2;
+
+  for (int i=0; i<nDims; i++) {
+    real* Fi = F + i*dimStride;
+    const double* Ji = J + i*nDims;
+    for (int k=0; k<nFields; k++) {
+      double Ft = Ji[0]*Fp[k];
+      for (int j=1; j<nDims; j++)
+        Ft += Ji[j]*Fp[j*nFields+k];
+      Fi[k] = (add) ? Fi[k] + Ft : Ft;
+    }
+  }
+}
+
+template<int nDims>
+__global__ void inviscidFluxSpts_kernel(int nPts, const double* U, real* F, const double* JGinv, deviceParams p)
+{
+  const int nFields = nDims+2;
+
+  FOR_EACH_PT(pt,nPts) {
+    double Fp[nDims*nFields];
+    eulerFlux<nDims>(U+pt*nFields, p.gamma, Fp);
+    storeSptFlux<nDims,false>(Fp, JGinv+pt*nDims*nDims, F+pt*nFields, nPts*nFields);
+  }
+}
+
+template<int nDims>
+__global__ void viscousFluxSpts_kernel(int nPts, const double* U, const real* dU, real* F, const double* JGinv, deviceParams p)
+{
+  const int nFields = nDims+2;
+
+  FOR_EACH_PT(pt,nPts) {
+    double dUp[nDims*nFields], Fp[nDims*nFields];
+    for (int dim=0; dim<nDims; dim++)
+      for (int k=0; k<nFields; k++)
+        dUp[dim*nFields+k] = dU[dim*nPts*nFields + pt*nFields + k];
+
+    viscousFlux<nDims>(U+pt*nFields, dUp, p, Fp);
+    storeSptFlux<nDims,true>(Fp, JGinv+pt*nDims*nDims, F+pt*nFields, nPts*nFields);
+  }
+}
+
+template<int nDims>
+__global__ void transformGradU_kernel(int nPts, int nFields, real* dU, const double* JGinv, const double* detJac)
+{
+  int stride = nPts*nFields;
+
+  FOR_EACH_PT(pt,nPts) {
+    double invDet = 1./detJac[pt];
+    double J[nDims*nDims];
+    for (int i=0; i<nDims*nDims; i++)
+      J[i] = JGinv[pt*nDims*nDims+i]*invDet;
+
+    for (int k=0; k<nFields; k++) {
+      double dUr[nDims];
+      for (int dim=0; dim<nDims; dim++)
+        dUr[dim] = dU[dim*stride + pt*nFields + k];
+
+      for (int dim=0; dim<nDims; dim++) {
+        double val = dUr[0]*J[dim];
+        for (int j=1; j<nDims; j++)
+          val += dUr[j]*J[j*nDims+dim];
+        dU[dim*stride + pt*nFields + k] = val;
+      }
+    }
+  }
+}
+
+void devInviscidFluxSpts(int nPts, const double* U, real* F, const double* JGinv, deviceParams p)
+{
+  if (nPts <= 0) return;
+
+  if (p.nDims == 2)
+    inviscidFluxSpts_kernel<2><<<nBlocks(nPts),nThreads>>>(nPts,U,F,JGinv,p);
+  else
+    inviscidFluxSpts_kernel<3><<<nBlocks(nPts),nThreads>>>(nPts,U,F,JGinv,p);
+  checkLaunch();
+}
+
+void devViscousFluxSpts(int nPts, const double* U, const real* dU, real* F, const double* JGinv, deviceParams p)
+{
+  if (nPts <= 0) return;
+
+  if (p.nDims == 2)
+    viscousFluxSpts_kernel<2><<<nBlocks(nPts),nThreads>>>(nPts,U,dU,F,JGinv,p);
+  else
+    viscousFluxSpts_kernel<3><<<nBlocks(nPts),nThreads>>>(nPts,U,dU,F,JGinv,p);
+  checkLaunch();
+}
+
+void devTransformGradU(int nPts, real* dU, const double* JGinv, const double* detJac, int nDims, int nFields)
+{
+  if (nPts <= 0) return;
+
+  if (nDims == 2)
+    transformGradU_kernel<2><<<nBlocks(nPts),nThreads>>>(nPts,nFields,dU,JGinv,detJac);
+  else
+    transformGradU_kernel<3><<<nBlocks(nPts),nThreads>>>(nPts,nFields,dU,JGinv,detJac);
+  checkLaunch();
+}
+
+/* ---------------- Flux-point kernels ---------------- */
+
+__global__ void difference_kernel(int n, const real* a, const real* b, real* c)
+{
+  FOR_EACH_PT(i,n) {
+    c[i] = a[i] - b[i];
+  }
+}
+
+__global__ void convert_kernel(int n, const double* a, real* b)
+{
+  FOR_EACH_PT(i,n) {
+    b[i] = a[i];
+  }
+}
+
+__global__ void deltaFn_kernel(int nPts, int nDims, int nFields, const real* Fn, const real* F_fpts,
+                               const double* tNorm, real* dFn)
+{
+  int stride = nPts*nFields;
+
+  FOR_EACH_PT(pt,nPts) {
+    const double* t = tNorm + pt*nDims;
+    for (int k=0; k<nFields; k++) {
+      int i = pt*nFields + k;
+      double disFn = F_fpts[i]*t[0];
+      for (int dim=1; dim<nDims; dim++)
+        disFn += F_fpts[dim*stride + i]*t[dim];
+      dFn[i] = Fn[i] - disFn;
+    }
+  }
+}
+
+void devDifference(int n, const real* a, const real* b, real* c)
+{
+  if (n <= 0) return;
+
+  difference_kernel<<<nBlocks(n),nThreads>>>(n,a,b,c);
+  checkLaunch();
+}
+
+void devConvert(int n, const double* a, real* b)
+{
+  if (n <= 0) return;
+
+  convert_kernel<<<nBlocks(n),nThreads>>>(n,a,b);
+  checkLaunch();
+}
+
+void devDeltaFn(int nPts, const real* Fn, const real* F_fpts, const double* tNorm, real* dFn, int nDims, int nFields)
+{
+  if (nPts <= 0) return;
+
+  deltaFn_kernel<<<nBlocks(nPts),nThreads>>>(nPts,nDims,nFields,Fn,F_fpts,tNorm,dFn);
+  checkLaunch();
+}
+
+/* ---------------- Face kernels ---------------- */
+
+template<int nDims>
+__global__ void interiorFlux_kernel(int nPts, const int* idxL, const int* idxR, const double* norm, const double* dAL,
+                                    const double* dAR, const real* U_fpts, const real* UR, real* Fn_fpts,
+                                    real* Fn_face, double* waveSp, real* Uc_fpts, deviceParams p)
+{
+  const int nFields = nDims+2;
+
+  FOR_EACH_PT(pt,nPts) {
+    int iL = idxL[pt];
+    int iR = idxR[pt];
+    const double* n = norm + pt*nDims;
+
+    double uL[nFields], uR[nFields];
+    for (int k=0; k<nFields; k++) {
+      uL[k] = U_fpts[iL+k];
+      uR[k] = UR[iR+k];
+    }
+
+    double fn[nFields];
+    double eig = commonFlux<nDims,false>(uL,uR,n,p.gamma,fn);
+
+    for (int k=0; k<nFields; k++) {
+      Fn_face[pt*nFields+k] = fn[k];
+      Fn_fpts[iL+k] = fn[k]*dAL[pt];
+    }
+    waveSp[iL/nFields] = eig / dAL[pt];
+
+    if (dAR != NULL)
+      for (int k=0; k<nFields; k++)
+        Fn_fpts[iR+k] = -fn[k]*dAR[pt];
+
+    if (Uc_fpts != NULL) {
+      double penFact = ldgPenalty<nDims>(n,p.penFact);
+      for (int k=0; k<nFields; k++) {
+        double Uc = 0.5*(uL[k] + uR[k]) - penFact*(uL[k] - uR[k]);
+        Uc_fpts[iL+k] = Uc;
+        if (dAR != NULL)
+          Uc_fpts[iR+k] = Uc;
+      }
+    }
+  }
+}
+
+template<int nDims>
+__global__ void boundaryFlux_kernel(int nPts, const int* idxL, const int* bcType, const double* norm, const double* dAL,
+                                    const real* U_fpts, real* Fn_fpts, real* Fn_face, double* waveSp,
+                                    real* Uc_fpts, deviceParams p)
+{
+  const int nFields = nDims+2;
+
+  FOR_EACH_PT(pt,nPts) {
+    int iL = idxL[pt];
+    const double* n = norm + pt*nDims;
+
+    double uL[nFields], uR[nFields];
+    for (int k=0; k<nFields; k++)
+      uL[k] = U_fpts[iL+k];
+
+    boundaryState<nDims>(bcType[pt],uL,n,p,uR);
+
+    double fn[nFields];
+    double eig = commonFlux<nDims,true>(uL,uR,n,p.gamma,fn);
+
+    for (int k=0; k<nFields; k++) {
+      Fn_face[pt*nFields+k] = fn[k];
+      Fn_fpts[iL+k] = fn[k]*dAL[pt];
+    }
+    waveSp[iL/nFields] = eig / dAL[pt];
+
+    if (Uc_fpts != NULL)
+      for (int k=0; k<nFields; k++)
+        Uc_fpts[iL+k] = 0.5*(uL[k] + uR[k]);
+  }
+}
+
+template<int nDims>
+__global__ void interiorViscousFlux_kernel(int nPts, const int* idxL, const int* idxR, const double* norm,
+                                           const double* dAL, const double* dAR, const real* U_fpts,
+                                           const real* UR, const real* dU_fpts, int gStride,
+                                           const real* dUR, int gScaleR, int gStrideR, real* Fn_fpts,
+                                           const real* Fn_face, deviceParams p)
+{
+  const int nFields = nDims+2;
+
+  FOR_EACH_PT(pt,nPts) {
+    int iL = idxL[pt];
+    int iR = idxR[pt];
+    const double* n = norm + pt*nDims;
+
+    double uL[nFields], uR[nFields];
+    for (int k=0; k<nFields; k++) {
+      uL[k] = U_fpts[iL+k];
+      uR[k] = UR[iR+k];
+    }
+
+    double dUL[nDims*nFields], dURp[nDims*nFields];
+    for (int dim=0; dim<nDims; dim++) {
+      for (int k=0; k<nFields; k++) {
+        dUL[dim*nFields+k] = dU_fpts[iL + dim*gStride + k];
+        dURp[dim*nFields+k] = dUR[iR*gScaleR + dim*gStrideR + k];
+      }
+    }
+
+    double FL[nDims*nFields], FR[nDims*nFields];
+    viscousFlux<nDims>(uL,dUL,p,FL);
+    viscousFlux<nDims>(uR,dURp,p,FR);
+    double penFact = ldgPenalty<nDims>(n,p.penFact);
+
+    double fn[nFields];
+    for (int k=0; k<nFields; k++)
+      fn[k] = Fn_face[pt*nFields+k];
+
+    // As in face::calcCommonViscousFlux, the 3D average uses the first flux component only
+    for (int dim=0; dim<nDims; dim++) {
+      int dAvg = (nDims == 2) ? dim : 0;
+      for (int k=0; k<nFields; k++) {
+        double jump = n[0]*(FL[k] - FR[k]);
+        for (int j=1; j<nDims; j++)
+          jump += n[j]*(FL[j*nFields+k] - FR[j*nFields+k]);
+        double Fc = 0.5*(FL[dAvg*nFields+k] + FR[dAvg*nFields+k]) + penFact*n[dim]*jump + p.tau*n[dim]*(uL[k] - uR[k]);
+        fn[k] += Fc*n[dim];
+      }
+    }
+
+    for (int k=0; k<nFields; k++)
+      Fn_fpts[iL+k] = fn[k]*dAL[pt];
+
+    if (dAR != NULL)
+      for (int k=0; k<nFields; k++)
+        Fn_fpts[iR+k] = -fn[k]*dAR[pt];
+  }
+}
+
+template<int nDims>
+__global__ void boundaryViscousFlux_kernel(int nPts, const int* idxL, const int* bcType, const double* norm,
+                                           const double* dAL, const real* U_fpts, const real* dU_fpts,
+                                           int gStride, real* Fn_fpts, const real* Fn_face, deviceParams p)
+{
+  const int nFields = nDims+2;
+
+  FOR_EACH_PT(pt,nPts) {
+    int iL = idxL[pt];
+    const double* n = norm + pt*nDims;
+
+    double uL[nFields], uR[nFields];
+    for (int k=0; k<nFields; k++)
+      uL[k] = U_fpts[iL+k];
+
+    boundaryState<nDims>(bcType[pt],uL,n,p,uR);
+
+    double dU[nDims*nFields];
+    for (int dim=0; dim<nDims; dim++)
+      for (int k=0; k<nFields; k++)
+        dU[dim*nFields+k] = dU_fpts[iL + dim*gStride + k];
+
+    // Adiabatic wall: Neumann-type BC on the right state; otherwise, Dirichlet-type from the left
+    double Fv[nDims*nFields];
+    if (bcType[pt] == ADIABATIC_NOSLIP) {
+      adiabaticGradient<nDims>(uL,uR,p,dU);
+      viscousFlux<nDims>(uR,dU,p,Fv);
+    }
+    else {
+      viscousFlux<nDims>(uL,dU,p,Fv);
+    }
+
+    double fn[nFields];
+    for (int k=0; k<nFields; k++)
+      fn[k] = Fn_face[pt*nFields+k];
+
+    for (int dim=0; dim<nDims; dim++) {
+      for (int k=0; k<nFields; k++) {
+        double Fc = Fv[dim*nFields+k] + p.tau*n[dim]*(uL[k] - uR[k]);
+        fn[k] += Fc*n[dim];
+      }
+    }
+
+    for (int k=0; k<nFields; k++)
+      Fn_fpts[iL+k] = fn[k]*dAL[pt];
+  }
+}
+
+__global__ void pack_kernel(int nPts, const int* idx, const real* src, int stride, int nDims, int nFields, real* buf)
+{
+  FOR_EACH_PT(pt,nPts) {
+    for (int dim=0; dim<nDims; dim++)
+      for (int k=0; k<nFields; k++)
+        buf[(pt*nDims+dim)*nFields+k] = src[idx[pt] + dim*stride + k];
+  }
+}
+
+void devInteriorFlux(int nPts, const int* idxL, const int* idxR, const double* norm, const double* dAL,
+                     const double* dAR, const real* U_fpts, const real* UR, real* Fn_fpts,
+                     real* Fn_face, double* waveSp, real* Uc_fpts, deviceParams p)
+{
+  if (nPts <= 0) return;
+
+  if (p.nDims == 2)
+    interiorFlux_kernel<2><<<nBlocks(nPts),nThreads>>>(nPts,idxL,idxR,norm,dAL,dAR,U_fpts,UR,Fn_fpts,Fn_face,waveSp,Uc_fpts,p);
+  else
+    interiorFlux_kernel<3><<<nBlocks(nPts),nThreads>>>(nPts,idxL,idxR,norm,dAL,dAR,U_fpts,UR,Fn_fpts,Fn_face,waveSp,Uc_fpts,p);
+  checkLaunch();
+}
+
+void devBoundaryFlux(int nPts, const int* idxL, const int* bcType, const double* norm, const double* dAL,
+                     const real* U_fpts, real* Fn_fpts, real* Fn_face, double* waveSp,
+                     real* Uc_fpts, deviceParams p)
+{
+  if (nPts <= 0) return;
+
+  if (p.nDims == 2)
+    boundaryFlux_kernel<2><<<nBlocks(nPts),nThreads>>>(nPts,idxL,bcType,norm,dAL,U_fpts,Fn_fpts,Fn_face,waveSp,Uc_fpts,p);
+  else
+    boundaryFlux_kernel<3><<<nBlocks(nPts),nThreads>>>(nPts,idxL,bcType,norm,dAL,U_fpts,Fn_fpts,Fn_face,waveSp,Uc_fpts,p);
+  checkLaunch();
+}
+
+void devInteriorViscousFlux(int nPts, const int* idxL, const int* idxR, const double* norm, const double* dAL,
+                            const double* dAR, const real* U_fpts, const real* UR, const real* dU_fpts,
+                            int gStride, const real* dUR, int gScaleR, int gStrideR, real* Fn_fpts,
+                            const real* Fn_face, deviceParams p)
+{
+  if (nPts <= 0) return;
+
+  if (p.nDims == 2)
+    interiorViscousFlux_kernel<2><<<nBlocks(nPts),nThreads>>>(nPts,idxL,idxR,norm,dAL,dAR,U_fpts,UR,dU_fpts,gStride,
+                                                              dUR,gScaleR,gStrideR,Fn_fpts,Fn_face,p);
+  else
+    interiorViscousFlux_kernel<3><<<nBlocks(nPts),nThreads>>>(nPts,idxL,idxR,norm,dAL,dAR,U_fpts,UR,dU_fpts,gStride,
+                                                              dUR,gScaleR,gStrideR,Fn_fpts,Fn_face,p);
+  checkLaunch();
+}
+
+void devBoundaryViscousFlux(int nPts, const int* idxL, const int* bcType, const double* norm, const double* dAL,
+                            const real* U_fpts, const real* dU_fpts, int gStride, real* Fn_fpts,
+                            const real* Fn_face, deviceParams p)
+{
+  if (nPts <= 0) return;
+
+  if (p.nDims == 2)
+    boundaryViscousFlux_kernel<2><<<nBlocks(nPts),nThreads>>>(nPts,idxL,bcType,norm,dAL,U_fpts,dU_fpts,gStride,Fn_fpts,Fn_face,p);
+  else
+    boundaryViscousFlux_kernel<3><<<nBlocks(nPts),nThreads>>>(nPts,idxL,bcType,norm,dAL,U_fpts,dU_fpts,gStride,Fn_fpts,Fn_face,p);
+  checkLaunch();
+}
+
+void devPack(int nPts, const int* idx, const real* src, int stride, int nDims, int nFields, real* buf)
+{
+  if (nPts <= 0) return;
+
+  pack_kernel<<<nBlocks(nPts),nThreads>>>(nPts,idx,src,stride,nDims,nFields,buf);
+  checkLaunch();
+}
+
+/* ---------------- Time advancement ---------------- */
+
+__global__ void timeStepA_kernel(int nPts, int nEles, int nFields, double* U, const double* U0, const real* divF,
+                                 const double* detJac, const double* dtEle, double dt, double rkVal)
+{
+  FOR_EACH_PT(pt,nPts) {
+    double dtp = (dtEle != NULL) ? dtEle[pt%nEles] : dt;
+    for (int k=0; k<nFields; k++) {
+      int i = pt*nFields + k;
+      U[i] = U0[i] - rkVal * dtp * divF[i]/detJac[pt];
+    }
+  }
+}
+
+__global__ void timeStepB_kernel(int nPts, int nEles, int nFields, double* U, const real* divF,
+                                 const double* detJac, const double* dtEle, double dt, double rkVal)
+{
+  FOR_EACH_PT(pt,nPts) {
+    double dtp = (dtEle != NULL) ? dtEle[pt%nEles] : dt;
+    for (int k=0; k<nFields; k++) {
+      int i = pt*nFields + k;
+      U[i] -= rkVal * dtp * divF[i]/detJac[pt];
+    }
+  }
+}
+
+__global__ void calcDt_kernel(int nEles, int nFpts, const double* waveSp, const double* dA, double fac, double* dtEle)
+{
+  FOR_EACH_PT(ic,nEles) {
+    double ws = 0;
+    for (int fpt=0; fpt<nFpts; fpt++)
+      if (dA[fpt*nEles+ic] > 0) // ignore collapsed edges
+        ws = fmax(ws,waveSp[fpt*nEles+ic]);
+
+    dtEle[ic] = fac * (2.0 / (ws+1.e-10));
+  }
+}
+
+void devTimeStepA(int nPts, int nEles, int nFields, double* U, const double* U0, const real* divF,
+                  const double* detJac, const double* dtEle, double dt, double rkVal)
+{
+  if (nPts <= 0) return;
+
+  timeStepA_kernel<<<nBlocks(nPts),nThreads>>>(nPts,nEles,nFields,U,U0,divF,detJac,dtEle,dt,rkVal);
+  checkLaunch();
+}
+
+void devTimeStepB(int nPts, int nEles, int nFields, double* U, const real* divF,
+                  const double* detJac, const double* dtEle, double dt, double rkVal)
+{
+  if (nPts <= 0) return;
+
+  timeStepB_kernel<<<nBlocks(nPts),nThreads>>>(nPts,nEles,nFields,U,divF,detJac,dtEle,dt,rkVal);
+  checkLaunch();
+}
+
+void devCalcDt(int nEles, int nFpts, const double* waveSp, const double* dA, double fac, double* dtEle)
+{
+  if (nEles <= 0) return;
+
+  calcDt_kernel<<<nBlocks(nEles),nThreads>>>(nEles,nFpts,waveSp,dA,fac,dtEle);
+  checkLaunch();
+}
@@ -31,7 +31,9 @@
 
 #include "ele.hpp"
 
+#include <map>
 #include <sstream>
+#include <tuple>
 
 #include "polynomials.hpp"
 #include "flux.hpp"
@@ -76,6 +78,9 @@ void ele::setup(input *inParams, geo *inGeo, int in_order)
   nDims = params->nDims;
   nFields = params->nFields;
 
+  invFluxKernel = getInviscidFluxKernel(params);
+  visFluxKernel = getViscousFluxKernel(params);
+
   if (eType == QUAD || eType == HEX)
     sptsType = params->sptsTypeQuad;
   else
@@ -101,6 +106,11 @@ void ele::setup(input *inParams, geo *inGeo, int in_order)
 
 void ele::setupArrays(void)
 {
+  /* --- Batched storage: use views into the (eType,order) block's memory
+   * [any subsequent setup() calls on these matrices are no-ops] --- */
+  if (block != NULL)
+    setupBlockViews();
+
   U_spts.setup(nSpts,nFields);
   U_fpts.setup(nFpts,nFields);
   U_mpts.setup(nMpts,nFields);
@@ -110,7 +120,7 @@ void ele::setupArrays(void)
   Fn_fpts.initializeToZero();
 
   nRKSteps = params->nRKSteps;
-  divF_spts.resize(nRKSteps);
+  divF_spts.resize(params->nRKRegs);
   for (auto& dF:divF_spts) dF.setup(nSpts,nFields);
 
   if (nRKSteps>1)
@@ -142,14 +152,15 @@ void ele::setupArrays(void)
 
   detJac_spts.resize(nSpts);
   detJac_fpts.resize(nFpts);
-  Jac_spts.resize(nSpts);
-  Jac_fpts.resize(nFpts);
   JGinv_spts.resize(nSpts);
-  JGinv_fpts.resize(nFpts);
-  for (auto& spt:Jac_spts) spt.setup(nDims,nDims);
-  for (auto& fpt:Jac_fpts) fpt.setup(nDims,nDims);
   for (auto& spt:JGinv_spts) spt.setup(nDims,nDims);
-  for (auto& fpt:JGinv_fpts) fpt.setup(nDims,nDims);
+
+  // The Jacobian itself is only needed for the moving-grid transforms and
+  // overset projection; otherwise, only its inverse & determinant are kept
+  if (params->motion || params->meshType == OVERSET_MESH) {
+    Jac_spts.resize(nSpts);
+    for (auto& spt:Jac_spts) spt.setup(nDims,nDims);
+  }
 
   norm_fpts.setup(nFpts,nDims);
   tNorm_fpts.setup(nFpts,nDims);
@@ -195,17 +206,63 @@ void ele::setupArrays(void)
   tempU.assign(nFields,0);
 }
 
+void ele::setupBlockViews(void)
+{
+  if (block->nSpts != nSpts || block->nFpts != nFpts || block->nFields != nFields)
+    FatalError("Element and eleBlock sizes do not match.");
+
+  block->getView(block->U_spts, blockInd, U_spts);
+  block->getView(block->U_fpts, blockInd, U_fpts);
+  block->getView(block->disFn_fpts, blockInd, disFn_fpts);
+  block->getView(block->dFn_fpts, blockInd, dFn_fpts);
+  block->getView(block->Fn_fpts, blockInd, Fn_fpts);
+
+  divF_spts.resize(block->divF_spts.size());
+  for (uint step=0; step<divF_spts.size(); step++)
+    block->getView(block->divF_spts[step], blockInd, divF_spts[step]);
+
+  if (block->U0.getSize() > 0)
+    block->getView(block->U0, blockInd, U0);
+
+  F_spts.resize(nDims);
+  F_fpts.resize(nDims);
+  for (int dim=0; dim<nDims; dim++) {
+    block->getView(block->F_spts[dim], blockInd, F_spts[dim]);
+    block->getView(block->F_fpts[dim], blockInd, F_fpts[dim]);
+  }
+
+  if (params->motion || params->viscous) {
+    dU_spts.resize(nDims);
+    dU_fpts.resize(nDims);
+    for (int dim=0; dim<nDims; dim++) {
+      block->getView(block->dU_spts[dim], blockInd, dU_spts[dim]);
+      block->getView(block->dU_fpts[dim], blockInd, dU_fpts[dim]);
+    }
+  }
+
+  if (params->viscous) {
+    block->getView(block->Uc_fpts, blockInd, Uc_fpts);
+    block->getView(block->dUc_fpts, blockInd, dUc_fpts);
+  }
+
+  if (params->PMG) {
+    block->getView(block->sol_spts, blockInd, sol_spts);
+    block->getView(block->corr_spts, blockInd, corr_spts);
+    block->getView(block->src_spts, blockInd, src_spts);
+  }
+}
+
 void ele::setupAllGeometry(void) {
-  setShape_spts();
-  setShape_fpts();
-  setDShape_spts();
-  setDShape_fpts();
+  setShapeTables();
   setTransformedNormals_fpts();
   calcTransforms();
 
   calcPosSpts();
   calcPosFpts();
   setPpts();
+
+  if (Geo->rigidMotion)
+    setupRigidTransforms();
 }
 
 void ele::move(bool doTransforms)
@@ -214,6 +271,11 @@ void ele::move(bool doTransforms)
     nodesRK[i] = point(Geo->xv[Geo->c2v(ID,i)],nDims);
   }
 
+  if (Geo->rigidMotion) {
+    moveRigid(doTransforms);
+    return;
+  }
+
   if (params->meshType == OVERSET_MESH) {
     // Only needed for overset connectivity purposes [also called from output.cpp]
     updatePosSpts();
@@ -221,12 +283,89 @@ void ele::move(bool doTransforms)
   }
 
   if (doTransforms) {
-    if (params->motion!=4) // Rigid translation: No update needed
-      calcTransforms(true);
+    calcTransforms(true);
     calcGridVelocity();
   }
 }
 
+void ele::setupRigidTransforms(void)
+{
+  Jac0_spts = Jac_spts;
+  JGinv0_spts = JGinv_spts;
+  norm0_fpts = norm_fpts;
+  pos0_spts = pos_spts;
+  pos0_fpts = pos_fpts;
+}
+
+void ele::moveRigid(bool doTransforms)
+{
+  /* For x = R*(x0 - xc) + xc + d:  Jac = R*Jac0, and since R is orthonormal,
+   * JGinv = adj(Jac) = JGinv0*R^T, norm = R*norm0; detJac & dA are unchanged.
+   * The grid velocity is Vc + omega x (x - xc - d). */
+  auto &R = Geo->rotMat;
+  point &xc = Geo->rotCenter;
+  point &d = Geo->rigidOffset;
+  point &Vc = Geo->rigidVel;
+  double omega = Geo->rotOmega;
+
+  auto rigidPos = [&](const point &pt0, point &pt, double &rx, double &ry) {
+    point dx = pt0;
+    dx -= xc;
+    rx = R(0,0)*dx.x + R(0,1)*dx.y;
+    ry = R(1,0)*dx.x + R(1,1)*dx.y;
+    pt.x = xc.x + rx + d.x;
+    pt.y = xc.y + ry + d.y;
+    pt.z = pt0.z;
+  };
+
+  auto rotate = [&](const matrix<double> &A0, matrix<double> &A, bool leftMult) {
+    for (int i=0; i<nDims; i++) {
+      for (int j=0; j<nDims; j++) {
+        A(i,j) = 0;
+        for (int k=0; k<nDims; k++)
+          A(i,j) += (leftMult) ? R(i,k)*A0(k,j) : A0(i,k)*R(j,k);
+      }
+    }
+  };
+
+  for (int spt=0; spt<nSpts; spt++) {
+    double rx, ry;
+    rigidPos(pos0_spts[spt],pos_spts[spt],rx,ry);
+
+    if (doTransforms) {
+      rotate(Jac0_spts[spt],Jac_spts[spt],true);
+      rotate(JGinv0_spts[spt],JGinv_spts[spt],false);
+
+      gridVel_spts(spt,0) = Vc.x - omega*ry;
+      gridVel_spts(spt,1) = Vc.y + omega*rx;
+      if (nDims == 3) gridVel_spts(spt,2) = 0.;
+    }
+  }
+
+  for (int fpt=0; fpt<nFpts; fpt++) {
+    double rx, ry;
+    rigidPos(pos0_fpts[fpt],pos_fpts[fpt],rx,ry);
+
+    if (doTransforms) {
+      for (int i=0; i<nDims; i++) {
+        norm_fpts(fpt,i) = 0;
+        for (int j=0; j<nDims; j++)
+          norm_fpts(fpt,i) += R(i,j)*norm0_fpts(fpt,j);
+      }
+
+      gridVel_fpts(fpt,0) = Vc.x - omega*ry;
+      gridVel_fpts(fpt,1) = Vc.y + omega*rx;
+      if (nDims == 3) gridVel_fpts(fpt,2) = 0.;
+    }
+  }
+
+  if (doTransforms) {
+    for (int iv=0; iv<nNodes; iv++)
+      for (int dim=0; dim<nDims; dim++)
+        gridVel_nodes(iv,dim) = Geo->gridVel(Geo->c2v(ID,iv),dim);
+  }
+}
+
 void ele::calcGridVelocity(void)
 {
   for (int iv=0; iv<nNodes; iv++) {
@@ -239,7 +378,7 @@ void ele::calcGridVelocity(void)
   for (int spt=0; spt<nSpts; spt++) {
     for (int iv=0; iv<nNodes; iv++) {
       for (int dim=0; dim<nDims; dim++) {
-        gridVel_spts(spt,dim) += shape_spts(spt,iv)*gridVel_nodes(iv,dim);
+        gridVel_spts(spt,dim) += shapes->spts(spt,iv)*gridVel_nodes(iv,dim);
       }
     }
   }
@@ -248,14 +387,34 @@ void ele::calcGridVelocity(void)
   for (int fpt=0; fpt<nFpts; fpt++) {
     for (int iv=0; iv<nNodes; iv++) {
       for (int dim=0; dim<nDims; dim++) {
-        gridVel_fpts(fpt,dim) += shape_fpts(fpt,iv)*gridVel_nodes(iv,dim);
+        gridVel_fpts(fpt,dim) += shapes->fpts(fpt,iv)*gridVel_nodes(iv,dim);
       }
     }
   }
 }
 
-void ele::setShape_spts(void)
+void ele::setShapeTables(void)
+{
+  static map<tuple<int,int,int,string>, shared_ptr<shapeTables>> tables;
+
+#pragma omp critical (shapeTables)
+  {
+    auto &tab = tables[make_tuple(eType,order,nNodes,sptsType)];
+    if (!tab) {
+      tab = make_shared<shapeTables>();
+      setShape_spts(*tab);
+      setShape_fpts(*tab);
+      setDShape_spts(*tab);
+      setDShape_fpts(*tab);
+      tab->wts_spts = getQptWeights(order,nDims);
+    }
+    shapes = tab;
+  }
+}
+
+void ele::setShape_spts(shapeTables &tab)
 {
+  auto &shape_spts = tab.spts;
   shape_spts.setup(nSpts,nNodes);
 
   for (int spt=0; spt<nSpts; spt++) {
@@ -273,8 +432,9 @@ void ele::setShape_spts(void)
   }
 }
 
-void ele::setShape_fpts(void)
+void ele::setShape_fpts(shapeTables &tab)
 {
+  auto &shape_fpts = tab.fpts;
   shape_fpts.setup(nFpts,nNodes);
 
   for (int fpt=0; fpt<nFpts; fpt++) {
@@ -292,8 +452,9 @@ void ele::setShape_fpts(void)
   }
 }
 
-void ele::setDShape_spts(void)
+void ele::setDShape_spts(shapeTables &tab)
 {
+  auto &dShape_spts = tab.dSpts;
   dShape_spts.resize(nSpts);
   for (auto& dS:dShape_spts) dS.setup(nNodes,nDims);
 
@@ -314,8 +475,9 @@ void ele::setDShape_spts(void)
   }
 }
 
-void ele::setDShape_fpts(void)
+void ele::setDShape_fpts(shapeTables &tab)
 {
+  auto &dShape_fpts = tab.dFpts;
   dShape_fpts.resize(nFpts);
   for (auto& dS:dShape_fpts) dS.setup(nNodes,nDims);
 
@@ -426,85 +588,68 @@ void ele::setTransformedNormals_fpts(void)
   }
 }
 
+/*! Inverse of the transformation Jacobian [times its determinant]; returns the determinant */
+static double calcJGinv(matrix<double> &Jac, matrix<double> &JGinv)
+{
+  if (Jac.getDim0() == 2) {
+    JGinv(0,0) = Jac(1,1);  JGinv(0,1) =-Jac(0,1);
+    JGinv(1,0) =-Jac(1,0);  JGinv(1,1) = Jac(0,0);
+    return Jac(0,0)*Jac(1,1)-Jac(1,0)*Jac(0,1);
+  }
+
+  double xr = Jac(0,0);   double xs = Jac(0,1);   double xt = Jac(0,2);
+  double yr = Jac(1,0);   double ys = Jac(1,1);   double yt = Jac(1,2);
+  double zr = Jac(2,0);   double zs = Jac(2,1);   double zt = Jac(2,2);
+
+  JGinv(0,0) = ys*zt - yt*zs;  JGinv(0,1) = xt*zs - xs*zt;  JGinv(0,2) = xs*yt - xt*ys;
+  JGinv(1,0) = yt*zr - yr*zt;  JGinv(1,1) = xr*zt - xt*zr;  JGinv(1,2) = xt*yr - xr*yt;
+  JGinv(2,0) = yr*zs - ys*zr;  JGinv(2,1) = xs*zr - xr*zs;  JGinv(2,2) = xr*ys - xs*yr;
+  return xr*(ys*zt - yt*zs) - xs*(yr*zt - yt*zr) + xt*(yr*zs - ys*zr);
+}
+
 void ele::calcTransforms(bool moving)
 {
-  /* --- Calculate Transformation at Solution Points --- */
-  for (int spt=0; spt<nSpts; spt++) {
-    Jac_spts[spt].initializeToZero();
+  auto &nodePts = (moving) ? nodesRK : nodes;
+  bool storeJac = !Jac_spts.empty();
 
-    if (!moving) {
-      for (int i=0; i<nNodes; i++)
-        for (int dim1=0; dim1<nDims; dim1++)
-          for (int dim2=0; dim2<nDims; dim2++)
-            Jac_spts[spt](dim1,dim2) += dShape_spts[spt](i,dim2)*nodes[i][dim1];
-    }
-    else {
-      for (int i=0; i<nNodes; i++)
-        for (int dim1=0; dim1<nDims; dim1++)
-          for (int dim2=0; dim2<nDims; dim2++)
-            Jac_spts[spt](dim1,dim2) += dShape_spts[spt](i,dim2)*nodesRK[i][dim1];
-    }
+  static thread_local matrix<double> Jac;    // Transformation Jacobian at the current point
+  static thread_local matrix<double> JGinv;  // Inverse of transformation Jacobian (times its determinant)
+  Jac.setup(nDims,nDims);
+  JGinv.setup(nDims,nDims);
 
-    if (nDims == 2) {
-      // Determinant of transformation matrix
-      detJac_spts[spt] = Jac_spts[spt](0,0)*Jac_spts[spt](1,1)-Jac_spts[spt](1,0)*Jac_spts[spt](0,1);
-      // Inverse of transformation matrix (times its determinant)
-      JGinv_spts[spt](0,0) = Jac_spts[spt](1,1);  JGinv_spts[spt](0,1) =-Jac_spts[spt](0,1);
-      JGinv_spts[spt](1,0) =-Jac_spts[spt](1,0);  JGinv_spts[spt](1,1) = Jac_spts[spt](0,0);
-    }
-    else if (nDims == 3) {
-      double xr = Jac_spts[spt](0,0);   double xs = Jac_spts[spt](0,1);   double xt = Jac_spts[spt](0,2);
-      double yr = Jac_spts[spt](1,0);   double ys = Jac_spts[spt](1,1);   double yt = Jac_spts[spt](1,2);
-      double zr = Jac_spts[spt](2,0);   double zs = Jac_spts[spt](2,1);   double zt = Jac_spts[spt](2,2);
-      detJac_spts[spt] = xr*(ys*zt - yt*zs) - xs*(yr*zt - yt*zr) + xt*(yr*zs - ys*zr);
+  /* --- Calculate Transformation at Solution Points --- */
+  for (int spt=0; spt<nSpts; spt++) {
+    auto &dShape = shapes->dSpts[spt];
+    Jac.initializeToZero();
+    for (int i=0; i<nNodes; i++)
+      for (int dim1=0; dim1<nDims; dim1++)
+        for (int dim2=0; dim2<nDims; dim2++)
+          Jac(dim1,dim2) += dShape(i,dim2)*nodePts[i][dim1];
 
-      JGinv_spts[spt](0,0) = ys*zt - yt*zs;  JGinv_spts[spt](0,1) = xt*zs - xs*zt;  JGinv_spts[spt](0,2) = xs*yt - xt*ys;
-      JGinv_spts[spt](1,0) = yt*zr - yr*zt;  JGinv_spts[spt](1,1) = xr*zt - xt*zr;  JGinv_spts[spt](1,2) = xt*yr - xr*yt;
-      JGinv_spts[spt](2,0) = yr*zs - ys*zr;  JGinv_spts[spt](2,1) = xs*zr - xr*zs;  JGinv_spts[spt](2,2) = xr*ys - xs*yr;
-    }
+    detJac_spts[spt] = calcJGinv(Jac,JGinv_spts[spt]);
     if (detJac_spts[spt]<0) FatalError("Negative Jacobian at solution points.");
+
+    if (storeJac) Jac_spts[spt] = Jac;
   }
 
   /* --- Calculate Transformation at Flux Points --- */
   for (int fpt=0; fpt<nFpts; fpt++) {
     // Calculate transformation Jacobian matrix - [dx/dr, dx/ds; dy/dr, dy/ds]
-    Jac_fpts[fpt].initializeToZero();
-    if (!moving) {
-      for (int i=0; i<nNodes; i++)
-        for (int dim1=0; dim1<nDims; dim1++)
-          for (int dim2=0; dim2<nDims; dim2++)
-            Jac_fpts[fpt][dim1][dim2] += dShape_fpts[fpt][i][dim2]*nodes[i][dim1];
-    }
-    else {
-      for (int i=0; i<nNodes; i++)
-        for (int dim1=0; dim1<nDims; dim1++)
-          for (int dim2=0; dim2<nDims; dim2++)
-            Jac_fpts[fpt][dim1][dim2] += dShape_fpts[fpt][i][dim2]*nodesRK[i][dim1];
-    }
+    auto &dShape = shapes->dFpts[fpt];
+    Jac.initializeToZero();
+    for (int i=0; i<nNodes; i++)
+      for (int dim1=0; dim1<nDims; dim1++)
+        for (int dim2=0; dim2<nDims; dim2++)
+          Jac(dim1,dim2) += dShape(i,dim2)*nodePts[i][dim1];
 
-    if (nDims == 2) {
-      detJac_fpts[fpt] = Jac_fpts[fpt](0,0)*Jac_fpts[fpt](1,1)-Jac_fpts[fpt](1,0)*Jac_fpts[fpt](0,1);
-      // Inverse of transformation matrix (times its determinant)
-      JGinv_fpts[fpt](0,0) = Jac_fpts[fpt](1,1);  JGinv_fpts[fpt](0,1) =-Jac_fpts[fpt](0,1);
-      JGinv_fpts[fpt](1,0) =-Jac_fpts[fpt](1,0);  JGinv_fpts[fpt](1,1) = Jac_fpts[fpt](0,0);
-    }
-    else if (nDims == 3) {
-      double xr = Jac_fpts[fpt](0,0);   double xs = Jac_fpts[fpt](0,1);   double xt = Jac_fpts[fpt](0,2);
-      double yr = Jac_fpts[fpt](1,0);   double ys = Jac_fpts[fpt](1,1);   double yt = Jac_fpts[fpt](1,2);
-      double zr = Jac_fpts[fpt](2,0);   double zs = Jac_fpts[fpt](2,1);   double zt = Jac_fpts[fpt](2,2);
-      detJac_fpts[fpt] = xr*(ys*zt - yt*zs) - xs*(yr*zt - yt*zr) + xt*(yr*zs - ys*zr);
-      // Inverse of transformation matrix (times its determinant)
-      JGinv_fpts[fpt](0,0) = ys*zt - yt*zs;  JGinv_fpts[fpt](0,1) = xt*zs - xs*zt;  JGinv_fpts[fpt](0,2) = xs*yt - xt*ys;
-      JGinv_fpts[fpt](1,0) = yt*zr - yr*zt;  JGinv_fpts[fpt](1,1) = xr*zt - xt*zr;  JGinv_fpts[fpt](1,2) = xt*yr - xr*yt;
-      JGinv_fpts[fpt](2,0) = yr*zs - ys*zr;  JGinv_fpts[fpt](2,1) = xs*zr - xr*zs;  JGinv_fpts[fpt](2,2) = xr*ys - xs*yr;
-    }
+    detJac_fpts[fpt] = calcJGinv(Jac,JGinv);
 
     /* --- Calculate outward unit normal vector at flux point --- */
     // Transform face normal from reference to physical space [JGinv .dot. tNorm]
     for (int dim1=0; dim1<nDims; dim1++) {
       norm_fpts(fpt,dim1) = 0.;
       for (int dim2=0; dim2<nDims; dim2++) {
-        norm_fpts(fpt,dim1) += JGinv_fpts[fpt](dim2,dim1) * tNorm_fpts(fpt,dim2);
+        norm_fpts(fpt,dim1) += JGinv(dim2,dim1) * tNorm_fpts(fpt,dim2);
       }
     }
 
@@ -576,6 +721,8 @@ void ele::calcTransforms_point(matrix<double> &jacobian, matrix<double> &JGinv,
 
 point ele::calcPos(const point &loc)
 {
+  // Thread-local scratch: the donor searches locate points in the same element from several threads
+  static thread_local vector<double> tmpShape;
   getShape(loc,tmpShape);
 
   point pt;
@@ -616,7 +763,7 @@ vector<double> ele::getBoundingBox(void)
   return bbox;
 }
 
-bool ele::getRefLocNewton(point pos, point &loc)
+bool ele::getRefLocNewton(point pos, point &loc, point guess)
 {
   // First, do a quick check to see if the point is even close to being in the element
   double xmin, ymin, zmin;
@@ -642,37 +789,118 @@ bool ele::getRefLocNewton(point pos, point &loc)
 
   double tol = 1e-12*h;
 
-  vector<double> shape(nNodes);
-  matrix<double> dshape(nNodes,nDims);
-  matrix<double> grad(nDims,nDims);
+  loc = guess;
+  for (int i=0; i<nDims; i++)
+    loc[i] = max(min(loc[i],1.),-1.);
+
+  return (newtonRefLoc(pos,loc,tol) >= 0);
+}
+
+int ele::getRefLocNewton(const point* pos, int nPts, point* loc, char* isIn, refLocStats* stats)
+{
+  double eps = 1e-10;
+
+  auto box = getBoundingBox();
+
+  // Use a relative tolerance to handle extreme grids
+  double h = min(box[3]-box[0],box[4]-box[1]);
+  if (nDims==3) h = min(h,box[5]-box[2]);
+
+  double tol = 1e-12*h;
+
+  // Uniform lattice of reference points & their physical positions, used for
+  // the initial guesses [only built once a point passes the bounding-box test]
+  const int nSub = 4;
+  static thread_local vector<point> latRef, latPos;
+  latRef.clear();
+  latPos.clear();
+
+  int nFound = 0;
+  for (int ipt=0; ipt<nPts; ipt++) {
+    const point &pt = pos[ipt];
+    isIn[ipt] = 0;
+    loc[ipt] = {99.,99.,99.};
+
+    if (pt.x < box[0]-eps || pt.y < box[1]-eps || pt.z < box[2]-eps ||
+        pt.x > box[3]+eps || pt.y > box[4]+eps || pt.z > box[5]+eps)
+      continue;
+
+    if (latPos.empty()) {
+      int nk = (nDims == 3) ? nSub+1 : 1;
+      for (int k=0; k<nk; k++) {
+        for (int j=0; j<=nSub; j++) {
+          for (int i=0; i<=nSub; i++) {
+            point rs(-1.+2.*i/nSub, -1.+2.*j/nSub, (nDims == 3) ? -1.+2.*k/nSub : 0.);
+            latRef.push_back(rs);
+            latPos.push_back(calcPos(rs));
+          }
+        }
+      }
+    }
+
+    // Start from the nearest lattice point
+    double minDist = INFINITY;
+    for (uint n=0; n<latPos.size(); n++) {
+      double dist = 0;
+      for (int dim=0; dim<nDims; dim++)
+        dist += (latPos[n][dim]-pt[dim])*(latPos[n][dim]-pt[dim]);
+      if (dist < minDist) {
+        minDist = dist;
+        loc[ipt] = latRef[n];
+      }
+    }
+
+    int nIter = newtonRefLoc(pt,loc[ipt],tol);
+
+    if (nIter >= 0) {
+      isIn[ipt] = 1;
+      nFound++;
+    }
+
+    if (stats) {
+      stats->nNewton++;
+      stats->nIters += (nIter >= 0) ? nIter : 20;
+      stats->maxIters = max(stats->maxIters, (nIter >= 0) ? nIter : 20);
+    }
+  }
+
+  if (stats) {
+    stats->nPts += nPts;
+    stats->nFound += nFound;
+  }
+
+  return nFound;
+}
+
+int ele::newtonRefLoc(const point &pos, point &loc, double tol)
+{
+  static thread_local vector<double> shape;
+  static thread_local matrix<double> dshape, grad;
+  shape.resize(nNodes);
+  dshape.setup(nNodes,nDims);
+  grad.setup(nDims,nDims);
+
+  const vector<point> &xn = (params->motion) ? nodesRK : nodes;
 
   int iter = 0;
   int iterMax = 20;
   double norm = 1;
-  loc = {0, 0, 0};
+
   while (norm > tol && iter<iterMax) {
-    shape_quad(loc,shape,nNodes);
-    dshape_quad(loc,dshape,nNodes);
+    getShape(loc,shape);
+    if (nDims == 2)
+      dshape_quad(loc,dshape,nNodes);
+    else
+      dshape_hex(loc,dshape,nNodes);
 
     point dx = pos;
     grad.initializeToZero();
-    if (params->motion) {
-      for (int n=0; n<nNodes; n++) {
-        for (int i=0; i<nDims; i++) {
-          for (int j=0; j<nDims; j++) {
-            grad(i,j) += nodesRK[n][i]*dshape(n,j);
-          }
-          dx[i] -= shape[n]*nodesRK[n][i];
-        }
-      }
-    } else {
-      for (int n=0; n<nNodes; n++) {
-        for (int i=0; i<nDims; i++) {
-          for (int j=0; j<nDims; j++) {
-            grad(i,j) += nodes[n][i]*dshape(n,j);
-          }
-          dx[i] -= shape[n]*nodes[n][i];
+    for (int n=0; n<nNodes; n++) {
+      for (int i=0; i<nDims; i++) {
+        for (int j=0; j<nDims; j++) {
+          grad(i,j) += xn[n][i]*dshape(n,j);
         }
+        dx[i] -= shape[n]*xn[n][i];
       }
     }
 
@@ -694,11 +922,11 @@ bool ele::getRefLocNewton(point pos, point &loc)
 
     iter++;
     if (iter == iterMax) {
-      return false;
+      return -1;
     }
   }
 
-  return true;
+  return iter;
 }
 
 double ele::getDxNelderMead(point refLoc, point physPos)
@@ -854,7 +1082,7 @@ void ele::calcPosSpts(void)
     pos_spts[spt].zero();
     for (int iv=0; iv<nNodes; iv++) {
       for (int dim=0; dim<nDims; dim++) {
-        pos_spts[spt][dim] += shape_spts(spt,iv)*nodes[iv][dim];
+        pos_spts[spt][dim] += shapes->spts(spt,iv)*nodes[iv][dim];
       }
     }
   }
@@ -866,7 +1094,7 @@ void ele::calcPosFpts(void)
     pos_fpts[fpt].zero();
     for (int iv=0; iv<nNodes; iv++) {
       for (int dim=0; dim<nDims; dim++) {
-        pos_fpts[fpt][dim] += shape_fpts(fpt,iv)*nodes[iv][dim];
+        pos_fpts[fpt][dim] += shapes->fpts(fpt,iv)*nodes[iv][dim];
       }
     }
   }
@@ -878,7 +1106,7 @@ void ele::updatePosSpts(void)
     pos_spts[spt].zero();
     for (int iv=0; iv<nNodes; iv++) {
       for (int dim=0; dim<nDims; dim++) {
-        pos_spts[spt][dim] += shape_spts(spt,iv)*nodesRK[iv][dim];
+        pos_spts[spt][dim] += shapes->spts(spt,iv)*nodesRK[iv][dim];
       }
     }
   }
@@ -890,7 +1118,7 @@ void ele::updatePosFpts(void)
     pos_fpts[fpt].zero();
     for (int iv=0; iv<nNodes; iv++) {
       for (int dim=0; dim<nDims; dim++) {
-        pos_fpts[fpt][dim] += shape_fpts(fpt,iv)*nodesRK[iv][dim];
+        pos_fpts[fpt][dim] += shapes->fpts(fpt,iv)*nodesRK[iv][dim];
       }
     }
   }
@@ -1177,75 +1405,18 @@ void ele::getShape(point loc, vector<double> &shape)
 
 void ele::calcInviscidFlux_spts()
 {
-  for (int spt=0; spt<nSpts; spt++) {
-
-    inviscidFlux(U_spts[spt], tempF, params);
-
-    if (params->motion) {
-      /* --- Don't transform yet; that will be handled later --- */
-      for (int i=0; i<nDims; i++) {
-        for (int k=0; k<nFields; k++) {
-          F_spts[i](spt,k) = tempF(i,k);
-        }
-      }
-    }
-    else {
-      /* --- Transform back to reference domain --- */
-      for (int i=0; i<nDims; i++) {
-        for (int k=0; k<nFields; k++) {
-          F_spts[i](spt,k) = 0.;
-          for (int j=0; j<nDims; j++) {
-            F_spts[i](spt,k) += JGinv_spts[spt](i,j)*tempF(j,k);
-          }
-        }
-      }
-    }
-
-  }
+  /* --- For moving grids, don't transform yet; that will be handled later --- */
+  invFluxKernel(U_spts, F_spts, (params->motion) ? NULL : &JGinv_spts, params);
 }
 
 void ele::calcViscousFlux_spts()
 {
-  for (int spt=0; spt<nSpts; spt++) {
-
-    // TEMP HACK (inefficient, but will work fine)
-    matrix<double> tempDU(nDims,nFields);
-    for (int dim=0; dim<nDims; dim++) {
-      for (int k=0; k<nFields; k++) {
-        tempDU(dim,k) = dU_spts[dim](spt,k);
-      }
-    }
-
-    if (params->equation == NAVIER_STOKES)
-      viscousFlux(U_spts[spt], tempDU, tempF, params);
-    else if (params->equation == ADVECTION_DIFFUSION)
-      viscousFluxAD(tempDU, tempF, params);
-
-    if (params->motion) {
-      /* --- Don't transform yet; that will be handled later --- */
-      for (int i=0; i<nDims; i++) {
-        for (int k=0; k<nFields; k++) {
-          F_spts[i](spt,k) += tempF(i,k);
-        }
-      }
-    }
-    else {
-      /* --- Transform back to reference domain --- */
-      for (int k=0; k<nFields; k++) {
-        for (int i=0; i<nDims; i++) {
-          for (int j=0; j<nDims; j++) {
-            F_spts[i](spt,k) += JGinv_spts[spt](i,j)*tempF(j,k);
-          }
-        }
-      }
-    }
-
-  }
+  visFluxKernel(U_spts, dU_spts, F_spts, (params->motion) ? NULL : &JGinv_spts, params);
 }
 
-vector<matrix<double>> ele::transformFlux_physToRef(void)
+void ele::transformFlux_physToRef(vector<matrix<double>> &outF)
 {
-  vector<matrix<double>> outF(nDims);
+  outF.resize(nDims);
   for (auto &FD:outF) {
     FD.setup(nSpts,nFields);
     FD.initializeToZero();
@@ -1253,9 +1424,9 @@ vector<matrix<double>> ele::transformFlux_physToRef(void)
 
   if (params->motion) {
     // Use space-time transformation
+    matrix<double> jacobian(nDims+1,nDims+1);
+    jacobian(nDims,nDims) = 1;
     for (int spt=0; spt<nSpts; spt++) {
-      matrix<double> jacobian(nDims+1,nDims+1);
-      jacobian(nDims,nDims) = 1;
       for (int dim1=0; dim1<nDims; dim1++) {
         jacobian(dim1,nDims) = gridVel_spts(spt,dim1);
         for (int dim2=0; dim2<nDims; dim2++) {
@@ -1287,8 +1458,6 @@ vector<matrix<double>> ele::transformFlux_physToRef(void)
       }
     }
   }
-
-  return outF;
 }
 
 vector<matrix<double>> ele::transformFlux_refToPhys(void)
@@ -1309,9 +1478,9 @@ vector<matrix<double>> ele::transformFlux_refToPhys(void)
   return outF;
 }
 
-vector<matrix<double>> ele::transformGradU_physToRef(void)
+void ele::transformGradU_physToRef(vector<matrix<double>> &outDU)
 {
-  vector<matrix<double>> outDU(nDims);
+  outDU.resize(nDims);
   for (auto &DU:outDU) {
     DU.setup(nSpts,nFields);
     DU.initializeToZero();
@@ -1325,8 +1494,6 @@ vector<matrix<double>> ele::transformGradU_physToRef(void)
       }
     }
   }
-
-  return outDU;
 }
 
 void ele::transformGradF_spts(int step)
@@ -1368,6 +1535,30 @@ void ele::transformGradF_spts(int step)
   }
 }
 
+void ele::calcDisFn_fpts(void)
+{
+  if (params->motion) {
+    // Physical normal flux
+    for (int fpt=0; fpt<nFpts; fpt++) {
+      for (int k=0; k<nFields; k++) {
+        disFn_fpts(fpt,k) = 0;
+        for (int dim=0; dim<nDims; dim++)
+          disFn_fpts(fpt,k) += F_fpts[dim](fpt,k)*norm_fpts(fpt,dim)*dA_fpts[fpt];
+      }
+    }
+  }
+  else {
+    // Transformed normal flux
+    for (int fpt=0; fpt<nFpts; fpt++) {
+      for (int k=0; k<nFields; k++) {
+        disFn_fpts(fpt,k) = F_fpts[0](fpt,k)*tNorm_fpts(fpt,0);
+        for (int dim=1; dim<nDims; dim++)
+          disFn_fpts(fpt,k) += F_fpts[dim](fpt,k)*tNorm_fpts(fpt,dim);
+      }
+    }
+  }
+}
+
 void ele::calcDeltaFn(void)
 {
   for (int fpt=0; fpt<nFpts; fpt++) {
@@ -1390,7 +1581,8 @@ void ele::calcDeltaUc(void)
 void ele::calcEntropyErr_spts(void)
 {
   for (int spt=0; spt<nSpts; spt++) {
-    auto v = getEntropyVars(spt);
+    double v[5];
+    getEntropyVars(spt,v);
     S_spts(spt) = 0;
     for (int k=0; k<nFields; k++) {
       S_spts(spt) += v[k]*divF_spts[0](spt,k);
@@ -1399,12 +1591,12 @@ void ele::calcEntropyErr_spts(void)
   }
 }
 
-vector<double> ele::getEntropyVars(int spt)
+void ele::getEntropyVars(int spt, double* v)
 {
-  vector<double> v(nFields);
   double gamma = params->gamma;
 
-  auto phi = getPrimitives(spt);
+  double phi[5] = {0};
+  getPrimitives(spt,phi);
 
   if (nDims == 2) {
     double S = log(phi[3]) - gamma*log(phi[0]); // ln(p) - gamma ln(rho)
@@ -1425,8 +1617,6 @@ vector<double> ele::getEntropyVars(int spt)
     v[3] = phi[0]*phi[3]/phi[4];
     v[4] = -phi[0]/phi[4];
   }
-
-  return v;
 }
 
 void ele::calcWaveSpFpts(void)
@@ -1532,6 +1722,45 @@ double ele::calcDt(void)
 }
 
 
+void ele::timeStepLS(double rkA, double rkB, bool source)
+{
+  if (params->dtType != 2) dt = params->dt;
+
+  for (int spt=0; spt<nSpts; spt++) {
+    for (int i=0; i<nFields; i++) {
+      double R = divF_spts[0](spt,i);
+      if (source) R += src_spts(spt,i);
+      U0(spt,i) = rkA * U0(spt,i) - dt * R / detJac_spts[spt];
+      U_spts(spt,i) += rkB * U0(spt,i);
+    }
+  }
+}
+
+double ele::timeStepSSP(double rkA, bool source, bool calcErr)
+{
+  if (params->dtType != 2) dt = params->dt;
+
+  double err = 0;
+  for (int spt=0; spt<nSpts; spt++) {
+    for (int i=0; i<nFields; i++) {
+      double R = divF_spts[0](spt,i);
+      if (source) R += src_spts(spt,i);
+      double U = rkA * U0(spt,i) + (1.-rkA) * (U_spts(spt,i) - dt * R / detJac_spts[spt]);
+
+      if (calcErr) {
+        /* Embedded 2nd-order solution is 2*U_2 - U0 */
+        double sc = params->adaptATol + params->adaptRTol * max(fabs(U0(spt,i)),fabs(U));
+        double e = (U - (2.*U_spts(spt,i) - U0(spt,i))) / sc;
+        err += e*e;
+      }
+
+      U_spts(spt,i) = U;
+    }
+  }
+
+  return err;
+}
+
 void ele::copyUspts_U0(void)
 {
   U0 = U_spts;
@@ -1542,10 +1771,8 @@ void ele::copyU0_Uspts(void)
   U_spts = U0;
 }
 
-vector<double> ele::getPrimitives(uint spt)
+void ele::getPrimitives(uint spt, double* V)
 {
-  vector<double> V(nFields);
-
   if (params->equation == ADVECTION_DIFFUSION) {
     V[0] = U_spts[spt][0];
   }
@@ -1560,14 +1787,10 @@ vector<double> ele::getPrimitives(uint spt)
     }
     V[nDims+1] = (params->gamma-1)*(U_spts(spt,nDims+1) - 0.5*V[0]*vMagSq);
   }
-
-  return V;
 }
 
-vector<double> ele::getPrimitivesFpt(uint fpt)
+void ele::getPrimitivesFpt(uint fpt, double* V)
 {
-  vector<double> V(nFields);
-
   if (params->equation == ADVECTION_DIFFUSION) {
     V[0] = U_fpts[fpt][0];
   }
@@ -1582,14 +1805,10 @@ vector<double> ele::getPrimitivesFpt(uint fpt)
     }
     V[nDims+1] = (params->gamma-1)*(U_fpts(fpt,nDims+1) - 0.5*V[0]*vMagSq);
   }
-
-  return V;
 }
 
-vector<double> ele::getPrimitivesMpt(uint mpt)
+void ele::getPrimitivesMpt(uint mpt, double* V)
 {
-  vector<double> V(nFields);
-
   if (params->equation == ADVECTION_DIFFUSION) {
     V[0] = U_mpts[mpt][0];
   }
@@ -1604,8 +1823,6 @@ vector<double> ele::getPrimitivesMpt(uint mpt)
     }
     V[nDims+1] = (params->gamma-1)*(U_mpts(mpt,nDims+1) - 0.5*V[0]*vMagSq);
   }
-
-  return V;
 }
 
 void ele::getPrimitivesPlot(matrix<double> &V)
@@ -1998,8 +2215,9 @@ void ele::checkEntropy()
   /* --- Next, check for entropy loss and correct if needed --- */
 
   double minTau = 1e15; // Entropy-bounding value
+  double phi[5];
   for (int spt=0; spt<nSpts; spt++) {
-    auto phi = getPrimitives(spt);
+    getPrimitives(spt,phi);
     double rho = phi[0];
     double p = phi[nDims+1];
 
@@ -2008,7 +2226,7 @@ void ele::checkEntropy()
   }
 
   for (int fpt=0; fpt<nFpts; fpt++) {
-    auto phi = getPrimitivesFpt(fpt);
+    getPrimitivesFpt(fpt,phi);
     double rho = phi[0];
     double p = phi[nDims+1];
 
@@ -2089,8 +2307,9 @@ void ele::checkEntropyPlot()
   /* --- Next, check for entropy loss and correct if needed --- */
 
   double minTau = 1e15; // Entropy-bounding value
+  double phi[5];
   for (int spt=0; spt<nSpts; spt++) {
-    auto phi = getPrimitives(spt);
+    getPrimitives(spt,phi);
     double rho = phi[0];
     double p = phi[nDims+1];
 
@@ -2099,7 +2318,7 @@ void ele::checkEntropyPlot()
   }
 
   for (int fpt=0; fpt<nFpts; fpt++) {
-    auto phi = getPrimitivesFpt(fpt);
+    getPrimitivesFpt(fpt,phi);
     double rho = phi[0];
     double p = phi[nDims+1];
 
@@ -2108,7 +2327,7 @@ void ele::checkEntropyPlot()
   }
 
   for (int mpt=0; mpt<nMpts; mpt++) {
-    auto phi = getPrimitivesMpt(mpt);
+    getPrimitivesMpt(mpt,phi);
     double rho = phi[0];
     double p = phi[nDims+1];
 
@@ -2376,48 +2595,8 @@ void ele::restart(ifstream &file, input* _params, geo* _Geo)
     U_spts.setup(nSpts,nFields);
 
     /* Setup inter-order interpolation operator */
-
-    if (nDims == 2)
-      nSpts_final = (params->order+1)*(params->order+1);
-    else
-      nSpts_final = (params->order+1)*(params->order+1)*(params->order+1);
-
-    opp_interp.setup(nSpts_final, nSpts);
-
-    auto loc_spts_r = getPts1D(sptsType,order);
-    auto loc_spts_f = getPts1D(sptsType,params->order);
-
-    point loc;
-    if (nDims == 2) {
-      for (uint spt = 0; spt < nSpts_final; spt++) {
-        loc.x = loc_spts_f[spt%(params->order+1)];
-        loc.y = loc_spts_f[floor(spt/(params->order+1))];
-        for (uint rspt = 0; rspt < nSpts; rspt++) {
-          uint ispt = rspt % (order+1);
-          uint jspt = floor(rspt/(order+1));
-          opp_interp(spt, rspt) = Lagrange(loc_spts_r,loc.x,ispt) * Lagrange(loc_spts_r,loc.y,jspt);
-        }
-      }
-    }
-    else {
-      for (uint rspt = 0; rspt < nSpts; rspt++) {
-        uint ksptr = rspt / ((order+1)*(order+1));
-        uint jsptr = (rspt-(order+1)*(order+1)*ksptr)/(order+1);
-        uint isptr = rspt - (order+1)*jsptr - (order+1)*(order+1)*ksptr;
-        for (uint fspt = 0; fspt < nSpts_final; fspt++) {
-          uint ksptf = fspt / ((params->order+1)*(params->order+1));
-          uint jsptf = (fspt-(params->order+1)*(params->order+1)*ksptf)/(params->order+1);
-          uint isptf = fspt - (params->order+1)*jsptf - (params->order+1)*(params->order+1)*ksptf;
-          loc.x = loc_spts_f[isptf];
-          loc.y = loc_spts_f[jsptf];
-          loc.z = loc_spts_f[ksptf];
-
-          opp_interp(fspt, rspt) = Lagrange(loc_spts_r,loc.x,isptr) * Lagrange(loc_spts_r,loc.y,jsptr) * Lagrange(loc_spts_r,loc.z,ksptr);
-        }
-      }
-    }
-    //cout << "ele order = " << order << ", input order = " << params->order << endl;
-    //FatalError("Cannot restart a simulation using a different polynomial order.");
+    opp_interp = getOrderInterp(order,params->order);
+    nSpts_final = opp_interp.getDim0();
   }
 
   if (eType == QUAD || eType == HEX)
@@ -2741,12 +2920,71 @@ void ele::restart(ifstream &file, input* _params, geo* _Geo)
   }
 }
 
-vector<double> ele::getNormResidual(int normType)
+void ele::restart(const double *U_r, int rOrder)
 {
-  vector<double> res(nFields,0);
+  if (rOrder == order) {
+    for (int spt=0; spt<nSpts; spt++)
+      for (int k=0; k<nFields; k++)
+        U_spts(spt,k) = U_r[spt*nFields+k];
+    return;
+  }
+
+  auto opp_interp = getOrderInterp(rOrder,order);
+  int nSpts_r = opp_interp.getDim1();
+
+  for (int spt=0; spt<nSpts; spt++) {
+    for (int k=0; k<nFields; k++) {
+      double val = 0;
+      for (int rspt=0; rspt<nSpts_r; rspt++)
+        val += opp_interp(spt,rspt) * U_r[rspt*nFields+k];
+      U_spts(spt,k) = val;
+    }
+  }
+}
+
+matrix<double> ele::getOrderInterp(int fromOrder, int toOrder)
+{
+  uint nPts1D_f = fromOrder+1;
+  uint nPts1D_t = toOrder+1;
+  uint nPts_f = (nDims == 2) ? nPts1D_f*nPts1D_f : nPts1D_f*nPts1D_f*nPts1D_f;
+  uint nPts_t = (nDims == 2) ? nPts1D_t*nPts1D_t : nPts1D_t*nPts1D_t*nPts1D_t;
+
+  auto loc_spts_t = getPts1D(sptsType,toOrder);
+
+  // 1D basis of the 'from' points, tabulated at each of the 'to' points
+  lagrangeBasis1D basis;
+  basis.setup(getPts1D(sptsType,fromOrder));
+  matrix<double> lag(nPts1D_t, nPts1D_f);
+  for (uint it = 0; it < nPts1D_t; it++)
+    basis.eval(loc_spts_t[it], lag[it]);
+
+  matrix<double> opp_interp(nPts_t, nPts_f);
+
+  for (uint tspt = 0; tspt < nPts_t; tspt++) {
+    uint it = tspt % nPts1D_t;
+    uint jt = (tspt / nPts1D_t) % nPts1D_t;
+    uint kt = tspt / (nPts1D_t*nPts1D_t);
+    for (uint fspt = 0; fspt < nPts_f; fspt++) {
+      uint i = fspt % nPts1D_f;
+      uint j = (fspt / nPts1D_f) % nPts1D_f;
+      uint k = fspt / (nPts1D_f*nPts1D_f);
+      double val = lag(it,i) * lag(jt,j);
+      if (nDims == 3)
+        val *= lag(kt,k);
+      opp_interp(tspt, fspt) = val;
+    }
+  }
+
+  return opp_interp;
+}
+
+void ele::getNormResidual(int normType, double* res)
+{
+  for (int i=0; i<nFields; i++)
+    res[i] = 0;
 
   // Integrating residual over element using Gaussian integration
-  auto weights = getQptWeights(order,nDims);
+  auto &weights = shapes->wts_spts;
 
   for (int spt=0; spt<nSpts; spt++) {
     for (int i=0; i<nFields; i++) {
@@ -2762,8 +3000,6 @@ vector<double> ele::getNormResidual(int normType)
       }
     }
   }
-
-  return res;
 }
 
 point ele::getPosSpt(uint spt)
@@ -2844,3 +3080,21 @@ void ele::setUSpts(double* Uvec)
       U_spts(spt,field) = Uvec[spt*nFields+field];
 }
 
+
+void ele::addMemUsage(memTally &mem)
+{
+  mem.add("ele: solution", memBytes(U_spts, U_fpts, U_mpts, U0, Uc_fpts, dUc_fpts, Uavg,
+                                    corr_spts, src_spts, sol_spts, S_spts, S_fpts, S_mpts));
+
+  mem.add("ele: flux", memBytes(F_spts, F_fpts, disFn_fpts, Fn_fpts, dFn_fpts, waveSp_fpts,
+                                dF_spts, divF_spts, tdF_spts, tempF, tempU));
+
+  mem.add("ele: gradients", memBytes(dU_spts, dU_fpts));
+
+  // Includes the element object itself
+  mem.add("ele: geometry & transforms", sizeof(ele)
+          + memBytes(detJac_spts, detJac_fpts, Jac_spts, JGinv_spts, gridVel_spts, gridVel_fpts,
+                     gridVel_nodes, gridVel_mpts, nodesRK, Jac0_spts, JGinv0_spts, norm0_fpts)
+          + memBytes(pos0_spts, pos0_fpts, pos_spts, pos_fpts, pos_ppts, norm_fpts, tNorm_fpts,
+                     dA_fpts, lift_fpts, loc_spts, loc_fpts, nodes, nodeID, faceID, bndFace));
+}
@@ -0,0 +1,145 @@
+/*!
+ * \file eleBlock.cpp
+ * \brief eleBlock class definition
+ *
+ * Contiguous storage of the solution arrays for all elements of one
+ * element type & polynomial order
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "eleBlock.hpp"
+
+void eleBlock::setup(input *inParams, int _eType, int _order, int _nEles)
+{
+  params = inParams;
+  eType = _eType;
+  order = _order;
+  nEles = _nEles;
+
+  nDims = params->nDims;
+  nFields = params->nFields;
+
+  if (eType == QUAD || eType == HEX) {
+    nSpts = pow(order+1,nDims);
+    nFpts = pow(order+1,nDims-1) * 2*nDims;
+  }
+  else {
+    FatalError("Only quads and hexes implemented.");
+  }
+
+  nCols = nEles*nFields;
+  storage.clear();
+
+  allocate(U_spts,nSpts);
+  allocate(U_fpts,nFpts);
+  allocate(disFn_fpts,nFpts);
+  allocate(dFn_fpts,nFpts);
+  allocate(Fn_fpts,nFpts);
+
+  divF_spts.resize(params->nRKRegs);
+  for (auto& dF:divF_spts) allocate(dF,nSpts);
+
+  if (params->nRKSteps>1)
+    allocate(U0,nSpts);
+
+  F_spts.resize(nDims);
+  F_fpts.resize(nDims);
+  for (auto& F:F_spts) allocate(F,nSpts);
+  for (auto& F:F_fpts) allocate(F,nFpts);
+
+  if (params->motion || params->viscous) {
+    dU_spts.resize(nDims);
+    dU_fpts.resize(nDims);
+    for (int dim=0; dim<nDims; dim++) {
+      allocate(dU_spts[dim],nSpts);
+      allocate(dU_fpts[dim],nFpts);
+    }
+  }
+
+  if (params->viscous) {
+    allocate(Uc_fpts,nFpts);
+    allocate(dUc_fpts,nFpts);
+  }
+
+  if (params->PMG) {
+    allocate(sol_spts,nSpts);
+    allocate(corr_spts,nSpts);
+    allocate(src_spts,nSpts);
+  }
+}
+
+void eleBlock::getView(matrix<double> &block, int ic, matrix<double> &view)
+{
+  if (ic < 0 || ic >= nEles)
+    FatalError("Element index out of range for eleBlock.");
+
+  view.setupView(&block(0,ic*nFields), block.getDim0(), nFields, block.getDim1());
+}
+
+void eleBlock::addMemUsage(memTally &mem)
+{
+  // The block arrays are all views of 'storage'
+  auto bytes = [&](const matrix<double> &mat) { return sizeof(double)*mat.getDim0()*mat.getDim1(); };
+  auto bytesV = [&](const vector<matrix<double>> &mats) {
+    size_t tot = 0;
+    for (auto &mat:mats) tot += bytes(mat);
+    return tot;
+  };
+
+  mem.add("ele: solution", bytes(U_spts) + bytes(U_fpts) + bytes(U0) + bytes(Uc_fpts) + bytes(dUc_fpts)
+          + bytes(sol_spts) + bytes(corr_spts) + bytes(src_spts));
+  mem.add("ele: flux", bytesV(F_spts) + bytesV(F_fpts) + bytes(disFn_fpts) + bytes(Fn_fpts)
+          + bytes(dFn_fpts) + bytesV(divF_spts));
+  mem.add("ele: gradients", bytesV(dU_spts) + bytesV(dU_fpts));
+}
+
+void eleBlock::allocate(matrix<double> &mat, int nRows)
+{
+  /* Leave the memory untouched on allocation, so that each page is first
+   * touched [and therefore placed on the NUMA node of] the thread which will
+   * later work on it */
+  double *ptr = new double[(size_t)nRows*nCols];
+  storage.emplace_back(ptr);
+
+  // Same column split among threads as the batched operators [see matMult]
+#pragma omp parallel
+  {
+#ifdef _OPENMP
+    int nThreads = omp_get_num_threads();
+    int thread = omp_get_thread_num();
+#else
+    int nThreads = 1;
+    int thread = 0;
+#endif
+    int k0 = ((size_t)nCols*thread) / nThreads;
+    int k1 = ((size_t)nCols*(thread+1)) / nThreads;
+
+    for (int i=0; i<nRows; i++)
+      for (int k=k0; k<k1; k++)
+        ptr[(size_t)i*nCols+k] = 0.;
+  }
+
+  mat.setupView(ptr,nRows,nCols,nCols);
+}
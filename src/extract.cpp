@@ -0,0 +1,436 @@
+/*!
+ * \file extract.cpp
+ * \brief Class for in-situ extraction of probe, slice & surface data
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "extract.hpp"
+
+#include <cstring>
+#include <iomanip>
+
+#ifndef _NO_MPI
+#include <mpi.h>
+#endif
+
+void extractor::setup(input *params, solver *Solver)
+{
+  this->params = params;
+  this->Solver = Solver;
+
+  nVars = params->nFields;
+
+  /* --- Point probes --- */
+  if (params->probeFreq > 0) {
+    if (params->probePts.size() % 3 != 0)
+      FatalError("probePts: expecting 3 coordinates [x y z] per probe.");
+
+    int nProbes = params->probePts.size() / 3;
+    for (int i=0; i<nProbes; i++)
+      probes.pts.push_back(point(&params->probePts[3*i]));
+
+    probes.fileName = params->dataFileName + "_probes.dat";
+    locatePoints(probes);
+  }
+
+  /* --- Cutting planes: a regular n1 x n2 grid of points spanned by two axes --- */
+  if (params->sliceFreq > 0) {
+    if (params->slices.size() % 11 != 0)
+      FatalError("slices: expecting 11 values [x0 y0 z0  ax ay az  bx by bz  n1 n2] per slice.");
+
+    int nSlices = params->slices.size() / 11;
+    slices.resize(nSlices);
+    for (int s=0; s<nSlices; s++) {
+      double *def = &params->slices[11*s];
+      point x0 = point(def);
+      Vec3 a = Vec3(def+3);
+      Vec3 b = Vec3(def+6);
+      int n1 = max((int)def[9],1);
+      int n2 = max((int)def[10],1);
+
+      for (int j=0; j<n2; j++) {
+        for (int i=0; i<n1; i++) {
+          double s1 = (n1 > 1) ? (double)i/(n1-1) : 0.;
+          double s2 = (n2 > 1) ? (double)j/(n2-1) : 0.;
+          point pt = x0;
+          for (int dim=0; dim<3; dim++)
+            pt[dim] += s1*a[dim] + s2*b[dim];
+          slices[s].pts.push_back(pt);
+        }
+      }
+
+      slices[s].fileName = params->dataFileName + "_slice" + to_string(s) + ".bin";
+      locatePoints(slices[s]);
+    }
+  }
+
+  surfFileName = params->dataFileName + "_surface.bin";
+
+  /* --- Start new files, unless continuing a restarted run --- */
+  if (params->rank == 0 && !params->restart) {
+    ofstream file;
+    if (params->probeFreq > 0) {
+      file.open(probes.fileName.c_str());  file.close();
+    }
+    for (auto &S:slices) {
+      file.open(S.fileName.c_str());  file.close();
+    }
+    if (params->surfaceFreq > 0) {
+      file.open(surfFileName.c_str());  file.close();
+    }
+  }
+}
+
+void extractor::sample(void)
+{
+  int iter = params->iter;
+
+  bool due = (params->probeFreq > 0 && iter%params->probeFreq == 0)
+          || (params->sliceFreq > 0 && iter%params->sliceFreq == 0)
+          || (params->surfaceFreq > 0 && iter%params->surfaceFreq == 0);
+
+  if (!due) return;
+
+  Solver->syncHost();
+
+  if (params->probeFreq > 0 && iter%params->probeFreq == 0)
+    writeProbes();
+
+  if (params->sliceFreq > 0 && iter%params->sliceFreq == 0)
+    writeSlices();
+
+  if (params->surfaceFreq > 0 && iter%params->surfaceFreq == 0)
+    writeSurface();
+}
+
+void extractor::relocate(void)
+{
+  if (params->probeFreq > 0)
+    locatePoints(probes);
+
+  for (auto &S:slices)
+    locatePoints(S);
+}
+
+void extractor::locatePoints(samplePts &S)
+{
+  int nPts = S.pts.size();
+  S.eleID.assign(nPts,-1);
+
+  if (params->nDims == 2)
+    for (auto &pt:S.pts) pt.z = 0.;
+
+  S.refLoc.assign(nPts,point());
+
+  // Test each element against all of the points not yet found
+  vector<int> pending(nPts);
+  for (int i=0; i<nPts; i++) pending[i] = i;
+  vector<point> pendingPts = S.pts;
+  vector<point> locs(nPts);
+  vector<char> isIn(nPts);
+  refLocStats stats;
+
+  for (uint ic=0; ic<Solver->eles.size() && !pending.empty(); ic++) {
+    auto &e = Solver->eles[ic];
+    if (params->meshType == OVERSET_MESH && Solver->Geo->iblankCell[e->ID] != NORMAL) continue;
+
+    int nPending = pending.size();
+    if (e->getRefLocNewton(pendingPts.data(),nPending,locs.data(),isIn.data(),&stats) == 0) continue;
+
+    int n = 0;
+    for (int i=0; i<nPending; i++) {
+      if (isIn[i]) {
+        S.eleID[pending[i]] = ic;
+        S.refLoc[pending[i]] = locs[i];
+      }
+      else {
+        pending[n] = pending[i];
+        pendingPts[n] = pendingPts[i];
+        n++;
+      }
+    }
+    pending.resize(n);
+    pendingPts.resize(n);
+  }
+
+  // Points on a partition boundary may be found by more than one rank;
+  // keep the lowest such rank as the point's owner
+  int nMissing = 0;
+#ifndef _NO_MPI
+  vector<int> owner(nPts), minOwner(nPts);
+  for (int i=0; i<nPts; i++)
+    owner[i] = (S.eleID[i] >= 0) ? params->rank : params->nproc;
+
+  MPI_Allreduce(owner.data(), minOwner.data(), nPts, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+
+  int nLocal[2] = {stats.nNewton, stats.nIters};
+  int nGlobal[2];
+  MPI_Allreduce(nLocal, nGlobal, 2, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  stats.nNewton = nGlobal[0];
+  stats.nIters = nGlobal[1];
+
+  for (int i=0; i<nPts; i++) {
+    if (minOwner[i] != params->rank) S.eleID[i] = -1;
+    if (minOwner[i] == params->nproc) nMissing++;
+  }
+#else
+  for (int i=0; i<nPts; i++)
+    if (S.eleID[i] < 0) nMissing++;
+#endif
+
+  if (params->rank == 0 && params->iter == params->initIter) {
+    cout << "Located " << nPts-nMissing << " of " << nPts << " sample points for " << S.fileName
+         << ": " << stats.nNewton << " Newton solves, " << (double)stats.nIters/max(stats.nNewton,1)
+         << " iterations per solve" << endl;
+    if (nMissing > 0)
+      cout << "WARNING: " << nMissing << " sample points for " << S.fileName << " are outside of the domain; writing zeros." << endl;
+  }
+}
+
+void extractor::getPrimitives(double *U)
+{
+  if (params->equation != NAVIER_STOKES) return;
+
+  int nDims = params->nDims;
+
+  double vMagSq = 0;
+  for (int dim=0; dim<nDims; dim++) {
+    U[dim+1] /= U[0];
+    vMagSq += U[dim+1]*U[dim+1];
+  }
+  U[nDims+1] = (params->gamma-1)*(U[nDims+1] - 0.5*U[0]*vMagSq);
+}
+
+void extractor::interpPoints(samplePts &S, vector<double> &V)
+{
+  // Points stay fixed in space while the elements move through them
+  if (params->motion)
+    locatePoints(S);
+
+  int nPts = S.pts.size();
+  V.assign(nPts*nVars,0.);
+
+  for (int i=0; i<nPts; i++) {
+    if (S.eleID[i] < 0) continue;
+
+    auto &e = Solver->eles[S.eleID[i]];
+    Solver->opers[e->eType][e->order].interpolateToPoint(e->U_spts, &V[i*nVars], S.refLoc[i]);
+    getPrimitives(&V[i*nVars]);
+  }
+
+#ifndef _NO_MPI
+  // Each point has exactly one owner, so a sum gathers all values to rank 0
+  if (params->rank == 0)
+    MPI_Reduce(MPI_IN_PLACE, V.data(), nPts*nVars, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+  else
+    MPI_Reduce(V.data(), NULL, nPts*nVars, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+#endif
+}
+
+void extractor::getSurfaceData(vector<double> &xyz, vector<double> &V)
+{
+  // The flux-point solution is left over from the last RK stage; update it
+  Solver->extrapolateU();
+
+  xyz.clear();
+  V.clear();
+
+  for (auto &f:Solver->faces) {
+    if (!f->myInfo.isBnd) continue;
+
+    int bcType = f->myInfo.bcType;
+    if (bcType != SLIP_WALL && bcType != ADIABATIC_NOSLIP && bcType != ISOTHERMAL_NOSLIP) continue;
+
+    ele *e = f->getLeftEle();
+    if (params->motion)
+      e->updatePosFpts();
+
+    for (int fpt=f->fptStartL; fpt<f->fptEndL; fpt++) {
+      for (int dim=0; dim<3; dim++)
+        xyz.push_back(e->pos_fpts[fpt][dim]);
+
+      int start = V.size();
+      for (int k=0; k<nVars; k++)
+        V.push_back(e->U_fpts(fpt,k));
+      getPrimitives(&V[start]);
+    }
+  }
+
+#ifndef _NO_MPI
+  int nPts = xyz.size()/3;
+  vector<int> nPts_rank(params->nproc);
+  MPI_Gather(&nPts, 1, MPI_INT, nPts_rank.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+  vector<int> cntX(params->nproc), dispX(params->nproc);
+  vector<int> cntV(params->nproc), dispV(params->nproc);
+  int nPtsTot = 0;
+  for (int p=0; p<params->nproc; p++) {
+    cntX[p] = 3*nPts_rank[p];      dispX[p] = 3*nPtsTot;
+    cntV[p] = nVars*nPts_rank[p];  dispV[p] = nVars*nPtsTot;
+    nPtsTot += nPts_rank[p];
+  }
+
+  vector<double> xyz_all, V_all;
+  if (params->rank == 0) {
+    xyz_all.resize(3*nPtsTot);
+    V_all.resize(nVars*nPtsTot);
+  }
+
+  MPI_Gatherv(xyz.data(), xyz.size(), MPI_DOUBLE, xyz_all.data(), cntX.data(), dispX.data(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  MPI_Gatherv(V.data(), V.size(), MPI_DOUBLE, V_all.data(), cntV.data(), dispV.data(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+  xyz.swap(xyz_all);
+  V.swap(V_all);
+#endif
+}
+
+bool extractor::openSeries(ofstream &file, const string &fileName, bool binary)
+{
+  ifstream test(fileName.c_str());
+  bool isNew = (!test.good() || test.peek() == EOF);
+  test.close();
+
+  auto mode = ofstream::out | ofstream::app;
+  if (binary) mode |= ofstream::binary;
+  file.open(fileName.c_str(), mode);
+
+  if (!file.is_open())
+    FatalError("Unable to open extraction output file.");
+
+  return isNew;
+}
+
+/*! Write a binary time-series header [and the fixed point coordinates] */
+static void writeSeriesHeader(ofstream &file, input *params, int nVars, const vector<double> &xyz, bool movingPts)
+{
+  seriesHeader header;
+  memcpy(header.magic, "FLURRYTS", 8);
+  header.version = 1;
+  header.nDims = params->nDims;
+  header.nVars = nVars;
+  header.nPts = xyz.size()/3;
+  header.movingPts = movingPts;
+
+  file.write((char*)&header, sizeof(seriesHeader));
+  if (!movingPts)
+    file.write((char*)xyz.data(), xyz.size()*sizeof(double));
+}
+
+/*! Append one sample to a binary time-series file */
+static void writeSeriesRecord(ofstream &file, input *params, const vector<double> &xyz, const vector<double> &V, bool movingPts)
+{
+  int nPts = xyz.size()/3;
+  file.write((char*)&params->iter, sizeof(int));
+  file.write((char*)&params->time, sizeof(double));
+  file.write((char*)&nPts, sizeof(int));
+  if (movingPts)
+    file.write((char*)xyz.data(), xyz.size()*sizeof(double));
+  file.write((char*)V.data(), V.size()*sizeof(double));
+}
+
+void extractor::writeProbes(void)
+{
+  vector<double> V;
+  interpPoints(probes, V);
+
+  if (params->rank != 0) return;
+
+  ofstream file;
+  bool isNew = openSeries(file, probes.fileName, false);
+
+  int colW = 16;
+  file.precision(8);
+  file.setf(ios::scientific, ios::floatfield);
+
+  if (isNew) {
+    vector<string> vars;
+    if (params->equation == NAVIER_STOKES) {
+      vars = {"rho","u","v"};
+      if (params->nDims == 3) vars.push_back("w");
+      vars.push_back("p");
+    }
+    else {
+      vars = {"u"};
+    }
+
+    for (uint i=0; i<probes.pts.size(); i++)
+      file << "# Probe " << i << ": " << probes.pts[i].x << " " << probes.pts[i].y << " " << probes.pts[i].z << endl;
+
+    file << setw(8) << left << "Iter";
+    file << setw(colW) << left << "Time";
+    for (uint i=0; i<probes.pts.size(); i++)
+      for (auto &var:vars)
+        file << setw(colW) << left << var + "_" + to_string(i);
+    file << endl;
+  }
+
+  file << setw(8) << left << params->iter;
+  file << setw(colW) << left << params->time;
+  for (auto &val:V)
+    file << setw(colW) << left << val;
+  file << endl;
+
+  file.close();
+}
+
+void extractor::writeSlices(void)
+{
+  for (auto &S:slices) {
+    vector<double> V;
+    interpPoints(S, V);
+
+    if (params->rank != 0) continue;
+
+    vector<double> xyz;
+    for (auto &pt:S.pts)
+      for (int dim=0; dim<3; dim++)
+        xyz.push_back(pt[dim]);
+
+    ofstream file;
+    if (openSeries(file, S.fileName, true))
+      writeSeriesHeader(file, params, nVars, xyz, false);
+
+    writeSeriesRecord(file, params, xyz, V, false);
+    file.close();
+  }
+}
+
+void extractor::writeSurface(void)
+{
+  vector<double> xyz, V;
+  getSurfaceData(xyz, V);
+
+  if (params->rank != 0) return;
+
+  // The set of wall points changes with overset blanking
+  bool movingPts = (params->motion || params->meshType == OVERSET_MESH);
+
+  ofstream file;
+  if (openSeries(file, surfFileName, true))
+    writeSeriesHeader(file, params, nVars, xyz, movingPts);
+
+  writeSeriesRecord(file, params, xyz, V, movingPts);
+  file.close();
+}
@@ -32,6 +32,8 @@
 
 #include "../include/flux.hpp"
 #include "../include/ele.hpp"
+#include "../include/points.hpp"
+#include "../include/polynomials.hpp"
 
 void face::initialize(shared_ptr<ele> &eL, shared_ptr<ele> &eR, int gID, int locF_L, faceInfo myInfo, input *params)
 {
@@ -58,6 +60,13 @@ void face::initialize(shared_ptr<ele> &eL, shared_ptr<ele> &eR, int gID, int loc
 
 void face::setupFace(void)
 {
+  /* Mixed orders: the common flux is computed at the flux points of the
+   * higher-order element, so it is made the left element */
+  if (eR != nullptr && eR->order > eL->order) {
+    swap(eL,eR);
+    swap(locF_L,myInfo.IDR);
+  }
+
   if (nDims == 2)
     nFptsL = eL->order+1;
   else
@@ -86,6 +95,11 @@ void face::setupFace(void)
     gradUR.resize(nFptsL);
     for (auto &dU:gradUL) dU.setup(nDims,nFields);
     for (auto &dU:gradUR) dU.setup(nDims,nFields);
+
+    if (params->viscScheme == 1) {
+      liftL.resize(nFptsL);
+      liftR.resize(nFptsL);
+    }
   }
 
   if (params->motion) {
@@ -94,11 +108,78 @@ void face::setupFace(void)
 
   getPointers();
 
+  // Initial geometry [faces may also be re-built mid-run: load rebalancing, p-adaptation]
+  for (int fpt=0; fpt<nFptsL; fpt++) {
+    for (int dim=0; dim<nDims; dim++)
+      normL(fpt,dim) = eL->norm_fpts(fptStartL+fpt,dim);
+    dAL[fpt] = eL->dA_fpts[fptStartL+fpt];
+    detJacL[fpt] = eL->detJac_fpts[fptStartL+fpt];
+  }
+
   this->setupRightState();
 
   this->getPointersRight();
 }
 
+void face::setupMortar(int orderR)
+{
+  int orderL = eL->order;
+  int nL = orderL+1;
+  int nR = orderR+1;
+
+  auto ptsL = getPts1D(eL->sptsType,orderL);
+  auto ptsR = getPts1D(eL->sptsType,orderR);
+
+  /* --- 1D interpolation: evaluate the right element's trace at the left points --- */
+  matrix<double> interp1D(nL,nR);
+  for (int i=0; i<nL; i++)
+    for (int k=0; k<nR; k++)
+      interp1D(i,k) = Lagrange(ptsR,ptsL[i],k);
+
+  /* --- 1D L2 projection of the left polynomial onto the right polynomial space:
+   * M_R^-1 * B, with M_R & B integrated exactly by Gauss quadrature --- */
+  int qOrder = max(orderL,orderR);
+  auto qpts = getPts1D("Legendre",qOrder);
+  auto qwts = getQptWeights1D(qOrder);
+
+  matrix<double> massR(nR,nR), B(nR,nL);
+  massR.initializeToZero();
+  B.initializeToZero();
+  for (int q=0; q<=qOrder; q++) {
+    for (int k=0; k<nR; k++) {
+      double lk = Lagrange(ptsR,qpts[q],k);
+      for (int m=0; m<nR; m++)
+        massR(k,m) += qwts[q] * lk * Lagrange(ptsR,qpts[q],m);
+      for (int i=0; i<nL; i++)
+        B(k,i) += qwts[q] * lk * Lagrange(ptsL,qpts[q],i);
+    }
+  }
+
+  matrix<double> proj1D(nR,nL);
+  auto massInv = massR.invertMatrix();
+  massInv.timesMatrix(B,proj1D);
+
+  /* --- Tensor products for the quad faces of hexes --- */
+  if (nDims == 2) {
+    interpR = interp1D;
+    projR = proj1D;
+  }
+  else {
+    interpR.setup(nL*nL,nR*nR);
+    projR.setup(nR*nR,nL*nL);
+    for (int j=0; j<nL; j++) {
+      for (int i=0; i<nL; i++) {
+        for (int m=0; m<nR; m++) {
+          for (int k=0; k<nR; k++) {
+            interpR(i+j*nL,k+m*nR) = interp1D(i,k)*interp1D(j,m);
+            projR(k+m*nR,i+j*nL) = proj1D(k,i)*proj1D(m,j);
+          }
+        }
+      }
+    }
+  }
+}
+
 void face::getPointers(void)
 {
   // Get access to data at left element
@@ -133,6 +214,9 @@ void face::getLeftState()
       detJacL[fpt] = (eL->detJac_fpts[i]);
     }
 
+    if (params->viscScheme == 1)
+      liftL[fpt] = params->br2Eta * eL->lift_fpts[i] * dAL[fpt] / detJacL[fpt];
+
     if (params->motion) {
       for (int dim=0; dim<nDims; dim++)
         Vg(fpt,dim) = eL->gridVel_fpts(i,dim);
@@ -163,6 +247,13 @@ void face::calcInviscidFlux(void)
     getLeftState();
   this->getRightState(); // <-- makes this more general for all face types, and allows face memory to be contiguous
 
+  calcCommonInviscidFlux();
+
+  finishInviscidFlux();
+}
+
+void face::calcCommonInviscidFlux(void)
+{
   // Calculate common inviscid flux at flux points
   if (params->equation == ADVECTION_DIFFUSION) {
     laxFriedrichsFlux();
@@ -179,7 +270,10 @@ void face::calcInviscidFlux(void)
       }
     }
   }
+}
 
+void face::finishInviscidFlux(void)
+{
   // Transform normal flux using edge Jacobian and put into ele's memory
   for (int i=0; i<nFptsL; i++) {
     for (int j=0; j<nFields; j++)
@@ -210,12 +304,33 @@ void face::calcViscousFlux(void)
 {
   if (!isMPI)
     getLeftGradient();
+
+  // BR2: lift each side's [uncorrected] gradient by its jump to the common solution
+  if (params->viscScheme == 1)
+    liftGradient(gradUL,UL,liftL,1.);
+
   this->getRightGradient();
 
+  if (params->viscScheme == 1 && !isBnd)
+    liftGradient(gradUR,UR,liftR,-1.);
+
+  calcCommonViscousFlux();
+
+  // Transform normal flux using edge Jacobian and put into ele's memory
+  for (int i=0; i<nFptsL; i++) {
+    for (int j=0; j<nFields; j++)
+      FnL[i][j] =  Fn(i,j)*dAL[i];
+  }
+
+  this->setRightStateFlux();
+}
+
+void face::calcCommonViscousFlux(void)
+{
   if (params->equation == NAVIER_STOKES) {
     for (int fpt=0; fpt<nFptsL; fpt++) {
       // Calculte common viscous flux at flux points [LDG numerical flux]
-      matrix<double> Fc(nDims,nFields);
+      double Fc[3][5];
 
       if (isBnd) {
         if (isBnd > 1) {
@@ -224,7 +339,7 @@ void face::calcViscousFlux(void)
           viscousFlux(UR[fpt], gradUR[fpt], tempFR, params);
           for (int dim=0; dim<nDims; dim++) {
             for (int k=0; k<nFields; k++) {
-              Fc(dim,k) = tempFR(dim,k) + params->tau*normL(fpt,dim)*(UL(fpt,k) - UR(fpt,k));
+              Fc[dim][k] = tempFR(dim,k) + params->tau*normL(fpt,dim)*(UL(fpt,k) - UR(fpt,k));
             }
           }
         }
@@ -234,25 +349,24 @@ void face::calcViscousFlux(void)
           viscousFlux(UL[fpt], gradUL[fpt], tempFL, params);
           for (int dim=0; dim<nDims; dim++) {
             for (int k=0; k<nFields; k++) {
-              Fc(dim,k) = tempFL(dim,k) + params->tau*normL(fpt,dim)*(UL(fpt,k) - UR(fpt,k));
+              Fc[dim][k] = tempFL(dim,k) + params->tau*normL(fpt,dim)*(UL(fpt,k) - UR(fpt,k));
             }
           }
         }
       }
+      else if (params->viscScheme == 1) {
+        // BR2: central average of the fluxes from the lifted gradients
+        viscousFlux(UL[fpt], gradUL[fpt], tempFL, params);
+        viscousFlux(UR[fpt], gradUR[fpt], tempFR, params);
+        for (int dim=0; dim<nDims; dim++)
+          for (int k=0; k<nFields; k++)
+            Fc[dim][k] = 0.5*(tempFL(dim,k) + tempFR(dim,k));
+      }
       else {
         // All general interior-type faces (interior, MPI, overset)
         viscousFlux(UL[fpt], gradUL[fpt], tempFL, params);
         viscousFlux(UR[fpt], gradUR[fpt], tempFR, params);
-        double penFact = params->penFact;
-        if (nDims == 2) {
-          if ( normL(fpt,0)+normL(fpt,1) < 0 )
-            penFact = -params->penFact;
-        }
-        else if (nDims == 3) {
-          if (normL(fpt,0)+normL(fpt,1)+sqrt(2.)*normL(fpt,2) < 0) {
-            penFact = -params->penFact;
-          }
-        }
+        double penFact = ldgPenalty(fpt);
 
         double normX = normL(fpt,0);
         double normY = normL(fpt,1);
@@ -262,15 +376,15 @@ void face::calcViscousFlux(void)
 
         if (nDims == 2) {
           for(int k=0; k<nFields; k++) {
-            Fc(0,k) = 0.5*(tempFL(0,k) + tempFR(0,k)) + penFact*normX*( normX*(tempFL(0,k) - tempFR(0,k)) + normY*(tempFL(1,k) - tempFR(1,k)) ) + params->tau*normX*(UL(fpt,k) - UR(fpt,k));
-            Fc(1,k) = 0.5*(tempFL(1,k) + tempFR(1,k)) + penFact*normY*( normX*(tempFL(0,k) - tempFR(0,k)) + normY*(tempFL(1,k) - tempFR(1,k)) ) + params->tau*normY*(UL(fpt,k) - UR(fpt,k));
+            Fc[0][k] = 0.5*(tempFL(0,k) + tempFR(0,k)) + penFact*normX*( normX*(tempFL(0,k) - tempFR(0,k)) + normY*(tempFL(1,k) - tempFR(1,k)) ) + params->tau*normX*(UL(fpt,k) - UR(fpt,k));
+            Fc[1][k] = 0.5*(tempFL(1,k) + tempFR(1,k)) + penFact*normY*( normX*(tempFL(0,k) - tempFR(0,k)) + normY*(tempFL(1,k) - tempFR(1,k)) ) + params->tau*normY*(UL(fpt,k) - UR(fpt,k));
           }
         }
         else if (nDims == 3) {
           for(int k=0; k<nFields; k++) {
-            Fc(0,k) = 0.5*(tempFL(0,k) + tempFR(0,k)) + penFact*normX*( normX*(tempFL(0,k) - tempFR(0,k)) + normY*(tempFL(1,k) - tempFR(1,k)) + normZ*(tempFL(2,k) - tempFR(2,k)) ) + params->tau*normX*(UL(fpt,k) - UR(fpt,k));
-            Fc(1,k) = 0.5*(tempFL(0,k) + tempFR(0,k)) + penFact*normY*( normX*(tempFL(0,k) - tempFR(0,k)) + normY*(tempFL(1,k) - tempFR(1,k)) + normZ*(tempFL(2,k) - tempFR(2,k)) ) + params->tau*normY*(UL(fpt,k) - UR(fpt,k));
-            Fc(2,k) = 0.5*(tempFL(0,k) + tempFR(0,k)) + penFact*normZ*( normX*(tempFL(0,k) - tempFR(0,k)) + normY*(tempFL(1,k) - tempFR(1,k)) + normZ*(tempFL(2,k) - tempFR(2,k)) ) + params->tau*normZ*(UL(fpt,k) - UR(fpt,k));
+            Fc[0][k] = 0.5*(tempFL(0,k) + tempFR(0,k)) + penFact*normX*( normX*(tempFL(0,k) - tempFR(0,k)) + normY*(tempFL(1,k) - tempFR(1,k)) + normZ*(tempFL(2,k) - tempFR(2,k)) ) + params->tau*normX*(UL(fpt,k) - UR(fpt,k));
+            Fc[1][k] = 0.5*(tempFL(0,k) + tempFR(0,k)) + penFact*normY*( normX*(tempFL(0,k) - tempFR(0,k)) + normY*(tempFL(1,k) - tempFR(1,k)) + normZ*(tempFL(2,k) - tempFR(2,k)) ) + params->tau*normY*(UL(fpt,k) - UR(fpt,k));
+            Fc[2][k] = 0.5*(tempFL(0,k) + tempFR(0,k)) + penFact*normZ*( normX*(tempFL(0,k) - tempFR(0,k)) + normY*(tempFL(1,k) - tempFR(1,k)) + normZ*(tempFL(2,k) - tempFR(2,k)) ) + params->tau*normZ*(UL(fpt,k) - UR(fpt,k));
           }
         }
       }
@@ -278,7 +392,7 @@ void face::calcViscousFlux(void)
       // calculate normal flux from discontinuous solution at flux points
       for (int dim=0; dim<nDims; dim++)
         for(int k=0; k<nFields; k++)
-          Fn(fpt,k) += Fc(dim,k)*normL(fpt,dim);
+          Fn(fpt,k) += Fc[dim][k]*normL(fpt,dim);
     }
   }
   else if (params->equation == ADVECTION_DIFFUSION) {
@@ -292,307 +406,226 @@ void face::calcViscousFlux(void)
       Fn(fpt,0) += tempFn[0];
     }
   }
-
-  // Transform normal flux using edge Jacobian and put into ele's memory
-  for (int i=0; i<nFptsL; i++) {
-    for (int j=0; j<nFields; j++)
-      FnL[i][j] =  Fn(i,j)*dAL[i];
-  }
-
-  this->setRightStateFlux();
 }
 
 
 void face::rusanovFlux(void)
 {
-  for (int fpt=0; fpt<nFptsL; fpt++) {
-    inviscidFlux(UL[fpt],tempFL,params);
-    inviscidFlux(UR[fpt],tempFR,params);
-
-    double tempFnL[5] = {0,0,0,0,0};
-    double tempFnR[5] = {0,0,0,0,0};
-
-    // Get primitive variables
-    double rhoL = UL(fpt,0);     double rhoR = UR(fpt,0);
-    double uL = UL(fpt,1)/rhoL;  double uR = UR(fpt,1)/rhoR;
-    double vL = UL(fpt,2)/rhoL;  double vR = UR(fpt,2)/rhoR;
-
-    double wL, pL, vnL=0.;
-    double wR, pR, vnR=0.;
-    double vgn=0.;
-
-    // Calculate pressure
-    if (params->nDims==2) {
-      pL = (params->gamma-1.0)*(UL(fpt,3)-0.5*rhoL*(uL*uL+vL*vL));
-      pR = (params->gamma-1.0)*(UR(fpt,3)-0.5*rhoR*(uR*uR+vR*vR));
-    }
-    else {
-      wL = UL(fpt,3)/rhoL;   wR = UR(fpt,3)/rhoR;
-      pL = (params->gamma-1.0)*(UL(fpt,4)-0.5*rhoL*(uL*uL+vL*vL+wL*wL));
-      pR = (params->gamma-1.0)*(UR(fpt,4)-0.5*rhoR*(uR*uR+vR*vR+wR*wR));
-    }
-
-    // Get normal fluxes, normal velocities
-    for (int dim=0; dim<params->nDims; dim++) {
-      vnL += normL(fpt,dim)*UL(fpt,dim+1)/rhoL;
-      vnR += normL(fpt,dim)*UR(fpt,dim+1)/rhoR;
-      if (params->motion)
-        vgn += normL(fpt,dim)*Vg(fpt,dim);
-      for (int i=0; i<params->nFields; i++) {
-        tempFnL[i] += normL(fpt,dim)*tempFL(dim,i);
-        tempFnR[i] += normL(fpt,dim)*tempFR(dim,i);
-      }
-    }
-
-    // Get maximum eigenvalue for diffusion coefficient
-    double csqL = max(params->gamma*pL/rhoL,0.0);
-    double csqR = max(params->gamma*pR/rhoR,0.0);
-    double eigL = std::fabs(vnL) + sqrt(csqL);
-    double eigR = std::fabs(vnR) + sqrt(csqR);
-    double eig  = max(eigL,eigR);
-
-    // Calculate Rusanov flux
-    for (int i=0; i<params->nFields; i++) {
-      Fn(fpt,i) = 0.5*(tempFnL[i]+tempFnR[i] - eig*(UR(fpt,i)-UL(fpt,i)));
-    }
-
-    // Store wave speed for calculation of allowable dt
-    if (params->motion) {
-      eigL = std::fabs(vnL-vgn) + sqrt(csqL);
-      eigR = std::fabs(vnR-vgn) + sqrt(csqR);
-    }
-    *waveSp[fpt] = max(eigL,eigR);
-  }
+  const double* vg = (params->motion) ? Vg[0] : NULL;
+  ::rusanovFlux(nFptsL,UL[0],UR[0],normL[0],vg,Fn[0],waveSp[0],params);
 }
 
 void face::roeFlux(void)
 {
-  double gamma = params->gamma;
-  int nDims = params->nDims;
-
-  if (nDims == 3) FatalError("Roe not implemented in 3D");
+  ::roeFlux(nFptsL,UL[0],UR[0],normL[0],Fn[0],params);
+}
 
+void face::laxFriedrichsFlux(void)
+{
   for (int fpt=0; fpt<nFptsL; fpt++) {
-    array<double,3> vL, vR, um;
-    array<double,5> du;
-
-    // velocities
-    for (int i=0;i<nDims;i++)  {
-      vL[i] = UL(fpt,i+1)/UL(fpt,0);
-      vR[i] = UR(fpt,i+1)/UR(fpt,0);
-    }
+    if (params->equation == ADVECTION_DIFFUSION) {
+      double uAvg = 0.5*(UL(fpt,0) + UR(fpt,0));
+      double uDiff = UL(fpt,0) - UR(fpt,0);
+      double vNorm = params->advectVx*normL(fpt,0) + params->advectVy*normL(fpt,1);
+      if (nDims==3)
+        vNorm += params->advectVz*normL(fpt,2);
 
-    double pL, pR;
-    if (nDims == 2) {
-      pL = (gamma-1.0)*(UL(fpt,3) - (0.5*UL(fpt,0)*(vL[0]*vL[0]+vL[1]*vL[1])));
-      pR = (gamma-1.0)*(UR(fpt,3) - (0.5*UR(fpt,0)*(vR[0]*vR[0]+vR[1]*vR[1])));
+      Fn(fpt,0) = vNorm*uAvg + 0.5*params->lambda*abs(vNorm)*uDiff;
+      *waveSp[fpt] = vNorm;
     }
-    else {
-      pL = (gamma-1.0)*(UL(fpt,4) - (0.5*UL(fpt,0)*(vL[0]*vL[0]+vL[1]*vL[1]+vL[2]*vL[2])));
-      pR = (gamma-1.0)*(UR(fpt,4) - (0.5*UR(fpt,0)*(vR[0]*vR[0]+vR[1]*vR[1]+vR[2]*vR[2])));
+    else if (params->equation == NAVIER_STOKES) {
+      FatalError("Lax-Friedrichs not supported for Navier-Stokes simulations - use Rusanov or Roe.");
     }
+  }
+}
 
+void face::centralFluxBound(void)
+{
+  const double* vg = (params->motion) ? Vg[0] : NULL;
+  ::centralFluxBound(nFptsL,UL[0],UR[0],normL[0],vg,Fn[0],waveSp[0],params);
+}
 
-    double hL = (UL(fpt,nDims+1)+pL)/UL(fpt,0);
-    double hR = (UR(fpt,nDims+1)+pR)/UR(fpt,0);
+//! First step of the LDG flux - take a biased average of the solution
+void face::ldgSolution()
+{
+  if (isBnd || params->viscScheme == 1) {
+    for (int fpt=0; fpt<nFptsL; fpt++)
+      for(int k=0;k<nFields;k++)
+        UC(fpt,k) = 0.5*(UL(fpt,k) + UR(fpt,k));
+  }
+  else {
+    // Choosing a unique direction for the switch
+    for (int fpt=0; fpt<nFptsL; fpt++) {
 
-    double sq_rho = sqrt(UR(fpt,0)/UL(fpt,0));
-    double rrho = 1./(sq_rho+1.);
+      double penFact = ldgPenalty(fpt);
 
-    // Roe-averaged velocity
-    double usq = 0.;
-    double unm = 0.;
-    double vgn = 0.;
-    for (int i=0; i<nDims; i++) {
-      um[i] = rrho*(vL[i]+sq_rho*vR[i]);
-      usq += 0.5*um[i]*um[i];
-      unm += um[i]*normL(fpt,i);
+      for(int k=0;k<nFields;k++)
+        UC(fpt,k) = 0.5*(UL(fpt,k) + UR(fpt,k)) - penFact*(UL(fpt,k) - UR(fpt,k));
     }
+  }
+}
 
-    // Roe-averaged enthalpy
-    double hm = rrho*(hL + sq_rho*hR);
-
-    // Roe-avereged speed of sound
-    double am_sq = (gamma-1.)*(hm-usq);
-    double am = sqrt(am_sq);
-
-    // Compute Euler flux (first part)
-    double rhoUnL = 0.;
-    double rhoUnR = 0.;
-    for (int i=0;i<nDims;i++) {
-      rhoUnL += UL(fpt,i+1)*normL(fpt,i);
-      rhoUnR += UR(fpt,i+1)*normL(fpt,i);
+void face::liftGradient(vector<matrix<double>> &gradU, matrix<double> &U, vector<double> &lift, double sign)
+{
+  for (int fpt=0; fpt<nFptsL; fpt++) {
+    for (int dim=0; dim<nDims; dim++) {
+      double fac = sign*lift[fpt]*normL(fpt,dim);
+      for (int k=0; k<nFields; k++)
+        gradU[fpt](dim,k) += fac*(UC(fpt,k) - U(fpt,k));
     }
+  }
+}
 
-    Fn(fpt,0) = rhoUnL + rhoUnR;
-    Fn(fpt,1) = rhoUnL*vL[0] + rhoUnR*vR[0] + (pL+pR)*normL(fpt,0);
-    Fn(fpt,2) = rhoUnL*vL[1] + rhoUnR*vR[1] + (pL+pR)*normL(fpt,1);
-    Fn(fpt,3) = rhoUnL*hL   +rhoUnR*hR;
-
-    // Compute solution difference across face
-    for (int i=0;i<params->nFields;i++) {
-      du[i] = UR(fpt,i)-UL(fpt,i);
-    }
+double face::ldgPenalty(int fpt)
+{
+  // Choosing a unique direction for the switch
+  if (nDims == 2) {
+    if ( normL(fpt,0)+normL(fpt,1) < 0 )
+      return -params->penFact;
+  }
+  else if (nDims == 3) {
+    if (normL(fpt,0)+normL(fpt,1)+sqrt(2.)*normL(fpt,2) < 0)
+      return -params->penFact;
+  }
 
-    // Eigenvalues
-    double lambda0 = abs(unm-vgn);
-    double lambdaP = abs(unm-vgn+am);
-    double lambdaM = abs(unm-vgn-am);
-
-    // Entropy fix
-    double eps = 0.5*(abs(rhoUnL/UL(fpt,0)-rhoUnR/UR(fpt,0))+ abs(sqrt(gamma*pL/UL(fpt,0))-sqrt(gamma*pR/UR(fpt,0))));
-    if(lambda0 < 2.*eps)
-      lambda0 = 0.25*lambda0*lambda0/eps + eps;
-    if(lambdaP < 2.*eps)
-      lambdaP = 0.25*lambdaP*lambdaP/eps + eps;
-    if(lambdaM < 2.*eps)
-      lambdaM = 0.25*lambdaM*lambdaM/eps + eps;
-
-    double a2 = 0.5*(lambdaP+lambdaM)-lambda0;
-    double a3 = 0.5*(lambdaP-lambdaM)/am;
-    double a1 = a2*(gamma-1.)/am_sq;
-    double a4 = a3*(gamma-1.);
-
-    double a5, a6;
-    if (nDims==2) {
-      a5 = usq*du[0]-um[0]*du[1]-um[1]*du[2]+du[3];
-      a6 = unm*du[0]-normL(fpt,0)*du[1]-normL(fpt,1)*du[2];
-    }
-    else if (nDims==3) {
-      a5 = usq*du[0]-um[0]*du[1]-um[1]*du[2]-um[2]*du[3]+du[4];
-      a6 = unm*du[0]-normL(fpt,0)*du[1]-normL(fpt,1)*du[2]-normL(fpt,2)*du[3];
-    }
+  return params->penFact;
+}
 
-    double aL1 = a1*a5 - a3*a6;
-    double bL1 = a4*a5 - a2*a6;
+void face::setupFluxJacobian(void)
+{
+  if (dFndUL.getDim0() == (uint)nFptsL) return;
 
-    // Compute Euler flux (second part)
-    if (nDims==2) {
-      Fn(fpt,0) -= lambda0*du[0]+aL1;
-      Fn(fpt,1) -= lambda0*du[1]+aL1*um[0]+bL1*normL(fpt,0);
-      Fn(fpt,2) -= lambda0*du[2]+aL1*um[1]+bL1*normL(fpt,1);
-      Fn(fpt,3) -= lambda0*du[3]+aL1*hm   +bL1*unm;
-    }
-    else if (nDims==3) {
-      Fn(fpt,0) -= lambda0*du[0]+aL1;
-      Fn(fpt,1) -= lambda0*du[1]+aL1*um[0]+bL1*normL(fpt,0);
-      Fn(fpt,2) -= lambda0*du[2]+aL1*um[1]+bL1*normL(fpt,1);
-      Fn(fpt,3) -= lambda0*du[3]+aL1*um[2]+bL1*normL(fpt,2);
-      Fn(fpt,4) -= lambda0*du[4]+aL1*hm   +bL1*unm;
-    }
+  dFndUL.setup(nFptsL,nFields*nFields);
+  dFndUR.setup(nFptsL,nFields*nFields);
+  dFndUL.initializeToZero();
+  dFndUR.initializeToZero();
 
-    for (int i=0;i<params->nFields;i++) {
-      Fn(fpt,i) *= 0.5;
-    }
+  if (params->viscous) {
+    dFndQL.setup(nFptsL,nFields*nDims*nFields);
+    dFndQR.setup(nFptsL,nFields*nDims*nFields);
+    dUcdUL.setup(nFptsL,nFields*nFields);
+    dUcdUR.setup(nFptsL,nFields*nFields);
+    dFndQL.initializeToZero();
+    dFndQR.initializeToZero();
+    dUcdUL.initializeToZero();
+    dUcdUR.initializeToZero();
   }
 }
 
-void face::laxFriedrichsFlux(void)
+void face::calcFluxJacobian(void)
 {
+  setupFluxJacobian();
+
+  int nF2 = nFields*nFields;
+
+  /* --- Common inviscid flux --- */
   for (int fpt=0; fpt<nFptsL; fpt++) {
+    double *dL = dFndUL[fpt];
+    double *dR = dFndUR[fpt];
+
     if (params->equation == ADVECTION_DIFFUSION) {
-      double uAvg = 0.5*(UL(fpt,0) + UR(fpt,0));
-      double uDiff = UL(fpt,0) - UR(fpt,0);
       double vNorm = params->advectVx*normL(fpt,0) + params->advectVy*normL(fpt,1);
       if (nDims==3)
         vNorm += params->advectVz*normL(fpt,2);
 
-      Fn(fpt,0) = vNorm*uAvg + 0.5*params->lambda*abs(vNorm)*uDiff;
-      *waveSp[fpt] = vNorm;
+      dL[0] = 0.5*(vNorm + params->lambda*abs(vNorm));
+      dR[0] = 0.5*(vNorm - params->lambda*abs(vNorm));
     }
     else if (params->equation == NAVIER_STOKES) {
-      FatalError("Lax-Friedrichs not supported for Navier-Stokes simulations - use Rusanov or Roe.");
+      if (params->riemannType==0)
+        rusanovFluxJacobian(UL[fpt],UR[fpt],normL[fpt],dL,dR,params);
+      else if (params->riemannType==1)
+        roeFluxJacobian(UL[fpt],UR[fpt],normL[fpt],dL,dR,params);
     }
   }
-}
 
-void face::centralFluxBound(void)
-{
-  for (int fpt=0; fpt<nFptsL; fpt++) {
-    inviscidFlux(UL[fpt],tempFL,params);
-    inviscidFlux(UR[fpt],tempFR,params);
-
-    double tempFnL[5] = {0,0,0,0,0};
-    double tempFnR[5] = {0,0,0,0,0};
+  if (!params->viscous) return;
 
-    // Get primitive variables
-    double rhoL = UL(fpt,0);     double rhoR = UR(fpt,0);
-    double uL = UL(fpt,1)/rhoL;  double uR = UR(fpt,1)/rhoR;
-    double vL = UL(fpt,2)/rhoL;  double vR = UR(fpt,2)/rhoR;
+  /* --- Common viscous [LDG] flux --- */
+  int nDF = nDims*nFields;
+  vector<double> dFvdU_L(nDF*nFields), dFvdU_R(nDF*nFields);
+  vector<double> dFvdQ_L(nDF*nDF), dFvdQ_R(nDF*nDF);
 
-    double wL, pL, vnL=0.;
-    double wR, pR, vnR=0.;
-    double vgn=0.;
+  for (int fpt=0; fpt<nFptsL; fpt++) {
+    double penFact = ldgPenalty(fpt);
 
-    // Calculate pressure
-    if (params->nDims==2) {
-      pL = (params->gamma-1.0)*(UL(fpt,3)-rhoL*(uL*uL+vL*vL));
-      pR = (params->gamma-1.0)*(UR(fpt,3)-rhoR*(uR*uR+vR*vR));
+    for (int i=0; i<nF2; i++) {
+      dUcdUL(fpt,i) = 0;
+      dUcdUR(fpt,i) = 0;
     }
-    else {
-      wL = UL(fpt,3)/rhoL;   wR = UR(fpt,3)/rhoR;
-      pL = (params->gamma-1.0)*(UL(fpt,4)-rhoL*(uL*uL+vL*vL+wL*wL));
-      pR = (params->gamma-1.0)*(UR(fpt,4)-rhoR*(uR*uR+vR*vR+wR*wR));
+    for (int k=0; k<nFields; k++) {
+      dUcdUL(fpt,k*nFields+k) = 0.5 - penFact;
+      dUcdUR(fpt,k*nFields+k) = 0.5 + penFact;
     }
 
-    // Get normal fluxes, normal velocities
-    for (int dim=0; dim<params->nDims; dim++) {
-      vnL += normL(fpt,dim)*UL(fpt,dim+1)/rhoL;
-      vnR += normL(fpt,dim)*UR(fpt,dim+1)/rhoR;
-      if (params->motion)
-        vgn += normL(fpt,dim)*Vg(fpt,dim);
-      for (int i=0; i<params->nFields; i++) {
-        tempFnL[i] += normL(fpt,dim)*tempFL(dim,i);
-        tempFnR[i] += normL(fpt,dim)*tempFR(dim,i);
-      }
+    /* Fn is linear in the left & right viscous fluxes and the solution jump:
+     * Fn = sum_dim (cL[dim]*FvL[dim] + cR[dim]*FvR[dim]) + cU*(UL-UR) */
+    double cL[3], cR[3], cU = 0;
+    double nn = 0, nSum = 0;
+    for (int dim=0; dim<nDims; dim++) {
+      nn += normL(fpt,dim)*normL(fpt,dim);
+      nSum += normL(fpt,dim);
     }
 
-    // Get maximum eigenvalue for diffusion coefficient
-    double csqL = max(params->gamma*pL/rhoL,0.0);
-    double csqR = max(params->gamma*pR/rhoR,0.0);
-    double eigL = std::fabs(vnL) + sqrt(csqL);
-    double eigR = std::fabs(vnR) + sqrt(csqR);
-
-    // Calculate Rusanov flux
-    for (int i=0; i<params->nFields; i++) {
-      Fn(fpt,i) = 0.5*(tempFnL[i]+tempFnR[i]);
+    if (params->equation == NAVIER_STOKES) {
+      for (int dim=0; dim<nDims; dim++) {
+        cL[dim] =  penFact*nn*normL(fpt,dim);
+        cR[dim] = -penFact*nn*normL(fpt,dim);
+      }
+      if (nDims == 2) {
+        for (int dim=0; dim<nDims; dim++) {
+          cL[dim] += 0.5*normL(fpt,dim);
+          cR[dim] += 0.5*normL(fpt,dim);
+        }
+      }
+      else {
+        // As in calcCommonViscousFlux, the 3D average uses the first flux component only
+        cL[0] += 0.5*nSum;
+        cR[0] += 0.5*nSum;
+      }
+      cU = params->tau*nn;
     }
-
-    // Store wave speed for calculation of allowable dt
-    if (params->motion) {
-      eigL = std::fabs(vnL-vgn) + sqrt(csqL);
-      eigR = std::fabs(vnR-vgn) + sqrt(csqR);
+    else if (params->equation == ADVECTION_DIFFUSION) {
+      for (int dim=0; dim<nDims; dim++) {
+        cL[dim] = 0.5*normL(fpt,dim);
+        cR[dim] = 0.5*normL(fpt,dim);
+      }
     }
-    *waveSp[fpt] = max(eigL,eigR);
-  }
-}
-
-//! First step of the LDG flux - take a biased average of the solution
-void face::ldgSolution()
-{
-  if (isBnd) {
-    for (int fpt=0; fpt<nFptsL; fpt++)
-      for(int k=0;k<nFields;k++)
-        UC(fpt,k) = 0.5*(UL(fpt,k) + UR(fpt,k));
-  }
-  else {
-    // Choosing a unique direction for the switch
-    for (int fpt=0; fpt<nFptsL; fpt++) {
 
-      double penFact = params->penFact;
+    viscousFluxJacobian(UL[fpt], gradUL[fpt], dFvdU_L.data(), dFvdQ_L.data(), params);
+    viscousFluxJacobian(UR[fpt], gradUR[fpt], dFvdU_R.data(), dFvdQ_R.data(), params);
 
-      if (nDims == 2) {
-        if ( normL(fpt,0)+normL(fpt,1) < 0 )
-          penFact = -params->penFact;
+    for (int k=0; k<nFields; k++) {
+      for (int m=0; m<nFields; m++) {
+        double sumL = 0, sumR = 0;
+        for (int dim=0; dim<nDims; dim++) {
+          sumL += cL[dim]*dFvdU_L[(dim*nFields+k)*nFields+m];
+          sumR += cR[dim]*dFvdU_R[(dim*nFields+k)*nFields+m];
+        }
+        dFndUL(fpt,k*nFields+m) += sumL;
+        dFndUR(fpt,k*nFields+m) += sumR;
       }
-      else if (nDims == 3) {
-        if (normL(fpt,0)+normL(fpt,1)+sqrt(2.)*normL(fpt,2) < 0) {
-          penFact = -params->penFact;
+      dFndUL(fpt,k*nFields+k) += cU;
+      dFndUR(fpt,k*nFields+k) -= cU;
+
+      for (int j=0; j<nDF; j++) {
+        double sumL = 0, sumR = 0;
+        for (int dim=0; dim<nDims; dim++) {
+          sumL += cL[dim]*dFvdQ_L[(dim*nFields+k)*nDF+j];
+          sumR += cR[dim]*dFvdQ_R[(dim*nFields+k)*nDF+j];
         }
+        dFndQL(fpt,k*nDF+j) = sumL;
+        dFndQR(fpt,k*nDF+j) = sumR;
       }
-
-      for(int k=0;k<nFields;k++)
-        UC(fpt,k) = 0.5*(UL(fpt,k) + UR(fpt,k)) - penFact*(UL(fpt,k) - UR(fpt,k));
     }
   }
 }
+
+void face::addMemUsage(memTally &mem)
+{
+  // Views of a faceBlock hold none; the pointers into the elements' memory are counted as such
+  mem.add("faces", sizeof(face)
+          + memBytes(UL, UR, UC, gradUL, gradUR, Vg, FL, FnL, UcL, Fn, normL, dAL, detJacL, liftL, liftR)
+          + memBytes(waveSp, tempFL, tempFR, tempUL, interpR, projR, rightParams)
+          + memBytes(dFndUL, dFndUR, dFndQL, dFndQR, dUcdUL, dUcdUR));
+}
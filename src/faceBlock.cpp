@@ -0,0 +1,137 @@
+/*!
+ * \file faceBlock.cpp
+ * \brief faceBlock class definition
+ *
+ * Contiguous flux-point storage & batched common-flux calculation for all
+ * faces of one concrete face type
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "faceBlock.hpp"
+
+#include "flux.hpp"
+
+//! # of flux points per chunk when splitting a block's flux calculation among threads
+#define FACE_BLOCK_CHUNK 256
+
+bool faceBlock::canBatch(input *params)
+{
+  // Only the Rusanov (interior) & central (boundary) Navier-Stokes fluxes have batched kernels
+  return (params->equation == NAVIER_STOKES && params->riemannType == 0);
+}
+
+void faceBlock::setup(input *inParams, int _faceType, vector<face*> &_faces)
+{
+  params = inParams;
+  faceType = _faceType;
+  faces = _faces;
+  nFaces = faces.size();
+
+  nDims = params->nDims;
+  nFields = params->nFields;
+
+  fptStart.resize(nFaces);
+  nFpts = 0;
+  for (int i=0; i<nFaces; i++) {
+    fptStart[i] = nFpts;
+    nFpts += faces[i]->nFptsL;
+  }
+
+  UL.setup(nFpts,nFields);
+  UR.setup(nFpts,nFields);
+  normL.setup(nFpts,nDims);
+  Fn.setup(nFpts,nFields);
+  waveSp.assign(nFpts,0.);
+
+  if (params->motion)
+    Vg.setup(nFpts,nDims);
+
+  /* --- Copy each face's current data into the block, then make the face's
+   * matrices views into the block --- */
+  for (int i=0; i<nFaces; i++) {
+    face *f = faces[i];
+    int f0 = fptStart[i];
+    int nFptsF = f->nFptsL;
+
+    for (int fpt=0; fpt<nFptsF; fpt++) {
+      for (int k=0; k<nFields; k++) {
+        UL(f0+fpt,k) = f->UL(fpt,k);
+        UR(f0+fpt,k) = f->UR(fpt,k);
+        Fn(f0+fpt,k) = f->Fn(fpt,k);
+      }
+      for (int dim=0; dim<nDims; dim++) {
+        normL(f0+fpt,dim) = f->normL(fpt,dim);
+        if (params->motion)
+          Vg(f0+fpt,dim) = f->Vg(fpt,dim);
+      }
+    }
+
+    f->UL.setupView(UL[f0],nFptsF,nFields,nFields);
+    f->UR.setupView(UR[f0],nFptsF,nFields,nFields);
+    f->Fn.setupView(Fn[f0],nFptsF,nFields,nFields);
+    f->normL.setupView(normL[f0],nFptsF,nDims,nDims);
+    if (params->motion)
+      f->Vg.setupView(Vg[f0],nFptsF,nDims,nDims);
+  }
+}
+
+void faceBlock::calcInviscidFlux(void)
+{
+  /* --- Gather the left & right states of all faces [MPI faces: left state
+   * already set, and right state already received, by faceComm] --- */
+#pragma omp parallel for
+  for (int i=0; i<nFaces; i++) {
+    if (!faces[i]->isMPI)
+      faces[i]->getLeftState();
+    faces[i]->getRightState();
+  }
+
+  /* --- Common flux over all flux points of the block --- */
+#pragma omp parallel for
+  for (int fpt0=0; fpt0<nFpts; fpt0+=FACE_BLOCK_CHUNK) {
+    int n = min(FACE_BLOCK_CHUNK,nFpts-fpt0);
+    const double* vg = (params->motion) ? Vg[fpt0] : NULL;
+
+    if (faceType == BOUNDARY)
+      centralFluxBound(n,UL[fpt0],UR[fpt0],normL[fpt0],vg,Fn[fpt0],&waveSp[fpt0],params);
+    else
+      rusanovFlux(n,UL[fpt0],UR[fpt0],normL[fpt0],vg,Fn[fpt0],&waveSp[fpt0],params);
+  }
+
+  /* --- Scatter the fluxes back to the elements --- */
+#pragma omp parallel for
+  for (int i=0; i<nFaces; i++) {
+    face *f = faces[i];
+    for (int fpt=0; fpt<f->nFptsL; fpt++)
+      *(f->waveSp[fpt]) = waveSp[fptStart[i]+fpt];
+
+    f->finishInviscidFlux();
+  }
+}
+
+void faceBlock::addMemUsage(memTally &mem)
+{
+  mem.add("faces", memBytes(faces, fptStart, UL, UR, normL, Vg, Fn, waveSp));
+}
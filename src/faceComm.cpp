@@ -0,0 +1,301 @@
+/*!
+ * \file faceComm.cpp
+ * \brief faceComm class definition
+ *
+ * Aggregated, persistent MPI communication of the data on all MPI faces
+ * shared with each neighboring rank
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "faceComm.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+faceComm::~faceComm()
+{
+  freeRequests();
+}
+
+void faceComm::freeRequests(void)
+{
+#ifndef _NO_MPI
+  int finalized;
+  MPI_Finalized(&finalized);
+
+  for (auto *reqs : {&sendReqs, &recvReqs, &sendReqsGrad, &recvReqsGrad, &sendReqsF, &sendReqsGradF}) {
+    if (!finalized)
+      for (auto &req : *reqs)
+        MPI_Request_free(&req);
+    reqs->clear();
+  }
+#endif
+}
+
+void faceComm::setup(input *inParams, vector<shared_ptr<mpiFace>> &mpiFaces)
+{
+  params = inParams;
+  nDims = params->nDims;
+  nFields = params->nFields;
+
+  freeRequests();
+
+  map<int, vector<mpiFace*>> rankFaces;
+  for (auto &face : mpiFaces)
+    rankFaces[face->procR].push_back(face.get());
+
+  nRanks = rankFaces.size();
+  ranks.resize(0);
+  sendFaces.resize(0);
+  recvFaces.resize(0);
+
+  for (auto &rf : rankFaces) {
+    ranks.push_back(rf.first);
+
+    auto faces = rf.second;
+    sort(faces.begin(), faces.end(), [](mpiFace *a, mpiFace *b) { return a->IDR < b->IDR; });
+    sendFaces.push_back(faces);
+
+    sort(faces.begin(), faces.end(), [](mpiFace *a, mpiFace *b) { return a->ID < b->ID; });
+    recvFaces.push_back(faces);
+  }
+
+  // BR2: the gradient & lifting factor are sent along with the solution
+  bool gradMsg = (params->viscous && params->viscScheme != 1);
+
+  floatMsg[0] = (params->haloFloat == 2);
+  floatMsg[1] = (params->haloFloat >= 1 && gradMsg);
+  sentFloat.resize(nRanks);
+  int nSol = nFields;
+  if (params->viscous && params->viscScheme == 1)
+    nSol += nDims*nFields + 1;
+
+  sendBuf.resize(nRanks);
+  recvBuf.resize(nRanks);
+  if (gradMsg) {
+    sendBufGrad.resize(nRanks);
+    recvBufGrad.resize(nRanks);
+  }
+
+  // The two sides of a face differ in # of flux points if their orders differ [p-adaptation]
+  for (int r=0; r<nRanks; r++) {
+    int nFptsSend = 0, nFptsRecv = 0;
+    for (auto &face : sendFaces[r]) {
+      nFptsSend += face->nFptsL;
+      nFptsRecv += face->nFptsR;
+    }
+
+    sendBuf[r].resize(nFptsSend*nSol);
+    recvBuf[r].resize(nFptsRecv*nSol);
+    if (gradMsg) {
+      sendBufGrad[r].resize(nFptsSend*nDims*nFields);
+      recvBufGrad[r].resize(nFptsRecv*nDims*nFields);
+    }
+  }
+
+  sendBufF.assign(floatMsg[0] ? nRanks : 0, vector<float>());
+  recvBufF.assign(floatMsg[0] ? nRanks : 0, vector<float>());
+  sendBufGradF.assign(floatMsg[1] ? nRanks : 0, vector<float>());
+  recvBufGradF.assign(floatMsg[1] ? nRanks : 0, vector<float>());
+  for (int r=0; r<nRanks; r++) {
+    if (floatMsg[0]) {
+      sendBufF[r].resize(sendBuf[r].size());
+      recvBufF[r].resize(recvBuf[r].size());
+    }
+    if (floatMsg[1]) {
+      sendBufGradF[r].resize(sendBufGrad[r].size());
+      recvBufGradF[r].resize(recvBufGrad[r].size());
+    }
+  }
+
+#ifndef _NO_MPI
+  if (nRanks == 0) return;
+
+  MPI_Comm myComm = sendFaces[0][0]->myInfo.gridComm;
+
+  // Tags distinguish the solution [0] from the gradient [1] messages; messages
+  // which may be sent as floats are sent & received as bytes
+  sendReqs.resize(nRanks);
+  recvReqs.resize(nRanks);
+  for (int r=0; r<nRanks; r++) {
+    if (floatMsg[0]) {
+      MPI_Send_init(sendBuf[r].data(),sendBuf[r].size()*sizeof(double),MPI_BYTE,ranks[r],0,myComm,&sendReqs[r]);
+      MPI_Recv_init(recvBuf[r].data(),recvBuf[r].size()*sizeof(double),MPI_BYTE,ranks[r],0,myComm,&recvReqs[r]);
+    } else {
+      MPI_Send_init(sendBuf[r].data(),sendBuf[r].size(),MPI_DOUBLE,ranks[r],0,myComm,&sendReqs[r]);
+      MPI_Recv_init(recvBuf[r].data(),recvBuf[r].size(),MPI_DOUBLE,ranks[r],0,myComm,&recvReqs[r]);
+    }
+  }
+
+  if (floatMsg[0]) {
+    sendReqsF.resize(nRanks);
+    for (int r=0; r<nRanks; r++)
+      MPI_Send_init(sendBufF[r].data(),sendBufF[r].size()*sizeof(float),MPI_BYTE,ranks[r],0,myComm,&sendReqsF[r]);
+  }
+
+  if (gradMsg) {
+    sendReqsGrad.resize(nRanks);
+    recvReqsGrad.resize(nRanks);
+    for (int r=0; r<nRanks; r++) {
+      if (floatMsg[1]) {
+        MPI_Send_init(sendBufGrad[r].data(),sendBufGrad[r].size()*sizeof(double),MPI_BYTE,ranks[r],1,myComm,&sendReqsGrad[r]);
+        MPI_Recv_init(recvBufGrad[r].data(),recvBufGrad[r].size()*sizeof(double),MPI_BYTE,ranks[r],1,myComm,&recvReqsGrad[r]);
+      } else {
+        MPI_Send_init(sendBufGrad[r].data(),sendBufGrad[r].size(),MPI_DOUBLE,ranks[r],1,myComm,&sendReqsGrad[r]);
+        MPI_Recv_init(recvBufGrad[r].data(),recvBufGrad[r].size(),MPI_DOUBLE,ranks[r],1,myComm,&recvReqsGrad[r]);
+      }
+    }
+  }
+
+  if (floatMsg[1]) {
+    sendReqsGradF.resize(nRanks);
+    for (int r=0; r<nRanks; r++)
+      MPI_Send_init(sendBufGradF[r].data(),sendBufGradF[r].size()*sizeof(float),MPI_BYTE,ranks[r],1,myComm,&sendReqsGradF[r]);
+  }
+#endif
+}
+
+#ifndef _NO_MPI
+void faceComm::startExchange(bool grad)
+{
+  if (nRanks == 0) return;
+
+  auto &sBuf = (grad) ? sendBufGrad : sendBuf;
+  auto &sReqs = (grad) ? sendReqsGrad : sendReqs;
+  auto &sReqsF = (grad) ? sendReqsGradF : sendReqsF;
+  auto &sBufF = (grad) ? sendBufGradF : sendBufF;
+  auto &rReqs = (grad) ? recvReqsGrad : recvReqs;
+  bool toFloat = floatMsg[grad];
+
+  MPI_Startall(nRanks,rReqs.data());
+
+  // Packing involves no MPI calls, so may be shared among threads [MPI_THREAD_FUNNELED]
+#pragma omp parallel for schedule(dynamic)
+  for (int r=0; r<nRanks; r++) {
+    double *buf = sBuf[r].data();
+    for (auto &face : sendFaces[r]) {
+      if (grad)
+        buf = face->communicateGrad(buf);
+      else
+        buf = face->communicate(buf);
+    }
+
+    if (toFloat)
+      sentFloat[r] = packFloat(sBuf[r],sBufF[r]);
+  }
+
+  if (toFloat) {
+    for (int r=0; r<nRanks; r++)
+      MPI_Start(sentFloat[r] ? &sReqsF[r] : &sReqs[r]);
+  } else {
+    MPI_Startall(nRanks,sReqs.data());
+  }
+}
+#else
+void faceComm::startExchange(bool /*grad*/) {}
+#endif
+
+#ifndef _NO_MPI
+int faceComm::finishAny(bool grad)
+{
+  PROFILE("mpiWait");
+
+  if (nRanks == 0) return -1;
+
+  auto &rBuf = (grad) ? recvBufGrad : recvBuf;
+  auto &sReqs = (grad) ? sendReqsGrad : sendReqs;
+  auto &sReqsF = (grad) ? sendReqsGradF : sendReqsF;
+  auto &rReqs = (grad) ? recvReqsGrad : recvReqs;
+
+  int r;
+  MPI_Status status;
+  MPI_Waitany(nRanks,rReqs.data(),&r,&status);
+
+  if (r == MPI_UNDEFINED) {
+    // All data received; make sure the send buffers are free for re-use
+    // [the unused one of each rank's two send requests is inactive]
+    MPI_Waitall(nRanks,sReqs.data(),MPI_STATUSES_IGNORE);
+    if (floatMsg[grad])
+      MPI_Waitall(nRanks,sReqsF.data(),MPI_STATUSES_IGNORE);
+    return -1;
+  }
+
+  if (floatMsg[grad]) {
+    int nBytes;
+    MPI_Get_count(&status,MPI_BYTE,&nBytes);
+    if (nBytes < (int)(rBuf[r].size()*sizeof(double)))
+      unpackFloat(rBuf[r], (grad) ? recvBufGradF[r] : recvBufF[r]);
+  }
+
+  const double *buf = rBuf[r].data();
+  for (auto &face : recvFaces[r]) {
+    if (grad)
+      buf = face->receiveGrad(buf);
+    else
+      buf = face->receive(buf);
+  }
+
+  return r;
+}
+#else
+int faceComm::finishAny(bool /*grad*/)
+{
+  return -1;
+}
+#endif
+
+void faceComm::finishAll(bool grad)
+{
+  PROFILE("mpiWait");
+
+  while (finishAny(grad) >= 0) {}
+}
+
+void faceComm::addMemUsage(memTally &mem)
+{
+  mem.add("mpiFace", memBytes(ranks, sendFaces, recvFaces, sendBuf, recvBuf, sendBufGrad, recvBufGrad)
+          + memBytes(sentFloat, sendBufF, recvBufF, sendBufGradF, recvBufGradF));
+}
+
+bool faceComm::packFloat(const vector<double> &buf, vector<float> &fBuf)
+{
+  double maxVal = 0, maxErr = 0;
+  for (size_t i=0; i<buf.size(); i++) {
+    fBuf[i] = buf[i];
+    maxVal = std::max(maxVal, std::abs(buf[i]));
+    maxErr = std::max(maxErr, std::abs(buf[i] - (double)fBuf[i]));
+  }
+
+  // [Also false for values out of the range of floats]
+  return (maxErr <= params->haloTol * maxVal);
+}
+
+void faceComm::unpackFloat(vector<double> &buf, vector<float> &fBuf)
+{
+  memcpy(fBuf.data(), buf.data(), fBuf.size()*sizeof(float));
+  for (size_t i=0; i<buf.size(); i++)
+    buf[i] = fBuf[i];
+}
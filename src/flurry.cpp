@@ -38,23 +38,234 @@
 #include <unistd.h>  // for getpid()
 #endif
 
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "extract.hpp"
 #include "funcs.hpp"
 #include "multigrid.hpp"
+#include "statistics.hpp"
+
+/*! Scaling benchmark: Flurry -scaling <weak|strong> [DOFs] [steps] [options file]
+ *
+ * Runs the isentropic vortex on a periodic box [geo::createMesh] with about
+ * 'DOFs' solution points per rank [weak] or in total [strong] for a fixed
+ * number of steps, and appends one JSON line per run to
+ * <dataFileName>_<weak|strong>.json.  Options in the [optional] options file
+ * take precedence over the benchmark's defaults [e.g. nDims, order]. */
+struct scalingBench {
+  bool on = false;
+  string mode = "weak";
+  double nDofs = 1e5;
+  int nSteps = 20;
+  string optsFile;
+};
+
+/*! One member of an ensemble run [see input::ensemble] other than the first,
+ *  which is the main solver.  All members share the main solver's mesh & FR
+ *  operators, and are advanced in lockstep with it. */
+struct ensembleMember {
+  input params;
+  solver Solver;
+  extractor extract;
+  statistics stats;
+};
+
+/*! Tally the memory held by each subsystem on every rank & print the summary
+ *  [see memTally]; the ensemble members share the main solver's mesh */
+static void reportMemory(const string &title, solver &Solver, multiGrid &pmg,
+                         vector<shared_ptr<ensembleMember>> &ensemble, input &params)
+{
+  memTally mem;
+  Solver.addMemUsage(mem);
+  Solver.Geo->addMemUsage(mem);
+
+  if (params.PMG)
+    pmg.addMemUsage(mem,Solver);
+
+  for (auto &m : ensemble) {
+    memTally member;
+    m->Solver.addMemUsage(member);
+    mem.add("ensemble members", member.total());
+  }
+
+  mem.report(title);
+}
+
+/*! Generate the input file of the scaling benchmark [on rank 0]; returns its name */
+static string writeScalingInput(const scalingBench &sb, int rank, int nproc)
+{
+  // The mesh size depends on the user's choice of nDims & order
+  int nDims = 2, order = 3;
+  if (!sb.optsFile.empty()) {
+    fileReader opts(sb.optsFile);
+    opts.readFile();
+    opts.getScalarValue("nDims",nDims,2);
+    opts.getScalarValue("order",order,3);
+  }
+
+  double nDofs = (sb.mode == "weak") ? sb.nDofs*nproc : sb.nDofs;
+  int nx = max(2,(int)round(pow(nDofs/pow(order+1,nDims),1./nDims)));
+
+  string fileName = "scaling_input.tmp";
+  if (rank != 0) return fileName;
+
+  ofstream inFile(fileName.c_str());
+  if (!sb.optsFile.empty()) {
+    ifstream opts(sb.optsFile.c_str());
+    inFile << opts.rdbuf() << endl;
+  }
+  inFile << "equation 1" << endl;
+  inFile << "nDims " << nDims << endl;
+  inFile << "order " << order << endl;
+  inFile << "viscous 0" << endl;
+  inFile << "icType 1" << endl;
+  inFile << "timeType 4" << endl;
+  inFile << "dtType 1" << endl;
+  inFile << "CFL 0.5" << endl;
+  inFile << "iterMax " << sb.nSteps << endl;
+  inFile << "maxTime 1e10" << endl;
+  inFile << "meshType 1" << endl;
+  inFile << "distributedMesh 1" << endl;
+  inFile << "nx " << nx << endl << "ny " << nx << endl << "nz " << nx << endl;
+  inFile << "xmin -5" << endl << "xmax 5" << endl;
+  inFile << "ymin -5" << endl << "ymax 5" << endl;
+  inFile << "zmin -5" << endl << "zmax 5" << endl;
+  inFile << "monitorResFreq " << sb.nSteps << endl;
+  inFile << "monitorErrFreq " << sb.nSteps+1 << endl;
+  inFile << "dataFileName scaling" << endl;
+  inFile << "profile 1" << endl;
+  inFile.close();
+
+  return fileName;
+}
+
+/*! Report the throughput of the scaling benchmark, & its parallel efficiency
+ *  relative to the run of the same case on the fewest cores in the report file */
+static void writeScalingReport(const scalingBench &sb, solver &Solver, input &params)
+{
+  double nDofs = 0;
+  for (auto &e : Solver.eles)
+    nDofs += e->nSpts;
+
+  // The slowest rank sets the pace; the wait fraction is averaged over all ranks
+  double tUpdate = profiler.getTime("update");
+  double tWait = profiler.getTime("mpiWait");
+  double tUpdateSum = tUpdate;
+#ifndef _NO_MPI
+  MPI_Allreduce(MPI_IN_PLACE,&nDofs,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE,&tWait,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE,&tUpdateSum,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE,&tUpdate,1,MPI_DOUBLE,MPI_MAX,MPI_COMM_WORLD);
+#endif
+
+  if (params.rank != 0) return;
+
+  int nThreads = getMaxThreads();
+  int nCores = params.nproc*nThreads;
+  int nSteps = params.iter - params.initIter;
+  double rate = nDofs*nSteps/tUpdate;
+  double waitFrac = (tUpdateSum > 0) ? tWait/tUpdateSum : 0.;
+
+  stringstream caseName;
+  caseName << sb.mode << " " << params.nDims << "D p" << params.order << " " << sb.nDofs;
+  string key = "\"case\": \"" + caseName.str() + "\"";
+
+  /* --- Baseline: the run of this case on the fewest cores so far --- */
+  string fileName = params.dataFileName + "_" + sb.mode + ".json";
+  int baseCores = nCores;
+  double baseRate = rate/nCores;
+  ifstream oldFile(fileName.c_str());
+  string line;
+  while (getline(oldFile,line)) {
+    if (line.find(key) == string::npos) continue;
+    int cores = atoi(line.substr(line.find("\"cores\": ")+9).c_str());
+    double perCore = atof(line.substr(line.find("\"dof_steps_per_core_s\": ")+24).c_str());
+    if (cores < baseCores) {
+      baseCores = cores;
+      baseRate = perCore;
+    }
+  }
+  oldFile.close();
+
+  double efficiency = rate/nCores/baseRate;
+
+  ofstream report(fileName.c_str(), ofstream::app);
+  report << "{" << key << ", \"ranks\": " << params.nproc << ", \"threads\": " << nThreads;
+  report << ", \"cores\": " << nCores << ", \"dofs\": " << nDofs << ", \"steps\": " << nSteps;
+  report << ", \"time_s\": " << tUpdate << ", \"dof_steps_per_s\": " << rate;
+  report << ", \"dof_steps_per_core_s\": " << rate/nCores << ", \"parallel_efficiency\": " << efficiency;
+  report << ", \"baseline_cores\": " << baseCores << ", \"mpi_wait_fraction\": " << waitFrac << "}" << endl;
+
+  cout << endl << "Scaling benchmark [" << caseName.str() << "]: " << nDofs << " DOFs on " << nCores << " core(s)" << endl;
+  cout << "  DOF-steps/s per core: " << rate/nCores << endl;
+  cout << "  Parallel efficiency:  " << efficiency << " [vs. " << baseCores << " core(s)]" << endl;
+  cout << "  MPI wait fraction:    " << waitFrac << endl;
+  cout << "  Appended to " << fileName << endl;
+}
+
+/*! Run-wide values for the JSON profile [profile 2]: the DOFs & steps, the
+ *  update time of the slowest rank per DOF per step, and the peak memory of
+ *  the largest rank; read by tests/regression/run_regression.sh */
+static map<string,double> getRunSummary(solver &Solver, input &params)
+{
+  double nDofs = 0;
+  for (auto &e : Solver.eles)
+    nDofs += e->nSpts;
+
+  double tUpdate = profiler.getTime("update");
+  double peakMem = getPeakMemory();
+#ifndef _NO_MPI
+  MPI_Allreduce(MPI_IN_PLACE,&nDofs,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE,&tUpdate,1,MPI_DOUBLE,MPI_MAX,MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE,&peakMem,1,MPI_DOUBLE,MPI_MAX,MPI_COMM_WORLD);
+#endif
+
+  int nSteps = params.iter - params.initIter;
+
+  map<string,double> summary;
+  summary["nThreads"] = getMaxThreads();
+  summary["nDofs"] = nDofs;
+  summary["nSteps"] = nSteps;
+  summary["updateTime"] = tUpdate;
+  summary["timePerDofStep"] = (nSteps > 0 && nDofs > 0) ? tUpdate/(nDofs*nSteps) : 0.;
+  summary["peakMemory"] = peakMem;
+
+  return summary;
+}
 
 int main(int argc, char *argv[]) {
   input params;
   solver Solver;
   multiGrid pmg;
+  extractor extract;
+  statistics stats;
 
   int rank = 0;
   int nproc = 1;
 #ifndef _NO_MPI
+#ifdef _OPENMP
+  /* Hybrid MPI+OpenMP: MPI calls are made by one thread at a time - the
+   * master thread, outside of any OpenMP parallel region, except for the
+   * task-based residual [see taskResidual], which needs MPI_THREAD_SERIALIZED */
+  int provided;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
+#else
   MPI_Init(&argc, &argv);
+#endif
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
   MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+#ifdef _OPENMP
+  if (provided < MPI_THREAD_FUNNELED)
+    FatalError("MPI library does not support MPI_THREAD_FUNNELED - required for hybrid MPI+OpenMP runs.");
+#endif
 #endif
   params.rank = rank;
   params.nproc = nproc;
+#if !defined(_NO_MPI) && defined(_OPENMP)
+  params.mpiSerialized = (provided >= MPI_THREAD_SERIALIZED);
+#endif
 
   if (rank == 0) {
     cout << endl;
@@ -70,6 +281,9 @@ int main(int argc, char *argv[]) {
     cout << R"(  ---------      Flux Reconstruction in C++      ---------  )" << endl;
     cout << R"(  ========================================================  )" << endl;
     cout << endl;
+#ifdef _OPENMP
+    cout << "Running with " << nproc << " MPI rank(s) x " << getMaxThreads() << " OpenMP thread(s)" << endl << endl;
+#endif
   }
 
   if (argc<2) FatalError("No input file specified.");
@@ -90,8 +304,50 @@ int main(int argc, char *argv[]) {
   }*/
 #endif
 
+  scalingBench scaling;
+  string inputFile = argv[1];
+  if (inputFile == "-scaling") {
+    scaling.on = true;
+    if (argc > 2) scaling.mode = argv[2];
+    if (argc > 3) scaling.nDofs = atof(argv[3]);
+    if (argc > 4) scaling.nSteps = atoi(argv[4]);
+    if (argc > 5) scaling.optsFile = argv[5];
+    if (scaling.mode != "weak" && scaling.mode != "strong")
+      FatalError("Usage: Flurry -scaling <weak|strong> [DOFs] [steps] [options file]");
+
+    inputFile = writeScalingInput(scaling, rank, nproc);
+  }
+
   /* Read input file & set simulation parameters */
-  params.readInputFile(argv[1]);
+  params.readInputFile(&inputFile[0]);
+
+  /* Ensemble run: each member reads the input file with its own overrides */
+  vector<shared_ptr<ensembleMember>> ensemble;
+  if (params.ensemble) {
+    params.readInputFile(&inputFile[0],0);
+    for (int i=1; i<(int)params.ensembleFiles.size(); i++) {
+      auto m = make_shared<ensembleMember>();
+      m->params.rank = params.rank;
+      m->params.nproc = params.nproc;
+      m->params.mpiSerialized = params.mpiSerialized;
+      m->params.readInputFile(&inputFile[0],i);
+      ensemble.push_back(m);
+    }
+  }
+
+  if (scaling.on && rank == 0)
+    remove(inputFile.c_str());
+
+  if (!params.partMeshFile.empty())
+  {
+    /* Pre-processing only: partition the mesh & write it out for later runs */
+    geo Geo;
+    Geo.writePartMesh(&params);
+#ifndef _NO_MPI
+    MPI_Finalize();
+#endif
+    return 0;
+  }
 
   if (params.PMG)
   {
@@ -105,10 +361,36 @@ int main(int argc, char *argv[]) {
 
     /* Apply the initial condition */
     Solver.initializeSolution();
+
+    /* The other ensemble members re-use the mesh & operators */
+    for (auto &m : ensemble) {
+      m->Solver.shareOperators(Solver);
+      m->Solver.setup(&m->params,m->params.order,Solver.Geo);
+      m->Solver.initializeSolution();
+    }
   }
 
   /* Write initial data file */
-  writeData(&Solver,&params);
+  if (!scaling.on) {
+    writeData(&Solver,&params);
+    for (auto &m : ensemble)
+      writeData(&m->Solver,&m->params);
+  }
+
+  /* Locate the probe & slice points for in-situ extraction */
+  extract.setup(&params,&Solver);
+  for (auto &m : ensemble)
+    m->extract.setup(&m->params,&m->Solver);
+
+  /* Start [or continue] the in-situ flow statistics */
+  if (params.statsFreq > 0) {
+    stats.setup(&params,&Solver);
+    for (auto &m : ensemble)
+      m->stats.setup(&m->params,&m->Solver);
+  }
+
+  if (params.memReport)
+    reportMemory("after setup",Solver,pmg,ensemble,params);
 
 #ifndef _NO_MPI
   // Allow all processes to finish initial file writing before starting computation
@@ -117,34 +399,129 @@ int main(int argc, char *argv[]) {
 
   /* Start timer for simulation (ignoring pre-processing) */
   params.timer.startTimer();
+  for (auto &m : ensemble)
+    m->params.timer.startTimer();
 
   double maxTime = params.maxTime;
   int initIter = params.initIter;
   int iterMax = params.iterMax;
   int iter = initIter;
 
+#ifdef _DEBUG
+  // Heap allocations made by the time steps after the first [which may set up scratch space]
+  long stepAllocs = 0;
+#endif
+
   /* --- Calculation Loop --- */
   while (params.iter < iterMax and params.time < maxTime) {
     iter++;
 
-    Solver.update();
+#ifdef _DEBUG
+    long nAlloc = getAllocCount();
+#endif
+
+    {
+      PROFILE("update");
+      Solver.update();
+      for (auto &m : ensemble)
+        m->Solver.update();
+    }
+
+    // Write the residual / error of the last monitored step, whose reduction
+    // across ranks has overlapped this one
+    finishMonitors();
+
+#ifdef _DEBUG
+    nAlloc = getAllocCount() - nAlloc;
+    if (iter > initIter+1) {
+      if (nAlloc > 0 && stepAllocs == 0 && params.rank == 0)
+        cout << "WARNING: Time step " << iter << " made " << nAlloc << " heap allocations." << endl;
+      stepAllocs += nAlloc;
+    }
+#endif
 
     /* If using multigrid, perform correction cycle */
-    if (params.PMG)
+    if (params.PMG) {
+      PROFILE("multigrid");
       pmg.cycle(Solver);
+    }
+
+    {
+      PROFILE("extract");
+      extract.sample();
+      for (auto &m : ensemble)
+        m->extract.sample();
+    }
+
+    if (params.statsFreq > 0) {
+      PROFILE("statistics");
+      stats.accumulate();
+      for (auto &m : ensemble)
+        m->stats.accumulate();
+    }
+
+    {
+      PROFILE("output");
+      // Ensemble members stop with the main solver [its iterMax & maxTime]
+      bool endTime = (params.time>=maxTime);
+      auto writeOutput = [&](solver &Solver, input &params, statistics &stats) {
+        if ((iter)%params.monitorResFreq==0 or iter==initIter+1 or endTime) writeResidual(&Solver,&params);
+        if ((iter)%params.monitorErrFreq==0 or iter==initIter+1) writeError(&Solver,&params);
+        if (!scaling.on and ((iter)%params.plotFreq==0 or iter==iterMax or endTime)) writeData(&Solver,&params);
+        if (params.restartType > 0 and ((iter)%params.restart_freq==0 or iter==iterMax or endTime)) writeRestartFile(&Solver,&params);
+        if (params.statsFreq > 0 and ((iter)%params.restart_freq==0 or iter==iterMax or endTime)) stats.write();
+      };
+
+      writeOutput(Solver,params,stats);
+      for (auto &m : ensemble)
+        writeOutput(m->Solver,m->params,m->stats);
+    }
 
-    if ((iter)%params.monitorResFreq==0 or iter==initIter+1 or params.time>=maxTime) writeResidual(&Solver,&params);
-    if ((iter)%params.monitorErrFreq==0 or iter==initIter+1) writeError(&Solver,&params);
-    if ((iter)%params.plotFreq==0 or iter==iterMax or params.time>=maxTime) writeData(&Solver,&params);
+    if (params.memReport and params.memReportFreq > 0 and iter%params.memReportFreq == 0)
+      reportMemory("at iteration " + to_string(iter),Solver,pmg,ensemble,params);
+
+    if (params.pAdaptFreq > 0 and iter%params.pAdaptFreq == 0) {
+      PROFILE("pAdapt");
+      if (Solver.setup_p_adaptation())
+        extract.relocate();
+    }
+
+    if (params.rebalanceFreq > 0 and iter%params.rebalanceFreq == 0) {
+      PROFILE("rebalance");
+      if (Solver.rebalance())
+        extract.relocate();
+    }
+  }
+
+  /* Wait for any background output to finish */
+  {
+    PROFILE("output");
+    finishOutput();
   }
 
   /* Calculate the integral / L1 / L2 error for the final time */
   writeAllError(&Solver,&params);
+  for (auto &m : ensemble)
+    writeAllError(&m->Solver,&m->params);
+
+#ifdef _DEBUG
+  if (params.rank == 0 && iter > initIter+1)
+    cout << "Heap allocations per time step [after the first]: " << (double)stepAllocs/(iter-initIter-1) << endl;
+#endif
 
   // Get simulation wall time
   params.timer.stopTimer();
   params.timer.showTime();
 
+  if (scaling.on)
+    writeScalingReport(scaling, Solver, params);
+
+  /* Print [and write] the per-phase timings */
+  if (params.profile > 1)
+    profiler.report(params.timer.getElapsedTime(), params.dataFileName + "_profile.json", getRunSummary(Solver,params));
+  else if (params.profile)
+    profiler.report(params.timer.getElapsedTime());
+
 #ifndef _NO_MPI
  MPI_Finalize();
 #endif
@@ -34,6 +34,33 @@
 #include <array>
 #include <vector>
 
+/*! Forward-mode dual number [value & one directional derivative], used for
+ *  the automatic differentiation of the more involved flux functions */
+struct dual
+{
+  double v = 0.;  //! Value
+  double d = 0.;  //! Derivative
+
+  dual(void) {}
+  dual(double val, double der = 0.) : v(val), d(der) {}
+
+  dual& operator+=(const dual &b) { v += b.v;  d += b.d;  return *this; }
+  dual& operator-=(const dual &b) { v -= b.v;  d -= b.d;  return *this; }
+  dual& operator*=(const dual &b) { d = d*b.v + v*b.d;  v *= b.v;  return *this; }
+  dual& operator/=(const dual &b) { d = (d*b.v - v*b.d)/(b.v*b.v);  v /= b.v;  return *this; }
+};
+
+static inline dual operator+(dual a, const dual &b) { return a += b; }
+static inline dual operator-(dual a, const dual &b) { return a -= b; }
+static inline dual operator*(dual a, const dual &b) { return a *= b; }
+static inline dual operator/(dual a, const dual &b) { return a /= b; }
+static inline dual operator-(const dual &a) { return dual(-a.v,-a.d); }
+static inline bool operator<(const dual &a, const dual &b) { return a.v < b.v; }
+
+static inline dual sqrt(const dual &a) { double r = std::sqrt(a.v); return dual(r, 0.5*a.d/r); }
+static inline dual abs(const dual &a) { return (a.v < 0) ? -a : a; }
+static inline dual pow(const dual &a, double b) { double r = std::pow(a.v,b-1.); return dual(r*a.v, b*r*a.d); }
+
 void inviscidFlux(const double* U, matrix<double> &F, input *params)
 {
   /* --- Note: Flux matrix expected to be <nDims x nFields> --- */
@@ -74,17 +101,87 @@ void inviscidFlux(const double* U, matrix<double> &F, input *params)
 }
 
 
-void viscousFlux(double* U, matrix<double> &gradU, matrix<double> &Fvis, input *params)
+/*! Jacobian of the Euler flux in direction 'norm' (F dot n) w.r.t. the
+ *  conserved variables at a point; An: [nFields, nFields], row-major */
+static void eulerFluxJacobian(const double* U, const double* norm, int nDims, double gamma, double* An)
+{
+  int nFields = nDims+2;
+  double g1 = gamma-1.;
+
+  double rho = U[0];
+  double vel[3] = {0,0,0};
+  double vSq = 0, vn = 0;
+  for (int i=0; i<nDims; i++) {
+    vel[i] = U[i+1]/rho;
+    vSq += vel[i]*vel[i];
+    vn += vel[i]*norm[i];
+  }
+
+  double p = g1*(U[nDims+1]-0.5*rho*vSq);
+  double H = (U[nDims+1]+p)/rho;
+
+  // Continuity
+  An[0] = 0;
+  for (int j=0; j<nDims; j++)
+    An[j+1] = norm[j];
+  An[nDims+1] = 0;
+
+  // Momentum
+  for (int i=0; i<nDims; i++) {
+    double *row = An + (i+1)*nFields;
+    row[0] = -vel[i]*vn + 0.5*g1*vSq*norm[i];
+    for (int j=0; j<nDims; j++)
+      row[j+1] = vel[i]*norm[j] - g1*norm[i]*vel[j];
+    row[i+1] += vn;
+    row[nDims+1] = g1*norm[i];
+  }
+
+  // Energy
+  double *row = An + (nDims+1)*nFields;
+  row[0] = vn*(0.5*g1*vSq - H);
+  for (int j=0; j<nDims; j++)
+    row[j+1] = H*norm[j] - g1*vn*vel[j];
+  row[nDims+1] = gamma*vn;
+}
+
+void inviscidFluxJacobian(const double* U, double* dFdU, input *params)
 {
   int nDims = params->nDims;
+  int nFields = params->nFields;
+
+  for (int dim=0; dim<nDims; dim++) {
+    double *A = dFdU + dim*nFields*nFields;
+
+    if (params->equation == ADVECTION_DIFFUSION) {
+      double a[3] = {params->advectVx, params->advectVy, params->advectVz};
+      A[0] = a[dim];
+    }
+    else if (params->equation == NAVIER_STOKES) {
+      double norm[3] = {0,0,0};
+      norm[dim] = 1.;
+      eulerFluxJacobian(U,norm,nDims,params->gamma,A);
+    }
+  }
+}
+
+/*! Body of viscousFlux; templated on the solution type so that the flux can
+ *  also be evaluated for dual numbers [see viscousFluxJacobian], and on the
+ *  dimension so that the 2D/3D branches resolve at compile time.
+ *  dU, Fv: [nDims, nFields], row-major */
+template<typename T, int nDims>
+static void viscousFluxT(const T* U, const double* dU, T* Fv, input *params)
+{
+  const int nFields = nDims+2;
+  auto gradU = [&](int i, int j) -> double { return dU[i*nFields+j]; };
+  auto Fvis = [&](int i, int j) -> T& { return Fv[i*nFields+j]; };
 
   /* --- Calculate Primitives --- */
-  double rho = U[0];
-  double u   = U[1]/rho;
-  double v   = U[2]/rho;
-  double e   = U[nDims+1]/rho - 0.5*(u*u+v*v);
+  T rho = U[0];
+  T u   = U[1]/rho;
+  T v   = U[2]/rho;
+  T e   = U[nDims+1]/rho - 0.5*(u*u+v*v);
 
-  double w;
+  T w;
   if (nDims == 3) {
     w = U[3]/rho;
     e -= 0.5*(w*w);
@@ -123,24 +220,24 @@ void viscousFlux(double* U, matrix<double> &gradU, matrix<double> &Fvis, input *
   }
 
   /* --- Calculate Viscosity --- */
-  double mu = params->mu_inf;
+  T mu = params->mu_inf;
   if (!params->fixVis) {
     // Use Sutherland's Law
-    double rt_ratio = (params->gamma-1.0)*e/(params->rt_inf);
+    T rt_ratio = (params->gamma-1.0)*e/(params->rt_inf);
     mu *= pow(rt_ratio,1.5)*(1.+(params->c_sth))/(rt_ratio+(params->c_sth));
   }
 
   /* --- Calculate Gradients --- */
-  double du_dx = (dRhoU_dx-dRho_dx*u)/rho;
-  double du_dy = (dRhoU_dy-dRho_dy*u)/rho;
+  T du_dx = (dRhoU_dx-dRho_dx*u)/rho;
+  T du_dy = (dRhoU_dy-dRho_dy*u)/rho;
 
-  double dv_dx = (dRhoV_dx-dRho_dx*v)/rho;
-  double dv_dy = (dRhoV_dy-dRho_dy*v)/rho;
+  T dv_dx = (dRhoV_dx-dRho_dx*v)/rho;
+  T dv_dy = (dRhoV_dy-dRho_dy*v)/rho;
 
   // 3D Derivatives
-  double du_dz=0, dv_dz=0;
-  double dw_dx=0, dw_dy=0;
-  double dw_dz = 0;
+  T du_dz=0, dv_dz=0;
+  T dw_dx=0, dw_dy=0;
+  T dw_dz = 0;
   if (nDims == 3) {
     du_dz = (dRhoU_dz-dRho_dz*u)/rho;
     dv_dz = (dRhoV_dz-dRho_dz*v)/rho;
@@ -150,7 +247,7 @@ void viscousFlux(double* U, matrix<double> &gradU, matrix<double> &Fvis, input *
     dw_dz = (dRhoW_dz-dRho_dz*w)/rho;
   }
 
-  double dK_dx, dK_dy, dK_dz;
+  T dK_dx, dK_dy, dK_dz;
   if (nDims == 2) {
     dK_dx = 0.5*(u*u+v*v)*dRho_dx+rho*(u*du_dx+v*dv_dx);
     dK_dy = 0.5*(u*u+v*v)*dRho_dy+rho*(u*du_dy+v*dv_dy);
@@ -162,22 +259,22 @@ void viscousFlux(double* U, matrix<double> &gradU, matrix<double> &Fvis, input *
     dK_dz = 0.5*(u*u+v*v+w*w)*dRho_dz+rho*(u*du_dz+v*dv_dz+w*dw_dz);
   }
 
-  double de_dx = (dE_dx-dK_dx-dRho_dx*e)/rho;
-  double de_dy = (dE_dy-dK_dy-dRho_dy*e)/rho;
-  double de_dz = 0;
+  T de_dx = (dE_dx-dK_dx-dRho_dx*e)/rho;
+  T de_dy = (dE_dy-dK_dy-dRho_dy*e)/rho;
+  T de_dz = 0;
   if (nDims == 3)
     de_dz = (dE_dz-dK_dz-dRho_dz*e)/rho;
 
-  double diag = (du_dx + dv_dy + dw_dz)/3.0;
+  T diag = (du_dx + dv_dy + dw_dz)/3.0;
 
-  double tauxx = 2.0*mu*(du_dx-diag);
-  double tauyy = 2.0*mu*(dv_dy-diag);
+  T tauxx = 2.0*mu*(du_dx-diag);
+  T tauyy = 2.0*mu*(dv_dy-diag);
 
-  double tauxy = mu*(du_dy + dv_dx);
+  T tauxy = mu*(du_dy + dv_dx);
 
-  double tauxz = 0;
-  double tauyz = 0;
-  double tauzz = 0;
+  T tauxz = 0;
+  T tauyz = 0;
+  T tauzz = 0;
   if (nDims == 3) {
     tauxz = mu*(du_dz + dv_dx);
     tauyz = mu*(du_dz + dv_dy);
@@ -207,6 +304,65 @@ void viscousFlux(double* U, matrix<double> &gradU, matrix<double> &Fvis, input *
   }
 }
 
+void viscousFlux(double* U, matrix<double> &gradU, matrix<double> &Fvis, input *params)
+{
+  if (params->nDims == 2)
+    viscousFluxT<double,2>(U, &gradU(0,0), &Fvis(0,0), params);
+  else
+    viscousFluxT<double,3>(U, &gradU(0,0), &Fvis(0,0), params);
+}
+
+void viscousFluxJacobian(double* U, matrix<double> &gradU, double* dFdU, double* dFdQ, input *params)
+{
+  int nDims = params->nDims;
+  int nFields = params->nFields;
+  int nF = nDims*nFields;
+
+  if (params->equation == ADVECTION_DIFFUSION) {
+    for (int i=0; i<nDims*nFields*nFields; i++)
+      dFdU[i] = 0;
+    for (int i=0; i<nF*nF; i++)
+      dFdQ[i] = 0;
+    for (int dim=0; dim<nDims; dim++)
+      dFdQ[dim*nF + dim] = -params->diffD;
+    return;
+  }
+
+  /* --- dF/dU: forward-mode AD, one field at a time --- */
+  dual Ud[5], Fd[15];
+  for (int m=0; m<nFields; m++) {
+    for (int k=0; k<nFields; k++)
+      Ud[k] = dual(U[k], (k==m) ? 1. : 0.);
+
+    if (nDims == 2)
+      viscousFluxT<dual,2>(Ud, &gradU(0,0), Fd, params);
+    else
+      viscousFluxT<dual,3>(Ud, &gradU(0,0), Fd, params);
+
+    for (int i=0; i<nF; i++)
+      dFdU[i*nFields+m] = Fd[i].d;
+  }
+
+  /* --- dF/d(gradU): for a given U, the flux is linear in the gradient, so
+   * each column is just the flux of a unit gradient --- */
+  matrix<double> dQ(nDims,nFields);
+  double F[15];
+  for (int dim=0; dim<nDims; dim++) {
+    for (int m=0; m<nFields; m++) {
+      dQ.initializeToZero();
+      dQ(dim,m) = 1.;
+
+      if (nDims == 2)
+        viscousFluxT<double,2>(U, &dQ(0,0), F, params);
+      else
+        viscousFluxT<double,3>(U, &dQ(0,0), F, params);
+
+      for (int i=0; i<nF; i++)
+        dFdQ[i*nF + dim*nFields+m] = F[i];
+    }
+  }
+}
+
 matrix<double> viscousStressTensor(double* U, matrix<double> &gradU, input *params)
 {
   int nDims = params->nDims;
@@ -346,6 +502,137 @@ void viscousFluxAD(matrix<double> &gradU, matrix<double> &Fvis, input *params)
     Fvis(2,0) = -params->diffD * gradU(2,0);
 }
 
+/*! Pointwise physical fluxes for one equation set & dimension
+ *  U: [nFields]; dU, F: [nDims, nFields], row-major */
+template<int eq, int nDims> struct pointFlux;
+
+template<int nDims>
+struct pointFlux<NAVIER_STOKES,nDims>
+{
+  static const int nFields = nDims+2;
+
+  static inline void inviscid(const double* U, input *params, double* F)
+  {
+    double rho = U[0];
+    double vel[nDims];
+    double vSq = 0.;
+    for (int dim=0; dim<nDims; dim++) {
+      vel[dim] = U[dim+1]/rho;
+      vSq += vel[dim]*vel[dim];
+    }
+
+    double p = (params->gamma-1.0)*(U[nDims+1]-(0.5*rho*vSq));
+
+    for (int dim=0; dim<nDims; dim++) {
+      double* Fd = F + dim*nFields;
+      Fd[0] = U[dim+1];
+      for (int k=1; k<nDims+1; k++)
+        Fd[k] = U[k]*vel[dim];
+      Fd[dim+1] += p;
+      Fd[nDims+1] = (U[nDims+1]+p)*vel[dim];
+    }
+  }
+
+  static inline void viscous(const double* U, const double* dU, input *params, double* F)
+  {
+    viscousFluxT<double,nDims>(U, dU, F, params);
+  }
+};
+
+template<int nDims>
+struct pointFlux<ADVECTION_DIFFUSION,nDims>
+{
+  static const int nFields = 1;
+
+  static inline void inviscid(const double* U, input *params, double* F)
+  {
+    const double a[3] = {params->advectVx, params->advectVy, params->advectVz};
+    for (int dim=0; dim<nDims; dim++)
+      F[dim] = a[dim]*U[0];
+  }
+
+  static inline void viscous(const double*, const double* dU, input *params, double* F)
+  {
+    for (int dim=0; dim<nDims; dim++)
+      F[dim] = -params->diffD*dU[dim];
+  }
+};
+
+/*! Write [or add] the flux at one solution point into F, transforming it to
+ *  the reference domain with JGinv if given */
+template<int nDims, int nFields, bool add>
+static inline void storeSptFlux(const double* Fp, vector<matrix<double>> &F, vector<matrix<double>> *JGinv, int spt)
+{
+  for (int i=0; i<nDims; i++) {
+    double* Fi = F[i][spt];
+    double Ft[nFields];
+    if (JGinv == NULL) {
+      for (int k=0; k<nFields; k++)
+        Ft[k] = Fp[i*nFields+k];
+    }
+    else {
+      const double* J = (*JGinv)[spt][i];
+      for (int k=0; k<nFields; k++) {
+        Ft[k] = J[0]*Fp[k];
+        for (int j=1; j<nDims; j++)
+          Ft[k] += J[j]*Fp[j*nFields+k];
+      }
+    }
+
+    for (int k=0; k<nFields; k++)
+      Fi[k] = (add) ? Fi[k] + Ft[k] : Ft[k];
+  }
+}
+
+template<int eq, int nDims>
+static void inviscidFluxSpts(matrix<double> &U, vector<matrix<double>> &F, vector<matrix<double>> *JGinv, input *params)
+{
+  typedef pointFlux<eq,nDims> PF;
+  const int nFields = PF::nFields;
+
+  int nPts = U.getDim0();
+  for (int spt=0; spt<nPts; spt++) {
+    double Fp[nDims*nFields];
+    PF::inviscid(U[spt], params, Fp);
+    storeSptFlux<nDims,nFields,false>(Fp, F, JGinv, spt);
+  }
+}
+
+template<int eq, int nDims>
+static void viscousFluxSpts(matrix<double> &U, vector<matrix<double>> &dU, vector<matrix<double>> &F,
+                            vector<matrix<double>> *JGinv, input *params)
+{
+  typedef pointFlux<eq,nDims> PF;
+  const int nFields = PF::nFields;
+
+  int nPts = U.getDim0();
+  for (int spt=0; spt<nPts; spt++) {
+    double dUp[nDims*nFields], Fp[nDims*nFields];
+    for (int dim=0; dim<nDims; dim++)
+      for (int k=0; k<nFields; k++)
+        dUp[dim*nFields+k] = dU[dim](spt,k);
+
+    PF::viscous(U[spt], dUp, params, Fp);
+    storeSptFlux<nDims,nFields,true>(Fp, F, JGinv, spt);
+  }
+}
+
+inviscidFluxKernel getInviscidFluxKernel(input *params)
+{
+  if (params->equation == NAVIER_STOKES)
+    return (params->nDims == 2) ? inviscidFluxSpts<NAVIER_STOKES,2> : inviscidFluxSpts<NAVIER_STOKES,3>;
+  else
+    return (params->nDims == 2) ? inviscidFluxSpts<ADVECTION_DIFFUSION,2> : inviscidFluxSpts<ADVECTION_DIFFUSION,3>;
+}
+
+viscousFluxKernel getViscousFluxKernel(input *params)
+{
+  if (params->equation == NAVIER_STOKES)
+    return (params->nDims == 2) ? viscousFluxSpts<NAVIER_STOKES,2> : viscousFluxSpts<NAVIER_STOKES,3>;
+  else
+    return (params->nDims == 2) ? viscousFluxSpts<ADVECTION_DIFFUSION,2> : viscousFluxSpts<ADVECTION_DIFFUSION,3>;
+}
+
 void centralFlux(double* uL, double* uR, double* norm, double* Fn, input *params)
 {
   if (params->equation == ADVECTION_DIFFUSION) {
@@ -379,6 +666,345 @@ void upwindFlux(double* uL, double* uR, double* norm, double* Fn, input *params)
 }
 
 
+//! Inviscid Euler normal flux (F dot n) at a point; returns the pressure
+template<int nDims>
+static inline double eulerNormalFlux(const double* U, const double* norm, double gamma, double* Fn)
+{
+  const int nFields = nDims+2;
+
+  double rho = U[0];
+  double vel[nDims];
+  for (int dim=0; dim<nDims; dim++)
+    vel[dim] = U[dim+1]/rho;
+
+  double vSq = vel[0]*vel[0];
+  for (int dim=1; dim<nDims; dim++)
+    vSq += vel[dim]*vel[dim];
+
+  double p = (gamma-1.0)*(U[nDims+1]-(0.5*rho*vSq));
+
+  for (int k=0; k<nFields; k++)
+    Fn[k] = 0;
+
+  for (int dim=0; dim<nDims; dim++) {
+    Fn[0] += norm[dim]*U[dim+1];
+    for (int k=1; k<nDims+1; k++) {
+      double F = U[k]*vel[dim];
+      if (k == dim+1) F += p;
+      Fn[k] += norm[dim]*F;
+    }
+    Fn[nDims+1] += norm[dim]*((U[nDims+1]+p)*vel[dim]);
+  }
+
+  return p;
+}
+
+/*! Common inviscid flux over a contiguous set of points: Rusanov, or central
+ *  for boundary faces [which, as before, use rho*|v|^2 in the wave-speed pressure] */
+template<int nDims, bool central>
+static void faceFluxKernel(int nPts, const double* __restrict__ UL, const double* __restrict__ UR,
+                           const double* __restrict__ norm, const double* __restrict__ Vg,
+                           double* __restrict__ Fn, double* __restrict__ waveSp, double gamma)
+{
+  const int nFields = nDims+2;
+
+  for (int fpt=0; fpt<nPts; fpt++) {
+    const double* uL = UL + fpt*nFields;
+    const double* uR = UR + fpt*nFields;
+    const double* n = norm + fpt*nDims;
+
+    double FnL[nFields], FnR[nFields];
+    double pL = eulerNormalFlux<nDims>(uL,n,gamma,FnL);
+    double pR = eulerNormalFlux<nDims>(uR,n,gamma,FnR);
+
+    double rhoL = uL[0];
+    double rhoR = uR[0];
+
+    if (central) {
+      double vSqL = 0., vSqR = 0.;
+      for (int dim=0; dim<nDims; dim++) {
+        vSqL += (uL[dim+1]/rhoL)*(uL[dim+1]/rhoL);
+        vSqR += (uR[dim+1]/rhoR)*(uR[dim+1]/rhoR);
+      }
+      pL = (gamma-1.0)*(uL[nDims+1]-rhoL*vSqL);
+      pR = (gamma-1.0)*(uR[nDims+1]-rhoR*vSqR);
+    }
+
+    // Normal velocities
+    double vnL = 0., vnR = 0., vgn = 0.;
+    for (int dim=0; dim<nDims; dim++) {
+      vnL += n[dim]*uL[dim+1]/rhoL;
+      vnR += n[dim]*uR[dim+1]/rhoR;
+      if (Vg != NULL)
+        vgn += n[dim]*Vg[fpt*nDims+dim];
+    }
+
+    // Get maximum eigenvalue for diffusion coefficient
+    double csqL = max(gamma*pL/rhoL,0.0);
+    double csqR = max(gamma*pR/rhoR,0.0);
+    double eigL = std::fabs(vnL) + sqrt(csqL);
+    double eigR = std::fabs(vnR) + sqrt(csqR);
+    double eig  = max(eigL,eigR);
+
+    double* fn = Fn + fpt*nFields;
+    if (central) {
+      for (int k=0; k<nFields; k++)
+        fn[k] = 0.5*(FnL[k]+FnR[k]);
+    }
+    else {
+      for (int k=0; k<nFields; k++)
+        fn[k] = 0.5*(FnL[k]+FnR[k] - eig*(uR[k]-uL[k]));
+    }
+
+    // Store wave speed for calculation of allowable dt
+    if (Vg != NULL) {
+      eigL = std::fabs(vnL-vgn) + sqrt(csqL);
+      eigR = std::fabs(vnR-vgn) + sqrt(csqR);
+    }
+    waveSp[fpt] = max(eigL,eigR);
+  }
+}
+
+void rusanovFlux(int nPts, const double* UL, const double* UR, const double* norm, const double* Vg,
+                 double* Fn, double* waveSp, input *params)
+{
+  if (params->nDims == 2)
+    faceFluxKernel<2,false>(nPts,UL,UR,norm,Vg,Fn,waveSp,params->gamma);
+  else
+    faceFluxKernel<3,false>(nPts,UL,UR,norm,Vg,Fn,waveSp,params->gamma);
+}
+
+void centralFluxBound(int nPts, const double* UL, const double* UR, const double* norm, const double* Vg,
+                      double* Fn, double* waveSp, input *params)
+{
+  if (params->nDims == 2)
+    faceFluxKernel<2,true>(nPts,UL,UR,norm,Vg,Fn,waveSp,params->gamma);
+  else
+    faceFluxKernel<3,true>(nPts,UL,UR,norm,Vg,Fn,waveSp,params->gamma);
+}
+
+void rusanovFluxJacobian(const double* UL, const double* UR, const double* norm, double* dFdUL, double* dFdUR, input *params)
+{
+  int nDims = params->nDims;
+  int nFields = params->nFields;
+  double gamma = params->gamma;
+  double g1 = gamma-1.;
+
+  eulerFluxJacobian(UL,norm,nDims,gamma,dFdUL);
+  eulerFluxJacobian(UR,norm,nDims,gamma,dFdUR);
+
+  /* --- Wave speed and its derivative on each side --- */
+  double eig[2], deig[2][5];
+  const double* U[2] = {UL,UR};
+  for (int side=0; side<2; side++) {
+    const double* u = U[side];
+    double rho = u[0];
+    double vSq = 0., vn = 0.;
+    for (int dim=0; dim<nDims; dim++) {
+      vSq += (u[dim+1]/rho)*(u[dim+1]/rho);
+      vn += norm[dim]*u[dim+1]/rho;
+    }
+    double p = g1*(u[nDims+1]-0.5*rho*vSq);
+    double csq = max(gamma*p/rho,0.0);
+    double c = sqrt(csq);
+    eig[side] = std::fabs(vn) + c;
+
+    // d|vn|/dU
+    double sgn = (vn < 0) ? -1. : 1.;
+    deig[side][0] = -sgn*vn/rho;
+    for (int dim=0; dim<nDims; dim++)
+      deig[side][dim+1] = sgn*norm[dim]/rho;
+    deig[side][nDims+1] = 0.;
+
+    // dc/dU = gamma/(2c) * d(p/rho)/dU
+    if (csq > 0) {
+      double fac = 0.5*gamma/(c*rho);
+      deig[side][0] += fac*(0.5*g1*vSq - p/rho);
+      for (int dim=0; dim<nDims; dim++)
+        deig[side][dim+1] -= fac*g1*u[dim+1]/rho;
+      deig[side][nDims+1] += fac*g1;
+    }
+  }
+
+  /* --- Fn = 0.5*(FnL + FnR - eig*(UR-UL)), eig = max(eigL,eigR) --- */
+  int iMax = (eig[0] >= eig[1]) ? 0 : 1;
+  double lambda = eig[iMax];
+  for (int i=0; i<nFields; i++) {
+    double dUi = UR[i] - UL[i];
+    for (int j=0; j<nFields; j++) {
+      dFdUL[i*nFields+j] *= 0.5;
+      dFdUR[i*nFields+j] *= 0.5;
+      if (iMax == 0)
+        dFdUL[i*nFields+j] -= 0.5*dUi*deig[0][j];
+      else
+        dFdUR[i*nFields+j] -= 0.5*dUi*deig[1][j];
+    }
+    dFdUL[i*nFields+i] += 0.5*lambda;
+    dFdUR[i*nFields+i] -= 0.5*lambda;
+  }
+}
+
+/*! Body of roeFlux; templated on the solution type for use with dual numbers */
+template<typename T, int nDims>
+static void roeFluxT(const T* uL, const T* uR, const double* norm, T* Fn, double gamma)
+{
+  const int nFields = nDims+2;
+
+  using std::abs;
+  using std::sqrt;
+
+  array<T,3> vL, vR, um;
+  array<T,5> du;
+
+  // velocities
+  for (int i=0;i<nDims;i++)  {
+    vL[i] = uL[i+1]/uL[0];
+    vR[i] = uR[i+1]/uR[0];
+  }
+
+  T pL, pR;
+  if (nDims == 2) {
+    pL = (gamma-1.0)*(uL[3] - (0.5*uL[0]*(vL[0]*vL[0]+vL[1]*vL[1])));
+    pR = (gamma-1.0)*(uR[3] - (0.5*uR[0]*(vR[0]*vR[0]+vR[1]*vR[1])));
+  }
+  else {
+    pL = (gamma-1.0)*(uL[4] - (0.5*uL[0]*(vL[0]*vL[0]+vL[1]*vL[1]+vL[2]*vL[2])));
+    pR = (gamma-1.0)*(uR[4] - (0.5*uR[0]*(vR[0]*vR[0]+vR[1]*vR[1]+vR[2]*vR[2])));
+  }
+
+  T hL = (uL[nDims+1]+pL)/uL[0];
+  T hR = (uR[nDims+1]+pR)/uR[0];
+
+  T sq_rho = sqrt(uR[0]/uL[0]);
+  T rrho = 1./(sq_rho+1.);
+
+  // Roe-averaged velocity
+  T usq = 0.;
+  T unm = 0.;
+  double vgn = 0.;
+  for (int i=0; i<nDims; i++) {
+    um[i] = rrho*(vL[i]+sq_rho*vR[i]);
+    usq += 0.5*um[i]*um[i];
+    unm += um[i]*norm[i];
+  }
+
+  // Roe-averaged enthalpy
+  T hm = rrho*(hL + sq_rho*hR);
+
+  // Roe-avereged speed of sound
+  T am_sq = (gamma-1.)*(hm-usq);
+  T am = sqrt(am_sq);
+
+  // Compute Euler flux (first part)
+  T rhoUnL = 0.;
+  T rhoUnR = 0.;
+  for (int i=0;i<nDims;i++) {
+    rhoUnL += uL[i+1]*norm[i];
+    rhoUnR += uR[i+1]*norm[i];
+  }
+
+  Fn[0] = rhoUnL + rhoUnR;
+  Fn[1] = rhoUnL*vL[0] + rhoUnR*vR[0] + (pL+pR)*norm[0];
+  Fn[2] = rhoUnL*vL[1] + rhoUnR*vR[1] + (pL+pR)*norm[1];
+  Fn[3] = rhoUnL*hL   +rhoUnR*hR;
+
+  // Compute solution difference across face
+  for (int i=0;i<nFields;i++) {
+    du[i] = uR[i]-uL[i];
+  }
+
+  // Eigenvalues
+  T lambda0 = abs(unm-vgn);
+  T lambdaP = abs(unm-vgn+am);
+  T lambdaM = abs(unm-vgn-am);
+
+  // Entropy fix
+  T eps = 0.5*(abs(rhoUnL/uL[0]-rhoUnR/uR[0])+ abs(sqrt(gamma*pL/uL[0])-sqrt(gamma*pR/uR[0])));
+  if(lambda0 < 2.*eps)
+    lambda0 = 0.25*lambda0*lambda0/eps + eps;
+  if(lambdaP < 2.*eps)
+    lambdaP = 0.25*lambdaP*lambdaP/eps + eps;
+  if(lambdaM < 2.*eps)
+    lambdaM = 0.25*lambdaM*lambdaM/eps + eps;
+
+  T a2 = 0.5*(lambdaP+lambdaM)-lambda0;
+  T a3 = 0.5*(lambdaP-lambdaM)/am;
+  T a1 = a2*(gamma-1.)/am_sq;
+  T a4 = a3*(gamma-1.);
+
+  T a5, a6;
+  if (nDims==2) {
+    a5 = usq*du[0]-um[0]*du[1]-um[1]*du[2]+du[3];
+    a6 = unm*du[0]-norm[0]*du[1]-norm[1]*du[2];
+  }
+  else if (nDims==3) {
+    a5 = usq*du[0]-um[0]*du[1]-um[1]*du[2]-um[2]*du[3]+du[4];
+    a6 = unm*du[0]-norm[0]*du[1]-norm[1]*du[2]-norm[2]*du[3];
+  }
+
+  T aL1 = a1*a5 - a3*a6;
+  T bL1 = a4*a5 - a2*a6;
+
+  // Compute Euler flux (second part)
+  if (nDims==2) {
+    Fn[0] -= lambda0*du[0]+aL1;
+    Fn[1] -= lambda0*du[1]+aL1*um[0]+bL1*norm[0];
+    Fn[2] -= lambda0*du[2]+aL1*um[1]+bL1*norm[1];
+    Fn[3] -= lambda0*du[3]+aL1*hm   +bL1*unm;
+  }
+  else if (nDims==3) {
+    Fn[0] -= lambda0*du[0]+aL1;
+    Fn[1] -= lambda0*du[1]+aL1*um[0]+bL1*norm[0];
+    Fn[2] -= lambda0*du[2]+aL1*um[1]+bL1*norm[1];
+    Fn[3] -= lambda0*du[3]+aL1*um[2]+bL1*norm[2];
+    Fn[4] -= lambda0*du[4]+aL1*hm   +bL1*unm;
+  }
+
+  for (int i=0;i<nFields;i++) {
+    Fn[i] *= 0.5;
+  }
+}
+
+void roeFlux(double* uL, double* uR, double *norm, double *Fn, input *params)
+{
+  if (params->nDims == 3) FatalError("Roe not implemented in 3D");
+
+  roeFluxT<double,2>(uL,uR,norm,Fn,params->gamma);
+}
+
+void roeFlux(int nPts, const double* UL, const double* UR, const double* norm, double* Fn, input *params)
+{
+  if (params->nDims == 3) FatalError("Roe not implemented in 3D");
+
+  const int nFields = 4;
+  for (int fpt=0; fpt<nPts; fpt++)
+    roeFluxT<double,2>(UL+fpt*nFields,UR+fpt*nFields,norm+fpt*2,Fn+fpt*nFields,params->gamma);
+}
+
+void roeFluxJacobian(const double* UL, const double* UR, const double* norm, double* dFdUL, double* dFdUR, input *params)
+{
+  if (params->nDims == 3) FatalError("Roe not implemented in 3D");
+
+  int nFields = params->nFields;
+
+  /* --- Forward-mode AD, one left/right field at a time --- */
+  dual uL[5], uR[5], Fn[5];
+  for (int side=0; side<2; side++) {
+    double *dFdU = (side == 0) ? dFdUL : dFdUR;
+    for (int m=0; m<nFields; m++) {
+      for (int k=0; k<nFields; k++) {
+        uL[k] = dual(UL[k], (side==0 && k==m) ? 1. : 0.);
+        uR[k] = dual(UR[k], (side==1 && k==m) ? 1. : 0.);
+      }
+
+      roeFluxT<dual,2>(uL,uR,norm,Fn,params->gamma);
+
+      for (int i=0; i<nFields; i++)
+        dFdU[i*nFields+m] = Fn[i].d;
+    }
+  }
+}
+
 void ldgFlux(double* , double* , matrix<double> &, matrix<double> &, double* , input *)
 {
   FatalError("LDG flux not implemented just yet.  Go to flux.cpp and do it!!");
@@ -605,6 +605,53 @@ vector<int> getOrder(vector<double> &data)
   return ind;
 }
 
+uint64_t hilbertIndex(const point &pt, const point &minPt, const point &maxPt, int nDims)
+{
+  // Integer coordinates of the point on a 2^nBits grid over the box
+  int nBits = (nDims == 3) ? 21 : 31;
+  uint32_t maxX = (1u << nBits) - 1;
+  uint32_t X[3] = {0, 0, 0};
+  for (int d=0; d<nDims; d++) {
+    double L = maxPt[d] - minPt[d];
+    double s = (L > 0) ? (pt[d] - minPt[d]) / L : 0.;
+    X[d] = (uint32_t)(min(max(s,0.),1.) * maxX);
+  }
+
+  // Transform the coordinates into the 'transposed' Hilbert index [J. Skilling, 2004]
+  uint32_t M = 1u << (nBits-1);
+  for (uint32_t Q=M; Q>1; Q>>=1) {
+    uint32_t P = Q - 1;
+    for (int i=0; i<nDims; i++) {
+      if (X[i] & Q) {
+        X[0] ^= P;
+      }
+      else {
+        uint32_t t = (X[0] ^ X[i]) & P;
+        X[0] ^= t;
+        X[i] ^= t;
+      }
+    }
+  }
+
+  for (int i=1; i<nDims; i++)
+    X[i] ^= X[i-1];
+
+  uint32_t t = 0;
+  for (uint32_t Q=M; Q>1; Q>>=1)
+    if (X[nDims-1] & Q) t ^= Q - 1;
+
+  for (int i=0; i<nDims; i++)
+    X[i] ^= t;
+
+  // Interleave the bits, most significant first
+  uint64_t h = 0;
+  for (int b=nBits-1; b>=0; b--)
+    for (int i=0; i<nDims; i++)
+      h = (h << 1) | ((X[i] >> b) & 1);
+
+  return h;
+}
+
 Vec3 getFaceNormalTri(vector<point> &facePts, point &xc)
 {
   point pt0 = facePts[0];
@@ -30,11 +30,15 @@
 
 #include <algorithm>
 #include <array>
+#include <climits>
 #include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
 #include <sstream>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "face.hpp"
@@ -46,7 +50,67 @@
 #ifndef _NO_MPI
 #include "mpi.h"
 #include "metis.h"
+#ifdef _PARMETIS
+#include "parmetis.h"
 #endif
+#endif
+
+/*! Open-addressed hash table from a face's sorted node IDs [up to 4 nodes]
+ *  to an integer ID, for matching faces without pairwise comparisons */
+struct faceHash
+{
+  typedef array<int,5> faceKey;  //! Sorted node IDs [padded with -1] & # of nodes
+
+  vector<faceKey> keys;
+  vector<int> ids;  //! ID stored in each slot [-1 if empty]
+  uint mask = 0;
+
+  static faceKey makeKey(const int* nodes, int nv)
+  {
+    faceKey key;
+    key.fill(-1);
+    std::copy(nodes,nodes+nv,key.begin());
+    std::sort(key.begin(),key.begin()+nv);
+    key[4] = nv;
+    return key;
+  }
+
+  void setup(uint nFaces)
+  {
+    uint size = 16;
+    while (size < 2*nFaces) size *= 2;
+    keys.resize(size);
+    ids.assign(size,-1);
+    mask = size-1;
+  }
+
+  uint hash(const faceKey &key) const
+  {
+    size_t h = 0;
+    for (auto k:key)
+      h ^= std::hash<int>()(k) + 0x9e3779b9 + (h<<6) + (h>>2);
+    return h & mask;
+  }
+
+  void insert(const faceKey &key, int id)
+  {
+    uint slot = hash(key);
+    while (ids[slot] != -1) slot = (slot+1) & mask;
+    keys[slot] = key;
+    ids[slot] = id;
+  }
+
+  //! ID of the first face inserted with the given key [-1 if none]
+  int find(const faceKey &key) const
+  {
+    uint slot = hash(key);
+    while (ids[slot] != -1) {
+      if (keys[slot] == key) return ids[slot];
+      slot = (slot+1) & mask;
+    }
+    return -1;
+  }
+};
 
 geo::geo()
 {
@@ -60,6 +124,25 @@ geo::~geo()
   }
 }
 
+/*! Corner nodes of each face of a hex, ordered CCW from the 'bottom-left' node of the face */
+static const int hexFaceNodes[6][4] = {
+  {0,1,2,3},  // Bottom face  (z = -1)
+  {5,4,7,6},  // Top face  (z = +1)
+  {0,3,7,4},  // Left face  (x = -1)
+  {2,1,5,6},  // Right face  (x = +1)
+  {1,0,4,5},  // Front face  (y = -1)
+  {3,2,6,7}   // Back face  (y = +1)
+};
+
+/*! Check whether the given file is a pre-partitioned binary mesh [rather than a Gmsh file] */
+static bool isPartMeshFile(const string &fileName)
+{
+  ifstream meshFile(fileName.c_str(), ios::in | ios::binary);
+  char magic[8] = {0};
+  meshFile.read(magic, 8);
+  return (meshFile && strncmp(magic, "FLURRYPM", 8) == 0);
+}
+
 void geo::setup(input* params, bool HMG)
 {
   this->params = params;
@@ -73,13 +156,22 @@ void geo::setup(input* params, bool HMG)
   rank = params->rank;
   nproc = params->nproc;
 
+  bool partMesh = false;
   switch(meshType) {
     case READ_MESH:
-      readGmsh(params->meshFileName);
+      partMesh = isPartMeshFile(params->meshFileName);
+      if (partMesh)
+        readPartMesh(params->meshFileName);
+      else
+        readGmsh(params->meshFileName);
       break;
 
     case CREATE_MESH:
-      createMesh();
+      meshBlocks = (params->distributedMesh && nproc > 1);
+      if (meshBlocks)
+        createMeshBlock();
+      else
+        createMesh();
       break;
 
 #ifndef _NO_MPI
@@ -97,8 +189,12 @@ void geo::setup(input* params, bool HMG)
 
   if (HMG)
   {
+    if (partMesh)
+      FatalError("h-multigrid cannot be used with a pre-partitioned mesh file.");
 #ifndef _NO_MPI
-    getMpiPartitions();
+    // Agglomeration: the coarsest level is partitioned instead [see multiGrid::setup]
+    if (params->HMG != 2)
+      getMpiPartitions();
 #endif
     if (nDims == 2)
       processConn2D();
@@ -108,7 +204,8 @@ void geo::setup(input* params, bool HMG)
   else
   {
 #ifndef _NO_MPI
-    partitionMesh();
+    if (!partMesh && !meshBlocks)
+      partitionMesh();
 #endif
     processConnectivity();
   }
@@ -145,10 +242,351 @@ void geo::setup_hmg(input *params, int _gridID, int _gridRank, int _nProcGrid, c
   processConnectivity();
 }
 
+void geo::agglomerate(geo &fineGrid, vector<int> &parent)
+{
+  auto &fg = fineGrid;
+
+  params = fg.params;
+  nDims = fg.nDims;
+  nFields = fg.nFields;
+  meshType = fg.meshType;
+  rank = params->rank;
+  nproc = params->nproc;
+  gridID = fg.gridID;
+  gridRank = fg.gridRank;
+  nProcGrid = fg.nProcGrid;
+  gridIdList = fg.gridIdList;
+
+  nBounds = fg.nBounds;
+  bcList = fg.bcList;
+  bcIdMap = fg.bcIdMap;
+  physicalNames = fg.physicalNames;
+
+  int nKids = 1 << nDims;
+  int cType = (nDims == 2) ? QUAD : HEX;
+
+  // Corner index <--> bits of its position [bit d set: +1 along xi_d] for the
+  // linear quad / hex [the map is its own inverse]
+  static const int cornerBits[8] = {0,1,3,2,4,5,7,6};
+
+  /* --- Quads / hexes around each vertex [as a corner] --- */
+
+  vector<vector<int>> v2c_q(fg.nVerts);
+  for (int ic = 0; ic < fg.nEles; ic++) {
+    if (fg.ctype[ic] != cType) continue;
+    set<int> corners(fg.c2v[ic], fg.c2v[ic]+nKids);
+    if ((int)corners.size() < nKids) continue;  // Collapsed cell
+    for (int k = 0; k < nKids; k++)
+      v2c_q[fg.c2v(ic,k)].push_back(ic);
+  }
+
+  /* --- Greedily form 2^nDims blocks around interior vertices --- */
+
+  vector<int> group(fg.nEles,-1);
+  vector<vector<int>> kids;     //! Fine cells of each group, by coarse-cell corner
+  vector<vector<int>> corners;  //! Coarse-cell vertices of each group
+
+  for (int iv = 0; iv < fg.nVerts; iv++) {
+    auto &cells = v2c_q[iv];
+    if ((int)cells.size() != nKids) continue;
+
+    bool free = true;
+    for (int ic : cells)
+      free = (free && group[ic] < 0);
+    if (!free) continue;
+
+    // Position of iv in each cell, and its neighbors along the cells' edges
+    vector<int> cb(nKids);
+    set<int> edgePts;
+    for (int i = 0; i < nKids; i++) {
+      for (int k = 0; k < nKids; k++)
+        if (fg.c2v(cells[i],k) == iv) cb[i] = cornerBits[k];
+      for (int d = 0; d < nDims; d++)
+        edgePts.insert(fg.c2v(cells[i], cornerBits[cb[i] ^ (1<<d)]));
+    }
+
+    if ((int)edgePts.size() != 2*nDims) continue;  // Irregular vertex
+
+    // The coarse cell is oriented as the first fine cell: a cell lies on the
+    // same side of iv along xi_d as that cell iff it shares that cell's
+    // neighbor of iv along xi_d
+    vector<int> kid(nKids,-1);
+    bool ok = true;
+    for (int i = 0; i < nKids && ok; i++) {
+      int oct = 0;
+      for (int d = 0; d < nDims; d++) {
+        int axisPt = fg.c2v(cells[0], cornerBits[cb[0] ^ (1<<d)]);
+        int shared = 0;
+        for (int d2 = 0; d2 < nDims; d2++)
+          shared |= (fg.c2v(cells[i], cornerBits[cb[i] ^ (1<<d2)]) == axisPt);
+        oct |= (shared ^ ((cb[0] >> d) & 1)) << d;
+      }
+
+      int k = cornerBits[oct];
+      if (kid[k] >= 0)
+        ok = false;
+      else
+        kid[k] = i;
+    }
+
+    if (!ok) continue;
+
+    int g = kids.size();
+    kids.push_back(vector<int>(nKids));
+    corners.push_back(vector<int>(nKids));
+    for (int k = 0; k < nKids; k++) {
+      int i = kid[k];
+      kids[g][k] = cells[i];
+      corners[g][k] = fg.c2v(cells[i], cornerBits[cb[i] ^ (nKids-1)]);
+      group[cells[i]] = g;
+    }
+  }
+
+  /* --- Only keep the groups forming a conforming coarse mesh --- */
+
+  // Sorted corner vertices of each face of each group
+  int nG = kids.size();
+  int nFacesC = 2*nDims;
+  vector<vector<vector<int>>> gFaces(nG);
+  map<vector<int>,vector<int>> face2g;
+  for (int g = 0; g < nG; g++) {
+    for (int f = 0; f < nFacesC; f++) {
+      vector<int> fv;
+      if (nDims == 2)
+        fv = {corners[g][f], corners[g][(f+1)%4]};
+      else
+        for (int j = 0; j < 4; j++)
+          fv.push_back(corners[g][hexFaceNodes[f][j]]);
+      std::sort(fv.begin(), fv.end());
+      face2g[fv].push_back(g);
+      gFaces[g].push_back(fv);
+    }
+  }
+
+  auto shareFace = [&](int g, int h) {
+    for (auto &fv : gFaces[g])
+      for (int g2 : face2g[fv])
+        if (g2 == h) return true;
+    return false;
+  };
+
+  // A group bordering an un-merged cell, or a group it doesn't share a whole
+  // face with, would leave hanging nodes: split it up again until none remain
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (int g = 0; g < nG; g++) {
+      if (kids[g].empty()) continue;
+
+      bool conforming = true;
+      for (int ic : kids[g]) {
+        for (int j = 0; j < fg.c2nf[ic] && conforming; j++) {
+          int ic2 = fg.c2c(ic,j);
+          if (ic2 < 0 || group[ic2] == g) continue;
+          conforming = (group[ic2] >= 0 && shareFace(g, group[ic2]));
+        }
+      }
+
+      if (!conforming) {
+        for (int ic : kids[g])
+          group[ic] = -1;
+        kids[g].clear();
+        changed = true;
+      }
+    }
+  }
+
+  /* --- Create the coarse cells [in the order of their first fine cell] --- */
+
+  vector<vector<int>> c2v_c;
+  vector<int> g2c(nG,-1);
+  parent.assign(fg.nEles,-1);
+  ctype.clear();
+  c2nf.clear();
+
+  int nMerged = 0;
+  for (int ic = 0; ic < fg.nEles; ic++) {
+    int g = group[ic];
+    if (g >= 0) {
+      if (g2c[g] < 0) {
+        g2c[g] = c2v_c.size();
+        c2v_c.push_back(corners[g]);
+        ctype.push_back(cType);
+        c2nf.push_back(nFacesC);
+        nMerged++;
+      }
+      parent[ic] = g2c[g];
+    }
+    else {
+      // Kept as-is, but with a linear shape [corner nodes only]
+      int nc = fg.c2nv[ic];
+      switch (fg.ctype[ic]) {
+        case TRI:  nc = 3; break;
+        case QUAD: nc = 4; break;
+        case HEX:  nc = 8; break;
+      }
+      parent[ic] = c2v_c.size();
+      c2v_c.push_back(vector<int>(fg.c2v[ic], fg.c2v[ic]+nc));
+      ctype.push_back(fg.ctype[ic]);
+      c2nf.push_back(fg.c2nf[ic]);
+    }
+  }
+
+  nEles = c2v_c.size();
+  c2nv.resize(nEles);
+  for (int ic = 0; ic < nEles; ic++)
+    c2nv[ic] = c2v_c[ic].size();
+
+  nNodesPerCell = getMax(c2nv);
+
+  /* --- Keep only the vertices still in use --- */
+
+  vector<int> ivMap(fg.nVerts,-1);
+  for (auto &cv : c2v_c)
+    for (int iv : cv)
+      ivMap[iv] = 0;
+
+  nVerts = 0;
+  for (int iv = 0; iv < fg.nVerts; iv++)
+    if (ivMap[iv] == 0) ivMap[iv] = nVerts++;
+
+  xv.setup(nVerts,nDims);
+  for (int iv = 0; iv < fg.nVerts; iv++)
+    if (ivMap[iv] >= 0)
+      for (int d = 0; d < nDims; d++)
+        xv(ivMap[iv],d) = fg.xv(iv,d);
+
+  c2v.setup(nEles,nNodesPerCell);
+  c2v.initializeToZero();
+  for (int ic = 0; ic < nEles; ic++)
+    for (int j = 0; j < c2nv[ic]; j++)
+      c2v(ic,j) = ivMap[c2v_c[ic][j]];
+
+  vector<vector<int>> boundPoints(nBounds);
+  for (int bnd = 0; bnd < nBounds; bnd++)
+    for (int j = 0; j < fg.nBndPts[bnd]; j++)
+      if (ivMap[fg.bndPts(bnd,j)] >= 0)
+        boundPoints[bnd].push_back(ivMap[fg.bndPts(bnd,j)]);
+
+  nBndPts.resize(nBounds);
+  for (int bnd = 0; bnd < nBounds; bnd++)
+    nBndPts[bnd] = boundPoints[bnd].size();
+
+  int maxNBndPts = 1;
+  for (int bnd = 0; bnd < nBounds; bnd++)
+    maxNBndPts = max(maxNBndPts,nBndPts[bnd]);
+
+  bndPts.setup(nBounds,maxNBndPts);
+  bndPts.initializeToValue(-1);
+  for (int bnd = 0; bnd < nBounds; bnd++)
+    for (int j = 0; j < nBndPts[bnd]; j++)
+      bndPts(bnd,j) = boundPoints[bnd][j];
+
+  if (rank == 0)
+    cout << "Geo: Agglomerated " << fg.nEles << " cells into " << nEles << " [" << nMerged
+         << " merged, " << nEles - nMerged << " kept]" << endl;
+
+  if (nDims == 2)
+    processConn2D();
+  else
+    processConn3D();
+}
+
+#ifndef _NO_MPI
+void geo::setupRebalanced(geo &oldGeo, const vector<shared_ptr<ele>> &eles)
+{
+  params = oldGeo.params;
+
+  nDims = oldGeo.nDims;
+  nFields = oldGeo.nFields;
+  meshType = oldGeo.meshType;
+  rank = params->rank;
+  nproc = params->nproc;
+  nGrids = oldGeo.nGrids;
+
+  gridID = oldGeo.gridID;
+  gridRank = oldGeo.gridRank;
+  nProcGrid = oldGeo.nProcGrid;
+  gridIdList = oldGeo.gridIdList;
+
+  if (meshType == OVERSET_MESH)
+    MPI_Comm_split(MPI_COMM_WORLD, gridID, params->rank, &gridComm);
+  else
+    gridComm = MPI_COMM_WORLD;
+
+  /* --- Start again from the full [un-partitioned] grid --- */
+
+  nBounds = oldGeo.nBounds;
+  bcList = oldGeo.bcList;
+  bcIdMap = oldGeo.bcIdMap;
+  physicalNames = oldGeo.physicalNames;
+  nNodesPerCell = oldGeo.nNodesPerCell;
+
+  if (nProcGrid > 1) {
+    if (oldGeo.c2v_g.getDim0() == 0)
+      FatalError("Load rebalancing requires the global mesh - not available with a pre-partitioned mesh file.");
+
+    nEles   = oldGeo.nEles_g;
+    nVerts  = oldGeo.nVerts_g;
+    c2v     = oldGeo.c2v_g;
+    xv      = oldGeo.xv_g;
+    ctype   = oldGeo.ctype_g;
+    c2nv    = oldGeo.c2nv_g;
+    c2nf    = oldGeo.c2ne_g;
+    bndPts  = oldGeo.bndPts_g;
+    nBndPts = oldGeo.nBndPts_g;
+  }
+  else {
+    // Grid on a single rank: nothing to re-partition, but the overset
+    // connectivity must still be re-processed along with the other grids
+    nEles   = oldGeo.nEles;
+    nVerts  = oldGeo.nVerts;
+    ic2icg  = oldGeo.ic2icg;
+    c2v     = oldGeo.c2v;
+    xv      = oldGeo.xv;
+    ctype   = oldGeo.ctype;
+    c2nv    = oldGeo.c2nv;
+    c2nf    = oldGeo.c2nf;
+    bndPts  = oldGeo.bndPts;
+    nBndPts = oldGeo.nBndPts;
+  }
+
+  if (nProcGrid > 1) {
+    /* --- Weight each element by its current cost [spts + fpts] --- */
+    vector<int> weights(nEles,1);
+    for (auto &e:eles)
+      weights[e->IDg] = 2*e->nSpts + e->nFpts;
+
+    MPI_Allreduce(MPI_IN_PLACE, weights.data(), nEles, MPI_INT, MPI_MAX, gridComm);
+
+    rank = gridRank;
+    nproc = nProcGrid;
+
+    if (rank == 0) {
+      if (meshType == OVERSET_MESH)
+        cout << "Geo: Re-partitioning mesh block " << gridID << " across " << nProcGrid << " processes" << endl;
+      else
+        cout << "Geo: Re-partitioning mesh across " << nProcGrid << " processes" << endl;
+    }
+
+    computePartitions(weights);
+
+    partitionFromEpart(epart);
+  }
+
+  processConnectivity();
+}
+#else
+void geo::setupRebalanced(geo &/*oldGeo*/, const vector<shared_ptr<ele>> &/*eles*/) {}
+#endif
+
 void geo::processConnectivity()
 {
   if (params->rank==0) cout << "Geo: Processing element connectivity" << endl;
 
+  if (params->reorderMesh)
+    reorderCells();
+
   if (nDims == 2)
     processConn2D();
   else if (nDims == 3)
@@ -158,6 +596,12 @@ void geo::processConnectivity()
 
   processPeriodicBoundaries();
 
+  if (params->reorderMesh) {
+    // The faces are numbered in order of their left cells, except for the
+    // periodic faces, which were appended to intFaces
+    stable_sort(intFaces.begin(), intFaces.end(), [&](int f1, int f2) { return f2c(f1,0) < f2c(f2,0); });
+  }
+
 #ifndef _NO_MPI
   /* --- Use TIOGA to find all hole nodes, then setup overset-face connectivity --- */
   if (meshType == OVERSET_MESH) {
@@ -174,7 +618,10 @@ void geo::processConnectivity()
   }
 
   /* --- Setup MPI Processor Boundary Faces --- */
-  matchMPIFaces();
+  if (meshBlocks)
+    matchMPIFacesBlocks();
+  else
+    matchMPIFaces();
 #endif
 
   /* --- Additional setup for moving grids --- */
@@ -182,6 +629,55 @@ void geo::processConnectivity()
     xv0.resize(nVerts);
     for (int i=0; i<nVerts; i++) xv0[i] = point(xv[i],nDims);
     gridVel.setup(nVerts,nDims);
+    gridVel.initializeToZero();
+
+    if (params->motion == 4 || params->motion == 5) {
+      rigidMotion = true;
+      rotMat.setup(3,3);
+      rotMat.initializeToZero();
+      for (int i=0; i<3; i++) rotMat(i,i) = 1.;
+      rotCenter = point({params->rotCx,params->rotCy,0.});
+    }
+  }
+}
+
+void geo::reorderCells(void)
+{
+  if (nEles < 2) return;
+
+  // Keep the original cell IDs, e.g. for restart files
+  if (ic2icg.empty()) {
+    ic2icg.resize(nEles);
+    for (int ic=0; ic<nEles; ic++) ic2icg[ic] = ic;
+  }
+
+  point xmin, xmax;
+  getBoundingBox(xv,xmin,xmax);
+
+  vector<pair<uint64_t,int>> keys(nEles);
+  for (int ic=0; ic<nEles; ic++) {
+    point xc;
+    for (int j=0; j<c2nv[ic]; j++)
+      for (int d=0; d<nDims; d++)
+        xc[d] += xv(c2v(ic,j),d) / c2nv[ic];
+
+    keys[ic] = {hilbertIndex(xc,xmin,xmax,nDims), ic};
+  }
+
+  sort(keys.begin(), keys.end());
+
+  /* --- Permute all per-cell data --- */
+  matrix<int> c2v0 = c2v;
+  vector<int> ctype0 = ctype, c2nv0 = c2nv, c2nf0 = c2nf, ic2icg0 = ic2icg;
+
+  for (int ic=0; ic<nEles; ic++) {
+    int ic0 = keys[ic].second;
+    for (uint j=0; j<c2v.getDim1(); j++)
+      c2v(ic,j) = c2v0(ic0,j);
+    ctype[ic] = ctype0[ic0];
+    c2nv[ic] = c2nv0[ic0];
+    c2nf[ic] = c2nf0[ic0];
+    ic2icg[ic] = ic2icg0[ic0];
   }
 }
 
@@ -235,47 +731,11 @@ void geo::processConn2D(void)
   intFaces.resize(0);
   bndFaces.resize(0);
 
-  for (uint i=0; i<iE.size(); i++) {
-    if (iE[i]!=-1) {
-      auto ie = findEq(iE,iE[i]);
-      if (ie.size()>2) {
-        stringstream ss; ss << i;
-        string errMsg = "More than 2 cells for edge " + ss.str();
-        FatalError(errMsg.c_str());
-      }
-      else if (ie.size()==2) {
-        // Internal Edge which has not yet been added
-        intFaces.push_back(iE[i]);
-        nIntFaces++;
-      }
-      else if (ie.size()==1) {
-        // Boundary or MPI Edge
-        bndFaces.push_back(iE[i]);
-        faceType[iE[i]] = BOUNDARY;
-        nBndFaces++;
-      }
-
-      // Mark edges as completed
-      vecAssign(iE,ie,-1);
-    }
-  }
+  sortFaces(iE,"edge");
 
   /* --- Match Boundary Faces to Boundary Conditions --- */
 
-  bcFaces.resize(nBounds);
-  bcType.assign(nBndFaces,-1);
-  for (int i=0; i<nBndFaces; i++) {
-    int iv1 = f2v(bndFaces[i],0);
-    int iv2 = f2v(bndFaces[i],1);
-    for (int bnd=0; bnd<nBounds; bnd++) {
-      if (findFirst(bndPts[bnd],iv1,bndPts.dims[1])!=-1 && findFirst(bndPts[bnd],iv2,bndPts.dims[1])!=-1) {
-        // The edge lies on this boundary
-        bcType[i] = bcList[bnd];
-        bcFaces[bnd].insertRow(f2v[bndFaces[i]],INSERT_AT_END,f2v.dims[1]);
-        break;
-      }
-    }
-  }
+  matchBoundaryFaces();
 
   /* --- Setup Cell-To-Edge, Edge-To-Cell --- */
 
@@ -287,11 +747,13 @@ void geo::processConn2D(void)
   f2c.setup(nFaces,2);
   f2c.initializeToValue(-1);
 
+  // The cells' edges are visited in the same order as when building e2v1,
+  // so iE directly gives each one's global edge ID
+  int iedge = 0;
   for (int ic=0; ic<nEles; ic++) {
     for (int j=0; j<c2nf[ic]; j++) {
       int jp1 = (j+1)%(c2nf[ic]);
 
-      // Store edges consistently to allow matching of duplicates
       if (c2v(ic,j) == c2v(ic,jp1)) {
         // Collapsed edge; ignore
         c2f(ic,j) = -1;
@@ -299,18 +761,7 @@ void geo::processConn2D(void)
         continue;
       }
 
-      if (c2v(ic,j) < c2v(ic,jp1)) {
-        edge[0] = c2v(ic,j);
-        edge[1] = c2v(ic,jp1);
-      } else {
-        edge[0] = c2v(ic,jp1);
-        edge[1] = c2v(ic,j);
-      }
-
-      auto ie1 = findEq(f2v.getCol(0),edge[0]);
-      auto col2 = (f2v.getRows(ie1)).getCol(1);
-      int ie2 = findFirst(col2,edge[1]);
-      int ie0 = ie1[ie2];
+      int ie0 = iE[iedge++];
 
       // Find ID of face within type-specific array
       if (faceType[ie0]>0) {
@@ -411,54 +862,11 @@ void geo::processConn3D(void)
   nBndFaces = 0;
   nMpiFaces = 0;
 
-  for (uint i=0; i<iF.size(); i++) {
-    if (iF[i]!=-1) {
-      auto ff = findEq(iF,iF[i]);
-      if (ff.size()>2) {
-        stringstream ss; ss << i;
-        string errMsg = "More than 2 cells for face " + ss.str();
-        FatalError(errMsg.c_str());
-      }
-      else if (ff.size()==2) {
-        // Internal Edge which has not yet been added
-        intFaces.push_back(iF[i]);
-        nIntFaces++;
-      }
-      else if (ff.size()==1) {
-        // Boundary or MPI Edge
-        bndFaces.push_back(iF[i]);
-        faceType[iF[i]] = BOUNDARY;
-        nBndFaces++;
-      }
-
-      // Mark edges as completed
-      vecAssign(iF,ff,-1);
-    }
-  }
+  sortFaces(iF,"face");
 
   /* --- Match Boundary Faces to Boundary Conditions --- */
 
-  bcFaces.resize(nBounds);
-  bcType.assign(nBndFaces,NONE);
-  for (int i=0; i<nBndFaces; i++) {
-    for (int bnd=0; bnd<nBounds; bnd++) {
-      bool isOnBound = true;
-      for (int j=0; j<f2nv[bndFaces[i]]; j++) {
-        if (findFirst(bndPts[bnd],f2v(bndFaces[i],j),bndPts.dims[1]) == -1) {
-          isOnBound = false;
-          break;
-        }
-      }
-
-      if (isOnBound) {
-        //cout << "bndFace matched to bc " << bcList[bnd] << endl;
-        // The edge lies on this boundary
-        bcType[i] = bcList[bnd];
-        bcFaces[bnd].insertRow(f2v[bndFaces[i]],INSERT_AT_END,f2v.dims[1]);
-        break;
-      }
-    }
-  }
+  matchBoundaryFaces();
 
   /* --- Setup Cell-To-Face, Face-To-Cell --- */
 
@@ -471,8 +879,12 @@ void geo::processConn3D(void)
   f2c.setup(nFaces,2);
   f2c.initializeToValue(-1);
 
+  // The cells' faces are visited in the same order as when building f2v1
+  int iface1 = -1;
   for (int ic=0; ic<nEles; ic++) {
     for (int j=0; j<c2nf[ic]; j++) {
+      iface1++;
+
       // Get local vertex list for face
       auto iface = ct2fv[ctype[ic]].getRow(j);
 
@@ -495,11 +907,18 @@ void geo::processConn3D(void)
       if (collapsed)
         continue;
 
-      for (int f=0; f<nFaces; f++) {
-        if (std::equal(f2v[f],f2v[f]+fnv,facev.begin())) {
-          found = true;
-          c2f(ic,j) = f;
-          break;
+      if (std::equal(facev.begin(),facev.end(),f2v[iF[iface1]])) {
+        found = true;
+        c2f(ic,j) = iF[iface1];
+      }
+      else {
+        // Partially-collapsed face [stored with repeated nodes removed]
+        for (int f=0; f<nFaces; f++) {
+          if (std::equal(f2v[f],f2v[f]+fnv,facev.begin())) {
+            found = true;
+            c2f(ic,j) = f;
+            break;
+          }
         }
       }
 
@@ -530,6 +949,75 @@ void geo::processConn3D(void)
   }
 }
 
+void geo::sortFaces(const vector<int> &iF, const string &faceName)
+{
+  // Faces are numbered in order of first appearance in iF, and the number
+  // of times a face appears is the number of cells it touches
+  vector<int> nCells(nFaces,0);
+  for (auto ff:iF) nCells[ff]++;
+
+  // [The connectivity may be processed more than once, e.g. for h-multigrid]
+  intFaces.clear();
+  bndFaces.clear();
+
+  for (int ff=0; ff<nFaces; ff++) {
+    if (nCells[ff]>2) {
+      stringstream ss; ss << ff;
+      string errMsg = "More than 2 cells for " + faceName + " " + ss.str();
+      FatalError(errMsg.c_str());
+    }
+    else if (nCells[ff]==2) {
+      // Internal face
+      intFaces.push_back(ff);
+      nIntFaces++;
+    }
+    else if (nCells[ff]==1) {
+      // Boundary or MPI face
+      bndFaces.push_back(ff);
+      faceType[ff] = BOUNDARY;
+      nBndFaces++;
+    }
+  }
+}
+
+void geo::matchBoundaryFaces(void)
+{
+  bcFaces.assign(nBounds,matrix<int>());
+  bcType.assign(nBndFaces,NONE);
+
+  // Set of the nodes on each boundary [including any padding in bndPts]
+  vector<unordered_set<int>> bndNodes(nBounds);
+  for (int bnd=0; bnd<nBounds; bnd++)
+    bndNodes[bnd].insert(bndPts[bnd],bndPts[bnd]+bndPts.dims[1]);
+
+  // First boundary containing all of each face's nodes
+  vector<int> faceBnd(nBndFaces,-1);
+#pragma omp parallel for
+  for (int i=0; i<nBndFaces; i++) {
+    for (int bnd=0; bnd<nBounds; bnd++) {
+      bool isOnBound = true;
+      for (int j=0; j<f2nv[bndFaces[i]]; j++) {
+        if (!bndNodes[bnd].count(f2v(bndFaces[i],j))) {
+          isOnBound = false;
+          break;
+        }
+      }
+
+      if (isOnBound) {
+        faceBnd[i] = bnd;
+        break;
+      }
+    }
+  }
+
+  for (int i=0; i<nBndFaces; i++) {
+    int bnd = faceBnd[i];
+    if (bnd < 0) continue;
+    bcType[i] = bcList[bnd];
+    bcFaces[bnd].insertRow(f2v[bndFaces[i]],INSERT_AT_END,f2v.dims[1]);
+  }
+}
+
 void geo::processConnExtra(void)
 {
   int maxNC;
@@ -587,16 +1075,8 @@ void geo::processConnExtra(void)
   }
 }
 
-void geo::matchMPIFaces(void)
+void geo::extractMPIFaces(void)
 {
-#ifndef _NO_MPI
-  if (nProcGrid <= 1) return;
-
-  if (params->rank == 0) {
-    cout << "Geo: Matching MPI faces" << endl;
-  }
-
-  // 1) Get a list of all the MPI faces on the processor
   // These will be all unassigned boundary faces (bcType == NONE, or the
   // remaining unmatched bcType == PERIODIC faces)
   // - Copy over to mpiFaces
@@ -610,8 +1090,7 @@ void geo::matchMPIFaces(void)
       int periodic = (bcType[i]==PERIODIC) ? 1 : 0;
       mpiPeriodic.push_back(periodic);
       if (nDims == 3) {
-        // Get cell ID & cell-local face ID for face-rotation mapping
-        mpiCells.push_back(ic2icg[f2c(ff,0)]);
+        // Get cell-local face ID for face-rotation mapping
         auto cellFaces = c2f.getRow(f2c(ff,0));
         int fid = findFirst(cellFaces,ff);
         mpiLocF.push_back(fid);
@@ -625,6 +1104,19 @@ void geo::matchMPIFaces(void)
   bndFaces.erase(std::remove(bndFaces.begin(), bndFaces.end(), -1), bndFaces.end());
   bcType.erase(std::remove(bcType.begin(), bcType.end(), -1), bcType.end());
   nBndFaces = bndFaces.size();
+}
+
+void geo::matchMPIFaces(void)
+{
+#ifndef _NO_MPI
+  if (nProcGrid <= 1) return;
+
+  if (params->rank == 0) {
+    cout << "Geo: Matching MPI faces" << endl;
+  }
+
+  // 1) Get a list of all the MPI faces on the processor
+  extractMPIFaces();
 
   // For future compatibility with 3D mixed meshes: allow faces with different #'s nodes
   // mpi_fptr is like csr matrix ptr (or like eptr from METIS, but for faces instead of eles)
@@ -639,6 +1131,33 @@ void geo::matchMPIFaces(void)
   // Convert local node ID's to global
   std::transform(mpiFaceNodes.begin(),mpiFaceNodes.end(),mpiFaceNodes.begin(), [=](int iv){return iv2ivg[iv];} );
 
+  // Periodic faces are matched [and oriented] using the positions of their nodes
+  int anyPeriodic = 0;
+  for (auto &P:mpiPeriodic) anyPeriodic = max(anyPeriodic,P);
+  MPI_Allreduce(MPI_IN_PLACE,&anyPeriodic,1,MPI_INT,MPI_MAX,gridComm);
+
+  // 3D: Also need the nodes of each face as oriented in its cell, to find the
+  // relative rotation across the face without the global connectivity
+  vector<double> mpiFaceXv, mpiOrientXv;
+  vector<int> mpiOrientNodes;
+  for (int i=0; i<nMpiFaces; i++) {
+    int ff = mpiFaces[i];
+    if (anyPeriodic) {
+      for (int j=0; j<f2nv[ff]; j++)
+        for (int dim=0; dim<3; dim++)
+          mpiFaceXv.push_back((dim<nDims) ? xv(f2v(ff,j),dim) : 0.);
+    }
+
+    if (nDims == 3) {
+      for (auto iv:getOrientedFaceNodes(f2c(ff,0),mpiLocF[i])) {
+        mpiOrientNodes.push_back(iv2ivg[iv]);
+        if (anyPeriodic)
+          for (int dim=0; dim<3; dim++)
+            mpiOrientXv.push_back(xv(iv,dim));
+      }
+    }
+  }
+
   // Get the number of mpiFaces on each processor (for later communication)
   vector<int> nMpiFaces_proc(nProcGrid);
   MPI_Allgather(&nMpiFaces,1,MPI_INT,nMpiFaces_proc.data(),1,MPI_INT,gridComm);
@@ -671,13 +1190,35 @@ void geo::matchMPIFaces(void)
   }
   MPI_Allgatherv(mpiFaces.data(),nMpiFaces,MPI_INT,mpiFid_proc.getData(),recvCnts.data(),recvDisp.data(),MPI_INT,gridComm);
 
-  matrix<int> mpiCells_proc, mpiLocF_proc;
+  vector<int> xCnts(nProcGrid), xDisp(nProcGrid);
+  matrix<double> mpiFaceXv_proc, mpiOrientXv_proc;
+  if (anyPeriodic) {
+    mpiFaceXv_proc.setup(nProcGrid,maxNMpiFaces*maxNodesPerFace*3);
+    for (int i=0; i<nProcGrid; i++) {
+      xCnts[i] = nMpiFaces_proc[i]*maxNodesPerFace*3;
+      xDisp[i] = i*maxNMpiFaces*maxNodesPerFace*3;
+    }
+    MPI_Allgatherv(mpiFaceXv.data(),mpiFaceXv.size(),MPI_DOUBLE,mpiFaceXv_proc.getData(),xCnts.data(),xDisp.data(),MPI_DOUBLE,gridComm);
+  }
+
+  matrix<int> mpiOrientNodes_proc;
   if (nDims == 3) {
     // Needed for 3D face-matching (to find relRot)
-    mpiCells_proc.setup(nProcGrid,maxNMpiFaces);
-    mpiLocF_proc.setup(nProcGrid,maxNMpiFaces);
-    MPI_Allgatherv(mpiCells.data(),mpiCells.size(),MPI_INT,mpiCells_proc.getData(),recvCnts.data(),recvDisp.data(),MPI_INT,gridComm);
-    MPI_Allgatherv(mpiLocF.data(),mpiLocF.size(),MPI_INT,mpiLocF_proc.getData(),recvCnts.data(),recvDisp.data(),MPI_INT,gridComm);
+    mpiOrientNodes_proc.setup(nProcGrid,maxNMpiFaces*4);
+    for (int i=0; i<nProcGrid; i++) {
+      xCnts[i] = nMpiFaces_proc[i]*4;
+      xDisp[i] = i*maxNMpiFaces*4;
+    }
+    MPI_Allgatherv(mpiOrientNodes.data(),mpiOrientNodes.size(),MPI_INT,mpiOrientNodes_proc.getData(),xCnts.data(),xDisp.data(),MPI_INT,gridComm);
+
+    if (anyPeriodic) {
+      mpiOrientXv_proc.setup(nProcGrid,maxNMpiFaces*12);
+      for (int i=0; i<nProcGrid; i++) {
+        xCnts[i] = nMpiFaces_proc[i]*12;
+        xDisp[i] = i*maxNMpiFaces*12;
+      }
+      MPI_Allgatherv(mpiOrientXv.data(),mpiOrientXv.size(),MPI_DOUBLE,mpiOrientXv_proc.getData(),xCnts.data(),xDisp.data(),MPI_DOUBLE,gridComm);
+    }
   }
 
   // For overset meshes, can have an overset face *also* be an MPI face known only to one of the processes
@@ -701,52 +1242,74 @@ void geo::matchMPIFaces(void)
   procR.resize(nMpiFaces);
   faceID_R.resize(nMpiFaces);
   if (nDims == 3) {
-    gIC_R.resize(nMpiFaces);
-    mpiLocF_R.resize(nMpiFaces);
+    mpiFaceNodes_R.setup(nMpiFaces,4);
+    if (anyPeriodic)
+      mpiFaceXv_R.setup(nMpiFaces,12);
   }
   for (auto &P:procR) P = -1;
 
+  // Hash our non-periodic faces by their [global] nodes; periodic faces are
+  // matched by the positions of their nodes, so are compared one by one
+  faceHash myFaces;
+  myFaces.setup(nMpiFaces);
+  vector<int> periodicF;
+  for (int F=0; F<nMpiFaces; F++) {
+    if (mpiPeriodic[F])
+      periodicF.push_back(F);
+    else
+      myFaces.insert(faceHash::makeKey(&mpiFaceNodes[mpiFptr[F]],mpiFptr[F+1]-mpiFptr[F]),F);
+  }
+
   vector<int> tmpFace(maxNodesPerFace);
-  vector<int> myFace(maxNodesPerFace);
+  vector<point> tmpPts, myPts;
   for (int p=0; p<nProcGrid; p++) {
     if (p == gridRank) continue;
 
     // Check all of the processor's faces to see if any match our faces
     for (int i=0; i<nMpiFaces_proc[p]; i++) {
       tmpFace.resize(maxNodesPerFace);
+      tmpPts.resize(0);
       int k = 0;
       for (int j=mpiFptr_proc(p,i); j<mpiFptr_proc(p,i+1); j++) {
         tmpFace[k] = mpiFaceNodes_proc(p,j);
+        if (anyPeriodic)
+          tmpPts.push_back(point(&mpiFaceXv_proc(p,3*j)));
         k++;
       }
       tmpFace.resize(k);
 
-      // See if this face matches any on this processor
-      for (int F=0; F<nMpiFaces; F++) {
-        if (procR[F] != -1) continue; // Face already matched
+      // See if this face matches any on this processor [the first unmatched one]
+      int F = myFaces.find(faceHash::makeKey(tmpFace.data(),k));
+      if (F >= 0 && procR[F] != -1) F = -1; // Face already matched
 
-        for (int j=0; j<f2nv[mpiFaces[F]]; j++) {
-          myFace[j] = mpiFaceNodes[mpiFptr[F]+j];
-        }
+      for (auto FP:periodicF) {
+        if (F >= 0 && FP > F) break;
+        if (procR[FP] != -1) continue;
 
-        bool match;
-        if (mpiPeriodic[F])
-          match = comparePeriodicMPI(myFace,tmpFace);
-        else
-          match = compareFaces(myFace,tmpFace);
-
-        if (match) {
-          procR[F] = p;
-          faceID_R[F] = mpiFid_proc(p,i);
-          if (nDims == 3) {
-            gIC_R[F] = mpiCells_proc(p,i);
-            mpiLocF_R[F] = mpiLocF_proc(p,i);
-          }
-          if (meshType == OVERSET_MESH)
-            mpiIblankR[F] = mpiIblank_proc(p,i);
+        myPts.resize(0);
+        for (int j=mpiFptr[FP]; j<mpiFptr[FP+1]; j++)
+          myPts.push_back(point(&mpiFaceXv[3*j]));
+
+        if (comparePeriodicMPI(myPts,tmpPts)) {
+          F = FP;
           break;
         }
       }
+
+      if (F < 0) continue;
+
+      procR[F] = p;
+      faceID_R[F] = mpiFid_proc(p,i);
+      if (nDims == 3) {
+        for (int j=0; j<4; j++) {
+          mpiFaceNodes_R(F,j) = mpiOrientNodes_proc(p,4*i+j);
+          if (anyPeriodic)
+            for (int dim=0; dim<3; dim++)
+              mpiFaceXv_R(F,3*j+dim) = mpiOrientXv_proc(p,12*i+3*j+dim);
+        }
+      }
+      if (meshType == OVERSET_MESH)
+        mpiIblankR[F] = mpiIblank_proc(p,i);
     }
   }
 
@@ -782,11 +1345,154 @@ void geo::matchMPIFaces(void)
 #endif
 }
 
-void geo::setupElesFaces(input *params, vector<shared_ptr<ele>> &eles, vector<shared_ptr<face>> &faces, vector<shared_ptr<mpiFace>> &mpiFacesVec, vector<shared_ptr<overFace>> &overFacesVec)
+void geo::matchMPIFacesBlocks(void)
 {
-  if (nEles<=0) FatalError("Cannot setup elements array - nEles = 0");
-
-  if (params->rank == 0) {
+#ifndef _NO_MPI
+  if (params->rank == 0)
+    cout << "Geo: Matching MPI faces between mesh blocks" << endl;
+
+  extractMPIFaces();
+
+  int N[3] = {params->nx, params->ny, (nDims == 3) ? params->nz : 1};
+
+  // Structured [i,j,k] indices of a global node ID
+  auto nodeIJK = [&](int ivg, int *ijk) {
+    ijk[0] = ivg % (N[0]+1);
+    ijk[1] = (ivg / (N[0]+1)) % (N[1]+1);
+    ijk[2] = ivg / ((N[0]+1)*(N[1]+1));
+  };
+
+  // Rank owning the cell with the given structured index
+  auto ownerRank = [&](const int *c) {
+    int r[3];
+    for (int d=0; d<3; d++) r[d] = ((long)(c[d]+1)*procDims[d]-1) / N[d];
+    return r[0] + procDims[0]*(r[1] + procDims[1]*r[2]);
+  };
+
+  // 1) Find the neighboring rank & a unique key of each face: its normal
+  //    direction & lowest node [wrapped around periodic boundaries]
+  int nFaceInts = (nDims == 3) ? 7 : 3;  // key [2 ints], face ID [, oriented global nodes]
+  int nFaceDbls = (nDims == 3) ? 12 : 0;  // oriented node positions
+  vector<long long> faceKey(nMpiFaces);
+  map<int,vector<int>> procFaces;  // MPI faces shared with each neighboring rank
+  for (int F=0; F<nMpiFaces; F++) {
+    int ff = mpiFaces[F];
+    int lo[3] = {INT_MAX, INT_MAX, INT_MAX};
+    int hi[3] = {-1, -1, -1};
+    for (int j=0; j<f2nv[ff]; j++) {
+      int ijk[3];
+      nodeIJK(iv2ivg[f2v(ff,j)],ijk);
+      for (int d=0; d<3; d++) {
+        lo[d] = min(lo[d],ijk[d]);
+        hi[d] = max(hi[d],ijk[d]);
+      }
+    }
+
+    int dir = 0;
+    while (dir < nDims-1 && lo[dir] != hi[dir]) dir++;
+
+    int c[3] = {lo[0], lo[1], lo[2]};  // Cell on the other side of the face
+    if (lo[dir] == blockLo[dir])
+      c[dir] = (lo[dir] + N[dir] - 1) % N[dir];
+    else
+      c[dir] = lo[dir] % N[dir];
+
+    int key[3] = {lo[0], lo[1], lo[2]};
+    key[dir] = lo[dir] % N[dir];
+    faceKey[F] = dir + 3*(key[0] + (long long)(N[0]+1)*(key[1] + (long long)(N[1]+1)*key[2]));
+
+    procFaces[ownerRank(c)].push_back(F);
+  }
+
+  // 2) Exchange the faces with each neighboring rank
+  int nNbrs = procFaces.size();
+  vector<int> nbrRank, nSend(nNbrs), nRecv(nNbrs);
+  vector<MPI_Request> reqs(2*nNbrs);
+  int n = 0;
+  for (auto &pf:procFaces) {
+    nbrRank.push_back(pf.first);
+    nSend[n] = pf.second.size();
+    MPI_Irecv(&nRecv[n],1,MPI_INT,pf.first,0,gridComm,&reqs[2*n]);
+    MPI_Isend(&nSend[n],1,MPI_INT,pf.first,0,gridComm,&reqs[2*n+1]);
+    n++;
+  }
+  MPI_Waitall(reqs.size(),reqs.data(),MPI_STATUSES_IGNORE);
+
+  vector<vector<int>> sendInts(nNbrs), recvInts(nNbrs);
+  vector<vector<double>> sendDbls(nNbrs), recvDbls(nNbrs);
+  reqs.resize(4*nNbrs);
+  for (int p=0; p<nNbrs; p++) {
+    for (int F:procFaces[nbrRank[p]]) {
+      int ff = mpiFaces[F];
+      sendInts[p].push_back(faceKey[F] >> 31);
+      sendInts[p].push_back(faceKey[F] & INT_MAX);
+      sendInts[p].push_back(ff);
+      if (nDims == 3) {
+        for (auto iv:getOrientedFaceNodes(f2c(ff,0),mpiLocF[F])) {
+          sendInts[p].push_back(iv2ivg[iv]);
+          for (int dim=0; dim<3; dim++)
+            sendDbls[p].push_back(xv(iv,dim));
+        }
+      }
+    }
+
+    recvInts[p].resize(nRecv[p]*nFaceInts);
+    recvDbls[p].resize(nRecv[p]*nFaceDbls);
+    MPI_Irecv(recvInts[p].data(),recvInts[p].size(),MPI_INT,nbrRank[p],1,gridComm,&reqs[4*p]);
+    MPI_Isend(sendInts[p].data(),sendInts[p].size(),MPI_INT,nbrRank[p],1,gridComm,&reqs[4*p+1]);
+    MPI_Irecv(recvDbls[p].data(),recvDbls[p].size(),MPI_DOUBLE,nbrRank[p],2,gridComm,&reqs[4*p+2]);
+    MPI_Isend(sendDbls[p].data(),sendDbls[p].size(),MPI_DOUBLE,nbrRank[p],2,gridComm,&reqs[4*p+3]);
+  }
+  MPI_Waitall(reqs.size(),reqs.data(),MPI_STATUSES_IGNORE);
+
+  // 3) Match the received faces to ours by their keys
+  procR.assign(nMpiFaces,-1);
+  faceID_R.resize(nMpiFaces);
+  if (nDims == 3) {
+    mpiFaceNodes_R.setup(nMpiFaces,4);
+    mpiFaceXv_R.setup(nMpiFaces,12);
+  }
+
+  for (int p=0; p<nNbrs; p++) {
+    unordered_map<long long,int> myFaces;
+    for (int F:procFaces[nbrRank[p]])
+      myFaces[faceKey[F]] = F;
+
+    for (int i=0; i<nRecv[p]; i++) {
+      int *data = &recvInts[p][i*nFaceInts];
+      auto it = myFaces.find(((long long)data[0] << 31) | data[1]);
+      if (it == myFaces.end())
+        FatalError("MPI face left unmatched!");
+
+      int F = it->second;
+      procR[F] = nbrRank[p];
+      faceID_R[F] = data[2];
+      if (nDims == 3) {
+        for (int j=0; j<4; j++) {
+          mpiFaceNodes_R(F,j) = data[3+j];
+          for (int dim=0; dim<3; dim++)
+            mpiFaceXv_R(F,3*j+dim) = recvDbls[p][12*i+3*j+dim];
+        }
+      }
+    }
+  }
+
+  for (auto &P:procR)
+    if (P==-1) FatalError("MPI face left unmatched!");
+
+  int nFacesTotalGrid;
+  MPI_Allreduce(&nMpiFaces,&nFacesTotalGrid,1,MPI_INT,MPI_SUM,gridComm);
+
+  if (gridRank == 0)
+    cout << "Geo: All MPI faces matched!  nMpiFaces = " << nFacesTotalGrid/2 << endl;
+#endif
+}
+
+void geo::setupElesFaces(input *params, vector<shared_ptr<ele>> &eles, vector<shared_ptr<face>> &faces, vector<shared_ptr<mpiFace>> &mpiFacesVec, vector<shared_ptr<overFace>> &overFacesVec)
+{
+  if (nEles<=0) FatalError("Cannot setup elements array - nEles = 0");
+
+  if (params->rank == 0) {
     cout << "Geo: Setting up elements" << endl;
   }
 
@@ -806,7 +1512,7 @@ void geo::setupElesFaces(input *params, vector<shared_ptr<ele>> &eles, vector<sh
 
     shared_ptr<ele> e = make_shared<ele>();
     e->ID = ic;
-    if (nProcGrid>1)
+    if (nProcGrid>1 || !ic2icg.empty())
       e->IDg = ic2icg[ic];
     else
       e->IDg = ic;
@@ -960,7 +1666,7 @@ void geo::setupElesFaces(input *params, vector<shared_ptr<ele>> &eles, vector<sh
         int relRot = 0;
         if (nDims == 3) {
           // Find the relative orientation (rotation) between left & right faces
-          relRot = compareOrientationMPI(ic,fid1,gIC_R[i],mpiLocF_R[i],mpiPeriodic[i]);
+          relRot = compareOrientationMPI(ic,fid1,i,mpiPeriodic[i]);
         }
         struct faceInfo info;
         info.IDR = faceID_R[i];
@@ -1019,6 +1725,93 @@ void geo::setupElesFaces(input *params, vector<shared_ptr<ele>> &eles, vector<sh
   }
 }
 
+/*! Number of nodes of each supported Gmsh element type [needed to read binary files] */
+static int gmshNodesPerEle(int eType)
+{
+  switch (eType) {
+    case 1:  return 2;   // Linear edge
+    case 2:  return 3;   // Linear triangle
+    case 3:  return 4;   // Linear quad
+    case 4:  return 4;   // Linear tet
+    case 5:  return 8;   // Linear hex
+    case 6:  return 6;   // Linear prism
+    case 8:  return 3;   // Quadratic edge
+    case 9:  return 6;   // Quadratic triangle
+    case 10: return 9;   // Quadratic (Lagrange) quad
+    case 12: return 27;  // Quadratic (Lagrange) hex
+    case 15: return 1;   // Point
+    case 16: return 8;   // Quadratic (Serendipity) quad
+    case 17: return 20;  // Quadratic (Serendipity) hex
+    case 26: return 4;   // Cubic edge
+    case 27: return 5;   // Quartic edge
+    case 28: return 6;   // Quintic edge
+    case 36: return 16;  // Cubic (Lagrange) quad
+    case 37: return 25;  // Quartic (Lagrange) quad
+    case 38: return 36;  // Quintic (Lagrange) quad
+    case 47: return 49;  // 6th-order (Lagrange) quad
+    case 48: return 64;  // 7th-order (Lagrange) quad
+    case 49: return 81;  // 8th-order (Lagrange) quad
+    case 50: return 100; // 9th-order (Lagrange) quad
+    case 51: return 121; // 10th-order (Lagrange) quad
+    case 64: return 9;   // Order 8 edge
+    case 65: return 10;  // Order 9 edge
+    case 66: return 11;  // Order 10 edge
+    default:
+      cout << "Gmsh Element Type = " << eType << endl;
+      FatalError("element type not recognized");
+  }
+
+  return 0;
+}
+
+void geo::addPhysicalName(int bcdim, int bcid, string bcStr)
+{
+  // Remove quotation marks from around boundary condition
+  size_t ind = bcStr.find("\"");
+  while (ind!=string::npos) {
+    bcStr.erase(ind,1);
+    ind = bcStr.find("\"");
+  }
+
+  // Convert to lowercase to match Flurry's boundary condition strings
+  std::transform(bcStr.begin(), bcStr.end(), bcStr.begin(), ::tolower);
+
+  // Keep the mesh's own name, so the partitioned-mesh file can be re-mapped later
+  gmshPhysicalName pName;
+  memset(&pName, 0, sizeof(pName));
+  pName.dim = bcdim;
+  pName.id = bcid;
+  strncpy(pName.name, bcStr.c_str(), sizeof(pName.name)-1);
+  physicalNames.push_back(pName);
+
+  // First, map mesh boundary to boundary condition in input file
+  if (!params->meshBounds.count(bcStr)) {
+    string errS = "Unrecognized mesh boundary: \"" + bcStr + "\"\n";
+    errS += "Boundary names in input file must match those in mesh file.";
+    FatalError(errS.c_str());
+  }
+
+  // Map the Gmsh PhysicalName to the input-file-specified Flurry boundary condition
+  bcStr = params->meshBounds[bcStr];
+
+  // Next, check that the requested boundary condition exists
+  if (!bcStr2Num.count(bcStr)) {
+    string errS = "Unrecognized boundary condition: \"" + bcStr + "\"";
+    FatalError(errS.c_str());
+  }
+
+  if (bcStr.compare("fluid")==0) {
+    nDims = bcdim;
+    params->nDims = bcdim;
+    bcIdMap[bcid] = -1;
+  }
+  else {
+    bcList.push_back(bcStr2Num[bcStr]);
+    bcIdMap[bcid] = nBounds; // Map Gmsh bcid to Flurry bound index
+    nBounds++;
+  }
+}
+
 void geo::readGmsh(string fileName)
 {
   ifstream meshFile;
@@ -1031,20 +1824,51 @@ void geo::readGmsh(string fileName)
     if (gridRank==0) cout << "Geo: Reading mesh file " << fileName << endl;
   }
 
-  meshFile.open(fileName.c_str());
+  meshFile.open(fileName.c_str(), ios::in | ios::binary);
   if (!meshFile.is_open())
     FatalError("Unable to open mesh file.");
 
+  /* --- Read the file format: ASCII or binary --- */
+
+  bool binary = false;
+  while (getline(meshFile,str)) {
+    if (str.find("$MeshFormat")!=string::npos) {
+      double version;
+      int fileType, dataSize;
+      meshFile >> version >> fileType >> dataSize;
+      getline(meshFile,str);  // clear rest of line
+
+      if (version < 2 || version >= 3)
+        FatalError("Only Gmsh mesh format 2.x is supported.");
+
+      if (fileType == 1) {
+        binary = true;
+        if (dataSize != sizeof(double))
+          FatalError("Binary Gmsh file: unsupported data size.");
+
+        // Written as the integer 1, to check the endianness of the file
+        int one;
+        meshFile.read((char*)&one, sizeof(int));
+        if (one != 1)
+          FatalError("Binary Gmsh file was written with a different endianness.");
+        getline(meshFile,str);
+      }
+      break;
+    }
+  }
+
   /* --- Read Boundary Conditions & Fluid Field(s) --- */
 
   // Move cursor to $PhysicalNames
+  meshFile.clear();
+  meshFile.seekg(0, ios::beg);
   while(1) {
     getline(meshFile,str);
     if (str.find("$PhysicalNames")!=string::npos) break;
     if(meshFile.eof()) FatalError("$PhysicalNames tag not found in Gmsh file!");
   }
 
-  // Read number of boundaries and fields defined
+  // Read number of boundaries and fields defined [always ASCII]
   int nBnds;              // Temp. variable for # of Gmsh regions ("PhysicalNames")
   meshFile >> nBnds;
   getline(meshFile,str);  // clear rest of line
@@ -1059,71 +1883,50 @@ void geo::readGmsh(string fileName)
     ss << str;
     ss >> bcdim >> bcid >> bcStr;
 
-    // Remove quotation marks from around boundary condition
-    size_t ind = bcStr.find("\"");
-    while (ind!=string::npos) {
-      bcStr.erase(ind,1);
-      ind = bcStr.find("\"");
-    }
-
-    // Convert to lowercase to match Flurry's boundary condition strings
-    std::transform(bcStr.begin(), bcStr.end(), bcStr.begin(), ::tolower);
-
-    // First, map mesh boundary to boundary condition in input file
-    if (!params->meshBounds.count(bcStr)) {
-      string errS = "Unrecognized mesh boundary: \"" + bcStr + "\"\n";
-      errS += "Boundary names in input file must match those in mesh file.";
-      FatalError(errS.c_str());
-    }
-
-    // Map the Gmsh PhysicalName to the input-file-specified Flurry boundary condition
-    bcStr = params->meshBounds[bcStr];
-
-    // Next, check that the requested boundary condition exists
-    if (!bcStr2Num.count(bcStr)) {
-      string errS = "Unrecognized boundary condition: \"" + bcStr + "\"";
-      FatalError(errS.c_str());
-    }
-
-    if (bcStr.compare("fluid")==0) {
-      nDims = bcdim;
-      params->nDims = bcdim;
-      bcIdMap[bcid] = -1;
-    }
-    else {
-      bcList.push_back(bcStr2Num[bcStr]);
-      bcIdMap[bcid] = nBounds; // Map Gmsh bcid to Flurry bound index
-      nBounds++;
-    }
+    addPhysicalName(bcdim,bcid,bcStr);
   }
 
   /* --- Read Mesh Vertex Locations --- */
 
   // Move cursor to $Nodes
-  meshFile.clear();
-  meshFile.seekg(0, ios::beg);
   while(1) {
     getline(meshFile,str);
     if (str.find("$Nodes")!=string::npos) break;
     if(meshFile.eof()) FatalError("$Nodes tag not found in Gmsh file!");
   }
 
-  uint iv;
   meshFile >> nVerts;
   xv.setup(nVerts,nDims);
   getline(meshFile,str); // Clear end of line, just in case
 
-  for (int i=0; i<nVerts; i++) {
-    meshFile >> iv >> xv(i,0) >> xv(i,1);
-    if (nDims == 3) meshFile >> xv(i,2);
-    getline(meshFile,str);
+  if (binary) {
+    // Records of {node ID [int], x, y, z [double]}
+    const int recSize = sizeof(int) + 3*sizeof(double);
+    vector<char> buf((size_t)nVerts*recSize);
+    meshFile.read(buf.data(), buf.size());
+    if (!meshFile)
+      FatalError("Binary Gmsh file: unexpected end of $Nodes section.");
+
+    for (int i=0; i<nVerts; i++) {
+      double pos[3];
+      memcpy(pos, &buf[(size_t)i*recSize+sizeof(int)], sizeof(pos));
+      for (int dim=0; dim<nDims; dim++)
+        xv(i,dim) = pos[dim];
+    }
+  }
+  else {
+    for (int i=0; i<nVerts; i++) {
+      getline(meshFile,str);
+      char *ptr = &str[0];
+      strtol(ptr,&ptr,10);  // Node ID
+      for (int dim=0; dim<nDims; dim++)
+        xv(i,dim) = strtod(ptr,&ptr);
+    }
   }
 
   /* --- Read Element Connectivity --- */
 
   // Move cursor to $Elements
-  meshFile.clear();
-  meshFile.seekg(0, ios::beg);
   while(1) {
     getline(meshFile,str);
     if (str.find("$Elements")!=string::npos) break;
@@ -1133,11 +1936,6 @@ void geo::readGmsh(string fileName)
   int nElesGmsh;
   vector<int> c2v_tmp(27,0);  // Maximum number of nodes/element possible
   vector<set<int>> boundPoints(nBounds);
-  map<int,int> eType2nv;
-  eType2nv[3] = 4;  // Linear quad
-  eType2nv[16] = 4; // Quadratic serendipity quad
-  eType2nv[10] = 4; // Quadratic Lagrange quad
-  eType2nv[8] = 8;  // Linear hex
 
   nBndPts.resize(nBounds);
 
@@ -1147,297 +1945,463 @@ void geo::readGmsh(string fileName)
 
   // For Gmsh node ordering, see: http://geuz.org/gmsh/doc/texinfo/gmsh.html#Node-ordering
   int ic = 0;
-  for (int k=0; k<nElesGmsh; k++) {
-    int id, eType, nTags, bcid, tmp;
-    meshFile >> id >> eType >> nTags;
-    meshFile >> bcid;
-    bcid = bcIdMap[bcid];
-    for (int tag=0; tag<nTags-1; tag++)
-      meshFile >> tmp;
-
-    if (bcid == -1) {
-      // NOTE: Currently, only quads are supported
-      switch(eType) {
-        case 2:
-          // linear triangle -> linear quad
-          c2nv.push_back(4);
-          c2nf.push_back(4);
-          ctype.push_back(QUAD);
-          meshFile >> c2v_tmp[0] >> c2v_tmp[1] >> c2v_tmp[2];
-          c2v_tmp[3] = c2v_tmp[2];
-          break;
+  int k = 0;
+  vector<int> vals;  // {id, eType, nTags, tags..., nodes...} of one element
+  vector<int> blockVals;
+  while (k < nElesGmsh) {
+    int nBlockEles = 1, eType, nTags, nNodes, recLen;
+
+    if (binary) {
+      // Block header {eType, nEles, nTags}, then records of {id, tags, nodes}
+      int blockHeader[3];
+      meshFile.read((char*)blockHeader, sizeof(blockHeader));
+      if (!meshFile)
+        FatalError("Binary Gmsh file: unexpected end of $Elements section.");
+      eType = blockHeader[0];
+      nBlockEles = blockHeader[1];
+      nTags = blockHeader[2];
+      nNodes = gmshNodesPerEle(eType);
+      recLen = 1 + nTags + nNodes;
+      blockVals.resize((size_t)nBlockEles*recLen);
+      meshFile.read((char*)blockVals.data(), blockVals.size()*sizeof(int));
+      if (!meshFile)
+        FatalError("Binary Gmsh file: unexpected end of $Elements section.");
+    }
+    else {
+      getline(meshFile,str);
+      vals.clear();
+      char *ptr = &str[0];
+      char *end;
+      for (long val = strtol(ptr,&end,10); end != ptr; val = strtol(ptr,&end,10)) {
+        vals.push_back(val);
+        ptr = end;
+      }
+      if (vals.size() < 4)
+        FatalError("Unable to read element in Gmsh file.");
+      eType = vals[1];
+      nTags = vals[2];
+      nNodes = vals.size() - 3 - nTags;
+      recLen = vals.size();
+    }
+
+    for (int n=0; n<nBlockEles; n++, k++) {
+      const int* tags;
+      if (binary)
+        tags = &blockVals[(size_t)n*recLen + 1];
+      else
+        tags = &vals[3];
+      const int* nodes = tags + nTags;
+
+      int bcid = bcIdMap[tags[0]];
+
+      if (bcid == -1) {
+        // NOTE: Currently, only quads & hexes are supported
+        switch(eType) {
+          case 2:
+            // linear triangle -> linear quad
+            c2nv.push_back(4);
+            c2nf.push_back(4);
+            ctype.push_back(QUAD);
+            c2v_tmp[0] = nodes[0];  c2v_tmp[1] = nodes[1];  c2v_tmp[2] = nodes[2];
+            c2v_tmp[3] = c2v_tmp[2];
+            break;
+
+          case 9:
+            // quadratic triangle -> quadratic quad  [corner nodes, then edge-center nodes]
+            c2nv.push_back(8);
+            c2nf.push_back(4);
+            ctype.push_back(QUAD);
+            c2v_tmp[0] = nodes[0];  c2v_tmp[1] = nodes[1];  c2v_tmp[2] = nodes[2];
+            c2v_tmp[4] = nodes[3];  c2v_tmp[5] = nodes[4];  c2v_tmp[7] = nodes[5];
+            c2v_tmp[3] = c2v_tmp[2];
+            c2v_tmp[6] = c2v_tmp[2];
+            break;
+
+          case 3:  // linear quadrangle
+          case 16: // quadratic 8-node (serendipity) quadrangle
+          case 10: // quadratic (9-node Lagrange) quadrangle (read as 8-node serendipity)
+          case 36: // cubic (16-node Lagrange) quadrangle
+          case 37: // quartic (25-node Lagrange) quadrangle
+          case 38: // quintic (36-node Lagrange) quadrangle
+          case 47: // 6th-order 49-node Lagrange quadrangle
+          case 48: // 7th-order 64-node Lagrange quadrangle
+          case 49: // 8th-order 81-node Lagrange quadrangle
+          case 50: // 9th-order 100-node Lagrange quadrangle
+          case 51: // 10th-order 121-node Lagrange quadrangle
+          {
+            int nv = (eType == 10) ? 8 : gmshNodesPerEle(eType);
+            c2nv.push_back(nv);
+            c2nf.push_back(4);
+            ctype.push_back(QUAD);
+            if ((int)c2v_tmp.size() < nv) c2v_tmp.resize(nv);
+            for (int i=0; i<nv; i++) c2v_tmp[i] = nodes[i];
+            break;
+          }
 
-        case 9:
-          // quadratic triangle -> quadratic quad  [corner nodes, then edge-center nodes]
-          c2nv.push_back(8);
-          c2nf.push_back(4);
-          ctype.push_back(QUAD);
-          meshFile >> c2v_tmp[0] >> c2v_tmp[1] >> c2v_tmp[2] >> c2v_tmp[4] >> c2v_tmp[5] >> c2v_tmp[7];
-          c2v_tmp[3] = c2v_tmp[2];
-          c2v_tmp[6] = c2v_tmp[2];
-          break;
+          case 5:
+            // Linear hexahedron
+            c2nv.push_back(8);
+            c2nf.push_back(6);
+            ctype.push_back(HEX);
+            for (int i=0; i<8; i++) c2v_tmp[i] = nodes[i];
+            break;
+
+          case 17: // Quadratic (20-Node Serendipity) Hexahedron
+          case 12: // Quadratic (27-Node Lagrange) Hexahedron (read as 20-node serendipity)
+          {
+            c2nv.push_back(20);
+            c2nf.push_back(6);
+            ctype.push_back(HEX);
+            // Corner Nodes, then Edge Nodes
+            const int edgeNodes[12] = {8, 11, 12, 9, 13, 10, 14, 15, 16, 19, 17, 18};
+            for (int i=0; i<8; i++) c2v_tmp[i] = nodes[i];
+            for (int i=0; i<12; i++) c2v_tmp[edgeNodes[i]] = nodes[8+i];
+            break;
+          }
 
-        case 3:
-          // linear quadrangle
-          c2nv.push_back(4);
-          c2nf.push_back(4);
-          ctype.push_back(QUAD);
-          meshFile >> c2v_tmp[0] >> c2v_tmp[1] >> c2v_tmp[2] >> c2v_tmp[3];
-          break;
+          case 4:
+            // Linear tetrahedron; read as collapsed-face hex
+            c2nv.push_back(4);
+            c2nf.push_back(4);
+            ctype.push_back(HEX);
+            c2v_tmp[0] = nodes[0];  c2v_tmp[1] = nodes[1];  c2v_tmp[2] = nodes[2];  c2v_tmp[4] = nodes[3];
+            c2v_tmp[3] = 2;
+            c2v_tmp[5] = c2v_tmp[4];
+            c2v_tmp[6] = c2v_tmp[4];
+            break;
+
+          case 6:
+            // Linear prism; read as collapsed-face hex
+            c2nv.push_back(8);
+            c2nf.push_back(6);
+            ctype.push_back(HEX);
+            c2v_tmp[0] = nodes[0];  c2v_tmp[1] = nodes[1];  c2v_tmp[2] = nodes[2];
+            c2v_tmp[4] = nodes[3];  c2v_tmp[5] = nodes[4];  c2v_tmp[6] = nodes[5];
+            c2v_tmp[3] = c2v_tmp[2];
+            c2v_tmp[7] = c2v_tmp[6];
+            break;
+
+          default:
+            cout << "Gmsh element ID " << k << ", Gmsh Element Type = " << eType << endl;
+            FatalError("element type not recognized");
+            break;
+        }
 
-        case 16:
-          // quadratic 8-node (serendipity) quadrangle
-          c2nv.push_back(8);
-          c2nf.push_back(4);
-          ctype.push_back(QUAD);
-          meshFile >> c2v_tmp[0] >> c2v_tmp[1] >> c2v_tmp[2] >> c2v_tmp[3] >> c2v_tmp[4] >> c2v_tmp[5] >> c2v_tmp[6] >> c2v_tmp[7];
-          break;
+        if (nNodes < gmshNodesPerEle(eType))
+          FatalError("Gmsh element has too few nodes.");
 
-        case 10:
-          // quadratic (9-node Lagrange) quadrangle (read as 8-node serendipity)
-          c2nv.push_back(8);
-          c2nf.push_back(4);
-          ctype.push_back(QUAD);
-          meshFile >> c2v_tmp[0] >> c2v_tmp[1] >> c2v_tmp[2] >> c2v_tmp[3] >> c2v_tmp[4] >> c2v_tmp[5] >> c2v_tmp[6] >> c2v_tmp[7];
-          break;
+        // Increase the size of c2v (max # of vertices per cell) if needed
+        if (c2v.getDim1()<(uint)c2nv[ic]) {
+          for (int dim=c2v.getDim1(); dim<c2nv[ic]; dim++) {
+            c2v.addCol();
+          }
+        }
 
-        case 36:
-          // cubic (16-node Lagrange) quadrangle
-          c2nv.push_back(16);
-          c2nf.push_back(4);
-          ctype.push_back(QUAD);
-          for (int i = 0; i < 16; i++) meshFile >> c2v_tmp[i];
-          break;
+        // Number of nodes in c2v_tmp may vary, so use pointer rather than vector
+        c2v.insertRow(c2v_tmp.data(),-1,c2nv[ic]);
 
-        case 37:
-          // quartic (25-node Lagrange) quadrangle
-          c2nv.push_back(25);
-          c2nf.push_back(4);
-          ctype.push_back(QUAD);
-          for (int i = 0; i < 25; i++) meshFile >> c2v_tmp[i];
-          break;
+        // Shift every value of c2v by -1 (Gmsh is 1-indexed; we need 0-indexed)
+        for(int j=0; j<c2nv[ic]; j++) {
+          if(c2v(ic,j)!=0) {
+            c2v(ic,j)--;
+          }
+        }
 
-        case 38:
-          // quintic (36-node Lagrange) quadrangle
-          c2nv.push_back(36);
-          c2v_tmp.resize(36);
-          c2nf.push_back(4);
-          ctype.push_back(QUAD);
-          for (int i = 0; i < 36; i++) meshFile >> c2v_tmp[i];
-          break;
+        ic++;
+      }
+      else {
+        // Boundary cell; put vertices into bndPts
+        int nPtsFace = 0;
+        switch(eType) {
+          case 1:  // Linear edge
+          case 2:  // Linear triangle
+          case 3:  // Linear quad
+          case 8:  // Quadratic edge
+          case 26: // Cubic Edge
+          case 27: // Quartic Edge
+          case 28: // Quintic Edge
+          case 64: // Order 8
+          case 65: // Order 9
+          case 66: // Order 10
+            nPtsFace = gmshNodesPerEle(eType);
+            break;
+
+          case 10: // Quadratic (Lagrange) quad
+          case 16: // Quadratic (Serendipity) quad
+            nPtsFace = 4;
+            break;
+
+          default:
+            cout << "Gmsh element ID " << k << ", Gmsh Element Type = " << eType << endl;
+            FatalError("Boundary Element (Face) Type Not Recognized!");
+        }
 
-        case 47:
-          // 6th-order 49-node Lagrange quadrangle
-          c2nv.push_back(49);
-          c2v_tmp.resize(49);
-          c2nf.push_back(4);
-          ctype.push_back(QUAD);
-          for (int i = 0; i < 49; i++) meshFile >> c2v_tmp[i];
-          break;
+        for (int i=0; i<nPtsFace; i++)
+          boundPoints[bcid].insert(nodes[i]-1);
+      }
+    }
+  } // End of loop over entities
 
-        case 48:
-          // 7th-order 64-node Lagrange quadrangle
-          c2nv.push_back(64);
-          c2v_tmp.resize(64);
-          c2nf.push_back(4);
-          ctype.push_back(QUAD);
-          for (int i = 0; i < 64; i++) meshFile >> c2v_tmp[i];
-          break;
+  nNodesPerCell = getMax(c2nv);
 
-        case 49:
-          // 8th-order 81-node Lagrange quadrangle
-          c2nv.push_back(81);
-          c2v_tmp.resize(81);
-          c2nf.push_back(4);
-          ctype.push_back(QUAD);
-          for (int i = 0; i < 81; i++) meshFile >> c2v_tmp[i];
-          break;
+  int maxNBndPts = 0;
+  for (int i=0; i<nBounds; i++) {
+    nBndPts[i] = boundPoints[i].size();
+    maxNBndPts = max(maxNBndPts,nBndPts[i]);
+  }
 
-        case 50:
-          // 9th-order 100-node Lagrange quadrangle
-          c2nv.push_back(100);
-          c2v_tmp.resize(100);
-          c2nf.push_back(4);
-          ctype.push_back(QUAD);
-          for (int i = 0; i < 100; i++) meshFile >> c2v_tmp[i];
-          break;
+  // Copy temp boundPoints data into bndPts matrix
+  bndPts.setup(nBounds,maxNBndPts);
+  for (int i=0; i<nBounds; i++) {
+    int j = 0;
+    for (auto& it:boundPoints[i]) {
+      bndPts(i,j) = it;
+      j++;
+    }
+  }
 
-        case 51:
-          // 10th-order 121-node Lagrange quadrangle
-          c2nv.push_back(121);
-          c2v_tmp.resize(121);
-          c2nf.push_back(4);
-          ctype.push_back(QUAD);
-          for (int i = 0; i < 121; i++) meshFile >> c2v_tmp[i];
-          break;
+  nEles = c2v.getDim0();
 
-        case 5:
-          // Linear hexahedron
-          c2nv.push_back(8);
-          c2nf.push_back(6);
-          ctype.push_back(HEX);
-          meshFile >> c2v_tmp[0] >> c2v_tmp[1] >> c2v_tmp[2] >> c2v_tmp[3] >> c2v_tmp[4] >> c2v_tmp[5] >> c2v_tmp[6] >> c2v_tmp[7];
-          break;
+  meshFile.close();
+}
 
-        case 17:
-          // Quadratic (20-Node Serendipity) Hexahedron
-          c2nv.push_back(20);
-          c2nf.push_back(6);
-          ctype.push_back(HEX);
-          // Corner Nodes
-          meshFile >> c2v_tmp[0] >> c2v_tmp[1] >> c2v_tmp[2] >> c2v_tmp[3] >> c2v_tmp[4] >> c2v_tmp[5] >> c2v_tmp[6] >> c2v_tmp[7];
-          // Edge Nodes
-          meshFile >> c2v_tmp[8] >> c2v_tmp[11] >> c2v_tmp[12] >> c2v_tmp[9] >> c2v_tmp[13] >> c2v_tmp[10];
-          meshFile >> c2v_tmp[14] >> c2v_tmp[15] >> c2v_tmp[16] >> c2v_tmp[19] >> c2v_tmp[17] >> c2v_tmp[18];
-          break;
+void geo::readPartMesh(string fileName)
+{
+  if (gridRank==0) cout << "Geo: Reading partitioned mesh file " << fileName << endl;
 
-        case 12:
-          // Quadratic (27-Node Lagrange) Hexahedron (read as 20-node serendipity)
-          c2nv.push_back(20);
-          c2nf.push_back(6);
-          ctype.push_back(HEX);
-          c2v_tmp.resize(20);
-          // Corner Nodes
-          meshFile >> c2v_tmp[0] >> c2v_tmp[1] >> c2v_tmp[2] >> c2v_tmp[3] >> c2v_tmp[4] >> c2v_tmp[5] >> c2v_tmp[6] >> c2v_tmp[7];
-          // Edge Nodes
-          meshFile >> c2v_tmp[8] >> c2v_tmp[11] >> c2v_tmp[12] >> c2v_tmp[9] >> c2v_tmp[13] >> c2v_tmp[10];
-          meshFile >> c2v_tmp[14] >> c2v_tmp[15] >> c2v_tmp[16] >> c2v_tmp[19] >> c2v_tmp[17] >> c2v_tmp[18];
-          break;
+  /* --- Read the header & this rank's own partition --- */
+  meshPartHeader header;
+  vector<gmshPhysicalName> names;
+  int64_t table[2];  // offset, nBytes
+  vector<char> buf;
 
-        case 4:
-          // Linear tetrahedron; read as collapsed-face hex
-          c2nv.push_back(4);
-          c2nf.push_back(4);
-          ctype.push_back(HEX);
-          meshFile >> c2v_tmp[0] >> c2v_tmp[1] >> c2v_tmp[2] >> c2v_tmp[4];
-          c2v_tmp[3] = 2;
-          c2v_tmp[5] = c2v_tmp[4];
-          c2v_tmp[6] = c2v_tmp[4];
-          c2v_tmp[6] = c2v_tmp[4];
-          break;
+#ifndef _NO_MPI
+  gridComm = MPI_COMM_WORLD;
 
-        case 6:
-          // Linear prism; read as collapsed-face hex
-          c2nv.push_back(8);
-          c2nf.push_back(6);
-          ctype.push_back(HEX);
-          meshFile >> c2v_tmp[0] >> c2v_tmp[1] >> c2v_tmp[2] >> c2v_tmp[4] >> c2v_tmp[5] >> c2v_tmp[6];
-          c2v_tmp[3] = c2v_tmp[2];
-          c2v_tmp[7] = c2v_tmp[6];
-          break;
+  MPI_File fh;
+  if (MPI_File_open(MPI_COMM_WORLD, &fileName[0], MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS)
+    FatalError("Unable to open mesh file.");
 
-        default:
-          cout << "Gmsh element ID " << k << ", Gmsh Element Type = " << eType << endl;
-          FatalError("element type not recognized");
-          break;
-      }
+  MPI_File_read_at_all(fh, 0, &header, sizeof(header), MPI_BYTE, MPI_STATUS_IGNORE);
+  if (strncmp(header.magic, "FLURRYPM", 8) != 0 || header.version != 1)
+    FatalError("Not a Flurry partitioned mesh file.");
+  if (header.nParts != nproc)
+    FatalError("Partitioned mesh file was written for a different number of ranks.");
 
-      // Increase the size of c2v (max # of vertices per cell) if needed
-      if (c2v.getDim1()<(uint)c2nv[ic]) {
-        for (int dim=c2v.getDim1(); dim<c2nv[ic]; dim++) {
-          c2v.addCol();
-        }
-      }
+  names.resize(header.nNames);
+  MPI_File_read_at_all(fh, sizeof(header), names.data(), names.size()*sizeof(gmshPhysicalName), MPI_BYTE, MPI_STATUS_IGNORE);
 
-      // Number of nodes in c2v_tmp may vary, so use pointer rather than vector
-      c2v.insertRow(c2v_tmp.data(),-1,c2nv[ic]);
+  int64_t tableOffset = sizeof(header) + names.size()*sizeof(gmshPhysicalName);
+  MPI_File_read_at_all(fh, tableOffset + 2*rank*sizeof(int64_t), table, sizeof(table), MPI_BYTE, MPI_STATUS_IGNORE);
 
-      // Shift every value of c2v by -1 (Gmsh is 1-indexed; we need 0-indexed)
-      for(int k=0; k<c2nv[ic]; k++) {
-        if(c2v(ic,k)!=0) {
-          c2v(ic,k)--;
-        }
-      }
+  if (table[1] > INT_MAX)
+    FatalError("Mesh partition exceeds 2GB; use more ranks.");
 
-      ic++;
-      getline(meshFile,str); // skip end of line
-    }
-    else {
-      // Boundary cell; put vertices into bndPts
-      int nPtsFace = 0;
-      switch(eType) {
-        case 1: // Linear edge
-          nPtsFace = 2;
-          break;
+  buf.resize(table[1]);
+  MPI_File_read_at_all(fh, table[0], buf.data(), (int)table[1], MPI_BYTE, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+#else
+  ifstream meshFile(fileName.c_str(), ios::in | ios::binary);
+  if (!meshFile.is_open())
+    FatalError("Unable to open mesh file.");
 
-        case 2: // Linear triangle
-          nPtsFace = 3;
-          break;
+  meshFile.read((char*)&header, sizeof(header));
+  if (strncmp(header.magic, "FLURRYPM", 8) != 0 || header.version != 1)
+    FatalError("Not a Flurry partitioned mesh file.");
+  if (header.nParts != 1)
+    FatalError("Partitioned mesh file was written for a different number of ranks.");
+
+  names.resize(header.nNames);
+  meshFile.read((char*)names.data(), names.size()*sizeof(gmshPhysicalName));
+  meshFile.read((char*)table, sizeof(table));
+
+  buf.resize(table[1]);
+  meshFile.seekg(table[0], ios::beg);
+  meshFile.read(buf.data(), buf.size());
+  if (!meshFile)
+    FatalError("Partitioned mesh file is truncated.");
+  meshFile.close();
+#endif
 
-        case 3: // Linear quad
-          nPtsFace = 4;
-          break;
+  /* --- Boundary conditions [re-mapped using the current input file] --- */
+  nBounds = 0;
+  for (auto &pName:names)
+    addPhysicalName(pName.dim, pName.id, string(pName.name));
+
+  if (nDims != header.nDims || nBounds != header.nBounds)
+    FatalError("Partitioned mesh file: fluid region / boundaries not mapped consistently.");
+
+  nEles_g = header.nEles_g;
+  nVerts_g = header.nVerts_g;
+
+  /* --- Unpack the partition --- */
+  const char *ptr = buf.data();
+  auto unpack = [&](void *dest, size_t nBytes) {
+    if (ptr + nBytes > buf.data() + buf.size())
+      FatalError("Partitioned mesh file is truncated.");
+    memcpy(dest, ptr, nBytes);
+    ptr += nBytes;
+  };
+
+  int info[5];  // nEles, nVerts, nNodesPerCell, nCols [c2v], maxNBndPts
+  unpack(info, sizeof(info));
+  nEles = info[0];
+  nVerts = info[1];
+  nNodesPerCell = info[2];
+  int nCols = info[3];
+  int maxNBndPts = info[4];
+
+  ctype.resize(nEles);
+  c2nv.resize(nEles);
+  c2nf.resize(nEles);
+  ic2icg.resize(nEles);
+  c2v.setup(nEles,nCols);
+  unpack(ctype.data(), nEles*sizeof(int));
+  unpack(c2nv.data(), nEles*sizeof(int));
+  unpack(c2nf.data(), nEles*sizeof(int));
+  unpack(ic2icg.data(), nEles*sizeof(int));
+  unpack(c2v.getData(), (size_t)nEles*nCols*sizeof(int));
+
+  iv2ivg.resize(nVerts);
+  xv.setup(nVerts,nDims);
+  unpack(iv2ivg.data(), nVerts*sizeof(int));
+  unpack(xv.getData(), (size_t)nVerts*nDims*sizeof(double));
 
-        case 10: // Quadratic (Lagrange) quad
-          nPtsFace = 4;
-          break;
+  nBndPts.resize(nBounds);
+  bndPts.setup(nBounds,maxNBndPts);
+  unpack(nBndPts.data(), nBounds*sizeof(int));
+  unpack(bndPts.getData(), (size_t)nBounds*maxNBndPts*sizeof(int));
 
-        case 16: // Quadratic (Serendipity) quad
-          nPtsFace = 4;
-          break;
+  if (meshType == OVERSET_MESH)
+    cout << "Geo:   Grid " << gridID << " on rank " << rank << ": nEles = " << nEles << endl;
+  else
+    cout << "Geo:   On rank " << rank << ": nEles = " << nEles << endl;
+}
 
-        case 8: // Quadratic edge
-          nPtsFace = 3;
-          break;
+void geo::writePartMesh(input *params)
+{
+  this->params = params;
 
-        case 26: // Cubic Edge
-          nPtsFace = 4;
-          break;
+  nDims = params->nDims;
+  nFields = params->nFields;
+  meshType = params->meshType;
+  gridID = 0;
+  gridRank = params->rank;
+  nProcGrid = params->nproc;
+  rank = params->rank;
+  nproc = params->nproc;
 
-        case 27: // Quartic Edge
-          nPtsFace = 5;
-          break;
+  if (meshType != READ_MESH)
+    FatalError("Partitioned mesh files can only be written for a single Gmsh mesh [meshType 0].");
 
-        case 28: // Quintic Edge
-          nPtsFace = 6;
-          break;
+  if (isPartMeshFile(params->meshFileName))
+    FatalError("Mesh file is already partitioned.");
 
-        case 64: // Order 8
-          nPtsFace = 9;
-          break;
+  readGmsh(params->meshFileName);
 
-        case 65: // Order 9
-          nPtsFace = 10;
-          break;
+#ifndef _NO_MPI
+  partitionMesh();
+#endif
 
-        case 66: // Order 10
-          nPtsFace = 11;
-          break;
+  if (nproc <= 1) {
+    // Single partition: local IDs are the global IDs
+    nEles_g = nEles;
+    nVerts_g = nVerts;
+    ic2icg.resize(nEles);
+    iv2ivg.resize(nVerts);
+    for (int ic=0; ic<nEles; ic++) ic2icg[ic] = ic;
+    for (int iv=0; iv<nVerts; iv++) iv2ivg[iv] = iv;
+  }
+
+  for (auto &pName:physicalNames)
+    if (strlen(pName.name) >= sizeof(pName.name)-1)
+      FatalError("Gmsh PhysicalName is too long for a partitioned mesh file.");
+
+  /* --- Pack this rank's partition --- */
+  int nCols = c2v.getDim1();
+  int maxNBndPts = bndPts.getDim1();
+  int info[5] = {nEles, nVerts, nNodesPerCell, nCols, maxNBndPts};
+
+  int64_t nBytes = sizeof(info) + (4*(int64_t)nEles + (int64_t)nEles*nCols + nVerts + nBounds
+                                   + (int64_t)nBounds*maxNBndPts)*sizeof(int) + (int64_t)nVerts*nDims*sizeof(double);
+
+  vector<char> buf(nBytes);
+  char *ptr = buf.data();
+  auto pack = [&](const void *src, size_t n) {
+    if (n > 0) memcpy(ptr, src, n);
+    ptr += n;
+  };
+
+  pack(info, sizeof(info));
+  pack(ctype.data(), nEles*sizeof(int));
+  pack(c2nv.data(), nEles*sizeof(int));
+  pack(c2nf.data(), nEles*sizeof(int));
+  pack(ic2icg.data(), nEles*sizeof(int));
+  pack(c2v.getData(), (size_t)nEles*nCols*sizeof(int));
+  pack(iv2ivg.data(), nVerts*sizeof(int));
+  pack(xv.getData(), (size_t)nVerts*nDims*sizeof(double));
+  pack(nBndPts.data(), nBounds*sizeof(int));
+  pack(bndPts.getData(), (size_t)nBounds*maxNBndPts*sizeof(int));
+
+  /* --- Header, PhysicalNames & partition table --- */
+  meshPartHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, "FLURRYPM", 8);
+  header.version = 1;
+  header.nDims = nDims;
+  header.nParts = nproc;
+  header.nNames = physicalNames.size();
+  header.nBounds = nBounds;
+  header.nEles_g = nEles_g;
+  header.nVerts_g = nVerts_g;
+
+  vector<int64_t> allBytes(nproc);
+#ifndef _NO_MPI
+  MPI_Allgather(&nBytes, 1, MPI_INT64_T, allBytes.data(), 1, MPI_INT64_T, MPI_COMM_WORLD);
+#else
+  allBytes[0] = nBytes;
+#endif
 
-        default:
-          cout << "Gmsh element ID " << k << ", Gmsh Element Type = " << eType << endl;
-          FatalError("Boundary Element (Face) Type Not Recognized!");
-      }
+  vector<int64_t> table(2*nproc);
+  int64_t offset = sizeof(header) + physicalNames.size()*sizeof(gmshPhysicalName) + table.size()*sizeof(int64_t);
+  for (int p=0; p<nproc; p++) {
+    table[2*p+0] = offset;
+    table[2*p+1] = allBytes[p];
+    offset += allBytes[p];
+  }
 
-      for (int i=0; i<nPtsFace; i++) {
-        meshFile >> iv;  iv--;
-        boundPoints[bcid].insert(iv);
-      }
-      getline(meshFile,str);
-    }
-  } // End of loop over entities
+  string fileName = params->partMeshFile;
 
-  nNodesPerCell = getMax(c2nv);
+#ifndef _NO_MPI
+  if (nBytes > INT_MAX)
+    FatalError("Mesh partition exceeds 2GB; use more ranks.");
 
-  int maxNBndPts = 0;
-  for (int i=0; i<nBounds; i++) {
-    nBndPts[i] = boundPoints[i].size();
-    maxNBndPts = max(maxNBndPts,nBndPts[i]);
-  }
+  MPI_File fh;
+  if (MPI_File_open(MPI_COMM_WORLD, &fileName[0], MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS)
+    FatalError("Unable to open partitioned mesh file for writing.");
+  MPI_File_set_size(fh, 0);
 
-  // Copy temp boundPoints data into bndPts matrix
-  bndPts.setup(nBounds,maxNBndPts);
-  for (int i=0; i<nBounds; i++) {
-    int j = 0;
-    for (auto& it:boundPoints[i]) {
-      bndPts(i,j) = it;
-      j++;
-    }
+  if (rank == 0) {
+    MPI_File_write_at(fh, 0, &header, sizeof(header), MPI_BYTE, MPI_STATUS_IGNORE);
+    MPI_File_write_at(fh, sizeof(header), physicalNames.data(), physicalNames.size()*sizeof(gmshPhysicalName), MPI_BYTE, MPI_STATUS_IGNORE);
+    MPI_File_write_at(fh, table[0] - table.size()*sizeof(int64_t), table.data(), table.size()*sizeof(int64_t), MPI_BYTE, MPI_STATUS_IGNORE);
   }
 
-  nEles = c2v.getDim0();
+  MPI_File_write_at_all(fh, table[2*rank], buf.data(), (int)nBytes, MPI_BYTE, MPI_STATUS_IGNORE);
+  MPI_File_close(&fh);
+#else
+  ofstream meshFile(fileName.c_str(), ios::binary | ios::trunc);
+  if (!meshFile.is_open())
+    FatalError("Unable to open partitioned mesh file for writing.");
 
+  meshFile.write((char*)&header, sizeof(header));
+  meshFile.write((char*)physicalNames.data(), physicalNames.size()*sizeof(gmshPhysicalName));
+  meshFile.write((char*)table.data(), table.size()*sizeof(int64_t));
+  meshFile.write(buf.data(), nBytes);
   meshFile.close();
+#endif
+
+  if (rank == 0) cout << "Geo: Wrote partitioned mesh file " << fileName << " [" << nproc << " partition(s)]" << endl;
 }
 
 void geo::createMesh()
@@ -1702,29 +2666,214 @@ void geo::createMesh()
     }
     nFacesPerBnd[ib] = nf;
 
-    // Front Side Faces (y = ymax)
-    ib = bc2bcList[bcStr2Num[params->create_bcFront]];
-    nf = nFacesPerBnd[ib];
-    for (int iz=0; iz<nz; iz++) {
-      for (int ix=0; ix<nx; ix++) {
-        bndPts(ib,4*nf)   = iz*(nx+1)*(ny+1) + ny*(nx+1) + ix;
-        bndPts(ib,4*nf+1) = (iz+1)*(nx+1)*(ny+1) + ny*(nx+1) + ix;
-        bndPts(ib,4*nf+2) = (iz+1)*(nx+1)*(ny+1) + ny*(nx+1) + ix + 1;
-        bndPts(ib,4*nf+3) = iz*(nx+1)*(ny+1) + ny*(nx+1) + ix + 1;
-        nf++;
+    // Front Side Faces (y = ymax)
+    ib = bc2bcList[bcStr2Num[params->create_bcFront]];
+    nf = nFacesPerBnd[ib];
+    for (int iz=0; iz<nz; iz++) {
+      for (int ix=0; ix<nx; ix++) {
+        bndPts(ib,4*nf)   = iz*(nx+1)*(ny+1) + ny*(nx+1) + ix;
+        bndPts(ib,4*nf+1) = (iz+1)*(nx+1)*(ny+1) + ny*(nx+1) + ix;
+        bndPts(ib,4*nf+2) = (iz+1)*(nx+1)*(ny+1) + ny*(nx+1) + ix + 1;
+        bndPts(ib,4*nf+3) = iz*(nx+1)*(ny+1) + ny*(nx+1) + ix + 1;
+        nf++;
+      }
+    }
+    nFacesPerBnd[ib] = nf;
+  }
+
+  // Remove duplicates in bndPts
+  for (int i=0; i<nBounds; i++) {
+    std::sort(bndPts[i], bndPts[i]+bndPts.dims[1]);
+    int* it = std::unique(bndPts[i], bndPts[i]+bndPts.dims[1]);
+    nBndPts[i] = std::distance(bndPts[i],it);
+  }
+  int maxNBndPts = getMax(nBndPts);
+  bndPts.removeCols(bndPts.dims[1]-maxNBndPts);
+}
+
+void geo::createMeshBlock()
+{
+#ifndef _NO_MPI
+  gridComm = MPI_COMM_WORLD;
+#endif
+
+  nDims = params->nDims;
+  int N[3] = {params->nx, params->ny, (nDims == 3) ? params->nz : 1};
+
+  /* --- Split the cells into a px x py [x pz] grid of blocks --- */
+
+  // Choose the factorization of nproc with the least total interface area
+  long bestArea = -1;
+  for (int px=1; px<=nproc; px++) {
+    if (nproc%px) continue;
+    for (int py=1; py<=nproc/px; py++) {
+      if ((nproc/px)%py) continue;
+      int pz = nproc/(px*py);
+      if (px > N[0] || py > N[1] || pz > N[2]) continue;
+
+      long area = (long)(px-1)*N[1]*N[2] + (long)(py-1)*N[0]*N[2] + (long)(pz-1)*N[0]*N[1];
+      if (bestArea < 0 || area < bestArea) {
+        bestArea = area;
+        procDims[0] = px;  procDims[1] = py;  procDims[2] = pz;
+      }
+    }
+  }
+
+  if (bestArea < 0)
+    FatalError("distributedMesh: Cannot split the mesh into one block per rank; use fewer ranks.");
+
+  int rIdx[3];
+  rIdx[0] = rank % procDims[0];
+  rIdx[1] = (rank / procDims[0]) % procDims[1];
+  rIdx[2] = rank / (procDims[0]*procDims[1]);
+
+  int M[3];  // # of cells in this block in each direction
+  for (int d=0; d<3; d++) {
+    blockLo[d] = (long)rIdx[d]*N[d]/procDims[d];
+    blockHi[d] = (long)(rIdx[d]+1)*N[d]/procDims[d];
+    M[d] = blockHi[d] - blockLo[d];
+  }
+
+  if (rank == 0) {
+    cout << "Geo: Creating " << N[0] << "x" << N[1] << "x" << N[2] << " cartesian mesh in ";
+    cout << procDims[0] << "x" << procDims[1] << "x" << procDims[2] << " blocks" << endl;
+  }
+
+  double xmin[3] = {params->xmin, params->ymin, params->zmin};
+  double xmax[3] = {params->xmax, params->ymax, params->zmax};
+  double dx[3];
+  for (int d=0; d<3; d++) dx[d] = (xmax[d]-xmin[d])/N[d];
+
+  params->periodicDX = xmax[0]-xmin[0];
+  params->periodicDY = xmax[1]-xmin[1];
+  params->periodicDZ = xmax[2]-xmin[2];
+
+  nEles_g = N[0]*N[1]*N[2];
+  nVerts_g = (N[0]+1)*(N[1]+1)*((nDims == 3) ? N[2]+1 : 1);
+  nEles = M[0]*M[1]*M[2];
+  nVerts = (M[0]+1)*(M[1]+1)*((nDims == 3) ? M[2]+1 : 1);
+
+  /* --- Setup Vertices [global IDs as in createMesh] --- */
+
+  int kMax = (nDims == 3) ? M[2] : 0;
+  xv.setup(nVerts,nDims);
+  iv2ivg.resize(nVerts);
+  int nv = 0;
+  for (int k=0; k<=kMax; k++) {
+    for (int j=0; j<=M[1]; j++) {
+      for (int i=0; i<=M[0]; i++) {
+        int ijk[3] = {blockLo[0]+i, blockLo[1]+j, blockLo[2]+k};
+        for (int d=0; d<nDims; d++)
+          xv(nv,d) = xmin[d] + ijk[d]*dx[d];
+        iv2ivg[nv] = ijk[0] + (N[0]+1)*(ijk[1] + (N[1]+1)*ijk[2]);
+        nv++;
+      }
+    }
+  }
+
+  // Local vertex ID from block-local indices
+  auto iv = [&](int i, int j, int k) { return i + (M[0]+1)*(j + (M[1]+1)*k); };
+
+  /* --- Setup Elements [same order & global IDs as createMesh] --- */
+
+  vector<int> c2v_tmp;
+  if (nDims == 2) {
+    c2nv.assign(nEles,4);
+    c2nf.assign(nEles,4);
+    ctype.assign(nEles,QUAD);
+    c2v_tmp.assign(4,0);
+
+    for (int i=0; i<M[0]; i++) {
+      for (int j=0; j<M[1]; j++) {
+        c2v_tmp[0] = iv(i,  j,  0);
+        c2v_tmp[1] = iv(i+1,j,  0);
+        c2v_tmp[2] = iv(i+1,j+1,0);
+        c2v_tmp[3] = iv(i,  j+1,0);
+        c2v.insertRow(c2v_tmp);
+        ic2icg.push_back((blockLo[0]+i)*N[1] + blockLo[1]+j);
+      }
+    }
+  }
+  else {
+    c2nv.assign(nEles,8);
+    c2nf.assign(nEles,6);
+    ctype.assign(nEles,HEX);
+    c2v_tmp.assign(8,0);
+
+    for (int k=0; k<M[2]; k++) {
+      for (int i=0; i<M[0]; i++) {
+        for (int j=0; j<M[1]; j++) {
+          c2v_tmp[0] = iv(i,  j,  k);
+          c2v_tmp[1] = iv(i+1,j,  k);
+          c2v_tmp[2] = iv(i+1,j+1,k);
+          c2v_tmp[3] = iv(i,  j+1,k);
+          c2v_tmp[4] = iv(i,  j,  k+1);
+          c2v_tmp[5] = iv(i+1,j,  k+1);
+          c2v_tmp[6] = iv(i+1,j+1,k+1);
+          c2v_tmp[7] = iv(i,  j+1,k+1);
+          c2v.insertRow(c2v_tmp);
+          ic2icg.push_back(blockLo[1]+j + N[1]*(blockLo[0]+i + N[0]*(blockLo[2]+k)));
+        }
+      }
+    }
+  }
+
+  /* --- Setup Boundaries --- */
+
+  // Boundary condition on the min / max side in each direction
+  string sideBC[3][2] = {{params->create_bcLeft, params->create_bcRight},
+                         {params->create_bcBottom, params->create_bcTop},
+                         {"", ""}};
+  if (nDims == 3) {
+    sideBC[1][0] = params->create_bcBack;    sideBC[1][1] = params->create_bcFront;
+    sideBC[2][0] = params->create_bcBottom;  sideBC[2][1] = params->create_bcTop;
+  }
+
+  for (int d=0; d<nDims; d++)
+    for (int s=0; s<2; s++)
+      bcList.push_back(bcStr2Num[sideBC[d][s]]);
+
+  std::sort(bcList.begin(), bcList.end());
+  bcList.erase(std::unique(bcList.begin(), bcList.end()), bcList.end());
+  nBounds = bcList.size();
+
+  map<int,int> bc2bcList;
+  for (int i=0; i<nBounds; i++)
+    bc2bcList[bcList[i]] = i;
+
+  // Nodes of this block lying on each side of the domain
+  vector<set<int>> boundPoints(nBounds);
+  for (int k=0; k<=kMax; k++) {
+    for (int j=0; j<=M[1]; j++) {
+      for (int i=0; i<=M[0]; i++) {
+        int ijk[3] = {blockLo[0]+i, blockLo[1]+j, blockLo[2]+k};
+        for (int d=0; d<nDims; d++) {
+          if (ijk[d] == 0)
+            boundPoints[bc2bcList[bcStr2Num[sideBC[d][0]]]].insert(iv(i,j,k));
+          if (ijk[d] == N[d])
+            boundPoints[bc2bcList[bcStr2Num[sideBC[d][1]]]].insert(iv(i,j,k));
+        }
       }
     }
-    nFacesPerBnd[ib] = nf;
   }
 
-  // Remove duplicates in bndPts
+  nFacesPerBnd.assign(nBounds,0);
+  nBndPts.resize(nBounds);
+  int maxNBndPts = 0;
   for (int i=0; i<nBounds; i++) {
-    std::sort(bndPts[i], bndPts[i]+bndPts.dims[1]);
-    int* it = std::unique(bndPts[i], bndPts[i]+bndPts.dims[1]);
-    nBndPts[i] = std::distance(bndPts[i],it);
+    nBndPts[i] = boundPoints[i].size();
+    maxNBndPts = max(maxNBndPts,nBndPts[i]);
   }
-  int maxNBndPts = getMax(nBndPts);
-  bndPts.removeCols(bndPts.dims[1]-maxNBndPts);
+
+  // Pad with -1 [matchBoundaryFaces looks at the full rows]
+  bndPts.setup(nBounds,maxNBndPts);
+  for (int i=0; i<nBounds; i++) {
+    int j = 0;
+    for (auto &it:boundPoints[i]) bndPts(i,j++) = it;
+    for (; j<maxNBndPts; j++) bndPts(i,j) = -1;
+  }
+
+  cout << "Geo:   On rank " << rank << ": nEles = " << nEles << endl;
 }
 
 void geo::processPeriodicBoundaries(void)
@@ -1744,57 +2893,148 @@ void geo::processPeriodicBoundaries(void)
   if (nPeriodic%2 != 0 && nProcGrid==1) FatalError("Expecting even number of periodic faces; have odd number.");
   if (params->rank==0) cout << "Geo: Processing periodic boundaries" << endl;
 
-  int nUnmatched = 0;
+  /* --- Spatial hash of the faces' centroids: a face's periodic partner lies
+   * near one of the images of its centroid, offset by {dx,dy,dz} [2D], or by
+   * {dx,dy,dz} weighted by the face normal [3D, see checkPeriodicFaces3D] --- */
 
-  for (auto& i:iPeriodic) {
-    if (bndFaces[i]==-10) continue;
-    bool match = false;
-    for (auto& j:iPeriodic) {
-      if (i==j || bndFaces[i]==-10 || bndFaces[j]==-10) continue;
+  double tol = params->periodicTol;
+  double dxyz[3] = {params->periodicDX, params->periodicDY, params->periodicDZ};
+  int nv = (nDims == 2) ? 2 : f2v.dims[1];
+
+  vector<point> cent(nPeriodic), norm(nPeriodic);
+  double h = 2*tol;
+  for (uint k=0; k<nPeriodic; k++) {
+    int ff = bndFaces[iPeriodic[k]];
+    point minPt(INFINITY,INFINITY,INFINITY), maxPt(-INFINITY,-INFINITY,-INFINITY);
+    for (int j=0; j<nv; j++) {
+      point pt = point(xv[f2v(ff,j)],nDims);
+      cent[k] += pt;
+      for (int dim=0; dim<nDims; dim++) {
+        minPt[dim] = min(minPt[dim],pt[dim]);
+        maxPt[dim] = max(maxPt[dim],pt[dim]);
+      }
+    }
+    cent[k] /= nv;
+    for (int dim=0; dim<nDims; dim++)
+      h = max(h,maxPt[dim]-minPt[dim]);
+
+    if (nDims == 3) {
+      Vec3 vec1 = point(xv[f2v(ff,1)]) - point(xv[f2v(ff,0)]);
+      Vec3 vec2 = point(xv[f2v(ff,2)]) - point(xv[f2v(ff,0)]);
+      norm[k] = vec1.cross(vec2);
+      norm[k] /= norm[k].norm();
+    }
+  }
+
+  auto cellKey = [&](long long ix, long long iy, long long iz) {
+    return (unsigned long long)(ix*73856093LL ^ iy*19349663LL ^ iz*83492791LL);
+  };
+
+  unordered_map<unsigned long long,vector<int>> cells;
+  for (uint k=0; k<nPeriodic; k++)
+    cells[cellKey(floor(cent[k].x/h),floor(cent[k].y/h),floor(cent[k].z/h))].push_back(k);
+
+  // Matching partners of each face [indices into iPeriodic, ascending]
+  vector<vector<int>> partners(nPeriodic);
+#pragma omp parallel for schedule(dynamic,64)
+  for (uint k=0; k<nPeriodic; k++) {
+    vector<point> images;
+    if (nDims == 2) {
+      for (int dim=0; dim<2; dim++) {
+        for (int sgn=-1; sgn<=1; sgn+=2) {
+          point img = cent[k];
+          img[dim] += sgn*dxyz[dim];
+          images.push_back(img);
+        }
+      }
+    }
+    else {
+      for (int sx=-1; sx<=1; sx+=2)
+        for (int sy=-1; sy<=1; sy+=2)
+          for (int sz=-1; sz<=1; sz+=2)
+            images.push_back(cent[k] + point(sx*abs(norm[k].x)*dxyz[0], sy*abs(norm[k].y)*dxyz[1], sz*abs(norm[k].z)*dxyz[2]));
+    }
+
+    vector<int> cand;
+    int nk = (nDims == 3) ? 1 : 0;
+    for (auto &img:images) {
+      long long ix = floor(img.x/h), iy = floor(img.y/h), iz = floor(img.z/h);
+      for (int i=-1; i<=1; i++) {
+        for (int j=-1; j<=1; j++) {
+          for (int l=-nk; l<=nk; l++) {
+            auto it = cells.find(cellKey(ix+i,iy+j,iz+l));
+            if (it != cells.end())
+              cand.insert(cand.end(),it->second.begin(),it->second.end());
+          }
+        }
+      }
+    }
+    std::sort(cand.begin(),cand.end());
+    cand.erase(std::unique(cand.begin(),cand.end()),cand.end());
+
+    int bi = bndFaces[iPeriodic[k]];
+    for (auto c:cand) {
+      if (c == (int)k) continue;
+      int bj = bndFaces[iPeriodic[c]];
+      bool match;
       if (nDims == 2) {
-        match = checkPeriodicFaces(f2v[bndFaces[i]],f2v[bndFaces[j]]);
+        match = checkPeriodicFaces(f2v[bi],f2v[bj]);
       }
       else {
-        auto face1 = f2v.getRow(bndFaces[i]);
-        auto face2 = f2v.getRow(bndFaces[j]);
+        auto face1 = f2v.getRow(bi);
+        auto face2 = f2v.getRow(bj);
         match = checkPeriodicFaces3D(face1, face2);
       }
-      if (match) {
+      if (match)
+        partners[k].push_back(c);
+    }
+  }
 
-        /* --- Match found - now take care of transfer from boundary -> internal --- */
+  int nUnmatched = 0;
 
-        if (i>j) FatalError("How did this happen?!");
+  for (uint k=0; k<nPeriodic; k++) {
+    int i = iPeriodic[k];
+    if (bndFaces[i]==-10) continue;
+    bool match = false;
+    for (auto c:partners[k]) {
+      int j = iPeriodic[c];
+      if (bndFaces[j]==-10) continue;
 
-        bi = bndFaces[i];
-        bj = bndFaces[j];
+      /* --- Match found - now take care of transfer from boundary -> internal --- */
 
-        // Transfer combined edge from boundary to internal list
-        intFaces.push_back(bi);
+      match = true;
 
-        // Flag global edge IDs as internal faces
-        faceType[bi] = INTERNAL;
-        faceType[bj] = INTERNAL;
+      if (i>j) FatalError("How did this happen?!");
 
-        // Fix f2c - add right cell to combined face, make left cell = -1 in 'deleted' face
-        f2c(bi,1) = f2c(bj,0);
-        f2c(bj,0) = -1;
+      bi = bndFaces[i];
+      bj = bndFaces[j];
 
-        // Fix c2f - replace 'deleted' edge from right cell with combined face
-        ic = f2c[bi][1];
-        int fID = findFirst(c2f[ic],(int)bj,c2nf[ic]);
-        c2f(f2c(bi,1),fID) = bi;
+      // Transfer combined edge from boundary to internal list
+      intFaces.push_back(bi);
 
-        // Fix c2b - set element-local face to be internal face
-        c2b(f2c(bi,1),fID) = false;
+      // Flag global edge IDs as internal faces
+      faceType[bi] = INTERNAL;
+      faceType[bj] = INTERNAL;
 
-        // Flag edges as gone in boundary edges list
-        bndFaces[i] = -10;
-        bndFaces[j] = -10;
-        bcType[i] = -10;
-        bcType[j] = -10;
+      // Fix f2c - add right cell to combined face, make left cell = -1 in 'deleted' face
+      f2c(bi,1) = f2c(bj,0);
+      f2c(bj,0) = -1;
 
-        break;
-      }
+      // Fix c2f - replace 'deleted' edge from right cell with combined face
+      ic = f2c[bi][1];
+      int fID = findFirst(c2f[ic],(int)bj,c2nf[ic]);
+      c2f(f2c(bi,1),fID) = bi;
+
+      // Fix c2b - set element-local face to be internal face
+      c2b(f2c(bi,1),fID) = false;
+
+      // Flag edges as gone in boundary edges list
+      bndFaces[i] = -10;
+      bndFaces[j] = -10;
+      bcType[i] = -10;
+      bcType[j] = -10;
+
+      break;
     }
 
     if (!match)
@@ -1814,22 +3054,6 @@ void geo::processPeriodicBoundaries(void)
 #endif
 }
 
-bool geo::compareFaces(vector<int> &face1, vector<int> &face2)
-{
-  uint nv = face1.size();
-  if (face2.size() != nv) return false;
-
-  std::sort(face1.begin(),face1.end());
-  std::sort(face2.begin(),face2.end());
-
-  bool found = true;
-  for (uint i=0; i<nv; i++) {
-    if (face1[i] != face2[i]) found = false;
-  }
-
-  return found;
-}
-
 bool geo::checkPeriodicFaces(int* edge1, int* edge2)
 {
   double x11, x12, y11, y12, x21, x22, y21, y22;
@@ -1934,14 +3158,14 @@ bool geo::checkPeriodicFaces3D(vector<int> &face1, vector<int> &face2)
   return true;
 }
 
-bool geo::comparePeriodicMPI(vector<int> &face1, vector<int> &face2)
+bool geo::comparePeriodicMPI(vector<point> &face1, vector<point> &face2)
 {
   if (nDims == 2) {
     double x11, x12, y11, y12, x21, x22, y21, y22;
-    x11 = xv_g(face1[0],0);  y11 = xv_g(face1[0],1);
-    x12 = xv_g(face1[1],0);  y12 = xv_g(face1[1],1);
-    x21 = xv_g(face2[0],0);  y21 = xv_g(face2[0],1);
-    x22 = xv_g(face2[1],0);  y22 = xv_g(face2[1],1);
+    x11 = face1[0].x;  y11 = face1[0].y;
+    x12 = face1[1].x;  y12 = face1[1].y;
+    x21 = face2[0].x;  y21 = face2[0].y;
+    x22 = face2[1].x;  y22 = face2[1].y;
 
     double tol = params->periodicTol;
     double dx = params->periodicDX;
@@ -1984,10 +3208,10 @@ bool geo::comparePeriodicMPI(vector<int> &face1, vector<int> &face2)
     // Calculate face normal & centriod for face 1
     Vec3 norm1;
     point c1;
-    vec1 = point(xv_g[face1[1]]) - point(xv_g[face1[0]]);
-    vec2 = point(xv_g[face1[2]]) - point(xv_g[face1[0]]);
+    vec1 = face1[1] - face1[0];
+    vec2 = face1[2] - face1[0];
     for (uint j=0; j<face1.size(); j++)
-      c1 += xv_g[face1[j]];
+      c1 += face1[j];
     c1 /= face1.size();
 
     norm1[0] = vec1[1]*vec2[2] - vec1[2]*vec2[1];
@@ -2000,10 +3224,10 @@ bool geo::comparePeriodicMPI(vector<int> &face1, vector<int> &face2)
     // Calculate face normal & centroid for face 2
     Vec3 norm2;
     point c2;
-    vec1 = point(xv_g[face2[1]]) - point(xv_g[face2[0]]);
-    vec2 = point(xv_g[face2[2]]) - point(xv_g[face2[0]]);
+    vec1 = face2[1] - face2[0];
+    vec2 = face2[2] - face2[0];
     for (uint j=0; j<face2.size(); j++)
-      c2 += point(xv_g[face2[j]]);
+      c2 += face2[j];
     c2 /= face2.size();
     norm2[0] = vec1[1]*vec2[2] - vec1[2]*vec2[1];
     norm2[1] = vec1[2]*vec2[0] - vec1[0]*vec2[2];
@@ -2187,148 +3411,67 @@ int geo::compareOrientation(int ic1, int f1, int ic2, int f2)
 
 }
 
-int geo::compareOrientationMPI(int ic1, int f1, int ic2, int f2, int isPeriodic=0)
+vector<int> geo::getOrientedFaceNodes(int ic, int f)
 {
-  if (nDims == 2) return 1;
-
-  int nv = f2nv[c2f(ic1,f1)];
-
-  vector<int> tmpFace1(nv), tmpFace2(nv);
+  vector<int> nodes(4);
 
-  int icg = ic2icg[ic1];
-  switch (ctype[ic1]) {
-    case HEX:
+  switch (ctype[ic]) {
+    case HEX: {
       // Flux points arranged in 2D grid on each face oriented with each
       // dimension increasing in its +'ve direction ['btm-left' to 'top-right']
       // Node ordering reflects this: CCW from 'bottom-left' node on each face
-      switch (f1) {
-        case 0:
-          // Bottom face  (z = -1)
-          tmpFace1[0] = c2v_g(icg,0);
-          tmpFace1[1] = c2v_g(icg,1);
-          tmpFace1[2] = c2v_g(icg,2);
-          tmpFace1[3] = c2v_g(icg,3);
-          break;
-        case 1:
-          // Top face  (z = +1)
-          tmpFace1[0] = c2v_g(icg,5);
-          tmpFace1[1] = c2v_g(icg,4);
-          tmpFace1[2] = c2v_g(icg,7);
-          tmpFace1[3] = c2v_g(icg,6);
-          break;
-        case 2:
-          // Left face  (x = -1)
-          tmpFace1[0] = c2v_g(icg,0);
-          tmpFace1[1] = c2v_g(icg,3);
-          tmpFace1[2] = c2v_g(icg,7);
-          tmpFace1[3] = c2v_g(icg,4);
-          break;
-        case 3:
-          // Right face  (x = +1)
-          tmpFace1[0] = c2v_g(icg,2);
-          tmpFace1[1] = c2v_g(icg,1);
-          tmpFace1[2] = c2v_g(icg,5);
-          tmpFace1[3] = c2v_g(icg,6);
-          break;
-        case 4:
-          // Front face  (y = -1)
-          tmpFace1[0] = c2v_g(icg,1);
-          tmpFace1[1] = c2v_g(icg,0);
-          tmpFace1[2] = c2v_g(icg,4);
-          tmpFace1[3] = c2v_g(icg,5);
-          break;
-        case 5:
-          // Back face  (y = +1)
-          tmpFace1[0] = c2v_g(icg,3);
-          tmpFace1[1] = c2v_g(icg,2);
-          tmpFace1[2] = c2v_g(icg,6);
-          tmpFace1[3] = c2v_g(icg,7);
-          break;
-      }
+      for (int i=0; i<4; i++)
+        nodes[i] = c2v(ic,hexFaceNodes[f][i]);
       break;
+    }
 
     default:
       FatalError("Element type not supported.");
       break;
   }
 
-  switch (ctype_g[ic2]) {
-    case HEX:
-      switch (f2) {
-        case 0:
-          // Bottom face  (z = -1)
-          tmpFace2[0] = c2v_g(ic2,0);
-          tmpFace2[1] = c2v_g(ic2,1);
-          tmpFace2[2] = c2v_g(ic2,2);
-          tmpFace2[3] = c2v_g(ic2,3);
-          break;
-        case 1:
-          // Top face  (z = +1)
-          tmpFace2[0] = c2v_g(ic2,5);
-          tmpFace2[1] = c2v_g(ic2,4);
-          tmpFace2[2] = c2v_g(ic2,7);
-          tmpFace2[3] = c2v_g(ic2,6);
-          break;
-        case 2:
-          // Left face  (x = -1)
-          tmpFace2[0] = c2v_g(ic2,0);
-          tmpFace2[1] = c2v_g(ic2,3);
-          tmpFace2[2] = c2v_g(ic2,7);
-          tmpFace2[3] = c2v_g(ic2,4);
-          break;
-        case 3:
-          // Right face  (x = +1)
-          tmpFace2[0] = c2v_g(ic2,2);
-          tmpFace2[1] = c2v_g(ic2,1);
-          tmpFace2[2] = c2v_g(ic2,5);
-          tmpFace2[3] = c2v_g(ic2,6);
-          break;
-        case 4:
-          // Front face  (y = -1)
-          tmpFace2[0] = c2v_g(ic2,1);
-          tmpFace2[1] = c2v_g(ic2,0);
-          tmpFace2[2] = c2v_g(ic2,4);
-          tmpFace2[3] = c2v_g(ic2,5);
-          break;
-        case 5:
-          // Back face  (y = +1)
-          tmpFace2[0] = c2v_g(ic2,3);
-          tmpFace2[1] = c2v_g(ic2,2);
-          tmpFace2[2] = c2v_g(ic2,6);
-          tmpFace2[3] = c2v_g(ic2,7);
-          break;
-      }
-      break;
+  return nodes;
+}
 
-    default:
-      FatalError("Element type not supported.");
-      break;
+int geo::compareOrientationMPI(int ic1, int f1, int F, int isPeriodic)
+{
+  if (nDims == 2) return 1;
+
+  // Left face: from this cell [converted to global node IDs]
+  // Right face: as oriented in the right cell, received while matching MPI faces
+  vector<int> tmpFace1 = getOrientedFaceNodes(ic1,f1);
+  vector<int> tmpFace2(mpiFaceNodes_R[F],mpiFaceNodes_R[F]+4);
+
+  vector<point> pts1(4), pts2(4);
+  if (isPeriodic) {
+    for (int i=0; i<4; i++) {
+      pts1[i] = point(xv[tmpFace1[i]]);
+      pts2[i] = point(&mpiFaceXv_R(F,3*i));
+    }
   }
 
+  for (auto &iv:tmpFace1) iv = iv2ivg[iv];
+
   // Now, compare the two faces to see the relative orientation [rotation]
   if      (tmpFace1[0] == tmpFace2[0]) return 0;
   else if (tmpFace1[1] == tmpFace2[0]) return 1;
   else if (tmpFace1[2] == tmpFace2[0]) return 2;
   else if (tmpFace1[3] == tmpFace2[0]) return 3;
   else if (isPeriodic) {
-    if (!comparePeriodicMPI(tmpFace1,tmpFace2))
+    if (!comparePeriodicMPI(pts1,pts2))
       FatalError("Periodic MPI faces improperly matched.");
 
     point c1, c2;
-    for (auto iv:tmpFace1) c1 += point(xv_g[iv]);
-    for (auto iv:tmpFace2) c2 += point(xv_g[iv]);
-    c1 /= tmpFace1.size();
-    c2 /= tmpFace2.size();
+    for (auto &pt:pts1) c1 += pt;
+    for (auto &pt:pts2) c2 += pt;
+    c1 /= pts1.size();
+    c2 /= pts2.size();
     Vec3 fDist = c2 - c1;
     fDist /= sqrt(fDist*fDist); // Normalize
 
-    point pt1;
-    point pt2 = point(xv_g[tmpFace2[0]]);
-
     for (int i=0; i<4; i++) {
-      pt1 = point(xv_g[tmpFace1[i]]);
-      Vec3 ptDist = pt2 - pt1;        // Vector between points
-      ptDist /= sqrt(ptDist*ptDist); // Normalize
+      Vec3 ptDist = pts2[0] - pts1[i]; // Vector between points
+      ptDist /= sqrt(ptDist*ptDist);   // Normalize
 
       double dot = fDist*ptDist;
       if (abs(1-abs(dot))<params->periodicTol) return i; // These points align
@@ -2338,34 +3481,69 @@ int geo::compareOrientationMPI(int ic1, int f1, int ic2, int f2, int isPeriodic=
   }
   else FatalError("MPI faces improperly matched.");
 
+  return 0;
 }
 
-void geo::partitionMesh(void)
+void geo::getEleWeights(vector<int> &weights)
 {
-#ifndef _NO_MPI
+  weights.clear();
+  if (!params->partWeights) return;
 
-  if (nproc <= 1) {
-    gridComm = MPI_COMM_WORLD;
-    return;
-  }
+  weights.assign(nEles,1);
 
-  if (meshType == OVERSET_MESH) {
-    // Partitioning each grid independantly; local 'grid rank' is the important rank
-    rank = gridRank;
-    nproc = nProcGrid;
+  // Mark the nodes lying on any boundary
+  vector<char> isBndPt(nVerts,0);
+  for (int i=0; i<nBounds; i++)
+    for (int j=0; j<nBndPts[i]; j++)
+      isBndPt[bndPts(i,j)] = 1;
 
-    if (nproc <= 1) return; // No additional partitioning needed
+  int nPts1D = params->order+1;
+  for (int ic=0; ic<nEles; ic++) {
+    int nSpts, nFptsPerFace;
+    vector<vector<int>> faces;
+    switch (ctype[ic]) {
+      case QUAD:
+        nSpts = nPts1D*nPts1D;
+        nFptsPerFace = nPts1D;
+        for (int f=0; f<4; f++)
+          faces.push_back({c2v(ic,f),c2v(ic,(f+1)%4)});
+        break;
 
-    if (rank == 0) cout << "Geo: Partitioning mesh block " << gridID << " across " << nProcGrid << " processes" << endl;
-    if (rank == 0) cout << "Geo:   Number of elements in block " << gridID << " : " << nEles << endl;
-  }
-  else {
-    if (rank == 0) cout << "Geo: Partitioning mesh across " << nproc << " processes" << endl;
-    if (rank == 0) cout << "Geo:   Number of elements globally: " << nEles << endl;
+      case HEX:
+        nSpts = nPts1D*nPts1D*nPts1D;
+        nFptsPerFace = nPts1D*nPts1D;
+        for (int f=0; f<6; f++) {
+          faces.push_back(vector<int>(4));
+          for (int j=0; j<4; j++)
+            faces[f][j] = c2v(ic,hexFaceNodes[f][j]);
+        }
+        break;
 
-    gridComm = MPI_COMM_WORLD;
+      default:
+        FatalError("Element type not supported.");
+    }
+
+    // Interior-face work is shared by the two cells on the face, but a cell
+    // owns all the work on its boundary faces [flux + boundary condition]
+    int nFaces = 0, nBndFaces = 0;
+    for (auto &face:faces) {
+      std::sort(face.begin(),face.end());
+      if (std::unique(face.begin(),face.end()) - face.begin() < nDims)
+        continue; // Collapsed face
+      nFaces++;
+
+      bool onBound = true;
+      for (auto iv:face) onBound = onBound && isBndPt[iv];
+      if (onBound) nBndFaces++;
+    }
+
+    weights[ic] = 2*nSpts + (nFaces + nBndFaces)*nFptsPerFace;
   }
+}
 
+#ifndef _NO_MPI
+void geo::computePartitions(vector<int> &weights)
+{
   vector<idx_t> eptr(nEles+1);
   vector<idx_t> eind;
 
@@ -2383,17 +3561,56 @@ void geo::partitionMesh(void)
     eptr[i+1] = nn;
   }
 
-  int objval;
-  epart.resize(nEles);
-  vector<int> npart(nVerts);
+  idx_t *vwgt = (weights.empty()) ? NULL : weights.data();
 
-  // int errVal = METIS PartMeshDual(idx_t *ne, idx_t *nn, idx_t *eptr, idx_t *eind, idx_t *vwgt, idx_t *vsize,
-  // idx_t *ncommon, idx_t *nparts, real_t *tpwgts, idx_t *options, idx_t *objval,idx_t *epart, idx_t *npart)
+  epart.resize(nEles);
 
   int ncommon; // 2 for 2D, ~3 for 3D [#nodes per face: 2 for quad/tri, 3 for tet, 4 for hex]
   if (nDims == 2) ncommon = 2;
   else if (nDims == 3) ncommon = 4;
 
+#ifdef _PARMETIS
+  /* --- Distributed partitioning: each rank hands ParMETIS a contiguous slice of the elements --- */
+  vector<idx_t> elmdist(nproc+1);
+  for (int p=0; p<=nproc; p++)
+    elmdist[p] = (idx_t)((int64_t)nEles*p/nproc);
+
+  int ic0 = elmdist[rank];
+  int nElesLocal = elmdist[rank+1] - ic0;
+
+  vector<idx_t> eptrLocal(nElesLocal+1);
+  for (int i=0; i<=nElesLocal; i++)
+    eptrLocal[i] = eptr[ic0+i] - eptr[ic0];
+  vector<idx_t> eindLocal(eind.begin()+eptr[ic0], eind.begin()+eptr[ic0+nElesLocal]);
+
+  idx_t wgtflag = (vwgt) ? 2 : 0;  // Element weights only
+  idx_t numflag = 0;
+  idx_t ncon = 1;
+  vector<real_t> tpwgts(nproc, 1./nproc);
+  real_t ubvec = 1.05;
+  idx_t options[3] = {0,0,0};
+  idx_t edgecut;
+  vector<idx_t> epartLocal(nElesLocal);
+  MPI_Comm comm = gridComm;
+
+  ParMETIS_V3_PartMeshKway(elmdist.data(),eptrLocal.data(),eindLocal.data(),(vwgt) ? vwgt+ic0 : NULL,
+                           &wgtflag,&numflag,&ncon,&ncommon,&nproc,tpwgts.data(),&ubvec,options,
+                           &edgecut,epartLocal.data(),&comm);
+
+  // Every rank still holds the full mesh here, so collect the full partition
+  vector<int> recvCnts(nproc), recvDisp(nproc);
+  for (int p=0; p<nproc; p++) {
+    recvCnts[p] = elmdist[p+1] - elmdist[p];
+    recvDisp[p] = elmdist[p];
+  }
+  MPI_Allgatherv(epartLocal.data(),nElesLocal,MPI_INT,epart.data(),recvCnts.data(),recvDisp.data(),MPI_INT,gridComm);
+#else
+  int objval;
+  vector<int> npart(nVerts);
+
+  // int errVal = METIS PartMeshDual(idx_t *ne, idx_t *nn, idx_t *eptr, idx_t *eind, idx_t *vwgt, idx_t *vsize,
+  // idx_t *ncommon, idx_t *nparts, real_t *tpwgts, idx_t *options, idx_t *objval,idx_t *epart, idx_t *npart)
+
   idx_t options[METIS_NOPTIONS];
   METIS_SetDefaultOptions(options);
   options[METIS_OPTION_NUMBERING] = 0;
@@ -2402,8 +3619,52 @@ void geo::partitionMesh(void)
   options[METIS_OPTION_PTYPE] = METIS_PTYPE_KWAY;
   options[METIS_OPTION_NCUTS] = 5;  // Allows better partitioning (less cuts) to be found [at negligible expense for CFD grids]
 
-  METIS_PartMeshDual(&nEles,&nVerts,eptr.data(),eind.data(),NULL,NULL,
+  METIS_PartMeshDual(&nEles,&nVerts,eptr.data(),eind.data(),vwgt,NULL,
                      &ncommon,&nproc,NULL,options,&objval,epart.data(),npart.data());
+#endif
+
+  if (vwgt && rank == 0) {
+    vector<double> partWeight(nproc,0.);
+    for (int ic=0; ic<nEles; ic++)
+      partWeight[epart[ic]] += weights[ic];
+    double avgWeight = 0;
+    for (auto &w:partWeight) avgWeight += w/nproc;
+    cout << "Geo:   Estimated load imbalance (max/avg weight) = " << getMax(partWeight)/avgWeight << endl;
+  }
+}
+#else
+void geo::computePartitions(vector<int> &/*weights*/) {}
+#endif
+
+void geo::partitionMesh(void)
+{
+#ifndef _NO_MPI
+
+  if (nproc <= 1) {
+    gridComm = MPI_COMM_WORLD;
+    return;
+  }
+
+  if (meshType == OVERSET_MESH) {
+    // Partitioning each grid independantly; local 'grid rank' is the important rank
+    rank = gridRank;
+    nproc = nProcGrid;
+
+    if (nproc <= 1) return; // No additional partitioning needed
+
+    if (rank == 0) cout << "Geo: Partitioning mesh block " << gridID << " across " << nProcGrid << " processes" << endl;
+    if (rank == 0) cout << "Geo:   Number of elements in block " << gridID << " : " << nEles << endl;
+  }
+  else {
+    if (rank == 0) cout << "Geo: Partitioning mesh across " << nproc << " processes" << endl;
+    if (rank == 0) cout << "Geo:   Number of elements globally: " << nEles << endl;
+
+    gridComm = MPI_COMM_WORLD;
+  }
+
+  vector<int> weights;
+  getEleWeights(weights);
+  computePartitions(weights);
 
   // Copy data to the global arrays & reset local arrays
   nEles_g   = nEles;
@@ -2518,44 +3779,9 @@ void geo::getMpiPartitions(void)
     gridComm = MPI_COMM_WORLD;
   }
 
-  vector<idx_t> eptr(nEles+1);
-  vector<idx_t> eind;
-
-  int nn = 0;
-  for (int i=0; i<nEles; i++) {
-    eind.push_back(c2v(i,0));
-    nn++;
-    for (int j=1; j<c2nv[i]; j++) {
-      if (c2v(i,j)==c2v(i,j-1)) {
-        continue; // To deal with collapsed edges
-      }
-      eind.push_back(c2v(i,j));
-      nn++;
-    }
-    eptr[i+1] = nn;
-  }
-
-  int objval;
-  epart.resize(nEles);
-  vector<int> npart(nVerts);
-
-  // int errVal = METIS PartMeshDual(idx_t *ne, idx_t *nn, idx_t *eptr, idx_t *eind, idx_t *vwgt, idx_t *vsize,
-  // idx_t *ncommon, idx_t *nparts, real_t *tpwgts, idx_t *options, idx_t *objval,idx_t *epart, idx_t *npart)
-
-  int ncommon; // 2 for 2D, ~3 for 3D [#nodes per face: 2 for quad/tri, 3 for tet, 4 for hex]
-  if (nDims == 2) ncommon = 2;
-  else if (nDims == 3) ncommon = 4;
-
-  idx_t options[METIS_NOPTIONS];
-  METIS_SetDefaultOptions(options);
-  options[METIS_OPTION_NUMBERING] = 0;
-  options[METIS_OPTION_IPTYPE] = METIS_IPTYPE_NODE;
-  options[METIS_OPTION_OBJTYPE] = METIS_OBJTYPE_CUT; // Reduces # of final MPI faces
-  options[METIS_OPTION_PTYPE] = METIS_PTYPE_KWAY;
-  options[METIS_OPTION_NCUTS] = 5;  // Allows better partitioning (less cuts) to be found [at negligible expense for CFD grids]
-
-  METIS_PartMeshDual(&nEles,&nVerts,eptr.data(),eind.data(),NULL,NULL,
-                     &ncommon,&nproc,NULL,options,&objval,epart.data(),npart.data());
+  vector<int> weights;
+  getEleWeights(weights);
+  computePartitions(weights);
 #endif
 }
 
@@ -2723,22 +3949,53 @@ void geo::moveMesh(double rkVal)
       }
       break;
     }
-    case 4: {
-      /// Rigid oscillation in a circle
+    case 4:
+    case 5: {
+      /// Rigid oscillation in a circle [4], plus rotation about the z-axis [5]
       if (gridID==0) {
         double Ax = params->moveAx; // Amplitude  (m)
         double Ay = params->moveAy; // Amplitude  (m)
         double fx = params->moveFx; // Frequency  (Hz)
         double fy = params->moveFy; // Frequency  (Hz)
+        rigidOffset.x = Ax*sin(2.*pi*fx*rkTime);
+        rigidOffset.y = Ay*(1-cos(2.*pi*fy*rkTime));
+        rigidVel.x = 2.*pi*fx*Ax*cos(2.*pi*fx*rkTime);
+        rigidVel.y = 2.*pi*fy*Ay*sin(2.*pi*fy*rkTime);
+
+        if (params->motion == 5) {
+          /// Constant spin plus pitching oscillation
+          double theta = params->rotOmega*rkTime + params->pitchAmp*sin(2.*pi*params->pitchFreq*rkTime);
+          rotOmega = params->rotOmega + 2.*pi*params->pitchFreq*params->pitchAmp*cos(2.*pi*params->pitchFreq*rkTime);
+          rotMat(0,0) = cos(theta);  rotMat(0,1) =-sin(theta);
+          rotMat(1,0) = sin(theta);  rotMat(1,1) = cos(theta);
+        }
+
+        #pragma omp parallel for
         for (int iv=0; iv<nVerts; iv++) {
-          xv(iv,0) = xv0[iv].x + Ax*sin(2.*pi*fx*rkTime);
-          //xv(iv,1) = xv0[iv].y + Ay*sin(2.*pi*fy*rkTime);
-          xv(iv,1) = xv0[iv].y + Ay*(1-cos(2.*pi*fy*rkTime));
-          gridVel(iv,0) = 2.*pi*fx*Ax*cos(2.*pi*fx*rkTime);
-          //gridVel(iv,1) = 2.*pi*fy*Ay*cos(2.*pi*fy*rkTime);
-          gridVel(iv,1) = 2.*pi*fy*Ay*sin(2.*pi*fy*rkTime);
+          double dx = xv0[iv].x - rotCenter.x;
+          double dy = xv0[iv].y - rotCenter.y;
+          double rx = rotMat(0,0)*dx + rotMat(0,1)*dy;
+          double ry = rotMat(1,0)*dx + rotMat(1,1)*dy;
+          xv(iv,0) = rotCenter.x + rx + rigidOffset.x;
+          xv(iv,1) = rotCenter.y + ry + rigidOffset.y;
+          gridVel(iv,0) = rigidVel.x - rotOmega*ry;
+          gridVel(iv,1) = rigidVel.y + rotOmega*rx;
         }
       }
     }
   }
 }
+
+void geo::addMemUsage(memTally &mem)
+{
+  size_t bytes = memBytes(c2v, xv, xv_new, xv0, gridVel, c2e, c2b, e2c, e2v, v2e, v2v, v2c)
+      + memBytes(c2f, f2v, f2c, c2c, c2ac, v2nv, v2nc, c2nv, c2nf, f2nv, ctype)
+      + memBytes(intFaces, bndFaces, mpiFaces, overFaces, overCells, bcList, bcType, bndPts, nBndPts, bcFaces)
+      + memBytes(nFacesPerBnd, procR, faceID_R, mpiLocF, mpiFaceNodes_R, mpiFaceXv_R, mpiPeriodic, faceType)
+      + memBytes(gridIdList, iblank, iblankCell, iblankFace, iwall, iover, nodeType, wallFaceNodes, overFaceNodes)
+      + memBytes(mpiNodes, eleMap, faceMap, currFaceType, epart, holeCells, holeFaces, unblankCells, blankCells)
+      + memBytes(fringeCells, tg_c2v, eleBBox, c2v_g, xv_g, ic2icg, iv2ivg, ctype_g, c2ne_g, c2nv_g)
+      + memBytes(bndPts_g, nBndPts_g);
+
+  mem.add("geo: mesh & connectivity", bytes);
+}
@@ -212,14 +212,7 @@ void geo::setupOverset2D(void)
 
   OComm->setIblanks2D(xv,overFaceNodes,wallFaceNodes,iblank);
 
-  eleBBox.setup(nEles,nDims*2);
-  for (int i=0; i<nEles; i++) {
-    matrix<double> epts;
-    for (int j=0; j<c2nv[i]; j++) {
-      epts.insertRow(xv[c2v(i,j)],INSERT_AT_END,nDims);
-    }
-    getBoundingBox(epts.getData(),c2nv[i],nDims,eleBBox[i]);
-  }
+  updateEleBBoxes();
 
   adt = make_shared<ADT>();
   OComm->adt = adt;
@@ -318,16 +311,35 @@ void geo::updateADT(void)
     // Have TIOGA perform the nodal overset connectivity (set nodal iblanks)
     tg->performConnectivity();
   } else {
-    for (int i=0; i<nEles; i++) {
-      matrix<double> epts;
-      for (int j=0; j<c2nv[i]; j++) {
-        epts.insertRow(xv[c2v(i,j)],INSERT_AT_END,nDims);
+    updateEleBBoxes();
+
+    // The element set is unchanged by motion, so only the node extents need
+    // updating; the search stays exact, only the tree's balance can degrade
+    if (adt->getNElem() == nEles)
+      adt->refitADT();
+    else
+      adt->buildADT(nDims*2,nEles,eleBBox.getData());
+  }
+#endif
+}
+
+void geo::updateEleBBoxes(void)
+{
+  eleBBox.setup(nEles,nDims*2);
+
+#pragma omp parallel for
+  for (int i=0; i<nEles; i++) {
+    for (int k=0; k<nDims; k++) {
+      eleBBox(i,k)       =  INFINITY;
+      eleBBox(i,k+nDims) = -INFINITY;
+    }
+    for (int j=0; j<c2nv[i]; j++) {
+      for (int k=0; k<nDims; k++) {
+        eleBBox(i,k)       = min(eleBBox(i,k),      xv(c2v(i,j),k));
+        eleBBox(i,k+nDims) = max(eleBBox(i,k+nDims),xv(c2v(i,j),k));
       }
-      getBoundingBox(epts.getData(),c2nv[i],nDims,eleBBox[i]);
     }
-    adt->buildADT(nDims*2,nEles,eleBBox.getData());
   }
-#endif
 }
 
 void geo::setIterIblanks(void)
@@ -396,6 +408,12 @@ void geo::setIterIblanks(void)
   }
 
   holeCells = holeCells_tmp;
+
+  // Blanking rarely changes from one step to the next; when no cell on this
+  // grid changed, the element & face lists can be left as they are
+  int nChanged = blankCells.size() + unblankCells.size();
+  MPI_Allreduce(MPI_IN_PLACE,&nChanged,1,MPI_INT,MPI_SUM,gridComm);
+  blankingChanged = (nChanged > 0);
 #endif
 }
 
@@ -862,7 +880,7 @@ void geo::insertEles(vector<shared_ptr<ele>> &eles, unordered_set<int> &ubEles)
 
     shared_ptr<ele> e = make_shared<ele>();
     e->ID = ic;
-    if (nProcGrid>1)
+    if (nProcGrid>1 || !ic2icg.empty())
       e->IDg = ic2icg[ic];
     else
       e->IDg = ic;
@@ -1025,7 +1043,7 @@ void geo::insertFaces(vector<shared_ptr<ele>> &eles, vector<shared_ptr<face>> &f
       int relRot = 0;
       if (nDims == 3) {
         // Find the relative orientation (rotation) between left & right faces
-        relRot = compareOrientationMPI(ic,fid1,gIC_R[ind],mpiLocF_R[ind],mpiPeriodic[ind]);
+        relRot = compareOrientationMPI(ic,fid1,ind,mpiPeriodic[ind]);
       }
       struct faceInfo info;
       info.IDR = faceID_R[ind];
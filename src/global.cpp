@@ -28,9 +28,16 @@
 
 #include "global.hpp"
 
+#include <atomic>
 #include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <set>
+#include <sstream>
 #include <string>
 
+#include <sys/resource.h>
+
 #ifndef _NO_MPI
 #include "mpi.h"
 #endif
@@ -38,6 +45,31 @@
 /* --- Misc. Common Constants --- */
 double pi = 4.0*atan(1);
 
+#ifdef _DEBUG
+/* --- Heap-allocation counter: replaces the global operator new [which the
+ * default operator new[] also calls], so that allocations in the time step
+ * can be found [see the main loop in flurry.cpp] */
+static std::atomic<long> allocCount(0);
+
+void* operator new(size_t size)
+{
+  allocCount++;
+  if (void* ptr = malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+  free(ptr);
+}
+
+long getAllocCount(void)
+{
+  return allocCount;
+}
+#endif
+
 //! Maps a boundary-condition string to its integer enum
 // NOTE: 'symmetry' is just a psuedonym for 'slip_wall' which will not be
 // considered a "wall" boundary condition for overset grids, force calc, etc.
@@ -210,3 +242,304 @@ void simTimer::showTime(int precision)
     }
   }
 }
+
+phaseTimers profiler;
+
+phaseTimers::phaseTimers(void)
+{
+  nodes.resize(1);
+  nodes[0].name = "total";
+  nodes[0].parent = -1;
+  nodes[0].time = 0;
+  nodes[0].calls = 0;
+  current = 0;
+}
+
+void phaseTimers::start(const char* name)
+{
+  // Find [or add] the named child of the current node
+  int child = -1;
+  for (int c:nodes[current].children) {
+    if (nodes[c].name.compare(name) == 0) {
+      child = c;
+      break;
+    }
+  }
+
+  if (child < 0) {
+    child = nodes.size();
+    nodes.push_back(node());
+    nodes[child].name = name;
+    nodes[child].parent = current;
+    nodes[child].time = 0;
+    nodes[child].calls = 0;
+    nodes[current].children.push_back(child);
+  }
+
+  current = child;
+  nodes[current].t0 = std::chrono::steady_clock::now();
+}
+
+void phaseTimers::stop(void)
+{
+  auto t1 = std::chrono::steady_clock::now();
+  nodes[current].time += std::chrono::duration<double>(t1 - nodes[current].t0).count();
+  nodes[current].calls++;
+  current = nodes[current].parent;
+}
+
+string phaseTimers::getPath(int n)
+{
+  if (nodes[n].parent <= 0) return nodes[n].name;
+  return getPath(nodes[n].parent) + "/" + nodes[n].name;
+}
+
+double phaseTimers::getTime(const string &name)
+{
+  double time = 0;
+  for (uint n=1; n<nodes.size(); n++) {
+    if (nodes[n].name != name) continue;
+
+    // Phases nested within one of the same name are already included
+    bool outer = true;
+    for (int p=nodes[n].parent; p>0; p=nodes[p].parent)
+      if (nodes[p].name == name) outer = false;
+
+    if (outer) time += nodes[n].time;
+  }
+
+  return time;
+}
+
+/*! Order '/'-separated phase paths depth-first, keeping siblings in their given order */
+static vector<string> sortPhases(const vector<string> &paths)
+{
+  map<string,vector<string>> children;
+  for (auto &path:paths) {
+    size_t pos = path.find_last_of('/');
+    string parent = (pos == string::npos) ? "" : path.substr(0,pos);
+    children[parent].push_back(path);
+  }
+
+  vector<string> sorted;
+  vector<string> stack(children[""].rbegin(),children[""].rend());
+  while (!stack.empty()) {
+    string path = stack.back();
+    stack.pop_back();
+    sorted.push_back(path);
+    auto &c = children[path];
+    stack.insert(stack.end(),c.rbegin(),c.rend());
+  }
+
+  return sorted;
+}
+
+#ifndef _NO_MPI
+/*! Union of the names given by all ranks, in order of first appearance
+ *  [taking the ranks in order]; the same list is returned on all ranks */
+static vector<string> unionOverRanks(const vector<string> &names)
+{
+  int rank, nproc;
+  MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+  MPI_Comm_size(MPI_COMM_WORLD,&nproc);
+
+  string myNames;
+  for (auto &name:names) myNames += name + "\n";
+
+  int nChars = myNames.size();
+  vector<int> nChars_rank(nproc), disp(nproc);
+  MPI_Gather(&nChars,1,MPI_INT,nChars_rank.data(),1,MPI_INT,0,MPI_COMM_WORLD);
+
+  int nCharsTot = 0;
+  for (int p=0; p<nproc; p++) {
+    disp[p] = nCharsTot;
+    nCharsTot += nChars_rank[p];
+  }
+
+  string allNames(nCharsTot,' ');
+  MPI_Gatherv(&myNames[0],nChars,MPI_CHAR,&allNames[0],nChars_rank.data(),disp.data(),MPI_CHAR,0,MPI_COMM_WORLD);
+
+  if (rank == 0) {
+    myNames.clear();
+    set<string> found;
+    stringstream ss(allNames);
+    string name;
+    while (getline(ss,name)) {
+      if (!found.count(name)) {
+        myNames += name + "\n";
+        found.insert(name);
+      }
+    }
+    nCharsTot = myNames.size();
+  }
+
+  MPI_Bcast(&nCharsTot,1,MPI_INT,0,MPI_COMM_WORLD);
+  myNames.resize(nCharsTot);
+  MPI_Bcast(&myNames[0],nCharsTot,MPI_CHAR,0,MPI_COMM_WORLD);
+
+  vector<string> out;
+  stringstream ss(myNames);
+  string name;
+  while (getline(ss,name))
+    out.push_back(name);
+
+  return out;
+}
+#endif
+
+void phaseTimers::report(double totalTime, const string &jsonFile, const map<string,double> &summary)
+{
+  int rank = 0, nproc = 1;
+#ifndef _NO_MPI
+  MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+  MPI_Comm_size(MPI_COMM_WORLD,&nproc);
+#endif
+
+  /* --- Local phases, listed parent-first --- */
+  vector<string> paths;
+  map<string,int> localID;
+  for (uint n=1; n<nodes.size(); n++) {
+    paths.push_back(getPath(n));
+    localID[paths.back()] = n;
+  }
+
+#ifndef _NO_MPI
+  // Not all ranks run the same phases [e.g. MPI or overset faces]
+  paths = unionOverRanks(paths);
+#endif
+  paths = sortPhases(paths);
+
+  int nPhases = paths.size();
+  vector<double> tLoc(nPhases,0.), tMin(nPhases), tMax(nPhases), tSum(nPhases);
+  vector<long> cLoc(nPhases,0), cMax(nPhases);
+  for (int i=0; i<nPhases; i++) {
+    if (localID.count(paths[i])) {
+      tLoc[i] = nodes[localID[paths[i]]].time;
+      cLoc[i] = nodes[localID[paths[i]]].calls;
+    }
+  }
+
+#ifndef _NO_MPI
+  MPI_Reduce(tLoc.data(),tMin.data(),nPhases,MPI_DOUBLE,MPI_MIN,0,MPI_COMM_WORLD);
+  MPI_Reduce(tLoc.data(),tMax.data(),nPhases,MPI_DOUBLE,MPI_MAX,0,MPI_COMM_WORLD);
+  MPI_Reduce(tLoc.data(),tSum.data(),nPhases,MPI_DOUBLE,MPI_SUM,0,MPI_COMM_WORLD);
+  MPI_Reduce(cLoc.data(),cMax.data(),nPhases,MPI_LONG,MPI_MAX,0,MPI_COMM_WORLD);
+#else
+  tMin = tMax = tSum = tLoc;
+  cMax = cLoc;
+#endif
+
+  if (rank != 0) return;
+
+  /* --- Print the profile --- */
+  cout << endl << "Performance profile [wall time, over " << nproc << " rank(s)]:" << endl;
+  cout << setw(40) << left << "Phase" << setw(10) << right << "Calls";
+  cout << setw(12) << "Avg [s]" << setw(12) << "Min [s]" << setw(12) << "Max [s]";
+  cout << setw(10) << "Avg %" << setw(10) << "Imbal." << endl;
+
+  cout.setf(ios::fixed, ios::floatfield);
+  for (int i=0; i<nPhases; i++) {
+    int depth = std::count(paths[i].begin(),paths[i].end(),'/');
+    string name = string(2*depth,' ') + paths[i].substr(paths[i].find_last_of('/')+1);
+    double tAvg = tSum[i]/nproc;
+
+    cout << setw(40) << left << name << setw(10) << right << cMax[i];
+    cout << setprecision(4) << setw(12) << tAvg << setw(12) << tMin[i] << setw(12) << tMax[i];
+    cout << setprecision(1) << setw(10) << 100.*tAvg/totalTime;
+    cout << setprecision(2) << setw(10) << ((tAvg > 0) ? tMax[i]/tAvg : 1.) << endl;
+  }
+  cout.unsetf(ios::floatfield);
+
+  /* --- Write the profile as JSON --- */
+  if (jsonFile.empty()) return;
+
+  ofstream json(jsonFile.c_str());
+  json.precision(6);
+  json << "{" << endl;
+  json << "  \"nRanks\": " << nproc << "," << endl;
+  json << "  \"totalTime\": " << totalTime << "," << endl;
+  for (auto &val : summary)
+    json << "  \"" << val.first << "\": " << val.second << "," << endl;
+  json << "  \"phases\": [" << endl;
+  for (int i=0; i<nPhases; i++) {
+    json << "    {\"path\": \"" << paths[i] << "\", \"calls\": " << cMax[i];
+    json << ", \"avg\": " << tSum[i]/nproc << ", \"min\": " << tMin[i] << ", \"max\": " << tMax[i] << "}";
+    json << ((i < nPhases-1) ? "," : "") << endl;
+  }
+  json << "  ]" << endl;
+  json << "}" << endl;
+  json.close();
+}
+
+size_t memTally::total(void) const
+{
+  size_t tot = 0;
+  for (auto &b:bytes) tot += b.second;
+
+  return tot;
+}
+
+void memTally::report(const string &title)
+{
+  int rank = 0, nproc = 1;
+#ifndef _NO_MPI
+  MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+  MPI_Comm_size(MPI_COMM_WORLD,&nproc);
+#endif
+
+  // Categories in alphabetical order, so that those of one subsystem are listed together
+  vector<string> names;
+  for (auto &b:bytes) names.push_back(b.first);
+#ifndef _NO_MPI
+  names = unionOverRanks(names);
+  std::sort(names.begin(),names.end());
+#endif
+
+  // The last two entries are the total & the peak resident set size
+  int n = names.size();
+  vector<double> mLoc(n+2,0.), mMin(n+2), mMax(n+2), mSum(n+2);
+  for (int i=0; i<n; i++)
+    if (bytes.count(names[i])) mLoc[i] = bytes[names[i]];
+  mLoc[n] = total();
+  mLoc[n+1] = getPeakMemory();
+
+#ifndef _NO_MPI
+  MPI_Reduce(mLoc.data(),mMin.data(),n+2,MPI_DOUBLE,MPI_MIN,0,MPI_COMM_WORLD);
+  MPI_Reduce(mLoc.data(),mMax.data(),n+2,MPI_DOUBLE,MPI_MAX,0,MPI_COMM_WORLD);
+  MPI_Reduce(mLoc.data(),mSum.data(),n+2,MPI_DOUBLE,MPI_SUM,0,MPI_COMM_WORLD);
+#else
+  mMin = mMax = mSum = mLoc;
+#endif
+
+  if (rank != 0) return;
+
+  const double MB = 1024.*1024.;
+  names.push_back("Total [tallied]");
+  names.push_back("Peak resident set size");
+
+  cout << endl << "Memory use " << title << " [MB, over " << nproc << " rank(s)]:" << endl;
+  cout << setw(40) << left << "Category" << setw(12) << right << "Min";
+  cout << setw(12) << "Max" << setw(12) << "Sum" << setw(10) << "% total" << endl;
+
+  cout.setf(ios::fixed, ios::floatfield);
+  for (int i=0; i<n+2; i++) {
+    cout << setw(40) << left << names[i] << right << setprecision(2);
+    cout << setw(12) << mMin[i]/MB << setw(12) << mMax[i]/MB << setw(12) << mSum[i]/MB;
+    if (i < n)
+      cout << setprecision(1) << setw(10) << ((mSum[n] > 0) ? 100.*mSum[i]/mSum[n] : 0.);
+    cout << endl;
+  }
+  cout.unsetf(ios::floatfield);
+}
+
+size_t getPeakMemory(void)
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF,&usage);
+
+#ifdef __APPLE__
+  return usage.ru_maxrss;       // bytes
+#else
+  return usage.ru_maxrss*1024;  // kilobytes
+#endif
+}
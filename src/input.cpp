@@ -33,6 +33,10 @@
 #include <string>
 #include <stdio.h>
 
+#ifndef _NO_MPI
+#include "mpi.h"
+#endif
+
 fileReader::fileReader()
 {
 
@@ -46,105 +50,155 @@ fileReader::fileReader(string fileName)
 fileReader::fileReader(const fileReader &_fr)
 {
   this->fileName = _fr.fileName;
+  this->isRead = _fr.isRead;
+  this->optLines = _fr.optLines;
 }
 
 fileReader& fileReader::operator=(const fileReader& _fr)
 {
   this->fileName = _fr.fileName;
+  this->isRead = _fr.isRead;
+  this->optLines = _fr.optLines;
+  return *this;
 }
 
 fileReader::~fileReader()
 {
-  if (optFile.is_open()) optFile.close();
+
 }
 
 void fileReader::setFile(string fileName)
 {
   this->fileName = fileName;
+  closeFile();
 }
 
-void fileReader::openFile(void)
+void fileReader::readFile(void)
 {
-  optFile.open(fileName.c_str(), ifstream::in);
-}
+  int rank = 0;
+#ifndef _NO_MPI
+  int mpiInit;
+  MPI_Initialized(&mpiInit);
+  if (mpiInit)
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+
+  // Only rank 0 touches the file system
+  string contents;
+  int nChars = 0;
+  if (rank == 0) {
+    ifstream optFile(fileName.c_str(), ifstream::in);
+    if (optFile.is_open()) {
+      stringstream ss;
+      ss << optFile.rdbuf();
+      contents = ss.str();
+    }
+    else {
+      nChars = -1;
+    }
+    if (nChars == 0)
+      nChars = contents.size();
+  }
 
-void fileReader::closeFile()
-{
-  optFile.close();
-}
+#ifndef _NO_MPI
+  if (mpiInit) {
+    MPI_Bcast(&nChars, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (nChars > 0) {
+      contents.resize(nChars);
+      MPI_Bcast(&contents[0], nChars, MPI_CHAR, 0, MPI_COMM_WORLD);
+    }
+  }
+#endif
 
-template<typename T>
-void fileReader::getScalarValue(string optName, T &opt, T defaultVal)
-{
-  string str, optKey;
+  if (nChars < 0)
+    FatalError("Cannont open input file for reading.");
 
-  openFile();
+  optLines = make_shared<map<string,vector<string>>>();
 
-  if (!optFile.is_open() || !getline(optFile,str)) {
-    optFile.open(fileName.c_str());
-    if (!optFile.is_open())
-      FatalError("Cannont open input file for reading.");
+  stringstream file(contents);
+  string str, optKey;
+  while (getline(file,str)) {
+    // Remove any leading whitespace & take the first word as the option name
+    stringstream ss;
+    ss.str(str);
+    if (!(ss >> optKey)) continue;
+
+    string rest;
+    getline(ss,rest,'\0');
+    (*optLines)[optKey].push_back(rest);
   }
 
-  // Rewind to the start of the file
-  optFile.seekg(0,optFile.beg);
+  isRead = true;
+}
 
-  // Search for the given option string
-  while (getline(optFile,str)) {
-    // Remove any leading whitespace & see if first word is the input option
-    stringstream ss;
-    ss.str(str);
-    ss >> optKey;
-    if (optKey.compare(optName)==0) {
-      if (!(ss >> opt)) {
-        // This could happen if, for example, trying to assign a string to a double
-        cout << "WARNING: Unable to assign value to option " << optName << endl;
-        cout << "Using default value of " << defaultVal << " instead." << endl;
-        opt = defaultVal;
-      }
+void fileReader::addOverrides(string overFile, const set<string> &locked)
+{
+  if (!isRead) readFile();
+
+  fileReader over(overFile);
+  over.readFile();
 
-      closeFile();
-      return;
+  // Copies of this reader keep the index they were made with
+  optLines = make_shared<map<string,vector<string>>>(*optLines);
+
+  for (auto &opt : *over.optLines) {
+    if (locked.count(opt.first)) {
+      string errMsg = "Option " + opt.first + " may not be overridden in " + overFile;
+      FatalError(errMsg.c_str());
     }
+    (*optLines)[opt.first] = opt.second;
   }
+}
 
-  opt = defaultVal;
-  closeFile();
+void fileReader::closeFile()
+{
+  optLines.reset();
+  isRead = false;
 }
 
-template<typename T>
-void fileReader::getScalarValue(string optName, T &opt)
+const string* fileReader::findOption(const string &optName)
 {
-  string str, optKey;
+  if (!isRead) readFile();
 
-  openFile();
+  auto it = optLines->find(optName);
+  if (it == optLines->end()) return NULL;
 
-  if (!optFile.is_open()) {
-    optFile.open(fileName.c_str());
-    if (!optFile.is_open())
-      FatalError("Cannont open input file for reading.");
-  }
+  return &(it->second.front());
+}
 
-  // Rewind to the start of the file
-  optFile.seekg(0,optFile.beg);
+template<typename T>
+void fileReader::getScalarValue(string optName, T &opt, T defaultVal)
+{
+  auto str = findOption(optName);
+
+  if (str) {
+    stringstream ss(*str);
+    if (!(ss >> opt)) {
+      // This could happen if, for example, trying to assign a string to a double
+      cout << "WARNING: Unable to assign value to option " << optName << endl;
+      cout << "Using default value of " << defaultVal << " instead." << endl;
+      opt = defaultVal;
+    }
+    return;
+  }
 
-  // Search for the given option string
-  while (getline(optFile,str)) {
-    // Remove any leading whitespace & see if first word is the input option
-    stringstream ss;
-    ss.str(str);
-    ss >> optKey;
-    if (optKey.compare(optName)==0) {
-      if (!(ss >> opt)) {
-        // This could happen if, for example, trying to assign a string to a double
-        cerr << "WARNING: Unable to assign value to option " << optName << endl;
-        string errMsg = "Required option not set: " + optName;
-        FatalError(errMsg.c_str())
-      }
+  opt = defaultVal;
+}
 
-      closeFile();
-      return;
+template<typename T>
+void fileReader::getScalarValue(string optName, T &opt)
+{
+  auto str = findOption(optName);
+
+  if (str) {
+    stringstream ss(*str);
+    if (!(ss >> opt)) {
+      // This could happen if, for example, trying to assign a string to a double
+      cerr << "WARNING: Unable to assign value to option " << optName << endl;
+      string errMsg = "Required option not set: " + optName;
+      FatalError(errMsg.c_str())
     }
+    return;
   }
 
   // Option was not found; throw error & exit
@@ -154,94 +208,56 @@ void fileReader::getScalarValue(string optName, T &opt)
 
 template<typename T, typename U>
 void fileReader::getMap(string optName, map<T,U> &opt) {
-  string str, optKey;
   T tmpT;
   U tmpU;
-  bool found;
 
-  openFile();
-
-  if (!optFile.is_open()) {
-    optFile.open(fileName.c_str());
-    if (!optFile.is_open())
-      FatalError("Cannont open input file for reading.");
-  }
+  if (!isRead) readFile();
 
-  // Rewind to the start of the file
-  optFile.seekg(0,optFile.beg);
-
-  // Search for the given option string
-  while (getline(optFile,str)) {
-    // Remove any leading whitespace & see if first word is the input option
-    stringstream ss;
-    ss.str(str);
-    ss >> optKey;
-    if (optKey.compare(optName)==0) {
-      found = true;
-      if (!(ss >> tmpT >> tmpU)) {
-        // This could happen if, for example, trying to assign a string to a double
-        cerr << "WARNING: Unable to assign value to option " << optName << endl;
-        string errMsg = "Required option not set: " + optName;
-        FatalError(errMsg.c_str())
-      }
-
-      opt[tmpT] = tmpU;
-      optKey = "";
-    }
-  }
-
-  if (!found) {
+  auto it = optLines->find(optName);
+  if (it == optLines->end()) {
     // Option was not found; throw error & exit
     string errMsg = "Required option not found: " + optName;
     FatalError(errMsg.c_str());
   }
 
-  closeFile();
+  // Every line for the option adds an entry
+  for (auto &str:it->second) {
+    stringstream ss(str);
+    if (!(ss >> tmpT >> tmpU)) {
+      // This could happen if, for example, trying to assign a string to a double
+      cerr << "WARNING: Unable to assign value to option " << optName << endl;
+      string errMsg = "Required option not set: " + optName;
+      FatalError(errMsg.c_str())
+    }
+
+    opt[tmpT] = tmpU;
+  }
 }
 
 template<typename T>
 void fileReader::getVectorValue(string optName, vector<T> &opt)
 {
-  string str, optKey;
-
-  openFile();
-
-  if (!optFile.is_open()) {
-    optFile.open(fileName.c_str());
-    if (!optFile.is_open())
-      FatalError("Cannont open input file for reading.");
-  }
-
-  // Rewind to the start of the file
-  optFile.seekg(0,optFile.beg);
+  auto str = findOption(optName);
+
+  if (str) {
+    stringstream ss(*str);
+    int nVals;
+    if (!(ss >> nVals)) {
+      // This could happen if, for example, trying to assign a string to a double
+      cerr << "WARNING: Unable to read number of entries for vector option " << optName << endl;
+      string errMsg = "Required option not set: " + optName;
+      FatalError(errMsg.c_str());
+    }
 
-  // Search for the given option string
-  while (getline(optFile,str)) {
-    // Remove any leading whitespace & see if first word is the input option
-    stringstream ss;
-    ss.str(str);
-    ss >> optKey;
-    if (optKey.compare(optName)==0) {
-      int nVals;
-      if (!(ss >> nVals)) {
-        // This could happen if, for example, trying to assign a string to a double
-        cerr << "WARNING: Unable to read number of entries for vector option " << optName << endl;
+    opt.resize(nVals);
+    for (int i=0; i<nVals; i++) {
+      if (!(ss >> opt[i])) {
+        cerr << "WARNING: Unable to assign all values to vector option " << optName << endl;
         string errMsg = "Required option not set: " + optName;
-        FatalError(errMsg.c_str());
-      }
-
-      opt.resize(nVals);
-      for (int i=0; i<nVals; i++) {
-        if (!(ss >> opt[i])) {
-          cerr << "WARNING: Unable to assign all values to vector option " << optName << endl;
-          string errMsg = "Required option not set: " + optName;
-          FatalError(errMsg.c_str())
-        }
+        FatalError(errMsg.c_str())
       }
-
-      closeFile();
-      return;
     }
+    return;
   }
 
   // Option was not found; throw error & exit
@@ -254,13 +270,40 @@ input::input()
 
 }
 
-void input::readInputFile(char *filename)
+//! Options which the mesh or the FR operators depend on: shared by all ensemble members
+static const set<string> ensembleLocked = {
+  "equation", "nDims", "viscous", "viscScheme", "order", "motion", "meshType",
+  "meshFileName", "partMeshFile", "distributedMesh", "partWeights", "reorderMesh",
+  "nx", "ny", "nz", "xmin", "xmax", "ymin", "ymax", "zmin", "zmax",
+  "create_bcTop", "create_bcBottom", "create_bcLeft", "create_bcRight",
+  "create_bcFront", "create_bcBack", "mesh_bound", "periodicDX", "periodicDY",
+  "periodicDZ", "periodicTol", "spts_type_tri", "spts_type_quad", "vcjhSchemeTri",
+  "vcjhSchemeQuad", "shockCapture", "sumFactorization", "PMG", "HMG", "shapeOrder",
+  "ensemble", "ensembleFiles"
+};
+
+void input::readInputFile(char *filename, int member)
 {
   /* --- Open Input File --- */
   string fName;
   fName.assign(filename);
 
   opts.setFile(fName);
+  opts.readFile();
+
+  /* --- Ensemble member: the member's own options replace the shared ones --- */
+  opts.getScalarValue("ensemble",ensemble,0);
+  if (ensemble)
+    opts.getVectorValue("ensembleFiles",ensembleFiles);
+
+  ensembleMember = member;
+  string baseDataFileName;
+  if (member >= 0) {
+    if (member >= (int)ensembleFiles.size())
+      FatalError("Ensemble member ID out of range of ensembleFiles.");
+    opts.getScalarValue("dataFileName",baseDataFileName,string("simData"));
+    opts.addOverrides(ensembleFiles[member],ensembleLocked);
+  }
 
   /* --- Read input file & store all simulation parameters --- */
 
@@ -305,32 +348,71 @@ void input::readInputFile(char *filename)
   opts.getScalarValue("timeType",timeType,4);
   opts.getScalarValue("dtType",dtType,0);
   opts.getScalarValue("iterMax",iterMax);
-  if (dtType != 0) {
+  opts.getScalarValue("adaptDt",adaptDt,0);
+  if (dtType == 2) {
+    // Local time stepping: 'time' is not physical, so only stop on iterMax by default
+    opts.getScalarValue("CFL",CFL);
+    opts.getScalarValue("maxTime",maxTime,(double)INFINITY);
+  } else if (dtType != 0) {
     opts.getScalarValue("CFL",CFL);
     opts.getScalarValue("maxTime",maxTime);
   } else {
     opts.getScalarValue("dt",dt);
-    maxTime = iterMax * dt;
+    if (adaptDt)
+      opts.getScalarValue("maxTime",maxTime,iterMax*dt);
+    else
+      maxTime = iterMax * dt;
+  }
+  if (adaptDt) {
+    if (dtType != 0)
+      FatalError("adaptDt sets dt from the RK error estimate - use dtType 0 (with 'dt' as the initial time step).");
+    opts.getScalarValue("adaptRTol",adaptRTol,1e-4);
+    opts.getScalarValue("adaptATol",adaptATol,1e-6);
   }
 
   opts.getScalarValue("viscous",viscous,0);
   opts.getScalarValue("motion",motion,0);
+  if (dtType == 2 && motion)
+    FatalError("Local time stepping [dtType 2] is only valid for steady-state problems - not compatible with motion.");
+
+  opts.getScalarValue("resSmoothing",resSmoothing,0.);
+  if (resSmoothing > 0)
+    opts.getScalarValue("resSmoothIters",resSmoothIters,2);
+
   opts.getScalarValue("order",order,3);
   opts.getScalarValue("riemannType",riemannType,0);
   opts.getScalarValue("testCase",testCase,0);
 
+  rotCx = rotCy = 0.;
   if (motion == 4) {
     opts.getScalarValue("moveAx",moveAx);
     opts.getScalarValue("moveAy",moveAy);
     opts.getScalarValue("moveFx",moveFx);
     opts.getScalarValue("moveFy",moveFy);
   }
+  else if (motion == 5) {
+    opts.getScalarValue("moveAx",moveAx,0.);
+    opts.getScalarValue("moveAy",moveAy,0.);
+    opts.getScalarValue("moveFx",moveFx,0.);
+    opts.getScalarValue("moveFy",moveFy,0.);
+    opts.getScalarValue("rotOmega",rotOmega,0.);
+    opts.getScalarValue("pitchAmp",pitchAmp,0.);
+    opts.getScalarValue("pitchFreq",pitchFreq,0.);
+    opts.getScalarValue("rotCx",rotCx,0.);
+    opts.getScalarValue("rotCy",rotCy,0.);
+  }
 
+  viscScheme = 0;
   if (viscous) {
     /* --- LDG Flux Parameters --- */
     opts.getScalarValue("LDG_penFact",penFact,0.0);
     opts.getScalarValue("LDG_tau",tau,1.);
 
+    /* --- BR2 Flux Parameters --- */
+    opts.getScalarValue("viscScheme",viscScheme,0);
+    if (viscScheme == 1)
+      opts.getScalarValue("BR2_eta",br2Eta,1.);
+
     if (equation == NAVIER_STOKES) {
       opts.getScalarValue("Re",Re);
       opts.getScalarValue("Lref",Lref,1.0);
@@ -361,6 +443,7 @@ void input::readInputFile(char *filename)
     opts.getScalarValue("nx",nx,10);
     opts.getScalarValue("ny",ny,10);
     opts.getScalarValue("nz",nz,10);
+    opts.getScalarValue("distributedMesh",distributedMesh,0);
     opts.getScalarValue("xmin",xmin,-10.);
     opts.getScalarValue("xmax",xmax,10.);
     opts.getScalarValue("ymin",ymin,-10.);
@@ -379,12 +462,16 @@ void input::readInputFile(char *filename)
     // Reading in the mesh in one form or another
     if (meshType == READ_MESH) {
       opts.getScalarValue("meshFileName",meshFileName);
+      opts.getScalarValue("partMeshFile",partMeshFile,string(""));
     }
     else if (meshType == OVERSET_MESH) {
       opts.getVectorValue("oversetGrids",oversetGrids);
       opts.getScalarValue("writeIBLANK",writeIBLANK,0);
       opts.getScalarValue("oversetMethod",oversetMethod);
       opts.getScalarValue("projection",projection,1);
+      opts.getScalarValue("donorCache",donorCache,1);
+      opts.getScalarValue("multirate",multirate,0);
+      opts.getScalarValue("multirateMax",multirateMax,32);
       nGrids = oversetGrids.size();
     }
 
@@ -418,18 +505,49 @@ void input::readInputFile(char *filename)
   opts.getScalarValue("resType",resType,2);
   opts.getScalarValue("plotFreq",plotFreq,100);
   opts.getScalarValue("plotType",plotType,1);
+  opts.getScalarValue("vtuFormat",vtuFormat,0);
+  opts.getScalarValue("vtuCompress",vtuCompress,0);
+  if (vtuCompress && vtuFormat == 0)
+    FatalError("vtuCompress requires binary output [vtuFormat 1 or 2].");
+#ifndef _ZLIB
+  if (vtuCompress)
+    FatalError("vtuCompress requires Flurry to be compiled with zlib [make zlib=y].");
+#endif
+  opts.getScalarValue("asyncOutput",asyncOutput,0);
+  opts.getScalarValue("profile",profile,0);
+  profiler.enabled = (profile > 0);
+  opts.getScalarValue("memReport",memReport,0);
+  opts.getScalarValue("memReportFreq",memReportFreq,0);
+  opts.getScalarValue("probeFreq",probeFreq,0);
+  if (probeFreq > 0)
+    opts.getVectorValue("probePts",probePts);
+  opts.getScalarValue("sliceFreq",sliceFreq,0);
+  if (sliceFreq > 0)
+    opts.getVectorValue("slices",slices);
+  opts.getScalarValue("surfaceFreq",surfaceFreq,0);
+  opts.getScalarValue("statsFreq",statsFreq,0);
+  opts.getScalarValue("statsStart",statsStart,0);
   opts.getScalarValue("restart_freq",restart_freq,100);
+  opts.getScalarValue("partWeights",partWeights,0);
+  opts.getScalarValue("restartType",restartType,0);
+  if (restartType && meshType == OVERSET_MESH)
+    FatalError("Binary restart files not yet supported for overset grids.");
   opts.getScalarValue("dataFileName",dataFileName,string("simData"));
+  if (member >= 0 && dataFileName == baseDataFileName)
+    dataFileName += "_E" + to_string(member);
 
   opts.getScalarValue("spts_type_tri",sptsTypeTri,string("Legendre"));
   opts.getScalarValue("spts_type_quad",sptsTypeQuad,string("Legendre"));
   opts.getScalarValue("vcjhSchemeTri",vcjhSchemeTri,0);
   opts.getScalarValue("vcjhSchemeQuad",vcjhSchemeQuad,0);
+  opts.getScalarValue("operCache",operCache,string(""));
 
   /* --- Shock Capturing --- */
   opts.getScalarValue("shockCapture",scFlag,0);
-  if(scFlag == 1)
+  if(scFlag == 1) {
     opts.getScalarValue("threshold",threshold,1.0);
+    opts.getScalarValue("scSensorFreq",scSensorFreq,1);
+  }
 
   opts.getScalarValue("squeeze",squeeze,0);
 
@@ -438,15 +556,117 @@ void input::readInputFile(char *filename)
   if (PMG) {
     opts.getScalarValue("lowOrder",lowOrder,0);
     opts.getScalarValue("smoothSteps",smoothSteps,1);
+    opts.getScalarValue("mgCycle",mgCycle,0);
+    if (mgCycle == 2)
+      opts.getScalarValue("fmgCycles",fmgCycles,10);
   }
   opts.getScalarValue("HMG",HMG,0);
   if (PMG) {
     opts.getScalarValue("n_h_levels",n_h_levels,1);
     opts.getScalarValue("shapeOrder",shapeOrder,2);
   }
+  if (HMG == 2 && meshType == OVERSET_MESH)
+    FatalError("H-multigrid by agglomeration not supported for overset meshes.");
+
+  /* --- Data Layout / Performance --- */
+  opts.getScalarValue("batchStorage",batchStorage,0);
+  if (batchStorage && meshType == OVERSET_MESH)
+    FatalError("Batched element storage requires a fixed set of elements - not compatible with overset grids.");
+  opts.getScalarValue("sumFactorization",sumFactorization,1);
+  opts.getScalarValue("faceBatching",faceBatching,0);
+  if (faceBatching && meshType == OVERSET_MESH)
+    FatalError("Batched face storage requires a fixed set of faces - not compatible with overset grids.");
+  opts.getScalarValue("reorderMesh",reorderMesh,0);
+  opts.getScalarValue("fuseKernels",fuseKernels,0);
+  opts.getScalarValue("taskResidual",taskResidual,0);
+  if (taskResidual) {
+    fuseKernels = 1;
+    if (faceBatching)
+      FatalError("The task-based residual operates face-by-face - not compatible with faceBatching.");
+    if (nproc > 1 && !mpiSerialized)
+      FatalError("The task-based residual completes the MPI exchanges from any thread - requires MPI_THREAD_SERIALIZED.");
+  }
+  if (fuseKernels && batchStorage)
+    FatalError("Fused element sweeps operate element-by-element - not compatible with batchStorage.");
+  if (fuseKernels && meshType == OVERSET_MESH)
+    FatalError("Fused element sweeps not compatible with overset grids.");
+  opts.getScalarValue("gpu",gpu,0);
+  if (gpu) {
+#ifndef _GPU
+    FatalError("gpu requires Flurry to be compiled with GPU support [make gpu=cuda or gpu=hip].");
+#endif
+    if (rank == 0 && member < 0)
+      cout << "WARNING: The GPU backend is experimental; it has not yet been validated against the CPU solver on a device." << endl;
+    opts.getScalarValue("gpuAwareMPI",gpuAwareMPI,0);
+    batchStorage = 1;  // The device arrays mirror the eleBlock layout
+  }
+  opts.getScalarValue("haloFloat",haloFloat,0);
+  if (haloFloat) {
+    opts.getScalarValue("haloTol",haloTol,1e-6);
+    if (gpu)
+      FatalError("haloFloat applies to the CPU face exchange; the GPU backend sends its own [storage-precision] buffers.");
+  }
+
+  /* --- p-Adaptation --- */
+  opts.getScalarValue("pAdaptFreq",pAdaptFreq,0);
+  if (pAdaptFreq > 0) {
+    opts.getScalarValue("pAdaptMin",pAdaptMin,1);
+    opts.getScalarValue("pAdaptMax",pAdaptMax,order+2);
+    opts.getScalarValue("pAdaptRefine",pAdaptRefine,2.);
+    opts.getScalarValue("pAdaptCoarsen",pAdaptCoarsen,0.25);
+    if (equation != NAVIER_STOKES)
+      FatalError("p-adaptation uses the entropy error indicator - Navier-Stokes / Euler only.");
+    if (PMG || (timeType >= 11 && timeType <= 13))
+      FatalError("p-adaptation not compatible with p-multigrid or implicit time stepping.");
+    if (batchStorage || faceBatching)
+      FatalError("p-adaptation requires per-element storage - not compatible with batchStorage or faceBatching.");
+    if (meshType == OVERSET_MESH)
+      FatalError("p-adaptation not yet implemented for overset grids.");
+    calcEntropySensor = true;
+  }
+
+  /* --- Dynamic Load Balancing --- */
+  opts.getScalarValue("rebalanceFreq",rebalanceFreq,0);
+  if (distributedMesh && (rebalanceFreq > 0 || HMG))
+    FatalError("A distributed mesh [distributedMesh] has no global mesh to re-partition or refine - not compatible with rebalancing or h-multigrid.");
+  if (rebalanceFreq > 0) {
+    opts.getScalarValue("rebalanceTol",rebalanceTol,1.1);
+    if (PMG)
+      FatalError("Dynamic load rebalancing not compatible with p-multigrid.");
+    if (motion && meshType == OVERSET_MESH)
+      FatalError("Dynamic load rebalancing not yet implemented for moving overset grids.");
+  }
 
-  /* --- Cleanup ---- */
-  opts.closeFile();
+  /* --- Implicit Time Stepping --- */
+  if (timeType >= 11 && timeType <= 13) {
+    opts.getScalarValue("newtonMaxIter",newtonMaxIter,10);
+    opts.getScalarValue("newtonTol",newtonTol,1e-6);
+    opts.getScalarValue("gmresKrylov",gmresKrylov,30);
+    opts.getScalarValue("gmresRestarts",gmresRestarts,4);
+    opts.getScalarValue("gmresTol",gmresTol,1e-2);
+    opts.getScalarValue("precondType",precondType,1);
+    opts.getScalarValue("jacobianFreq",jacobianFreq,10);
+    if (PMG)
+      FatalError("Implicit time stepping not compatible with p-multigrid.");
+    if (motion)
+      FatalError("Implicit time stepping not yet implemented for moving grids.");
+    if (dtType == 2)
+      FatalError("Implicit time stepping requires a global time step [dtType 0 or 1].");
+  }
+
+  /* --- In-situ Flow Statistics --- */
+  if (statsFreq > 0 && (pAdaptFreq > 0 || rebalanceFreq > 0 || meshType == OVERSET_MESH))
+    FatalError("Flow statistics are kept per element - not compatible with p-adaptation, rebalancing or overset grids.");
+
+  /* --- Ensemble Runs --- */
+  if (ensemble) {
+    if (PMG || HMG || motion || meshType == OVERSET_MESH)
+      FatalError("Ensemble members share one static mesh & one set of operators - not compatible with multigrid, moving or overset grids.");
+    if (pAdaptFreq > 0 || rebalanceFreq > 0)
+      FatalError("Ensemble members require a fixed set of elements - not compatible with p-adaptation or rebalancing.");
+    if (gpu)
+      FatalError("Ensemble runs not yet supported by the GPU backend.");
+  }
 
   /* --- Additional Processing --- */
   if (restart) {
@@ -455,21 +675,100 @@ void input::readInputFile(char *filename)
     initIter = 0;
   }
 
+  lowStorageRK = 0;
+  implicitTime = (timeType >= 11 && timeType <= 13);
   switch (timeType) {
     case 0:
       nRKSteps = 1;
       RKa = {0};
       RKb = {1};
       break;
+    case 3:
+      /* SSP-RK(3,3) [Shu & Osher], with embedded 2nd-order (Heun) solution
+       * U_i+1 = RKa_i*U0 + (1-RKa_i)*(U_i + dt*R(U_i)) */
+      lowStorageRK = 2;
+      nRKSteps = 3;
+      RKa = {0., 3./4., 1./3.};
+      RKc = {0., 1., .5};
+      break;
     case 4:
       nRKSteps = 4;
       RKa = {0., .5, .5, 1.};
       RKb = {1./6., 1./3., 1./3., 1./6.};
       break;
+    case 5:
+      /* 5-stage, 4th-order 2N-storage RK [Carpenter & Kennedy, NASA TM-109112, 1994]
+       * dU = RKa_i*dU + dt*R(U);  U += RKb_i*dU */
+      lowStorageRK = 1;
+      nRKSteps = 5;
+      RKa = {0.,
+             -567301805773./1357537059087.,
+             -2404267990393./2016746695238.,
+             -3550918686646./2091501179385.,
+             -1275806237668./842570457699.};
+      RKb = {1432997174477./9575080441755.,
+             5161836677717./13612068292357.,
+             1720146321549./2090206949498.,
+             3134564353537./4481467310338.,
+             2277821191437./14882151754819.};
+      RKc = {0.,
+             1432997174477./9575080441755.,
+             2526269341429./6820363962896.,
+             2006345519317./3224310063776.,
+             2802321613138./2924317926251.};
+      break;
+    case 11:
+    case 12:
+    case 13:
+      /* Implicit: BDF1, BDF2, ESDIRK3 [see newtonKrylov] */
+      nRKSteps = 1;
+      RKa = {0};
+      RKb = {1};
+      break;
     default:
       FatalError("Time-Stepping type not supported.");
   }
 
+  // For the classical schemes, RKa also gives the stage times
+  if (!lowStorageRK)
+    RKc = RKa;
+
+  nRKRegs = (lowStorageRK) ? 1 : nRKSteps;
+
+  if (adaptDt && lowStorageRK != 2)
+    FatalError("adaptDt requires an RK scheme with an embedded error estimate [timeType 3].");
+
+  if (meshType != OVERSET_MESH)
+    multirate = 0;
+  if (multirate) {
+    if (dtType != 1)
+      FatalError("Multirate time stepping requires CFL-based time steps [dtType 1].");
+    if (motion || (oversetMethod == 2 && projection))
+      FatalError("Multirate time stepping requires static overset grids, with boundary or collocated field interpolation.");
+    if (PMG || implicitTime || lowStorageRK)
+      FatalError("Multirate time stepping supports the classical explicit RK schemes only [timeType 0 or 4].");
+  }
+
+  if (gpu) {
+    if (equation != NAVIER_STOKES || riemannType != 0)
+      FatalError("The GPU backend supports Navier-Stokes / Euler with the Rusanov flux only.");
+    if (motion || meshType == OVERSET_MESH || slipPenalty)
+      FatalError("The GPU backend does not yet support moving or overset grids, or slip-penalty BCs.");
+    if (PMG || implicitTime || lowStorageRK)
+      FatalError("The GPU backend supports the classical explicit RK schemes only [timeType 0 or 4].");
+    if (squeeze || scFlag || resSmoothing > 0 || fuseKernels)
+      FatalError("The GPU backend does not support squeezing, shock capturing, residual smoothing or fuseKernels / taskResidual.");
+    if (pAdaptFreq > 0 || rebalanceFreq > 0)
+      FatalError("The GPU backend requires a fixed set of elements - not compatible with p-adaptation or rebalancing.");
+  }
+
+  if (viscScheme == 1) {
+    if (gpu || meshType == OVERSET_MESH)
+      FatalError("The BR2 viscous flux is not yet implemented for the GPU backend or overset grids.");
+    if (implicitTime || pAdaptFreq > 0)
+      FatalError("The BR2 viscous flux is not compatible with implicit time stepping or p-adaptation.");
+  }
+
   if (squeeze) {
     // Entropy bound for polynomial squeezing
     exps0 = 0.0*pBound/(pow(rhoBound,gamma));
@@ -43,19 +43,13 @@ void intFace::setupRightState(void)
   else
     nFptsR = (eR->order+1)*(eR->order+1);
 
-  /* --- Will have to introduce 'mortar' elements in the future [for p-adaptation],
-   * but for now just force all faces to have same # of flux points [order] --- */
-
-  if (nFptsL != nFptsR)
-    FatalError("Mortar elements not yet implemented - must have nFptsL==nFptsR");
-
   FnR.resize(nFptsR);
   normR.setup(nFptsR,nDims);
   dAR.resize(nFptsR);
-  detJacR.resize(nFptsL);
+  detJacR.resize(nFptsR);
 
-  /* --- Setup the L/R flux-point matching --- */
-  fptR.resize(nFptsL);
+  /* --- Setup the L/R flux-point matching [right points, as ordered on the left face] --- */
+  fptR.resize(nFptsR);
   if (nDims == 2) {
     // For 1D faces [line segments] only - find first/last ID of fpts;
     // right element's are simply reversed
@@ -70,12 +64,12 @@ void intFace::setupRightState(void)
   }
   else if (nDims == 3) {
     // Only for quad tensor-product faces
-    int order = sqrt(nFptsL)-1;
+    int order = eR->order;
 
     fptStartR = nFptsR*faceID_R;
     fptEndR = nFptsR*(faceID_R+1);
 
-    for (int i=0; i<nFptsL; i++) {
+    for (int i=0; i<nFptsR; i++) {
       int ifpt = i%(order+1);
       int jfpt = floor(i/(order+1));
       switch (relRot) {
@@ -95,6 +89,18 @@ void intFace::setupRightState(void)
     }
   }
 
+  /* --- Elements of different order [p-adaptation]: the common flux is computed
+   * at the left flux points, and projected onto the right flux points --- */
+  if (nFptsL != nFptsR)
+    setupMortar(eR->order);
+
+  for (int fpt=0; fpt<nFptsR; fpt++) {
+    for (int dim=0; dim<nDims; dim++)
+      normR(fpt,dim) = eR->norm_fpts(fptR[fpt],dim);
+    dAR[fpt] = eR->dA_fpts[fptR[fpt]];
+    detJacR[fpt] = eR->detJac_fpts[fptR[fpt]];
+  }
+
   if (params->viscous) {
     UcR.resize(nFptsR);
   }
@@ -103,7 +109,7 @@ void intFace::setupRightState(void)
 void intFace::getPointersRight(void)
 {
   // Get access to normal flux storage at right element [use look-up table to get right fpt]
-  for (int i=0; i<nFptsL; i++) {
+  for (int i=0; i<nFptsR; i++) {
     FnR[i] = (eR->Fn_fpts[fptR[i]]);
 
     if (params->viscous)
@@ -114,13 +120,26 @@ void intFace::getPointersRight(void)
 void intFace::getRightState(void)
 {
   // Get data from right element [order reversed to match left ele]
-  for (int fpt=0; fpt<nFptsL; fpt++) {
-    for (int j=0; j<nFields; j++) {
-      UR(fpt,j) = (eR->U_fpts(fptR[fpt],j));
+  if (nFptsR == nFptsL) {
+    for (int fpt=0; fpt<nFptsL; fpt++)
+      for (int j=0; j<nFields; j++)
+        UR(fpt,j) = (eR->U_fpts(fptR[fpt],j));
+  }
+  else {
+    // Mixed orders: evaluate the right element's trace at the left flux points
+    for (int fpt=0; fpt<nFptsL; fpt++) {
+      for (int j=0; j<nFields; j++) {
+        double val = 0;
+        for (int i=0; i<nFptsR; i++)
+          val += interpR(fpt,i) * eR->U_fpts(fptR[i],j);
+        UR(fpt,j) = val;
+      }
     }
+  }
 
-    // For dynamic grids, need to update geometry-related data
-    if ((params->iter == params->initIter+1) || (params->motion != 0)) {
+  // For dynamic grids, need to update geometry-related data
+  if ((params->iter == params->initIter+1) || (params->motion != 0)) {
+    for (int fpt=0; fpt<nFptsR; fpt++) {
       for (int dim=0; dim<nDims; dim++) {
         normR(fpt,dim) = (eR->norm_fpts(fptR[fpt],dim));
       }
@@ -128,44 +147,91 @@ void intFace::getRightState(void)
       detJacR[fpt] = (eR->detJac_fpts[fptR[fpt]]);
     }
   }
+
+  // BR2 lifting factor [equal orders only]
+  if (params->viscScheme == 1) {
+    for (int fpt=0; fpt<nFptsR; fpt++)
+      liftR[fpt] = params->br2Eta * eR->lift_fpts[fptR[fpt]] * dAR[fpt] / detJacR[fpt];
+  }
 }
 
 void intFace::getRightGradient(void)
 {
   // Get data from right element [order reversed to match left ele]
   if (params->viscous) {
-    for (int fpt=0; fpt<nFptsL; fpt++) {
-      for (int dim=0; dim<nDims; dim++)
-        for (int j=0; j<nFields; j++)
-          gradUR[fpt](dim,j) = (eR->dU_fpts[dim](fptR[fpt],j));
+    if (nFptsR == nFptsL) {
+      for (int fpt=0; fpt<nFptsL; fpt++) {
+        for (int dim=0; dim<nDims; dim++)
+          for (int j=0; j<nFields; j++)
+            gradUR[fpt](dim,j) = (eR->dU_fpts[dim](fptR[fpt],j));
+      }
+    }
+    else {
+      for (int fpt=0; fpt<nFptsL; fpt++) {
+        for (int dim=0; dim<nDims; dim++) {
+          for (int j=0; j<nFields; j++) {
+            double val = 0;
+            for (int i=0; i<nFptsR; i++)
+              val += interpR(fpt,i) * eR->dU_fpts[dim](fptR[i],j);
+            gradUR[fpt](dim,j) = val;
+          }
+        }
+      }
     }
   }
 }
 
 void intFace::setRightStateFlux(void)
 {
-  for (int i=0; i<nFptsR; i++)
-    for (int j=0; j<nFields; j++)
-      FnR[i][j] = -Fn(i,j)*dAR[i]; // opposite normal direction
+  if (nFptsR == nFptsL) {
+    for (int i=0; i<nFptsR; i++)
+      for (int j=0; j<nFields; j++)
+        FnR[i][j] = -Fn(i,j)*dAR[i]; // opposite normal direction
+  }
+  else {
+    // Mixed orders: project the [area-weighted] flux, so the face stays conservative
+    for (int i=0; i<nFptsR; i++) {
+      for (int j=0; j<nFields; j++) {
+        double val = 0;
+        for (int fpt=0; fpt<nFptsL; fpt++)
+          val += projR(i,fpt) * Fn(fpt,j)*dAL[fpt];
+        FnR[i][j] = -val;
+      }
+    }
+  }
 }
 
 void intFace::setRightStateSolution(void)
 {
-  for (int i=0; i<nFptsR; i++)
-    for (int j=0; j<nFields; j++)
-      UcR[i][j] = UC(i,j);
+  if (nFptsR == nFptsL) {
+    for (int i=0; i<nFptsR; i++)
+      for (int j=0; j<nFields; j++)
+        UcR[i][j] = UC(i,j);
+  }
+  else {
+    for (int i=0; i<nFptsR; i++) {
+      for (int j=0; j<nFields; j++) {
+        double val = 0;
+        for (int fpt=0; fpt<nFptsL; fpt++)
+          val += projR(i,fpt) * UC(fpt,j);
+        UcR[i][j] = val;
+      }
+    }
+  }
+}
+
+void intFace::computeWallForce(double*)
+{
+  // Not a wall boundary - no contribution
 }
 
-vector<double> intFace::computeWallForce()
+void intFace::computeMassFlux(double*)
 {
-  // Not a wall boundary - return 0
-  vector<double> force = {0,0,0,0,0,0};
-  return force;
+  // Not an inlet/outlet boundary - no contribution
 }
 
-vector<double> intFace::computeMassFlux()
+void intFace::addMemUsage(memTally &mem)
 {
-  // Not an inlet/outlet boundary - return 0
-  vector<double> force(nFields);
-  return force;
+  face::addMemUsage(mem);
+  mem.add("faces", memBytes(fptR, FR, FnR, UcR, normR, dAR, detJacR));
 }
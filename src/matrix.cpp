@@ -28,12 +28,47 @@
  */
 #include "../include/matrix.hpp"
 
+#include <algorithm>
+#include <functional>
 #include <set>
 
 #ifndef _NO_MPI
 #include "mpi.h"
 #endif
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef _BLAS
+#ifdef _MKL
+#include "mkl_cblas.h"
+#else
+#include "cblas.h"
+#endif
+#endif
+
+//! Minimum # of columns in a matrix product before splitting the work among OpenMP threads
+#define BATCH_GEMM_MIN_COLS 1024
+
+//! Width of the column blocks used in matrix products [doubles]
+#define MATMULT_BLOCK_COLS 256
+
+//! Copy the entries of an Array (owned or view) into a contiguous vector
+template<typename T, uint N>
+static void copyArrayData(const Array<T,N> &A, vector<T> &out)
+{
+  if (!A.isView) {
+    out = A.data;
+    return;
+  }
+
+  out.resize(A.dims[0]*A.dims[1]);
+  for (uint i = 0; i < A.dims[0]; i++)
+    for (uint j = 0; j < A.dims[1]; j++)
+      out[i*A.dims[1]+j] = A.dataPtr[i*A.stride+j];
+}
+
 template<typename T, uint N>
 Array<T,N>::Array()
 {
@@ -42,6 +77,7 @@ Array<T,N>::Array()
   dims[1] = 0;
   dims[2] = 0;
   dims[3] = 0;
+  resetDataPtr();
 }
 
 template<typename T, uint N>
@@ -52,6 +88,7 @@ Array<T,N>::Array(uint inNDim0, uint inNDim1, uint inDim2, uint inDim3)
   dims[1] = inNDim1;
   dims[2] = inDim2;
   dims[3] = inDim3;
+  resetDataPtr();
 }
 
 template<typename T>
@@ -60,6 +97,9 @@ Array2D<T>::Array2D()
   this->data.resize(0);
   this->dims[0] = 0;
   this->dims[1] = 0;
+  this->dims[2] = 1;
+  this->dims[3] = 1;
+  this->resetDataPtr();
 }
 
 template<typename T>
@@ -68,6 +108,9 @@ Array2D<T>::Array2D(uint inNDim0, uint inNDim1)
   this->data.resize(inNDim0*inNDim1);
   this->dims[0] = inNDim0;
   this->dims[1] = inNDim1;
+  this->dims[2] = 1;
+  this->dims[3] = 1;
+  this->resetDataPtr();
 }
 
 template<typename T>
@@ -76,6 +119,9 @@ matrix<T>::matrix()
   this->data.resize(0);
   this->dims[0] = 0;
   this->dims[1] = 0;
+  this->dims[2] = 1;
+  this->dims[3] = 1;
+  this->resetDataPtr();
 }
 
 template<typename T>
@@ -84,46 +130,93 @@ matrix<T>::matrix(uint inNDim0, uint inNDim1)
   this->data.resize(inNDim0*inNDim1);
   this->dims[0] = inNDim0;
   this->dims[1] = inNDim1;
-
-  if (this->data.size()>0) {
-    this->dims[2] = 1;
-    this->dims[3] = 1;
-  }
+  this->dims[2] = 1;
+  this->dims[3] = 1;
+  this->resetDataPtr();
 }
 
 template<typename T>
 matrix<T>::matrix(const Array2D<T> &inMatrix)
 {
-  this->data = inMatrix.data;
   for (uint i = 0; i < 4; i++)
     this->dims[i] = inMatrix.dims[i];
+
+  copyArrayData(inMatrix, this->data);
+  this->resetDataPtr();
 }
 
 template<typename T,uint N>
 Array<T,N>::Array(const Array<T,N> &inMatrix)
 {
-  data = inMatrix.data;
   for (uint i = 0; i < 4; i++)
     dims[i] = inMatrix.dims[i];
+
+  copyArrayData(inMatrix, data);
+  resetDataPtr();
 }
 
 template<typename T, uint N>
-Array<T,N> Array<T,N>::operator=(const Array<T,N> &inMatrix)
+Array<T,N>& Array<T,N>::operator=(const Array<T,N> &inMatrix)
 {
-  data = inMatrix.data;
+  if (isView) {
+    // Views keep pointing to the same storage; copy the values into it
+    if (inMatrix.dims[0] != dims[0] || inMatrix.dims[1] != dims[1])
+      FatalErrorST("Cannot assign Array of different size to an Array view.");
+
+    for (uint i = 0; i < dims[0]; i++)
+      for (uint j = 0; j < dims[1]; j++)
+        dataPtr[i*stride+j] = inMatrix.dataPtr[i*inMatrix.stride+j];
+
+    return *this;
+  }
+
   for (uint i = 0; i < 4; i++)
     dims[i] = inMatrix.dims[i];
+
+  copyArrayData(inMatrix, data);
+  resetDataPtr();
   return *this;
 }
 
 template<typename T, uint N>
 void Array<T,N>::setup(uint inDim0, uint inDim1, uint inDim2, uint inDim3)
 {
+  if (isView) {
+    // Already properly sized; resizing would silently detach it from the external storage
+    if (inDim0 == dims[0] && inDim1 == dims[1] && inDim2*inDim3 == 1) return;
+    FatalErrorST("Cannot resize an Array view.");
+  }
+
   data.resize(inDim0*inDim1*inDim2*inDim3);
   dims[0] = inDim0;
   dims[1] = inDim1;
   dims[2] = inDim2;
   dims[3] = inDim3;
+  resetDataPtr();
+}
+
+template<typename T, uint N>
+void Array<T,N>::setupView(T* inData, uint inDim0, uint inDim1, uint inStride)
+{
+  data.resize(0);
+  data.shrink_to_fit();
+
+  dims[0] = inDim0;
+  dims[1] = inDim1;
+  dims[2] = 1;
+  dims[3] = 1;
+
+  dataPtr = inData;
+  stride = inStride;
+  isView = true;
+}
+
+template<typename T, uint N>
+void Array<T,N>::resetDataPtr(void)
+{
+  isView = false;
+  dataPtr = data.data();
+  stride = dims[1]*dims[2]*dims[3];
 }
 
 
@@ -135,7 +228,7 @@ void matrix<T>::addMatrix(matrix<T> &A, double a)
 
   for (uint i=0; i<this->dims[0]; i++)
     for (uint j=0; j<this->dims[1]; j++)
-      this->data[i*this->dims[1]+j] += a*A(i,j);
+      this->dataPtr[i*this->stride+j] += a*A(i,j);
 }
 
 template<>
@@ -146,7 +239,7 @@ matrix<double>& matrix<double>::operator+=(matrix<double> &A)
 
   for (uint i=0; i<this->dims[0]; i++)
     for (uint j=0; j<this->dims[1]; j++)
-      this->data[i*this->dims[1]+j] += A(i,j);
+      this->dataPtr[i*this->stride+j] += A(i,j);
 
   return *this;
 }
@@ -159,7 +252,7 @@ matrix<double>& matrix<double>::operator-=(matrix<double> &A)
 
   for (uint i=0; i<this->dims[0]; i++)
     for (uint j=0; j<this->dims[1]; j++)
-      this->data[i*this->dims[1]+j] -= A(i,j);
+      this->dataPtr[i*this->stride+j] -= A(i,j);
 
   return *this;
 }
@@ -167,14 +260,20 @@ matrix<double>& matrix<double>::operator-=(matrix<double> &A)
 template<>
 matrix<double>& matrix<double>::operator*=(double a)
 {
-  for (auto &val:this->data) val *= a;
+  for (uint i=0; i<this->dims[0]; i++)
+    for (uint j=0; j<this->dims[1]; j++)
+      this->dataPtr[i*this->stride+j] *= a;
+
   return *this;
 }
 
 template<>
 matrix<double>& matrix<double>::operator/=(double a)
 {
-  for (auto &val:this->data) val /= a;
+  for (uint i=0; i<this->dims[0]; i++)
+    for (uint j=0; j<this->dims[1]; j++)
+      this->dataPtr[i*this->stride+j] /= a;
+
   return *this;
 }
 
@@ -188,7 +287,7 @@ T* Array<T,N>::operator[](int inRow)
     FatalErrorST("Operator[]: Attempted out-of-bounds access in matrix.");
   }
 #endif
-  return &data[inRow*this->dims[1]];
+  return &dataPtr[inRow*stride];
 }
 
 template<typename T, uint N>
@@ -203,7 +302,7 @@ T& Array<T,N>::operator()(int i, int j, int k, int l)
     FatalErrorST("Attempted out-of-bounds access in Array.");
   }
 #endif
-  return data[l+dims[3]*(k+dims[2]*(j+dims[1]*i))];
+  return dataPtr[l+dims[3]*(k+dims[2]*j)+stride*i];
 }
 
 template<typename T, uint N>
@@ -218,7 +317,7 @@ T Array<T,N>::operator()(int i, int j, int k, int l) const
     FatalErrorST("Attempted out-of-bounds access in Array.");
   }
 #endif
-  return data[l+dims[3]*(k+dims[2]*(j+dims[1]*i))];
+  return dataPtr[l+dims[3]*(k+dims[2]*j)+stride*i];
 }
 
 template<typename T>
@@ -231,7 +330,7 @@ T& Array2D<T>::operator()(int i, int j)
     FatalErrorST("Attempted out-of-bounds access in matrix.");
   }
 #endif
-  return this->data[j+this->dims[1]*i];
+  return this->dataPtr[j+this->stride*i];
 }
 
 template<typename T>
@@ -244,57 +343,186 @@ T Array2D<T>::operator()(int i, int j) const
     FatalErrorST("Attempted out-of-bounds access in matrix.");
   }
 #endif
-  return this->data[j+this->dims[1]*i];
+  return this->dataPtr[j+this->stride*i];
 }
 
 template<typename T>
 void matrix<T>::initializeToZero(void)
 {
+  if (this->isView) {
+    for (uint i=0; i<this->dims[0]; i++)
+      for (uint j=0; j<this->dims[1]; j++)
+        this->dataPtr[i*this->stride+j] = 0;
+    return;
+  }
+
   for (auto &val:this->data) val = 0;
 }
 
 template<typename T, uint N>
 void Array<T,N>::initializeToValue(const T &_val)
 {
+  if (isView) {
+    for (uint i=0; i<dims[0]; i++)
+      for (uint j=0; j<dims[1]; j++)
+        dataPtr[i*stride+j] = _val;
+    return;
+  }
+
   for (auto &val:this->data) val = _val;
 }
 
-template <typename T>
-void matrix<T>::timesMatrix(matrix<T> &A, matrix<T> &B)
+//! Register-blocked kernel for A & B with exactly P columns [P = nFields for a single element]
+template<typename T, uint P>
+static void matMultFixed(const T* __restrict__ M, uint ldm, const T* __restrict__ A, uint lda,
+                         T* __restrict__ B, uint ldb, uint m, uint n, bool zero)
 {
-  uint i, j, k, p;
-  p = A.dims[1];
+  uint i = 0;
+
+  // Two rows of B at a time to re-use each row of A from registers
+  for (; i+1<m; i+=2) {
+    T acc0[P], acc1[P];
+    for (uint k=0; k<P; k++) {
+      acc0[k] = (zero) ? 0 : B[i*ldb+k];
+      acc1[k] = (zero) ? 0 : B[(i+1)*ldb+k];
+    }
 
-  if (A.dims[0] != this->dims[1]) FatalErrorST("Incompatible matrix sizes in matrix multiplication!");
-  if (B.dims[0] != this->dims[0] || B.dims[1] != A.dims[1]) B.setup(this->dims[0], A.dims[1]);
+    for (uint j=0; j<n; j++) {
+      T M0j = M[i*ldm+j];
+      T M1j = M[(i+1)*ldm+j];
+      for (uint k=0; k<P; k++) {
+        acc0[k] += M0j*A[j*lda+k];
+        acc1[k] += M1j*A[j*lda+k];
+      }
+    }
+
+    for (uint k=0; k<P; k++) {
+      B[i*ldb+k] = acc0[k];
+      B[(i+1)*ldb+k] = acc1[k];
+    }
+  }
 
-  B.initializeToZero();
+  for (; i<m; i++) {
+    T acc[P];
+    for (uint k=0; k<P; k++)
+      acc[k] = (zero) ? 0 : B[i*ldb+k];
 
-  for (i=0; i<this->dims[0]; i++) {
-    for (j=0; j<this->dims[1]; j++) {
-      for (k=0; k<p; k++) {
-        B[i][k] += this->data[i*this->dims[1]+j]*A[j][k];
+    for (uint j=0; j<n; j++) {
+      T Mij = M[i*ldm+j];
+      for (uint k=0; k<P; k++)
+        acc[k] += Mij*A[j*lda+k];
+    }
+
+    for (uint k=0; k<P; k++)
+      B[i*ldb+k] = acc[k];
+  }
+}
+
+//! Multiply columns [k0,k1) of A [n x p] by M [m x n] (row-major, strided) into B: B (+)= M*A
+template<typename T>
+static void matMultCols(const T* __restrict__ M, uint ldm, const T* __restrict__ A, uint lda,
+                        T* __restrict__ B, uint ldb, uint m, uint n, uint k0, uint k1, bool zero)
+{
+  // Specialized kernels for a single element's worth of data [1, 4, or 5 fields]
+  switch (k1-k0) {
+    case 1:
+      matMultFixed<T,1>(M,ldm,A+k0,lda,B+k0,ldb,m,n,zero);
+      return;
+    case 4:
+      matMultFixed<T,4>(M,ldm,A+k0,lda,B+k0,ldb,m,n,zero);
+      return;
+    case 5:
+      matMultFixed<T,5>(M,ldm,A+k0,lda,B+k0,ldb,m,n,zero);
+      return;
+  }
+
+  /* General case: loop over blocks of columns so that the working set of
+   * A & B stays in cache, and let the innermost (unit-stride) loop vectorize */
+  for (uint kb=k0; kb<k1; kb+=MATMULT_BLOCK_COLS) {
+    uint ke = std::min(kb+MATMULT_BLOCK_COLS,k1);
+
+    for (uint i=0; i<m; i++) {
+      T* __restrict__ Bi = B+i*ldb;
+
+      if (zero)
+        for (uint k=kb; k<ke; k++)
+          Bi[k] = 0;
+
+      for (uint j=0; j<n; j++) {
+        const T Mij = M[i*ldm+j];
+        const T* __restrict__ Aj = A+j*lda;
+        for (uint k=kb; k<ke; k++)
+          Bi[k] += Mij*Aj[k];
       }
     }
   }
 }
 
+//! Calculate B (+)= M*A, where M is [m x n] and A is [n x p]
+template<typename T>
+static void matMult(const T* M, uint ldm, const T* A, uint lda, T* B, uint ldb,
+                    uint m, uint n, uint p, bool zero)
+{
+#ifdef _OPENMP
+  /* For large batched operations (e.g. an operator applied to all elements of
+   * an eleBlock at once), split the columns of A & B among the threads */
+  if (p >= BATCH_GEMM_MIN_COLS && !omp_in_parallel()) {
+#pragma omp parallel
+    {
+      uint nThreads = omp_get_num_threads();
+      uint thread = omp_get_thread_num();
+      uint k0 = (p*thread) / nThreads;
+      uint k1 = (p*(thread+1)) / nThreads;
+      matMultCols(M,ldm,A,lda,B,ldb,m,n,k0,k1,zero);
+    }
+    return;
+  }
+#endif
+
+  matMultCols(M,ldm,A,lda,B,ldb,m,n,0,p,zero);
+}
+
+#ifdef _BLAS
+//! Use the external BLAS library's DGEMM for all double-precision matrix products
+static void matMult(const double* M, uint ldm, const double* A, uint lda, double* B, uint ldb,
+                    uint m, uint n, uint p, bool zero)
+{
+  if (m == 0 || p == 0) return;
+
+  if (n == 0) {
+    if (zero)
+      for (uint i=0; i<m; i++)
+        for (uint k=0; k<p; k++)
+          B[i*ldb+k] = 0;
+    return;
+  }
+
+  cblas_dgemm(CblasRowMajor,CblasNoTrans,CblasNoTrans,m,p,n,1.0,M,ldm,A,lda,(zero) ? 0.0 : 1.0,B,ldb);
+}
+#endif
+
 template <typename T>
-void matrix<T>::timesMatrixPlus(matrix<T> &A, matrix<T> &B)
+void matrix<T>::timesMatrix(matrix<T> &A, matrix<T> &B)
 {
-  uint i, j, k, p;
-  p = A.dims[1];
+#ifdef _DEBUG
+  if (A.dims[0] != this->dims[1]) FatalErrorST("Incompatible matrix sizes in matrix multiplication!");
+#endif
+  if (B.dims[0] != this->dims[0] || B.dims[1] != A.dims[1]) B.setup(this->dims[0], A.dims[1]);
+
+  matMult(this->dataPtr,this->stride,A.dataPtr,A.stride,B.dataPtr,B.stride,
+          this->dims[0],this->dims[1],A.dims[1],true);
+}
 
+template <typename T>
+void matrix<T>::timesMatrixPlus(matrix<T> &A, matrix<T> &B)
+{
+#ifdef _DEBUG
   if (A.dims[0] != this->dims[1]) FatalErrorST("Incompatible matrix sizes in matrix multiplication!");
+#endif
   if (B.dims[0] != this->dims[0] || B.dims[1] != A.dims[1]) B.setup(this->dims[0], A.dims[1]);
 
-  for (i=0; i<this->dims[0]; i++) {
-    for (j=0; j<this->dims[1]; j++) {
-      for (k=0; k<p; k++) {
-        B[i][k] += this->data[i*this->dims[1]+j]*A[j][k];
-      }
-    }
-  }
+  matMult(this->dataPtr,this->stride,A.dataPtr,A.stride,B.dataPtr,B.stride,
+          this->dims[0],this->dims[1],A.dims[1],false);
 }
 
 template <typename T>
@@ -308,7 +536,7 @@ void matrix<T>::timesVector(vector<T> &A, vector<T> &B)
   for (i=0; i<this->dims[0]; i++) {
     B[i] = 0;
     for (j=0; j<this->dims[1]; j++) {
-      B[i] += this->data[i*this->dims[1]+j]*A[j];
+      B[i] += this->dataPtr[i*this->stride+j]*A[j];
     }
   }
 }
@@ -316,18 +544,25 @@ void matrix<T>::timesVector(vector<T> &A, vector<T> &B)
 template<typename T>
 void Array2D<T>::appendRows(Array2D<T> &mat)
 {
+  if (this->isView) FatalErrorST("Cannot resize an Array view.");
+
   if (this->dims[1]!= 0 && mat.getDim1()!=this->dims[1])
     FatalErrorST("Attempting to append rows of wrong size to matrix.");
 
-  this->data.insert(this->data.end(),mat.getData(),mat.getData()+mat.getSize());
+  for (uint i=0; i<mat.getDim0(); i++)
+    this->data.insert(this->data.end(),mat[i],mat[i]+mat.getDim1());
 
   if (this->dims[1]==0) this->dims[1]=mat.getDim1();
   this->dims[0]+=mat.getDim0();
+
+  this->resetDataPtr();
 }
 
 template<typename T>
 void Array2D<T>::insertRow(const vector<T> &vec, int rowNum)
 {
+  if (this->isView) FatalErrorST("Cannot resize an Array view.");
+
   if (this->dims[1]!= 0 && vec.size()!=this->dims[1])
     FatalErrorST("Attempting to assign row of wrong size to matrix.");
 
@@ -341,11 +576,15 @@ void Array2D<T>::insertRow(const vector<T> &vec, int rowNum)
 
   if (this->dims[1]==0) this->dims[1]=vec.size(); // This may not be needed (i.e. may never have this->dims[1]==0). need to verify how I set up this->dims[0], this->dims[1]...
   this->dims[0]++;
+
+  this->resetDataPtr();
 }
 
 template<typename T>
 void Array2D<T>::insertRow(T *vec, int rowNum, int length)
 {
+  if (this->isView) FatalErrorST("Cannot resize an Array view.");
+
   if (this->dims[1]!=0 && length!=(int)this->dims[1])
     FatalErrorST("Attempting to assign row of wrong size to matrix.");
 
@@ -364,12 +603,16 @@ void Array2D<T>::insertRow(T *vec, int rowNum, int length)
   }
 
   this->dims[0]++;
+
+  this->resetDataPtr();
 }
 
 
 template<typename T>
 void Array2D<T>::insertRowUnsized(const vector<T> &vec)
 {
+  if (this->isView) FatalErrorST("Cannot resize an Array view.");
+
   // Add row to end, and resize matrix (add columns) if needed
   if (vec.size() > this->dims[1]) addCols(vec.size()-this->dims[1]);
 
@@ -385,11 +628,15 @@ void Array2D<T>::insertRowUnsized(const vector<T> &vec)
   }
 
   this->dims[0]++;
+
+  this->resetDataPtr();
 }
 
 template<typename T>
 void Array2D<T>::insertRowUnsized(T* vec, uint length)
 {
+  if (this->isView) FatalErrorST("Cannot resize an Array view.");
+
   // Add row to end, and resize matrix (add columns) if needed
   if (length > this->dims[1]) addCols(length-this->dims[1]);
 
@@ -405,11 +652,15 @@ void Array2D<T>::insertRowUnsized(T* vec, uint length)
   }
 
   this->dims[0]++;
+
+  this->resetDataPtr();
 }
 
 template<typename T>
 void Array2D<T>::addCol(void)
 {
+  if (this->isView) FatalErrorST("Cannot resize an Array view.");
+
   typename vector<T>::iterator it;
   for (uint row=0; row<this->dims[0]; row++) {
     it = this->data.begin() + (row+1)*(this->dims[1]+1) - 1;
@@ -417,22 +668,30 @@ void Array2D<T>::addCol(void)
   }
 
   this->dims[1]++;
+
+  this->resetDataPtr();
 }
 
 template<typename T>
 void Array2D<T>::addCols(int nCols)
 {
+  if (this->isView) FatalErrorST("Cannot resize an Array view.");
+
   typename vector<T>::iterator it;
   for (uint row=0; row<this->dims[0]; row++) {
     it = this->data.begin() + (row+1)*(this->dims[1]+nCols) - nCols;
     this->data.insert(it,nCols,(T)0);
   }
   this->dims[1] += nCols;
+
+  this->resetDataPtr();
 }
 
 template<typename T>
 void Array2D<T>::removeCols(int nCols)
 {
+  if (this->isView) FatalErrorST("Cannot resize an Array view.");
+
   if (nCols == 0) return;
 
   typename vector<T>::iterator it;
@@ -441,6 +700,8 @@ void Array2D<T>::removeCols(int nCols)
     this->data.erase(it-nCols,it);
   }
   this->dims[1] -= nCols;
+
+  this->resetDataPtr();
 }
 
 template<typename T>
@@ -449,7 +710,7 @@ vector<T> Array2D<T>::getRow(uint row)
   if (row > this->dims[0]) FatalErrorST("Attempting to grab row beyond end of matrix.");
 
   vector<T> out;
-  out.assign(&(this->data[row*this->dims[1]]),&(this->data[row*this->dims[1]])+this->dims[1]);
+  out.assign(&(this->dataPtr[row*this->stride]),&(this->dataPtr[row*this->stride])+this->dims[1]);
   return out;
 }
 
@@ -457,7 +718,7 @@ template<typename T>
 Array2D<T> Array2D<T>::getRows(vector<int> ind)
 {
   matrix<T> out;
-  for (auto& i:ind) out.insertRow(&(this->data[i*this->dims[1]]),-1,this->dims[1]);
+  for (auto& i:ind) out.insertRow(&(this->dataPtr[i*this->stride]),-1,this->dims[1]);
   return out;
 }
 
@@ -465,7 +726,7 @@ template<typename T>
 vector<T> Array2D<T>::getCol(int col)
 {
   vector<T> out;
-  for (uint i=0; i<this->dims[0]; i++) out.push_back(this->data[i*this->dims[1]+col]);
+  for (uint i=0; i<this->dims[0]; i++) out.push_back(this->dataPtr[i*this->stride+col]);
   return  out;
 }
 
@@ -500,13 +761,13 @@ Array2D<T> Array2D<T>::slice(array<int,2> rows, array<int,2> cols)
 template<typename T>
 void matrix<T>::print(int prec) const
 {
-  if (this->data.size()>0) {
+  if (this->dims[0]*this->dims[1]>0) {
     cout << endl;
     cout.setf(ios::fixed, ios::floatfield);
     cout.precision(prec);
     for (uint i=0; i<this->dims[0]; i++) {
       for (uint j=0; j<this->dims[1]; j++) {
-        cout << setw(prec+4) << left << this->data[i*this->dims[1]+j] << " ";
+        cout << setw(prec+4) << left << this->dataPtr[i*this->stride+j] << " ";
       }
       cout << endl;
     }
@@ -517,8 +778,9 @@ void matrix<T>::print(int prec) const
 template<typename T>
 bool matrix<T>::checkNan(void)
 {
-  for (auto& i:this->data)
-    if (std::isnan(i)) return true;
+  for (uint i=0; i<this->dims[0]; i++)
+    for (uint j=0; j<this->dims[1]; j++)
+      if (std::isnan(this->dataPtr[i*this->stride+j])) return true;
 
   return false;
 }
@@ -532,31 +794,57 @@ void matrix<T>::unique(matrix<T>& out, vector<int> &iRow)
   iRow.resize(this->dims[0]);
   iRow.assign(this->dims[0],-1);
 
-  /* --- For each row in the matrix, compare to all
-     previous rows to get first unique occurence --- */
-  typename vector<T>::iterator itI, itJ;
+  uint nCols = this->dims[1];
+
+  /* --- Open-addressed hash table of the unique rows found so far [entries
+     are row indices in 'out'], so each row is compared only against rows
+     with the same hash; rows appear in 'out' in order of first occurrence --- */
+  uint size = 16;
+  while (size < 2*this->dims[0]) size *= 2;
+  vector<int> table(size,-1);
+  vector<size_t> hashes;
+  hashes.reserve(this->dims[0]);
+
+  vector<T> rows;  // Unique rows, as a flat array
+  rows.reserve(this->dims[0]*nCols);
+
+  std::hash<T> hashT;
   for (uint i=0; i<this->dims[0]; i++) {
-    itI = this->data.begin() + i*this->dims[1];
-    for (uint j=0; j<i; j++) {
-      itJ = this->data.begin() + j*this->dims[1];
-      if (equal(itI,itI+this->dims[1],itJ)) {
-        iRow[i] = iRow[j];
+    T *itI = this->dataPtr + i*this->stride;
+
+    size_t h = 0;
+    for (uint j=0; j<nCols; j++)
+      h ^= hashT(itI[j]) + 0x9e3779b9 + (h<<6) + (h>>2);
+
+    uint slot = h & (size-1);
+    while (table[slot] != -1) {
+      int r = table[slot];
+      if (hashes[r] == h && equal(itI,itI+nCols,&rows[r*nCols])) {
+        iRow[i] = r;
         break;
       }
+      slot = (slot+1) & (size-1);
     }
 
-    // If no prior occurance found, put in 'out' matrix
+    // If no prior occurance found, add to the unique rows
     if (iRow[i]==-1) {
-      out.insertRow(&(this->data[i*this->dims[1]]),-1,this->dims[1]);
-      iRow[i] = out.getDim0() - 1;
+      iRow[i] = hashes.size();
+      table[slot] = iRow[i];
+      hashes.push_back(h);
+      rows.insert(rows.end(),itI,itI+nCols);
     }
   }
+
+  if (!hashes.empty()) {
+    out.setup(hashes.size(),nCols);
+    std::copy(rows.begin(),rows.end(),out.getData());
+  }
 }
 
 template<typename T, uint N>
 T *Array<T,N>::getData(void)
 {
-  return data.data();
+  return dataPtr;
 }
 
 template<typename T>
@@ -786,11 +1074,11 @@ double matrix<T>::det()
     FatalErrorST("Determinant only meaningful for square matrices.");
 
   if (this->dims[0] == 1) {
-    return this->data[0];
+    return this->operator()(0,0);
   }
   else if (this->dims[0] == 2) {
     // Base case
-    return this->data[0]*this->data[3] - this->data[1]*this->data[2];
+    return this->operator()(0,0)*this->operator()(1,1) - this->operator()(0,1)*this->operator()(1,0);
   }
   else {
     // Use minor-matrix recursion
@@ -855,7 +1143,9 @@ template<typename T>
 T matrix<T>::frobNorm(void)
 {
   T norm = 0;
-  for (auto &val:this->data) norm += val*val;
+  for (uint i=0; i<this->dims[0]; i++)
+    for (uint j=0; j<this->dims[1]; j++)
+      norm += this->dataPtr[i*this->stride+j]*this->dataPtr[i*this->stride+j];
   return norm;
 }
 
@@ -868,7 +1158,7 @@ void matrix<T>::vecToMatrixResize(vector<T> &A)
   }
   else {
     for(uint i=0; i<A.size(); i++)
-      this->data[i] = A[i];
+      this->dataPtr[(i/this->dims[1])*this->stride + i%this->dims[1]] = A[i];
   }
 }
 
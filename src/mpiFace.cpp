@@ -63,15 +63,9 @@ void mpiFace::finishRightSetup(void)
   MPI_Wait(&nFpts_in,MPI_STATUSES_IGNORE);
   MPI_Wait(&nFpts_out,MPI_STATUSES_IGNORE);
 
-  /* --- Will have to introduce 'mortar' elements in the future [for p-adaptation],
-   * but for now just force all faces to have same # of flux points [order] --- */
-
-  if (nFptsL != nFptsR)
-    FatalError("Mortar elements not yet implemented - must have nFptsL==nFptsR");
-
-  /* --- Setup the L/R flux-point matching ---
+  /* --- Setup the L/R flux-point matching [right points, as ordered on the left face] ---
    * NOTE THAT THIS IS DIFFERENT THAN IN intFaces */
-  fptR.resize(nFptsL);
+  fptR.resize(nFptsR);
   if (nDims == 2) {
     // For 1D faces [line segments] only - find first/last ID of fpts;
     // right faces's points are simply reversed
@@ -86,8 +80,8 @@ void mpiFace::finishRightSetup(void)
   }
   else if (nDims == 3) {
     // Only for quad tensor-product faces: Rotate the face to the correct relative orientation
-    int order = sqrt(nFptsL)-1;
-    for (int i=0; i<nFptsL; i++) {
+    int order = sqrt(nFptsR)-1;
+    for (int i=0; i<nFptsR; i++) {
       int ifpt = i%(order+1);
       int jfpt = floor(i/(order+1));
       switch (relRot) {
@@ -98,19 +92,26 @@ void mpiFace::finishRightSetup(void)
           fptR[i] = order-ifpt + jfpt*(order+1);
           break;
         case 2:
-          fptR[i] = nFptsL-1 - (ifpt*(order+1) + jfpt);
+          fptR[i] = nFptsR-1 - (ifpt*(order+1) + jfpt);
           break;
         case 3:
-          fptR[i] = nFptsL - (order+1)*(jfpt+1) + ifpt;
+          fptR[i] = nFptsR - (order+1)*(jfpt+1) + ifpt;
           break;
       }
     }
   }
 
-  UR.setup(nFptsR,nFields);
+  /* --- Elements of different order [p-adaptation]: each side computes the
+   * common flux at its own flux points, from the other side's interpolated trace --- */
+  if (nFptsL != nFptsR) {
+    int orderR = (nDims == 2) ? nFptsR-1 : sqrt(nFptsR)-1;
+    setupMortar(orderR);
+  }
+
   bufUR.setup(nFptsR,nFields);
   bufGradUR.setup(nFptsR,nDims,nFields); // !! TEMP HACK !!  need 3D matrix/array
-  bufGradUL.setup(nFptsR,nDims,nFields); // !! TEMP HACK !!
+  if (params->viscScheme == 1)
+    bufLiftR.resize(nFptsR);
 #endif
 }
 
@@ -119,82 +120,124 @@ void mpiFace::getPointersRight()
   // Do nothing
 }
 
-void mpiFace::communicate(void)
+double* mpiFace::communicate(double* sendBuf)
 {
   getLeftState();
 
-#ifndef _NO_MPI
-  /* Send/Get data to/from right element [order reversed to match left ele] */
+  for (int fpt=0; fpt<nFptsL; fpt++)
+    for (int k=0; k<nFields; k++)
+      *(sendBuf++) = UL(fpt,k);
 
-  // The send/receive pairs are tagged by the processor-local face ID of the
-  // face on the receiving end of the call
-  MPI_Irecv(bufUR.getData(),UR.getSize(),MPI_DOUBLE,procR,ID,myComm,&UR_in);
-  MPI_Isend(UL.getData(),UL.getSize(),MPI_DOUBLE,procR,IDR,myComm,&UL_out);
-#endif
+  if (params->viscScheme == 1) {
+    // BR2: no separate gradient exchange
+    getLeftGradient();
+
+    for (int fpt=0; fpt<nFptsL; fpt++)
+      for (int dim=0; dim<nDims; dim++)
+        for (int k=0; k<nFields; k++)
+          *(sendBuf++) = gradUL[fpt](dim,k);
+
+    for (int fpt=0; fpt<nFptsL; fpt++)
+      *(sendBuf++) = liftL[fpt];
+  }
+
+  return sendBuf;
 }
 
-void mpiFace::communicateGrad(void)
+double* mpiFace::communicateGrad(double* sendBuf)
 {
-#ifndef _NO_MPI
-  /* Send/Get data to/from right element [order reversed to match left ele] */
+  getLeftGradient();
 
-  // The send/receive pairs are tagged by the processor-local face ID of the
-  // face on the receiving end of the call
-  if (params->viscous) {
-    getLeftGradient();
+  for (int fpt=0; fpt<nFptsL; fpt++)
+    for (int dim=0; dim<nDims; dim++)
+      for (int k=0; k<nFields; k++)
+        *(sendBuf++) = gradUL[fpt](dim,k);
 
-    // !!! TEMP HACK !!! Just until I update Matrix class to 3D+
-    for (int i=0; i<nFptsL; i++)
-      for (int j=0; j<nDims; j++)
-        for (int k=0; k<nFields; k++)
-          bufGradUL(i,j,k) = gradUL[i](j,k);
+  return sendBuf;
+}
+
+const double* mpiFace::receive(const double* recvBuf)
+{
+  for (int fpt=0; fpt<nFptsR; fpt++)
+    for (int k=0; k<nFields; k++)
+      bufUR(fpt,k) = *(recvBuf++);
+
+  if (params->viscScheme == 1) {
+    recvBuf = receiveGrad(recvBuf);
 
-    MPI_Irecv(bufGradUR.getData(),bufGradUR.getSize(),MPI_DOUBLE,procR,ID,myComm,&gradUR_in);
-    MPI_Isend(bufGradUL.getData(),bufGradUL.getSize(),MPI_DOUBLE,procR,IDR,myComm,&gradUL_out);
+    for (int fpt=0; fpt<nFptsR; fpt++)
+      bufLiftR[fpt] = *(recvBuf++);
   }
-#endif
+
+  return recvBuf;
+}
+
+const double* mpiFace::receiveGrad(const double* recvBuf)
+{
+  for (int fpt=0; fpt<nFptsR; fpt++)
+    for (int dim=0; dim<nDims; dim++)
+      for (int k=0; k<nFields; k++)
+        bufGradUR(fpt,dim,k) = *(recvBuf++);
+
+  return recvBuf;
 }
 
 void mpiFace::getRightState(void)
 {
-#ifndef _NO_MPI
-  // Make sure the communication is complete & transfer from buffer
-  MPI_Wait(&UL_out,&status);
-  MPI_Wait(&UR_in,&status);
-
-  // Copy UR from the buffer to the proper matrix [note that the order of the
-  // fpts is reversed between the two faces]
-  int fpt = 0;
-  for (int i=0; i<nFptsL; i++) {
-    for (int j=0; j<nFields; j++)
-      UR(fpt,j) = bufUR(fptR[i],j);
-
-    fpt++;
+  // Transfer from the receive buffer [filled by faceComm; note that the order
+  // of the fpts is reversed between the two faces]
+  if (nFptsR == nFptsL) {
+    int fpt = 0;
+    for (int i=0; i<nFptsL; i++) {
+      for (int j=0; j<nFields; j++)
+        UR(fpt,j) = bufUR(fptR[i],j);
+
+      fpt++;
+    }
+  }
+  else {
+    for (int fpt=0; fpt<nFptsL; fpt++) {
+      for (int j=0; j<nFields; j++) {
+        double val = 0;
+        for (int i=0; i<nFptsR; i++)
+          val += interpR(fpt,i) * bufUR(fptR[i],j);
+        UR(fpt,j) = val;
+      }
+    }
+  }
+
+  // BR2 lifting factor [equal orders only]
+  if (params->viscScheme == 1) {
+    for (int fpt=0; fpt<nFptsR; fpt++)
+      liftR[fpt] = bufLiftR[fptR[fpt]];
   }
-#endif
 }
 
 void mpiFace::getRightGradient(void)
 {
-#ifndef _NO_MPI
-  // Make sure the communication is complete & transfer from buffer
+  // Transfer from the receive buffer [filled by faceComm; note that the order
+  // of the fpts is reversed between the two faces]
   if (params->viscous) {
-    MPI_Wait(&gradUL_out,&status);
-    MPI_Wait(&gradUR_in,&status);
-
-    // Copy UR from the buffer to the proper matrix [note that the order of the
-    // fpts is reversed between the two faces]
-    int fpt = 0;
-    for (int i=0; i<nFptsL; i++) {
-      for (int j=0; j<nFields; j++)
+    if (nFptsR == nFptsL) {
+      for (int fpt=0; fpt<nFptsL; fpt++) {
         for (int dim=0; dim<nDims; dim++)
           for (int j=0; j<nFields; j++)
-            gradUR[fpt](dim,j) = bufGradUR(fptR[i],dim,j);
-
-      fpt++;
+            gradUR[fpt](dim,j) = bufGradUR(fptR[fpt],dim,j);
+      }
+    }
+    else {
+      for (int fpt=0; fpt<nFptsL; fpt++) {
+        for (int dim=0; dim<nDims; dim++) {
+          for (int j=0; j<nFields; j++) {
+            double val = 0;
+            for (int i=0; i<nFptsR; i++)
+              val += interpR(fpt,i) * bufGradUR(fptR[i],dim,j);
+            gradUR[fpt](dim,j) = val;
+          }
+        }
+      }
     }
   }
-#endif
 }
 
 void mpiFace::setRightStateFlux(void)
@@ -211,16 +254,18 @@ void mpiFace::setRightStateSolution(void)
 #endif
 }
 
-vector<double> mpiFace::computeWallForce()
+void mpiFace::computeWallForce(double*)
+{
+  // Not a wall boundary - no contribution
+}
+
+void mpiFace::computeMassFlux(double*)
 {
-  // Not a wall boundary - return 0
-  vector<double> force = {0,0,0,0,0,0};
-  return force;
+  // Not an inlet/outlet boundary - no contribution
 }
 
-vector<double> mpiFace::computeMassFlux()
+void mpiFace::addMemUsage(memTally &mem)
 {
-  // Not an inlet/outlet boundary - return 0
-  vector<double> force(nFields);
-  return force;
+  face::addMemUsage(mem);
+  mem.add("mpiFace", memBytes(fptR, normR, dAR, detJacR, bufUR, bufGradUR, bufLiftR));
 }
@@ -31,6 +31,7 @@
 #include "multigrid.hpp"
 
 #include <sstream>
+#include <unordered_map>
 #include <omp.h>
 
 #include "input.hpp"
@@ -42,45 +43,119 @@ void multiGrid::setup(int order, input *params, solver &Solver)
   this->order = order;
   this->params = params;
 
+  if (params->lowOrder >= order)
+    FatalError("PMG lowOrder must be less than the solution order.");
+
   pInputs.assign(order, *params);
   pGrids.resize(order);
 
-  /* H-P Multigrid using Refinement Method */
+  /* H-P Multigrid: the h-levels lie below the coarsest [P = 0] p-level */
   if (params->HMG)
   {
     if (params->lowOrder != 0)
       FatalError("H-Multigrid only supported for PMG lowOrder = 0.");
 
-    if (params->nDims == 3)
-      FatalError("H-Multigrid only supported for 2D currently.");
+    int nH = params->n_h_levels;
+    hInputs.assign(nH, *params);
+    hGrids.resize(nH);
+    hGeos.resize(nH);
+    parent_cells.resize(nH);
+
+    if (params->HMG == 1)
+    {
+      /* Refinement method: the input mesh is the coarsest h-level */
+      if (params->nDims == 3)
+        FatalError("H-Multigrid by refinement only supported for 2D; use HMG = 2 [agglomeration] in 3D.");
 
-    geo coarse_grid;
-    coarse_grid.setup(params,true);
+      geo coarse_grid;
+      coarse_grid.setup(params,true);
 
-    hInputs.assign(params->n_h_levels, *params);
-    hGrids.resize(params->n_h_levels);
-    hGeos.resize(params->n_h_levels);
-    pGeos.resize(params->order);
+      for (int H = 0; H < nH; H++)
+      {
+        if (params->rank == 0) cout << endl << "H-Multigrid: Setting up H = " << H << endl;
 
-    for (int H = 0; H < params->n_h_levels; H++)
+        hGeos[H] = make_shared<geo>();
+
+        /* Refine the initial coarse grid to produce the fine grids */
+        setup_h_level(coarse_grid, *hGeos[H], nH - H - 1);
+
+        /* Cell ic*4^L + i*2^L + j of a grid refined L times lies in cell
+         * ic*4^(L-1) + (i/2)*2^(L-1) + j/2 of the grid refined L-1 times */
+        int L = nH - H;
+        int nSide = 1 << L;
+        int nSplit = nSide * nSide;
+        parent_cells[H].resize(coarse_grid.nEles * nSplit);
+        for (uint ic = 0; ic < parent_cells[H].size(); ic++)
+        {
+          int i = (ic % nSplit) / nSide;
+          int j = ic % nSide;
+          parent_cells[H][ic] = (ic / nSplit) * nSplit / 4 + (i/2) * nSide / 2 + j/2;
+        }
+      }
+
+      /* Create final fine grid */
+      if (params->rank == 0) cout << endl << "H-Multigrid: Setting up fine grid" << endl;
+      fine_grid = make_shared<geo>();
+      setup_h_level(coarse_grid, *fine_grid, nH);
+    }
+    else
     {
-      if (params->rank == 0) cout << endl << "H-Multigrid: Setting up H = " << H << endl;
+      /* Agglomeration method: the input mesh is the finest level; each coarser
+       * h-level merges the cells of the one above it */
+      vector<geo> levels(nH+1);
+      levels[0].setup(params,true);
 
+      for (int H = 0; H < nH; H++)
+      {
+        if (params->rank == 0) cout << endl << "H-Multigrid: Agglomerating H = " << H << endl;
+        levels[H+1].agglomerate(levels[H], parent_cells[H]);
+      }
+
+      /* Partition the coarsest level; every cell then lies on the same rank
+       * as all of its children */
+      vector<vector<int>> eparts(nH+1);
+#ifndef _NO_MPI
+      if (params->nproc > 1)
+      {
+        geo coarsest = levels[nH];
+        coarsest.getMpiPartitions();
+        eparts[nH] = coarsest.epart;
+        for (int H = nH-1; H >= 0; H--)
+        {
+          eparts[H].resize(levels[H].nEles);
+          for (int ic = 0; ic < levels[H].nEles; ic++)
+            eparts[H][ic] = eparts[H+1][parent_cells[H][ic]];
+        }
+      }
+#endif
+
+      for (int H = 0; H < nH; H++)
+      {
+        if (params->rank == 0) cout << endl << "H-Multigrid: Setting up H = " << H << endl;
+        hGeos[H] = make_shared<geo>(levels[H+1]);
+        hGeos[H]->setup_hmg(params, 0, params->rank, params->nproc, {0}, eparts[H+1]);
+      }
+
+      if (params->rank == 0) cout << endl << "H-Multigrid: Setting up fine grid" << endl;
+      fine_grid = make_shared<geo>(levels[0]);
+      fine_grid->setup_hmg(params, 0, params->rank, params->nproc, {0}, eparts[0]);
+    }
+
+    for (int H = 0; H < nH; H++)
+    {
       hInputs[H].dataFileName += "_H" + std::to_string(H) + "_";
-      hGrids[H] = make_shared<solver>();
-      hGeos[H] = make_shared<geo>();
 
-      /* Refine the initial coarse grid to produce the fine grids */
-      setup_h_level(coarse_grid, *hGeos[H], params->n_h_levels - H - 1);
+      /* The h-levels are P = 0; getCFLLimit is for 1D, and their explicit
+       * stability limit drops by about nDims on quads / hexes */
+      hInputs[H].CFL /= params->nDims;
 
+      hGrids[H] = make_shared<solver>();
       hGrids[H]->setup(&hInputs[H], params->lowOrder, &(*hGeos[H]));
       hGrids[H]->initializeSolution(true);
     }
 
-    /* Create final fine grid and re-setup the given solver */
+    /* Re-setup the given solver on the fine grid */
     if (params->rank == 0) cout << endl << "H-Multigrid: Setting up fine grid solver" << endl;
-    fine_grid = make_shared<geo>();
-    setup_h_level(coarse_grid, *fine_grid, params->n_h_levels);
     Solver.setup(params, order, &(*fine_grid));
     Solver.initializeSolution();
 
@@ -96,18 +171,28 @@ void multiGrid::setup(int order, input *params, solver &Solver)
         if (params->rank == 0) cout << endl << "P-Multigrid: Setting up P = " << P << endl;
 
         pInputs[P].dataFileName += "_P" + std::to_string(P) + "_";
-        pGeos[P] = make_shared<geo>(*fine_grid);
         pGrids[P] = make_shared<solver>();
-
-        pGeos[P]->setup_hmg(&pInputs[P], fine_grid->gridID, fine_grid->gridRank, fine_grid->nProcGrid, fine_grid->gridIdList);
-        pGrids[P]->setup(&pInputs[P], P, &(*pGeos[P]));
+        pGrids[P]->setup(&pInputs[P], P, &(*fine_grid));
         pGrids[P]->initializeSolution(true);
       }
     }
+
+    child_cells.resize(nH);
+    setup_children(*pGrids[params->lowOrder], *hGrids[0], parent_cells[0], child_cells[0]);
+    for (int H = 1; H < nH; H++)
+      setup_children(*hGrids[H-1], *hGrids[H], parent_cells[H], child_cells[H]);
   }
 
   /* P-Multigrid Alone */
   else {
+    if (params->rank == 0) cout << endl << "P-Multigrid: Setting up P = " << params->order << endl;
+    Solver.setup(params, params->order);
+    Solver.initializeSolution();
+
+    /* The coarse levels can share the fine level's mesh & connectivity as long
+     * as it never changes */
+    bool shareGeo = (params->meshType != OVERSET_MESH && !params->motion);
+
     /* Instantiate coarse grid solvers */
     for (int P = 0; P < order; P++)
     {
@@ -121,20 +206,37 @@ void multiGrid::setup(int order, input *params, solver &Solver)
 
         pInputs[P].dataFileName += "_P" + std::to_string(P) + "_";
         pGrids[P] = make_shared<solver>();
-        pGrids[P]->setup(&pInputs[P], P);
+        pGrids[P]->setup(&pInputs[P], P, (shareGeo) ? Solver.Geo : NULL);
         pGrids[P]->initializeSolution(true);
       }
     }
-
-    if (params->rank == 0) cout << endl << "P-Multigrid: Setting up P = " << params->order << endl;
-    Solver.setup(params, params->order);
-    Solver.initializeSolution();
   }
 
   /* Still some weird bug in initialization of PMG solvers; this is a
    * workaround for the moment */
   cycle(Solver);
   Solver.initializeSolution();
+
+  if (params->mgCycle == 2 && !params->restart)
+    full_multigrid(Solver);
+}
+
+void multiGrid::addMemUsage(memTally &mem, solver &Solver)
+{
+  auto levelBytes = [&](solver &grid) {
+    memTally level;
+    grid.addMemUsage(level);
+    if (grid.Geo != Solver.Geo)
+      grid.Geo->addMemUsage(level);
+    return level.total();
+  };
+
+  for (uint P = 0; P < pGrids.size(); P++)
+    if (pGrids[P])
+      mem.add("multigrid: P" + std::to_string(P), levelBytes(*pGrids[P]));
+
+  for (uint H = 0; H < hGrids.size(); H++)
+    mem.add("multigrid: H" + std::to_string(H), levelBytes(*hGrids[H]) + memBytes(parent_cells[H], child_cells[H]));
 }
 
 void multiGrid::setup_h_level(geo &mesh_c, geo &mesh_f, int refine_level)
@@ -160,151 +262,201 @@ void multiGrid::setup_h_level(geo &mesh_c, geo &mesh_f, int refine_level)
   mesh_f.setup_hmg(params, mesh_c.gridID, mesh_c.gridRank, mesh_c.nProcGrid, mesh_c.gridIdList, epart);
 }
 
+void multiGrid::setup_children(solver &grid_f, solver &grid_c, const vector<int> &parent, matrix<int> &children)
+{
+  /* The cells may have been re-ordered or partitioned: match them by global ID */
+  unordered_map<int,int> icg2e;
+  for (uint e = 0; e < grid_c.eles.size(); e++)
+    icg2e[grid_c.eles[e]->IDg] = e;
+
+  vector<vector<int>> kids(grid_c.eles.size());
+  for (uint e = 0; e < grid_f.eles.size(); e++)
+  {
+    auto it = icg2e.find(parent[grid_f.eles[e]->IDg]);
+    if (it == icg2e.end())
+      FatalError("H-Multigrid: parent cell not found on this rank.");
+    kids[it->second].push_back(e);
+  }
+
+  uint maxKids = 1;
+  for (auto &k : kids)
+    maxKids = std::max(maxKids, (uint)k.size());
+
+  children.setup(grid_c.eles.size(), maxKids);
+  children.initializeToValue(-1);
+  for (uint e = 0; e < kids.size(); e++)
+    for (uint j = 0; j < kids[e].size(); j++)
+      children(e,j) = kids[e][j];
+}
+
 void multiGrid::cycle(solver &Solver)
 {
-  /* Update residual on finest grid level and restrict */
+  /* Update residual on finest grid level, then restrict, cycle, and correct */
   Solver.calcResidual(0);
 
-  restrict_pmg(Solver, *pGrids[order-1]);
+  coarse_correction(Solver, order-1);
+}
 
-  for (int P = order-1; P >= (int) params->lowOrder; P--)
-  {
-    /* Generate source term */
-    compute_source_term(*pGrids[P]);
+void multiGrid::coarse_correction(solver &grid_f, int P)
+{
+  restrict_pmg(grid_f, *pGrids[P]);
 
-    /* Copy initial solution to solution storage */
-#pragma omp parallel for
-    for (uint e = 0; e < pGrids[P]->eles.size(); e++)
-    {
-      pGrids[P]->eles[e]->sol_spts = pGrids[P]->eles[e]->U_spts;
-    }
+  /* Generate source term */
+  compute_source_term(*pGrids[P]);
 
-    /* Update solution on coarse level */
-    for (uint step = 0; step < params->smoothSteps; step++)
-    {
-      pGrids[P]->update(true);
-    }
+  /* Copy initial solution to solution storage */
+  store_solution(*pGrids[P]);
 
-    if (P-1 >= (int) params->lowOrder || params->HMG)
-    {
-      /* Update residual and add source */
-      pGrids[P]->calcResidual(0);
+  /* V-cycle: visit each coarse level once; W-cycle: twice */
+  int nCycles = (params->mgCycle == 1) ? 2 : 1;
+  for (int i = 0; i < nCycles; i++)
+    cycle_level(P);
 
-#pragma omp parallel for
-      for (uint e = 0; e < pGrids[P]->eles.size(); e++)
-      {
-        pGrids[P]->eles[e]->divF_spts[0] += pGrids[P]->eles[e]->src_spts;
-      }
+  /* Generate error, then prolong and add to fine grid solution */
+  compute_correction(*pGrids[P]);
+  prolong_err(*pGrids[P], grid_f);
+}
 
-      if (P-1 >= (int) params->lowOrder)
-      {
-        /* Restrict to next coarse grid */
-        restrict_pmg(*pGrids[P], *pGrids[P-1]);
-      }
-    }
+void multiGrid::cycle_level(int P)
+{
+  /* Update solution on coarse level */
+  for (uint step = 0; step < params->smoothSteps; step++)
+  {
+    pGrids[P]->update(true);
   }
 
-  if (params->HMG)
+  if (P-1 >= (int) params->lowOrder || params->HMG)
   {
-    /* Initial restriction to first HMG level */
-    restrict_hmg(*pGrids[params->lowOrder], *hGrids[0], 0);
-
-    for (int H = 0; H < params->n_h_levels; H++)
-    {
-      /* Generate source term */
-      compute_source_term(*hGrids[H]);
+    /* Update residual and add source */
+    pGrids[P]->calcResidual(0);
+    add_source_term(*pGrids[P]);
+
+    if (P-1 >= (int) params->lowOrder)
+      coarse_correction(*pGrids[P], P-1);
+    else
+      cycle_hmg();
+  }
 
-      /* Copy initial solution to solution storage */
-  #pragma omp parallel for
-      for (uint e = 0; e < hGrids[H]->eles.size(); e++)
-      {
-        hGrids[H]->eles[e]->sol_spts = hGrids[H]->eles[e]->U_spts;
-      }
+  /* Advance again (post-smoothing) */
+  for (uint step = 0; step < params->smoothSteps; step++)
+  {
+    pGrids[P]->update(true);
+  }
+}
 
-      /* Update solution on coarse level */
-      for (uint step = 0; step < params->smoothSteps; step++)
-      {
-        hGrids[H]->update(true);
-      }
+void multiGrid::cycle_hmg(void)
+{
+  /* Initial restriction to first HMG level */
+  restrict_hmg(*pGrids[params->lowOrder], *hGrids[0], 0);
 
-      if (H+1 < params->n_h_levels)
-      {
-        /* Update residual and add source */
-        hGrids[H]->calcResidual(0);
+  for (int H = 0; H < params->n_h_levels; H++)
+  {
+    /* Generate source term */
+    compute_source_term(*hGrids[H]);
 
-#pragma omp parallel for
-        for (uint e = 0; e < hGrids[H]->eles.size(); e++)
-        {
-          hGrids[H]->eles[e]->divF_spts[0] += hGrids[H]->eles[e]->src_spts;
-        }
+    /* Copy initial solution to solution storage */
+    store_solution(*hGrids[H]);
 
-        /* Restrict to next coarse grid */
-        restrict_hmg(*hGrids[H], *hGrids[H+1], H+1);
-      }
+    /* Update solution on coarse level */
+    for (uint step = 0; step < params->smoothSteps; step++)
+    {
+      hGrids[H]->update(true);
     }
 
-    /* --- Upward HMG Cycle --- */
-    for (int H = params->n_h_levels-1; H >= 0; H--)
+    if (H+1 < params->n_h_levels)
     {
-      /* Advance again (v-cycle)*/
-      for (unsigned int step = 0; step < params->smoothSteps; step++)
-      {
-        hGrids[H]->update(true);
-      }
-
-      /* Generate error */
-  #pragma omp parallel for
-      for (int e = 0; e < hGrids[H]->eles.size(); e++)
-      {
-        hGrids[H]->eles[e]->corr_spts  = hGrids[H]->eles[e]->U_spts;
-        hGrids[H]->eles[e]->corr_spts -= hGrids[H]->eles[e]->sol_spts;
-      }
+      /* Update residual and add source */
+      hGrids[H]->calcResidual(0);
+      add_source_term(*hGrids[H]);
 
-      /* Prolong error and add to fine grid solution */
-      if (H > 0)
-      {
-        prolong_hmg(*hGrids[H], *hGrids[H-1], H-1);
-      }
-      else
-      {
-        prolong_hmg(*hGrids[0], *pGrids[params->lowOrder], 0);
-      }
+      /* Restrict to next coarse grid */
+      restrict_hmg(*hGrids[H], *hGrids[H+1], H+1);
     }
   }
 
-  /* --- Upward PMG Cycle --- */
-  for (int P = (int) params->lowOrder; P <= order-1; P++)
+  /* --- Upward HMG Cycle --- */
+  for (int H = params->n_h_levels-1; H >= 0; H--)
   {
     /* Advance again (v-cycle)*/
     for (unsigned int step = 0; step < params->smoothSteps; step++)
     {
-      pGrids[P]->update(true);
+      hGrids[H]->update(true);
     }
 
     /* Generate error */
-#pragma omp parallel for
-    for (int e = 0; e < pGrids[P]->eles.size(); e++)
-    {
-      pGrids[P]->eles[e]->corr_spts  = pGrids[P]->eles[e]->U_spts;
-      pGrids[P]->eles[e]->corr_spts -= pGrids[P]->eles[e]->sol_spts;
-    }
+    compute_correction(*hGrids[H]);
 
     /* Prolong error and add to fine grid solution */
-    if (P < order-1)
+    if (H > 0)
+    {
+      prolong_hmg(*hGrids[H], *hGrids[H-1], H);
+    }
+    else
     {
-      prolong_err(*pGrids[P], *pGrids[P+1]);
+      prolong_hmg(*hGrids[0], *pGrids[params->lowOrder], 0);
     }
   }
+}
+
+void multiGrid::full_multigrid(solver &Solver)
+{
+  /* Nested iteration: start from the restricted initial condition on the
+   * coarsest level, and converge each level [with cycles on the levels below
+   * it] before interpolating its solution up to the next finer level */
+  if (params->rank == 0) cout << endl << "P-Multigrid: Full-multigrid start-up" << endl;
+
+  restrict_pmg(Solver, *pGrids[order-1], false);
+  for (int P = order-1; P > (int) params->lowOrder; P--)
+    restrict_pmg(*pGrids[P], *pGrids[P-1], false);
 
-  /* Prolong correction and add to finest grid solution */
-  prolong_err(*pGrids[order-1], Solver);
+  for (int P = params->lowOrder; P < order; P++)
+  {
+    auto &grid = *pGrids[P];
+
+    /* Each level in turn acts as the finest level [no source term] */
+#pragma omp parallel for
+    for (uint e = 0; e < grid.eles.size(); e++)
+      grid.eles[e]->src_spts.initializeToZero();
+
+    for (int iter = 0; iter < params->fmgCycles; iter++)
+    {
+      grid.update(true);
+
+      if (P-1 >= (int) params->lowOrder)
+      {
+        grid.calcResidual(0);
+        coarse_correction(grid, P-1);
+      }
+    }
+
+    if (P < order-1)
+      prolong_sol(grid, *pGrids[P+1]);
+    else
+      prolong_sol(grid, Solver);
+  }
 }
 
-void multiGrid::restrict_pmg(solver &grid_f, solver &grid_c)
+void multiGrid::restrict_pmg(solver &grid_f, solver &grid_c, bool residual)
 {
   if (grid_f.order - grid_c.order > 1)
     FatalError("Cannot restrict more than 1 order currently!");
 
+  /* Batched storage: one product per (eType,order) block */
+  if (!grid_f.eleBlocks.empty() && !grid_c.eleBlocks.empty())
+  {
+    for (auto &etype : grid_f.eleBlocks)
+    {
+      auto &b_f = etype.second[grid_f.order];
+      auto &b_c = grid_c.eleBlocks[etype.first][grid_c.order];
+      auto &opp_res = grid_f.opers[etype.first][grid_f.order].opp_restrict;
+
+      opp_res.timesMatrix(b_f.U_spts, b_c.U_spts);
+      if (residual)
+        opp_res.timesMatrix(b_f.divF_spts[0], b_c.divF_spts[0]);
+    }
+    return;
+  }
+
 #pragma omp parallel for
   for (uint e = 0; e < grid_f.eles.size(); e++)
   {
@@ -316,12 +468,24 @@ void multiGrid::restrict_pmg(solver &grid_f, solver &grid_c)
     opp_res.timesMatrix(e_f.U_spts, e_c.U_spts);
 
     /* Restrict residual */
-    opp_res.timesMatrix(e_f.divF_spts[0], e_c.divF_spts[0]);
+    if (residual)
+      opp_res.timesMatrix(e_f.divF_spts[0], e_c.divF_spts[0]);
   }
 }
 
 void multiGrid::prolong_err(solver &grid_c, solver &grid_f)
 {
+  if (!grid_c.eleBlocks.empty() && !grid_f.eleBlocks.empty())
+  {
+    for (auto &etype : grid_c.eleBlocks)
+    {
+      auto &b_c = etype.second[grid_c.order];
+      auto &b_f = grid_f.eleBlocks[etype.first][grid_f.order];
+      grid_c.opers[etype.first][grid_c.order].opp_prolong.timesMatrixPlus(b_c.corr_spts, b_f.U_spts);
+    }
+    return;
+  }
+
 #pragma omp parallel for
   for (uint e = 0; e < grid_c.eles.size(); e++)
   {
@@ -332,6 +496,29 @@ void multiGrid::prolong_err(solver &grid_c, solver &grid_f)
   }
 }
 
+void multiGrid::prolong_sol(solver &grid_c, solver &grid_f)
+{
+  if (!grid_c.eleBlocks.empty() && !grid_f.eleBlocks.empty())
+  {
+    for (auto &etype : grid_c.eleBlocks)
+    {
+      auto &b_c = etype.second[grid_c.order];
+      auto &b_f = grid_f.eleBlocks[etype.first][grid_f.order];
+      grid_c.opers[etype.first][grid_c.order].opp_prolong.timesMatrix(b_c.U_spts, b_f.U_spts);
+    }
+    return;
+  }
+
+#pragma omp parallel for
+  for (uint e = 0; e < grid_c.eles.size(); e++)
+  {
+    auto &e_c = *grid_c.eles[e];
+    auto &e_f = *grid_f.eles[e];
+    auto &opp_pro = grid_c.opers[e_c.eType][e_c.order].opp_prolong;
+    opp_pro.timesMatrix(e_c.U_spts, e_f.U_spts);
+  }
+}
+
 void multiGrid::compute_source_term(solver &grid)
 {
   /* Copy restricted fine grid residual to source term */
@@ -352,10 +539,41 @@ void multiGrid::compute_source_term(solver &grid)
   }
 }
 
+void multiGrid::store_solution(solver &grid)
+{
+#pragma omp parallel for
+  for (uint e = 0; e < grid.eles.size(); e++)
+  {
+    grid.eles[e]->sol_spts = grid.eles[e]->U_spts;
+  }
+}
+
+void multiGrid::compute_correction(solver &grid)
+{
+#pragma omp parallel for
+  for (uint e = 0; e < grid.eles.size(); e++)
+  {
+    grid.eles[e]->corr_spts  = grid.eles[e]->U_spts;
+    grid.eles[e]->corr_spts -= grid.eles[e]->sol_spts;
+  }
+}
+
+void multiGrid::add_source_term(solver &grid)
+{
+#pragma omp parallel for
+  for (uint e = 0; e < grid.eles.size(); e++)
+  {
+    grid.eles[e]->divF_spts[0] += grid.eles[e]->src_spts;
+  }
+}
+
 void multiGrid::restrict_hmg(solver &grid_f, solver &grid_c, uint H)
 {
-  int nSplit = 1 << params->nDims;
+  auto &kids = child_cells[H];
 
+  /* P = 0: the solution is averaged over the children [weighted by volume],
+   * while the residual [a reference-space divergence, i.e. scaled by |J|] is
+   * summed, so that each coarse cell sees the net flux out of its children */
 #pragma omp parallel for
   for (uint e = 0; e < grid_c.eles.size(); e++)
   {
@@ -363,30 +581,43 @@ void multiGrid::restrict_hmg(solver &grid_f, solver &grid_c, uint H)
     e_c.U_spts.initializeToZero();
     e_c.divF_spts[0].initializeToZero();
 
-    for (uint j = 0; j < nSplit; j++)
+    double vol = 0;
+    for (uint j = 0; j < kids.getDim1() && kids(e,j) >= 0; j++)
+    {
+      auto &e_f = *grid_f.eles[kids(e,j)];
+      double detJ = e_f.detJac_spts[0];
+      vol += detJ;
+      for (int spt = 0; spt < e_c.nSpts; spt++)
+      {
+        for (int k = 0; k < e_c.nFields; k++)
+        {
+          e_c.U_spts(spt,k) += detJ * e_f.U_spts(spt,k);
+          e_c.divF_spts[0](spt,k) += e_f.divF_spts[0](spt,k);
+        }
+      }
+    }
+
+    for (int spt = 0; spt < e_c.nSpts; spt++)
     {
-      // what to do...? Take avg (Josh's simple method), or do Galerkin projection?
-      // For the moment: take avg value [Only remotely reasonable for P = 0]
-      auto &e_f = *grid_f.eles[e*nSplit+j];
-      e_c.U_spts += e_f.U_spts;
-      e_c.divF_spts[0] += e_f.divF_spts[0];
+      for (int k = 0; k < e_c.nFields; k++)
+      {
+        e_c.U_spts(spt,k) /= vol;
+        e_c.divF_spts[0](spt,k) *= e_c.detJac_spts[spt] / vol;
+      }
     }
-    e_c.U_spts /= nSplit;
-    e_c.divF_spts[0] /= nSplit;
   }
 }
 
 void multiGrid::prolong_hmg(solver &grid_c, solver &grid_f, uint H)
 {
-  int nSplit = 1 << params->nDims;
+  auto &kids = child_cells[H];
 
+  /* P = 0: inject the coarse-cell correction into each of its children */
 #pragma omp parallel for
-  for (uint e = 0; e < grid_f.eles.size(); e++)
+  for (uint e = 0; e < grid_c.eles.size(); e++)
   {
-    auto &e_f = *grid_f.eles[e];
-    auto &e_c = *grid_c.eles[e/nSplit];
-    // what to do...? Copy value (Josh's simple method), or do Galerkin projection?
-    // For the moment: simple method [Only remotely reasonable for P = 0]
-    e_f.U_spts += e_c.corr_spts;
+    auto &e_c = *grid_c.eles[e];
+    for (uint j = 0; j < kids.getDim1() && kids(e,j) >= 0; j++)
+      grid_f.eles[kids(e,j)]->U_spts += e_c.corr_spts;
   }
 }
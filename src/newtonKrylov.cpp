@@ -0,0 +1,590 @@
+/*!
+ * \file newtonKrylov.cpp
+ * \brief newtonKrylov class definition
+ *
+ * Jacobian-free Newton-Krylov implicit time integration
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "newtonKrylov.hpp"
+
+#include <cfloat>
+#include <cmath>
+#include <iomanip>
+#include <set>
+
+#ifndef _NO_MPI
+#include "mpi.h"
+#endif
+
+#include "solver.hpp"
+
+void newtonKrylov::setup(input *inParams, solver *inSolver)
+{
+  params = inParams;
+  Solver = inSolver;
+
+  if (params->meshType == OVERSET_MESH)
+    FatalError("Implicit time stepping requires a fixed set of elements - not compatible with overset grids.");
+
+  auto &eles = Solver->eles;
+  nEles = eles.size();
+
+  offset.resize(nEles);
+  nDOF.resize(nEles);
+  N = 0;
+  for (int i=0; i<nEles; i++) {
+    offset[i] = N;
+    nDOF[i] = eles[i]->nSpts*eles[i]->nFields;
+    N += nDOF[i];
+  }
+
+  /* --- Time-integration scheme --- */
+  switch (params->timeType) {
+    case 11:
+      // Backward Euler
+      nStages = 1;
+      gamma = 1.;
+      c = {1.};
+      break;
+    case 12:
+      // BDF2 [first step taken with backward Euler]
+      nStages = 1;
+      gamma = 2./3.;
+      c = {1.};
+      break;
+    case 13: {
+      /* ESDIRK3(2)4L[2]SA [Kennedy & Carpenter, NASA TM-2001-211038]
+       * 3rd-order, L-stable, stiffly accurate; the first stage is explicit */
+      nStages = 4;
+      gamma = 1767732205903./4055673282236.;
+      A.assign(4,vector<double>(4,0.));
+      A[1][0] = gamma;
+      A[2][0] = 2746238789719./10658868560708.;
+      A[2][1] = -640167445237./6845629431997.;
+      A[3][0] = 1471266399579./7840856788654.;
+      A[3][1] = -4482444167858./7529755066697.;
+      A[3][2] = 11266239266428./11593286722821.;
+      for (int i=1; i<4; i++) A[i][i] = gamma;
+      c = {0., 2.*gamma, 3./5., 1.};
+      Rstage.assign(nStages,vector<double>(N));
+      break;
+    }
+    default:
+      FatalError("Implicit time-stepping type not recognized.");
+  }
+
+  for (auto *vec : {&U, &Un, &Unm1, &Ustar, &G, &R, &dU, &Up, &Rp, &z})
+    vec->assign(N,0.);
+
+  int m = params->gmresKrylov;
+  V.assign(m+1,vector<double>(N));
+  H.setup(m+1,m);
+  cs.resize(m);
+  sn.resize(m);
+  s.resize(m+1);
+
+  /* --- Block-Jacobi preconditioner --- */
+  if (params->precondType > 0) {
+    if (params->precondType == 1)
+      setupColoring();
+    else
+      Jac.setup(params,Solver);
+
+    dRdU.resize(nEles);
+    LU.resize(nEles);
+    piv.resize(nEles);
+    for (int i=0; i<nEles; i++) {
+      dRdU[i].assign(nDOF[i]*nDOF[i],0.);
+      LU[i].assign(nDOF[i]*nDOF[i],0.);
+      piv[i].resize(nDOF[i]);
+    }
+  }
+
+  nSteps = 0;
+  stepsSinceJac = -1;
+}
+
+void newtonKrylov::timeStep(void)
+{
+  PROFILE("newtonKrylov");
+
+  double dt = params->dt;
+  double t0 = params->time;
+
+  getState(Un);
+
+  if (params->precondType > 0) {
+    if (stepsSinceJac < 0 || stepsSinceJac >= params->jacobianFreq) {
+      calcBlockJacobian();
+      stepsSinceJac = 0;
+      factorGDt = 0;
+    }
+    stepsSinceJac++;
+  }
+
+  U = Un;
+
+  if (params->timeType == 11 || (params->timeType == 12 && nSteps == 0)) {
+    /* --- Backward Euler: U* = U^n --- */
+    Ustar = Un;
+    solveStage(dt, t0+dt);
+  }
+  else if (params->timeType == 12) {
+    /* --- BDF2: (3U - 4U^n + U^n-1) / (2dt) + R(U) = 0 --- */
+#pragma omp parallel for
+    for (int i=0; i<N; i++) {
+      Ustar[i] = (4.*Un[i] - Unm1[i]) / 3.;
+      U[i] = 2.*Un[i] - Unm1[i];  // Extrapolated initial guess
+    }
+    solveStage(gamma*dt, t0+dt);
+  }
+  else {
+    /* --- ESDIRK: explicit first stage, then one implicit solve per stage --- */
+    params->rkTime = t0;
+    calcR(Un, Rstage[0]);
+
+    for (int stage=1; stage<nStages; stage++) {
+#pragma omp parallel for
+      for (int i=0; i<N; i++) {
+        double sum = 0;
+        for (int j=0; j<stage; j++)
+          sum += A[stage][j]*Rstage[j][i];
+        Ustar[i] = Un[i] - dt*sum;
+      }
+
+      solveStage(gamma*dt, t0+c[stage]*dt);
+
+      // From the stage equation, R(U_i) = -(U_i - U*) / (gamma*dt)
+#pragma omp parallel for
+      for (int i=0; i<N; i++)
+        Rstage[stage][i] = (Ustar[i] - U[i]) / (gamma*dt);
+    }
+    // Stiffly accurate: U^n+1 is the final stage solution
+  }
+
+  Unm1 = Un;
+  setState(U);
+  nSteps++;
+}
+
+double newtonKrylov::solveStage(double gdt, double tStage)
+{
+  params->rkTime = tStage;
+
+  if (params->precondType > 0 && gdt != factorGDt)
+    factorBlocks(gdt);
+
+  double gNorm0 = 0, gNorm = 0;
+  int totalKrylov = 0;
+  int iter;
+  for (iter=0; iter<=params->newtonMaxIter; iter++) {
+    calcR(U,R);
+
+#pragma omp parallel for
+    for (int i=0; i<N; i++)
+      G[i] = (U[i] - Ustar[i]) / gdt + R[i];
+
+    gNorm = norm(G);
+    if (iter == 0) gNorm0 = gNorm;
+
+    if (gNorm <= params->newtonTol*gNorm0 || gNorm < DBL_MIN || iter == params->newtonMaxIter)
+      break;
+
+#pragma omp parallel for
+    for (int i=0; i<N; i++)
+      G[i] = -G[i];
+
+    totalKrylov += gmres(G,dU,gdt);
+
+#pragma omp parallel for
+    for (int i=0; i<N; i++)
+      U[i] += dU[i];
+  }
+
+  if (params->rank == 0 && (params->iter%params->monitorResFreq == 0 || params->iter == params->initIter+1)) {
+    cout.precision(3);
+    cout << "  Newton: " << iter << " iterations, " << totalKrylov << " GMRES iterations, ";
+    cout << "|G|/|G0| = " << std::scientific << ((gNorm0 > 0) ? gNorm/gNorm0 : 0.) << endl;
+  }
+
+  return gNorm;
+}
+
+void newtonKrylov::applyJ(const vector<double> &v, vector<double> &Jv, double gdt)
+{
+  double vNorm = norm(v);
+  if (vNorm == 0) {
+    std::fill(Jv.begin(),Jv.end(),0.);
+    return;
+  }
+
+  double eps = sqrt(DBL_EPSILON*(1.+norm(U))) / vNorm;
+
+#pragma omp parallel for
+  for (int i=0; i<N; i++)
+    Up[i] = U[i] + eps*v[i];
+
+  calcR(Up,Rp);
+
+#pragma omp parallel for
+  for (int i=0; i<N; i++)
+    Jv[i] = v[i] / gdt + (Rp[i] - R[i]) / eps;
+}
+
+int newtonKrylov::gmres(const vector<double> &b, vector<double> &x, double gdt)
+{
+  int m = params->gmresKrylov;
+  double tol = params->gmresTol * norm(b);
+
+  std::fill(x.begin(),x.end(),0.);
+
+  int total = 0;
+  for (int restart=0; restart<=params->gmresRestarts; restart++) {
+    auto &r = V[0];
+    if (restart == 0) {
+      r = b;
+    } else {
+      applyJ(x,r,gdt);
+#pragma omp parallel for
+      for (int i=0; i<N; i++)
+        r[i] = b[i] - r[i];
+    }
+
+    double beta = norm(r);
+    if (beta <= tol) break;
+
+#pragma omp parallel for
+    for (int i=0; i<N; i++)
+      r[i] /= beta;
+
+    std::fill(s.begin(),s.end(),0.);
+    s[0] = beta;
+
+    int k = 0;
+    double resid = beta;
+    for (int j=0; j<m; j++) {
+      applyPrecond(V[j],z);
+      applyJ(z,V[j+1],gdt);
+
+      // Modified Gram-Schmidt
+      auto &w = V[j+1];
+      for (int i=0; i<=j; i++) {
+        H(i,j) = dot(w,V[i]);
+        double h = H(i,j);
+#pragma omp parallel for
+        for (int n=0; n<N; n++)
+          w[n] -= h*V[i][n];
+      }
+      H(j+1,j) = norm(w);
+      if (H(j+1,j) > 0) {
+        double h = H(j+1,j);
+#pragma omp parallel for
+        for (int n=0; n<N; n++)
+          w[n] /= h;
+      }
+
+      // Apply previous Givens rotations, then compute the new one
+      for (int i=0; i<j; i++) {
+        double tmp = cs[i]*H(i,j) + sn[i]*H(i+1,j);
+        H(i+1,j) = -sn[i]*H(i,j) + cs[i]*H(i+1,j);
+        H(i,j) = tmp;
+      }
+      double den = sqrt(H(j,j)*H(j,j) + H(j+1,j)*H(j+1,j));
+      cs[j] = (den > 0) ? H(j,j)/den : 1.;
+      sn[j] = (den > 0) ? H(j+1,j)/den : 0.;
+      H(j,j) = den;
+      H(j+1,j) = 0.;
+      s[j+1] = -sn[j]*s[j];
+      s[j] = cs[j]*s[j];
+
+      k = j+1;
+      total++;
+      resid = std::abs(s[j+1]);
+      if (resid <= tol) break;
+    }
+
+    // Solve the upper-triangular system H y = s, and update x += M^-1 V y
+    vector<double> y(k);
+    for (int i=k-1; i>=0; i--) {
+      y[i] = s[i];
+      for (int l=i+1; l<k; l++)
+        y[i] -= H(i,l)*y[l];
+      y[i] /= H(i,i);
+    }
+
+#pragma omp parallel for
+    for (int n=0; n<N; n++) {
+      double sum = 0;
+      for (int i=0; i<k; i++)
+        sum += y[i]*V[i][n];
+      Up[n] = sum;
+    }
+    applyPrecond(Up,z);
+#pragma omp parallel for
+    for (int n=0; n<N; n++)
+      x[n] += z[n];
+
+    if (resid <= tol) break;
+  }
+
+  return total;
+}
+
+void newtonKrylov::applyPrecond(const vector<double> &in, vector<double> &out)
+{
+  if (params->precondType == 0) {
+    out = in;
+    return;
+  }
+
+#pragma omp parallel for
+  for (int e=0; e<nEles; e++) {
+    int n = nDOF[e];
+    const double *b = &in[offset[e]];
+    double *x = &out[offset[e]];
+    const double *lu = LU[e].data();
+    const int *p = piv[e].data();
+
+    // Forward substitution [unit lower-triangular L, with row pivoting]
+    for (int i=0; i<n; i++) {
+      double sum = b[p[i]];
+      for (int j=0; j<i; j++)
+        sum -= lu[i*n+j]*x[j];
+      x[i] = sum;
+    }
+
+    // Back substitution
+    for (int i=n-1; i>=0; i--) {
+      double sum = x[i];
+      for (int j=i+1; j<n; j++)
+        sum -= lu[i*n+j]*x[j];
+      x[i] = sum / lu[i*n+i];
+    }
+  }
+}
+
+void newtonKrylov::setupColoring(void)
+{
+  Solver->setupEleNbrs();
+  auto &nbrs = Solver->eleNbrs;
+
+  /* The viscous residual of an element depends upon the neighbors of its
+   * neighbors [through the corrected gradient], so use a distance-2 coloring */
+  vector<set<int>> stencil(nEles);
+  for (int e=0; e<nEles; e++) {
+    for (int n1:nbrs[e]) {
+      stencil[e].insert(n1);
+      if (params->viscous)
+        for (int n2:nbrs[n1])
+          if (n2 != e) stencil[e].insert(n2);
+    }
+  }
+
+  color.assign(nEles,-1);
+  nColors = 0;
+  for (int e=0; e<nEles; e++) {
+    set<int> used;
+    for (int n:stencil[e])
+      if (color[n] >= 0) used.insert(color[n]);
+
+    int col = 0;
+    while (used.count(col)) col++;
+    color[e] = col;
+    nColors = max(nColors,col+1);
+  }
+
+#ifndef _NO_MPI
+  // All ranks must perform the same number of residual evaluations
+  MPI_Allreduce(MPI_IN_PLACE, &nColors, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+#endif
+
+  if (params->rank == 0)
+    cout << "Newton-Krylov: " << nColors << " colors for block-Jacobian evaluation" << endl;
+}
+
+void newtonKrylov::calcBlockJacobian(void)
+{
+  int maxDOF = 0;
+  for (int e=0; e<nEles; e++)
+    maxDOF = max(maxDOF,nDOF[e]);
+
+#ifndef _NO_MPI
+  MPI_Allreduce(MPI_IN_PLACE, &maxDOF, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+#endif
+
+  calcR(Un,R);
+
+  if (params->precondType == 2) {
+    Jac.assemble();
+
+#pragma omp parallel for
+    for (int e=0; e<nEles; e++) {
+      const double *B = Jac.getDiagBlock(e);
+      for (int i=0; i<nDOF[e]*nDOF[e]; i++)
+        dRdU[e][i] = B[i];
+    }
+
+    setState(Un);
+    return;
+  }
+
+  Up = Un;
+
+  vector<double> h(nEles);
+  for (int col=0; col<nColors; col++) {
+    for (int j=0; j<maxDOF; j++) {
+      for (int e=0; e<nEles; e++) {
+        if (color[e] != col || j >= nDOF[e]) continue;
+        int ind = offset[e]+j;
+        h[e] = sqrt(DBL_EPSILON) * max(1.,std::abs(Un[ind]));
+        Up[ind] += h[e];
+      }
+
+      calcR(Up,Rp);
+
+#pragma omp parallel for
+      for (int e=0; e<nEles; e++) {
+        if (color[e] != col || j >= nDOF[e]) continue;
+        int n = nDOF[e];
+        for (int i=0; i<n; i++)
+          dRdU[e][i*n+j] = (Rp[offset[e]+i] - R[offset[e]+i]) / h[e];
+        Up[offset[e]+j] = Un[offset[e]+j];
+      }
+    }
+  }
+
+  setState(Un);
+}
+
+void newtonKrylov::factorBlocks(double gdt)
+{
+#pragma omp parallel for
+  for (int e=0; e<nEles; e++) {
+    int n = nDOF[e];
+    auto &lu = LU[e];
+    auto &p = piv[e];
+
+    lu = dRdU[e];
+    for (int i=0; i<n; i++) {
+      lu[i*n+i] += 1./gdt;
+      p[i] = i;
+    }
+
+    // In-place LU with partial (row) pivoting
+    for (int k=0; k<n; k++) {
+      int imax = k;
+      for (int i=k+1; i<n; i++)
+        if (std::abs(lu[i*n+k]) > std::abs(lu[imax*n+k])) imax = i;
+
+      if (imax != k) {
+        for (int j=0; j<n; j++)
+          std::swap(lu[k*n+j],lu[imax*n+j]);
+        std::swap(p[k],p[imax]);
+      }
+
+      double diag = lu[k*n+k];
+      for (int i=k+1; i<n; i++) {
+        double f = lu[i*n+k] / diag;
+        lu[i*n+k] = f;
+        for (int j=k+1; j<n; j++)
+          lu[i*n+j] -= f*lu[k*n+j];
+      }
+    }
+  }
+
+  factorGDt = gdt;
+}
+
+void newtonKrylov::getState(vector<double> &vec)
+{
+  auto &eles = Solver->eles;
+#pragma omp parallel for
+  for (int e=0; e<nEles; e++) {
+    auto &ele = eles[e];
+    double *u = &vec[offset[e]];
+    for (int spt=0; spt<ele->nSpts; spt++)
+      for (int k=0; k<ele->nFields; k++)
+        u[spt*ele->nFields+k] = ele->U_spts(spt,k);
+  }
+}
+
+void newtonKrylov::setState(const vector<double> &vec)
+{
+  auto &eles = Solver->eles;
+#pragma omp parallel for
+  for (int e=0; e<nEles; e++) {
+    auto &ele = eles[e];
+    const double *u = &vec[offset[e]];
+    for (int spt=0; spt<ele->nSpts; spt++)
+      for (int k=0; k<ele->nFields; k++)
+        ele->U_spts(spt,k) = u[spt*ele->nFields+k];
+  }
+}
+
+void newtonKrylov::calcR(const vector<double> &u, vector<double> &res)
+{
+  setState(u);
+
+  Solver->calcResidual(0);
+
+  auto &eles = Solver->eles;
+#pragma omp parallel for
+  for (int e=0; e<nEles; e++) {
+    auto &ele = eles[e];
+    double *r = &res[offset[e]];
+    for (int spt=0; spt<ele->nSpts; spt++)
+      for (int k=0; k<ele->nFields; k++)
+        r[spt*ele->nFields+k] = ele->divF_spts[0](spt,k) / ele->detJac_spts[spt];
+  }
+}
+
+double newtonKrylov::dot(const vector<double> &a, const vector<double> &b)
+{
+  double sum = 0;
+#pragma omp parallel for reduction(+:sum)
+  for (int i=0; i<N; i++)
+    sum += a[i]*b[i];
+
+#ifndef _NO_MPI
+  MPI_Allreduce(MPI_IN_PLACE, &sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+#endif
+
+  return sum;
+}
+
+double newtonKrylov::norm(const vector<double> &a)
+{
+  return sqrt(dot(a,a));
+}
+
+void newtonKrylov::addMemUsage(memTally &mem)
+{
+  mem.add("newtonKrylov", memBytes(offset, nDOF, A, c, U, Un, Unm1, Ustar, G, R, dU, Up, Rp)
+          + memBytes(Rstage, V, z, H, cs, sn, s));
+
+  mem.add("newtonKrylov: preconditioner", memBytes(color, dRdU, LU, piv));
+  Jac.addMemUsage(mem);
+}
@@ -28,6 +28,10 @@
 #include "../include/operators.hpp"
 
 #include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
 
 #include "../include/polynomials.hpp"
 
@@ -37,7 +41,7 @@ static bool abs_compare(int a, int b)
   return (std::abs(a) < std::abs(b));
 }
 
-void oper::setupOperators(uint eType, uint order, geo *inGeo, input *inParams)
+void oper::setupOperators(uint eType, uint order, geo *inGeo, input *inParams, const char *packed)
 {
   // Get access to basic data
   Geo = inGeo;
@@ -60,33 +64,178 @@ void oper::setupOperators(uint eType, uint order, geo *inGeo, input *inParams)
   nSpts = loc_spts.size();
   nFpts = loc_fpts.size();
 
-  tempFn.setup(nFpts,nDims);
+  tempFn.resize(getMaxThreads());
+  for (auto &tmp:tempFn)
+    tmp.setup(nFpts,nFields);
 
-  // Set up each operator
-  setupExtrapolateSptsFpts(loc_fpts);
+  wts_spts = getQptWeights(order,nDims);
 
-  setupExtrapolateSptsMpts(loc_spts);
+  basis1D.setup(getPts1D(sptsType,order));
 
-  setupGradSpts(loc_spts);
+  if (packed) {
+    // Copy the dense operators out of the cache / broadcast buffer
+    for (auto op:denseOperators()) {
+      uint dims[2];
+      memcpy(dims, packed, sizeof(dims));
+      packed += sizeof(dims);
+      op->setup(dims[0],dims[1]);
+      if (dims[0]*dims[1] > 0)
+        memcpy(op->getData(), packed, dims[0]*dims[1]*sizeof(double));
+      packed += dims[0]*dims[1]*sizeof(double);
+    }
+  }
+  else {
+    // Set up each operator
+    setupExtrapolateSptsFpts(loc_fpts);
+
+    setupExtrapolateSptsMpts(loc_spts);
+
+    setupGradSpts(loc_spts);
+
+    setupCorrection(loc_spts,loc_fpts);
+
+    if (params->viscous) {
+      setupCorrectGradU();
+    }
 
-  setupCorrection(loc_spts,loc_fpts);
+    // Operators needed for Shock capturing
+    if (params->scFlag) {
+      setupVandermonde(loc_spts);
 
-  if (params->viscous) {
-    setupCorrectGradU();
+      setupSensingMatrix();
+
+      setupFilterMatrix();
+    }
+
+    if (params->PMG) {
+      setupPMG(order);
+    }
   }
 
-  // Operators needed for Shock capturing
-  if (params->scFlag) {
-    setupVandermonde(loc_spts);
+  if (params->viscous && params->viscScheme == 1)
+    setupLifting();
 
-    setupSensingMatrix();
+  setupSumFactorization();
+}
 
-    setupFilterMatrix();
+vector<matrix<double>*> oper::denseOperators(void)
+{
+  opp_grad_spts.resize(nDims);
+  opp_correctU.resize(nDims);
+
+  vector<matrix<double>*> ops = {&opp_spts_to_fpts, &opp_spts_to_mpts, &opp_correction};
+  for (auto &op:opp_grad_spts) ops.push_back(&op);
+  for (auto &op:opp_correctU) ops.push_back(&op);
+
+  for (auto op:{&vandermonde1D, &inv_vandermonde1D, &vandermonde2D, &inv_vandermonde2D,
+                &sensingMatrix, &filterMatrix, &opp_prolong, &opp_restrict})
+    ops.push_back(op);
+
+  return ops;
+}
+
+void oper::packOperators(vector<char> &buf)
+{
+  for (auto op:denseOperators()) {
+    uint dims[2] = {op->getDim0(), op->getDim1()};
+    size_t nBytes = dims[0]*dims[1]*sizeof(double);
+    size_t pos = buf.size();
+    buf.resize(pos + sizeof(dims) + nBytes);
+    memcpy(&buf[pos], dims, sizeof(dims));
+    if (nBytes > 0)
+      memcpy(&buf[pos+sizeof(dims)], op->getData(), nBytes);
   }
+}
 
-  if (params->PMG) {
-    setupPMG(order);
+void oper::addMemUsage(memTally &mem)
+{
+  const char* typeNames[] = {"Tri", "Quad", "Tet", "Prism", "Hex", "Pyramid"};
+  string category = string("oper: ") + typeNames[eType] + " P" + to_string(order);
+
+  size_t bytes = memBytes(opp_div_spts, opp_correctF, lift_fpts, tempFn, wts_spts);
+  for (auto op:denseOperators())
+    bytes += memBytes(*op);
+
+  bytes += sf_spts_to_fpts.getMemUsage() + sf_correction.getMemUsage();
+  for (auto &sf:sf_grad_spts) bytes += sf.getMemUsage();
+  for (auto &sf:sf_correctU) bytes += sf.getMemUsage();
+
+  mem.add(category, bytes);
+}
+
+string oper::cacheKey(uint eType, uint order, input *params)
+{
+  /* The solution points & correction functions of quads & hexes are set by
+   * the 'Quad' parameters; the flags select which operators are set up */
+  stringstream key;
+  key << "eType " << eType << " nDims " << params->nDims << " order " << order
+      << " spts " << params->sptsTypeQuad << " vcjh " << params->vcjhSchemeQuad
+      << " viscous " << params->viscous << " shockCapture " << params->scFlag
+      << " PMG " << params->PMG;
+  return key.str();
+}
+
+static const char operCacheMagic[8] = {'F','L','U','R','R','Y','O','P'};
+static const int operCacheVersion = 1;
+
+bool readOperCache(const string &fileName, operCacheMap &cache)
+{
+  ifstream file(fileName, ios::binary);
+  if (!file.is_open()) return false;
+
+  char magic[8];
+  int version;
+  uint64_t nRecs;
+  file.read(magic, sizeof(magic));
+  file.read((char*)&version, sizeof(version));
+  file.read((char*)&nRecs, sizeof(nRecs));
+  if (!file || memcmp(magic, operCacheMagic, sizeof(magic)) || version != operCacheVersion)
+    return false;
+
+  for (uint64_t i=0; i<nRecs; i++) {
+    uint64_t keyLen, nBytes;
+    file.read((char*)&keyLen, sizeof(keyLen));
+    string key(keyLen,' ');
+    file.read(&key[0], keyLen);
+    file.read((char*)&nBytes, sizeof(nBytes));
+    auto &buf = cache[key];
+    buf.resize(nBytes);
+    file.read(buf.data(), nBytes);
+    if (!file) {
+      cache.clear();
+      return false;
+    }
   }
+
+  return true;
+}
+
+void writeOperCache(const string &fileName, const operCacheMap &cache)
+{
+  // Write to a temporary file, then move it into place, so that a run which
+  // is reading the cache never sees a partial file
+  string tmpName = fileName + ".tmp";
+  ofstream file(tmpName, ios::binary | ios::trunc);
+  if (!file.is_open()) {
+    cout << "WARNING: Unable to write the operator cache file " << fileName << endl;
+    return;
+  }
+
+  uint64_t nRecs = cache.size();
+  file.write(operCacheMagic, sizeof(operCacheMagic));
+  file.write((char*)&operCacheVersion, sizeof(operCacheVersion));
+  file.write((char*)&nRecs, sizeof(nRecs));
+
+  for (auto &rec:cache) {
+    uint64_t keyLen = rec.first.size(), nBytes = rec.second.size();
+    file.write((char*)&keyLen, sizeof(keyLen));
+    file.write(rec.first.data(), keyLen);
+    file.write((char*)&nBytes, sizeof(nBytes));
+    file.write(rec.second.data(), nBytes);
+  }
+  file.close();
+
+  rename(tmpName.c_str(), fileName.c_str());
 }
 
 void oper::setupExtrapolateSptsFpts(vector<point> &loc_fpts)
@@ -226,35 +375,11 @@ matrix<double> oper::setupInterpolateSptsIpts(matrix<double> &loc_ipts)
       }
       break;
     }
-    case QUAD: {
-      vector<double> locSpts1D = getPts1D(params->sptsTypeQuad,order);
-      for (uint ipt=0; ipt<nIpts; ipt++) {
-        // Location of the current interpolation point
-        point pt = point(loc_ipts[ipt]);
-        for (uint spt=0; spt<nSpts; spt++) {
-          // Structured I,J indices of current solution point
-          uint ispt = spt%(nSpts/(order+1));
-          uint jspt = floor(spt/(order+1));
-          // 3D Tensor-Product Lagrange Interpolation
-          opp_interp(ipt,spt) =  Lagrange(locSpts1D,pt.x,ispt) * Lagrange(locSpts1D,pt.y,jspt);
-        }
-      }
-      break;
-    }
+    case QUAD:
     case HEX: {
-      vector<double> locSpts1D = getPts1D(params->sptsTypeQuad,order);
-      for (uint ipt = 0; ipt < nIpts; ipt++) {
-        // Location of the current interpolation point
-        point pt = point(loc_ipts[ipt]);
-        for (uint spt=0; spt<nSpts; spt++) {
-          // Structured I,J,K indices of current solution point
-          uint kspt = spt/((order+1)*(order+1));
-          uint jspt = (spt-(order+1)*(order+1)*kspt)/(order+1);
-          uint ispt = spt - (order+1)*jspt - (order+1)*(order+1)*kspt;
-          // 3D Tensor-Product Lagrange Interpolation
-          opp_interp(ipt,spt) =  Lagrange(locSpts1D,pt.x,ispt) * Lagrange(locSpts1D,pt.y,jspt) * Lagrange(locSpts1D,pt.z,kspt);
-        }
-      }
+      // Tensor-Product Lagrange Interpolation
+      for (uint ipt=0; ipt<nIpts; ipt++)
+        evalTensorBasis(loc_ipts[ipt],&opp_interp(ipt,0));
       break;
     }
     default:
@@ -264,6 +389,30 @@ matrix<double> oper::setupInterpolateSptsIpts(matrix<double> &loc_ipts)
   return opp_interp;
 }
 
+void oper::evalTensorBasis(const double* loc, double* basis)
+{
+  uint nSpts1D = order+1;
+  static thread_local vector<double> l1D;
+  l1D.resize(3*nSpts1D);
+  double *lx = &l1D[0], *ly = &l1D[nSpts1D], *lz = &l1D[2*nSpts1D];
+
+  basis1D.eval(loc[0],lx);
+  basis1D.eval(loc[1],ly);
+
+  if (nDims == 2) {
+    for (uint j=0; j<nSpts1D; j++)
+      for (uint i=0; i<nSpts1D; i++)
+        basis[i+nSpts1D*j] = lx[i]*ly[j];
+  }
+  else {
+    basis1D.eval(loc[2],lz);
+    for (uint k=0; k<nSpts1D; k++)
+      for (uint j=0; j<nSpts1D; j++)
+        for (uint i=0; i<nSpts1D; i++)
+          basis[i+nSpts1D*(j+nSpts1D*k)] = lx[i]*ly[j]*lz[k];
+  }
+}
+
 void oper::getBasisValues(point &ipt, vector<double> &weights)
 {
   double loc_ipt[] = {ipt.x, ipt.y, ipt.z};
@@ -284,29 +433,11 @@ void oper::getBasisValues(double* loc_ipt, double* weights)
         weights[spt] = eval_dubiner_basis_2d(pt,spt,order);
       break;
     }
-    case QUAD: {
-      vector<double> locSpts1D = getPts1D(params->sptsTypeQuad,order);
-      for (uint spt=0; spt<nSpts; spt++) {
-        // Structured I,J indices of current solution point
-        uint ispt = spt%(nSpts/(order+1));
-        uint jspt = floor(spt/(order+1));
-        // 3D Tensor-Product Lagrange Interpolation
-        weights[spt] =  Lagrange(locSpts1D,loc_ipt[0],ispt) * Lagrange(locSpts1D,loc_ipt[1],jspt);
-      }
-      break;
-    }
-    case HEX: {
-      vector<double> locSpts1D = getPts1D(params->sptsTypeQuad,order);
-      for (uint spt=0; spt<nSpts; spt++) {
-        // Structured I,J,K indices of current solution point
-        uint kspt = spt/((order+1)*(order+1));
-        uint jspt = (spt-(order+1)*(order+1)*kspt)/(order+1);
-        uint ispt = spt - (order+1)*jspt - (order+1)*(order+1)*kspt;
-        // 3D Tensor-Product Lagrange Interpolation
-        weights[spt] =  Lagrange(locSpts1D,loc_ipt[0],ispt) * Lagrange(locSpts1D,loc_ipt[1],jspt) * Lagrange(locSpts1D,loc_ipt[2],kspt);
-      }
+    case QUAD:
+    case HEX:
+      // Tensor-Product Lagrange Interpolation
+      evalTensorBasis(loc_ipt,weights);
       break;
-    }
     default:
       FatalError("Element type not yet supported.");
   }
@@ -317,33 +448,13 @@ void oper::interpolateSptsToPoints(vector<double> &Q_spts, vector<double> &Q_ipt
   uint nIpts = loc_ipts.getDim0();
   Q_ipts.assign(nIpts,0);
 
-  if (eType == QUAD) {
-    vector<double> locSpts1D = getPts1D(params->sptsTypeQuad,order);
+  if (eType == QUAD || eType == HEX) {
+    static thread_local vector<double> basis;
+    basis.resize(nSpts);
     for (uint ipt=0; ipt<nIpts; ipt++) {
-      // Location of the current interpolation point
-      point pt = point(loc_ipts[ipt],2);
-      for (uint spt=0; spt<nSpts; spt++) {
-        // Structured I,J indices of current solution point
-        uint ispt = spt%(nSpts/(order+1));
-        uint jspt = floor(spt/(order+1));
-
-        Q_ipts[ipt] += Q_spts[spt] * Lagrange(locSpts1D,pt.x,ispt) * Lagrange(locSpts1D,pt.y,jspt);
-      }
-    }
-  }
-  else if (eType == HEX) {
-    vector<double> locSpts1D = getPts1D(params->sptsTypeQuad,order);
-    for (uint ipt = 0; ipt < nIpts; ipt++) {
-      // Location of the current interpolation point
-      point pt = point(loc_ipts[ipt]);
-      for (uint spt=0; spt<nSpts; spt++) {
-        // Structured I,J,K indices of current solution point
-        uint kspt = spt/((order+1)*(order+1));
-        uint jspt = (spt-(order+1)*(order+1)*kspt)/(order+1);
-        uint ispt = spt - (order+1)*jspt - (order+1)*(order+1)*kspt;
-
-        Q_ipts[ipt] += Q_spts[spt] * Lagrange(locSpts1D,pt.x,ispt) * Lagrange(locSpts1D,pt.y,jspt) * Lagrange(locSpts1D,pt.z,kspt);
-      }
+      evalTensorBasis(loc_ipts[ipt],basis.data());
+      for (uint spt=0; spt<nSpts; spt++)
+        Q_ipts[ipt] += Q_spts[spt] * basis[spt];
     }
   }
 }
@@ -369,39 +480,16 @@ void oper::interpolateSptsToPoints(matrix<double> &Q_spts,matrix<double> &Q_ipts
       }
       break;
     }
-    case QUAD: {
-      vector<double> locSpts1D = getPts1D(params->sptsTypeQuad,order);
-      for (uint ipt=0; ipt<nIpts; ipt++) {
-        // Location of the current interpolation point
-        point pt = point(loc_ipts[ipt],2);
-        for (uint spt=0; spt<nSpts; spt++) {
-          // Structured I,J indices of current solution point
-          uint ispt = spt%(nSpts/(order+1));
-          uint jspt = floor(spt/(order+1));
-
-          // 3D Tensor-Product Lagrange Interpolation
-          for (uint field=0; field<nFields; field++)
-            Q_ipts(ipt,field) += Q_spts(spt,field) * Lagrange(locSpts1D,pt.x,ispt) * Lagrange(locSpts1D,pt.y,jspt);
-        }
-      }
-      break;
-    }
-
+    case QUAD:
     case HEX: {
-      vector<double> locSpts1D = getPts1D(params->sptsTypeQuad,order);
-      for (uint ipt = 0; ipt < nIpts; ipt++) {
-        // Location of the current interpolation point
-        point pt = point(loc_ipts[ipt]);
-        for (uint spt=0; spt<nSpts; spt++) {
-          // Structured I,J,K indices of current solution point
-          uint kspt = spt/((order+1)*(order+1));
-          uint jspt = (spt-(order+1)*(order+1)*kspt)/(order+1);
-          uint ispt = spt - (order+1)*jspt - (order+1)*(order+1)*kspt;
-
-          // 3D Tensor-Product Lagrange Interpolation
+      // Tensor-Product Lagrange Interpolation
+      static thread_local vector<double> basis;
+      basis.resize(nSpts);
+      for (uint ipt=0; ipt<nIpts; ipt++) {
+        evalTensorBasis(loc_ipts[ipt],basis.data());
+        for (uint spt=0; spt<nSpts; spt++)
           for (uint field=0; field<nFields; field++)
-            Q_ipts(ipt,field) += Q_spts(spt,field) * Lagrange(locSpts1D,pt.x,ispt) * Lagrange(locSpts1D,pt.y,jspt) * Lagrange(locSpts1D,pt.z,kspt);
-        }
+            Q_ipts(ipt,field) += Q_spts(spt,field) * basis[spt];
       }
       break;
     }
@@ -425,32 +513,16 @@ void oper::interpolateToPoint(matrix<double> &Q_spts, double* Q_ipts, point &loc
           Q_ipts[field] += Q_spts(spt,field) * eval_dubiner_basis_2d(loc_ipt,spt,order);
       break;
     }
-    case QUAD: {
-      vector<double> locSpts1D = getPts1D(params->sptsTypeQuad,order);
-      for (uint spt=0; spt<nSpts; spt++) {
-        // Structured I,J indices of current solution point
-        uint ispt = spt%(nSpts/(order+1));
-        uint jspt = floor(spt/(order+1));
-
-        // 3D Tensor-Product Lagrange Interpolation
-        for (uint field=0; field<nFields; field++)
-          Q_ipts[field] += Q_spts(spt,field) * Lagrange(locSpts1D,loc_ipt.x,ispt) * Lagrange(locSpts1D,loc_ipt.y,jspt);
-      }
-      break;
-    }
-
+    case QUAD:
     case HEX: {
-      vector<double> locSpts1D = getPts1D(params->sptsTypeQuad,order);
-      for (uint spt=0; spt<nSpts; spt++) {
-        // Structured I,J,K indices of current solution point
-        uint kspt = spt/((order+1)*(order+1));
-        uint jspt = (spt-(order+1)*(order+1)*kspt)/(order+1);
-        uint ispt = spt - (order+1)*jspt - (order+1)*(order+1)*kspt;
-
-        // 3D Tensor-Product Lagrange Interpolation
+      // Tensor-Product Lagrange Interpolation
+      double loc[3] = {loc_ipt.x, loc_ipt.y, loc_ipt.z};
+      static thread_local vector<double> basis;
+      basis.resize(nSpts);
+      evalTensorBasis(loc,basis.data());
+      for (uint spt=0; spt<nSpts; spt++)
         for (uint field=0; field<nFields; field++)
-          Q_ipts[field] += Q_spts(spt,field) * Lagrange(locSpts1D,loc_ipt.x,ispt) * Lagrange(locSpts1D,loc_ipt.y,jspt) * Lagrange(locSpts1D,loc_ipt.z,kspt);
-      }
+          Q_ipts[field] += Q_spts(spt,field) * basis[spt];
       break;
     }
     default:
@@ -475,34 +547,17 @@ void oper::interpolateFluxToPoint(vector<matrix<double>> &F_spts, matrix<double>
             F_ipt(dim,field) += F_spts[spt](dim,field) * eval_dubiner_basis_2d(loc_ipt,spt,order);
       break;
     }
-    case QUAD: {
-      vector<double> locSpts1D = getPts1D(params->sptsTypeQuad,order);
-      for (uint spt=0; spt<nSpts; spt++) {
-        // Structured I,J indices of current solution point
-        uint ispt = spt%(nSpts/(order+1));
-        uint jspt = floor(spt/(order+1));
-
-        // 3D Tensor-Product Lagrange Interpolation
-        for (uint dim=0; dim<nDims; dim++)
-          for (uint field=0; field<nFields; field++)
-            F_ipt(dim,field) += F_spts[spt](dim,field) * Lagrange(locSpts1D,loc_ipt.x,ispt) * Lagrange(locSpts1D,loc_ipt.y,jspt);
-      }
-      break;
-    }
-
+    case QUAD:
     case HEX: {
-      vector<double> locSpts1D = getPts1D(params->sptsTypeQuad,order);
-      for (uint spt=0; spt<nSpts; spt++) {
-        // Structured I,J,K indices of current solution point
-        uint kspt = spt/((order+1)*(order+1));
-        uint jspt = (spt-(order+1)*(order+1)*kspt)/(order+1);
-        uint ispt = spt - (order+1)*jspt - (order+1)*(order+1)*kspt;
-
-        // 3D Tensor-Product Lagrange Interpolation
+      // Tensor-Product Lagrange Interpolation
+      double loc[3] = {loc_ipt.x, loc_ipt.y, loc_ipt.z};
+      static thread_local vector<double> basis;
+      basis.resize(nSpts);
+      evalTensorBasis(loc,basis.data());
+      for (uint spt=0; spt<nSpts; spt++)
         for (uint dim=0; dim<nDims; dim++)
           for (uint field=0; field<nFields; field++)
-            F_ipt(dim,field) += F_spts[spt](dim,field) * Lagrange(locSpts1D,loc_ipt.x,ispt) * Lagrange(locSpts1D,loc_ipt.y,jspt) * Lagrange(locSpts1D,loc_ipt.z,kspt);
-      }
+            F_ipt(dim,field) += F_spts[spt](dim,field) * basis[spt];
       break;
     }
     default:
@@ -787,6 +842,16 @@ void oper::setupCorrectGradU(void)
   }
 }
 
+void oper::setupLifting(void)
+{
+  // Diagonal of [extrapolation * correction]: the FR lifting of a unit jump at
+  // each flux point, evaluated at that same point [tensor-product elements]
+  lift_fpts.assign(nFpts,0.);
+  for (uint fpt=0; fpt<nFpts; fpt++)
+    for (uint spt=0; spt<nSpts; spt++)
+      lift_fpts[fpt] += opp_spts_to_fpts(fpt,spt)*opp_correction(spt,fpt);
+}
+
 // Setup Vandermonde Matrices
 void oper::setupVandermonde(vector<point> &loc_spts)
 {
@@ -889,32 +954,68 @@ void oper::setupFilterMatrix(void)
   }
 }
 
-void oper::applyGradSpts(matrix<double> &U_spts, vector<matrix<double> > &dU_spts)
+void oper::setupSumFactorization(void)
 {
+  sf_grad_spts.resize(nDims);
+  sf_correctU.resize(nDims);
+
+  if (!params->sumFactorization || (eType != QUAD && eType != HEX))
+    return;
+
+  sf_spts_to_fpts.setup(opp_spts_to_fpts);
+
   for (uint dim=0; dim<nDims; dim++)
-    opp_grad_spts[dim].timesMatrix(U_spts,dU_spts[dim]);
+    sf_grad_spts[dim].setup(opp_grad_spts[dim]);
+
+  sf_correction.setup(opp_correction);
+
+  if (params->viscous)
+    for (uint dim=0; dim<nDims; dim++)
+      sf_correctU[dim].setup(opp_correctU[dim]);
+}
+
+void oper::applyGradSpts(matrix<double> &U_spts, vector<matrix<double> > &dU_spts)
+{
+  for (uint dim=0; dim<nDims; dim++) {
+    if (sf_grad_spts[dim].isActive())
+      sf_grad_spts[dim].timesMatrix(U_spts,dU_spts[dim]);
+    else
+      opp_grad_spts[dim].timesMatrix(U_spts,dU_spts[dim]);
+  }
 }
 
 void oper::applyGradFSpts(vector<matrix<double>> &F_spts, Array<matrix<double>,2> &dF_spts)
 {
   // Note: dim1 is flux direction, dim2 is derivative direction
-  for (uint dim1=0; dim1<nDims; dim1++)
-    for (uint dim2=0; dim2<dF_spts.dims[0]; dim2++)
-      opp_grad_spts[dim2].timesMatrix(F_spts[dim1],dF_spts(dim2,dim1));
+  for (uint dim1=0; dim1<nDims; dim1++) {
+    for (uint dim2=0; dim2<dF_spts.dims[0]; dim2++) {
+      if (sf_grad_spts[dim2].isActive())
+        sf_grad_spts[dim2].timesMatrix(F_spts[dim1],dF_spts(dim2,dim1));
+      else
+        opp_grad_spts[dim2].timesMatrix(F_spts[dim1],dF_spts(dim2,dim1));
+    }
+  }
 }
 
 
 void oper::applyDivFSpts(vector<matrix<double>> &F_spts, matrix<double> &divF_spts)
 {
   divF_spts.initializeToZero();
-  for (uint dim=0; dim<nDims; dim++)
+  for (uint dim=0; dim<nDims; dim++) {
+    if (sf_grad_spts[dim].isActive())
+      sf_grad_spts[dim].timesMatrixPlus(F_spts[dim],divF_spts);
+    else
       opp_grad_spts[dim].timesMatrixPlus(F_spts[dim],divF_spts);
+  }
 }
 
 
 void oper::applySptsFpts(matrix<double> &U_spts, matrix<double> &U_fpts)
 {
-  opp_spts_to_fpts.timesMatrix(U_spts,U_fpts);
+  if (sf_spts_to_fpts.isActive())
+    sf_spts_to_fpts.timesMatrix(U_spts,U_fpts);
+  else
+    opp_spts_to_fpts.timesMatrix(U_spts,U_fpts);
 }
 
 void oper::applySptsMpts(matrix<double> &U_spts, matrix<double> &U_mpts)
@@ -924,13 +1025,15 @@ void oper::applySptsMpts(matrix<double> &U_spts, matrix<double> &U_mpts)
 
 void oper::applyExtrapolateFn(vector<matrix<double>> &F_spts, matrix<double> &tnorm_fpts, matrix<double> &Fn_fpts)
 {
-  opp_spts_to_fpts.timesMatrix(F_spts[0],tempFn);
+  matrix<double> &tempFn = this->tempFn[getThreadNum()];
+
+  applySptsFpts(F_spts[0],tempFn);
   for (uint fpt=0; fpt<nFpts; fpt++)
     for (uint i=0; i<nFields; i++)
       Fn_fpts(fpt,i) = tempFn(fpt,i)*tnorm_fpts(fpt,0);
   
   for (uint dim=1; dim<nDims; dim++) {
-    opp_spts_to_fpts.timesMatrix(F_spts[dim],tempFn);
+    applySptsFpts(F_spts[dim],tempFn);
     for (uint fpt=0; fpt<nFpts; fpt++)
       for (uint i=0; i<nFields; i++)
         Fn_fpts(fpt,i) += tempFn(fpt,i)*tnorm_fpts(fpt,dim);
@@ -939,35 +1042,35 @@ void oper::applyExtrapolateFn(vector<matrix<double>> &F_spts, matrix<double> &tn
 
 void oper::applyExtrapolateFn(vector<matrix<double>> &F_spts, matrix<double> &norm_fpts, matrix<double> &Fn_fpts, vector<double>& dA_fpts)
 {
-  uint nFpts = norm_fpts.getDim0();
-  matrix<double> tempFn(nFpts,nDims);
-  tempFn.initializeToZero();
+  matrix<double> &tempFn = this->tempFn[getThreadNum()];
   Fn_fpts.initializeToZero();
 
   for (uint dim=0; dim<nDims; dim++) {
-    opp_spts_to_fpts.timesMatrix(F_spts[dim],tempFn);
+    applySptsFpts(F_spts[dim],tempFn);
     for (uint fpt=0; fpt<nFpts; fpt++)
       for (uint i=0; i<nFields; i++)
         Fn_fpts(fpt,i) += tempFn(fpt,i)*norm_fpts(fpt,dim)*dA_fpts[fpt];
   }
 }
 
-matrix<double> oper::interpolateCorrectedFlux(vector<matrix<double>> &F_spts, matrix<double> &dFn_fpts, point refLoc)
+void oper::interpolateCorrectedFlux(vector<matrix<double>> &F_spts, matrix<double> &dFn_fpts, point refLoc, matrix<double> &Fi)
 {
   vector<double> locSpts1D = getPts1D(params->sptsTypeQuad,order);
 
-  matrix<double> Fi(nDims,nFields);
+  Fi.setup(nDims,nFields);
+  Fi.initializeToZero();
 
-  if (nDims == 2) {
-    // Contributions from solution points
-    for (uint spt=0; spt<nSpts; spt++) {
-      uint ispt = spt%(nSpts/(order+1));
-      uint jspt = floor(spt/(order+1));
+  // Contributions from solution points
+  double loc[3] = {refLoc.x, refLoc.y, refLoc.z};
+  static thread_local vector<double> basis;
+  basis.resize(nSpts);
+  evalTensorBasis(loc,basis.data());
+  for (uint spt=0; spt<nSpts; spt++)
+    for (uint dim=0; dim<nDims; dim++)
+      for (uint k=0; k<nFields; k++)
+        Fi(dim,k) += F_spts[dim](spt,k) * basis[spt];
 
-      for (uint dim=0; dim<nDims; dim++)
-        for (uint k=0; k<nFields; k++)
-          Fi(dim,k) += F_spts[dim](spt,k) * Lagrange(locSpts1D,refLoc.x,ispt) * Lagrange(locSpts1D,refLoc.y,jspt);
-    }
+  if (nDims == 2) {
 
     // Contribution from flux points [Correction function]
     for (uint fpt=0; fpt<nFpts; fpt++) {
@@ -998,17 +1101,6 @@ matrix<double> oper::interpolateCorrectedFlux(vector<matrix<double>> &F_spts, ma
     }
   }
   else {
-    // Contribution from solution points
-    for (uint spt=0; spt<nSpts; spt++) {
-      uint kspt = spt/((order+1)*(order+1));
-      uint jspt = (spt-(order+1)*(order+1)*kspt)/(order+1);
-      uint ispt = spt - (order+1)*jspt - (order+1)*(order+1)*kspt;
-
-      for (uint dim=0; dim<nDims; dim++)
-        for (uint k=0; k<nFields; k++)
-          Fi(dim,k) += F_spts[dim](spt,k) * Lagrange(locSpts1D,refLoc.x,ispt) * Lagrange(locSpts1D,refLoc.y,jspt) * Lagrange(locSpts1D,refLoc.z,kspt);
-    }
-
     // Contributions from flux points [Correction function]
     for (uint fpt=0; fpt<nFpts; fpt++) {
       uint iFace = floor(fpt / ((order+1)*(order+1)));
@@ -1052,22 +1144,51 @@ matrix<double> oper::interpolateCorrectedFlux(vector<matrix<double>> &F_spts, ma
           Fi(dim,k) += dFn_fpts(fpt,k) * VCJH_hex(fpt,refLoc,locSpts1D,params->vcjhSchemeQuad,order) * tNorm[dim];
     }
   }
-
-  return Fi;
 }
 
 void oper::applyCorrectDivF(matrix<double> &dFn_fpts, matrix<double> &divF_spts)
 {
-  opp_correction.timesMatrixPlus(dFn_fpts,divF_spts);
+  if (sf_correction.isActive())
+    sf_correction.timesMatrixPlus(dFn_fpts,divF_spts);
+  else
+    opp_correction.timesMatrixPlus(dFn_fpts,divF_spts);
 }
 
 void oper::applyCorrectGradU(matrix<double> &dUc_fpts, vector<matrix<double>> &dU_spts, vector<matrix<double>> &JGinv_spts, vector<double> &detJac_spts)
 {
   // Calculate the gradient in the parent domain
-  for (uint dim=0; dim<nDims; dim++)
-    opp_correctU[dim].timesMatrixPlus(dUc_fpts,dU_spts[dim]);
+  applyCorrectGradU(dUc_fpts,dU_spts);
 
   // Transform the gradient back to physical space
+  applyTransformGradU(dU_spts,JGinv_spts,detJac_spts);
+}
+
+void oper::applyCorrectGradU(matrix<double> &dUc_fpts, vector<matrix<double>> &dU_spts)
+{
+  for (uint dim=0; dim<nDims; dim++) {
+    if (sf_correctU[dim].isActive())
+      sf_correctU[dim].timesMatrixPlus(dUc_fpts,dU_spts[dim]);
+    else
+      opp_correctU[dim].timesMatrixPlus(dUc_fpts,dU_spts[dim]);
+  }
+}
+
+void oper::applyExtrapolateGradU(vector<matrix<double>> &dU_spts, vector<matrix<double>> &JGinv_spts, vector<double> &detJac_spts, vector<matrix<double>> &dU_fpts)
+{
+  static thread_local vector<matrix<double>> dU_phys;
+
+  dU_phys.resize(nDims);
+  for (uint dim=0; dim<nDims; dim++)
+    dU_phys[dim] = dU_spts[dim];
+
+  applyTransformGradU(dU_phys,JGinv_spts,detJac_spts);
+
+  for (uint dim=0; dim<nDims; dim++)
+    applySptsFpts(dU_phys[dim],dU_fpts[dim]);
+}
+
+void oper::applyTransformGradU(vector<matrix<double>> &dU_spts, vector<matrix<double>> &JGinv_spts, vector<double> &detJac_spts)
+{
   if (nDims == 2) {
     for (uint spt=0; spt<nSpts; spt++) {
       double invDet = 1./detJac_spts[spt];
@@ -1109,15 +1230,13 @@ void oper::applyCorrectGradU(matrix<double> &dUc_fpts, vector<matrix<double>> &d
 
 void oper::calcAvgU(matrix<double> &U_spts, vector<double> &detJ_spts, vector<double> &Uavg)
 {
-  auto weights = getQptWeights(order,nDims);
-
   Uavg.assign(nFields,0);
   double vol = 0;
   for (uint spt=0; spt<nSpts; spt++) {
     for (uint i=0; i<nFields; i++) {
-      Uavg[i] += U_spts(spt,i)*weights[spt]*detJ_spts[spt];
+      Uavg[i] += U_spts(spt,i)*wts_spts[spt]*detJ_spts[spt];
     }
-    vol += weights[spt]*detJ_spts[spt];
+    vol += wts_spts[spt]*detJ_spts[spt];
   }
 
   for (auto &i:Uavg) i/= vol;
@@ -1129,6 +1248,31 @@ const matrix<double> &oper::get_oper_div_spts()
   return opp_div_spts;
 }
 
+const matrix<double> &oper::get_oper_spts_fpts()
+{
+  return opp_spts_to_fpts;
+}
+
+const matrix<double> &oper::get_oper_grad_spts_dim(int dim)
+{
+  return opp_grad_spts[dim];
+}
+
+const matrix<double> &oper::get_oper_correction()
+{
+  return opp_correction;
+}
+
+const matrix<double> &oper::get_oper_correctU(int dim)
+{
+  return opp_correctU[dim];
+}
+
+const vector<double> &oper::get_lift_fpts()
+{
+  return lift_fpts;
+}
+
 double oper::VCJH_quad(uint fpt, point& loc, vector<double>& spts1D, uint vcjh, uint order)
 {
   double eta;
@@ -1244,8 +1388,8 @@ double oper::divVCJH_hex(int in_fpt, point& loc, vector<double>& loc_1d_spts, ui
   return div_vcjh_basis;
 }
 
-// Method to capture shock in the element
-double oper::shockCaptureInEle(matrix<double> &U_spts, double threshold)
+// Concentration-method sensor for discontinuities in the element
+double oper::shockSensor(matrix<double> &U_spts)
 {
   double sensor = 0;
   if(eType == TRI)
@@ -1254,82 +1398,163 @@ double oper::shockCaptureInEle(matrix<double> &U_spts, double threshold)
 
     // Sensing Part
     int p = 3;  // Exponent of concentration method
-    matrix<double> Rho(order+1,order+1);
-    vector<double> rho = U_spts.getCol(0);
-    vector<double> rho_x, rho_y, uEx, uEy;
-    std::vector<double>::iterator maxuEx, maxuEy;
-    double newmax, currmax = 0;
-
-    // Put the density into a 2D matrix- to access as row,col
-    Rho.vecToMatrixResize(rho);
-
-    // Sense along the X and Y-slices
-    for(uint i=0; i<order+1; i++) {
-      rho_x = Rho.getRow(i);
-      rho_y = Rho.getCol(i);
-      sensingMatrix.timesVector(rho_x,uEx);
-      sensingMatrix.timesVector(rho_x,uEy);
-      maxuEx = max_element(uEx.begin(), uEx.end(), abs_compare);
-      maxuEy = max_element(uEx.begin(), uEx.end(), abs_compare);
-      newmax = max(abs(*maxuEx),abs(*maxuEy));
-      currmax = max(currmax,newmax);
+    uint nSpts1D = order+1;
+    double currmax = 0;
+
+    // Sense along the X-slices [rows of the tensor-product density, read
+    // directly from U_spts]
+    for (uint i=0; i<nSpts1D; i++) {
+      double maxuE = 0;
+      for (uint r=0; r<sensingMatrix.getDim0(); r++) {
+        double uE = 0;
+        for (uint j=0; j<nSpts1D; j++)
+          uE += sensingMatrix(r,j)*U_spts(i*nSpts1D+j,0);
+        if (r == 0 || abs_compare(maxuE,uE)) maxuE = uE;
+      }
+      currmax = max(currmax,abs(maxuE));
     }
 
     sensor = pow(currmax,p)*pow(order+1,p/2);
-
-    //Filtering Part
-    if(sensor >= threshold) {
-      //cout<<"It is filtering!"<<endl;
-      matrix<double> tempMatrix(U_spts.getDim0(),U_spts.getDim1());
-      filterMatrix.timesMatrix(U_spts,tempMatrix);
-      U_spts = tempMatrix;
-    }
   }
   return sensor;
 }
 
-void oper::setupPMG(int my_order)
+void oper::applyFilter(vector<matrix<double>*> &U_spts)
 {
-  /* Allocate memory for operators */
-  unsigned int nSpts_pro_1D = order+2;
-  unsigned int nSpts_res_1D = order;
-  unsigned int nSpts_pro = nSpts_pro_1D * nSpts_pro_1D;
-  unsigned int nSpts_res = nSpts_res_1D * nSpts_res_1D;
+  uint nEles = U_spts.size();
+  if (nEles == 0 || eType != QUAD) return;
+
+  static thread_local matrix<double> U_batch, UF_batch;
+  U_batch.setup(nSpts,nEles*nFields);
 
+  for (uint ie=0; ie<nEles; ie++)
+    for (uint spt=0; spt<nSpts; spt++)
+      for (uint k=0; k<nFields; k++)
+        U_batch(spt,ie*nFields+k) = (*U_spts[ie])(spt,k);
+
+  filterMatrix.timesMatrix(U_batch,UF_batch);
+
+  for (uint ie=0; ie<nEles; ie++)
+    for (uint spt=0; spt<nSpts; spt++)
+      for (uint k=0; k<nFields; k++)
+        (*U_spts[ie])(spt,k) = UF_batch(spt,ie*nFields+k);
+}
+
+void oper::setupPMG(int my_order)
+{
+  /* Tensor-product Lagrange interpolation between this order's solution
+   * points and those of order+1 [prolongation] and order-1 [restriction] */
+  uint nSpts1D = order+1;
   auto loc_spts = getPts1D(sptsType,my_order);
 
-  vector<double> loc(nDims, 0.0);
+  auto setupInterp = [&](matrix<double> &opp, int order2) {
+    uint nSpts2_1D = order2+1;
+    uint nSpts2 = (nDims == 2) ? nSpts2_1D*nSpts2_1D : nSpts2_1D*nSpts2_1D*nSpts2_1D;
+    auto loc_spts2 = getPts1D(sptsType,order2);
 
-  /* Setup prolongation operator */
-  opp_prolong.setup(nSpts_pro, nSpts);
+    opp.setup(nSpts2, nSpts);
 
-  auto loc_spts_pro_1D = getPts1D(sptsType,order+1);
+    for (uint spt = 0; spt < nSpts; spt++) {
+      uint ispt = spt % nSpts1D;
+      uint jspt = (spt / nSpts1D) % nSpts1D;
+      uint kspt = spt / (nSpts1D*nSpts1D);
+      for (uint spt2 = 0; spt2 < nSpts2; spt2++) {
+        uint i2 = spt2 % nSpts2_1D;
+        uint j2 = (spt2 / nSpts2_1D) % nSpts2_1D;
+        uint k2 = spt2 / (nSpts2_1D*nSpts2_1D);
+        double val = Lagrange(loc_spts,loc_spts2[i2],ispt) * Lagrange(loc_spts,loc_spts2[j2],jspt);
+        if (nDims == 3)
+          val *= Lagrange(loc_spts,loc_spts2[k2],kspt);
+        opp(spt2, spt) = val;
+      }
+    }
+  };
 
-  for (uint spt = 0; spt < nSpts; spt++) {
-    uint ispt = spt % (nSpts/(order+1));
-    uint jspt = floor(spt/(order+1));
-    for (uint pspt = 0; pspt < nSpts_pro; pspt++) {
-      loc[0] = loc_spts_pro_1D[pspt%nSpts_pro_1D];
-      loc[1] = loc_spts_pro_1D[floor(pspt/nSpts_pro_1D)];
+  /* Setup prolongation operator */
+  setupInterp(opp_prolong, order+1);
 
-      opp_prolong(pspt, spt) = Lagrange(loc_spts,loc[0],ispt) * Lagrange(loc_spts,loc[1],jspt);
+  /* Setup restriction operator */
+  if (order != 0)
+    setupInterp(opp_restrict, order-1);
+}
+
+void sumFactOper::setup(matrix<double> &op)
+{
+  nRows = op.getDim0();
+  nCols = op.getDim1();
+
+  rowStart.assign(1,0);
+  cols.resize(0);
+  vals.resize(0);
+
+  // Entries off of each row's 1D line are exactly zero [Lagrange(x_j,x_k) for j != k]
+  for (uint i=0; i<nRows; i++) {
+    for (uint j=0; j<nCols; j++) {
+      if (op(i,j) != 0.) {
+        cols.push_back(j);
+        vals.push_back(op(i,j));
+      }
     }
+    rowStart.push_back(cols.size());
   }
 
-  if (order != 0) {
-    /* Setup restriction operator */
-    opp_restrict.setup(nSpts_res, nSpts);
+  // Not worth the indirection unless most of the operator is empty
+  active = (2*vals.size() <= nRows*nCols);
+}
 
-    auto loc_spts_res_1D = getPts1D(sptsType,order-1);
+void sumFactOper::timesMatrix(matrix<double> &A, matrix<double> &B)
+{
+  mult(A,B,true);
+}
 
-    for (uint spt = 0; spt < nSpts; spt++) {
-      uint ispt = spt % (nSpts/(order+1));
-      uint jspt = floor(spt/(order+1));
-      for (uint rspt = 0; rspt < nSpts_res; rspt++) {
-        loc[0] = loc_spts_res_1D[rspt%nSpts_res_1D];
-        loc[1] = loc_spts_res_1D[floor(rspt/nSpts_res_1D)];
-        opp_restrict(rspt, spt) = Lagrange(loc_spts,loc[0],ispt) * Lagrange(loc_spts,loc[1],jspt);
-      }
+void sumFactOper::timesMatrixPlus(matrix<double> &A, matrix<double> &B)
+{
+  mult(A,B,false);
+}
+
+//! B (+)= Op*A for columns [k0,k1) of A & B
+static void sumFactMultCols(const uint* rowStart, const uint* cols, const double* vals, uint nRows,
+                            const double* __restrict__ A, uint lda, double* __restrict__ B, uint ldb,
+                            uint k0, uint k1, bool zero)
+{
+  for (uint i=0; i<nRows; i++) {
+    double* __restrict__ Bi = B+i*ldb;
+
+    if (zero)
+      for (uint k=k0; k<k1; k++)
+        Bi[k] = 0;
+
+    for (uint n=rowStart[i]; n<rowStart[i+1]; n++) {
+      const double val = vals[n];
+      const double* __restrict__ Aj = A+cols[n]*lda;
+      for (uint k=k0; k<k1; k++)
+        Bi[k] += val*Aj[k];
     }
   }
 }
+
+void sumFactOper::mult(matrix<double> &A, matrix<double> &B, bool zero)
+{
+#ifdef _DEBUG
+  if (A.getDim0() != nCols) FatalErrorST("Incompatible matrix sizes in sum-factorized operator!");
+#endif
+  uint p = A.getDim1();
+  if (B.getDim0() != nRows || B.getDim1() != p) B.setup(nRows,p);
+
+#ifdef _OPENMP
+  // When applied to an entire eleBlock, split the columns among the threads
+  if (p >= 1024 && !omp_in_parallel()) {
+#pragma omp parallel
+    {
+      uint nThreads = omp_get_num_threads();
+      uint thread = omp_get_thread_num();
+      uint k0 = (p*thread) / nThreads;
+      uint k1 = (p*(thread+1)) / nThreads;
+      sumFactMultCols(rowStart.data(),cols.data(),vals.data(),nRows,A.dataPtr,A.stride,B.dataPtr,B.stride,k0,k1,zero);
+    }
+    return;
+  }
+#endif
+
+  sumFactMultCols(rowStart.data(),cols.data(),vals.data(),nRows,A.dataPtr,A.stride,B.dataPtr,B.stride,0,p,zero);
+}
@@ -28,8 +28,17 @@
  */
 #include "output.hpp"
 
+#include <climits>
+#include <cstdint>
+#include <cstring>
 #include <iomanip>
+#include <memory>
 #include <string>
+#include <thread>
+
+#ifdef _ZLIB
+#include <zlib.h>
+#endif
 
 // Used for making sub-directories (for MPI and 'time-stamp' files)
 #include <sys/types.h>
@@ -40,13 +49,54 @@
 #include "mpi.h"
 #endif
 
+/*! Background writer thread for asynchronous output; joined before the next
+ *  write is started, at the end of the run, and on exit */
+static struct asyncWriter
+{
+  thread worker;
+  shared_ptr<plotData> data;  //! Staged data being written by 'worker'
+
+  void wait(void)
+  {
+    if (worker.joinable()) worker.join();
+    data.reset();
+  }
+
+  ~asyncWriter() { wait(); }
+} writer;
+
+void finishOutput(void)
+{
+  writer.wait();
+}
+
 void writeData(solver *Solver, input *params)
 {
+  PROFILE("writeData");
+
+  Solver->syncHost();
+
   if (params->plotType == 0) {
     writeCSV(Solver,params);
   }
   else if (params->plotType == 1) {
-    writeParaview(Solver,params);
+    if (params->asyncOutput) {
+      // Snapshot the plot data now, then hand it to the background thread
+      // [only one file is in flight at a time, to bound the staging memory]
+      auto data = make_shared<plotData>();
+      bool haveData = stageParaview(Solver,params,*data);
+
+      writer.wait();
+      if (haveData) {
+        writer.data = data;
+        writer.worker = thread(writeParaviewFile,std::cref(*data),params);
+      }
+
+      if (params->rank == 0) cout << "queued." <<  endl;
+    }
+    else {
+      writeParaview(Solver,params);
+    }
   }
 
   /* Write out mesh in Tecplot format, with IBLANK data [Overset cases only] */
@@ -55,6 +105,150 @@ void writeData(solver *Solver, input *params)
   }
 }
 
+string getRestartFileName(input *params, int iter, int rank)
+{
+  char fileNameC[256];
+  string fileName = params->dataFileName;
+
+  if (params->restartType == 1) {
+    sprintf(fileNameC,"%s_%.09d.rst",&fileName[0],iter);
+  }
+  else {
+#ifndef _NO_MPI
+    sprintf(fileNameC,"%s_%.09d/%s_%.09d_%d.rst",&fileName[0],iter,&fileName[0],iter,rank);
+#else
+    sprintf(fileNameC,"%s_%.09d_%d.rst",&fileName[0],iter,rank);
+#endif
+  }
+
+  return string(fileNameC);
+}
+
+void writeRestartFile(solver *Solver, input *params)
+{
+  PROFILE("writeRestartFile");
+
+  Solver->syncHost();
+
+  int iter = params->iter;
+  int nFields = params->nFields;
+
+  if (params->rank == 0)
+    cout << "Writing restart file " << getRestartFileName(params,iter,0) << "...  " << flush;
+
+  /* --- Pack this rank's element records --- */
+  int64_t nEles = Solver->eles.size();
+  int64_t nBytes = 0;
+  for (auto &e:Solver->eles)
+    nBytes += 4*sizeof(int) + e->nSpts*nFields*sizeof(double);
+
+  vector<char> buf(nBytes);
+  char *ptr = buf.data();
+  for (auto &e:Solver->eles) {
+    int info[4] = {e->IDg, e->eType, e->order, e->nSpts};
+    memcpy(ptr, info, sizeof(info));
+    ptr += sizeof(info);
+
+    double *U = (double*)ptr;
+    for (int spt=0; spt<e->nSpts; spt++)
+      for (int k=0; k<nFields; k++)
+        U[spt*nFields+k] = e->U_spts(spt,k);
+    ptr += e->nSpts*nFields*sizeof(double);
+  }
+
+  restartHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, "FLURRYRS", 8);
+  header.version = 2;
+  header.nRanks = params->nproc;
+  header.nDims = params->nDims;
+  header.nFields = nFields;
+  header.iter = iter;
+  header.time = params->time;
+  header.dt = params->dt;
+
+  if (params->restartType == 1) {
+    /* --- All ranks' partitions in one file --- */
+    header.nParts = params->nproc;
+    header.part = -1;
+
+    vector<int64_t> table(3*params->nproc);
+    int64_t myInfo[2] = {nEles, nBytes};
+    vector<int64_t> allInfo(2*params->nproc);
+#ifndef _NO_MPI
+    MPI_Allgather(myInfo, 2, MPI_INT64_T, allInfo.data(), 2, MPI_INT64_T, MPI_COMM_WORLD);
+#else
+    allInfo[0] = myInfo[0];  allInfo[1] = myInfo[1];
+#endif
+
+    int64_t offset = sizeof(restartHeader) + table.size()*sizeof(int64_t);
+    for (int p=0; p<params->nproc; p++) {
+      table[3*p+0] = allInfo[2*p];
+      table[3*p+1] = offset;
+      table[3*p+2] = allInfo[2*p+1];
+      offset += allInfo[2*p+1];
+    }
+
+    string fileName = getRestartFileName(params,iter,params->rank);
+
+#ifndef _NO_MPI
+    if (nBytes > INT_MAX)
+      FatalError("Restart data on one rank exceeds 2GB; use per-rank restart files [restartType 2].");
+
+    MPI_File fh;
+    MPI_File_open(MPI_COMM_WORLD, &fileName[0], MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh);
+    MPI_File_set_size(fh, 0);
+
+    if (params->rank == 0) {
+      MPI_File_write_at(fh, 0, &header, sizeof(header), MPI_BYTE, MPI_STATUS_IGNORE);
+      MPI_File_write_at(fh, sizeof(header), table.data(), table.size()*sizeof(int64_t), MPI_BYTE, MPI_STATUS_IGNORE);
+    }
+
+    MPI_File_write_at_all(fh, table[3*params->rank+1], buf.data(), (int)nBytes, MPI_BYTE, MPI_STATUS_IGNORE);
+    MPI_File_close(&fh);
+#else
+    ofstream dataFile(fileName, ios::binary | ios::trunc);
+    if (!dataFile.is_open())
+      FatalError("Unable to open restart file for writing.");
+
+    dataFile.write((char*)&header, sizeof(header));
+    dataFile.write((char*)table.data(), table.size()*sizeof(int64_t));
+    dataFile.write(buf.data(), nBytes);
+    dataFile.close();
+#endif
+  }
+  else {
+    /* --- Each rank writes its own file --- */
+    header.nParts = 1;
+    header.part = params->rank;
+
+#ifndef _NO_MPI
+    if (params->rank == 0) {
+      char datadirC[256];
+      sprintf(datadirC,"%s_%.09d",&params->dataFileName[0],iter);
+      struct stat st = {0};
+      if (stat(datadirC, &st) == -1)
+        mkdir(datadirC, 0755);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+#endif
+
+    int64_t table[3] = {nEles, (int64_t)(sizeof(restartHeader) + sizeof(table)), nBytes};
+
+    ofstream dataFile(getRestartFileName(params,iter,params->rank), ios::binary | ios::trunc);
+    if (!dataFile.is_open())
+      FatalError("Unable to open restart file for writing.");
+
+    dataFile.write((char*)&header, sizeof(header));
+    dataFile.write((char*)table, sizeof(table));
+    dataFile.write(buf.data(), nBytes);
+    dataFile.close();
+  }
+
+  if (params->rank == 0)
+    cout << "done." << endl;
+}
+
 void writeCSV(solver *Solver, input *params)
 {
   ofstream dataFile;
@@ -70,7 +264,7 @@ void writeCSV(solver *Solver, input *params)
   dataFile.open(fileNameC);
 
   // Vector of primitive variables
-  vector<double> V;
+  vector<double> V(params->nFields);
   // Location of solution point
   point pt;
 
@@ -97,7 +291,7 @@ void writeCSV(solver *Solver, input *params)
       e->setPpts();
     }
     for (uint spt=0; spt<e->getNSpts(); spt++) {
-      V = e->getPrimitives(spt);
+      e->getPrimitives(spt,V.data());
       pt = e->getPosSpt(spt);
 
       for (uint dim=0; dim<e->getNDims(); dim++) {
@@ -113,7 +307,7 @@ void writeCSV(solver *Solver, input *params)
 
     if (plotFpts) {
       for (uint fpt=0; fpt<e->getNFpts(); fpt++) {
-        V = e->getPrimitivesFpt(fpt);
+        e->getPrimitivesFpt(fpt,V.data());
         pt = e->getPosFpt(fpt);
 
         for (uint dim=0; dim<e->getNDims(); dim++) {
@@ -132,9 +326,84 @@ void writeCSV(solver *Solver, input *params)
   dataFile.close();
 }
 
-void writeParaview(solver *Solver, input *params)
+/*! Base64-encode the given bytes and append them to 'out' */
+static void appendBase64(string &out, const unsigned char *data, size_t nBytes)
+{
+  static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+  for (size_t i=0; i<nBytes; i+=3) {
+    unsigned int n = data[i] << 16;
+    if (i+1 < nBytes) n |= data[i+1] << 8;
+    if (i+2 < nBytes) n |= data[i+2];
+
+    out += table[(n >> 18) & 63];
+    out += table[(n >> 12) & 63];
+    out += (i+1 < nBytes) ? table[(n >> 6) & 63] : '=';
+    out += (i+2 < nBytes) ? table[n & 63] : '=';
+  }
+}
+
+/*! Append one DataArray's binary data block [header + data] to the appended
+ *  data section, zlib-compressed and/or base64-encoded if requested
+ *  The header and data are encoded separately, as VTK's own writer does */
+static void appendBinaryBlock(string &appended, input *params, const char *data, size_t nBytes)
+{
+  vector<uint64_t> header;
+  const char *block = data;
+  size_t blockSize = nBytes;
+
+#ifdef _ZLIB
+  vector<Bytef> comp;
+  if (params->vtuCompress) {
+    // A single compressed block: {nBlocks, blockSize, lastBlockSize, compressedSize}
+    uLongf compSize = compressBound(nBytes);
+    comp.resize(compSize);
+    if (compress2(comp.data(), &compSize, (const Bytef*)data, nBytes, Z_DEFAULT_COMPRESSION) != Z_OK)
+      FatalError("zlib compression of ParaView data failed.");
+    header = {1, nBytes, nBytes, compSize};
+    block = (const char*)comp.data();
+    blockSize = compSize;
+  }
+  else
+#endif
+  {
+    header = {nBytes};
+  }
+
+  if (params->vtuFormat == 1) {
+    appended.append((const char*)header.data(), header.size()*sizeof(uint64_t));
+    appended.append(block, blockSize);
+  }
+  else {
+    appendBase64(appended, (const unsigned char*)header.data(), header.size()*sizeof(uint64_t));
+    appendBase64(appended, (const unsigned char*)block, blockSize);
+  }
+}
+
+/*! Write a DataArray element [with the given type, name, etc. attributes]
+ *  ASCII: values are written inline; binary: values are converted to T and
+ *  added to the appended data section, and the element refers to them by offset */
+template<typename T, typename S>
+static void writeDataArray(ofstream &dataFile, string &appended, input *params, const string &attrs, const vector<S> &vals)
+{
+  if (params->vtuFormat == 0) {
+    dataFile << "				<DataArray " << attrs << " format=\"ascii\">" << endl;
+    for (auto &val:vals) {
+      dataFile << val << " ";
+    }
+    dataFile << endl;
+    dataFile << "				</DataArray>" << endl;
+  }
+  else {
+    dataFile << "				<DataArray " << attrs << " format=\"appended\" offset=\"" << appended.size() << "\"/>" << endl;
+
+    vector<T> tmp(vals.begin(), vals.end());
+    appendBinaryBlock(appended, params, (const char*)tmp.data(), tmp.size()*sizeof(T));
+  }
+}
+
+bool stageParaview(solver *Solver, input *params, plotData &data)
 {
-  ofstream dataFile;
   int iter = params->iter;
 
   char fileNameC[256];
@@ -239,29 +508,13 @@ void writeParaview(solver *Solver, input *params)
 #endif
 
   /* --- Move onto the rank-specific data file --- */
-  if (Solver->eles.size()==0) return;
-
-  dataFile.open(fileNameC);
-  dataFile.precision(16);
-
-  // File header
-  dataFile << "<?xml version=\"1.0\" ?>" << endl;
-  dataFile << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\" compressor=\"vtkZLibDataCompressor\">" << endl;
-
-  // Write simulation time and iteration number
-  dataFile << "<!-- TIME " << params->time << " -->" << endl;
-  dataFile << "<!-- ITER " << params->iter << " -->" << endl;
+  if (Solver->eles.size()==0) return false;
 
-  // Write the cell iblank data for restarting purposes
-  if (params->meshType == OVERSET_MESH) {
-    dataFile << "<!-- IBLANK_CELL ";
-    for (int i=0; i<Solver->Geo->nEles; i++) {
-      dataFile << Solver->Geo->iblankCell[i] << " ";
-    }
-    dataFile << " -->" << endl;
-  }
-
-  dataFile << "	<UnstructuredGrid>" << endl;
+  data.fileName = string(fileNameC);
+  data.iter = params->iter;
+  data.time = params->time;
+  if (params->meshType == OVERSET_MESH)
+    data.iblankCell = Solver->Geo->iblankCell;
 
   // If this is the initial file, need to extrapolate solution to flux points
   //if (params->iter==params->initIter)
@@ -285,6 +538,8 @@ void writeParaview(solver *Solver, input *params)
     }
   }
 
+  data.eles.clear();
+  data.eles.reserve(Solver->eles.size());
   for (auto& e:Solver->eles) {
     if (params->meshType == OVERSET_MESH && Solver->Geo->iblankCell[e->ID]!=NORMAL) continue;
 
@@ -295,31 +550,84 @@ void writeParaview(solver *Solver, input *params)
     }
 
     // The combination of spts + fpts will be the plot points
-    matrix<double> vPpts, gridVelPpts, errPpts;
-    vector<point> ppts;
-    e->getPrimitivesPlot(vPpts);
+    data.eles.push_back(plotEle());
+    plotEle &pe = data.eles.back();
+    pe.order = e->order;
+    e->getPrimitivesPlot(pe.V);
     if (params->motion)
-      e->getGridVelPlot(gridVelPpts);
-    ppts = e->getPpts();
+      e->getGridVelPlot(pe.gridVel);
+    pe.ppts = e->getPpts();
 
     // Shock Capturing stuff
-    double sensor;
+    pe.sensor = 0;
     if(params->scFlag == 1) {
-      sensor = e->getSensor();
+      pe.sensor = e->getSensor();
     }
 
     if (params->equation == NAVIER_STOKES && params->calcEntropySensor)
-      e->getEntropyErrPlot(errPpts);
+      e->getEntropyErrPlot(pe.err);
+
+    pe.iblank = NORMAL;
+    if (params->meshType == OVERSET_MESH)
+      pe.iblank = Solver->Geo->iblankCell[e->ID];
+  }
+
+  return true;
+}
+
+void writeParaviewFile(const plotData &data, input *params)
+{
+  ofstream dataFile;
+
+  dataFile.open(data.fileName.c_str(), ios::out | ios::binary);
+  dataFile.precision(16);
+
+  // Encoded binary data for all DataArrays, written at the end of the file
+  string appended;
+
+  // File header
+  dataFile << "<?xml version=\"1.0\" ?>" << endl;
+  if (params->vtuFormat == 0) {
+    dataFile << "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\" compressor=\"vtkZLibDataCompressor\">" << endl;
+  }
+  else {
+    dataFile << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"LittleEndian\" header_type=\"UInt64\"";
+    if (params->vtuCompress)
+      dataFile << " compressor=\"vtkZLibDataCompressor\"";
+    dataFile << ">" << endl;
+  }
+
+  // Write simulation time and iteration number
+  dataFile << "<!-- TIME " << data.time << " -->" << endl;
+  dataFile << "<!-- ITER " << data.iter << " -->" << endl;
+
+  // Write the cell iblank data for restarting purposes
+  if (params->meshType == OVERSET_MESH) {
+    dataFile << "<!-- IBLANK_CELL ";
+    for (auto &ib:data.iblankCell) {
+      dataFile << ib << " ";
+    }
+    dataFile << " -->" << endl;
+  }
+
+  dataFile << "	<UnstructuredGrid>" << endl;
+
+  for (auto& pe:data.eles) {
+    const matrix<double> &vPpts = pe.V;
+    const matrix<double> &gridVelPpts = pe.gridVel;
+    const matrix<double> &errPpts = pe.err;
+    const vector<point> &ppts = pe.ppts;
+    const double sensor = pe.sensor;
 
     int nSubCells, nPpts;
-    int nPpts1D = e->order+3;
+    int nPpts1D = pe.order+3;
     if (params->nDims == 2) {
-      nSubCells = (e->order+2)*(e->order+2);
-      nPpts = (e->order+3)*(e->order+3);
+      nSubCells = (pe.order+2)*(pe.order+2);
+      nPpts = (pe.order+3)*(pe.order+3);
     }
     else if (params->nDims == 3) {
-      nSubCells = (e->order+2)*(e->order+2)*(e->order+2);
-      nPpts = (e->order+3)*(e->order+3)*(e->order+3);
+      nSubCells = (pe.order+2)*(pe.order+2)*(pe.order+2);
+      nPpts = (pe.order+3)*(pe.order+3)*(pe.order+3);
     }
     else
       FatalError("Invalid dimensionality [nDims].");
@@ -331,88 +639,63 @@ void writeParaview(solver *Solver, input *params)
 
     dataFile << "			<PointData>" << endl;
 
+    vector<double> vals;
+
     /* --- Density --- */
-    dataFile << "				<DataArray type=\"Float32\" Name=\"Density\" format=\"ascii\">" << endl;
+    vals.resize(nPpts);
     for(int k=0; k<nPpts; k++) {
-      dataFile << vPpts(k,0) << " ";
+      vals[k] = vPpts(k,0);
     }
-    dataFile << endl;
-    dataFile << "				</DataArray>" << endl;
+    writeDataArray<float>(dataFile,appended,params,"type=\"Float32\" Name=\"Density\"",vals);
 
     if (params->equation == NAVIER_STOKES) {
       /* --- Velocity --- */
-      dataFile << "				<DataArray type=\"Float32\" NumberOfComponents=\"3\" Name=\"Velocity\" format=\"ascii\">" << endl;
+      // In 2D the z-component of velocity is not stored, but Paraview needs it so write a 0.
+      vals.resize(3*nPpts);
       for(int k=0; k<nPpts; k++) {
-        dataFile << vPpts(k,1) << " " << vPpts(k,2) << " ";
-
-        // In 2D the z-component of velocity is not stored, but Paraview needs it so write a 0.
-        if(params->nDims==2) {
-          dataFile << 0.0 << " ";
-        }
-        else {
-          dataFile << vPpts(k,3) << " ";
-        }
+        vals[3*k+0] = vPpts(k,1);
+        vals[3*k+1] = vPpts(k,2);
+        vals[3*k+2] = (params->nDims==2) ? 0.0 : vPpts(k,3);
       }
-      dataFile << endl;
-      dataFile << "				</DataArray>" << endl;
+      writeDataArray<float>(dataFile,appended,params,"type=\"Float32\" NumberOfComponents=\"3\" Name=\"Velocity\"",vals);
 
       /* --- Pressure --- */
-      dataFile << "				<DataArray type=\"Float32\" Name=\"Pressure\" format=\"ascii\">" << endl;
+      vals.resize(nPpts);
       for(int k=0; k<nPpts; k++) {
-        dataFile << vPpts(k,params->nDims+1) << " ";
+        vals[k] = vPpts(k,params->nDims+1);
       }
-      dataFile << endl;
-      dataFile << "				</DataArray>" << endl;
+      writeDataArray<float>(dataFile,appended,params,"type=\"Float32\" Name=\"Pressure\"",vals);
 
       if (params->calcEntropySensor) {
         /* --- Entropy Error Estimate --- */
-        dataFile << "				<DataArray type=\"Float32\" Name=\"EntropyErr\" format=\"ascii\">" << endl;
         for(int k=0; k<nPpts; k++) {
-          dataFile << std::abs(errPpts(k)) << " ";
+          vals[k] = std::abs(errPpts(k));
         }
-        dataFile << endl;
-        dataFile << "				</DataArray>" << endl;
+        writeDataArray<float>(dataFile,appended,params,"type=\"Float32\" Name=\"EntropyErr\"",vals);
       }
     }
 
     if(params->scFlag == 1) {
       /* --- Shock Sensor --- */
-      dataFile << "				<DataArray type=\"Float32\" Name=\"Sensor\" format=\"ascii\">" << endl;
-      for(int k=0; k<nPpts; k++) {
-        dataFile << sensor << " ";
-      }
-      dataFile << endl;
-      dataFile << "				</DataArray>" << endl;
+      vals.assign(nPpts,sensor);
+      writeDataArray<float>(dataFile,appended,params,"type=\"Float32\" Name=\"Sensor\"",vals);
     }
 
     if (params->motion > 0) {
       /* --- Grid Velocity --- */
-      dataFile << "				<DataArray type=\"Float32\" NumberOfComponents=\"3\" Name=\"GridVelocity\" format=\"ascii\">" << endl;
+      vals.resize(3*nPpts);
       for(int k=0; k<nPpts; k++) {
-        // Divide momentum components by density to obtain velocity components
-        dataFile << gridVelPpts(k,0) << " " << gridVelPpts(k,1) << " ";
-
-        // In 2D the z-component of velocity is not stored, but Paraview needs it so write a 0.
-        if(params->nDims==2) {
-          dataFile << 0.0 << " ";
-        }
-        else {
-          dataFile << gridVelPpts(k,2) << " ";
-        }
+        vals[3*k+0] = gridVelPpts(k,0);
+        vals[3*k+1] = gridVelPpts(k,1);
+        vals[3*k+2] = (params->nDims==2) ? 0.0 : gridVelPpts(k,2);
       }
-      dataFile << endl;
-      dataFile << "				</DataArray>" << endl;
+      writeDataArray<float>(dataFile,appended,params,"type=\"Float32\" NumberOfComponents=\"3\" Name=\"GridVelocity\"",vals);
     }
 
     if (params->meshType == OVERSET_MESH && params->writeIBLANK) {
       /* --- TIOGA iBlank value --- */
-      dataFile << "				<DataArray type=\"Float32\" Name=\"IBLANK\" format=\"ascii\">" << endl;
-
-      for(int k=0; k<nPpts; k++) {
-        dataFile << Solver->Geo->iblankCell[e->ID] << " ";
-      }
-      dataFile << endl;
-      dataFile << "				</DataArray>" << endl;
+      vals.assign(nPpts,pe.iblank);
+      writeDataArray<float>(dataFile,appended,params,"type=\"Float32\" Name=\"IBLANK\"",vals);
     }
 
     /* --- End of Cell's Solution Data --- */
@@ -423,38 +706,30 @@ void writeParaview(solver *Solver, input *params)
 
     /* --- Write out the plot point coordinates --- */
     dataFile << "			<Points>" << endl;
-    dataFile << "				<DataArray type=\"Float32\" NumberOfComponents=\"3\" format=\"ascii\">" << endl;
 
-    // Loop over plot points in element
+    // If 2D, write a 0 as the z-component
+    vals.resize(3*nPpts);
     for(int k=0; k<nPpts; k++) {
-      for(int l=0;l<params->nDims;l++) {
-        dataFile << ppts[k][l] << " ";
-      }
-
-      // If 2D, write a 0 as the z-component
-      if(params->nDims == 2) {
-        dataFile << "0 ";
+      for(int l=0; l<3; l++) {
+        vals[3*k+l] = (l < params->nDims) ? ppts[k][l] : 0.;
       }
     }
+    writeDataArray<float>(dataFile,appended,params,"type=\"Float32\" NumberOfComponents=\"3\"",vals);
 
-    dataFile << endl;
-    dataFile << "				</DataArray>" << endl;
     dataFile << "			</Points>" << endl;
 
     /* --- Write out Cell data: connectivity, offsets, element types --- */
     dataFile << "			<Cells>" << endl;
 
     /* --- Write connectivity array --- */
-    dataFile << "				<DataArray type=\"Int32\" Name=\"connectivity\" format=\"ascii\">" << endl;
-
+    vector<int> conn;
     if (params->nDims == 2) {
       for (int j=0; j<nPpts1D-1; j++) {
         for (int i=0; i<nPpts1D-1; i++) {
-          dataFile << j*nPpts1D     + i   << " ";
-          dataFile << j*nPpts1D     + i+1 << " ";
-          dataFile << (j+1)*nPpts1D + i+1 << " ";
-          dataFile << (j+1)*nPpts1D + i   << " ";
-          dataFile << endl;
+          conn.push_back(j*nPpts1D     + i  );
+          conn.push_back(j*nPpts1D     + i+1);
+          conn.push_back((j+1)*nPpts1D + i+1);
+          conn.push_back((j+1)*nPpts1D + i  );
         }
       }
     }
@@ -462,114 +737,131 @@ void writeParaview(solver *Solver, input *params)
       for (int k=0; k<nPpts1D-1; k++) {
         for (int j=0; j<nPpts1D-1; j++) {
           for (int i=0; i<nPpts1D-1; i++) {
-            dataFile << i   + nPpts1D*(j   + nPpts1D*k) << " ";
-            dataFile << i+1 + nPpts1D*(j   + nPpts1D*k) << " ";
-            dataFile << i+1 + nPpts1D*(j+1 + nPpts1D*k) << " ";
-            dataFile << i   + nPpts1D*(j+1 + nPpts1D*k) << " ";
-
-            dataFile << i   + nPpts1D*(j   + nPpts1D*(k+1)) << " ";
-            dataFile << i+1 + nPpts1D*(j   + nPpts1D*(k+1)) << " ";
-            dataFile << i+1 + nPpts1D*(j+1 + nPpts1D*(k+1)) << " ";
-            dataFile << i   + nPpts1D*(j+1 + nPpts1D*(k+1)) << " ";
-
-            dataFile << endl;
+            conn.push_back(i   + nPpts1D*(j   + nPpts1D*k));
+            conn.push_back(i+1 + nPpts1D*(j   + nPpts1D*k));
+            conn.push_back(i+1 + nPpts1D*(j+1 + nPpts1D*k));
+            conn.push_back(i   + nPpts1D*(j+1 + nPpts1D*k));
+
+            conn.push_back(i   + nPpts1D*(j   + nPpts1D*(k+1)));
+            conn.push_back(i+1 + nPpts1D*(j   + nPpts1D*(k+1)));
+            conn.push_back(i+1 + nPpts1D*(j+1 + nPpts1D*(k+1)));
+            conn.push_back(i   + nPpts1D*(j+1 + nPpts1D*(k+1)));
           }
         }
       }
     }
-    dataFile << "				</DataArray>" << endl;
+    writeDataArray<int32_t>(dataFile,appended,params,"type=\"Int32\" Name=\"connectivity\"",conn);
 
     // Write cell-node offsets
     int nvPerCell;
     if (params->nDims == 2) nvPerCell = 4;
     else                    nvPerCell = 8;
-    dataFile << "				<DataArray type=\"Int32\" Name=\"offsets\" format=\"ascii\">" << endl;
+    vector<int> offsets(nSubCells);
     for(int k=0; k<nSubCells; k++){
-      dataFile << (k+1)*nvPerCell << " ";
+      offsets[k] = (k+1)*nvPerCell;
     }
-    dataFile << endl;
-    dataFile << "				</DataArray>" << endl;
+    writeDataArray<int32_t>(dataFile,appended,params,"type=\"Int32\" Name=\"offsets\"",offsets);
 
     // Write VTK element type
     // 5 = tri, 9 = quad, 10 = tet, 12 = hex
     int eType;
     if (params->nDims == 2) eType = 9;
     else                    eType = 12;
-    dataFile << "				<DataArray type=\"UInt8\" Name=\"types\" format=\"ascii\">" << endl;
-    for(int k=0; k<nSubCells; k++) {
-      dataFile << eType << " ";
-    }
-    dataFile << endl;
-    dataFile << "				</DataArray>" << endl;
+    vector<int> types(nSubCells,eType);
+    writeDataArray<uint8_t>(dataFile,appended,params,"type=\"UInt8\" Name=\"types\"",types);
 
     /* --- Write cell and piece footers --- */
     dataFile << "			</Cells>" << endl;
     dataFile << "		</Piece>" << endl;
   }
 
-  /* --- Write footer of file & close --- */
+  /* --- Write footer of file [and the appended binary data] & close --- */
   dataFile << "	</UnstructuredGrid>" << endl;
+  if (params->vtuFormat > 0) {
+    dataFile << "	<AppendedData encoding=\"" << ((params->vtuFormat == 1) ? "raw" : "base64") << "\">" << endl;
+    dataFile << "_";
+    dataFile.write(appended.data(), appended.size());
+    dataFile << endl;
+    dataFile << "	</AppendedData>" << endl;
+  }
   dataFile << "</VTKFile>" << endl;
 
   dataFile.close();
+}
+
+void writeParaview(solver *Solver, input *params)
+{
+  plotData data;
+  if (stageParaview(Solver,params,data))
+    writeParaviewFile(data,params);
 
   if (params->rank == 0) cout << "done." <<  endl;
 }
 
 
-void writeResidual(solver *Solver, input *params)
+/*! A line of monitor output [residual or error norms] whose reduction across
+ *  ranks is still in flight; it is completed & written at the next output
+ *  stage [see finishMonitors], so that the reduction overlaps a time step */
+struct pendingMonitor
 {
-  vector<double> res(params->nFields);
-  int iter = params->iter;
+  bool active = false;
+  input *params;                 //! Run the line belongs to [ensemble members share the monitors]
+  int iter;
+  double time, wallTime, dt;
+  bool takeSqrt = false;         //! Complete an L2 norm once summed [errors]
+  vector<double> local, global;  //! This rank's & the reduced values
+#ifndef _NO_MPI
+  MPI_Request reqs[2];
+#endif
+};
 
-  if (params->dt < 1e-13)
-    FatalError("Instability detected - dt approaching zero!");
+static pendingMonitor pendingRes, pendingErr;
 
-  if (params->resType == 3) {
-    // Infinity Norm
-    for (uint e=0; e<Solver->eles.size(); e++) {
-      if (params->meshType == OVERSET_MESH && Solver->Geo->iblankCell[Solver->eles[e]->ID]!=NORMAL) continue;
-      auto resTmp = Solver->eles[e]->getNormResidual(params->resType);
-      if(checkNaN(resTmp)) {
-        cout << "rank " << params->rank << ", ele " << e << ": ";
-        auto box = Solver->eles[e]->getBoundingBox();
-        cout << " minPt = " << box[0] << "," << box[1] << "," << box[2] << ", maxPt = " << box[3] << "," << box[4] << "," << box[5] << endl;
-        FatalError("NaN Encountered in Solution Residual!");
-      }
+//! Record the iteration, time & time step a monitor line belongs to
+static void stampMonitor(pendingMonitor &m, input *params)
+{
+  m.params = params;
+  m.iter = params->iter;
+  m.time = params->time;
+  m.wallTime = params->timer.getElapsedTime();
+  m.dt = params->dt;
+}
 
-      for (int i=0; i<params->nFields; i++)
-        res[i] = max(res[i],resTmp[i]);
-    }
-  }
-  else if (params->resType == 1 || params->resType == 2) {
-    // 1-Norm or 2-Norm
-    for (uint e=0; e<Solver->eles.size(); e++) {
-      if (params->meshType == OVERSET_MESH && Solver->Geo->iblankCell[Solver->eles[e]->ID]!=NORMAL) continue;
-      auto resTmp = Solver->eles[e]->getNormResidual(params->resType);
-      if(checkNaN(resTmp)) {
-        cout << "rank " << params->rank << ", ele " << e << ": " << flush;
-        auto box = Solver->eles[e]->getBoundingBox();
-        cout << " minPt = " << box[0] << "," << box[1] << "," << box[2] << ", maxPt = " << box[3] << "," << box[4] << "," << box[5] << endl;
-        FatalError("NaN Encountered in Solution Residual!");
-      }
+//! Terminal label of a monitor line: the ensemble member's ID follows the name
+static string monitorTag(const string &name, input *params)
+{
+  if (params->ensembleMember < 0) return name;
 
-      for (int i=0; i<params->nFields; i++)
-        res[i] += resTmp[i];
-    }
-  }
+  return name + to_string(params->ensembleMember);
+}
+
+//! Wait for a pending reduction to finish
+static bool waitMonitor(pendingMonitor &m)
+{
+  if (!m.active) return false;
 
-  vector<double> force(6);
-  if (params->equation == NAVIER_STOKES) {
-    auto fTmp = Solver->computeWallForce();
 #ifndef _NO_MPI
-    MPI_Reduce(fTmp.data(), force.data(), 6, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-#else
-    force = fTmp;
+  MPI_Waitall(2, m.reqs, MPI_STATUSES_IGNORE);
 #endif
+  m.active = false;
+
+  return true;
+}
+
+/*! Print the residual [global: nFields norms followed by the 6 force
+ *  components] to both the terminal and the history file */
+static void printResidual(pendingMonitor &m)
+{
+  input *params = m.params;
+  int iter = m.iter;
+  vector<double> res(m.global.begin(), m.global.begin()+params->nFields);
+  vector<double> force(m.global.begin()+params->nFields, m.global.end());
+
+  if (params->equation == NAVIER_STOKES) {
     for (auto &f:force) f /= (0.5*params->rhoBound*params->Uinf*params->Uinf);
 
     double alpha = std::atan2(params->vBound,params->uBound);
-    fTmp = force;
+    auto fTmp = force;
     force[0] = fTmp[0]*cos(alpha) + fTmp[1]*sin(alpha);  // Rotate to align with freestream
     force[1] = fTmp[1]*cos(alpha) - fTmp[0]*sin(alpha);
     if (params->viscous) {
@@ -578,19 +870,6 @@ void writeResidual(solver *Solver, input *params)
     }
   }
 
-#ifndef _NO_MPI
-  if (params->nproc > 1) {
-    if (params->resType == 3) {
-      vector<double> resTmp = res;
-      MPI_Reduce(resTmp.data(), res.data(), params->nFields, MPI_DOUBLE, MPI_MAX, 0,MPI_COMM_WORLD);
-    }
-    else if (params->resType == 1 || params->resType == 2) {
-      vector<double> resTmp = res;
-      MPI_Reduce(resTmp.data(), res.data(), params->nFields, MPI_DOUBLE, MPI_SUM, 0,MPI_COMM_WORLD);
-    }
-  }
-#endif
-
   if (params->rank == 0) {
     // If taking 2-norm, res is sum squared; take sqrt to complete
     if (params->resType == 2) {
@@ -607,7 +886,7 @@ void writeResidual(solver *Solver, input *params)
       cout << setw(8) << left << "Iter" << "Var  ";
       if (params->equation == ADVECTION_DIFFUSION) {
         cout << setw(colW) << "Residual";
-        if (params->dtType != 0)
+        if (params->dtType != 0 || params->adaptDt)
           cout << setw(colW) << left << "DeltaT";
         cout << endl;
       }else if (params->equation == NAVIER_STOKES) {
@@ -617,7 +896,7 @@ void writeResidual(solver *Solver, input *params)
         if (params->nDims == 3)
           cout << setw(colW) << left << "rhoW";
         cout << setw(colW) << left << "rhoE";
-        if (params->dtType != 0)
+        if (params->dtType != 0 || params->adaptDt)
           cout << setw(colW) << left << "deltaT";
         cout << setw(colW) << left << "CD";
         cout << setw(colW) << left << "CL";
@@ -627,15 +906,15 @@ void writeResidual(solver *Solver, input *params)
       cout << endl;
     }
 
-    // Print residuals
-    cout << setw(8) << left << iter << "Res  ";
+    // Print residuals [tagged with the member ID in ensemble runs]
+    cout << setw(8) << left << iter << setw(5) << left << monitorTag("Res",params);
     for (int i=0; i<params->nFields; i++) {
       cout << setw(colW) << left << res[i];
     }
 
     // Print time step (for CFL time-stepping)
-    if (params->dtType != 0)
-      cout << setw(colW) << left << params->dt;
+    if (params->dtType != 0 || params->adaptDt)
+      cout << setw(colW) << left << m.dt;
 
     // Print wall force coefficients
     if (params->equation == NAVIER_STOKES) {
@@ -669,7 +948,7 @@ void writeResidual(solver *Solver, input *params)
         if (params->nDims == 3)
           histFile << setw(colW) << left << "rhoW";
         histFile << setw(colW) << left << "rhoE";
-        if (params->dtType != 0)
+        if (params->dtType != 0 || params->adaptDt)
           histFile << setw(colW) << left << "deltaT";
         histFile << setw(colW) << left << "CDinv";
         histFile << setw(colW) << left << "CLinv";
@@ -691,15 +970,15 @@ void writeResidual(solver *Solver, input *params)
 
     // Write residuals
     histFile << setw(8) << left << iter;
-    histFile << setw(colW) << left << params->time;
-    histFile << setw(colW) << left << params->timer.getElapsedTime();
+    histFile << setw(colW) << left << m.time;
+    histFile << setw(colW) << left << m.wallTime;
     for (int i=0; i<params->nFields; i++) {
       histFile << setw(colW) << left << res[i];
     }
 
     // Write time step (for CFL time-stepping)
-    if (params->dtType != 0)
-      histFile << setw(colW) << left << params->dt;
+    if (params->dtType != 0 || params->adaptDt)
+      histFile << setw(colW) << left << m.dt;
 
     // Write inviscid wall force coefficients
     if (params->equation == NAVIER_STOKES) {
@@ -718,23 +997,180 @@ void writeResidual(solver *Solver, input *params)
   }
 }
 
+
+//! Print the error norms [global] to both the terminal and the error file
+static void printError(pendingMonitor &m)
+{
+  input *params = m.params;
+  vector<double> err = m.global;
+  if (m.takeSqrt)
+    for (auto &val:err) val = std::sqrt(std::abs(val));
+
+  if (params->rank == 0)
+  {
+    /* --- Write the error out to the terminal --- */
+
+    int colw = 16;
+    cout.precision(6);
+    cout.setf(ios::scientific, ios::floatfield);
+
+    cout << setw(8) << left << m.iter << setw(5) << left << monitorTag("Err",params);
+    for (int i=0; i<err.size(); i++)
+      cout << setw(colw) << left << std::abs(err[i]);
+    cout << endl;
+
+    /* --- Write the error out to the history file --- */
+
+    ofstream errFile;
+    string fileName = params->dataFileName + ".err";
+    errFile.open(fileName.c_str(),ofstream::app);
+
+    errFile.precision(5);
+    errFile.setf(ios::scientific, ios::floatfield);
+
+    if (m.iter==params->initIter+1) {
+      errFile << setw(8) << left << "Iter";
+      errFile << setw(colw) << left << "Flow Time";
+      errFile << setw(colw) << left << "Wall Time";
+      if (params->equation == ADVECTION_DIFFUSION) {
+        errFile << setw(colw) << left << "Error" << endl;
+      } else if (params->equation == NAVIER_STOKES) {
+        errFile << setw(colw) << left << "rho";
+        errFile << setw(colw) << left << "rhoU";
+        errFile << setw(colw) << left << "rhoV";
+        if (params->nDims == 3)
+          errFile << setw(colw) << left << "rhoW";
+        errFile << setw(colw) << left << "rhoE";
+      }
+      errFile << endl;
+    }
+
+    errFile << setw(8) << left << m.iter;
+    errFile << setw(colw) << left << m.time;
+    errFile << setw(colw) << left << m.wallTime;
+    for (int i=0; i<params->nFields; i++) {
+      errFile << setw(colw) << left << std::abs(err[i]);
+    }
+    errFile << endl;
+    errFile.close();
+  }
+}
+
+
+void finishMonitors(void)
+{
+  if (waitMonitor(pendingRes)) printResidual(pendingRes);
+  if (waitMonitor(pendingErr)) printError(pendingErr);
+}
+
+void writeResidual(solver *Solver, input *params)
+{
+  PROFILE("writeResidual");
+
+  Solver->syncHost();
+
+  if (params->dt < 1e-13)
+    FatalError("Instability detected - dt approaching zero!");
+
+  if (waitMonitor(pendingRes)) printResidual(pendingRes);
+
+  auto &m = pendingRes;
+  stampMonitor(m,params);
+
+  int nFields = params->nFields;
+  m.local.assign(nFields+6,0);
+  double *res = m.local.data();
+
+  /* --- This rank's residual norm [the element loop runs in parallel;
+   * the first element with a NaN residual, if any, is reported] --- */
+
+  auto &eles = Solver->eles;
+  uint nanEle = eles.size();
+  bool infNorm = (params->resType == 3);
+
+  if (params->resType >= 1 && params->resType <= 3) {
+#pragma omp parallel
+    {
+      vector<double> resTmp(nFields);
+
+      if (infNorm) {
+        // Infinity Norm
+#pragma omp for reduction(max:res[:nFields]) reduction(min:nanEle)
+        for (uint e=0; e<eles.size(); e++) {
+          if (params->meshType == OVERSET_MESH && Solver->Geo->iblankCell[eles[e]->ID]!=NORMAL) continue;
+          eles[e]->getNormResidual(params->resType,resTmp.data());
+          if (checkNaN(resTmp)) nanEle = min(nanEle,e);
+
+          for (int i=0; i<nFields; i++)
+            res[i] = max(res[i],resTmp[i]);
+        }
+      }
+      else {
+        // 1-Norm or 2-Norm
+#pragma omp for reduction(+:res[:nFields]) reduction(min:nanEle)
+        for (uint e=0; e<eles.size(); e++) {
+          if (params->meshType == OVERSET_MESH && Solver->Geo->iblankCell[eles[e]->ID]!=NORMAL) continue;
+          eles[e]->getNormResidual(params->resType,resTmp.data());
+          if (checkNaN(resTmp)) nanEle = min(nanEle,e);
+
+          for (int i=0; i<nFields; i++)
+            res[i] += resTmp[i];
+        }
+      }
+    }
+  }
+
+  if (nanEle < eles.size()) {
+    cout << "rank " << params->rank << ", ele " << nanEle << ": " << flush;
+    auto box = eles[nanEle]->getBoundingBox();
+    cout << " minPt = " << box[0] << "," << box[1] << "," << box[2] << ", maxPt = " << box[3] << "," << box[4] << "," << box[5] << endl;
+    FatalError("NaN Encountered in Solution Residual!");
+  }
+
+  if (params->equation == NAVIER_STOKES) {
+    auto fTmp = Solver->computeWallForce();
+    for (int i=0; i<6; i++)
+      m.local[nFields+i] = fTmp[i];
+  }
+
+#ifndef _NO_MPI
+  if (params->nproc > 1) {
+    /* --- Post the reductions; they are completed at the next output stage --- */
+    m.global.resize(nFields+6);
+    MPI_Iallreduce(m.local.data(), m.global.data(), nFields, MPI_DOUBLE, (infNorm) ? MPI_MAX : MPI_SUM, MPI_COMM_WORLD, &m.reqs[0]);
+    MPI_Iallreduce(m.local.data()+nFields, m.global.data()+nFields, 6, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, &m.reqs[1]);
+    m.active = true;
+    return;
+  }
+#endif
+
+  m.global = m.local;
+  printResidual(m);
+}
+
+
 void writeAllError(solver *Solver, input *params)
 {
+  finishMonitors();
+
   if (params->testCase == 1) {
     params->errorNorm = 0;
     if (params->rank == 0)
       cout << "Integrated conservation error:" << endl;
     writeError(Solver,params);
+    finishMonitors();
 
     params->errorNorm = 1;
     if (params->rank == 0)
       cout << "Integral L1 error:" << endl;
     writeError(Solver,params);
+    finishMonitors();
 
     params->errorNorm = 2;
     if (params->rank == 0)
       cout << "Integral L2 error:" << endl;
     writeError(Solver,params);
+    finishMonitors();
   }
   else if (params->testCase == 2) {
     /* Calculate mass-flux error (integrate inlet/outlet boudnary fluxes) */
@@ -745,6 +1181,7 @@ void writeAllError(solver *Solver, input *params)
     if (params->rank == 0)
       cout << "Net Mass Flux Through Domain:" << endl;
     writeError(Solver,params);
+    finishMonitors();
   }
   else if (params->testCase == 3) {
     /* Calculate total amount of conserved quantities in domain */
@@ -752,82 +1189,65 @@ void writeAllError(solver *Solver, input *params)
     if (params->rank == 0)
       cout << "Integrated conservative variables:" << endl;
     writeError(Solver,params);
+    finishMonitors();
   }
 }
 
 void writeError(solver *Solver, input *params)
 {
+  PROFILE("writeError");
+
+  Solver->syncHost();
+
   if (params->testCase == 0) return;
 
-  // For implemented test cases, calculcate the L1/L2 error over the overset domain
-  vector<double> err;
+  if (waitMonitor(pendingErr)) printError(pendingErr);
+
+  auto &m = pendingErr;
+  stampMonitor(m,params);
+  m.takeSqrt = false;
 
+  // For implemented test cases, calculcate the L1/L2 error over the overset domain
   if (params->testCase == 1)
   {
     /* --- Standard error calculation wrt analytical solution --- */
 
-    if (params->meshType == OVERSET_MESH)
-      err = Solver->integrateErrorOverset();
-    else
-      err = Solver->integrateError();
+    if (params->meshType == OVERSET_MESH) {
+      m.global = Solver->integrateErrorOverset();
+    }
+    else {
+      m.local = Solver->integrateErrorLocal();
+      m.takeSqrt = (params->errorNorm == 2);
+
+#ifndef _NO_MPI
+      if (params->nproc > 1) {
+        // Post the sum over ranks; it is completed at the next output stage
+        m.global.resize(m.local.size());
+        MPI_Iallreduce(m.local.data(), m.global.data(), m.local.size(), MPI_DOUBLE, MPI_SUM, Solver->Geo->gridComm, &m.reqs[0]);
+        m.reqs[1] = MPI_REQUEST_NULL;
+        m.active = true;
+        return;
+      }
+#endif
+
+      m.global = m.local;
+    }
   }
   else if (params->testCase == 2)
   {
     /* --- Internal-Flow Test Cases: Calculate Net Mass-Flux Error --- */
 
-    err = Solver->computeMassFlux();
+    m.global = Solver->computeMassFlux();
   }
-
-  if (params->rank == 0)
+  else
   {
-    /* --- Write the error out to the terminal --- */
-
-    int colw = 16;
-    cout.precision(6);
-    cout.setf(ios::scientific, ios::floatfield);
-
-    cout << setw(8) << left << params->iter << "Err  ";
-    for (int i=0; i<err.size(); i++)
-      cout << setw(colw) << left << std::abs(err[i]);
-    cout << endl;
-
-    /* --- Write the error out to the history file --- */
-
-    ofstream errFile;
-    string fileName = params->dataFileName + ".err";
-    errFile.open(fileName.c_str(),ofstream::app);
-
-    errFile.precision(5);
-    errFile.setf(ios::scientific, ios::floatfield);
-
-    if (params->iter==params->initIter+1) {
-      errFile << setw(8) << left << "Iter";
-      errFile << setw(colw) << left << "Flow Time";
-      errFile << setw(colw) << left << "Wall Time";
-      if (params->equation == ADVECTION_DIFFUSION) {
-        errFile << setw(colw) << left << "Error" << endl;
-      } else if (params->equation == NAVIER_STOKES) {
-        errFile << setw(colw) << left << "rho";
-        errFile << setw(colw) << left << "rhoU";
-        errFile << setw(colw) << left << "rhoV";
-        if (params->nDims == 3)
-          errFile << setw(colw) << left << "rhoW";
-        errFile << setw(colw) << left << "rhoE";
-      }
-      errFile << endl;
-    }
-
-    errFile << setw(8) << left << params->iter;
-    errFile << setw(colw) << left << params->time;
-    errFile << setw(colw) << left << params->timer.getElapsedTime();
-    for (int i=0; i<params->nFields; i++) {
-      errFile << setw(colw) << left << std::abs(err[i]);
-    }
-    errFile << endl;
-    errFile.close();
+    m.global.clear();
   }
+
+  printError(m);
 }
 
+
 void writeMeshTecplot(geo *Geo, input* params)
 {
   ofstream dataFile;
@@ -61,6 +61,22 @@ overComm::overComm()
 
 }
 
+void overComm::addMemUsage(memTally &mem)
+{
+  size_t bytes = memBytes(gridIdList, foundPts, foundRank, foundEles, foundLocs, foundNorm, overPts, overNorm)
+      + memBytes(nPtsRecv, nPtsSend, recvPts, U_in, U_out, gradU_in, gradU_out, U_in0, U_in1, gradU_in0, gradU_in1)
+      + memBytes(nCells_rank, foundCells, foundCellDonors, foundCellNDonors, ubCells, nCellsRecv, nCellsSend, recvCells)
+      + memBytes(nQptsSend, nQptsRecv, qpts, qptsD_ref, donorBasis, massMatTDRow, ubLHS, targetID, donorID, recvInds, eleList);
+
+  for (auto &mat:interpMat)
+    bytes += memBytes(mat.rowPtr, mat.weights, mat.gradTransform);
+
+  for (auto &sm:donors)
+    bytes += sm.getMemUsage();
+
+  mem.add("overComm", bytes);
+}
+
 void overComm::setup(input* _params, int _nGrids, int _gridID, int _gridRank, int _nprocPerGrid, vector<int>& _gridIdList)
 {
   params = _params;
@@ -259,17 +275,55 @@ void overComm::transferEleData(vector<shared_ptr<ele>> &eles, const unordered_se
 void overComm::matchOversetPoints(vector<shared_ptr<ele>> &eles, const vector<int> &eleMap, const point &minPt, const point &maxPt)
 {
 #ifndef _NO_MPI
-  /* ---- Gather all interpolation point data on each grid ---- */
+  PROFILE("matchOversetPoints");
+
+  /* ---- Send each fringe point only to the ranks of other grids whose
+   *      bounding box contains it ---- */
 
   nOverPts = overPts.getDim0();
+  int nDims = params->nDims;
+  double tol = 1e-6;
 
-  vector<double> interpPtsPhys;
+  vector<double> rankBox(6*nproc);
+  double myBox[6] = {minPt.x,minPt.y,minPt.z,maxPt.x,maxPt.y,maxPt.z};
+  MPI_Allgather(myBox, 6, MPI_DOUBLE, rankBox.data(), 6, MPI_DOUBLE, MPI_COMM_WORLD);
 
-  gatherData(nOverPts, 3, overPts.getData(), nPts_rank, interpPtsPhys);
+  // Normals are sent along with the points for the corrected-flux method
+  int stride = (params->oversetMethod==1) ? 6 : 3;
 
-  vector<double> interpNorms;
-  if (params->oversetMethod==1)
-    gatherData(nOverPts, 3, overNorm.getData(), nPts_rank, interpNorms);
+  vector<vector<int>> sendPts(nproc);
+  for (int i=0; i<nOverPts; i++) {
+    for (int p=0; p<nproc; p++) {
+      if (gridIdList[p] == gridID) continue;
+
+      bool inBox = true;
+      for (int d=0; d<nDims; d++)
+        inBox = inBox && overPts(i,d) >= rankBox[6*p+d]-tol && overPts(i,d) <= rankBox[6*p+3+d]+tol;
+
+      if (inBox) sendPts[p].push_back(i);
+    }
+  }
+
+  vector<int> nSend(nproc,0), nRecv;
+  vector<matrix<double>> sendVals(nproc);
+  for (int p=0; p<nproc; p++) {
+    nSend[p] = sendPts[p].size();
+    sendVals[p].setup(nSend[p],stride);
+    for (int j=0; j<nSend[p]; j++) {
+      for (int d=0; d<3; d++) {
+        sendVals[p](j,d) = overPts(sendPts[p][j],d);
+        if (stride == 6)
+          sendVals[p](j,3+d) = overNorm(sendPts[p][j],d);
+      }
+    }
+  }
+
+  setupNPieces(nSend,nRecv);
+
+  // recvPtIDs[p]: index of each received point within rank p's overPts
+  vector<vector<int>> recvPtIDs;
+  vector<matrix<double>> recvVals;
+  sendRecvData(nSend,nRecv,sendPts,recvPtIDs,sendVals,recvVals,stride);
 
   /* ---- Check Every Fringe Point for Donor Cell on This Grid ---- */
 
@@ -281,16 +335,21 @@ void overComm::matchOversetPoints(vector<shared_ptr<ele>> &eles, const vector<in
     }
   }
 
+  // For moving grids, keep each point's donor from the previous match as a
+  // starting guess: [point ID on rank p] -> {donor cell, reference location}
+  vector<unordered_map<int,pair<int,point>>> prevDonor(nproc);
+  if (params->donorCache && params->motion) {
+    for (int p=0; p<foundPts.size(); p++)
+      for (int k=0; k<foundPts[p].size(); k++)
+        prevDonor[p][foundPts[p][k]] = {foundEles[p][k],foundLocs[p][k]};
+  }
+
   foundPts.resize(nproc);
   foundEles.resize(nproc);
   foundLocs.resize(nproc);
   if (params->oversetMethod==1)
     foundNorm.resize(nproc);
-  int offset = 0;
-  double tol = 1e-6;
   for (int p=0; p<nproc; p++) {
-    if (p>0) offset += nPts_rank[p-1];
-
     if (gridIdList[p] == gridID) continue;
 
     foundPts[p].resize(0);
@@ -298,55 +357,68 @@ void overComm::matchOversetPoints(vector<shared_ptr<ele>> &eles, const vector<in
     foundLocs[p].resize(0);
     if (params->oversetMethod==1)
       foundNorm[p].resize(0);
-    for (int i=0; i<nPts_rank[p]; i++) {
+
+    /* Search for the donors of all points received from rank p at once: the
+     * searches are independent, so they run in parallel, and the matches are
+     * then collected in the order received [as by a serial search] */
+    vector<int> donor(nRecv[p],-1);  // -2: donor found by TIOGA, but point not located in it
+    vector<point> refLoc(nRecv[p]);
+
+#pragma omp parallel for schedule(dynamic,16)
+    for (int j=0; j<nRecv[p]; j++) {
       // Get requested interpolation point
-      point pt = point(&interpPtsPhys[3*(offset+i)]);
+      int i = recvPtIDs[p][j];
+      point pt = point(&recvVals[p](j,0));
 
-      if (params->nDims == 2) {
-        // First, check that point even lies within bounding box of grid
-        if ( (pt.x<minPt.x-tol) || (pt.y<minPt.y-tol) ||
-             (pt.x>maxPt.x+tol) || (pt.y>maxPt.y+tol) )
-          continue;
+      // Points move only a fraction of a cell per step: first retry the
+      // previous donor & its neighbors before doing a full search
+      auto prev = prevDonor[p].find(i);
+      if (prev != prevDonor[p].end())
+        donor[j] = checkNearDonor(eles,eleMap,pt,prev->second.first,prev->second.second,refLoc[j]);
 
+      if (donor[j] >= 0) continue;
+
+      if (params->nDims == 2) {
         // Use ADT to find all cells whose bounding box contains the point
         unordered_set<int> cellIDs;
         vector<double> targetBox = {pt.x,pt.y,pt.x,pt.y};
         adt->searchADT_box(eleList.data(),cellIDs,targetBox.data());
         for (auto &ic:cellIDs) {
           if (eleMap[ic]<0) continue;
-          point refLoc;
-          bool isInEle = eles[eleMap[ic]]->getRefLocNewton(pt,refLoc);
+          bool isInEle = eles[eleMap[ic]]->getRefLocNewton(pt,refLoc[j]);
 
           if (isInEle) {
-            foundPts[p].push_back(i);
-            foundEles[p].push_back(ic); // Local ele id for this grid
-            foundLocs[p].push_back(refLoc);
-            if (params->oversetMethod==1)
-              foundNorm[p].push_back(point(&interpNorms[3*(offset+i)]));
+            donor[j] = ic;
             break;
           }
         }
       }
       else {
-        int ic = tg->findPointDonor(&interpPtsPhys[3*(offset+i)]);
+        int ic = tg->findPointDonor(&recvVals[p](j,0));
         if (ic>=0 && eleMap[ic]>=0) {
           int ie = eleMap[ic];
-          point refLoc;
-          bool isInEle = eles[ie]->getRefLocNelderMead(pt,refLoc);
+          bool isInEle = eles[ie]->getRefLocNelderMead(pt,refLoc[j]);
 
-          if (!isInEle) FatalError("Unable to match fringe point!");
-
-          foundPts[p].push_back(i);
-          foundEles[p].push_back(ic); // Local ele id for this grid
-          foundLocs[p].push_back(refLoc);
-          if (params->oversetMethod==1)
-            foundNorm[p].push_back(point(&interpNorms[3*(offset+i)]));
+          donor[j] = (isInEle) ? ic : -2;
         }
       }
+    }
 
+    for (int j=0; j<nRecv[p]; j++) {
+      if (donor[j] == -2) FatalError("Unable to match fringe point!");
+
+      if (donor[j] >= 0) {
+        foundPts[p].push_back(recvPtIDs[p][j]);
+        foundEles[p].push_back(donor[j]); // Local ele id for this grid
+        foundLocs[p].push_back(refLoc[j]);
+        if (params->oversetMethod==1)
+          foundNorm[p].push_back(point(&recvVals[p](j,3)));
+      }
     }
   }
 
+  newDonors = true;
+
   /* ---- Prepare for Data Communication ---- */
 
   // Get the number of matched points for each grid
@@ -359,6 +431,24 @@ void overComm::matchOversetPoints(vector<shared_ptr<ele>> &eles, const vector<in
 }
 
 
+int overComm::checkNearDonor(vector<shared_ptr<ele>> &eles, const vector<int> &eleMap, const point &pt, int ic0, const point &loc0, point &refLoc)
+{
+  if (eleMap[ic0]>=0 && eles[eleMap[ic0]]->getRefLocNewton(pt,refLoc,loc0))
+    return ic0;
+
+  if (c2c == NULL) return -1;
+
+  for (int j=0; j<c2c->getDim1(); j++) {
+    int ic = (*c2c)(ic0,j);
+    if (ic<0 || eleMap[ic]<0) continue;
+
+    if (eles[eleMap[ic]]->getRefLocNewton(pt,refLoc))
+      return ic;
+  }
+
+  return -1;
+}
+
 void overComm::matchUnblankCells(vector<shared_ptr<ele>> &eles, unordered_set<int>& unblankCells, vector<int> &eleMap, int quadOrder)
 {
 #ifndef _NO_MPI
@@ -414,7 +504,11 @@ void overComm::matchUnblankCells(vector<shared_ptr<ele>> &eles, unordered_set<in
   foundCells.resize(nproc);
   foundCellDonors.resize(nproc);
   foundCellNDonors.resize(nproc);
-  donors.resize(0);
+
+  // Target & donor nodes of each supermesh to be built
+  vector<vector<point>> meshTargets;
+  vector<Array2D<point>> meshDonors;
+
   int offset = 0;
   for (int p=0; p<nproc; p++) {
     if (p>0) offset += nCells_rank[p-1];
@@ -470,18 +564,59 @@ void overComm::matchUnblankCells(vector<shared_ptr<ele>> &eles, unordered_set<in
             donorPts.insertRow(eles[eleMap[ic]]->nodes);
         }
 
-        superMesh mesh(targetNodes,donorPts,quadOrder,nDims,rank,donors.size());
-        donors.push_back(mesh);
+        meshTargets.push_back(targetNodes);
+        meshDonors.push_back(donorPts);
       }
     }
   }
 
-  /* --- Setup & Exchange Quadrature-Point Data --- */
+  /* --- Build the local supermesh for each target cell --- */
+
+  // On moving grids, reuse the previous supermesh of any target/donor set
+  // whose nodes haven't moved [e.g. pairs of cells from two static grids]
+  int nMeshes = meshTargets.size();
+  vector<superMesh> oldMeshes;
+  oldMeshes.swap(donors);
+  donors.resize(nMeshes);
+
+  unordered_multimap<size_t,int> oldMeshIDs;
+  if (params->motion) {
+    for (int i=0; i<oldMeshes.size(); i++)
+      oldMeshIDs.insert({hashSuperMeshInputs(oldMeshes[i].target,oldMeshes[i].donors),i});
+  }
+
+  vector<bool> reused(oldMeshes.size(),false);
+  vector<int> newMeshes;
+  for (int m=0; m<nMeshes; m++) {
+    bool found = false;
+    if (!oldMeshIDs.empty()) {
+      auto range = oldMeshIDs.equal_range(hashSuperMeshInputs(meshTargets[m],meshDonors[m]));
+      for (auto it=range.first; it!=range.second; it++) {
+        int i = it->second;
+        if (!reused[i] && oldMeshes[i].hasInputs(meshTargets[m],meshDonors[m])) {
+          donors[m] = std::move(oldMeshes[i]);
+          donors[m].ID = m;
+          reused[i] = true;
+          found = true;
+          break;
+        }
+      }
+    }
+
+    if (!found)
+      newMeshes.push_back(m);
+  }
 
   // Now that we have the local superMesh for each target, setup points for
   // use with Galerkin projection
-  for (auto &mesh:donors)
-    mesh.setupQuadrature();
+#pragma omp parallel for schedule(dynamic)
+  for (int n=0; n<newMeshes.size(); n++) {
+    int m = newMeshes[n];
+    donors[m].rank = rank;
+    donors[m].ID = m;
+    donors[m].setup(meshTargets[m],meshDonors[m],quadOrder,nDims);
+    donors[m].setupQuadrature();
+  }
 #endif
 }
 
@@ -831,6 +966,8 @@ vector<double> overComm::integrateErrOverset(vector<shared_ptr<ele>> &eles, map<
   vector<matrix<int>> foundCellDonors(nproc);
   vector<vector<int>> foundCellNDonors(nproc);
   vector<superMesh> supers(0);
+  vector<vector<point>> meshTargets;
+  vector<Array2D<point>> meshDonors;
   int offset = 0;
   for (int p=0; p<nproc; p++) {
     if (p>0) offset += nCells_rank[p-1];
@@ -893,18 +1030,24 @@ vector<double> overComm::integrateErrOverset(vector<shared_ptr<ele>> &eles, map<
           for (auto &ic:donorsIDs)
             donorPts.insertRow(eles[eleMap[ic]]->nodes);
 
-        superMesh mesh(targetNodes,donorPts,quadOrder,nDims,rank,supers.size());
-        supers.push_back(mesh);
+        meshTargets.push_back(targetNodes);
+        meshDonors.push_back(donorPts);
       }
     }
   }
 
   /* --- Setup & Exchange Quadrature-Point Data --- */
 
-  // Now that we have the local superMesh for each target, setup points for
-  // use with numerical quadrature
-  for (auto &mesh:supers)
-    mesh.setupQuadrature();
+  // Build the local superMesh for each target, and setup points for use with
+  // numerical quadrature
+  supers.resize(meshTargets.size());
+#pragma omp parallel for schedule(dynamic)
+  for (int m=0; m<supers.size(); m++) {
+    supers[m].rank = rank;
+    supers[m].ID = m;
+    supers[m].setup(meshTargets[m],meshDonors[m],quadOrder,nDims);
+    supers[m].setupQuadrature();
+  }
 
   // Get the locations of the quadrature points for each target cell, and
   // interpolate the solution error to them
@@ -991,6 +1134,9 @@ vector<double> overComm::integrateErrOverset(vector<shared_ptr<ele>> &eles, map<
 void overComm::exchangeOversetData(vector<shared_ptr<ele>> &eles, map<int, map<int,oper> > &opers, vector<int> &eleMap)
 {
 #ifndef _NO_MPI
+  if (newDonors)
+    setupInterpolation(eles,opers,eleMap);
+
   U_out.resize(nproc);
   unordered_set<int> correctedEles;
   for (int p=0; p<nproc; p++) {
@@ -998,6 +1144,7 @@ void overComm::exchangeOversetData(vector<shared_ptr<ele>> &eles, map<int, map<i
       U_out[p].setup(foundPts[p].size(),2*nFields);
     else
       U_out[p].setup(foundPts[p].size(),nFields);
+    U_out[p].initializeToZero();
 
     if (gridIdList[p] == gridID) continue;
     for (int i=0; i<foundPts[p].size(); i++) {
@@ -1027,12 +1174,13 @@ void overComm::exchangeOversetData(vector<shared_ptr<ele>> &eles, map<int, map<i
         vector<matrix<double>> tempF_spts;
         if (params->motion) {
           // Flux vector must be in ref. space in order to apply correction functions
-          tempF_spts = eles[ic]->transformFlux_physToRef();
+          eles[ic]->transformFlux_physToRef(tempF_spts);
         } else {
           tempF_spts = eles[ic]->F_spts;
         }
 
-        matrix<double> tempF_ref = opers[eles[ic]->eType][eles[ic]->order].interpolateCorrectedFlux(tempF_spts, eles[ic]->dFn_fpts, refPos);
+        matrix<double> tempF_ref;
+        opers[eles[ic]->eType][eles[ic]->order].interpolateCorrectedFlux(tempF_spts, eles[ic]->dFn_fpts, refPos, tempF_ref);
 
         vector<double> tempU(nFields);
         opers[eles[ic]->eType][eles[ic]->order].interpolateToPoint(eles[ic]->U_spts, tempU.data(), refPos);
@@ -1085,37 +1233,24 @@ void overComm::exchangeOversetData(vector<shared_ptr<ele>> &eles, map<int, map<i
 
       else {
         // Interpolate discontinuous solution [Original 'Artificial Boundary' Method]
-        opers[eles[ic]->eType][eles[ic]->order].interpolateToPoint(eles[ic]->U_spts, U_out[p][i], refPos);
+        auto &M = interpMat[p];
+        auto &U = eles[ic]->U_spts;
+        for (int j=M.rowPtr[i]; j<M.rowPtr[i+1]; j++) {
+          int spt = j - M.rowPtr[i];
+          for (int k=0; k<nFields; k++)
+            U_out[p](i,k) += M.weights[j]*U(spt,k);
+        }
       }
 
     }
   }
 
   /* ---- Send/Receive the the interpolated data across grids using interComm ---- */
-  nPtsSend.resize(nproc);
-  for (int p=0; p<nproc; p++) {
-    if (gridIdList[p] == gridID) continue;
-    nPtsSend[p] = foundPts[p].size();
-  }
-
-  setupNPieces(nPtsSend,nPtsRecv);
-
-  if (nOverPts > getSum(nPtsRecv)) {
-    cout << "rank " << params->rank << ", # Unmatched Points = " << nOverPts - getSum(nPtsRecv) << " out of " << nOverPts << endl;
-    FatalError("Unmatched points remaining!");
-  }
-
-  recvPts.resize(nproc);
-  for (int p=0; p<nproc; p++) {
-    if (p==rank) continue;
-    recvPts[p].resize(nPtsRecv[p]);
-  }
-
   // For flux-interp method, send both solution and normal flux
   int nVars = nFields;
   if (params->oversetMethod == 1) nVars *= 2;
 
-  sendRecvData(nPtsSend,nPtsRecv,foundPts,recvPts,U_out,U_in,nVars,true);
+  sendInterpolatedData(U_out,U_in,nVars);
 #endif
 }
 
@@ -1123,14 +1258,19 @@ void overComm::exchangeOversetGradient(vector<shared_ptr<ele>> &eles, map<int, m
 {
 #ifndef _NO_MPI
   int nDims = params->nDims;
+
+  if (newDonors)
+    setupInterpolation(eles,opers,eleMap);
+
   gradU_out.resize(nproc);
 
   for (int p=0; p<nproc; p++) {
     gradU_out[p].setup(foundPts[p].size(),nDims*nFields);
+    gradU_out[p].initializeToZero();
     if (gridIdList[p] == gridID) continue;
 
+    auto &M = interpMat[p];
     for (int i=0; i<foundPts[p].size(); i++) {
-      point refPos = foundLocs[p][i];
       int ic = eleMap[foundEles[p][i]];
 
       if (ic<0 || ic>eles.size())
@@ -1140,55 +1280,158 @@ void overComm::exchangeOversetGradient(vector<shared_ptr<ele>> &eles, map<int, m
       // Need to also keep track of whether gradient is in ref/phys space and
       //   transform as required.
       vector<matrix<double>> tempDU_spts;
-      uint nSpts = eles[ic]->nSpts;
-      uint nFpts = eles[ic]->nFpts;
       if (params->motion) {
         // Gradient vector must be in ref. space in order to apply correction functions
-        tempDU_spts = eles[ic]->transformGradU_physToRef();
+        eles[ic]->transformGradU_physToRef(tempDU_spts);
       } else {
         tempDU_spts = eles[ic]->dU_spts;
       }
 
       matrix<double> tempDU_ref(nDims,nFields);
-      for (int dim=0; dim<nDims; dim++)
-        opers[eles[ic]->eType][eles[ic]->order].interpolateToPoint(tempDU_spts[dim], tempDU_ref[dim], refPos);
+      tempDU_ref.initializeToZero();
+      for (int j=M.rowPtr[i]; j<M.rowPtr[i+1]; j++) {
+        int spt = j - M.rowPtr[i];
+        for (int dim=0; dim<nDims; dim++)
+          for (int k=0; k<nFields; k++)
+            tempDU_ref(dim,k) += M.weights[j]*tempDU_spts[dim](spt,k);
+      }
 
       // NOW we can transform flux vector back to physical space
       // [Recall: F_phys = JGinv .dot. F_ref]
-      matrix<double> jacobian, invJaco;
-      double detJac;
-      eles[ic]->calcTransforms_point(jacobian,invJaco,detJac,refPos);
+      if (params->motion) {
+        matrix<double> jacobian, invJaco;
+        double detJac;
+        eles[ic]->calcTransforms_point(jacobian,invJaco,detJac,foundLocs[p][i]);
 
-      for (int dim1=0; dim1<nDims; dim1++)
-        for (int dim2=0; dim2<nDims; dim2++)
-          for (int k=0; k<nFields; k++)
-            gradU_out[p](i,dim1*nFields+k) += invJaco(dim2,dim1) * tempDU_ref(dim2,k) / detJac;
+        for (int dim1=0; dim1<nDims; dim1++)
+          for (int dim2=0; dim2<nDims; dim2++)
+            for (int k=0; k<nFields; k++)
+              gradU_out[p](i,dim1*nFields+k) += invJaco(dim2,dim1) * tempDU_ref(dim2,k) / detJac;
+      } else {
+        double *T = &M.gradTransform[nDims*nDims*i];
+        for (int dim1=0; dim1<nDims; dim1++)
+          for (int dim2=0; dim2<nDims; dim2++)
+            for (int k=0; k<nFields; k++)
+              gradU_out[p](i,dim1*nFields+k) += T[dim1*nDims+dim2] * tempDU_ref(dim2,k);
+      }
     }
   }
 
   /* ---- Send/Receive the the interpolated data across grids using interComm ---- */
-  nPtsSend.resize(nproc);
-  for (int p=0; p<nproc; p++) {
-    if (gridIdList[p] == gridID) continue;
-    nPtsSend[p] = foundPts[p].size();
-  }
 
-  setupNPieces(nPtsSend,nPtsRecv);
+  sendInterpolatedData(gradU_out,gradU_in,nDims*nFields);
+#endif
+}
+
+void overComm::storeFringeData(double t, bool grad)
+{
+  auto &in = (grad) ? gradU_in : U_in;
+  auto &in0 = (grad) ? gradU_in0 : U_in0;
+  auto &in1 = (grad) ? gradU_in1 : U_in1;
+
+  in0 = in1;
+  tIn0[grad] = tIn1[grad];
+  in1 = in;
+  tIn1[grad] = t;
+  nStored[grad]++;
+}
 
-  if (nOverPts > getSum(nPtsRecv)) {
-    cout << "rank " << params->rank << ", # Unmatched Points = " << nOverPts - getSum(nPtsRecv) << " out of " << nOverPts << endl;
-    FatalError("Unmatched points remaining!");
-  }
+void overComm::extrapolateFringeData(double t, bool grad)
+{
+  auto &in = (grad) ? gradU_in : U_in;
+  auto &in0 = (grad) ? gradU_in0 : U_in0;
+  auto &in1 = (grad) ? gradU_in1 : U_in1;
+
+  in = in1;
+  if (nStored[grad] < 2 || in0.getSize() != in1.getSize() || tIn1[grad] <= tIn0[grad])
+    return;
+
+  double fac = (t - tIn1[grad]) / (tIn1[grad] - tIn0[grad]);
+  double *U = in.getData();
+  const double *U0 = in0.getData();
+  const double *U1 = in1.getData();
+  for (uint i=0; i<in.getSize(); i++)
+    U[i] = U1[i] + fac*(U1[i] - U0[i]);
+}
+
+#ifndef _NO_MPI
+void overComm::setupInterpolation(vector<shared_ptr<ele>> &eles, map<int,map<int,oper>> &opers, vector<int> &eleMap)
+{
+  int nDims = params->nDims;
 
-  recvPts.resize(nproc);
+  interpMat.resize(nproc);
   for (int p=0; p<nproc; p++) {
-    if (p==rank) continue;
-    recvPts[p].resize(nPtsRecv[p]);
-  }
+    auto &M = interpMat[p];
+    int nRows = (gridIdList[p] == gridID) ? 0 : foundPts[p].size();
+
+    M.rowPtr.assign(nRows+1,0);
+    M.weights.resize(0);
+    M.gradTransform.resize(0);
+    if (!params->motion)
+      M.gradTransform.resize(nDims*nDims*nRows);
+
+    for (int i=0; i<nRows; i++) {
+      int ic = eleMap[foundEles[p][i]];
+      if (ic<0 || ic>eles.size())
+        FatalError("bad value of ic!");
 
-  sendRecvData(nPtsSend,nPtsRecv,foundPts,recvPts,gradU_out,gradU_in,nDims*nFields,true);
+      vector<double> wts;
+      opers[eles[ic]->eType][eles[ic]->order].getBasisValues(foundLocs[p][i],wts);
+      M.weights.insert(M.weights.end(),wts.begin(),wts.end());
+      M.rowPtr[i+1] = M.weights.size();
+
+      if (!params->motion) {
+        matrix<double> jacobian, invJaco;
+        double detJac;
+        eles[ic]->calcTransforms_point(jacobian,invJaco,detJac,foundLocs[p][i]);
+
+        for (int dim1=0; dim1<nDims; dim1++)
+          for (int dim2=0; dim2<nDims; dim2++)
+            M.gradTransform[nDims*nDims*i+dim1*nDims+dim2] = invJaco(dim2,dim1) / detJac;
+      }
+    }
+  }
+}
+#else
+void overComm::setupInterpolation(vector<shared_ptr<ele>> &/*eles*/, map<int,map<int,oper>> &/*opers*/, vector<int> &/*eleMap*/) {}
 #endif
+
+#ifndef _NO_MPI
+void overComm::sendInterpolatedData(vector<matrix<double>> &sendVals, matrix<double> &recvVals, int nVars)
+{
+  if (newDonors) {
+    // Exchange the point counts & IDs once for each new set of donors
+    nPtsSend.resize(nproc);
+    for (int p=0; p<nproc; p++) {
+      if (gridIdList[p] == gridID) continue;
+      nPtsSend[p] = foundPts[p].size();
+    }
+
+    setupNPieces(nPtsSend,nPtsRecv);
+
+    if (nOverPts > getSum(nPtsRecv)) {
+      cout << "rank " << params->rank << ", # Unmatched Points = " << nOverPts - getSum(nPtsRecv) << " out of " << nOverPts << endl;
+      FatalError("Unmatched points remaining!");
+    }
+
+    recvPts.resize(nproc);
+    for (int p=0; p<nproc; p++) {
+      if (p==rank) continue;
+      recvPts[p].resize(nPtsRecv[p]);
+    }
+
+    sendRecvData(nPtsSend,nPtsRecv,foundPts,recvPts,sendVals,recvVals,nVars,true);
+
+    newDonors = false;
+  }
+  else {
+    // Same points as last time; only the values need to be sent
+    sendRecvData(nPtsSend,nPtsRecv,foundPts,recvPts,sendVals,recvVals,nVars,false);
+  }
 }
+#else
+void overComm::sendInterpolatedData(vector<matrix<double>> &/*sendVals*/, matrix<double> &/*recvVals*/, int /*nVars*/) {}
+#endif
 
 template<typename T>
 void overComm::gatherData(int nPieces, int stride, T *values, vector<int>& nPieces_rank, vector<T> &values_all)
@@ -1242,7 +1485,7 @@ void overComm::setupNPieces(vector<int> &nPiecesIn, vector<int> &nPiecesOut)
 
 template<typename T>
 void overComm::sendRecvData(vector<int> &nPiecesSend, vector<int> &nPiecesRecv, vector<vector<int>> &sendInds, vector<vector<int>> &recvInds,
-                            vector<matrix<T>> &sendVals, matrix<T> &recvVals, int stride, bool matchInds=false)
+                            vector<matrix<T>> &sendVals, matrix<T> &recvVals, int stride, bool matchInds)
 {
   // Do basic send/receive, keeping receive values in destination arrays from each rank
   vector<matrix<T>> tmpRecvVals;
@@ -81,18 +81,14 @@ void overFace::setRightStateSolution(void)
 
 }
 
-vector<double> overFace::computeWallForce()
+void overFace::computeWallForce(double*)
 {
-  // Not a wall boundary - return 0
-  vector<double> force = {0,0,0,0,0,0};
-  return force;
+  // Not a wall boundary - no contribution
 }
 
-vector<double> overFace::computeMassFlux()
+void overFace::computeMassFlux(double*)
 {
-  // Not an inlet/outlet boundary - return 0
-  vector<double> force(nFields);
-  return force;
+  // Not an inlet/outlet boundary - no contribution
 }
 
 vector<point> overFace::getPosFpts()
@@ -190,3 +186,9 @@ void overFace::rusanovFlux(void)
     face::rusanovFlux();
   }
 }
+
+void overFace::addMemUsage(memTally &mem)
+{
+  face::addMemUsage(mem);
+  mem.add("faces", memBytes(posFpts));
+}
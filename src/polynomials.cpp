@@ -35,6 +35,38 @@
 
 using namespace std;
 
+void lagrangeBasis1D::setup(const vector<double> &x_lag)
+{
+  x = x_lag;
+  w.assign(x.size(),1.);
+  for (uint j=0; j<x.size(); j++) {
+    for (uint k=0; k<x.size(); k++)
+      if (k != j) w[j] *= x[j]-x[k];
+    w[j] = 1./w[j];
+  }
+}
+
+void lagrangeBasis1D::eval(double y, double* l) const
+{
+  uint n = x.size();
+
+  double sum = 0;
+  for (uint j=0; j<n; j++) {
+    double dy = y - x[j];
+    if (dy == 0) {
+      // Exactly at a point
+      for (uint k=0; k<n; k++) l[k] = 0;
+      l[j] = 1;
+      return;
+    }
+    l[j] = w[j]/dy;
+    sum += l[j];
+  }
+
+  for (uint j=0; j<n; j++)
+    l[j] /= sum;
+}
+
 
 double Lagrange(vector<double> &x_lag, double y, uint mode)
 {
@@ -29,9 +29,19 @@
 
 #include "solver.hpp"
 
+#include <climits>
+#include <cstddef>
+#include <cstring>
 #include <sstream>
+#include <unordered_map>
 #include <omp.h>
 
+// Memory-mapped reading of binary restart files
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 class intFace;
 class boundFace;
 
@@ -39,6 +49,9 @@ class boundFace;
 #include "geo.hpp"
 #include "intFace.hpp"
 #include "boundFace.hpp"
+#include "newtonKrylov.hpp"
+#include "output.hpp"
+#include "deviceBackend.hpp"
 
 solver::solver()
 {
@@ -69,6 +82,54 @@ void solver::setup(input *params, int order, geo *_Geo)
   params->time = 0.;
   this->order = order;
 
+  setupFromGeo();
+}
+
+void solver::shareOperators(solver &lead)
+{
+  opers = lead.opers;
+  eTypes = lead.eTypes;
+  polyOrders = lead.polyOrders;
+}
+
+void solver::addMemUsage(memTally &mem)
+{
+  for (auto &e:eles)
+    e->addMemUsage(mem);
+
+  for (auto &etype:eleBlocks)
+    for (auto &block:etype.second)
+      block.second.addMemUsage(mem);
+
+  for (auto &etype:opers)
+    for (auto &op:etype.second)
+      op.second.addMemUsage(mem);
+
+  for (auto &F:faces) F->addMemUsage(mem);
+  for (auto &F:mpiFaces) F->addMemUsage(mem);
+  for (auto &F:overFaces) F->addMemUsage(mem);
+
+  for (auto &block:faceBlocks)
+    block.second.addMemUsage(mem);
+
+  mpiFaceComm.addMemUsage(mem);
+
+  if (OComm) OComm->addMemUsage(mem);
+
+  size_t donorBytes = memBytes(U_spts, sptStart, iblankVert, iblankEle);
+  for (auto &sm:donors)
+    donorBytes += sm.getMemUsage();
+  if (donorBytes > 0)
+    mem.add("overComm", donorBytes);
+
+  if (NK) NK->addMemUsage(mem);
+
+  mem.add("solver: other", memBytes(eles, faces, mpiFaces, overFaces, eleNbrs, resMean, resSmooth, resTmp)
+          + memBytes(r_adapt_cells, h_adapt_cells, p_adapt_cells, troubledEles, isListed, troubled, filterU));
+}
+
+void solver::setupFromGeo(void)
+{
   /* Setup the FR elements & faces which will be computed on */
   Geo->setupElesFaces(params,eles,faces,mpiFaces,overFaces);
 
@@ -85,6 +146,10 @@ void solver::setup(input *params, int order, geo *_Geo)
   /* Setup the FR operators for computation */
   setupOperators();
 
+  if (params->viscous && params->viscScheme == 1)
+    for (auto &e:eles)
+      e->lift_fpts = opers[e->eType][e->order].get_lift_fpts();
+
   /* Additional Setup */
 
   // Time advancement setup
@@ -93,18 +158,71 @@ void solver::setup(input *params, int order, geo *_Geo)
 #ifndef _NO_MPI
   finishMpiSetup();
 #endif
+
+  if (params->faceBatching && faceBlock::canBatch(params))
+    setupFaceBlocks();
+
+  if (params->resSmoothing > 0)
+    setupResidualSmoothing();
+
+  if (params->implicitTime) {
+    NK = make_shared<newtonKrylov>();
+    NK->setup(params,this);
+  }
 }
 
 void solver::update(bool PMG_Source)
 {
   params->iter++;
 
+#ifdef _GPU
+  if (params->gpu) {
+    device->update();
+    return;
+  }
+#endif
+
+  if (params->multirate) {
+    updateMultirate(PMG_Source);
+    return;
+  }
+
   /* Intermediate residuals for Runge-Kutta time integration */
 
   if (params->dtType != 0) calcDt();
 
+  if (params->implicitTime) {
+    NK->timeStep();
+    params->time += params->dt;
+    return;
+  }
+
+  if (params->lowStorageRK) {
+    updateLowStorage(PMG_Source);
+    return;
+  }
+
+  if (params->fuseKernels && params->resSmoothing <= 0) {
+    /* RK stage updates are folded into the final element sweep of each stage */
+    for (int step=0; step<nRKSteps; step++) {
+      params->rkTime = params->time + params->RKc[step]*params->dt;
+
+      moveMesh(step);
+
+      calcResidualFused(step, true, PMG_Source);
+    }
+
+    params->time += params->dt;
+    return;
+  }
+
+  stepRK(PMG_Source);
+}
+
+void solver::stepRK(bool PMG_Source)
+{
   for (int step=0; step<nRKSteps-1; step++) {
-    params->rkTime = params->time + params->RKa[step]*params->dt;
+    params->rkTime = params->time + params->RKc[step]*params->dt;
 
     moveMesh(step);
 
@@ -112,17 +230,21 @@ void solver::update(bool PMG_Source)
 
     calcResidual(step);
 
+    smoothResidual(step, PMG_Source);
+
     timeStepA(step, PMG_Source);
   }
 
   /* Final Runge-Kutta time advancement step */
 
-  params->rkTime = params->time + params->RKa[nRKSteps-1]*params->dt;
+  params->rkTime = params->time + params->RKc[nRKSteps-1]*params->dt;
 
   moveMesh(nRKSteps-1);
 
   calcResidual(nRKSteps-1);
 
+  smoothResidual(nRKSteps-1, PMG_Source);
+
   // Reset solution to initial-stage values
   if (nRKSteps>1)
     copyU0_Uspts();
@@ -133,9 +255,115 @@ void solver::update(bool PMG_Source)
   params->time += params->dt;
 }
 
+void solver::updateMultirate(bool PMG_Source)
+{
+  /* --- Stable dt of this grid, & of the finest & coarsest grids --- */
+  double dtGrid = INFINITY;
+#pragma omp parallel for reduction(min:dtGrid)
+  for (uint i=0; i<eles.size(); i++)
+    dtGrid = min(dtGrid, eles[i]->calcDt());
+
+  double dtMinMax[2] = {-dtGrid, dtGrid};
+#ifndef _NO_MPI
+  MPI_Allreduce(MPI_IN_PLACE, &dtGrid, 1, MPI_DOUBLE, MPI_MIN, Geo->gridComm);
+  dtMinMax[0] = -dtGrid;  dtMinMax[1] = dtGrid;
+  MPI_Allreduce(MPI_IN_PLACE, dtMinMax, 2, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+
+  // The macro step is the coarsest grid's dt, limited to multirateMax steps of the finest grid
+  double dtMacro = min(dtMinMax[1], -dtMinMax[0]*params->multirateMax);
+  int nSub = max(1, (int)ceil(dtMacro / dtGrid * (1. - 1e-12)));
+
+  if (nSub != nSubSteps && gridRank == 0)
+    cout << "Solver: Grid " << gridID << ": " << nSub << " sub-step(s) per multirate time step" << endl;
+  nSubSteps = nSub;
+
+  /* --- Sub-cycle this grid over the macro step; the grids only exchange
+   * fringe data at the start [see oversetInterp] --- */
+  double time0 = params->time;
+  params->dt = dtMacro / nSub;
+  fringeSync[0] = fringeSync[1] = true;
+
+  for (int sub=0; sub<nSub; sub++)
+    stepRK(PMG_Source);
+
+  params->time = time0 + dtMacro;
+  params->dt = dtMacro;
+}
+
+void solver::updateLowStorage(bool PMG_Source)
+{
+  /* Only a single residual register is used [divF_spts[0]], and U0 holds
+   * either the stage increment (2N-storage) or the initial solution (SSP) */
+  bool calcErr = params->adaptDt;
+
+  while (true) {
+    double err = 0;
+
+    for (int step=0; step<nRKSteps; step++) {
+      params->rkTime = params->time + params->RKc[step]*params->dt;
+
+      moveMesh(step);
+
+      if (step == 0) copyUspts_U0();
+
+      calcResidual(0);
+
+      smoothResidual(0, PMG_Source);
+
+      if (params->lowStorageRK == 1) {
+#pragma omp parallel for
+        for (uint i=0; i<eles.size(); i++)
+          eles[i]->timeStepLS(params->RKa[step],params->RKb[step],PMG_Source);
+      }
+      else {
+        bool lastStep = (calcErr && step == nRKSteps-1);
+#pragma omp parallel for reduction(+:err)
+        for (uint i=0; i<eles.size(); i++)
+          err += eles[i]->timeStepSSP(params->RKa[step],PMG_Source,lastStep);
+      }
+    }
+
+    if (!calcErr) break;
+
+    /* --- Adaptive time step: RMS of the scaled embedded-error estimate --- */
+    double nDOF = 0;
+    for (auto &e:eles) nDOF += e->nSpts*e->nFields;
+
+#ifndef _NO_MPI
+    double tmp[2] = {err, nDOF};
+    MPI_Allreduce(MPI_IN_PLACE, tmp, 2, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    err = tmp[0];  nDOF = tmp[1];
+#endif
+
+    err = sqrt(err / nDOF);
+
+    // Standard controller for an order-2 embedded estimate, with safety factor
+    double fac = 0.9 * pow(max(err,1e-10), -1./3.);
+
+    if (err <= 1.) {
+      params->time += params->dt;
+      params->dt *= min(fac, 2.);
+      return;
+    }
+
+    // Reject the step & retry from the initial solution with a smaller dt
+    params->dt *= max(fac, .2);
+    copyU0_Uspts();
+  }
+
+  params->time += params->dt;
+}
 
 void solver::calcResidual(int step)
 {
+  PROFILE("calcResidual");
+
+  if (params->fuseKernels) {
+    calcResidualFused(step);
+    return;
+  }
+
   if (params->meshType == OVERSET_MESH && params->oversetMethod == 2) {
     oversetFieldInterp();
   }
@@ -155,16 +383,29 @@ void solver::calcResidual(int step)
 
   }
 
-  if (params->viscous || params->motion) {
+  /* --- BR2 viscous flux: the faces only need each side's uncorrected
+   * gradient, so it is sent along with the solution in a single exchange --- */
+  bool compactVisc = (params->viscous && params->viscScheme == 1);
+  if (compactVisc) {
 
     calcGradU_spts();
 
+    extrapolateGradU_uncorrected();
+
   }
 
+  /* --- Post the MPI face exchange as soon as U_fpts is final, so that the
+   * messages are in flight during the volume & interior-face work --- */
 #ifndef _NO_MPI
   doCommunication();
 #endif
 
+  if ((params->viscous || params->motion) && !compactVisc) {
+
+    calcGradU_spts();
+
+  }
+
   calcInviscidFlux_spts();
 
   calcInviscidFlux_faces();
@@ -185,12 +426,16 @@ void solver::calcResidual(int step)
 
     correctGradU();
 
-    extrapolateGradU();
+    if (!compactVisc) {
+
+      extrapolateGradU();
 
 #ifndef _NO_MPI
-    doCommunicationGrad();
+      doCommunicationGrad();
 #endif
 
+    }
+
     calcViscousFlux_spts();
 
     calcViscousFlux_faces();
@@ -213,8 +458,344 @@ void solver::calcResidual(int step)
   correctDivFlux(step);
 }
 
+void solver::calcResidualFused(int step, bool advance, bool PMG_Source)
+{
+  PROFILE("calcResidualFused");
+
+  /* Only the face-flux stages (and the MPI exchanges) require all elements to
+   * be synchronized; everything in between is element-local, and is done for
+   * each element while its data is still in cache */
+
+  if(params->scFlag == 1) {
+    shockCapture();
+  }
+
+  if (params->taskResidual) {
+    calcResidualTasks(step, advance, PMG_Source);
+    return;
+  }
+
+  bool copyU0 = (advance && step == 0 && nRKSteps > 1);
+  int nEles = eles.size();
+
+#pragma omp parallel for
+  for (int i=0; i<nEles; i++)
+    fusedSweep1(i, i+1, copyU0);
+
+#ifndef _NO_MPI
+  doCommunication();
+#endif
+
+  calcInviscidFlux_faces();
+
+#ifndef _NO_MPI
+  calcInviscidFlux_mpi();
+#endif
+
+  if (params->viscous) {
+#pragma omp parallel for
+    for (int i=0; i<nEles; i++)
+      fusedSweep2(i, i+1);
+
+#ifndef _NO_MPI
+    doCommunicationGrad();
+#endif
+
+    calcViscousFlux_faces();
+
+#ifndef _NO_MPI
+    calcViscousFlux_mpi();
+#endif
+  }
+
+#pragma omp parallel for
+  for (int i=0; i<nEles; i++)
+    fusedSweep3(i, i+1, step, advance, PMG_Source);
+}
+
+void solver::fusedSweep1(int i0, int i1, bool copyU0)
+{
+  /* --- Sweep 1: Solution [& for BR2, uncorrected gradient] at flux points
+   * [+ polynomial squeezing] --- */
+  bool compactVisc = (params->viscous && params->viscScheme == 1);
+
+  for (int i=i0; i<i1; i++) {
+    auto &e = eles[i];
+    auto &op = opers[e->eType][e->order];
+
+    if (copyU0) e->copyUspts_U0();
+
+    op.applySptsFpts(e->U_spts,e->U_fpts);
+
+    if (params->squeeze) {
+      op.calcAvgU(e->U_spts,e->detJac_spts,e->Uavg);
+      e->checkEntropy();
+    }
+
+    if (compactVisc) {
+      op.applyGradSpts(e->U_spts,e->dU_spts);
+      op.applyExtrapolateGradU(e->dU_spts,e->JGinv_spts,e->detJac_spts,e->dU_fpts);
+    }
+  }
+}
+
+void solver::fusedSweep2(int i0, int i1)
+{
+  /* --- Sweep 2: Corrected gradient at solution & flux points --- */
+  bool compactVisc = (params->viscScheme == 1);
+
+  for (int i=i0; i<i1; i++) {
+    auto &e = eles[i];
+    auto &op = opers[e->eType][e->order];
+
+    if (!compactVisc)
+      op.applyGradSpts(e->U_spts,e->dU_spts);
+
+    e->calcDeltaUc();
+    op.applyCorrectGradU(e->dUc_fpts,e->dU_spts,e->JGinv_spts,e->detJac_spts);
+
+    if (compactVisc) continue;
+
+    for (int dim=0; dim<params->nDims; dim++)
+      op.applySptsFpts(e->dU_spts[dim],e->dU_fpts[dim]);
+  }
+}
+
+void solver::fusedSweep3(int i0, int i1, int step, bool advance, bool PMG_Source)
+{
+  /* --- Sweep 3: Flux at solution points, corrected divergence [+ RK update] --- */
+  for (int i=i0; i<i1; i++) {
+    auto &e = eles[i];
+    auto &op = opers[e->eType][e->order];
+
+    if (params->motion && !params->viscous)
+      op.applyGradSpts(e->U_spts,e->dU_spts);
+
+    e->calcInviscidFlux_spts();
+
+    if (params->viscous)
+      e->calcViscousFlux_spts();
+
+    if (params->motion) {
+      op.applyExtrapolateFn(e->F_spts,e->norm_fpts,e->disFn_fpts,e->dA_fpts);
+      op.applyGradFSpts(e->F_spts,e->dF_spts);
+      e->transformGradF_spts(step);
+    }
+    else {
+      op.applyExtrapolateFn(e->F_spts,e->tNorm_fpts,e->disFn_fpts);
+      op.applyDivFSpts(e->F_spts,e->divF_spts[step]);
+    }
+
+    e->calcDeltaFn();
+    op.applyCorrectDivF(e->dFn_fpts,e->divF_spts[step]);
+
+    if (!advance) continue;
+
+    if (step < nRKSteps-1) {
+      if (PMG_Source)
+        e->timeStepA_source(step,params->RKa[step+1]);
+      else
+        e->timeStepA(step,params->RKa[step+1]);
+    }
+    else {
+      // Reset solution to initial-stage values & assemble all stages
+      if (nRKSteps>1)
+        e->copyU0_Uspts();
+
+      for (int s=0; s<nRKSteps; s++) {
+        if (PMG_Source)
+          e->timeStepB_source(s,params->RKb[s]);
+        else
+          e->timeStepB(s,params->RKb[s]);
+      }
+    }
+  }
+}
+
+void solver::calcResidualTasks(int step, bool advance, bool PMG_Source)
+{
+  PROFILE("calcResidualTasks");
+
+  if (resTasks.size() == 0)
+    setupResidualTasks();
+
+  taskStep = step;
+  taskAdvance = advance;
+  taskPMGSource = PMG_Source;
+
+  resTasks.run();
+}
+
+void solver::setupResidualTasks(void)
+{
+  /* Elements & faces are split into contiguous chunks [a few per thread, so
+   * that the runtime can balance the load]; each face chunk depends only on
+   * the element chunks it touches, so e.g. the flux on the faces of one part
+   * of the domain may be computed while another part is still being
+   * extrapolated, and the MPI faces are finished as the data from each rank
+   * arrives, while the interior work continues on the other threads. */
+
+  resTasks = taskGraph();
+
+  bool viscous = params->viscous;
+  bool compactVisc = (viscous && params->viscScheme == 1);
+
+  int nEles = eles.size();
+  int nFaces = faces.size();
+  int nChunks = max(1, min(nEles, 8*getMaxThreads()));
+  int eChunk = (nEles + nChunks - 1) / nChunks;
+  nChunks = (nEles + eChunk - 1) / eChunk;
+
+  unordered_map<ele*,int> eleChunk;
+  for (int i=0; i<nEles; i++)
+    eleChunk[eles[i].get()] = i / eChunk;
+
+  // Element chunks touched by a set of faces
+  auto getChunks = [&](vector<face*> fList) {
+    set<int> cs;
+    for (auto &f : fList) {
+      cs.insert(eleChunk[f->getLeftEle()]);
+      if (eleChunk.count(f->getRightEle()))
+        cs.insert(eleChunk[f->getRightEle()]);
+    }
+    return cs;
+  };
+
+  /* --- Element sweeps --- */
+
+  vector<int> S1(nChunks), S2(nChunks), S3(nChunks);
+  for (int c=0; c<nChunks; c++) {
+    int i0 = c*eChunk, i1 = min(nEles, (c+1)*eChunk);
+
+    S1[c] = resTasks.addNode([=] () {
+      fusedSweep1(i0, i1, taskAdvance && taskStep == 0 && nRKSteps > 1);
+    });
+    if (viscous)
+      S2[c] = resTasks.addNode([=] () { fusedSweep2(i0, i1); });
+    S3[c] = resTasks.addNode([=] () {
+      fusedSweep3(i0, i1, taskStep, taskAdvance, taskPMGSource);
+    });
+
+    if (viscous) {
+      resTasks.addEdge(S1[c], S2[c]);
+      resTasks.addEdge(S2[c], S3[c]);
+    }
+    else {
+      resTasks.addEdge(S1[c], S3[c]);
+    }
+  }
+
+  /* --- Interior & boundary faces --- */
+
+  int nfChunks = max(1, min(nFaces, 8*getMaxThreads()));
+  int fChunk = (nFaces + nfChunks - 1) / nfChunks;
+  nfChunks = (nFaces + fChunk - 1) / fChunk;
+
+  for (int f=0; f<nfChunks; f++) {
+    int i0 = f*fChunk, i1 = min(nFaces, (f+1)*fChunk);
+
+    vector<face*> fList;
+    for (int i=i0; i<i1; i++)
+      fList.push_back(faces[i].get());
+
+    int FI = resTasks.addNode([=] () {
+      for (int i=i0; i<i1; i++) faces[i]->calcInviscidFlux();
+    });
+
+    int FV = -1;
+    if (viscous) {
+      FV = resTasks.addNode([=] () {
+        for (int i=i0; i<i1; i++) faces[i]->calcViscousFlux();
+      });
+      // BR2: the lifted gradient needs only the sweep-1 data & the common solution
+      if (compactVisc)
+        resTasks.addEdge(FI, FV);
+    }
+
+    for (int c : getChunks(fList)) {
+      resTasks.addEdge(S1[c], FI);
+      if (viscous) {
+        resTasks.addEdge(FI, S2[c]);
+        if (!compactVisc)
+          resTasks.addEdge(S2[c], FV);
+        resTasks.addEdge(FV, S3[c]);
+      }
+      else {
+        resTasks.addEdge(FI, S3[c]);
+      }
+    }
+  }
+
+#ifndef _NO_MPI
+  /* --- MPI faces: one task per neighbor rank, released by the exchange task
+   * as soon as that rank's data has arrived --- */
+
+  int nRanks = mpiFaceComm.nRanks;
+  if (nRanks == 0) return;
+
+  set<int> commChunks;
+  vector<int> MI(nRanks), MV(nRanks);
+  for (int r=0; r<nRanks; r++) {
+    vector<face*> fList(mpiFaceComm.recvFaces[r].begin(), mpiFaceComm.recvFaces[r].end());
+
+    MI[r] = resTasks.addNode([=] () {
+      for (auto &mface : mpiFaceComm.recvFaces[r])
+        mface->calcInviscidFlux();
+    });
+    resTasks.addDependency(MI[r]);
+
+    if (viscous) {
+      MV[r] = resTasks.addNode([=] () {
+        for (auto &mface : mpiFaceComm.recvFaces[r])
+          mface->calcViscousFlux();
+      });
+      if (compactVisc)
+        resTasks.addEdge(MI[r], MV[r]);
+      else
+        resTasks.addDependency(MV[r]);
+    }
+
+    for (int c : getChunks(fList)) {
+      commChunks.insert(c);
+      if (viscous) {
+        resTasks.addEdge(MI[r], S2[c]);
+        resTasks.addEdge(MV[r], S3[c]);
+      }
+      else {
+        resTasks.addEdge(MI[r], S3[c]);
+      }
+    }
+  }
+
+  // The send buffers are packed from the left states of the MPI faces
+  int comm = resTasks.addNode([=] () {
+    mpiFaceComm.startExchange();
+    int r;
+    while ((r = mpiFaceComm.finishAny()) >= 0)
+      resTasks.release(MI[r]);
+  });
+  for (int c : commChunks)
+    resTasks.addEdge(S1[c], comm);
+
+  if (viscous && !compactVisc) {
+    int commGrad = resTasks.addNode([=] () {
+      mpiFaceComm.startExchange(true);
+      int r;
+      while ((r = mpiFaceComm.finishAny(true)) >= 0)
+        resTasks.release(MV[r]);
+    });
+    // MPI calls are serialized [MPI_THREAD_SERIALIZED]
+    resTasks.addEdge(comm, commGrad);
+    for (int c : commChunks)
+      resTasks.addEdge(S2[c], commGrad);
+  }
+#endif
+}
+
 void solver::calcDt(void)
 {
+  PROFILE("calcDt");
+
   double dt = INFINITY;
 
 #pragma omp parallel for reduction(min:dt)
@@ -230,8 +811,111 @@ void solver::calcDt(void)
   params->dt = dt;
 }
 
+void solver::setupEleNbrs(void)
+{
+  if (eleNbrs.size() == eles.size()) return;
+
+  unordered_map<ele*,int> eleInd;
+  for (uint i=0; i<eles.size(); i++)
+    eleInd[eles[i].get()] = i;
+
+  /* Only internal [incl. periodic] faces connect two local elements; MPI
+   * boundaries are treated like physical boundaries */
+  eleNbrs.assign(eles.size(),vector<int>());
+  for (auto &face:faces) {
+    ele *eL = face->getLeftEle();
+    ele *eR = face->getRightEle();
+    if (face->myInfo.isBnd || eR == NULL) continue;
+
+    int iL = eleInd[eL];
+    int iR = eleInd[eR];
+    eleNbrs[iL].push_back(iR);
+    eleNbrs[iR].push_back(iL);
+  }
+}
+
+void solver::setupResidualSmoothing(void)
+{
+  if (params->meshType == OVERSET_MESH)
+    FatalError("Residual smoothing requires a fixed set of elements - not compatible with overset grids.");
+
+  setupEleNbrs();
+
+  resMean.setup(eles.size(),params->nFields);
+  resSmooth.setup(eles.size(),params->nFields);
+  resTmp.setup(eles.size(),params->nFields);
+}
+
+void solver::smoothResidual(int step, bool PMG_Source)
+{
+  if (params->resSmoothing <= 0) return;
+
+  PROFILE("smoothResidual");
+
+  double eps = params->resSmoothing;
+  int nFields = params->nFields;
+
+  /* --- Element-mean update dt*R [in physical space]; smoothing dt*R rather
+   * than R keeps small (e.g. wall) cells from polluting their neighbors when
+   * using local time stepping --- */
+#pragma omp parallel for
+  for (uint i=0; i<eles.size(); i++) {
+    auto &e = eles[i];
+    double dt = (params->dtType == 2) ? e->dt : params->dt;
+    for (int k=0; k<nFields; k++) {
+      double sum = 0;
+      for (int spt=0; spt<e->nSpts; spt++) {
+        double R = e->divF_spts[step](spt,k);
+        if (PMG_Source) R += e->src_spts(spt,k);
+        sum += R / e->detJac_spts[spt];
+      }
+      resMean(i,k) = dt * sum / e->nSpts;
+      resSmooth(i,k) = resMean(i,k);
+    }
+  }
+
+  /* --- Damped Jacobi iterations for (1 - eps*Laplacian) Rbar = R
+   * [undamped Jacobi flips the sign of the checkerboard mode for eps*nNbrs > 1] --- */
+  matrix<double> *Rold = &resSmooth;
+  matrix<double> *Rnew = &resTmp;
+  for (int iter=0; iter<params->resSmoothIters; iter++) {
+#pragma omp parallel for
+    for (uint i=0; i<eles.size(); i++) {
+      for (int k=0; k<nFields; k++) {
+        double sum = 0;
+        for (int j:eleNbrs[i])
+          sum += (*Rold)(j,k);
+        double jac = (resMean(i,k) + eps*sum) / (1. + eps*eleNbrs[i].size());
+        (*Rnew)(i,k) = .5 * ((*Rold)(i,k) + jac);
+      }
+    }
+    std::swap(Rold,Rnew);
+  }
+  matrix<double> &Rbar = *Rold;
+
+  /* --- Final Jacobi iteration applied to the full element residual:
+   * R <- Rbar + (R - Rmean) / (1 + eps*nNbrs)
+   * i.e. smoothing of the mean, and damping of the intra-element modes --- */
+#pragma omp parallel for
+  for (uint i=0; i<eles.size(); i++) {
+    auto &e = eles[i];
+    double dt = (params->dtType == 2) ? e->dt : params->dt;
+    double fac = 1. / (1. + eps*eleNbrs[i].size());
+    for (int spt=0; spt<e->nSpts; spt++) {
+      for (int k=0; k<nFields; k++) {
+        double src = (PMG_Source) ? e->src_spts(spt,k) : 0.;
+        double R = dt * (e->divF_spts[step](spt,k) + src) / e->detJac_spts[spt];
+        R = Rbar(i,k) + (R - resMean(i,k)) * fac;
+        e->divF_spts[step](spt,k) = R * e->detJac_spts[spt] / dt - src;
+      }
+    }
+  }
+}
+
 void solver::timeStepA(int step, bool PMG_Source)
 {
+  PROFILE("timeStepA");
+
   if (PMG_Source)
   {
     /* --- Include PMG Source Term --- */
@@ -266,6 +950,8 @@ void solver::timeStepA(int step, bool PMG_Source)
 
 void solver::timeStepB(int step, bool PMG_Source)
 {
+  PROFILE("timeStepB");
+
   if (PMG_Source)
   {
     /* --- Include PMG Source Term --- */
@@ -316,6 +1002,15 @@ void solver::copyU0_Uspts(void)
 
 void solver::extrapolateU(void)
 {
+  PROFILE("extrapolateU");
+
+  if (params->batchStorage) {
+    for (auto &etype:eleBlocks)
+      for (auto &P:etype.second)
+        opers[etype.first][P.first].applySptsFpts(P.second.U_spts,P.second.U_fpts);
+    return;
+  }
+
 #pragma omp parallel for
   for (uint i=0; i<eles.size(); i++) {
     opers[eles[i]->eType][eles[i]->order].applySptsFpts(eles[i]->U_spts,eles[i]->U_fpts);
@@ -333,7 +1028,7 @@ void solver::calcAvgSolution()
 bool solver::checkDensity()
 {
   bool squeezed = false;
-#pragma omp parallel for
+#pragma omp parallel for reduction(||:squeezed)
   for (uint i=0; i<eles.size(); i++) {
     bool check = eles[i]->checkDensity();
     squeezed = check|| squeezed;
@@ -392,6 +1087,8 @@ void solver::extrapolateSFpts(void)
 
 void solver::calcInviscidFlux_spts(void)
 {
+  PROFILE("calcInviscidFlux_spts");
+
 #pragma omp parallel for
   for (uint i=0; i<eles.size(); i++) {
     eles[i]->calcInviscidFlux_spts();
@@ -400,20 +1097,30 @@ void solver::calcInviscidFlux_spts(void)
 
 void solver::doCommunication()
 {
-  for (uint i=0; i<mpiFaces.size(); i++) {
-    mpiFaces[i]->communicate();
-  }
+  PROFILE("doCommunication");
+
+  mpiFaceComm.startExchange();
 }
 
 void solver::doCommunicationGrad()
 {
-  for (uint i=0; i<mpiFaces.size(); i++) {
-    mpiFaces[i]->communicateGrad();
-  }
+  PROFILE("doCommunicationGrad");
+
+  // BR2: the gradient is sent along with the solution [see faceComm]
+  if (params->viscous && params->viscScheme != 1)
+    mpiFaceComm.startExchange(true);
 }
 
 void solver::calcInviscidFlux_faces()
 {
+  PROFILE("calcInviscidFlux_faces");
+
+  if (!faceBlocks.empty()) {
+    if (faceBlocks.count(INTERNAL)) faceBlocks[INTERNAL].calcInviscidFlux();
+    if (faceBlocks.count(BOUNDARY)) faceBlocks[BOUNDARY].calcInviscidFlux();
+    return;
+  }
+
 #pragma omp parallel for
   for (uint i=0; i<faces.size(); i++) {
     faces[i]->calcInviscidFlux();
@@ -422,15 +1129,27 @@ void solver::calcInviscidFlux_faces()
 
 void solver::calcInviscidFlux_mpi()
 {
-  for (uint i=0; i<mpiFaces.size(); i++) {
-    mpiFaces[i]->calcInviscidFlux();
+  PROFILE("calcInviscidFlux_mpi");
+
+  if (faceBlocks.count(MPI_FACE)) {
+    mpiFaceComm.finishAll();
+    faceBlocks[MPI_FACE].calcInviscidFlux();
+    return;
   }
+
+  // Finish the MPI faces shared with each neighbor rank as its data arrives
+  int r;
+  while ((r = mpiFaceComm.finishAny()) >= 0)
+    for (auto &mface : mpiFaceComm.recvFaces[r])
+      mface->calcInviscidFlux();
 }
 
 void solver::calcInviscidFlux_overset()
 {
   if (params->oversetMethod == 2) return;
 
+  PROFILE("calcInviscidFlux_overset");
+
 #pragma omp parallel for
   for (uint i=0; i<overFaces.size(); i++) {
     overFaces[i]->calcInviscidFlux();
@@ -439,6 +1158,8 @@ void solver::calcInviscidFlux_overset()
 
 void solver::calcViscousFlux_spts(void)
 {
+  PROFILE("calcViscousFlux_spts");
+
 #pragma omp parallel for
   for (uint i=0; i<eles.size(); i++) {
     eles[i]->calcViscousFlux_spts();
@@ -447,6 +1168,8 @@ void solver::calcViscousFlux_spts(void)
 
 void solver::calcViscousFlux_faces()
 {
+  PROFILE("calcViscousFlux_faces");
+
 #pragma omp parallel for
   for (uint i=0; i<faces.size(); i++) {
     faces[i]->calcViscousFlux();
@@ -455,13 +1178,27 @@ void solver::calcViscousFlux_faces()
 
 void solver::calcViscousFlux_mpi()
 {
-  for (uint i=0; i<mpiFaces.size(); i++) {
-    mpiFaces[i]->calcViscousFlux();
+  PROFILE("calcViscousFlux_mpi");
+
+  if (params->viscScheme == 1) {
+    // BR2: all of the required data arrived with the solution
+#pragma omp parallel for
+    for (uint i=0; i<mpiFaces.size(); i++)
+      mpiFaces[i]->calcViscousFlux();
+    return;
   }
+
+  // Finish the MPI faces shared with each neighbor rank as its data arrives
+  int r;
+  while ((r = mpiFaceComm.finishAny(true)) >= 0)
+    for (auto &mface : mpiFaceComm.recvFaces[r])
+      mface->calcViscousFlux();
 }
 
 void solver::calcViscousFlux_overset()
 {
+  PROFILE("calcViscousFlux_overset");
+
   if (params->oversetMethod == 2) return;
 
 #pragma omp parallel for
@@ -488,6 +1225,8 @@ void solver::transformGradF_spts(int step)
 
 void solver::calcFluxDivergence(int step)
 {
+  PROFILE("calcFluxDivergence");
+
   if (params->motion) {
 
     /* Use non-conservation-form chain-rule transformation
@@ -507,6 +1246,13 @@ void solver::calcFluxDivergence(int step)
 
 void solver::calcDivF_spts(int step)
 {
+  if (params->batchStorage) {
+    for (auto &etype:eleBlocks)
+      for (auto &P:etype.second)
+        opers[etype.first][P.first].applyDivFSpts(P.second.F_spts,P.second.divF_spts[step]);
+    return;
+  }
+
 #pragma omp parallel for
   for (uint i=0; i<eles.size(); i++) {
     opers[eles[i]->eType][eles[i]->order].applyDivFSpts(eles[i]->F_spts,eles[i]->divF_spts[step]);
@@ -515,6 +1261,23 @@ void solver::calcDivF_spts(int step)
 
 void solver::extrapolateNormalFlux(void)
 {
+  PROFILE("extrapolateNormalFlux");
+
+  if (params->batchStorage) {
+    /* Extrapolate each flux component for all elements at once, then take the
+     * element-local dot product with the (physical or transformed) normal */
+    for (auto &etype:eleBlocks)
+      for (auto &P:etype.second)
+        for (int dim=0; dim<params->nDims; dim++)
+          opers[etype.first][P.first].applySptsFpts(P.second.F_spts[dim],P.second.F_fpts[dim]);
+
+#pragma omp parallel for
+    for (uint i=0; i<eles.size(); i++) {
+      eles[i]->calcDisFn_fpts();
+    }
+    return;
+  }
+
   if (params->motion) {
     /* Extrapolate physical normal flux */
 #pragma omp parallel for
@@ -533,6 +1296,20 @@ void solver::extrapolateNormalFlux(void)
 
 void solver::correctDivFlux(int step)
 {
+  PROFILE("correctDivFlux");
+
+  if (params->batchStorage) {
+#pragma omp parallel for
+    for (uint i=0; i<eles.size(); i++) {
+      eles[i]->calcDeltaFn();
+    }
+
+    for (auto &etype:eleBlocks)
+      for (auto &P:etype.second)
+        opers[etype.first][P.first].applyCorrectDivF(P.second.dFn_fpts,P.second.divF_spts[step]);
+    return;
+  }
+
 #pragma omp parallel for
   for (uint i=0; i<eles.size(); i++) {
     eles[i]->calcDeltaFn();
@@ -542,6 +1319,15 @@ void solver::correctDivFlux(int step)
 
 void solver::calcGradU_spts(void)
 {
+  PROFILE("calcGradU_spts");
+
+  if (params->batchStorage) {
+    for (auto &etype:eleBlocks)
+      for (auto &P:etype.second)
+        opers[etype.first][P.first].applyGradSpts(P.second.U_spts,P.second.dU_spts);
+    return;
+  }
+
 #pragma omp parallel for
   for (uint i=0; i<eles.size(); i++) {
     opers[eles[i]->eType][eles[i]->order].applyGradSpts(eles[i]->U_spts,eles[i]->dU_spts);
@@ -550,6 +1336,25 @@ void solver::calcGradU_spts(void)
 
 void solver::correctGradU(void)
 {
+  PROFILE("correctGradU");
+
+  if (params->batchStorage) {
+#pragma omp parallel for
+    for (uint i=0; i<eles.size(); i++) {
+      eles[i]->calcDeltaUc();
+    }
+
+    for (auto &etype:eleBlocks)
+      for (auto &P:etype.second)
+        opers[etype.first][P.first].applyCorrectGradU(P.second.dUc_fpts,P.second.dU_spts);
+
+#pragma omp parallel for
+    for (uint i=0; i<eles.size(); i++) {
+      opers[eles[i]->eType][eles[i]->order].applyTransformGradU(eles[i]->dU_spts,eles[i]->JGinv_spts,eles[i]->detJac_spts);
+    }
+    return;
+  }
+
 #pragma omp parallel for
   for (uint i=0; i<eles.size(); i++) {
     eles[i]->calcDeltaUc();
@@ -559,6 +1364,16 @@ void solver::correctGradU(void)
 
 void solver::extrapolateGradU()
 {
+  PROFILE("extrapolateGradU");
+
+  if (params->batchStorage) {
+    for (auto &etype:eleBlocks)
+      for (auto &P:etype.second)
+        for (int dim=0; dim<params->nDims; dim++)
+          opers[etype.first][P.first].applySptsFpts(P.second.dU_spts[dim],P.second.dU_fpts[dim]);
+    return;
+  }
+
 #pragma omp parallel for
   for (uint i=0; i<eles.size(); i++) {
     for (int dim=0; dim<params->nDims; dim++) {
@@ -567,6 +1382,16 @@ void solver::extrapolateGradU()
   }
 }
 
+void solver::extrapolateGradU_uncorrected(void)
+{
+  PROFILE("extrapolateGradU");
+
+#pragma omp parallel for
+  for (uint i=0; i<eles.size(); i++) {
+    opers[eles[i]->eType][eles[i]->order].applyExtrapolateGradU(eles[i]->dU_spts,eles[i]->JGinv_spts,eles[i]->detJac_spts,eles[i]->dU_fpts);
+  }
+}
+
 void solver::calcEntropyErr_spts(void)
 {
 #pragma omp parallel for
@@ -575,17 +1400,92 @@ void solver::calcEntropyErr_spts(void)
   }
 }
 
+void solver::get_p_adapt_cells(void)
+{
+  calcEntropyErr_spts();
+
+  /* --- Error indicator of each element: max. magnitude of the entropy error --- */
+  vector<double> eta(eles.size());
+  double sumEta = 0;
+#pragma omp parallel for reduction(+:sumEta)
+  for (uint i=0; i<eles.size(); i++) {
+    double val = 0;
+    for (int spt=0; spt<eles[i]->nSpts; spt++)
+      val = max(val, std::abs(eles[i]->S_spts(spt)));
+    eta[i] = val;
+    sumEta += val;
+  }
+
+  double nEles = eles.size();
+#ifndef _NO_MPI
+  MPI_Allreduce(MPI_IN_PLACE, &sumEta, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &nEles, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+#endif
+  double meanEta = sumEta / max(nEles, 1.);
+
+  p_adapt_cells.resize(0);
+  for (uint i=0; i<eles.size(); i++) {
+    auto &e = eles[i];
+    bool shock = (params->scFlag && e->sensor > params->threshold);
+
+    int newOrder = e->order;
+    if (eta[i] > params->pAdaptRefine*meanEta && !shock)
+      newOrder = min(e->order+1, params->pAdaptMax);
+    else if (eta[i] < params->pAdaptCoarsen*meanEta)
+      newOrder = max(e->order-1, params->pAdaptMin);
+
+    if (newOrder == e->order) continue;
+
+    p_adapt_cells.push_back(i);
+    if (newOrder == order)
+      eleOrders.erase(e->IDg);
+    else
+      eleOrders[e->IDg] = newOrder;
+  }
+}
+
+bool solver::setup_p_adaptation(void)
+{
+  get_p_adapt_cells();
+
+  int nChanged = p_adapt_cells.size();
+#ifndef _NO_MPI
+  MPI_Allreduce(MPI_IN_PLACE, &nChanged, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+#endif
+  if (nChanged == 0) return false;
+
+  if (params->rank == 0)
+    cout << "Solver: p-adaptation: changing the order of " << nChanged << " elements" << endl;
+
+  // Keep the solution of every element; the faces of all elements are re-built
+  vector<char> recs;
+  for (auto &e:eles)
+    packEleRecord(e.get(), recs);
+
+  rebuildElesFaces(recs);
+
+  return true;
+}
+
 void solver::moveMesh(int step)
 {
   if (!params->motion) return;
 
+  PROFILE("moveMesh");
+
   if (params->meshType == OVERSET_MESH) {
     if (step == 0) {
       Geo->setIterIblanks();
-      if (params->RKa[nRKSteps-1]!=1.)
+      if (params->RKc[nRKSteps-1]!=1.)
         Geo->updateADT();
-      Geo->processBlanks(eles,faces,mpiFaces,overFaces);
-      Geo->processUnblanks(eles,faces,mpiFaces,overFaces);
+      if (Geo->blankingChanged) {
+        Geo->processBlanks(eles,faces,mpiFaces,overFaces);
+        Geo->processUnblanks(eles,faces,mpiFaces,overFaces);
+#ifndef _NO_MPI
+        // MPI faces may have been added or removed; re-build the messages to each rank
+        mpiFaceComm.setup(params,mpiFaces);
+#endif
+      }
       OComm->matchUnblankCells(eles,Geo->unblankCells,Geo->eleMap,params->quadOrder);
       OComm->performGalerkinProjection(eles,opers,Geo->eleMap,order);
     }
@@ -595,8 +1495,7 @@ void solver::moveMesh(int step)
         OComm->matchUnblankCells(eles,Geo->fringeCells,Geo->eleMap,params->quadOrder);
         OComm->performGalerkinProjection(eles,opers,Geo->eleMap,order);
       } else {
-        if (params->nDims==2)
-          getBoundingBox(Geo->xv,Geo->minPt,Geo->maxPt);
+        getBoundingBox(Geo->xv,Geo->minPt,Geo->maxPt);
         OComm->setupFringeCellPoints(eles,Geo->fringeCells,Geo->eleMap);
         OComm->matchOversetPoints(eles,Geo->eleMap,Geo->minPt,Geo->maxPt);
         OComm->exchangeOversetData(eles,opers,Geo->eleMap);
@@ -604,21 +1503,20 @@ void solver::moveMesh(int step)
       }
     }
 
-    if ( !(step==0 && params->RKa[step]==0) )
-      Geo->moveMesh(params->RKa[step]);
+    if ( !(step==0 && params->RKc[step]==0) )
+      Geo->moveMesh(params->RKc[step]);
 
     for (auto &e:eles) e->move(true);
 
     Geo->updateADT();
 
     if (params->oversetMethod != 2) {
-      if (params->nDims==2)
-        getBoundingBox(Geo->xv,Geo->minPt,Geo->maxPt);
+      getBoundingBox(Geo->xv,Geo->minPt,Geo->maxPt);
       OComm->setupOverFacePoints(overFaces);
       OComm->matchOversetPoints(eles,Geo->eleMap,Geo->minPt,Geo->maxPt);
     }
   } else {
-    Geo->moveMesh(params->RKa[step]);
+    Geo->moveMesh(params->RKc[step]);
 
 #pragma omp parallel for
     for (uint i=0; i<eles.size(); i++) {
@@ -632,12 +1530,8 @@ vector<double> solver::computeWallForce(void)
 {
   vector<double> force = {0,0,0,0,0,0};
 
-  for (uint i=0; i<faces.size(); i++) {
-    auto fTmp = faces[i]->computeWallForce();
-
-    for (int j=0; j<6; j++)
-      force[j] += fTmp[j];
-  }
+  for (uint i=0; i<faces.size(); i++)
+    faces[i]->computeWallForce(force.data());
 
   return force;
 }
@@ -646,12 +1540,8 @@ vector<double> solver::computeMassFlux(void)
 {
   vector<double> flux(params->nFields);
 
-  for (uint i=0; i<faces.size(); i++) {
-    auto fTmp = faces[i]->computeMassFlux();
-
-    for (int j=0; j<params->nFields; j++)
-      flux[j] += fTmp[j];
-  }
+  for (uint i=0; i<faces.size(); i++)
+    faces[i]->computeMassFlux(flux.data());
 
 #ifndef _NO_MPI
     auto fTmp = flux;
@@ -665,16 +1555,89 @@ void solver::setupOperators()
 {
   if (params->rank==0) cout << "Solver: Setting up FR operators" << endl;
 
-  // Get all element types & olynomial orders in mesh
+  // Get all element types & olynomial orders in mesh; operators are only
+  // setup for the (eType,order) pairs not already present [p-adaptation]
+  set<pair<int,int>> newOrders;
   for (auto& e:eles) {
     eTypes.insert(e->eType);
-    polyOrders[e->eType].insert(e->order);
+    if (polyOrders[e->eType].insert(e->order).second)
+      newOrders.insert({e->eType,e->order});
+  }
+
+  if (params->nproc == 1 && params->operCache.empty()) {
+    for (auto& ep: newOrders)
+      opers[ep.first][ep.second].setupOperators(ep.first,ep.second,Geo,params);
+    return;
   }
 
-  for (auto& e: eTypes) {
-    for (auto& p: polyOrders[e]) {
-      opers[e][p].setupOperators(e,p,Geo,params);
+  /* --- Otherwise, the operators needed on any rank are computed [or read
+   * from the operator cache file] only on rank 0, then broadcast --- */
+
+  vector<int> keys;
+  for (auto& ep: newOrders) {
+    keys.push_back(ep.first);
+    keys.push_back(ep.second);
+  }
+
+#ifndef _NO_MPI
+  int nKeys = keys.size();
+  vector<int> nKeys_rank(params->nproc), disp(params->nproc);
+  MPI_Allgather(&nKeys,1,MPI_INT,nKeys_rank.data(),1,MPI_INT,MPI_COMM_WORLD);
+  for (int p=1; p<params->nproc; p++)
+    disp[p] = disp[p-1] + nKeys_rank[p-1];
+  vector<int> allKeys(disp.back()+nKeys_rank.back());
+  MPI_Allgatherv(keys.data(),nKeys,MPI_INT,allKeys.data(),nKeys_rank.data(),disp.data(),MPI_INT,MPI_COMM_WORLD);
+  keys = allKeys;
+#endif
+
+  set<pair<int,int>> allOrders;
+  for (uint i=0; i<keys.size(); i+=2)
+    allOrders.insert({keys[i],keys[i+1]});
+
+  // Records of {eType, order, nBytes} followed by the packed operators
+  vector<char> buf;
+  if (params->rank == 0) {
+    operCacheMap cache;
+    if (!params->operCache.empty() && readOperCache(params->operCache,cache))
+      cout << "Solver: Read the operator cache " << params->operCache << endl;
+
+    int nNew = 0;
+    for (auto& ep: allOrders) {
+      auto &packed = cache[oper::cacheKey(ep.first,ep.second,params)];
+      if (packed.empty()) {
+        oper op;
+        op.setupOperators(ep.first,ep.second,Geo,params);
+        op.packOperators(packed);
+        nNew++;
+      }
+
+      int64_t info[3] = {ep.first, ep.second, (int64_t)packed.size()};
+      size_t pos = buf.size();
+      buf.resize(pos + sizeof(info) + packed.size());
+      memcpy(&buf[pos], info, sizeof(info));
+      memcpy(&buf[pos+sizeof(info)], packed.data(), packed.size());
     }
+
+    if (nNew > 0 && !params->operCache.empty())
+      writeOperCache(params->operCache,cache);
+  }
+
+#ifndef _NO_MPI
+  int64_t nBytes = buf.size();
+  MPI_Bcast(&nBytes,1,MPI_INT64_T,0,MPI_COMM_WORLD);
+  buf.resize(nBytes);
+  if (nBytes > INT_MAX)
+    FatalError("Packed FR operators exceed 2GB!");
+  MPI_Bcast(buf.data(),(int)nBytes,MPI_BYTE,0,MPI_COMM_WORLD);
+#endif
+
+  for (size_t pos=0; pos<buf.size(); ) {
+    int64_t info[3];
+    memcpy(info, &buf[pos], sizeof(info));
+    pos += sizeof(info);
+    if (newOrders.count({(int)info[0],(int)info[1]}))
+      opers[info[0]][info[1]].setupOperators(info[0],info[1],Geo,params,&buf[pos]);
+    pos += info[2];
   }
 }
 
@@ -682,9 +1645,15 @@ void solver::setupElesFaces(void) {
 
   if (params->rank==0) cout << "Solver: Setting up elements & faces" << endl;
 
+  if (params->batchStorage)
+    setupEleBlocks();
+
+  // Each element's storage is allocated (and first touched) by the thread
+  // which will later compute on it
 #pragma omp parallel for
   for (uint i=0; i<eles.size(); i++) {
-    eles[i]->setup(params,Geo,order);
+    auto it = eleOrders.find(eles[i]->IDg);
+    eles[i]->setup(params,Geo,(it == eleOrders.end()) ? order : it->second);
   }
 
   // Finish setting up internal & boundary faces
@@ -706,6 +1675,47 @@ void solver::setupElesFaces(void) {
   }
 }
 
+void solver::setupEleBlocks(void)
+{
+  /* --- Count the elements of each type & order, and assign each element its
+   * index within the corresponding block --- */
+  eleBlocks.clear();
+
+  map<int, map<int,int> > nEles;
+  for (auto &e:eles) {
+    e->blockInd = nEles[e->eType][order];
+    nEles[e->eType][order]++;
+  }
+
+  for (auto &etype:nEles) {
+    for (auto &P:etype.second) {
+      eleBlocks[etype.first][P.first].setup(params,etype.first,P.first,P.second);
+    }
+  }
+
+  for (auto &e:eles)
+    e->block = &eleBlocks[e->eType][order];
+}
+
+void solver::setupFaceBlocks(void)
+{
+  faceBlocks.clear();
+
+  map<int, vector<face*> > blockFaces;
+  for (auto &f:faces) {
+    if (f->myInfo.isBnd)
+      blockFaces[BOUNDARY].push_back(f.get());
+    else
+      blockFaces[INTERNAL].push_back(f.get());
+  }
+
+  for (auto &f:mpiFaces)
+    blockFaces[MPI_FACE].push_back(f.get());
+
+  for (auto &fType:blockFaces)
+    faceBlocks[fType.first].setup(params,fType.first,fType.second);
+}
+
 void solver::finishMpiSetup(void)
 {
   if (params->rank==0) cout << "Solver: Setting up MPI face communications" << endl;
@@ -713,10 +1723,165 @@ void solver::finishMpiSetup(void)
   for (uint i=0; i<mpiFaces.size(); i++) {
     mpiFaces[i]->finishRightSetup();
   }
+
+  mpiFaceComm.setup(params,mpiFaces);
+}
+
+void solver::packEleRecord(ele *e, vector<char> &buf)
+{
+  int nFields = params->nFields;
+
+  size_t pos = buf.size();
+  buf.resize(pos + 4*sizeof(int) + e->nSpts*nFields*sizeof(double));
+
+  int info[4] = {e->IDg, e->eType, e->order, e->nSpts};
+  memcpy(&buf[pos], info, sizeof(info));
+
+  double *U = (double*)&buf[pos+sizeof(info)];
+  for (int spt=0; spt<e->nSpts; spt++)
+    for (int k=0; k<nFields; k++)
+      U[spt*nFields+k] = e->U_spts(spt,k);
+}
+
+void solver::rebuildElesFaces(const vector<char> &recs)
+{
+  eles.clear();
+  faces.clear();
+  mpiFaces.clear();
+  overFaces.clear();
+  eleNbrs.clear();
+  resTasks = taskGraph();
+  donors.clear();
+
+  setupFromGeo();
+
+  // Set the geometry to the current time
+  params->rkTime = params->time;
+  if (params->motion)
+    moveMesh(0);
+
+  /* --- Restore the solution, interpolating to each element's new order --- */
+  int nFound = applyEleRecords(recs.data(), recs.data()+recs.size());
+
+  if (nFound != (int)eles.size())
+    FatalError("Solution not found for all elements on this rank after re-building the elements.");
+
+  finishSolutionSetup();
+}
+
+#ifndef _NO_MPI
+/*! Send sendBufs[p] to each rank p [clearing sendBufs]; returns all data received, in order of the source rank */
+template<typename T>
+static vector<T> exchangeBuffers(vector<vector<T>> &sendBufs, vector<int> &recvCnts, MPI_Comm comm, const string &what)
+{
+  int nproc = sendBufs.size();
+
+  // Counts & displacements in bytes
+  vector<int> sendCnts(nproc), sendDisp(nproc);
+  vector<int> recvBytes(nproc), recvDisp(nproc);
+  vector<T> sendBuf;
+  for (int p=0; p<nproc; p++) {
+    if ((sendBufs[p].size() + sendBuf.size())*sizeof(T) > INT_MAX)
+      FatalError((what + ": data sent from one rank exceeds 2GB.").c_str());
+    sendCnts[p] = sendBufs[p].size()*sizeof(T);
+    sendDisp[p] = sendBuf.size()*sizeof(T);
+    sendBuf.insert(sendBuf.end(), sendBufs[p].begin(), sendBufs[p].end());
+    vector<T>().swap(sendBufs[p]);
+  }
+
+  MPI_Alltoall(sendCnts.data(), 1, MPI_INT, recvBytes.data(), 1, MPI_INT, comm);
+
+  int64_t nRecv = 0;
+  recvCnts.resize(nproc);
+  for (int p=0; p<nproc; p++) {
+    recvDisp[p] = nRecv;
+    recvCnts[p] = recvBytes[p]/sizeof(T);
+    nRecv += recvBytes[p];
+  }
+  if (nRecv > INT_MAX)
+    FatalError((what + ": data received on one rank exceeds 2GB.").c_str());
+
+  vector<T> recvBuf(nRecv/sizeof(T));
+  MPI_Alltoallv(sendBuf.data(), sendCnts.data(), sendDisp.data(), MPI_BYTE,
+                recvBuf.data(), recvBytes.data(), recvDisp.data(), MPI_BYTE, comm);
+
+  return recvBuf;
+}
+#endif
+
+bool solver::rebalance(void)
+{
+#ifndef _NO_MPI
+  if (params->nproc <= 1) return false;
+
+  /* --- Estimated load of each rank: volume [spts] + surface [fpts] work --- */
+  double load = 0;
+  for (auto &e:eles)
+    load += 2*e->nSpts + e->nFpts;
+
+  double maxLoad, sumLoad;
+  MPI_Allreduce(&load, &maxLoad, 1, MPI_DOUBLE, MPI_MAX, Geo->gridComm);
+  MPI_Allreduce(&load, &sumLoad, 1, MPI_DOUBLE, MPI_SUM, Geo->gridComm);
+  double imbalance = maxLoad * nprocPerGrid / max(sumLoad, 1.);
+
+  // The overset connectivity spans all grids, so all grids are re-partitioned together
+  double maxImbalance;
+  MPI_Allreduce(&imbalance, &maxImbalance, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+  if (maxImbalance <= params->rebalanceTol) return false;
+
+  if (params->rank == 0)
+    cout << "Solver: Load imbalance (max/avg) = " << maxImbalance << "; re-partitioning" << endl;
+
+  geo *newGeo = new geo;
+  newGeo->setupRebalanced(*Geo, eles);
+
+  /* --- Pack each element's record [as in the binary restart file] for its new rank --- */
+  int nFields = params->nFields;
+  vector<vector<char>> sendBufs(nprocPerGrid);
+  for (auto &e:eles) {
+    int dest = (nprocPerGrid > 1) ? newGeo->epart[e->IDg] : 0;
+    packEleRecord(e.get(), sendBufs[dest]);
+  }
+
+  vector<int> recvCnts;
+  vector<char> recvBuf = exchangeBuffers(sendBufs, recvCnts, Geo->gridComm, "Load rebalancing");
+  int64_t nRecv = recvBuf.size();
+
+  /* --- Replace the grid, and rebuild the elements, faces & communication --- */
+  opers.clear();
+  eTypes.clear();
+  polyOrders.clear();
+
+  delete Geo;
+  Geo = newGeo;
+  tg = Geo->tg;
+
+  // The elements keep their [p-adapted] orders
+  eleOrders.clear();
+  for (const char *ptr = recvBuf.data(); ptr < recvBuf.data()+nRecv; ) {
+    int info[4];  // IDg, eType, order, nSpts
+    memcpy(info, ptr, sizeof(info));
+    if (info[2] != order)
+      eleOrders[info[0]] = info[2];
+    ptr += sizeof(info) + (size_t)info[3]*nFields*sizeof(double);
+  }
+
+  rebuildElesFaces(recvBuf);
+
+  return true;
+#else
+  return false;
+#endif
 }
 
 void solver::readRestartFile(void) {
 
+  if (params->restartType > 0) {
+    readRestartBinary();
+    return;
+  }
+
   ifstream dataFile;
   dataFile.precision(15);
 
@@ -769,6 +1934,8 @@ void solver::readRestartFile(void) {
         for (int i=0; i<Geo->nEles; i++)
           ss >> tmpIblank[i];
       }
+    } else if (str.compare("<VTKFile")==0 && ss.str().find("header_type") != string::npos) {
+      FatalError("Cannot restart from a binary .vtu file; write restart files with vtuFormat = 0, or use restartType.");
     } else if (str.compare("<UnstructuredGrid>")==0) {
       foundUGTag = true;
       break;
@@ -799,6 +1966,9 @@ void solver::readRestartFile(void) {
     }
 
     Geo->processBlanks(eles,faces,mpiFaces,overFaces);
+#ifndef _NO_MPI
+    mpiFaceComm.setup(params,mpiFaces);
+#endif
   }
 
   // Read restart data & setup all data arrays
@@ -818,6 +1988,242 @@ void solver::readRestartFile(void) {
   if (params->rank==0) cout << "Solver: Done reading restart file." << endl;
 }
 
+void solver::readRestartBinary(void)
+{
+  int rank = params->rank;
+  int nproc = params->nproc;
+  int iter = params->restartIter;
+  bool shared = (params->restartType == 1);
+
+  string fileName = getRestartFileName(params,iter,0);
+
+  if (rank==0) cout << "Solver: Restarting from " << fileName << endl;
+
+  /* --- Read the header on rank 0 [of the shared file, or of rank 0's file] --- */
+  restartHeader header;
+  memset(&header, 0, sizeof(header));
+  if (rank == 0) {
+    ifstream file(fileName.c_str(), ios::in | ios::binary);
+    if (file.is_open())
+      file.read((char*)&header, sizeof(header));
+  }
+#ifndef _NO_MPI
+  MPI_Bcast(&header, sizeof(header), MPI_BYTE, 0, MPI_COMM_WORLD);
+#endif
+
+  if (strncmp(header.magic, "FLURRYRS", 8) != 0 || header.version < 1 || header.version > 2)
+    FatalError("Cannot open restart file, or not a Flurry binary restart file.");
+
+  if (header.nDims != params->nDims || header.nFields != params->nFields)
+    FatalError("Restart file does not match the current equation set / dimension.");
+
+  // Version-1 headers end before nRanks; version-1 per-rank files were read by the same # of ranks
+  size_t headerSize = (header.version == 1) ? offsetof(restartHeader,nRanks) : sizeof(restartHeader);
+  int nParts = shared ? header.nParts : ((header.version == 1) ? nproc : header.nRanks);
+
+  /* --- Get pointers to the element records of the partitions read by this rank --- */
+  // Each rank reads a contiguous range of the partitions that were written; if
+  // the # of ranks or the partitioning has changed, the element records are
+  // then sent on to the ranks now owning the elements
+  int p0 = (int64_t)rank*nParts/nproc;
+  int p1 = (int64_t)(rank+1)*nParts/nproc;
+
+  vector<pair<const char*,const char*>> segs;  // Start & end of each partition's records
+  vector<char> buf;
+  vector<pair<char*,size_t>> maps;
+
+#ifndef _NO_MPI
+  if (shared) {
+    /* Shared file: collective MPI-IO read of this rank's partitions [contiguous in the file] */
+    MPI_File fh;
+    if (MPI_File_open(MPI_COMM_WORLD, &fileName[0], MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS)
+      FatalError("Cannot open restart file.");
+
+    vector<int64_t> table(3*(p1-p0));  // nEles, offset, nBytes
+    MPI_File_read_at_all(fh, headerSize + 3*p0*sizeof(int64_t), table.data(), table.size()*sizeof(int64_t), MPI_BYTE, MPI_STATUS_IGNORE);
+
+    int64_t start = (p1 > p0) ? table[1] : 0;
+    int64_t nBytes = (p1 > p0) ? table[3*(p1-p0-1)+1] + table[3*(p1-p0-1)+2] - start : 0;
+    if (nBytes > INT_MAX)
+      FatalError("Restart data read by one rank exceeds 2GB; use more ranks, or per-rank restart files [restartType 2].");
+
+    buf.resize(nBytes);
+    MPI_File_read_at_all(fh, start, buf.data(), (int)nBytes, MPI_BYTE, MPI_STATUS_IGNORE);
+    MPI_File_close(&fh);
+
+    for (int p=0; p<p1-p0; p++) {
+      const char *ptr = buf.data() + table[3*p+1] - start;
+      segs.push_back({ptr, ptr + table[3*p+2]});
+    }
+  }
+  else
+#endif
+  {
+    /* Memory-map the file(s), and read the records in place */
+    for (int p=p0; p<p1; p++) {
+      string partFile = shared ? fileName : getRestartFileName(params,iter,p);
+      int fd = open(partFile.c_str(), O_RDONLY);
+      if (fd < 0)
+        FatalError("Cannot open restart file.");
+
+      struct stat st;
+      fstat(fd, &st);
+      size_t mapSize = st.st_size;
+      if (mapSize < headerSize)
+        FatalError("Restart file is truncated.");
+
+      char *map = (char*)mmap(NULL, mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+      close(fd);
+      if (map == MAP_FAILED)
+        FatalError("Unable to memory-map restart file.");
+      maps.push_back({map, mapSize});
+
+      restartHeader partHeader;
+      memcpy(&partHeader, map, sizeof(partHeader));
+      if (!shared && partHeader.part != p)
+        FatalError("Per-rank restart file does not belong to this rank.");
+
+      int64_t table[3];  // nEles, offset, nBytes
+      memcpy(table, map + headerSize + 3*(shared ? p : 0)*sizeof(int64_t), sizeof(table));
+      if ((size_t)(table[1] + table[2]) > mapSize)
+        FatalError("Restart file is truncated.");
+
+      segs.push_back({map + table[1], map + table[1] + table[2]});
+    }
+  }
+
+  params->time = header.time;
+  params->rkTime = header.time;
+  if (params->adaptDt)
+    params->dt = header.dt;
+
+  if (rank == 0)
+    cout << "  Restart time = " << params->time << endl;
+
+  /* -- Set the geometry to the current restart time -- */
+  moveMesh(0);
+
+  /* --- Read each element's record --- */
+  int nFound = 0;
+  if (nParts == nproc || nproc == 1)
+    for (auto &seg:segs)
+      nFound += applyEleRecords(seg.first, seg.second);
+
+  int found = (nFound == (int)eles.size());
+#ifndef _NO_MPI
+  MPI_Allreduce(MPI_IN_PLACE, &found, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+
+  if (!found) {
+    if (rank == 0)
+      cout << "Solver: Redistributing restart data written by " << nParts << " ranks" << endl;
+
+    vector<char> recs;
+    redistributeEleRecords(segs, recs);
+    nFound = applyEleRecords(recs.data(), recs.data()+recs.size());
+    found = (nFound == (int)eles.size());
+  }
+#endif
+
+  for (auto &m:maps)
+    munmap(m.first, m.second);
+
+  if (!found)
+    FatalError("Restart file does not contain data for all elements on this rank.");
+
+  if (rank==0) cout << "Solver: Done reading restart file." << endl;
+}
+
+int solver::applyEleRecords(const char *ptr, const char *end)
+{
+  unordered_map<int,int> eleInd;
+  for (uint i=0; i<eles.size(); i++)
+    eleInd[eles[i]->IDg] = i;
+
+  int nFound = 0;
+  while (ptr < end) {
+    int info[4];  // IDg, eType, order, nSpts
+    memcpy(info, ptr, sizeof(info));
+    ptr += sizeof(info);
+
+    auto it = eleInd.find(info[0]);
+    if (it != eleInd.end()) {
+      auto &e = eles[it->second];
+      if (e->eType != info[1])
+        FatalError("Element type in restart file does not match the mesh.");
+      e->restart((const double*)ptr, info[2]);
+      nFound++;
+    }
+
+    ptr += (size_t)info[3]*params->nFields*sizeof(double);
+  }
+
+  return nFound;
+}
+
+#ifndef _NO_MPI
+void solver::redistributeEleRecords(const vector<pair<const char*,const char*>> &segs, vector<char> &recs)
+{
+  int nproc = params->nproc;
+  int nFields = params->nFields;
+
+  // The new owner of each element is found through a directory of the element
+  // IDs distributed over all ranks [ID % nproc], so no rank needs global data
+
+  /* --- Register our elements with the directory --- */
+  vector<vector<int>> sendIDs(nproc);
+  for (auto &e:eles)
+    sendIDs[e->IDg % nproc].push_back(e->IDg);
+
+  vector<int> recvCnts;
+  vector<int> regIDs = exchangeBuffers(sendIDs, recvCnts, MPI_COMM_WORLD, "Restart");
+
+  unordered_map<int,int> owner;
+  for (int p=0, i=0; p<nproc; p++)
+    for (int j=0; j<recvCnts[p]; j++)
+      owner[regIDs[i++]] = p;
+
+  /* --- Ask the directory for the owner of each of the records we read --- */
+  vector<vector<const char*>> recPtrs(nproc);
+  for (auto &seg:segs) {
+    for (const char *ptr = seg.first; ptr < seg.second; ) {
+      int info[4];  // IDg, eType, order, nSpts
+      memcpy(info, ptr, sizeof(info));
+      sendIDs[info[0] % nproc].push_back(info[0]);
+      recPtrs[info[0] % nproc].push_back(ptr);
+      ptr += sizeof(info) + (size_t)info[3]*nFields*sizeof(double);
+    }
+  }
+
+  vector<int> queryIDs = exchangeBuffers(sendIDs, recvCnts, MPI_COMM_WORLD, "Restart");
+
+  vector<vector<int>> replies(nproc);
+  for (int p=0, i=0; p<nproc; p++) {
+    for (int j=0; j<recvCnts[p]; j++, i++) {
+      auto it = owner.find(queryIDs[i]);
+      replies[p].push_back((it != owner.end()) ? it->second : -1);
+    }
+  }
+
+  vector<int> owners = exchangeBuffers(replies, recvCnts, MPI_COMM_WORLD, "Restart");
+
+  /* --- Send each record to its owner [records of elements no longer in the mesh are dropped] --- */
+  vector<vector<char>> sendRecs(nproc);
+  for (int p=0, i=0; p<nproc; p++) {
+    for (auto ptr:recPtrs[p]) {
+      int dest = owners[i++];
+      if (dest < 0) continue;
+
+      int info[4];
+      memcpy(info, ptr, sizeof(info));
+      size_t nBytes = sizeof(info) + (size_t)info[3]*nFields*sizeof(double);
+      sendRecs[dest].insert(sendRecs[dest].end(), ptr, ptr+nBytes);
+    }
+  }
+
+  recs = exchangeBuffers(sendRecs, recvCnts, MPI_COMM_WORLD, "Restart");
+}
+#endif
+
 void solver::initializeSolution(bool PMG)
 {
   if (params->rank==0) cout << "Solver: Initializing Solution... " << flush;
@@ -839,14 +2245,20 @@ void solver::initializeSolution(bool PMG)
 
   }
 
+  finishSolutionSetup();
+
+  if (params->rank == 0) cout << "done." << endl;
+}
+
+void solver::finishSolutionSetup(void)
+{
   if (params->meshType == OVERSET_MESH && params->motion == 0) {
     // Perform initial LGP to setup connectivity / arrays for remainder of computations [Field-interp method]
     if (params->projection) {
       OComm->matchUnblankCells(eles,Geo->fringeCells,Geo->eleMap,params->quadOrder);
       OComm->performGalerkinProjection(eles,opers,Geo->eleMap,order);
     } else {
-      if (params->nDims==2)
-        getBoundingBox(Geo->xv,Geo->minPt,Geo->maxPt);
+      getBoundingBox(Geo->xv,Geo->minPt,Geo->maxPt);
       OComm->setupFringeCellPoints(eles,Geo->fringeCells,Geo->eleMap);
       OComm->matchOversetPoints(eles,Geo->eleMap,Geo->minPt,Geo->maxPt);
       OComm->exchangeOversetData(eles,opers,Geo->eleMap);
@@ -863,10 +2275,39 @@ void solver::initializeSolution(bool PMG)
     }
   }
 
-  if (params->rank == 0) cout << "done." << endl;
+#ifdef _GPU
+  /* Hand the solution over to the GPU for the rest of the run */
+  if (params->gpu) {
+    device = make_shared<deviceBackend>();
+    device->setup(params,this);
+  }
+#endif
+}
+
+void solver::syncHost(void)
+{
+#ifdef _GPU
+  if (params->gpu)
+    device->syncHost();
+#endif
 }
 
 vector<double> solver::integrateError(void)
+{
+  auto LpErr = integrateErrorLocal();
+
+#ifndef _NO_MPI
+  vector<double> tmpErr = LpErr;
+  MPI_Allreduce(tmpErr.data(), LpErr.data(), params->nFields, MPI_DOUBLE, MPI_SUM, Geo->gridComm);
+#endif
+
+  if (params->errorNorm==2)
+    for (auto &val:LpErr) val = std::sqrt(std::abs(val));
+
+  return LpErr;
+}
+
+vector<double> solver::integrateErrorLocal(void)
 {
   int quadOrder = params->quadOrder;
 
@@ -881,36 +2322,92 @@ vector<double> solver::integrateError(void)
   matrix<double> quadPoints;
   for (auto &pt: qpts) quadPoints.insertRow({pt.x,pt.y,pt.z});
 
-  vector<double> LpErr(params->nFields);
-  matrix<double> U_qpts;
-  vector<double> detJac_qpts;
-  for (uint ic=0; ic<eles.size(); ic++) {
-    //if (params->meshType == OVERSET_MESH and Geo->iblankCell[eles[ic]->ID]!=NORMAL) continue;
-    opers[eles[ic]->eType][eles[ic]->order].interpolateSptsToPoints(eles[ic]->U_spts, U_qpts, quadPoints);
-    opers[eles[ic]->eType][eles[ic]->order].interpolateSptsToPoints(eles[ic]->detJac_spts, detJac_qpts, quadPoints);
-    for (uint i=0; i<qpts.size(); i++) {
-      auto tmpErr = calcError(U_qpts.getRow(i), eles[ic]->calcPos(qpts[i]), params);
-      for (int j=0; j<params->nFields; j++)
-        LpErr[j] += tmpErr[j] * wts[i] * detJac_qpts[i];
+  int nFields = params->nFields;
+  vector<double> LpErr(nFields);
+  double *err = LpErr.data();
+
+#pragma omp parallel
+  {
+    matrix<double> U_qpts;
+    vector<double> detJac_qpts;
+
+#pragma omp for reduction(+:err[:nFields])
+    for (uint ic=0; ic<eles.size(); ic++) {
+      //if (params->meshType == OVERSET_MESH and Geo->iblankCell[eles[ic]->ID]!=NORMAL) continue;
+      opers[eles[ic]->eType][eles[ic]->order].interpolateSptsToPoints(eles[ic]->U_spts, U_qpts, quadPoints);
+      opers[eles[ic]->eType][eles[ic]->order].interpolateSptsToPoints(eles[ic]->detJac_spts, detJac_qpts, quadPoints);
+      for (uint i=0; i<qpts.size(); i++) {
+        auto tmpErr = calcError(U_qpts.getRow(i), eles[ic]->calcPos(qpts[i]), params);
+        for (int j=0; j<nFields; j++)
+          err[j] += tmpErr[j] * wts[i] * detJac_qpts[i];
+      }
     }
   }
 
-#ifndef _NO_MPI
-  vector<double> tmpErr = LpErr;
-  MPI_Allreduce(tmpErr.data(), LpErr.data(), params->nFields, MPI_DOUBLE, MPI_SUM, Geo->gridComm);
-#endif
-
-  if (params->errorNorm==2)
-    for (auto &val:LpErr) val = std::sqrt(std::abs(val));
-
   return LpErr;
 }
 
 // Method for shock capturing
 void solver::shockCapture(void)
 {
+  PROFILE("shockCapture");
+
+  int nEles = eles.size();
+
+  bool sweep = (params->scSensorFreq <= 1 || (int)isListed.size() != nEles ||
+                (params->iter != scSweepIter && params->iter % params->scSensorFreq == 0));
+
+  if (sweep) {
+    troubledEles.resize(nEles);
+    for (int i=0; i<nEles; i++) troubledEles[i] = i;
+    scSweepIter = params->iter;
+  }
+
+  int nSense = troubledEles.size();
 #pragma omp parallel for
-  for (uint i=0; i<eles.size(); i++) {
-    eles[i]->sensor = opers[eles[i]->eType][eles[i]->order].shockCaptureInEle(eles[i]->U_spts,params->threshold);
+  for (int n=0; n<nSense; n++) {
+    auto &e = eles[troubledEles[n]];
+    e->sensor = opers[e->eType][e->order].shockSensor(e->U_spts);
+  }
+
+  troubled.clear();
+  for (int n=0; n<nSense; n++)
+    if (eles[troubledEles[n]]->sensor >= params->threshold)
+      troubled.push_back(troubledEles[n]);
+
+  // Filter all of the troubled elements of each type & order at once
+  for (auto &eType:opers) {
+    for (auto &order:eType.second) {
+      filterU.clear();
+      for (auto ie:troubled)
+        if (eles[ie]->eType == eType.first && eles[ie]->order == order.first)
+          filterU.push_back(&eles[ie]->U_spts);
+      order.second.applyFilter(filterU);
+    }
+  }
+
+  if (params->scSensorFreq <= 1) return;
+
+  // Update the list: troubled elements & their face neighbours [only added to
+  // between sweeps, so that a moving discontinuity stays inside the list]
+  if (sweep) {
+    troubledEles.clear();
+    isListed.assign(nEles,0);
+  }
+
+  auto addEle = [&](int ie) {
+    if (ie >= 0 && !isListed[ie]) {
+      isListed[ie] = 1;
+      troubledEles.push_back(ie);
+    }
+  };
+
+  for (auto ie:troubled) {
+    addEle(ie);
+    int ic = eles[ie]->ID;
+    for (int j=0; j<Geo->c2nf[ic]; j++) {
+      int ic2 = Geo->c2c(ic,j);
+      if (ic2 >= 0) addEle(Geo->eleMap[ic2]);
+    }
   }
 }
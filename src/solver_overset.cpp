@@ -33,6 +33,8 @@
 
 void solver::oversetFieldInterp(void)
 {
+  PROFILE("oversetFieldInterp");
+
 #ifndef _NO_MPI
   if (params->motion) return;  // For moving problems, projection done in moveMesh()
 
@@ -40,7 +42,15 @@ void solver::oversetFieldInterp(void)
   if (params->projection)
     OComm->performProjection_static(eles,Geo->eleMap,order);
   else {
-    OComm->exchangeOversetData(eles,opers,Geo->eleMap);
+    if (params->multirate && !fringeSync[0]) {
+      OComm->extrapolateFringeData(params->rkTime,false);
+    } else {
+      OComm->exchangeOversetData(eles,opers,Geo->eleMap);
+      if (params->multirate) {
+        OComm->storeFringeData(params->rkTime,false);
+        fringeSync[0] = false;
+      }
+    }
     OComm->transferEleData(eles,Geo->fringeCells,Geo->eleMap);
   }
 #endif
@@ -48,19 +58,44 @@ void solver::oversetFieldInterp(void)
 
 void solver::oversetInterp(void)
 {
+  PROFILE("oversetInterp");
+
 #ifndef _NO_MPI
   if (params->oversetMethod == 2) return;
 
+  // Multirate: exchange at the start of each macro step only, then extrapolate in time
+  if (params->multirate && !fringeSync[0]) {
+    OComm->extrapolateFringeData(params->rkTime,false);
+    return;
+  }
+
   OComm->exchangeOversetData(eles,opers,Geo->eleMap);
+
+  if (params->multirate) {
+    OComm->storeFringeData(params->rkTime,false);
+    fringeSync[0] = false;
+  }
 #endif
 }
 
 void solver::oversetInterp_gradient(void)
 {
+  PROFILE("oversetInterp_gradient");
+
 #ifndef _NO_MPI
   if (params->oversetMethod == 2) return;
 
+  if (params->multirate && !fringeSync[1]) {
+    OComm->extrapolateFringeData(params->rkTime,true);
+    return;
+  }
+
   OComm->exchangeOversetGradient(eles,opers,Geo->eleMap);
+
+  if (params->multirate) {
+    OComm->storeFringeData(params->rkTime,true);
+    fringeSync[1] = false;
+  }
 #endif
 }
 
@@ -78,10 +113,13 @@ void solver::setupOverset(void)
   }
   else {
     OComm = Geo->OComm;
-
-    getBoundingBox(Geo->xv,Geo->minPt,Geo->maxPt);
   }
 
+  OComm->c2c = &Geo->c2c;
+
+  // Partition bounding box, used to route fringe points to candidate donor ranks
+  getBoundingBox(Geo->xv,Geo->minPt,Geo->maxPt);
+
   if (params->oversetMethod == 2 && !params->projection) {
     OComm->setupFringeCellPoints(eles,Geo->fringeCells,Geo->eleMap);
   } else if (params->oversetMethod != 2) {
@@ -105,27 +143,25 @@ void solver::setupOversetData(void)
 {
   // Allocate storage for global solution vector (for use with Tioga)
   // and initialize to 0
-  int nSptsTotal = 0;
-  for (uint i=0; i<eles.size(); i++) nSptsTotal += eles[i]->getNSpts();
-  U_spts.assign(nSptsTotal*params->nFields,0);
+  sptStart.resize(eles.size()+1);
+  sptStart[0] = 0;
+  for (uint i=0; i<eles.size(); i++)
+    sptStart[i+1] = sptStart[i] + eles[i]->getNSpts();
+  U_spts.assign(sptStart.back()*params->nFields,0);
 }
 
 void solver::setGlobalSolutionArray(void)
 {
-  int ind = 0;
-  for (uint i=0; i<eles.size(); i++) {
-    eles[i]->getUSpts(&U_spts[ind]);
-    ind += eles[i]->getNSpts() * params->nFields;
-  }
+#pragma omp parallel for
+  for (uint i=0; i<eles.size(); i++)
+    eles[i]->getUSpts(&U_spts[sptStart[i]*params->nFields]);
 }
 
 void solver::updateElesSolutionArrays(void)
 {
-  int ind = 0;
-  for (uint i=0; i<eles.size(); i++) {
-    eles[i]->setUSpts(&U_spts[ind]);
-    ind += eles[i]->getNSpts() * params->nFields;
-  }
+#pragma omp parallel for
+  for (uint i=0; i<eles.size(); i++)
+    eles[i]->setUSpts(&U_spts[sptStart[i]*params->nFields]);
 }
 
 void solver::callDataUpdateTIOGA(void)
@@ -163,15 +199,12 @@ void solver::donorWeights(int* cellID, double* xyz, int* nWeights, int* iNode, d
 {
   int ic = *cellID;
 
-  // Get starting offset for global solution-point index
-  int iStart = 0;
-  for (int i=0; i<ic; i++)
-    iStart += eles[i]->getNSpts();
-
   // Put the global indices of ele's spts into inode array
   (*nWeights) = eles[ic]->getNSpts();
+  if ((*nWeights) > (*fracSize))
+    FatalError("Too many solution points in donor cell for TIOGA's weight arrays [NFRAC].");
   for (int i=0; i<(*nWeights); i++)
-    iNode[i] = iStart + i;
+    iNode[i] = sptStart[ic] + i;
 
   opers[eles[ic]->eType][eles[ic]->order].getBasisValues(rst,weights);
 }
@@ -188,7 +221,6 @@ void solver::convertToModal(int* cellID, int* nPtsIn, double* uIn, int* nPtsOut,
   uOut = uIn;
 
   // Get starting offset for global solution-point index
-  *iStart = 0;
-  for (int i=0; i<ic; i++)
-    *iStart += eles[i]->getNSpts();
+  *iStart = sptStart[ic];
 }
+
@@ -0,0 +1,304 @@
+/*!
+ * \file statistics.cpp
+ * \brief Class for in-situ accumulation of flow statistics
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "statistics.hpp"
+
+#include <cstring>
+#include <iomanip>
+#include <unordered_map>
+
+#include <sys/stat.h>
+
+#ifndef _NO_MPI
+#include <mpi.h>
+#endif
+
+void statistics::setup(input *params, solver *Solver)
+{
+  this->params = params;
+  this->Solver = Solver;
+
+  int nFields = params->nFields;
+  int nDims = params->nDims;
+  nStats = 2*nFields;
+  if (params->equation == NAVIER_STOKES)
+    nStats += nDims*(nDims-1)/2;
+
+  eleStats.resize(Solver->eles.size());
+  for (uint i=0; i<Solver->eles.size(); i++) {
+    eleStats[i].setup(Solver->eles[i]->nSpts,nStats);
+    eleStats[i].initializeToZero();
+  }
+
+  for (int i=0; i<6; i++) {
+    wallMean[i] = 0;
+    wallSq[i] = 0;
+  }
+
+  if (params->restart && read() && params->rank == 0)
+    cout << "Statistics: Continuing the averages of " << nSamples << " samples over a time of " << tAvg << endl;
+}
+
+void statistics::accumulate(void)
+{
+  int iter = params->iter;
+  if (iter < params->statsStart || iter%params->statsFreq != 0) return;
+
+  // Each sample stands for the time since the previous one
+  if (tLast < 0) {
+    tLast = params->time;
+    return;
+  }
+
+  double w = params->time - tLast;
+  if (w <= 0) return;
+
+  tLast = params->time;
+  tAvg += w;
+  nSamples++;
+  double frac = w / tAvg;
+
+  Solver->syncHost();
+
+  int nFields = params->nFields;
+  int nDims = params->nDims;
+  bool products = (params->equation == NAVIER_STOKES);
+
+#pragma omp parallel
+  {
+    vector<double> V(nFields);
+
+#pragma omp for
+    for (uint i=0; i<Solver->eles.size(); i++) {
+      auto &e = Solver->eles[i];
+      auto &S = eleStats[i];
+      for (int spt=0; spt<e->nSpts; spt++) {
+        e->getPrimitives(spt,V.data());
+
+        double *s = S[spt];
+        for (int k=0; k<nFields; k++) {
+          s[k] += frac*(V[k] - s[k]);
+          s[nFields+k] += frac*(V[k]*V[k] - s[nFields+k]);
+        }
+
+        if (products) {
+          int n = 2*nFields;
+          for (int d1=0; d1<nDims; d1++) {
+            for (int d2=d1+1; d2<nDims; d2++) {
+              s[n] += frac*(V[1+d1]*V[1+d2] - s[n]);
+              n++;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (params->equation != NAVIER_STOKES) return;
+
+  auto force = Solver->computeWallForce();
+#ifndef _NO_MPI
+  MPI_Allreduce(MPI_IN_PLACE, force.data(), 6, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+#endif
+
+  for (int i=0; i<6; i++) {
+    wallMean[i] += frac*(force[i] - wallMean[i]);
+    wallSq[i] += frac*(force[i]*force[i] - wallSq[i]);
+  }
+}
+
+string statistics::getFileName(int iter, int rank)
+{
+  char fileNameC[256];
+  string fileName = params->dataFileName;
+
+#ifndef _NO_MPI
+  sprintf(fileNameC,"%s_%.09d/%s_%.09d_%d.stats",&fileName[0],iter,&fileName[0],iter,rank);
+#else
+  sprintf(fileNameC,"%s_%.09d_%d.stats",&fileName[0],iter,rank);
+#endif
+
+  return string(fileNameC);
+}
+
+void statistics::write(void)
+{
+  PROFILE("writeStatistics");
+
+  int iter = params->iter;
+  int nDims = params->nDims;
+
+  if (params->rank == 0)
+    cout << "Writing statistics file " << getFileName(iter,0) << "...  " << flush;
+
+#ifndef _NO_MPI
+  if (params->rank == 0) {
+    char datadirC[256];
+    sprintf(datadirC,"%s_%.09d",&params->dataFileName[0],iter);
+    struct stat st = {0};
+    if (stat(datadirC, &st) == -1)
+      mkdir(datadirC, 0755);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+#endif
+
+  statsHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, "FLURRYST", 8);
+  header.version = 1;
+  header.nDims = nDims;
+  header.nStats = nStats;
+  header.part = params->rank;
+  header.iter = iter;
+  header.nSamples = nSamples;
+  header.time = params->time;
+  header.tAvg = tAvg;
+  memcpy(header.wallMean, wallMean, sizeof(wallMean));
+  memcpy(header.wallSq, wallSq, sizeof(wallSq));
+
+  ofstream dataFile(getFileName(iter,params->rank), ios::binary | ios::trunc);
+  if (!dataFile.is_open())
+    FatalError("Unable to open statistics file for writing.");
+
+  int64_t nEles = Solver->eles.size();
+  dataFile.write((char*)&header, sizeof(header));
+  dataFile.write((char*)&nEles, sizeof(nEles));
+  for (uint i=0; i<Solver->eles.size(); i++) {
+    auto &e = Solver->eles[i];
+    int info[4] = {e->IDg, e->eType, e->order, e->nSpts};
+    dataFile.write((char*)info, sizeof(info));
+    dataFile.write((char*)eleStats[i].getData(), e->nSpts*nStats*sizeof(double));
+  }
+  dataFile.close();
+
+  /* --- Mean & RMS fluctuation of the wall force [one line per checkpoint] --- */
+  if (params->rank == 0 && params->equation == NAVIER_STOKES) {
+    string fileName = params->dataFileName + "_wallStats.dat";
+    ifstream test(fileName.c_str());
+    bool isNew = (!test.good() || test.peek() == EOF);
+    test.close();
+
+    ofstream wallFile(fileName.c_str(), ofstream::app);
+
+    int colW = 16;
+    wallFile.precision(8);
+    wallFile.setf(ios::scientific, ios::floatfield);
+
+    const char xyz[] = "xyz";
+    if (isNew) {
+      wallFile << setw(8) << left << "Iter" << setw(colW) << left << "Time";
+      wallFile << setw(colW) << left << "AvgTime" << setw(colW) << left << "Samples";
+      for (string type : {"Finv", "Fvis"})
+        for (int dim=0; dim<nDims; dim++)
+          wallFile << setw(colW) << left << "mean_" + type + xyz[dim];
+      for (string type : {"Finv", "Fvis"})
+        for (int dim=0; dim<nDims; dim++)
+          wallFile << setw(colW) << left << "rms_" + type + xyz[dim];
+      wallFile << endl;
+    }
+
+    wallFile << setw(8) << left << iter << setw(colW) << left << params->time;
+    wallFile << setw(colW) << left << tAvg << setw(colW) << left << nSamples;
+    for (int i=0; i<2; i++)
+      for (int dim=0; dim<nDims; dim++)
+        wallFile << setw(colW) << left << wallMean[3*i+dim];
+    for (int i=0; i<2; i++) {
+      for (int dim=0; dim<nDims; dim++) {
+        double mean = wallMean[3*i+dim];
+        wallFile << setw(colW) << left << sqrt(max(wallSq[3*i+dim] - mean*mean, 0.));
+      }
+    }
+    wallFile << endl;
+    wallFile.close();
+  }
+
+  if (params->rank == 0)
+    cout << "done." << endl;
+}
+
+bool statistics::read(void)
+{
+  string fileName = getFileName(params->restartIter,params->rank);
+  ifstream dataFile(fileName.c_str(), ios::in | ios::binary);
+
+  int found = dataFile.is_open();
+#ifndef _NO_MPI
+  MPI_Allreduce(MPI_IN_PLACE, &found, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+
+  if (!found) {
+    if (params->rank == 0)
+      cout << "Statistics: No statistics file for the restart iteration; starting new averages." << endl;
+    return false;
+  }
+
+  statsHeader header;
+  int64_t nEles = 0;
+  dataFile.read((char*)&header, sizeof(header));
+  dataFile.read((char*)&nEles, sizeof(nEles));
+
+  if (strncmp(header.magic, "FLURRYST", 8) != 0 || header.version != 1)
+    FatalError("Not a Flurry statistics file.");
+
+  if (header.nDims != params->nDims || header.nStats != nStats || header.part != params->rank)
+    FatalError("Statistics file does not match this run [the same equations & # of ranks are required].");
+
+  unordered_map<int,int> eleInd;
+  for (uint i=0; i<Solver->eles.size(); i++)
+    eleInd[Solver->eles[i]->IDg] = i;
+
+  uint nFound = 0;
+  vector<double> vals;
+  for (int64_t n=0; n<nEles; n++) {
+    int info[4];  // IDg, eType, order, nSpts
+    dataFile.read((char*)info, sizeof(info));
+    vals.resize(info[3]*nStats);
+    dataFile.read((char*)vals.data(), vals.size()*sizeof(double));
+
+    auto it = eleInd.find(info[0]);
+    if (it == eleInd.end()) continue;
+
+    auto &e = Solver->eles[it->second];
+    if (e->eType != info[1] || e->order != info[2])
+      FatalError("Element in statistics file does not match the mesh.");
+
+    memcpy(eleStats[it->second].getData(), vals.data(), vals.size()*sizeof(double));
+    nFound++;
+  }
+
+  if (!dataFile.good() || nFound != Solver->eles.size())
+    FatalError("Statistics file does not contain data for all elements on this rank.");
+
+  nSamples = header.nSamples;
+  tAvg = header.tAvg;
+  tLast = header.time;
+  memcpy(wallMean, header.wallMean, sizeof(wallMean));
+  memcpy(wallSq, header.wallSq, sizeof(wallSq));
+
+  return true;
+}
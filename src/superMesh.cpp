@@ -80,6 +80,12 @@ superMesh::~superMesh()
 
 }
 
+size_t superMesh::getMemUsage(void) const
+{
+  return sizeof(superMesh) + memBytes(target, donors, faces, normals, qpts, weights, shapeQpts)
+      + memBytes(tets, tris, parents, vol, qptsPhys);
+}
+
 void superMesh::setup(vector<point> &_target, Array2D<point> &_donors, int _order, int _nDims)
 {
   target = _target;
@@ -104,16 +110,21 @@ void superMesh::buildSuperMesh(void)
 
 void superMesh::buildSuperMeshTri(void)
 {
-  // Step 1: Split the donor hexahedrons into triangles to prepare for clipping
-  tris.resize(0);
-  parents.resize(0);
+  // Scratch buffers for the clipping passes, reused from one supermesh to
+  // the next [one set per thread] so that clipping needn't allocate
+  static thread_local vector<triangle> trisA, trisB;
+  static thread_local vector<int> parentsA, parentsB;
+
+  // Step 1: Split the donor quadrilaterals into triangles to prepare for clipping
+  trisA.clear();
+  parentsA.clear();
   for (int i=0; i<nDonors; i++) {
-    auto tmpTris = splitQuadIntoTris(donors.getRow(i));
-    tris.insert(tris.end(),tmpTris.begin(),tmpTris.end());
-    parents.insert(parents.end(),tmpTris.size(),i);
+    splitQuadIntoTris(&donors(i,0),trisA);
+    parentsA.resize(trisA.size(),i);
   }
 
   // Step 2: Get the clipping planes from the target-cell faces
+  faces.setup(0,0);
   normals.resize(4);
 
   point xc;
@@ -137,34 +148,43 @@ void superMesh::buildSuperMeshTri(void)
   faces.insertRow(facePts);
   normals[3] = getEdgeNormal(facePts,xc);
 
-  // Step 3: Use the faces to clip the tets
+  // Step 3: Use the faces to clip the tris
   for (uint i=0; i<faces.getDim0(); i++) {
-    vector<triangle> newTris;
-    vector<int> newParents;
-    for (uint j=0; j<tris.size(); j++) {
-      triangle tri = tris[j];
-      auto tmpTris = clipTri(tri, faces.getRow(i), normals[i]);
-
-      newTris.insert(newTris.end(),tmpTris.begin(),tmpTris.end());
-      newParents.insert(newParents.end(),tmpTris.size(),parents[j]);
+    point fc = faces(i,0);
+    fc += faces(i,1);
+    fc /= 2.;
+
+    trisB.clear();
+    parentsB.clear();
+    for (uint j=0; j<trisA.size(); j++) {
+      clipTri(trisA[j], fc, normals[i], trisB);
+      parentsB.resize(trisB.size(),parentsA[j]);
     }
-    tris = newTris;
-    parents = newParents;
+    trisA.swap(trisB);
+    parentsA.swap(parentsB);
   }
+
+  tris.assign(trisA.begin(),trisA.end());
+  parents.assign(parentsA.begin(),parentsA.end());
 }
 
 void superMesh::buildSuperMeshTet(void)
 {
+  // Scratch buffers for the clipping passes, reused from one supermesh to
+  // the next [one set per thread] so that clipping needn't allocate
+  static thread_local vector<tetra> tetsA, tetsB;
+  static thread_local vector<int> parentsA, parentsB;
+
   // Step 1: Split the donor hexahedrons into tets to prepare for clipping
-  tets.resize(0);
-  parents.resize(0);
+  tetsA.clear();
+  parentsA.clear();
   for (int i=0; i<nDonors; i++) {
-    auto tmpTets = splitHexIntoTets(donors.getRow(i));
-    tets.insert(tets.end(),tmpTets.begin(),tmpTets.end());
-    parents.insert(parents.end(),tmpTets.size(),i);
+    splitHexIntoTets(&donors(i,0),tetsA);
+    parentsA.resize(tetsA.size(),i);
   }
 
   // Step 2: Get the clipping planes from the target-cell faces
+  faces.setup(0,0);
   normals.resize(6); // Consider slightly-more-accurate approach of splitting faces into tris instead (12 faces)
 
   point xc;
@@ -198,17 +218,40 @@ void superMesh::buildSuperMeshTet(void)
 
   // Step 3: Use the faces to clip the tets
   for (uint i=0; i<faces.getDim0(); i++) {
-    vector<tetra> newTets;
-    vector<int> newParents;
-    for (uint j=0; j<tets.size(); j++) {
-      tetra tet = tets[j];
-      auto tmpTets = clipTet(tet, faces.getRow(i), normals[i]);
-      newTets.insert(newTets.end(),tmpTets.begin(),tmpTets.end());
-      newParents.insert(newParents.end(),tmpTets.size(),parents[j]);
+    point fc;
+    for (int j=0; j<4; j++)
+      fc += faces(i,j);
+    fc /= 4.;
+
+    tetsB.clear();
+    parentsB.clear();
+    for (uint j=0; j<tetsA.size(); j++) {
+      clipTet(tetsA[j], fc, normals[i], tetsB);
+      parentsB.resize(tetsB.size(),parentsA[j]);
     }
-    tets = newTets;
-    parents = newParents;
+    tetsA.swap(tetsB);
+    parentsA.swap(parentsB);
   }
+
+  tets.assign(tetsA.begin(),tetsA.end());
+  parents.assign(parentsA.begin(),parentsA.end());
+}
+
+bool superMesh::hasInputs(const vector<point> &_target, Array2D<point> &_donors)
+{
+  if (_target.size() != target.size() || _donors.getDim0() != donors.getDim0() || _donors.getDim1() != donors.getDim1())
+    return false;
+
+  for (uint i=0; i<target.size(); i++)
+    for (int dim=0; dim<3; dim++)
+      if (_target[i][dim] != target[i][dim]) return false;
+
+  for (uint i=0; i<donors.getDim0(); i++)
+    for (uint j=0; j<donors.getDim1(); j++)
+      for (int dim=0; dim<3; dim++)
+        if (_donors(i,j)[dim] != donors(i,j)[dim]) return false;
+
+  return true;
 }
 
 double superMesh::integrate(const vector<double> &data)
@@ -297,25 +340,24 @@ void superMesh::setupQuadrature(void)
       shape_tet(qpts[i],shapeQpts[i]);
   }
 
-  vol.resize(0);
+  vol.resize(nSimps);
+  qptsPhys.assign(nQpts,point());
 
   if (nDims==2) {
-    for (auto &tri:tris) {
-      vol.push_back(getAreaTri(tri.nodes));
-      tri.qpts.resize(nQpts_simp);
+    for (int i=0; i<nSimps; i++) {
+      vol[i] = getAreaTri(tris[i].nodes);
       for (int j=0; j<nQpts_simp; j++) {
         for (int k=0; k<nv_simp; k++) {
-          tri.qpts[j] += tri.nodes[k]*shapeQpts(j,k);
+          qptsPhys[i*nQpts_simp+j] += tris[i].nodes[k]*shapeQpts(j,k);
         }
       }
     }
   } else {
-    for (auto &tet:tets) {
-      vol.push_back(getVolumeTet(tet.nodes));
-      tet.qpts.resize(nQpts_simp);
+    for (int i=0; i<nSimps; i++) {
+      vol[i] = getVolumeTet(tets[i].nodes);
       for (int j=0; j<nQpts_simp; j++) {
         for (int k=0; k<nv_simp; k++) {
-          tet.qpts[j] += tet.nodes[k]*shapeQpts(j,k);
+          qptsPhys[i*nQpts_simp+j] += tets[i].nodes[k]*shapeQpts(j,k);
         }
       }
     }
@@ -324,42 +366,24 @@ void superMesh::setupQuadrature(void)
 
 void superMesh::getQpts(vector<point> &qptPos, vector<int> &qptCell)
 {
-  qptPos.resize(0);
-  qptCell.resize(0);
-  if (nDims == 2) {
-    for (int i=0; i<nSimps; i++) {
-      for (int j=0; j<nQpts_simp; j++) {
-        qptPos.push_back(tris[i].qpts[j]);
-        qptCell.push_back(parents[i]);
-      }
-    }
-  } else {
-    for (int i=0; i<nSimps; i++) {
-      for (int j=0; j<nQpts_simp; j++) {
-        qptPos.push_back(tets[i].qpts[j]);
-        qptCell.push_back(parents[i]);
-      }
-    }
-  }
+  qptPos = qptsPhys;
+  qptCell.resize(nQpts);
+  for (int i=0; i<nSimps; i++)
+    for (int j=0; j<nQpts_simp; j++)
+      qptCell[i*nQpts_simp+j] = parents[i];
 }
 
 void superMesh::getQpts(matrix<double> &qptPos, vector<int> &qptCell)
 {
-  qptPos.setup(0,0);
-  qptCell.resize(0);
-  if (nDims == 2) {
-    for (int i=0; i<nSimps; i++) {
-      for (int j=0; j<nQpts_simp; j++) {
-        qptPos.insertRow({tris[i].qpts[j].x,tris[i].qpts[j].y,0.});
-        qptCell.push_back(parents[i]);
-      }
-    }
-  } else {
-    for (int i=0; i<nSimps; i++) {
-      for (int j=0; j<nQpts_simp; j++) {
-        qptPos.insertRow({tets[i].qpts[j].x,tets[i].qpts[j].y,tets[i].qpts[j].z});
-        qptCell.push_back(parents[i]);
-      }
+  qptPos.setup(nQpts,3);
+  qptCell.resize(nQpts);
+  for (int i=0; i<nSimps; i++) {
+    for (int j=0; j<nQpts_simp; j++) {
+      int iq = i*nQpts_simp+j;
+      qptPos(iq,0) = qptsPhys[iq].x;
+      qptPos(iq,1) = qptsPhys[iq].y;
+      qptPos(iq,2) = (nDims == 2) ? 0. : qptsPhys[iq].z;
+      qptCell[iq] = parents[i];
     }
   }
 }
@@ -418,54 +442,59 @@ void superMesh::printQuadPoints(vector<double> &vals)
   for (int i=0; i<tris.size(); i++) {
     int id = parents[i];
     for (int j=0; j<nQpts_simp; j++) {
-      point pt = tris[i].qpts[j];
+      point pt = qptsPhys[i*nQpts_simp+j];
       mesh << id << "," << i << "," << vals[i*nQpts_simp+j] << "," << pt.x << "," << pt.y << endl;
     }
   }
   mesh.close();
 }
 
-vector<tetra> splitHexIntoTets(const vector<point> &hexNodes)
+void splitHexIntoTets(const point *hexNodes, vector<tetra> &outTets)
 {
-  vector<tetra> newTets(5);
-
-  short ind[5][4] = {{0,1,4,3},{2,1,6,3},{5,1,6,4},{7,3,4,6},{1,3,6,4}};
+  static const short ind[5][4] = {{0,1,4,3},{2,1,6,3},{5,1,6,4},{7,3,4,6},{1,3,6,4}};
 
-  for (short i=0; i<5; i++)
+  tetra tet;
+  for (short i=0; i<5; i++) {
     for (short j=0; j<4; j++)
-      newTets[i].nodes[j] = hexNodes[ind[i][j]];
+      tet.nodes[j] = hexNodes[ind[i][j]];
+    outTets.push_back(tet);
+  }
+}
 
-  return newTets;
+//! Intersection of the edge a-b with the plane through xc with normal norm
+static inline point intersectEdge(point a, point b, point xc, Vec3 norm)
+{
+  Vec3 ab = b - a;
+  Vec3 ac = xc - a;
+  return ab*((norm*ac)/(norm*ab)) + a;
 }
 
-vector<tetra> clipTet(tetra &tet, const vector<point> &clipFace, Vec3 &norm)
+void clipTet(const tetra &tet, const point &xc, const Vec3 &norm, vector<tetra> &outTets)
 {
   /* --- WARNING: Assuming a linear, planar face --- */
 
-  vector<tetra> outTets;
-
-  // Get face centroid
-  point xc;
-  for (auto &pt:clipFace)
-    xc += pt;
-  xc /= clipFace.size();
-
-  set<int> deadPts;
+  // Check each point of tetra to see which must be removed [bit i set if
+  // point i lies on the cut side of the clipping plane]
+  int dead = 0, nDead = 0;
   for (int i=0; i<4; i++) {
-    // Check each point of tetra to see which must be removed
-    Vec3 dx = tet.nodes[i] - xc;
-    double dot = dx*norm;
-    if (dot > 0) // Point lies on cut-side of clipping plane
-      deadPts.insert(i);
+    point pt = tet.nodes[i];
+    Vec3 dx = pt - xc;
+    if (dx*norm > 0) {
+      dead |= (1 << i);
+      nDead++;
+    }
   }
 
+  // Orientation-preserving orderings of the other 3 nodes for each node
+  static const int flipTet1[4][3] = {{1,3,2},{0,2,3},{0,3,1},{0,1,2}};
+
   /*
    * Perform the clipping and subdivide the new volume into new tets
    * Only 3 cases in which the clipping can occur
    * New points are created at the intersections of the original tet's edges
    * with the clipping plane: http://geomalgorithms.com/a05-_intersect-1.html
    */
-  switch (deadPts.size()) {
+  switch (nDead) {
     case 0: {
       // No intersection
       outTets.push_back(tet);
@@ -474,122 +503,75 @@ vector<tetra> clipTet(tetra &tet, const vector<point> &clipFace, Vec3 &norm)
 
     case 1: {
       // Remove 1 point to get a prism; split prism into 3 new tets
-      int kill = *(deadPts.begin());  // The point to remove
+      int kill = 0;  // The point to remove
+      while (!(dead & (1 << kill))) kill++;
 
       // Get the new points by intersecting the tet's edges with the clipping plane
       // Have to be careful about orientation of final tet
-      map<int,array<int,3>> flipTet;
-      flipTet[0] = {{1,3,2}};  flipTet[1] = {{0,2,3}};
-      flipTet[2] = {{0,3,1}};  flipTet[3] = {{0,1,2}};
-      array<int,3> ePts = flipTet[kill];
+      const int *ePts = flipTet1[kill];
 
       // Find the intersection points
       array<point,3> newPts;
-      for (int i=0; i<3; i++) {
-        Vec3 ab = tet.nodes[ePts[i]] - tet.nodes[kill];
-        Vec3 ac = xc - tet.nodes[kill];
-        newPts[i] = ab*((norm*ac)/(norm*ab)) + tet.nodes[kill];
-      }
-
-      outTets.resize(3);
-      outTets[0].nodes = {{tet.nodes[ePts[0]], tet.nodes[ePts[1]], newPts[0], tet.nodes[ePts[2]]}};
-      outTets[1].nodes = {{tet.nodes[ePts[2]], newPts[0], newPts[2], newPts[1]}};
-      outTets[2].nodes = {{tet.nodes[ePts[1]], tet.nodes[ePts[2]], newPts[1],newPts[0]}};
+      for (int i=0; i<3; i++)
+        newPts[i] = intersectEdge(tet.nodes[kill], tet.nodes[ePts[i]], xc, norm);
+
+      tetra newTet;
+      newTet.nodes = {{tet.nodes[ePts[0]], tet.nodes[ePts[1]], newPts[0], tet.nodes[ePts[2]]}};
+      outTets.push_back(newTet);
+      newTet.nodes = {{tet.nodes[ePts[2]], newPts[0], newPts[2], newPts[1]}};
+      outTets.push_back(newTet);
+      newTet.nodes = {{tet.nodes[ePts[1]], tet.nodes[ePts[2]], newPts[1],newPts[0]}};
+      outTets.push_back(newTet);
       break;
     }
 
     case 2: {
       // Tet cut in half through 4 edges; split into 3 new tets
-      // Get the points we're keeping and 'killing'
-      array<int,2> kill, keep;
-      int m=0, n=0;
-      for (int i=0; i<4; i++) {
-        if (deadPts.count(i)) {
-          kill[m] = i;
-          m++;
-        }
-        else {
-          keep[n] = i;
-          n++;
-        }
-      }
-
       /* Re-orient tet (shuffle nodes) based on kept nodes so that
        * clipping becomes standardized; 'base case' is keeping {0,1}
-       * One possible case for each edge being removed */
-      map<array<int,2>,array<int,4>> flipTet;
-      flipTet[{{0,1}}] = {{0,1,2,3}};  flipTet[{{0,2}}] = {{0,2,3,1}};
-      flipTet[{{0,3}}] = {{0,3,1,2}};  flipTet[{{1,2}}] = {{1,2,0,3}};
-      flipTet[{{1,3}}] = {{1,3,2,0}};  flipTet[{{2,3}}] = {{2,3,0,1}};
-      array<int,4> ind = flipTet[keep];
-
-      // Intersect the plane with the edges to get the new points
+       * One possible case for each edge being removed [indexed by the
+       * bit mask of the two kept nodes] */
+      static const int flipTet2[16][4] = {
+        {0,0,0,0}, {0,0,0,0}, {0,0,0,0}, {0,1,2,3},   //  3: keep {0,1}
+        {0,0,0,0}, {0,2,3,1}, {1,2,0,3}, {0,0,0,0},   //  5: keep {0,2};  6: keep {1,2}
+        {0,0,0,0}, {0,3,1,2}, {1,3,2,0}, {0,0,0,0},   //  9: keep {0,3}; 10: keep {1,3}
+        {2,3,0,1}, {0,0,0,0}, {0,0,0,0}, {0,0,0,0}};  // 12: keep {2,3}
+      const int *ind = flipTet2[~dead & 15];
+
+      // Intersect the plane with the edges 0-3, 1-3, 1-2, 0-2 to get the new points
       array<point,4> newPts;
-      point a,b;
-      Vec3 ab,ac;
-
-      // Edge 0-3
-      a = tet.nodes[ind[0]];
-      b = tet.nodes[ind[3]];
-      ab = b - a;
-      ac = xc - a;
-      newPts[0] = ab*((norm*ac)/(norm*ab)) + a;
-
-      // Edge 1-3
-      a = tet.nodes[ind[1]];
-      b = tet.nodes[ind[3]];
-      ab = b - a;
-      ac = xc - a;
-      newPts[1] = ab*((norm*ac)/(norm*ab)) + a;
-
-      // Edge 1-2
-      a = tet.nodes[ind[1]];
-      b = tet.nodes[ind[2]];
-      ab = b - a;
-      ac = xc - a;
-      newPts[2] = ab*((norm*ac)/(norm*ab)) + a;
-
-      // Edge 0-2
-      a = tet.nodes[ind[0]];
-      b = tet.nodes[ind[2]];
-      ab = b - a;
-      ac = xc - a;
-      newPts[3] = ab*((norm*ac)/(norm*ab)) + a;
+      newPts[0] = intersectEdge(tet.nodes[ind[0]], tet.nodes[ind[3]], xc, norm);
+      newPts[1] = intersectEdge(tet.nodes[ind[1]], tet.nodes[ind[3]], xc, norm);
+      newPts[2] = intersectEdge(tet.nodes[ind[1]], tet.nodes[ind[2]], xc, norm);
+      newPts[3] = intersectEdge(tet.nodes[ind[0]], tet.nodes[ind[2]], xc, norm);
 
       // Setup the new tets
-      outTets.resize(3);
-      outTets[0].nodes = {{tet.nodes[ind[1]],newPts[0],newPts[3],tet.nodes[ind[0]]}};
-      outTets[1].nodes = {{newPts[0],newPts[3],newPts[1],tet.nodes[ind[1]]}};
-      outTets[2].nodes = {{newPts[1],newPts[3],newPts[2],tet.nodes[ind[1]]}};
+      tetra newTet;
+      newTet.nodes = {{tet.nodes[ind[1]],newPts[0],newPts[3],tet.nodes[ind[0]]}};
+      outTets.push_back(newTet);
+      newTet.nodes = {{newPts[0],newPts[3],newPts[1],tet.nodes[ind[1]]}};
+      outTets.push_back(newTet);
+      newTet.nodes = {{newPts[1],newPts[3],newPts[2],tet.nodes[ind[1]]}};
+      outTets.push_back(newTet);
       break;
     }
 
     case 3: {
       // The opposite of case 1; new tet is one corner of original tet
-      int keep = -1;
-      for (int i=0; i<4; i++) {
-        if (!deadPts.count(i)) {
-          keep = i;
-          break;
-        }
-      }
+      int keep = 0;
+      while (dead & (1 << keep)) keep++;
 
       // Get the new points by intersecting the tet's edges with the clipping plane
       // Have to be careful about orientation of final tet, so map to a 'standard' orientation
-      map<int,array<int,3>> flipTet;
-      flipTet[0] = {{1,3,2}};  flipTet[1] = {{0,2,3}};
-      flipTet[2] = {{0,3,1}};  flipTet[3] = {{0,1,2}};
-      array<int,3> ePts = flipTet[keep];
+      const int *ePts = flipTet1[keep];
 
       // Setup outgoing tet; node 3 is the 'kept' node
       // Find the intersection points
-      outTets.resize(1);
-      outTets[0].nodes[3] = tet.nodes[keep];
-      for (int i=0; i<3; i++) {
-        Vec3 ab = tet.nodes[ePts[i]] - tet.nodes[keep];
-        Vec3 ac = xc - tet.nodes[keep];
-        outTets[0].nodes[i] = ab*((norm*ac)/(norm*ab)) + tet.nodes[keep];
-      }
+      tetra newTet;
+      newTet.nodes[3] = tet.nodes[keep];
+      for (int i=0; i<3; i++)
+        newTet.nodes[i] = intersectEdge(tet.nodes[keep], tet.nodes[ePts[i]], xc, norm);
+      outTets.push_back(newTet);
       break;
     }
 
@@ -598,35 +580,32 @@ vector<tetra> clipTet(tetra &tet, const vector<point> &clipFace, Vec3 &norm)
       break;
     }
   }
-
-  return outTets;
 }
 
 
-vector<triangle> clipTri(triangle &tri, const vector<point> &clipEdge, Vec3 &norm)
+void clipTri(const triangle &tri, const point &xc, const Vec3 &norm, vector<triangle> &outTris)
 {
   /* --- WARNING: Assuming a linear edge --- */
 
-  vector<triangle> outTris;
-
-  // Get face centroid
-  point xc = clipEdge[0];
-  xc += clipEdge[1];
-  xc /= 2.;
-
-  set<int> deadPts;
+  // Check each point of triangle to see which must be removed [bit i set if
+  // point i lies on the cut side of the clipping plane]
+  int dead = 0, nDead = 0;
   for (int i=0; i<3; i++) {
-    // Check each point of triangle to see which must be removed
-    Vec3 dx = tri.nodes[i] - xc;
-    double dot = dx*norm;
-    if (dot > 0) // Point lies on cut-side of clipping plane
-      deadPts.insert(i);
+    point pt = tri.nodes[i];
+    Vec3 dx = pt - xc;
+    if (dx*norm > 0) {
+      dead |= (1 << i);
+      nDead++;
+    }
   }
 
+  // The other 2 nodes of the tri for each node, in a 'standard' orientation
+  static const int flipTri[3][2] = {{1,2},{2,0},{0,1}};
+
   /*
    * Perform the clipping and subdivide the new volume into new tris
    */
-  switch (deadPts.size()) {
+  switch (nDead) {
     case 0: {
       // No intersection.
       outTris.push_back(tri);
@@ -634,49 +613,36 @@ vector<triangle> clipTri(triangle &tri, const vector<point> &clipEdge, Vec3 &nor
     }
     case 1: {
       // Removing one corner of tri
-      int kill = *(deadPts.begin());  // The point to remove
+      int kill = 0;  // The point to remove
+      while (!(dead & (1 << kill))) kill++;
 
-      // Get the points being kept; map to a 'standard' triangle
-      map<int,array<int,2>> flipTri;
-      flipTri[0] = {{1,2}};  flipTri[1] = {{2,0}}; flipTri[2] = {{0,1}};
-      array<int,2> ePts = flipTri[kill];
+      const int *ePts = flipTri[kill];
 
       // Find the cutting-plane intersection points
-      Vec3 ab = tri.nodes[ePts[0]] - tri.nodes[kill];
-      Vec3 ac = xc - tri.nodes[kill];
-      point newPt1 = ab*(norm*ac)/(norm*ab) + tri.nodes[kill];
-
-      ab = tri.nodes[ePts[1]] - tri.nodes[kill];
-      point newPt2 = ab*(norm*ac)/(norm*ab) + tri.nodes[kill];
-
-      outTris.resize(2);
-      outTris[0].nodes = {{tri.nodes[ePts[0]],tri.nodes[ePts[1]],newPt1}};
-      outTris[1].nodes = {{tri.nodes[ePts[1]],newPt2,newPt1}};
+      point newPt1 = intersectEdge(tri.nodes[kill], tri.nodes[ePts[0]], xc, norm);
+      point newPt2 = intersectEdge(tri.nodes[kill], tri.nodes[ePts[1]], xc, norm);
+
+      triangle newTri;
+      newTri.nodes = {{tri.nodes[ePts[0]],tri.nodes[ePts[1]],newPt1}};
+      outTris.push_back(newTri);
+      newTri.nodes = {{tri.nodes[ePts[1]],newPt2,newPt1}};
+      outTris.push_back(newTri);
       break;
     }
     case 2: {
       // Keeping one corner of tri
-      int keep = -1;
-      for (int i=0; i<3; i++) {
-        if (!deadPts.count(i)) {
-          keep = i;
-          break;
-        }
-      }
+      int keep = 0;
+      while (dead & (1 << keep)) keep++;
 
-      map<int,array<int,2>> flipTri;
-      flipTri[0] = {{1,2}};  flipTri[1] = {{2,0}}; flipTri[2] = {{0,1}};
-      array<int,2> ePts = flipTri[keep];
+      const int *ePts = flipTri[keep];
 
       // Setup outgoing tri; node 2 is the 'kept' node
       // Find the intersection points
-      outTris.resize(1);
-      outTris[0].nodes[2] = tri.nodes[keep];
-      for (int i=0; i<2; i++) {
-        Vec3 ab = tri.nodes[ePts[i]] - tri.nodes[keep];
-        Vec3 ac = xc - tri.nodes[keep];
-        outTris[0].nodes[i] = ab*((norm*ac)/(norm*ab)) + tri.nodes[keep];
-      }
+      triangle newTri;
+      newTri.nodes[2] = tri.nodes[keep];
+      for (int i=0; i<2; i++)
+        newTri.nodes[i] = intersectEdge(tri.nodes[keep], tri.nodes[ePts[i]], xc, norm);
+      outTris.push_back(newTri);
       break;
     }
     case 3: {
@@ -684,19 +650,35 @@ vector<triangle> clipTri(triangle &tri, const vector<point> &clipEdge, Vec3 &nor
       break;
     }
   }
-
-  return outTris;
 }
 
 
-vector<triangle> splitQuadIntoTris(const vector<point> &quadNodes)
+void splitQuadIntoTris(const point *quadNodes, vector<triangle> &outTris)
 {
-  vector<triangle> newTris(2);
+  triangle tri;
+  tri.nodes = {{quadNodes[0],quadNodes[1],quadNodes[3]}};
+  outTris.push_back(tri);
+  tri.nodes = {{quadNodes[1],quadNodes[2],quadNodes[3]}};
+  outTris.push_back(tri);
+}
+
+size_t hashSuperMeshInputs(const vector<point> &target, Array2D<point> &donors)
+{
+  size_t h = 0;
+  auto combine = [&](double val) {
+    h ^= std::hash<double>()(val) + 0x9e3779b9 + (h << 6) + (h >> 2);
+  };
+
+  for (auto &pt:target)
+    for (int dim=0; dim<3; dim++)
+      combine(pt[dim]);
 
-  newTris[0].nodes = {{quadNodes[0],quadNodes[1],quadNodes[3]}};
-  newTris[1].nodes = {{quadNodes[1],quadNodes[2],quadNodes[3]}};
+  for (uint i=0; i<donors.getDim0(); i++)
+    for (uint j=0; j<donors.getDim1(); j++)
+      for (int dim=0; dim<3; dim++)
+        combine(donors(i,j)[dim]);
 
-  return newTris;
+  return h;
 }
 
 double getAreaTri(std::array<point,3> &nodes)
@@ -0,0 +1,88 @@
+/*!
+ * \file taskGraph.cpp
+ * \brief taskGraph class definition
+ *
+ * Static task graph with explicit dependencies, run with OpenMP tasks
+ *
+ * \author - Jacob Crabill
+ *           Aerospace Computing Laboratory (ACL)
+ *           Aero/Astro Department. Stanford University
+ *
+ * \version 1.0.0
+ *
+ * Flux Reconstruction in C++ (Flurry++) Code
+ * Copyright (C) 2015 Jacob Crabill
+ *
+ * Flurry++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Flurry++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Flurry++; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "taskGraph.hpp"
+
+int taskGraph::addNode(std::function<void(void)> work)
+{
+  nodes.push_back(node());
+  nodes.back().work = work;
+
+  return nodes.size()-1;
+}
+
+void taskGraph::addEdge(int from, int to)
+{
+  nodes[from].next.push_back(to);
+  nodes[to].nDeps++;
+}
+
+void taskGraph::addDependency(int to)
+{
+  nodes[to].nDeps++;
+}
+
+void taskGraph::release(int n)
+{
+  if (--pending[n] == 0)
+    spawn(n);
+}
+
+void taskGraph::run(void)
+{
+  if (pending.size() != nodes.size())
+    pending = vector<std::atomic<int>>(nodes.size());
+
+  for (uint i=0; i<nodes.size(); i++)
+    pending[i] = nodes[i].nDeps;
+
+#pragma omp parallel
+  {
+#pragma omp single
+    {
+      for (uint i=0; i<nodes.size(); i++)
+        if (nodes[i].nDeps == 0) spawn(i);
+    }
+  } // All tasks are complete at the end of the parallel region
+}
+
+void taskGraph::spawn(int n)
+{
+#pragma omp task firstprivate(n)
+  execute(n);
+}
+
+void taskGraph::execute(int n)
+{
+  nodes[n].work();
+
+  for (int m : nodes[n].next)
+    release(m);
+}
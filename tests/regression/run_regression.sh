@@ -0,0 +1,198 @@
+#!/bin/sh
+# Performance regression harness over the test cases listed in cases.txt
+#
+# Usage: run_regression.sh <check|update> <serial|openmp|mpi> [case ...]
+#
+# Each case is run for a fixed number of steps [iterMax] with the JSON profile
+# on [profile 2], in a copy of its directory under regression_<config>/.  The
+# time per DOF per step of the update [slowest rank], the peak resident set
+# size [largest rank], the per-phase timings and the final residual are kept
+# in regression_<config>/<case>.txt & <case>_profile.json.
+#
+# 'update' stores these as the baselines in baselines/<config>/; 'check'
+# compares against them and exits non-zero if any case got slower by more
+# than TIME_TOL [default: 0.10], grew its peak memory by more than MEM_TOL
+# [default: 0.10], or changed its residual by more than RES_TOL [relative;
+# default: 1e-8].  Timings only compare on the machine which wrote the
+# baselines.
+#
+# The binary must match the config: FLURRY [default: ../../bin/Flurry],
+# THREADS [openmp; default: 4], RANKS & MPIRUN [mpi; defaults: 4, mpirun].
+
+mode=${1:-check}
+config=${2:-serial}
+[ $# -ge 2 ] && shift 2 || shift $#
+
+here=$(cd "$(dirname "$0")" && pwd)
+tests=$(dirname "$here")
+
+FLURRY=${FLURRY:-$here/../../bin/Flurry}
+FLURRY=$(cd "$(dirname "$FLURRY")" && pwd)/$(basename "$FLURRY")
+MPIRUN=${MPIRUN:-mpirun}
+THREADS=${THREADS:-4}
+RANKS=${RANKS:-4}
+TIME_TOL=${TIME_TOL:-0.10}
+MEM_TOL=${MEM_TOL:-0.10}
+RES_TOL=${RES_TOL:-1e-8}
+BASELINES=${BASELINES:-$here/baselines}/$config
+WORKDIR=${WORKDIR:-$(pwd)/regression_$config}
+
+case $mode in check|update) ;; *) echo "Unknown mode $mode [check|update]"; exit 2;; esac
+
+case $config in
+  serial) run() { OMP_NUM_THREADS=1 "$FLURRY" "$1"; } ;;
+  openmp) run() { OMP_NUM_THREADS=$THREADS "$FLURRY" "$1"; } ;;
+  mpi)    run() { OMP_NUM_THREADS=1 $MPIRUN -np $RANKS "$FLURRY" "$1"; } ;;
+  *) echo "Unknown config $config [serial|openmp|mpi]"; exit 2 ;;
+esac
+
+[ -x "$FLURRY" ] || { echo "No Flurry binary at $FLURRY"; exit 2; }
+mkdir -p "$WORKDIR" "$BASELINES"
+
+# Value of a top-level field of the JSON profile
+jsonValue() {
+  awk -v key="\"$1\":" '$1 == key { gsub(",","",$2); print $2 }' "$2"
+}
+
+# Value of a field of a result / baseline file
+fieldValue() {
+  awk -v key="$1" '$1 == key { $1 = ""; sub(/^ /,""); print }' "$2"
+}
+
+# Option value from an input file [first occurrence wins, as in Flurry]
+optValue() {
+  awk -v key="$1" '$1 == key { $1 = ""; sub(/^ /,""); print; exit }' "$2"
+}
+
+# Generate any missing mesh of the input file with gmsh; fails if it can't
+meshCase() {
+  nDims=$(optValue nDims "$1" | awk '{print $1}')
+  for msh in $(optValue meshFileName "$1" | awk '{print $1}') \
+             $(optValue oversetGrids "$1" | awk '{for (i=2; i<=NF && i<=$1+1; i++) print $i}'); do
+    [ -f "$msh" ] && continue
+    geo=${msh%.msh}.geo
+    [ -f "$geo" ] && command -v gmsh > /dev/null || return 1
+    gmsh -${nDims:-2} "$geo" -o "$msh" > /dev/null 2>&1 || return 1
+  done
+}
+
+# Compare the new result file against the baseline; prints the failures
+compareCase() {
+  awk -v timeTol=$TIME_TOL -v memTol=$MEM_TOL -v resTol=$RES_TOL '
+    function abs(x) { return (x < 0) ? -x : x }
+    FNR == NR { base[$1] = $0; next }
+    !($1 in base) { next }
+    {
+      n = split(base[$1], b)
+      if ($1 == "nDofs" || $1 == "nSteps") {
+        if ($2 != b[2]) printf "    %s changed: %s -> %s\n", $1, b[2], $2
+      }
+      else if ($1 == "timePerDofStep" && $2 > b[2]*(1+timeTol)) {
+        printf "    slower: %.3e -> %.3e s/DOF/step [%+.1f%%]\n", b[2], $2, 100*($2/b[2]-1)
+      }
+      else if ($1 == "peakMemory" && $2 > b[2]*(1+memTol)) {
+        printf "    more memory: %.1f -> %.1f MB [%+.1f%%]\n", b[2]/1048576, $2/1048576, 100*($2/b[2]-1)
+      }
+      else if ($1 == "res") {
+        if (NF != n) { printf "    residual has %d fields [baseline: %d]\n", NF-1, n-1; next }
+        for (i=2; i<=NF; i++)
+          if (abs($i-b[i]) > resTol*abs(b[i]) + 1e-300) {
+            printf "    residual %d changed: %s -> %s\n", i-1, b[i], $i
+            break
+          }
+      }
+    }' "$1" "$2"
+}
+
+# Top-level phases of two JSON profiles, side by side
+comparePhases() {
+  awk '
+    function phase(line) { sub(/.*"path": "/,"",line); sub(/".*/,"",line); return line }
+    function avg(line) { sub(/.*"avg": /,"",line); sub(/,.*/,"",line); return line }
+    /"path"/ {
+      p = phase($0)
+      if (p ~ /\//) next
+      if (FNR == NR) { t0[p] = avg($0); next }
+      printf "      %-24s %10.4f -> %10.4f s\n", p, t0[p], avg($0)
+    }' "$1" "$2"
+}
+
+nPass=0; nFail=0; nSkip=0
+while read name input steps configs; do
+  case $name in ''|\#*) continue ;; esac
+  if [ $# -gt 0 ]; then
+    case " $* " in *" $name "*) ;; *) continue ;; esac
+  fi
+  case ",$configs," in *",$config,"*) ;; *) continue ;; esac
+
+  dir=$WORKDIR/$name
+  rm -rf "$dir"
+  cp -r "$tests/$(dirname "$input")" "$dir"
+  cd "$dir"
+
+  # The first occurrence of an option wins, so the overrides go first
+  {
+    echo "iterMax $steps"
+    echo "maxTime 1e10"
+    echo "monitorResFreq $steps"
+    echo "monitorErrFreq $steps"
+    echo "plotFreq $((steps+1))"
+    echo "restartType 0"
+    echo "profile 2"
+    echo "memReport 0"
+    echo "dataFileName $name"
+    cat "$(basename "$input")"
+  } > input_regression
+
+  if ! meshCase input_regression; then
+    echo "$name: SKIPPED [mesh file missing & no gmsh to generate it]"
+    nSkip=$((nSkip+1))
+    cd "$WORKDIR"; continue
+  fi
+
+  if ! run input_regression < /dev/null > $name.log 2>&1 || [ ! -f ${name}_profile.json ]; then
+    echo "$name: FAILED to run [see $dir/$name.log]"
+    nFail=$((nFail+1))
+    cd "$WORKDIR"; continue
+  fi
+
+  result=$WORKDIR/$name.txt
+  {
+    echo "nDofs $(jsonValue nDofs ${name}_profile.json)"
+    echo "nSteps $(jsonValue nSteps ${name}_profile.json)"
+    echo "timePerDofStep $(jsonValue timePerDofStep ${name}_profile.json)"
+    echo "peakMemory $(jsonValue peakMemory ${name}_profile.json)"
+    awk '$2 == "Res" { $1 = ""; $2 = ""; res = $0 } END { gsub(/^ +/,"",res); print "res " res }' $name.log
+  } > "$result"
+  cp ${name}_profile.json "$WORKDIR/"
+  cd "$WORKDIR"
+
+  tNew=$(fieldValue timePerDofStep "$result")
+  if [ "$mode" = update ]; then
+    cp "$result" "$WORKDIR/${name}_profile.json" "$BASELINES/"
+    echo "$name: baseline updated [$tNew s/DOF/step]"
+    nPass=$((nPass+1))
+  elif [ ! -f "$BASELINES/$name.txt" ]; then
+    echo "$name: no baseline [$tNew s/DOF/step]; run with 'update' to store one"
+    nSkip=$((nSkip+1))
+  else
+    failures=$(compareCase "$BASELINES/$name.txt" "$result")
+    tOld=$(fieldValue timePerDofStep "$BASELINES/$name.txt")
+    change=$(awk -v a=$tOld -v b=$tNew 'BEGIN { printf "%+.1f%%", 100*(b/a-1) }')
+    if [ -z "$failures" ]; then
+      echo "$name: ok [$tNew s/DOF/step, $change]"
+      nPass=$((nPass+1))
+    else
+      echo "$name: FAILED"
+      echo "$failures"
+      case $failures in *slower*)
+        echo "    top-level phases [baseline -> new]:"
+        comparePhases "$BASELINES/${name}_profile.json" "$WORKDIR/${name}_profile.json" ;;
+      esac
+      nFail=$((nFail+1))
+    fi
+  fi
+done < "$here/cases.txt"
+
+echo "Regression [$config, $mode]: $nPass passed, $nFail failed, $nSkip skipped"
+[ $nFail -eq 0 ]
@@ -0,0 +1,24 @@
+#!/bin/sh
+# Weak or strong scaling of Flurry over 1, 2, 4, ... maxRanks MPI ranks
+#
+# Usage: run_scaling.sh <weak|strong> <maxRanks> [DOFs] [steps] [options file]
+#
+# Each run appends one JSON line to scaling_<weak|strong>.json in the current
+# directory; parallel efficiencies are relative to the 1-rank run.  Set
+# FLURRY [default: ../../bin/Flurry] and MPIRUN [default: mpirun] as needed.
+
+mode=${1:-weak}
+maxRanks=${2:-1}
+dofs=${3:-100000}
+steps=${4:-20}
+opts=$5
+
+FLURRY=${FLURRY:-$(dirname "$0")/../../bin/Flurry}
+MPIRUN=${MPIRUN:-mpirun}
+
+n=1
+while [ $n -le $maxRanks ]; do
+  $MPIRUN -np $n $FLURRY -scaling $mode $dofs $steps $opts > scaling_${mode}_np$n.log 2>&1 || exit 1
+  grep -A4 "Scaling benchmark" scaling_${mode}_np$n.log
+  n=$((n*2))
+done